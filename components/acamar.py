@@ -27,6 +27,7 @@
 
 import os.path
 from prj import Module
+from util.rtos import configure_id_sizes
 
 
 class AcamarModule(Module):
@@ -43,6 +44,8 @@ class AcamarModule(Module):
         config['prefix_type'] = config['prefix'].capitalize() if config['prefix'] is not None else ''
         config['prefix_const'] = config['prefix'].upper() + '_' if config['prefix'] is not None else ''
 
+        configure_id_sizes(xml_config, config)
+
         return config
 
 module = AcamarModule()
@@ -0,0 +1,52 @@
+/*| headers |*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*| object_like_macros |*/
+
+/*| types |*/
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+{{#atomics}}
+static bool atomic_compare_and_swap(volatile uint32_t *word, uint32_t expected, uint32_t desired);
+{{/atomics}}
+
+/*| state |*/
+
+/*| function_like_macros |*/
+
+/*| functions |*/
+{{#atomics}}
+/*
+ * Atomically replace the value of word with desired if it is equal to expected, and return whether it did.
+ * This is safe to use from both tasks and interrupt handlers without masking interrupts.
+ * Exception entry and return clear the exclusive monitor, so the strex fails and the loop retries if an interrupt
+ * handler runs between the ldrex and the strex.
+ */
+static RAMFUNC bool
+atomic_compare_and_swap(volatile uint32_t *const word, const uint32_t expected, const uint32_t desired)
+{
+    uint32_t value;
+    uint32_t failed;
+
+    /* loop bound: retries */
+    do
+    {
+        asm volatile("ldrex %0, [%1]" : "=r" (value) : "r" (word) : "memory");
+        if (value != expected)
+        {
+            asm volatile("clrex" ::: "memory");
+            return false;
+        }
+        asm volatile("strex %0, %1, [%2]" : "=&r" (failed) : "r" (desired), "r" (word) : "memory");
+    } while (failed);
+
+    return true;
+}
+{{/atomics}}
+
+/*| public_functions |*/
@@ -0,0 +1,51 @@
+/*| headers |*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*| object_like_macros |*/
+
+/*| types |*/
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+{{#atomics}}
+static bool atomic_compare_and_swap(volatile uint32_t *word, uint32_t expected, uint32_t desired);
+{{/atomics}}
+
+/*| state |*/
+
+/*| function_like_macros |*/
+
+/*| functions |*/
+{{#atomics}}
+/*
+ * Atomically replace the value of word with desired if it is equal to expected, and return whether it did.
+ * This is safe to use from both tasks and interrupt handlers without masking interrupts.
+ * Interrupts do not clear the reservation, so the word must only be modified through this function.
+ * Then an interrupt handler that modifies the word between the lwarx and the stwcx. consumes the reservation with its
+ * own stwcx., so the stwcx. of the interrupted compare-and-swap fails and it retries.
+ */
+static RAMFUNC bool
+atomic_compare_and_swap(volatile uint32_t *const word, const uint32_t expected, const uint32_t desired)
+{
+    uint32_t value;
+
+    asm volatile(
+        "1: lwarx %0,0,%1\n"
+        "cmpw %0,%2\n"
+        "bne- 2f\n"
+        "stwcx. %3,0,%1\n"
+        "bne- 1b\n"
+        "2:"
+        : "=&r" (value)
+        : "r" (word), "r" (expected), "r" (desired)
+        : "cc", "memory");
+
+    return value == expected;
+}
+{{/atomics}}
+
+/*| public_functions |*/
@@ -0,0 +1,36 @@
+/*| headers |*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*| object_like_macros |*/
+
+/*| types |*/
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+{{#atomics}}
+static bool atomic_compare_and_swap(volatile uint32_t *word, uint32_t expected, uint32_t desired);
+{{/atomics}}
+
+/*| state |*/
+
+/*| function_like_macros |*/
+
+/*| functions |*/
+{{#atomics}}
+static bool
+atomic_compare_and_swap(volatile uint32_t *const word, const uint32_t expected, const uint32_t desired)
+{
+    if (*word != expected)
+    {
+        return false;
+    }
+    *word = desired;
+    return true;
+}
+{{/atomics}}
+
+/*| public_functions |*/
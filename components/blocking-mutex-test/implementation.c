@@ -83,11 +83,16 @@ pub_set_get_current_task_ptr({{prefix_type}}TaskId (*y)(void))
 void pub_mutex_init(void)
 {
     {{prefix_type}}MutexId mutex_id;
+    {{prefix_type}}TaskId task_id;
     /* For testing purposes we also reset all mutexes */
     for (mutex_id = {{prefix_const}}MUTEX_ID_ZERO; mutex_id <= {{prefix_const}}MUTEX_ID_MAX; mutex_id++)
     {
         mutexes[mutex_id].holder = TASK_ID_NONE;
     }
+    for (task_id = {{prefix_const}}TASK_ID_ZERO; task_id <= {{prefix_const}}TASK_ID_MAX; task_id++)
+    {
+        mutex_waiters[task_id] = MUTEX_ID_NONE;
+    }
     block_on_ptr = NULL;
     unblock_ptr = NULL;
     get_current_task_ptr = NULL;
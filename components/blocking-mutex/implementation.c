@@ -24,6 +24,11 @@ struct mutex_stat {
 /*| extern_declarations |*/
 
 /*| function_declarations |*/
+{{#mutexes.length}}
+static bool mutex_try_lock({{prefix_type}}MutexId m);
+static bool mutex_acquire({{prefix_type}}MutexId m) {{prefix_const}}REENTRANT;
+static void mutex_release({{prefix_type}}MutexId m);
+{{/mutexes.length}}
 
 /*| state |*/
 {{#mutexes.length}}
@@ -69,6 +74,55 @@ mutex_try_lock(const {{prefix_type}}MutexId m)
 
     return r;
 }
+
+/*
+ * Lock the mutex, blocking the current task while another task holds it.
+ * Returns whether the mutex was contended.
+ */
+static bool
+mutex_acquire(const {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT
+{
+    bool contended = false;
+
+    precondition_preemption_disabled();
+
+    while (!mutex_try_lock(m))
+    {
+        contended = true;
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on(mutexes[m].holder);
+    }
+
+    postcondition_preemption_disabled();
+
+    return contended;
+}
+
+static void
+mutex_release(const {{prefix_type}}MutexId m)
+{
+    {{prefix_type}}TaskId t;
+
+    precondition_preemption_disabled();
+
+[[#prio_ceiling]]
+    mutex_core_unlocked(m);
+[[/prio_ceiling]]
+
+    /* loop bound: {{tasks.length}} */
+    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+    {
+        if (mutex_waiters[t] == m)
+        {
+            mutex_waiters[t] = MUTEX_ID_NONE;
+            mutex_core_unblock(t);
+        }
+    }
+
+    mutexes[m].holder = TASK_ID_NONE;
+
+    postcondition_preemption_disabled();
+}
 {{#mutex.stats}}
 
 static void
@@ -97,7 +151,7 @@ void
 {{prefix_func}}mutex_lock(const {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT
 {
 {{#mutex.stats}}
-    bool contended = false;
+    bool contended;
     const {{prefix_type}}TicksAbsolute wait_start_ticks = {{prefix_func}}timer_current_ticks;
 
 {{/mutex.stats}}
@@ -106,14 +160,12 @@ void
 
     preempt_disable();
 
-    while (!mutex_try_lock(m))
-    {
 {{#mutex.stats}}
-        contended = true;
+    contended = mutex_acquire(m);
+{{/mutex.stats}}
+{{^mutex.stats}}
+    (void) mutex_acquire(m);
 {{/mutex.stats}}
-        mutex_waiters[get_current_task()] = m;
-        mutex_core_block_on(mutexes[m].holder);
-    }
 
     preempt_enable();
 
@@ -163,27 +215,12 @@ bool
 void
 {{prefix_func}}mutex_unlock(const {{prefix_type}}MutexId m)
 {
-    {{prefix_type}}TaskId t;
-
     assert_mutex_valid(m);
     api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
 
     preempt_disable();
 
-[[#prio_ceiling]]
-    mutex_core_unlocked(m);
-[[/prio_ceiling]]
-
-    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
-    {
-        if (mutex_waiters[t] == m)
-        {
-            mutex_waiters[t] = MUTEX_ID_NONE;
-            mutex_core_unblock(t);
-        }
-    }
-
-    mutexes[m].holder = TASK_ID_NONE;
+    mutex_release(m);
 
     preempt_enable();
 }
@@ -218,6 +255,7 @@ void {{prefix_func}}mutex_stats_clear(void)
 {
     /* memset would be preferable, but string.h is not available on all platforms */
     uint8_t mutex_index;
+    /* loop bound: {{mutexes.length}} */
     for (mutex_index = 0; mutex_index < {{mutexes.length}}; mutex_index += 1)
     {
         mutex_stats[mutex_index].mutex_lock_counter = 0;
@@ -0,0 +1,27 @@
+/*| public_headers |*/
+#include <stdint.h>
+
+/*| public_types |*/
+typedef uint8_t {{prefix_type}}TaskId;
+typedef uint8_t {{prefix_type}}SignalSet;
+
+/*| public_structures |*/
+
+/*| public_object_like_macros |*/
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+{{#tasks}}
+#define {{prefix_const}}TASK_ID_{{name|u}} (({{prefix_type}}TaskId) UINT8_C({{idx}}))
+{{/tasks}}
+{{#broadcasts}}
+#define {{prefix_const}}SIGNAL_SET_{{sig_set|u}} (({{prefix_type}}SignalSet) UINT8_C(1))
+{{/broadcasts}}
+
+/*| public_function_like_macros |*/
+
+/*| public_state |*/
+
+/*| public_function_declarations |*/
+void pub_broadcast_init(void);
+void pub_set_current_task({{prefix_type}}TaskId task_id);
+void pub_set_wait_ptr(void (*y)(void));
@@ -0,0 +1,105 @@
+/*| headers |*/
+#include <stddef.h>
+#include <stdint.h>
+#include "rtos-broadcast-test.h"
+
+/*| object_like_macros |*/
+
+/*| types |*/
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+static void signal_send_set({{prefix_type}}TaskId task_id, {{prefix_type}}SignalSet signals);
+static {{prefix_type}}SignalSet signal_wait_set({{prefix_type}}SignalSet requested_signals) {{prefix_const}}REENTRANT;
+static {{prefix_type}}TaskId get_current_task(void);
+
+/*| state |*/
+static {{prefix_type}}TaskId current_task;
+static void (*wait_ptr)(void);
+{{prefix_type}}SignalSet pub_signals[{{tasks.length}}];
+uint8_t pub_waits;
+{{prefix_type}}ErrorId pub_fatal_error_id;
+
+/*| function_like_macros |*/
+
+/*| functions |*/
+static void
+signal_send_set(const {{prefix_type}}TaskId task_id, const {{prefix_type}}SignalSet signals)
+{
+    pub_signals[task_id] |= signals;
+}
+
+/*
+ * While the current task waits, other tasks run in the wait function that the test sets.
+ */
+static {{prefix_type}}SignalSet
+signal_wait_set(const {{prefix_type}}SignalSet requested_signals) {{prefix_const}}REENTRANT
+{
+    const {{prefix_type}}TaskId task = current_task;
+
+    pub_waits++;
+    pub_signals[task] &= ~requested_signals;
+    if (wait_ptr != NULL)
+    {
+        wait_ptr();
+    }
+    current_task = task;
+
+    return requested_signals;
+}
+
+static {{prefix_type}}TaskId
+get_current_task(void)
+{
+    return current_task;
+}
+
+void
+test_fatal_error(const {{prefix_type}}ErrorId error_id)
+{
+    pub_fatal_error_id = error_id;
+}
+
+/*| public_functions |*/
+void
+pub_broadcast_init(void)
+{
+    {{prefix_type}}BroadcastId broadcast;
+    BroadcastSubscriptionIndex s;
+    {{prefix_type}}TaskId task_id;
+
+    /* For testing purposes, all channels and subscriptions are reset */
+    for (broadcast = 0; broadcast < {{broadcasts.length}}; broadcast++)
+    {
+        broadcasts[broadcast].head = 0;
+        broadcasts[broadcast].published = 0;
+    }
+    for (s = 0; s < {{broadcast_subscriptions.length}}; s++)
+    {
+        broadcast_subscriptions[s].cursor = 0;
+        broadcast_subscriptions[s].lost = 0;
+    }
+    for (task_id = {{prefix_const}}TASK_ID_ZERO; task_id <= {{prefix_const}}TASK_ID_MAX; task_id++)
+    {
+        pub_signals[task_id] = 0;
+    }
+    current_task = {{prefix_const}}TASK_ID_ZERO;
+    wait_ptr = NULL;
+    pub_waits = 0;
+    pub_fatal_error_id = ERROR_ID_NONE;
+}
+
+void
+pub_set_current_task(const {{prefix_type}}TaskId task_id)
+{
+    current_task = task_id;
+}
+
+void
+pub_set_wait_ptr(void (*y)(void))
+{
+    wait_ptr = y;
+}
@@ -0,0 +1,26 @@
+/*| public_headers |*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*| public_types |*/
+typedef uint8_t {{prefix_type}}BroadcastId;
+
+/*| public_structures |*/
+
+/*| public_object_like_macros |*/
+{{#broadcasts}}
+#define {{prefix_const}}BROADCAST_ID_{{name|u}} (({{prefix_type}}BroadcastId) UINT8_C({{idx}}))
+{{/broadcasts}}
+
+/*| public_function_like_macros |*/
+
+/*| public_state |*/
+
+/*| public_function_declarations |*/
+{{#broadcasts.length}}
+void {{prefix_func}}broadcast_publish({{prefix_type}}BroadcastId broadcast, const void *record);
+bool {{prefix_func}}broadcast_try_get({{prefix_type}}BroadcastId broadcast, void *record);
+void {{prefix_func}}broadcast_get({{prefix_type}}BroadcastId broadcast, void *record) {{prefix_const}}REENTRANT;
+uint32_t {{prefix_func}}broadcast_lost({{prefix_type}}BroadcastId broadcast);
+
+{{/broadcasts.length}}
@@ -0,0 +1,228 @@
+/*| headers |*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*| object_like_macros |*/
+
+/*| types |*/
+typedef uint8_t BroadcastSubscriptionIndex;
+
+/*| structures |*/
+/* representation of a broadcast channel instance */
+struct broadcast
+{
+    /* pointer to the array holding the record data
+     * the array contains record_size * length bytes */
+    uint8_t *records;
+    /* size of each record in bytes */
+    uint16_t record_size;
+    /* number of records the channel retains for its subscribers */
+    uint8_t length;
+    /* index of the slot the next record is published into
+     * 0 <= head < length */
+    uint8_t head;
+    /* sequence number of the next record to be published */
+    uint32_t published;
+    /* range of the subscriptions of the channel in the broadcast_subscriptions array */
+    BroadcastSubscriptionIndex first_subscription;
+    BroadcastSubscriptionIndex subscription_count;
+    /* signal set sent to all subscribers when a record is published */
+    {{prefix_type}}SignalSet sig_set;
+};
+
+/* the per-subscriber state of a broadcast channel */
+struct broadcast_subscription
+{
+    {{prefix_type}}TaskId task;
+    /* sequence number of the next record the subscriber retrieves */
+    uint32_t cursor;
+    /* number of records that were overwritten before the subscriber retrieved them */
+    uint32_t lost;
+};
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+{{#broadcasts.length}}
+static struct broadcast_subscription *broadcast_subscription_get({{prefix_type}}BroadcastId broadcast);
+static void broadcast_copy(uint8_t *dst, const uint8_t *src, uint16_t length);
+{{/broadcasts.length}}
+
+/*| state |*/
+{{#broadcasts.length}}
+{{#broadcasts}}
+static uint8_t broadcast_{{name}}_records[{{length}}][{{#record_size}}{{record_size}}{{/record_size}}{{#record_type}}sizeof({{record_type}}){{/record_type}}];
+{{/broadcasts}}
+static struct broadcast broadcasts[{{broadcasts.length}}] =
+{
+{{#broadcasts}}
+    {
+        (uint8_t*)broadcast_{{name}}_records,
+{{#record_size}}
+        {{record_size}},
+{{/record_size}}
+{{#record_type}}
+        sizeof({{record_type}}),
+{{/record_type}}
+        {{length}},
+        0,
+        0,
+        {{first_subscription}},
+        {{subscribers.length}},
+        {{prefix_const}}SIGNAL_SET_{{sig_set|u}}
+    },
+{{/broadcasts}}
+};
+static struct broadcast_subscription broadcast_subscriptions[{{broadcast_subscriptions.length}}] =
+{
+{{#broadcast_subscriptions}}
+    { {{prefix_const}}TASK_ID_{{name|u}}, 0, 0 },
+{{/broadcast_subscriptions}}
+};
+
+{{/broadcasts.length}}
+
+/*| function_like_macros |*/
+{{#broadcasts.length}}
+#define broadcast_api_assert_valid(broadcast) api_assert(broadcast < {{broadcasts.length}}, ERROR_ID_INVALID_ID)
+
+{{/broadcasts.length}}
+
+/*| functions |*/
+{{#broadcasts.length}}
+static struct broadcast_subscription *
+broadcast_subscription_get(const {{prefix_type}}BroadcastId broadcast)
+{
+    const struct broadcast *const b = &broadcasts[broadcast];
+    BroadcastSubscriptionIndex s;
+
+    /* loop bound: {{broadcast_subscriptions.length}} */
+    for (s = b->first_subscription; s < b->first_subscription + b->subscription_count; s += 1)
+    {
+        if (broadcast_subscriptions[s].task == get_current_task())
+        {
+            return &broadcast_subscriptions[s];
+        }
+    }
+
+    api_error(ERROR_ID_BROADCAST_NOT_SUBSCRIBED);
+    return &broadcast_subscriptions[b->first_subscription];
+}
+
+/* called broadcast_copy instead of memcpy to not conflict with gcc's built-in memcpy declaration on unit test
+ * targets */
+static void
+broadcast_copy(uint8_t *dst, const uint8_t *src, const uint16_t length)
+{
+    uint8_t *const dst_end = dst + length;
+
+    /* loop bound: 65535 */
+    while (dst < dst_end)
+    {
+        *dst++ = *src++;
+    }
+}
+
+{{/broadcasts.length}}
+
+/*| public_functions |*/
+{{#broadcasts.length}}
+void
+{{prefix_func}}broadcast_publish(const {{prefix_type}}BroadcastId broadcast, const void *const record)
+{
+    struct broadcast *b;
+    BroadcastSubscriptionIndex s;
+
+    broadcast_api_assert_valid(broadcast);
+    api_assert(record, ERROR_ID_BROADCAST_INVALID_POINTER);
+
+    b = &broadcasts[broadcast];
+
+    /* The record is copied once, regardless of the number of subscribers.
+     * The producer never waits for subscribers: slow subscribers lose the oldest records instead. */
+    broadcast_copy(&b->records[(uint16_t) b->head * b->record_size], (const uint8_t*)record, b->record_size);
+    b->head = (b->head + 1) % b->length;
+    b->published += 1;
+
+    /* Sending the signal only makes the subscribers runnable; they run in the order the scheduler selects them after
+     * the publishing task yields. */
+    /* loop bound: {{broadcast_subscriptions.length}} */
+    for (s = b->first_subscription; s < b->first_subscription + b->subscription_count; s += 1)
+    {
+        signal_send_set(broadcast_subscriptions[s].task, b->sig_set);
+    }
+}
+
+bool
+{{prefix_func}}broadcast_try_get(const {{prefix_type}}BroadcastId broadcast, void *const record)
+{
+    const struct broadcast *b;
+    struct broadcast_subscription *subscription;
+    uint32_t pending;
+
+    broadcast_api_assert_valid(broadcast);
+    api_assert(record, ERROR_ID_BROADCAST_INVALID_POINTER);
+
+    b = &broadcasts[broadcast];
+    subscription = broadcast_subscription_get(broadcast);
+    pending = b->published - subscription->cursor;
+
+    if (pending == 0)
+    {
+        return false;
+    }
+
+    if (pending > b->length)
+    {
+        /* The records the subscriber has not retrieved yet have been overwritten, so skip to the oldest record the
+         * channel still retains */
+        subscription->lost += pending - b->length;
+        subscription->cursor = b->published - b->length;
+        pending = b->length;
+    }
+
+    broadcast_copy((uint8_t*)record,
+                   &b->records[(uint16_t) ((b->head + b->length - pending) % b->length) * b->record_size],
+                   b->record_size);
+    subscription->cursor += 1;
+
+    return true;
+}
+
+void
+{{prefix_func}}broadcast_get(const {{prefix_type}}BroadcastId broadcast, void *const record) {{prefix_const}}REENTRANT
+{
+    broadcast_api_assert_valid(broadcast);
+    api_assert(record, ERROR_ID_BROADCAST_INVALID_POINTER);
+
+    while (!{{prefix_func}}broadcast_try_get(broadcast, record))
+    {
+        (void) signal_wait_set(broadcasts[broadcast].sig_set);
+    }
+}
+
+uint32_t
+{{prefix_func}}broadcast_lost(const {{prefix_type}}BroadcastId broadcast)
+{
+    struct broadcast_subscription *subscription;
+    const struct broadcast *b;
+    uint32_t lost;
+
+    broadcast_api_assert_valid(broadcast);
+
+    b = &broadcasts[broadcast];
+    subscription = broadcast_subscription_get(broadcast);
+    lost = subscription->lost;
+
+    /* Records that have been overwritten but not skipped by broadcast_try_get() yet are lost as well */
+    if (b->published - subscription->cursor > b->length)
+    {
+        lost += b->published - subscription->cursor - b->length;
+        subscription->cursor = b->published - b->length;
+    }
+    subscription->lost = 0;
+
+    return lost;
+}
+
+{{/broadcasts.length}}
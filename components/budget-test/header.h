@@ -0,0 +1,27 @@
+/*| public_headers |*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*| public_types |*/
+typedef uint8_t {{prefix_type}}TaskId;
+typedef uint16_t {{prefix_type}}TicksRelative;
+typedef uint32_t {{prefix_type}}TicksAbsolute;
+
+/*| public_structures |*/
+
+/*| public_object_like_macros |*/
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+
+/*| public_function_like_macros |*/
+
+/*| public_state |*/
+extern {{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+
+/*| public_function_declarations |*/
+void pub_budget_init(void);
+void pub_sched_set_runnable({{prefix_type}}TaskId task_id);
+void pub_sched_set_blocked({{prefix_type}}TaskId task_id);
+bool pub_sched_runnable({{prefix_type}}TaskId task_id);
+{{prefix_type}}TaskId pub_budget_select(void);
+int32_t pub_budget_remaining({{prefix_type}}TaskId task_id);
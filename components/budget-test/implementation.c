@@ -0,0 +1,125 @@
+/*| headers |*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "rtos-budget-test.h"
+
+/*| object_like_macros |*/
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+
+/*| types |*/
+typedef {{prefix_type}}TaskId TaskIdOption;
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+static uint32_t cycle_counter_get(void);
+static void interrupt_event_wait(void);
+
+/*| state |*/
+static {{prefix_type}}TaskId current_task;
+{{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+uint32_t pub_cycles;
+uint32_t pub_idle_ticks;
+uint8_t pub_overruns[{{tasks.length}}];
+
+/*| function_like_macros |*/
+#define cycle_counter_init()
+
+/*| functions |*/
+static uint32_t
+cycle_counter_get(void)
+{
+    return pub_cycles;
+}
+
+/*
+ * While no task is runnable, the system idles until the next tick.
+ */
+static void
+interrupt_event_wait(void)
+{
+    {{prefix_func}}timer_current_ticks++;
+    pub_idle_ticks++;
+}
+
+void
+test_budget_overrun(const {{prefix_type}}TaskId task)
+{
+    pub_overruns[task]++;
+}
+
+/*| public_functions |*/
+void
+pub_budget_init(void)
+{
+    memset(budgets, 0, sizeof(budgets));
+    memset(&sched_tasks, 0, sizeof(sched_tasks));
+    memset(pub_overruns, 0, sizeof(pub_overruns));
+    current_task = {{prefix_const}}TASK_ID_ZERO;
+    {{prefix_func}}timer_current_ticks = 0;
+    pub_cycles = 0;
+    pub_idle_ticks = 0;
+    budget_init();
+}
+
+void
+pub_sched_set_runnable(const {{prefix_type}}TaskId task_id)
+{
+    sched_set_runnable(task_id);
+}
+
+void
+pub_sched_set_blocked(const {{prefix_type}}TaskId task_id)
+{
+    sched_set_blocked(task_id);
+}
+
+bool
+pub_sched_runnable(const {{prefix_type}}TaskId task_id)
+{
+    return sched_runnable(task_id);
+}
+
+/*
+ * Make a scheduling decision the way the interrupt-event component does, and switch to the selected task.
+ */
+{{prefix_type}}TaskId
+pub_budget_select(void)
+{
+    TaskIdOption next;
+
+    budget_charge(current_task);
+
+    for (;;)
+    {
+        budget_replenish_process();
+        next = sched_get_next();
+        if (next != TASK_ID_NONE && budget_throttle(next))
+        {
+            continue;
+        }
+
+        if (next == TASK_ID_NONE)
+        {
+            interrupt_event_wait();
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    budget_switch(current_task, next);
+    current_task = next;
+
+    return next;
+}
+
+int32_t
+pub_budget_remaining(const {{prefix_type}}TaskId task_id)
+{
+    return budgets[task_id].remaining;
+}
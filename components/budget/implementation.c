@@ -0,0 +1,241 @@
+/*| headers |*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*| object_like_macros |*/
+{{#budgets}}
+#define BUDGET_REPLENISHMENTS_MAX 4U
+{{/budgets}}
+
+/*| types |*/
+
+/*| structures |*/
+{{#budgets}}
+struct budget_replenishment {
+    {{prefix_type}}TicksAbsolute due;
+    uint32_t amount;
+};
+
+struct budget {
+    /* Signed, because the RTOS only notices an exhausted budget at the next scheduling point, so a task may overrun
+     * its budget by the cycles it executes until then. */
+    int32_t remaining;
+    uint32_t consumed;
+    {{prefix_type}}TicksAbsolute activation;
+    bool active;
+    bool throttled;
+    uint8_t replenishment_head;
+    uint8_t replenishment_count;
+    struct budget_replenishment replenishments[BUDGET_REPLENISHMENTS_MAX];
+};
+{{/budgets}}
+
+/*| extern_declarations |*/
+{{#budget_overrun}}
+extern void {{budget_overrun}}({{prefix_type}}TaskId task);
+{{/budget_overrun}}
+
+/*| function_declarations |*/
+{{#budgets}}
+static void budget_init(void);
+static void budget_activate({{prefix_type}}TaskId task);
+static void budget_post({{prefix_type}}TaskId task);
+static void budget_charge({{prefix_type}}TaskId task);
+static bool budget_throttle({{prefix_type}}TaskId task);
+static void budget_replenish_process(void);
+static void budget_switch({{prefix_type}}TaskId from, {{prefix_type}}TaskId to);
+{{/budgets}}
+
+/*| state |*/
+{{#budgets}}
+static struct budget budgets[{{tasks.length}}];
+static uint32_t budget_switch_in;
+static const uint32_t budget_capacities[{{tasks.length}}] = {
+{{#tasks}}
+    UINT32_C({{budget}}),
+{{/tasks}}
+};
+static const {{prefix_type}}TicksRelative budget_periods[{{tasks.length}}] = {
+{{#tasks}}
+    {{budget_period}},
+{{/tasks}}
+};
+{{/budgets}}
+
+/*| function_like_macros |*/
+{{#budgets}}
+#define budget_limited(task) (budget_capacities[task] != 0)
+{{/budgets}}
+
+/*| functions |*/
+{{#budgets}}
+static void
+budget_init(void)
+{
+    {{prefix_type}}TaskId task;
+
+    cycle_counter_init();
+
+    for (task = {{prefix_const}}TASK_ID_ZERO; task <= {{prefix_const}}TASK_ID_MAX; task++)
+    {
+        budgets[task].remaining = (int32_t) budget_capacities[task];
+    }
+
+    budget_activate({{prefix_const}}TASK_ID_ZERO);
+    budget_switch_in = cycle_counter_get();
+}
+
+static void
+budget_activate(const {{prefix_type}}TaskId task)
+{
+    if (budget_limited(task))
+    {
+        budgets[task].activation = {{prefix_func}}timer_current_ticks;
+        budgets[task].active = true;
+    }
+}
+
+/*
+ * Schedule the replenishment of the cycles a task has consumed since its activation, one replenishment period after
+ * the activation.
+ * When all replenishment slots of the task are in use, the cycles are added to the latest replenishment instead,
+ * which is deferred accordingly.
+ * That returns budget later than a sporadic server with unlimited replenishments would, but never earlier.
+ */
+static void
+budget_post(const {{prefix_type}}TaskId task)
+{
+    struct budget *const budget = &budgets[task];
+    struct budget_replenishment *replenishment;
+
+    if (budget->consumed != 0)
+    {
+        if (budget->replenishment_count < BUDGET_REPLENISHMENTS_MAX)
+        {
+            replenishment = &budget->replenishments[(budget->replenishment_head + budget->replenishment_count) %
+                                                    BUDGET_REPLENISHMENTS_MAX];
+            replenishment->amount = 0;
+            budget->replenishment_count++;
+        }
+        else
+        {
+            replenishment = &budget->replenishments[(budget->replenishment_head + BUDGET_REPLENISHMENTS_MAX - 1) %
+                                                    BUDGET_REPLENISHMENTS_MAX];
+        }
+        replenishment->due = budget->activation + budget_periods[task];
+        replenishment->amount += budget->consumed;
+        budget->consumed = 0;
+    }
+    budget->active = false;
+}
+
+/*
+ * Charge the cycles since the last scheduling decision to the task that executed them.
+ * The active period of the task ends when it exhausts its budget or when it blocks.
+ */
+static RAMFUNC void
+budget_charge(const {{prefix_type}}TaskId task)
+{
+    const uint32_t now = cycle_counter_get();
+    const uint32_t elapsed = now - budget_switch_in;
+    struct budget *const budget = &budgets[task];
+
+    budget_switch_in = now;
+
+    if (budget_limited(task))
+    {
+        budget->remaining -= (int32_t) elapsed;
+        budget->consumed += elapsed;
+
+        if (budget->remaining <= 0)
+        {
+            budget_post(task);
+{{#budget_overrun}}
+            {{budget_overrun}}(task);
+{{/budget_overrun}}
+        }
+        else if (!sched_runnable(task))
+        {
+            budget_post(task);
+        }
+    }
+}
+
+/*
+ * Block a task the scheduler selected if its budget is exhausted, until budget_replenish_process() makes it runnable
+ * again.
+ */
+static RAMFUNC bool
+budget_throttle(const {{prefix_type}}TaskId task)
+{
+    if (budget_limited(task) && budgets[task].remaining <= 0)
+    {
+        sched_set_blocked(task);
+        budgets[task].throttled = true;
+        return true;
+    }
+
+    return false;
+}
+
+static RAMFUNC void
+budget_replenish_process(void)
+{
+    {{prefix_type}}TaskId task;
+    struct budget *budget;
+    struct budget_replenishment *replenishment;
+
+    /* loop bound: {{tasks.length}} */
+    for (task = {{prefix_const}}TASK_ID_ZERO; task <= {{prefix_const}}TASK_ID_MAX; task++)
+    {
+        budget = &budgets[task];
+        /* loop bound: 4 */
+        while (budget->replenishment_count != 0)
+        {
+            replenishment = &budget->replenishments[budget->replenishment_head];
+            if ((int32_t) ({{prefix_func}}timer_current_ticks - replenishment->due) < 0)
+            {
+                break;
+            }
+
+            budget->remaining += (int32_t) replenishment->amount;
+            if (budget->remaining > (int32_t) budget_capacities[task])
+            {
+                budget->remaining = (int32_t) budget_capacities[task];
+            }
+            budget->replenishment_head = (budget->replenishment_head + 1) % BUDGET_REPLENISHMENTS_MAX;
+            budget->replenishment_count--;
+        }
+
+        if (budget->throttled && budget->remaining > 0)
+        {
+            budget->throttled = false;
+            sched_set_runnable(task);
+        }
+    }
+}
+
+/*
+ * A task that is switched out ends its active period, so that its replenishment is scheduled relative to when it
+ * started running rather than to when it next runs.
+ * The cycles executed between budget_charge() and this function, i.e., by the scheduler and while the system is idle,
+ * are not charged to any task.
+ */
+static RAMFUNC void
+budget_switch(const {{prefix_type}}TaskId from, const {{prefix_type}}TaskId to)
+{
+    if (from != to && budgets[from].active)
+    {
+        budget_post(from);
+    }
+
+    if (!budgets[to].active)
+    {
+        budget_activate(to);
+    }
+
+    budget_switch_in = cycle_counter_get();
+}
+{{/budgets}}
+
+/*| public_functions |*/
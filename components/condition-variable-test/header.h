@@ -0,0 +1,26 @@
+/*| public_headers |*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*| public_types |*/
+typedef uint8_t {{prefix_type}}TaskId;
+typedef uint16_t {{prefix_type}}TicksRelative;
+typedef uint32_t {{prefix_type}}TicksAbsolute;
+
+/*| public_structures |*/
+
+/*| public_object_like_macros |*/
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+
+/*| public_function_like_macros |*/
+
+/*| public_state |*/
+extern {{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+
+/*| public_function_declarations |*/
+void pub_cond_init(void);
+void pub_set_current_task({{prefix_type}}TaskId task_id);
+void pub_set_block_ptr(void (*y)({{prefix_type}}TaskId));
+void pub_set_block_timeout_ptr(void (*y)({{prefix_type}}TicksRelative));
+void pub_set_preempt_ptr(void (*y)(void));
@@ -0,0 +1,218 @@
+/*| headers |*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rtos-condition-variable-test.h"
+
+/*| object_like_macros |*/
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+
+/*| types |*/
+typedef {{prefix_type}}TaskId TaskIdOption;
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+static void test_block(TaskIdOption blocker) {{prefix_const}}REENTRANT;
+static void mutex_core_block_on({{prefix_type}}TaskId blocker) {{prefix_const}}REENTRANT;
+static void cond_core_block(void) {{prefix_const}}REENTRANT;
+static void cond_core_block_timeout({{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT;
+static void test_unblock({{prefix_type}}TaskId task);
+static void test_preempt_enable(void);
+static {{prefix_type}}TaskId get_current_task(void);
+
+/*| state |*/
+static {{prefix_type}}TaskId current_task;
+static bool preemption_disabled;
+static bool preemption_pending;
+static void (*block_ptr)({{prefix_type}}TaskId);
+static void (*block_timeout_ptr)({{prefix_type}}TicksRelative);
+static void (*preempt_ptr)(void);
+{{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+bool pub_unblocked[{{tasks.length}}];
+uint8_t pub_deadlocks;
+uint8_t pub_preemption_errors;
+
+/*| function_like_macros |*/
+#define preempt_disable() (preemption_disabled = true)
+#define preempt_enable() test_preempt_enable()
+#define precondition_preemption_disabled() \
+    do { if (!preemption_disabled) { pub_preemption_errors++; } } while (0)
+#define postcondition_preemption_disabled() precondition_preemption_disabled()
+#define api_assert(expression, error_id) do { } while(0)
+#define mutex_core_unblock(task) test_unblock(task)
+#define cond_core_unblock(task) test_unblock(task)
+#define cond_core_higher_priority(t1, t2) ((t1) < (t2))
+
+/*| functions |*/
+/*
+ * While the current task is blocked, other tasks run in the block function that the test sets.
+ * The block function receives the task that holds the mutex the current task waits for, if any.
+ * Each block function runs once, so that the test lays out exactly which tasks run at which point.
+ * When no other task runs, nothing can unblock the current task.
+ * Instead of blocking forever, the task records the deadlock and stops waiting, so that a failing test does not hang.
+ */
+static void
+test_block(const TaskIdOption blocker) {{prefix_const}}REENTRANT
+{
+    const {{prefix_type}}TaskId task = current_task;
+    void (*const block)({{prefix_type}}TaskId) = block_ptr;
+
+    precondition_preemption_disabled();
+
+    pub_unblocked[task] = false;
+    block_ptr = NULL;
+    if (block != NULL)
+    {
+        /* Other tasks start with preemption enabled */
+        preemption_disabled = false;
+        block(blocker);
+        preemption_disabled = true;
+    }
+    current_task = task;
+
+    if (!pub_unblocked[task])
+    {
+        pub_deadlocks++;
+        cond_waiters[task] = COND_ID_NONE;
+        if (mutex_waiters[task] != MUTEX_ID_NONE)
+        {
+            mutexes[mutex_waiters[task]].holder = TASK_ID_NONE;
+            mutex_waiters[task] = MUTEX_ID_NONE;
+        }
+    }
+}
+
+static void
+mutex_core_block_on(const {{prefix_type}}TaskId blocker) {{prefix_const}}REENTRANT
+{
+    test_block(blocker);
+}
+
+static void
+cond_core_block(void) {{prefix_const}}REENTRANT
+{
+    test_block(TASK_ID_NONE);
+}
+
+/*
+ * Without a block function, no other task runs and the timeout expires.
+ */
+static void
+cond_core_block_timeout(const {{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT
+{
+    const {{prefix_type}}TaskId task = current_task;
+    void (*const block_timeout)({{prefix_type}}TicksRelative) = block_timeout_ptr;
+
+    precondition_preemption_disabled();
+
+    pub_unblocked[task] = false;
+    block_timeout_ptr = NULL;
+    if (block_timeout != NULL)
+    {
+        preemption_disabled = false;
+        block_timeout(timeout);
+        preemption_disabled = true;
+    }
+    else
+    {
+        {{prefix_func}}timer_current_ticks += timeout;
+    }
+    current_task = task;
+}
+
+static void
+test_unblock(const {{prefix_type}}TaskId task)
+{
+    precondition_preemption_disabled();
+
+    pub_unblocked[task] = true;
+    preemption_pending = true;
+}
+
+/*
+ * An unblocked task preempts the current task as soon as preemption is enabled again, if the test sets a preempt
+ * function.
+ */
+static void
+test_preempt_enable(void)
+{
+    const {{prefix_type}}TaskId task = current_task;
+    void (*const preempt)(void) = preempt_ptr;
+
+    preemption_disabled = false;
+    if (preemption_pending)
+    {
+        preemption_pending = false;
+        if (preempt != NULL)
+        {
+            preempt_ptr = NULL;
+            preempt();
+            current_task = task;
+        }
+    }
+}
+
+static {{prefix_type}}TaskId
+get_current_task(void)
+{
+    return current_task;
+}
+
+/*| public_functions |*/
+
+struct mutex * pub_mutexes = mutexes;
+
+void
+pub_cond_init(void)
+{
+    {{prefix_type}}MutexId mutex_id;
+    {{prefix_type}}TaskId task_id;
+
+    /* For testing purposes, all mutexes and waiters are reset, too */
+    for (mutex_id = {{prefix_const}}MUTEX_ID_ZERO; mutex_id <= {{prefix_const}}MUTEX_ID_MAX; mutex_id++)
+    {
+        mutexes[mutex_id].holder = TASK_ID_NONE;
+    }
+    for (task_id = {{prefix_const}}TASK_ID_ZERO; task_id <= {{prefix_const}}TASK_ID_MAX; task_id++)
+    {
+        mutex_waiters[task_id] = MUTEX_ID_NONE;
+        cond_waiters[task_id] = COND_ID_NONE;
+        pub_unblocked[task_id] = false;
+    }
+    current_task = {{prefix_const}}TASK_ID_ZERO;
+    preemption_disabled = false;
+    preemption_pending = false;
+    block_ptr = NULL;
+    block_timeout_ptr = NULL;
+    preempt_ptr = NULL;
+    {{prefix_func}}timer_current_ticks = 0;
+    pub_deadlocks = 0;
+    pub_preemption_errors = 0;
+}
+
+void
+pub_set_current_task(const {{prefix_type}}TaskId task_id)
+{
+    current_task = task_id;
+}
+
+void
+pub_set_block_ptr(void (*y)({{prefix_type}}TaskId))
+{
+    block_ptr = y;
+}
+
+void
+pub_set_block_timeout_ptr(void (*y)({{prefix_type}}TicksRelative))
+{
+    block_timeout_ptr = y;
+}
+
+void
+pub_set_preempt_ptr(void (*y)(void))
+{
+    preempt_ptr = y;
+}
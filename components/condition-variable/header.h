@@ -0,0 +1,30 @@
+/*| public_headers |*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*| public_types |*/
+typedef uint8_t {{prefix_type}}CondId;
+
+/*| public_structures |*/
+
+/*| public_object_like_macros |*/
+{{#condition_variables.length}}
+#define {{prefix_const}}COND_ID_ZERO (({{prefix_type}}CondId) UINT8_C(0))
+#define {{prefix_const}}COND_ID_MAX (({{prefix_type}}CondId) UINT8_C({{condition_variables.length}} - 1))
+{{#condition_variables}}
+#define {{prefix_const}}COND_ID_{{name|u}} (({{prefix_type}}CondId) UINT8_C({{idx}}))
+{{/condition_variables}}
+{{/condition_variables.length}}
+
+/*| public_function_like_macros |*/
+
+/*| public_state |*/
+
+/*| public_function_declarations |*/
+{{#condition_variables.length}}
+void {{prefix_func}}cond_wait({{prefix_type}}CondId cond, {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT;
+bool {{prefix_func}}cond_wait_timeout({{prefix_type}}CondId cond, {{prefix_type}}MutexId m,
+                                    {{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT;
+void {{prefix_func}}cond_signal({{prefix_type}}CondId cond);
+void {{prefix_func}}cond_broadcast({{prefix_type}}CondId cond);
+{{/condition_variables.length}}
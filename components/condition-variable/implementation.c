@@ -0,0 +1,155 @@
+/*| headers |*/
+
+/*| object_like_macros |*/
+{{#condition_variables.length}}
+#define COND_ID_NONE ((CondIdOption) UINT8_MAX)
+{{/condition_variables.length}}
+
+/*| types |*/
+typedef {{prefix_type}}CondId CondIdOption;
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+{{#condition_variables.length}}
+static void cond_wake({{prefix_type}}CondId cond, bool all);
+{{/condition_variables.length}}
+
+/*| state |*/
+{{#condition_variables.length}}
+/* The condition variable each task waits on, if any.
+ * A task waiting on a condition variable holds no mutex and is blocked without a blocker, so no task inherits its
+ * priority until it is woken up and waits for the mutex again. */
+static CondIdOption cond_waiters[{{tasks.length}}] = {
+{{#tasks}}
+    COND_ID_NONE,
+{{/tasks}}
+};
+{{/condition_variables.length}}
+
+/*| function_like_macros |*/
+{{#condition_variables.length}}
+#define assert_cond_valid(cond) api_assert(cond < {{condition_variables.length}}, ERROR_ID_INVALID_ID)
+{{/condition_variables.length}}
+
+/*| functions |*/
+{{#condition_variables.length}}
+static void
+cond_wake(const {{prefix_type}}CondId cond, const bool all)
+{
+    {{prefix_type}}TaskId t;
+    TaskIdOption waiter = TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    /* loop bound: {{tasks.length}} */
+    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+    {
+        if (cond_waiters[t] == cond)
+        {
+            if (all)
+            {
+                cond_waiters[t] = COND_ID_NONE;
+                cond_core_unblock(t);
+            }
+            else if (waiter == TASK_ID_NONE || cond_core_higher_priority(t, waiter))
+            {
+                waiter = t;
+            }
+        }
+    }
+
+    if (waiter != TASK_ID_NONE)
+    {
+        cond_waiters[waiter] = COND_ID_NONE;
+        cond_core_unblock(waiter);
+    }
+
+    postcondition_preemption_disabled();
+}
+{{/condition_variables.length}}
+
+/*| public_functions |*/
+{{#condition_variables.length}}
+void
+{{prefix_func}}cond_wait(const {{prefix_type}}CondId cond, const {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT
+{
+    assert_cond_valid(cond);
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    /* With preemption disabled, no other task can signal the condition variable between releasing the mutex and
+     * blocking, so the wakeup cannot be lost. */
+    cond_waiters[get_current_task()] = cond;
+    mutex_release(m);
+
+    /* The task may also receive the blocking signal for reasons other than being woken up, e.g., a stale signal of an
+     * earlier timeout, so block until it is actually removed from the waiters. */
+    do
+    {
+        cond_core_block();
+    } while (cond_waiters[get_current_task()] == cond);
+
+    (void) mutex_acquire(m);
+
+    preempt_enable();
+}
+
+bool
+{{prefix_func}}cond_wait_timeout(const {{prefix_type}}CondId cond, const {{prefix_type}}MutexId m,
+                                 const {{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT
+{
+    bool signaled;
+    const {{prefix_type}}TicksAbsolute absolute_timeout = {{prefix_func}}timer_current_ticks + timeout;
+
+    assert_cond_valid(cond);
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    cond_waiters[get_current_task()] = cond;
+    mutex_release(m);
+
+    while (cond_waiters[get_current_task()] == cond && absolute_timeout > {{prefix_func}}timer_current_ticks)
+    {
+        cond_core_block_timeout(absolute_timeout - {{prefix_func}}timer_current_ticks);
+    }
+    signaled = cond_waiters[get_current_task()] != cond;
+    cond_waiters[get_current_task()] = COND_ID_NONE;
+
+    (void) mutex_acquire(m);
+
+    preempt_enable();
+
+    return signaled;
+}
+
+void
+{{prefix_func}}cond_signal(const {{prefix_type}}CondId cond)
+{
+    assert_cond_valid(cond);
+
+    preempt_disable();
+
+    cond_wake(cond, false);
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}cond_broadcast(const {{prefix_type}}CondId cond)
+{
+    assert_cond_valid(cond);
+
+    preempt_disable();
+
+    cond_wake(cond, true);
+
+    preempt_enable();
+}
+{{/condition_variables.length}}
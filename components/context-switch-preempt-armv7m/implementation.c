@@ -93,7 +93,8 @@
  * This reflects our desire for the RTOS to be able to manually yield (via svc) when preemption is disabled.
  *
  * Some platforms do not implement the low 4 bits of priority.
- * Thus, we choose priority values that are distinct regardless of the lower 4 bits. */
+ * Thus, we choose priority values that are distinct regardless of the lower 4 bits.
+ * The armv7m.vectable module validates the configured interrupt priorities against these values. */
 
 #define SVCALL_PRIORITY 224u
 #define PENDSV_PRIORITY 240u
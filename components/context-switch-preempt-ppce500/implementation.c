@@ -226,6 +226,7 @@ preempt_irq_invoke_scheduler(void)
 
     /* While interrupts are enabled in the following do-loop, another interrupt may set preempt_pending back to true,
      * but the precondition that preemption is disabled ensures we don't get runaway interrupt recursion. */
+    /* loop bound: retries */
     do {
         interrupts_enable();
 
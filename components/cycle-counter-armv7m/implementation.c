@@ -0,0 +1,49 @@
+/*| headers |*/
+#include <stdint.h>
+
+/*| object_like_macros |*/
+{{#cycle_counter}}
+#define DEMCR_PHYSADDR 0xE000EDFC
+#define DEMCR_TRCENA (1u << 24)
+#define DWT_CTRL_PHYSADDR 0xE0001000
+#define DWT_CTRL_CYCCNTENA (1u << 0)
+#define DWT_CYCCNT_PHYSADDR 0xE0001004
+{{/cycle_counter}}
+
+/*| types |*/
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+{{#cycle_counter}}
+static void cycle_counter_init(void);
+{{/cycle_counter}}
+
+/*| state |*/
+
+/*| function_like_macros |*/
+{{#cycle_counter}}
+#define cycle_counter_get() (*((volatile uint32_t *) DWT_CYCCNT_PHYSADDR))
+{{/cycle_counter}}
+
+/*| functions |*/
+{{#cycle_counter}}
+/*
+ * The cycle counter is the DWT CYCCNT register, which counts processor clock cycles and wraps around every 2^32
+ * cycles.
+ * The DWT unit is only powered when DEMCR.TRCENA is set, which debuggers may also do.
+ */
+static void
+cycle_counter_init(void)
+{
+    volatile uint32_t *const demcr = (volatile uint32_t *) DEMCR_PHYSADDR;
+    volatile uint32_t *const dwt_ctrl = (volatile uint32_t *) DWT_CTRL_PHYSADDR;
+
+    *demcr |= DEMCR_TRCENA;
+    *dwt_ctrl |= DWT_CTRL_CYCCNTENA;
+}
+{{/cycle_counter}}
+
+/*| public_functions |*/
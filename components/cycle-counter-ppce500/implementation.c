@@ -0,0 +1,53 @@
+/*| headers |*/
+#include <stdint.h>
+
+/*| object_like_macros |*/
+
+/*| types |*/
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+{{#cycle_counter}}
+static void cycle_counter_init(void);
+static uint32_t cycle_counter_get(void);
+{{/cycle_counter}}
+
+/*| state |*/
+
+/*| function_like_macros |*/
+
+/*| functions |*/
+{{#cycle_counter}}
+/*
+ * The cycle counter is the lower 32 bits of the e500 time base, which counts at the rate selected by HID0[SEL_TBCLK]
+ * rather than at the processor clock.
+ */
+static void
+cycle_counter_init(void)
+{
+    /* Set HID0[TBEN] to enable the time base.
+     * A context-synchronising instruction is required before and after mtspr HID0 by the e500 Reference Manual. */
+    asm volatile(
+        "mfspr %%r3,1008\n"
+        "ori %%r3,%%r3,0x4000\n" /* 0x4000 = HID0[TBEN] */
+        "isync\n"
+        "mtspr 1008,%%r3\n"
+        "isync"
+        ::: "r3");
+}
+
+static uint32_t
+cycle_counter_get(void)
+{
+    uint32_t tbl;
+
+    asm volatile("mftb %0" : "=r" (tbl));
+
+    return tbl;
+}
+{{/cycle_counter}}
+
+/*| public_functions |*/
@@ -0,0 +1,24 @@
+/*| headers |*/
+#include <stdint.h>
+
+/*| object_like_macros |*/
+
+/*| types |*/
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+
+/*| state |*/
+
+/*| function_like_macros |*/
+{{#cycle_counter}}
+#define cycle_counter_init()
+#define cycle_counter_get() ((uint32_t) 0)
+{{/cycle_counter}}
+
+/*| functions |*/
+
+/*| public_functions |*/
@@ -34,6 +34,14 @@
 #define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED (({{prefix_type}}ErrorId) UINT8_C(29))
 #define ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX (({{prefix_type}}ErrorId) UINT8_C(30))
 #define ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED (({{prefix_type}}ErrorId) UINT8_C(31))
+#define ERROR_ID_SCHED_EDF_TASK_NOT_PERIODIC (({{prefix_type}}ErrorId) UINT8_C(32))
+#define ERROR_ID_TIMER_TASK_NOT_PERIODIC (({{prefix_type}}ErrorId) UINT8_C(33))
+#define ERROR_ID_POOL_INVALID_BLOCK (({{prefix_type}}ErrorId) UINT8_C(34))
+#define ERROR_ID_BROADCAST_NOT_SUBSCRIBED (({{prefix_type}}ErrorId) UINT8_C(35))
+#define ERROR_ID_BROADCAST_INVALID_POINTER (({{prefix_type}}ErrorId) UINT8_C(36))
+#define ERROR_ID_WORK_QUEUE_INVALID_FUNCTION (({{prefix_type}}ErrorId) UINT8_C(37))
+#define ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS (({{prefix_type}}ErrorId) UINT8_C(38))
+#define ERROR_ID_TIMEBASE_TIME_TOO_FAR (({{prefix_type}}ErrorId) UINT8_C(39))
 
 /*| types |*/
 
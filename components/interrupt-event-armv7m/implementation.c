@@ -1,6 +1,6 @@
 /*| headers |*/
-{{#interrupt_events.length}}
 #include <stdint.h>
+{{#interrupt_events.length}}
 #include <stdbool.h>
 #include "bitband.h"
 {{/interrupt_events.length}}
@@ -8,6 +8,8 @@
 /*| object_like_macros |*/
 #define interrupt_event rtos_internal_interrupt_event
 #define interrupt_event_bitband rtos_internal_interrupt_event_bitband
+#define SCR_PHYSADDR 0xE000ED10
+#define SCR_SEVONPEND (1u << 4)
 
 /*| types |*/
 
@@ -33,6 +35,7 @@ interrupt_event_process(void)
 {
 {{#interrupt_events.length}}
     uint32_t tmp = interrupt_event;
+    /* loop bound: {{interrupt_events.length}} */
     while (tmp != 0)
     {
         const {{prefix_type}}InterruptEventId i = __builtin_ffs(tmp) - 1;
@@ -54,16 +57,22 @@ interrupt_application_event_check(void)
 {{/interrupt_events.length}}
 }
 
+/*
+ * Waiting for an interrupt event must not mask interrupts, so that the RTOS never delays zero-latency interrupts.
+ * Instead, SEVONPEND makes every interrupt that becomes pending set the event register.
+ * An interrupt that occurs after the check therefore causes the wfe to return immediately rather than being lost.
+ * Spurious returns from wfe are harmless, as the caller checks for interrupt events again.
+ */
 static inline void
 interrupt_event_wait(void)
 {
-    asm volatile("cpsid i");
-    asm volatile("isb");
+    volatile uint32_t *scr = (uint32_t *) SCR_PHYSADDR;
+
+    *scr |= SCR_SEVONPEND;
     if (!interrupt_event_check())
     {
-        asm volatile("wfi");
+        asm volatile("wfe");
     }
-    asm volatile("cpsie i");
 }
 
 /*| public_functions |*/
@@ -69,6 +69,7 @@ interrupt_event_process(void)
 #else
     tmp = interrupt_event;
 #endif
+    /* loop bound: {{interrupt_events.length}} */
     while (tmp != 0)
     {
         /* __builtin_ffs(x) returns 1 + the index of the least significant 1-bit in x, or returns zero if x is 0 */
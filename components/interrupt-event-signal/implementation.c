@@ -30,7 +30,7 @@ struct interrupt_event_handler interrupt_events[{{interrupt_events.length}}] = {
 
 /*| functions |*/
 {{#interrupt_events.length}}
-static void
+static RAMFUNC void
 interrupt_event_handle(const {{prefix_type}}InterruptEventId interrupt_event_id)
 {
     precondition_preemption_disabled();
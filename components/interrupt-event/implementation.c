@@ -21,18 +21,38 @@ static bool system_is_idle;
 #define interrupt_event_get_next() rtos_internal_interrupt_event_get_next()
 
 /*| functions |*/
-{{prefix_type}}TaskId
+RAMFUNC {{prefix_type}}TaskId
 rtos_internal_interrupt_event_get_next(void)
 {
     TaskIdOption next;
+[[#budgets]]
+{{#budgets}}
 
+    budget_charge(get_current_task());
+{{/budgets}}
+[[/budgets]]
+
+    /* loop bound: {{tasks.length}} + 1 */
     for (;;)
     {
         interrupt_event_process();
 [[#timer_process]]
         timer_tick_process();
 [[/timer_process]]
+[[#budgets]]
+{{#budgets}}
+        budget_replenish_process();
+{{/budgets}}
+[[/budgets]]
         next = sched_get_next();
+[[#budgets]]
+{{#budgets}}
+        if (next != TASK_ID_NONE && budget_throttle(next))
+        {
+            continue;
+        }
+{{/budgets}}
+[[/budgets]]
 
         if (next == TASK_ID_NONE)
         {
@@ -47,6 +67,11 @@ rtos_internal_interrupt_event_get_next(void)
     }
 
     internal_assert_task_valid(next);
+[[#budgets]]
+{{#budgets}}
+    budget_switch(get_current_task(), next);
+{{/budgets}}
+[[/budgets]]
 
     return next;
 }
@@ -26,8 +26,11 @@
 #
 
 import os.path
-from prj import Module
+from prj import Module, SystemParseError, xml_error_str
 from operator import itemgetter
+from util.rtos import (configure_budgets, configure_id_sizes, configure_pools, configure_timebase,
+                       configure_timers, configure_work_queues)
+from util.util import LengthList
 
 
 class KochabModule(Module):
@@ -42,6 +45,8 @@ class KochabModule(Module):
 
         # Create builtin signals
         config['signal_labels'].append({'name': '_task_timer', 'idx': len(config['signal_labels'])})
+        if config['work_queues']:
+            config['signal_labels'].append({'name': '_work', 'idx': len(config['signal_labels'])})
 
         # Create signal_set definitions from signal definitions:
         config['signal_sets'] = [{'name': sig['name'], 'value': 1 << sig['idx'], 'singleton': True}
@@ -53,8 +58,12 @@ class KochabModule(Module):
 
         tasks = config['tasks']
         tasks.sort(key=itemgetter('priority'), reverse=True)
+        config['priority_levels'] = LengthList()
         for idx, t in enumerate(tasks):
             t['idx'] = idx
+            # Tasks of equal priority are adjacent after sorting and form a priority level
+            if idx == 0 or t['priority'] != tasks[idx - 1]['priority']:
+                config['priority_levels'].append({'first': idx})
             # Create a timer for each task
             timer = {'name': '_task_' + t['name'],
                      'error': 0,
@@ -65,6 +74,29 @@ class KochabModule(Module):
                      'sig_set': '_task_timer'}
             t['timer'] = timer
             config['timers'].append(timer)
+
+        if not 0 <= config['time_slice'] <= 0xffff:
+            raise SystemParseError(xml_error_str(xml_config, "The time slice must be a relative tick count"))
+
+        configure_budgets(xml_config, config)
+
+        configure_pools(xml_config, config)
+
+        if config['condition_variables'] and not config['mutexes']:
+            raise SystemParseError(xml_error_str(xml_config, "Condition variables require at least one mutex"))
+
+        configure_work_queues(xml_config, config)
+
+        config['atomics'] = len(config['pools']) > 0 or len(config['work_queues']) > 0
+
+        configure_timebase(xml_config, config)
+
+        # The cycle counter is only compiled into systems that use it, so that its functions are never unused
+        config['cycle_counter'] = config['budgets'] or bool(config['timebase'])
+
+        configure_id_sizes(xml_config, config, len(config['signal_labels']))
+        configure_timers(xml_config, config)
         return config
 
+
 module = KochabModule()
@@ -35,7 +35,7 @@ block(void) {{prefix_const}}REENTRANT
     {{prefix_func}}yield();
 }
 
-static void
+static RAMFUNC void
 unblock(const {{prefix_type}}TaskId task)
 {
     sched_set_runnable(task);
@@ -126,6 +126,7 @@ message_queue_invariants_check(void)
                     ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH);
 {{/message_queues}}
 
+    /* loop bound: {{message_queues.length}} */
     for (message_queue = 0; message_queue < {{message_queues.length}}; message_queue += 1)
     {
         const struct message_queue *const mq = &message_queues[message_queue];
@@ -137,6 +138,7 @@ message_queue_invariants_check(void)
                         ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE);
     }
 
+    /* loop bound: {{tasks.length}} */
     for (task = 0; task <= {{prefix_const}}TASK_ID_MAX; task += 1)
     {
         message_queue = message_queue_waiters[task];
@@ -161,7 +163,7 @@ message_queue_invariants_check(void)
      * other timers.
      * The timers of tasks depends not only on the message queue implementation but also on how other components use
      * those task timers. */
-    internal_assert(!timers[task_timers[get_current_task()]].enabled,\
+    internal_assert(!timer_is_enabled(task_timers[get_current_task()]),\
                     ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED);
 }
 
@@ -173,6 +175,7 @@ message_queue_waiters_wakeup(const {{prefix_type}}MessageQueueId message_queue)
 
     message_queue_internal_assert_valid(message_queue);
 
+    /* loop bound: {{tasks.length}} */
     for (task = {{prefix_const}}TASK_ID_ZERO; task <= {{prefix_const}}TASK_ID_MAX; task += 1)
     {
         if (message_queue_waiters[task] == message_queue)
@@ -219,6 +222,7 @@ memcopy(uint8_t *dst, const uint8_t *src, const uint8_t length)
 
     api_assert((dst < src) || (dst >= (src + length)), ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP);
 
+    /* loop bound: 255 */
     while (dst < dst_end)
     {
         *dst++ = *src++;
@@ -26,8 +26,9 @@
 #
 
 import os.path
-from prj import Module
+from prj import Module, SystemParseError, xml_error_str
 from operator import itemgetter
+from util.rtos import configure_id_sizes, configure_pools, configure_timers
 
 
 class PhactModule(Module):
@@ -87,6 +88,15 @@ class PhactModule(Module):
         else:
             config['schedindex_size'] = 8
 
+        configure_pools(xml_config, config)
+
+        if config['condition_variables'] and not config['mutexes']:
+            raise SystemParseError(xml_error_str(xml_config, "Condition variables require at least one mutex"))
+
+        config['atomics'] = len(config['pools']) > 0
+
+        configure_id_sizes(xml_config, config, len(config['signal_labels']))
+        configure_timers(xml_config, config)
         return config
 
 module = PhactModule()
@@ -34,6 +34,11 @@ static {{prefix_type}}TimerId task_timers[{{tasks.length}}] = {
 #define mutex_core_unblock(task) signal_send_set(task, {{prefix_const}}SIGNAL_ID__TASK_TIMER)
 #define sem_core_block() signal_wait({{prefix_const}}SIGNAL_ID__TASK_TIMER)
 #define sem_core_unblock(task) signal_send_set(task, {{prefix_const}}SIGNAL_ID__TASK_TIMER)
+#define cond_core_block() signal_wait({{prefix_const}}SIGNAL_ID__TASK_TIMER)
+#define cond_core_block_timeout(ticks) sem_core_block_timeout(ticks)
+#define cond_core_unblock(task) signal_send_set(task, {{prefix_const}}SIGNAL_ID__TASK_TIMER)
+/* Tasks are sorted by priority, so a lower task ID means a higher priority */
+#define cond_core_higher_priority(task_a, task_b) ((task_a) < (task_b))
 
 /*| functions |*/
 {{#tasks}}
@@ -84,7 +89,7 @@ sem_core_block_timeout(const {{prefix_type}}TicksRelative ticks)
     postcondition_preemption_disabled();
 }
 
-static void
+static RAMFUNC void
 unblock(const {{prefix_type}}TaskId task)
 {
     precondition_preemption_disabled();
@@ -134,6 +139,10 @@ void
     context_init(get_task_context({{idx}}), entry_{{name}}, stack_{{idx}}, {{stack_size}});
     sched_set_runnable({{idx}});
     {{/tasks}}
+{{#pools.length}}
+
+    pool_init();
+{{/pools.length}}
 
     context_switch_first({{prefix_const}}TASK_ID_ZERO);
 }
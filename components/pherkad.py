@@ -0,0 +1,94 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+import os.path
+from prj import Module, SystemParseError, xml_error_str
+from util.rtos import configure_id_sizes, configure_pools, configure_timers
+
+
+class PherkadModule(Module):
+    xml_schema_path = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'schema.xml')
+    files = [
+        {'input': 'rtos-pherkad.h', 'render': True},
+        {'input': 'rtos-pherkad.c', 'render': True, 'type': 'c'},
+    ]
+
+    def configure(self, xml_config):
+        config = super().configure(xml_config)
+
+        # Create builtin signals
+        config['signal_labels'].append({'name': '_task_timer', 'idx': len(config['signal_labels'])})
+        config['signal_labels'].append({'name': '_task_release', 'idx': len(config['signal_labels'])})
+
+        # Create signal_set definitions from signal definitions:
+        config['signal_sets'] = [{'name': sig['name'], 'value': 1 << sig['idx'], 'singleton': True}
+                                 for sig in config['signal_labels']]
+
+        config['prefix_func'] = config['prefix'] + '_' if config['prefix'] is not None else ''
+        config['prefix_type'] = config['prefix'].capitalize() if config['prefix'] is not None else ''
+        config['prefix_const'] = config['prefix'].upper() + '_' if config['prefix'] is not None else ''
+
+        # Unlike the priority-based variants, the scheduler does not depend on the order of the tasks.
+        for t in config['tasks']:
+            # Deadlines and periods are relative tick counts
+            if not 0 < t['deadline'] <= 0xffff or not 0 <= t['period'] <= 0xffff:
+                raise SystemParseError(xml_error_str(xml_config, "The deadline and period of task {} must be "
+                                                     "relative tick counts".format(t['name'])))
+            # Create a timer for each task
+            timer = {'name': '_task_' + t['name'],
+                     'error': 0,
+                     'reload': 0,
+                     'task': t,
+                     'idx': len(config['timers']),
+                     'enabled': False,
+                     'sig_set': '_task_timer'}
+            t['timer'] = timer
+            config['timers'].append(timer)
+
+        # Create a periodic timer that releases each periodic task
+        for t in config['tasks']:
+            if t['period'] > 0:
+                config['timers'].append({'name': '_release_' + t['name'],
+                                         'error': 0,
+                                         'reload': t['period'],
+                                         'task': t,
+                                         'idx': len(config['timers']),
+                                         'enabled': True,
+                                         'sig_set': '_task_release'})
+
+        configure_pools(xml_config, config)
+
+        if config['condition_variables'] and not config['mutexes']:
+            raise SystemParseError(xml_error_str(xml_config, "Condition variables require at least one mutex"))
+
+        config['atomics'] = len(config['pools']) > 0
+
+        configure_id_sizes(xml_config, config, len(config['signal_labels']))
+        configure_timers(xml_config, config)
+        return config
+
+module = PherkadModule()
@@ -0,0 +1,17 @@
+/*| public_headers |*/
+#include <stdint.h>
+
+/*| public_types |*/
+
+/*| public_structures |*/
+
+/*| public_object_like_macros |*/
+
+/*| public_function_like_macros |*/
+
+/*| public_state |*/
+
+/*| public_function_declarations |*/
+void {{prefix_func}}start(void);
+void {{prefix_func}}release_wait(void);
+void {{prefix_func}}deadline_set({{prefix_type}}TicksRelative deadline);
@@ -0,0 +1,171 @@
+/*| headers |*/
+#include "rtos-pherkad.h"
+
+/*| object_like_macros |*/
+
+/*| types |*/
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+{{#tasks}}
+extern void {{function}}(void);
+{{/tasks}}
+
+/*| function_declarations |*/
+static void block_on({{prefix_type}}TaskId blocker);
+{{#mutexes.length}}
+static void mutex_core_block_on_timeout({{prefix_type}}TaskId t, {{prefix_type}}TicksRelative ticks);
+{{/mutexes.length}}
+static void sem_core_block_timeout({{prefix_type}}TicksRelative ticks);
+static void unblock({{prefix_type}}TaskId task);
+
+/*| state |*/
+{{#timers.length}}
+static {{prefix_type}}TimerId task_timers[{{tasks.length}}] = {
+{{#tasks}}
+    {{prefix_const}}TIMER_ID_{{timer.name|u}},
+{{/tasks}}
+};
+{{/timers.length}}
+static const {{prefix_type}}TicksRelative task_deadlines[{{tasks.length}}] = {
+{{#tasks}}
+    {{deadline}},
+{{/tasks}}
+};
+static const {{prefix_type}}TicksRelative task_periods[{{tasks.length}}] = {
+{{#tasks}}
+    {{period}},
+{{/tasks}}
+};
+/* The tick at which each periodic task was most recently released */
+static {{prefix_type}}TicksAbsolute task_releases[{{tasks.length}}];
+
+/*| function_like_macros |*/
+#define block() block_on(TASK_ID_NONE)
+#define mutex_core_block_on(blocker) signal_wait_blocked_on({{prefix_const}}SIGNAL_ID__TASK_TIMER, blocker)
+#define mutex_core_unblock(task) signal_send_set(task, {{prefix_const}}SIGNAL_ID__TASK_TIMER)
+#define sem_core_block() signal_wait({{prefix_const}}SIGNAL_ID__TASK_TIMER)
+#define sem_core_unblock(task) signal_send_set(task, {{prefix_const}}SIGNAL_ID__TASK_TIMER)
+#define cond_core_block() signal_wait({{prefix_const}}SIGNAL_ID__TASK_TIMER)
+#define cond_core_block_timeout(ticks) sem_core_block_timeout(ticks)
+#define cond_core_unblock(task) signal_send_set(task, {{prefix_const}}SIGNAL_ID__TASK_TIMER)
+/* Under EDF scheduling, the task with the earlier deadline has the higher priority */
+#define cond_core_higher_priority(task_a, task_b) sched_deadline_before(sched_deadline_get(task_a), \
+                                                                        sched_deadline_get(task_b))
+
+/*| functions |*/
+{{#tasks}}
+static void
+entry_{{name}}(void)
+{
+    precondition_preemption_disabled();
+
+    preempt_enable();
+    {{function}}();
+}
+{{/tasks}}
+
+static void
+block_on(const {{prefix_type}}TaskId blocker)
+{
+    precondition_preemption_disabled();
+
+    sched_set_blocked_on(get_current_task(), blocker);
+    yield();
+
+    postcondition_preemption_disabled();
+}
+
+{{#mutexes.length}}
+
+static void
+mutex_core_block_on_timeout(const {{prefix_type}}TaskId t, const {{prefix_type}}TicksRelative ticks)
+{
+    precondition_preemption_disabled();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    mutex_core_block_on(t);
+    timer_disable(task_timers[get_current_task()]);
+
+    postcondition_preemption_disabled();
+}
+{{/mutexes.length}}
+
+static void
+sem_core_block_timeout(const {{prefix_type}}TicksRelative ticks)
+{
+    precondition_preemption_disabled();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    sem_core_block();
+    timer_disable(task_timers[get_current_task()]);
+
+    postcondition_preemption_disabled();
+}
+
+static RAMFUNC void
+unblock(const {{prefix_type}}TaskId task)
+{
+    precondition_preemption_disabled();
+
+    sched_set_runnable(task);
+
+    /* Note: When preemption is enabled a yield should be forced as a task with an earlier deadline may have been
+     * scheduled. */
+    preempt_pend();
+
+    postcondition_preemption_disabled();
+}
+
+/*| public_functions |*/
+void
+{{prefix_func}}start(void)
+{
+    sem_init();
+    preempt_init();
+
+    {{#tasks}}
+    context_init(get_task_context({{idx}}), entry_{{name}}, stack_{{idx}}, {{stack_size}});
+    task_releases[{{idx}}] = {{prefix_func}}timer_current_ticks;
+    sched_set_deadline({{idx}}, {{prefix_func}}timer_current_ticks + {{deadline}});
+    sched_set_runnable({{idx}});
+    {{/tasks}}
+{{#pools.length}}
+
+    pool_init();
+{{/pools.length}}
+
+    context_switch_first(sched_get_next());
+}
+
+void
+{{prefix_func}}release_wait(void)
+{
+    const {{prefix_type}}TaskId task = get_current_task();
+
+    api_assert(task_periods[task] != 0, ERROR_ID_SCHED_EDF_TASK_NOT_PERIODIC);
+
+    preempt_disable();
+
+    /* The deadline of the next job is set before waiting for its release.
+     * If the release has already happened, the task continues with the later deadline, so a task with an earlier
+     * deadline may need to be scheduled instead. */
+    task_releases[task] += task_periods[task];
+    sched_set_deadline(task, task_releases[task] + task_deadlines[task]);
+    preempt_pend();
+    signal_wait({{prefix_const}}SIGNAL_ID__TASK_RELEASE);
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}deadline_set(const {{prefix_type}}TicksRelative deadline)
+{
+    preempt_disable();
+
+    sched_set_deadline(get_current_task(), {{prefix_func}}timer_current_ticks + deadline);
+    preempt_pend();
+
+    preempt_enable();
+}
@@ -0,0 +1,54 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+import os.path
+from prj import Module
+from util.rtos import configure_pools
+
+
+class PoolTestModule(Module):
+    xml_schema_path = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'schema.xml')
+    files = [
+        {'input': 'rtos-pool-test.h', 'render': True},
+        {'input': 'rtos-pool-test.c', 'render': True, 'type': 'c'},
+    ]
+
+    def configure(self, xml_config):
+        config = super().configure(xml_config)
+
+        config['prefix_func'] = config['prefix'] + '_' if config['prefix'] is not None else ''
+        config['prefix_type'] = config['prefix'].capitalize() if config['prefix'] is not None else ''
+        config['prefix_const'] = config['prefix'].upper() + '_' if config['prefix'] is not None else ''
+
+        # The test component provides the fatal error function that API assertions call
+        config['fatal_error'] = 'test_fatal_error'
+
+        configure_pools(xml_config, config)
+
+        return config
+
+module = PoolTestModule()
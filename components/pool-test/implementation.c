@@ -0,0 +1,186 @@
+/*| headers |*/
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rtos-pool-test.h"
+
+/*| object_like_macros |*/
+
+/*| types |*/
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+static bool atomic_compare_and_swap(volatile uint32_t *word, uint32_t expected, uint32_t desired);
+static void sem_core_block(void) {{prefix_const}}REENTRANT;
+static void sem_core_block_timeout({{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT;
+static void sem_core_unblock({{prefix_type}}TaskId task);
+static {{prefix_type}}TaskId get_current_task(void);
+
+/*| state |*/
+static {{prefix_type}}TaskId current_task;
+static void (*interrupt_ptr)(void);
+static uint32_t interrupt_compare_and_swap_count;
+static void (*block_ptr)(void);
+static void (*block_timeout_ptr)({{prefix_type}}TicksRelative);
+static jmp_buf fatal_error_jmp_buf;
+static bool fatal_error_jmp_buf_valid;
+{{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+bool pub_unblocked[{{tasks.length}}];
+{{prefix_type}}ErrorId pub_fatal_error_id;
+
+/*| function_like_macros |*/
+#define preempt_disable()
+#define preempt_enable()
+
+/*| functions |*/
+/*
+ * The interrupt, if one is set, occurs immediately before the given compare-and-swap operation, i.e., after the
+ * caller has read the value that it expects.
+ */
+static bool
+atomic_compare_and_swap(volatile uint32_t *const word, const uint32_t expected, const uint32_t desired)
+{
+    void (*const interrupt)(void) = interrupt_ptr;
+
+    if (interrupt != NULL && --interrupt_compare_and_swap_count == 0)
+    {
+        interrupt_ptr = NULL;
+        interrupt();
+    }
+
+    if (*word != expected)
+    {
+        return false;
+    }
+    *word = desired;
+    return true;
+}
+
+/*
+ * While the current task is blocked, other tasks and interrupt handlers run in the block functions that the test sets.
+ */
+static void
+sem_core_block(void) {{prefix_const}}REENTRANT
+{
+    const {{prefix_type}}TaskId task = current_task;
+
+    pub_unblocked[task] = false;
+    if (block_ptr != NULL)
+    {
+        block_ptr();
+    }
+    current_task = task;
+}
+
+static void
+sem_core_block_timeout(const {{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT
+{
+    const {{prefix_type}}TaskId task = current_task;
+
+    pub_unblocked[task] = false;
+    if (block_timeout_ptr != NULL)
+    {
+        block_timeout_ptr(timeout);
+    }
+    current_task = task;
+}
+
+static void
+sem_core_unblock(const {{prefix_type}}TaskId task)
+{
+    pub_unblocked[task] = true;
+}
+
+static {{prefix_type}}TaskId
+get_current_task(void)
+{
+    return current_task;
+}
+
+void
+test_fatal_error(const {{prefix_type}}ErrorId error_id)
+{
+    pub_fatal_error_id = error_id;
+    if (fatal_error_jmp_buf_valid)
+    {
+        longjmp(fatal_error_jmp_buf, 1);
+    }
+}
+
+/*| public_functions |*/
+void
+pub_pool_init(void)
+{
+    {{prefix_type}}PoolId pool;
+    {{prefix_type}}TaskId task_id;
+
+    /* For testing purposes, the usage statistics of the pools are reset, too */
+    pool_init();
+    for (pool = 0; pool < {{pools.length}}; pool++)
+    {
+        pool_states[pool].used = 0;
+        pool_states[pool].high_water_mark = 0;
+    }
+    for (task_id = {{prefix_const}}TASK_ID_ZERO; task_id <= {{prefix_const}}TASK_ID_MAX; task_id++)
+    {
+        pub_unblocked[task_id] = false;
+    }
+    current_task = {{prefix_const}}TASK_ID_ZERO;
+    interrupt_ptr = NULL;
+    block_ptr = NULL;
+    block_timeout_ptr = NULL;
+    {{prefix_func}}timer_current_ticks = 0;
+    pub_fatal_error_id = ERROR_ID_NONE;
+}
+
+void
+pub_set_current_task(const {{prefix_type}}TaskId task_id)
+{
+    current_task = task_id;
+}
+
+void
+pub_set_interrupt_ptr(void (*y)(void), const uint32_t compare_and_swap_count)
+{
+    interrupt_ptr = y;
+    interrupt_compare_and_swap_count = compare_and_swap_count;
+}
+
+void
+pub_set_block_ptr(void (*y)(void))
+{
+    block_ptr = y;
+}
+
+void
+pub_set_block_timeout_ptr(void (*y)({{prefix_type}}TicksRelative))
+{
+    block_timeout_ptr = y;
+}
+
+uint32_t
+pub_pool_head(const {{prefix_type}}PoolId pool)
+{
+    return pool_states[pool].head;
+}
+
+/*
+ * Free a block and return the ID of the fatal error that this raises, which does not return, or ERROR_ID_NONE.
+ */
+{{prefix_type}}ErrorId
+pub_pool_free_fatal_error(const {{prefix_type}}PoolId pool, void *const block)
+{
+    pub_fatal_error_id = ERROR_ID_NONE;
+    if (setjmp(fatal_error_jmp_buf) == 0)
+    {
+        fatal_error_jmp_buf_valid = true;
+        {{prefix_func}}pool_free_from_interrupt(pool, block);
+    }
+    fatal_error_jmp_buf_valid = false;
+
+    return pub_fatal_error_id;
+}
@@ -0,0 +1,28 @@
+/*| public_headers |*/
+#include <stddef.h>
+#include <stdint.h>
+
+/*| public_types |*/
+typedef uint8_t {{prefix_type}}PoolId;
+
+/*| public_structures |*/
+
+/*| public_object_like_macros |*/
+{{#pools}}
+#define {{prefix_const}}POOL_ID_{{name|u}} (({{prefix_type}}PoolId) UINT8_C({{idx}}))
+{{/pools}}
+
+/*| public_function_like_macros |*/
+
+/*| public_state |*/
+
+/*| public_function_declarations |*/
+{{#pools.length}}
+void *{{prefix_func}}pool_alloc({{prefix_type}}PoolId pool);
+void *{{prefix_func}}pool_alloc_wait({{prefix_type}}PoolId pool) {{prefix_const}}REENTRANT;
+void *{{prefix_func}}pool_alloc_timeout({{prefix_type}}PoolId pool, {{prefix_type}}TicksRelative timeout)
+        {{prefix_const}}REENTRANT;
+void {{prefix_func}}pool_free({{prefix_type}}PoolId pool, void *block);
+void {{prefix_func}}pool_free_from_interrupt({{prefix_type}}PoolId pool, void *block);
+uint16_t {{prefix_func}}pool_high_water_mark({{prefix_type}}PoolId pool);
+{{/pools.length}}
@@ -0,0 +1,266 @@
+/*| headers |*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*| object_like_macros |*/
+{{#pools.length}}
+#define POOL_ID_NONE ((PoolIdOption) UINT8_MAX)
+#define POOL_BLOCK_NONE ((uint16_t) UINT16_MAX)
+#ifdef __GNUC__
+#define POOL_ALIGNED(alignment) __attribute__((aligned(alignment)))
+#else
+#define POOL_ALIGNED(alignment)
+#endif
+{{/pools.length}}
+
+/*| types |*/
+typedef {{prefix_type}}PoolId PoolIdOption;
+
+/*| structures |*/
+{{#pools.length}}
+struct pool {
+    uint8_t *storage;
+    uint16_t block_stride;
+    uint16_t block_count;
+};
+
+/*
+ * The free blocks of a pool form a singly-linked list, with the index of the next free block stored in the first two
+ * bytes of each free block.
+ * The head of the list is a word that holds the index of the first free block in its lower half and a tag in its upper
+ * half.
+ * Every update of the head increments the tag, so that a compare-and-swap based on an outdated head fails even if the
+ * same block has been allocated and freed again in the meantime (the ABA problem).
+ */
+struct pool_state {
+    volatile uint32_t head;
+    volatile uint32_t used;
+    volatile uint32_t high_water_mark;
+};
+{{/pools.length}}
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+{{#pools.length}}
+static void pool_init(void);
+static void *pool_try_alloc({{prefix_type}}PoolId pool);
+static void pool_used_add({{prefix_type}}PoolId pool, int32_t delta);
+{{/pools.length}}
+
+/*| state |*/
+{{#pools.length}}
+{{#pools}}
+static uint8_t pool_storage_{{name}}[{{block_count}}U * {{stride}}U] POOL_ALIGNED({{alignment}});
+{{/pools}}
+static const struct pool pools[{{pools.length}}] = {
+{{#pools}}
+    { pool_storage_{{name}}, {{stride}}U, {{block_count}}U },
+{{/pools}}
+};
+static struct pool_state pool_states[{{pools.length}}];
+static PoolIdOption pool_waiters[{{tasks.length}}];
+{{/pools.length}}
+
+/*| function_like_macros |*/
+{{#pools.length}}
+#define pool_block(pool, index) (&pools[pool].storage[(uint32_t) (index) * pools[pool].block_stride])
+#define pool_block_next(block) (*((volatile uint16_t *) (block)))
+#define pool_head_index(head) ((uint16_t) ((head) & 0xffffU))
+#define pool_head_next(head, index) (((((head) >> 16) + 1U) << 16) | (uint32_t) (index))
+{{/pools.length}}
+#define assert_pool_valid(pool) api_assert(pool < {{pools.length}}, ERROR_ID_INVALID_ID)
+
+/*| functions |*/
+{{#pools.length}}
+static void
+pool_init(void)
+{
+    {{prefix_type}}PoolId pool;
+    {{prefix_type}}TaskId t;
+    uint16_t index;
+
+    for (pool = 0; pool < {{pools.length}}; pool++)
+    {
+        for (index = 0; index < pools[pool].block_count; index++)
+        {
+            pool_block_next(pool_block(pool, index)) = index + 1U < pools[pool].block_count ? index + 1U : POOL_BLOCK_NONE;
+        }
+        pool_states[pool].head = 0;
+    }
+
+    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+    {
+        pool_waiters[t] = POOL_ID_NONE;
+    }
+}
+
+static void
+pool_used_add(const {{prefix_type}}PoolId pool, const int32_t delta)
+{
+    struct pool_state *const state = &pool_states[pool];
+    uint32_t used;
+    uint32_t high_water_mark;
+
+    /* loop bound: retries */
+    do
+    {
+        used = state->used;
+    } while (!atomic_compare_and_swap(&state->used, used, used + (uint32_t) delta));
+
+    used += (uint32_t) delta;
+    /* loop bound: retries */
+    do
+    {
+        high_water_mark = state->high_water_mark;
+    } while (used > high_water_mark && !atomic_compare_and_swap(&state->high_water_mark, high_water_mark, used));
+}
+
+static RAMFUNC void *
+pool_try_alloc(const {{prefix_type}}PoolId pool)
+{
+    struct pool_state *const state = &pool_states[pool];
+    uint32_t head;
+    uint16_t index;
+    uint8_t *block;
+
+    /* loop bound: retries */
+    do
+    {
+        head = state->head;
+        index = pool_head_index(head);
+        if (index == POOL_BLOCK_NONE)
+        {
+            return NULL;
+        }
+        block = pool_block(pool, index);
+        /* If another allocation takes the block before the compare-and-swap, next may be garbage, but then the tag of
+         * the head has changed and the compare-and-swap fails. */
+    } while (!atomic_compare_and_swap(&state->head, head, pool_head_next(head, pool_block_next(block))));
+
+    pool_used_add(pool, 1);
+
+    return block;
+}
+{{/pools.length}}
+
+/*| public_functions |*/
+{{#pools.length}}
+void *
+{{prefix_func}}pool_alloc(const {{prefix_type}}PoolId pool)
+{
+    assert_pool_valid(pool);
+
+    return pool_try_alloc(pool);
+}
+
+void *
+{{prefix_func}}pool_alloc_wait(const {{prefix_type}}PoolId pool) {{prefix_const}}REENTRANT
+{
+    void *block;
+
+    assert_pool_valid(pool);
+
+    preempt_disable();
+
+    while ((block = pool_try_alloc(pool)) == NULL)
+    {
+        pool_waiters[get_current_task()] = pool;
+        sem_core_block();
+    }
+    /* A block freed by an interrupt handler does not make the task runnable, so it may still be a waiter */
+    pool_waiters[get_current_task()] = POOL_ID_NONE;
+
+    preempt_enable();
+
+    return block;
+}
+
+void *
+{{prefix_func}}pool_alloc_timeout(const {{prefix_type}}PoolId pool, const {{prefix_type}}TicksRelative timeout)
+        {{prefix_const}}REENTRANT
+{
+    void *block;
+    const {{prefix_type}}TicksAbsolute absolute_timeout = {{prefix_func}}timer_current_ticks + timeout;
+
+    assert_pool_valid(pool);
+
+    preempt_disable();
+
+    while ((block = pool_try_alloc(pool)) == NULL && absolute_timeout > {{prefix_func}}timer_current_ticks)
+    {
+        pool_waiters[get_current_task()] = pool;
+        sem_core_block_timeout(absolute_timeout - {{prefix_func}}timer_current_ticks);
+    }
+    pool_waiters[get_current_task()] = POOL_ID_NONE;
+
+    preempt_enable();
+
+    return block;
+}
+
+void
+{{prefix_func}}pool_free(const {{prefix_type}}PoolId pool, void *const block)
+{
+    {{prefix_type}}TaskId t;
+
+    {{prefix_func}}pool_free_from_interrupt(pool, block);
+
+    preempt_disable();
+
+    /* loop bound: {{tasks.length}} */
+    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+    {
+        if (pool_waiters[t] == pool)
+        {
+            pool_waiters[t] = POOL_ID_NONE;
+            sem_core_unblock(t);
+        }
+    }
+
+    preempt_enable();
+}
+
+/*
+ * Interrupt handlers must not unblock tasks, so tasks waiting for a block of the pool only notice a block freed by an
+ * interrupt handler when a task frees a block or their timeout expires.
+ */
+void
+{{prefix_func}}pool_free_from_interrupt(const {{prefix_type}}PoolId pool, void *const block)
+{
+    struct pool_state *state;
+    uint32_t offset;
+    uint16_t index;
+    uint32_t head;
+
+    assert_pool_valid(pool);
+    api_assert((uint8_t *) block >= pools[pool].storage, ERROR_ID_POOL_INVALID_BLOCK);
+
+    state = &pool_states[pool];
+    offset = (uint32_t) ((uint8_t *) block - pools[pool].storage);
+    index = (uint16_t) (offset / pools[pool].block_stride);
+    api_assert(offset % pools[pool].block_stride == 0 && offset / pools[pool].block_stride < pools[pool].block_count,
+               ERROR_ID_POOL_INVALID_BLOCK);
+    /* A block that is freed twice without being allocated in between is detected if it is still the first free block,
+     * or if no block of the pool is allocated. */
+    api_assert(pool_head_index(state->head) != index && state->used != 0, ERROR_ID_POOL_INVALID_BLOCK);
+
+    /* loop bound: retries */
+    do
+    {
+        head = state->head;
+        pool_block_next(block) = pool_head_index(head);
+    } while (!atomic_compare_and_swap(&state->head, head, pool_head_next(head, index)));
+
+    pool_used_add(pool, -1);
+}
+
+uint16_t
+{{prefix_func}}pool_high_water_mark(const {{prefix_type}}PoolId pool)
+{
+    assert_pool_valid(pool);
+
+    return (uint16_t) pool_states[pool].high_water_mark;
+}
+{{/pools.length}}
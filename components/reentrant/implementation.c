@@ -1,6 +1,15 @@
 /*| headers |*/
 
 /*| object_like_macros |*/
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
 
 /*| types |*/
 
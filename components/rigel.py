@@ -27,6 +27,8 @@
 
 import os.path
 from prj import SystemParseError, Module
+from util.rtos import configure_id_sizes, configure_timers
+from util.util import LengthList
 
 
 class RigelModule(Module):
@@ -51,7 +53,6 @@ class RigelModule(Module):
         # These are configurable in the code, but for simplicitly they are not supported as
         # user configuration at this stage.
         config['interrupteventid_size'] = 8
-        config['taskid_size'] = 8
 
         # Create builtin signals
         # The RTOS task timer signal is used in the following conditions:
@@ -77,6 +78,9 @@ class RigelModule(Module):
         for sig in config['signal_labels']:
             sig['idx'] = label_ids[sig['name']]
 
+        # Signal sets have a bit for each signal value
+        configure_id_sizes(xml_config, config, max(label_ids.values()) + 1)
+
         # Create signal_set definitions from signal definitions:
         config['signal_sets'] = [{'name': sig['name'], 'value': 1 << sig['idx'], 'singleton': True}
                                  for sig in config['signal_labels']]
@@ -93,6 +97,42 @@ class RigelModule(Module):
                 msg = "Unknown signal-set '{}' in timer '{}'"
                 raise SystemParseError(msg.format(timer['sig_set'], timer['name']))
 
+        # Create the subscriptions of all broadcast channels
+        # The subscriptions of each channel are adjacent so that a channel can iterate over them by index.
+        config['broadcast_subscriptions'] = LengthList()
+        for broadcast in config['broadcasts']:
+            if broadcast['sig_set'] not in signal_set_names:
+                msg = "Unknown signal-set '{}' in broadcast '{}'"
+                raise SystemParseError(msg.format(broadcast['sig_set'], broadcast['name']))
+            if not 0 < broadcast['length'] < 256:
+                msg = "The length of broadcast '{}' must be between 1 and 255"
+                raise SystemParseError(msg.format(broadcast['name']))
+            broadcast['first_subscription'] = len(config['broadcast_subscriptions'])
+            sig = next(sig for sig in config['signal_labels'] if sig['name'] == broadcast['sig_set'])
+            for task in broadcast['subscribers']:
+                if not sig.get('global', False) and task['name'] not in [t['name'] for t in sig['tasks']]:
+                    msg = "Subscriber '{}' of broadcast '{}' is not assigned the signal '{}'"
+                    raise SystemParseError(msg.format(task['name'], broadcast['name'], sig['name']))
+                config['broadcast_subscriptions'].append({'name': task['name']})
+        if len(config['broadcast_subscriptions']) > 255:
+            raise SystemParseError("The total number of broadcast subscribers must not exceed 255")
+
+        # Group the run-to-completion tasks that share a stack.
+        # Each group runs in the context of its first task on a stack that is large enough for any task in the group.
+        config['stack_groups'] = LengthList()
+        for task in config['tasks']:
+            task['context_owner'] = task['idx']
+            if task['stack_group'] is None:
+                continue
+            for group in config['stack_groups']:
+                if group['name'] == task['stack_group']:
+                    group['stack_size'] = max(group['stack_size'], task['stack_size'])
+                    break
+            else:
+                group = {'name': task['stack_group'], 'owner': task['idx'], 'stack_size': task['stack_size']}
+                config['stack_groups'].append(group)
+            task['context_owner'] = group['owner']
+
         # Create a timer for each task
         for task in config['tasks']:
             timer = {'name': '_task_' + task['name'],
@@ -104,6 +144,8 @@ class RigelModule(Module):
                      'sig_set': '_task_timer'}
             task['timer'] = timer
             config['timers'].append(timer)
+
+        configure_timers(xml_config, config)
         return config
 
 
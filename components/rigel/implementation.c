@@ -1,4 +1,5 @@
 /*| headers |*/
+#include <stdbool.h>
 #include "rtos-rigel.h"
 
 /*| object_like_macros |*/
@@ -13,6 +14,9 @@
 static void yield_to({{prefix_type}}TaskId to) {{prefix_const}}REENTRANT;
 static void block(void) {{prefix_const}}REENTRANT;
 static void unblock({{prefix_type}}TaskId task);
+{{#stack_groups.length}}
+static void stack_group_entry(void);
+{{/stack_groups.length}}
 
 /*| state |*/
 static {{prefix_type}}TimerId task_timers[{{tasks.length}}] = {
@@ -20,9 +24,33 @@ static {{prefix_type}}TimerId task_timers[{{tasks.length}}] = {
     {{prefix_const}}TIMER_ID_{{timer.name|u}},
 {{/tasks}}
 };
+{{#stack_groups.length}}
+
+/* The tasks of a stack group share the stack and the execution context of the first task of the group */
+static const {{prefix_type}}TaskId task_context_owners[{{tasks.length}}] = {
+{{#tasks}}
+    {{context_owner}},
+{{/tasks}}
+};
+
+static void (*const task_functions[{{tasks.length}}])(void) = {
+{{#tasks}}
+    {{function}},
+{{/tasks}}
+};
+
+/* Whether the current task is a run-to-completion task that is executing its task function */
+static bool run_to_completion;
+{{/stack_groups.length}}
 
 /*| function_like_macros |*/
 #define yield() {{prefix_func}}yield()
+{{#stack_groups.length}}
+#define task_context(task_id) get_task_context(task_context_owners[task_id])
+{{/stack_groups.length}}
+{{^stack_groups.length}}
+#define task_context(task_id) get_task_context(task_id)
+{{/stack_groups.length}}
 #define interrupt_event_id_to_taskid(interrupt_event_id) (({{prefix_type}}TaskId)(interrupt_event_id))
 #define mutex_core_block_on(unused_task) {{prefix_func}}signal_wait({{prefix_const}}SIGNAL_ID__TASK_TIMER)
 #define mutex_core_unblock(task) {{prefix_func}}signal_send(task, {{prefix_const}}SIGNAL_ID__TASK_TIMER)
@@ -52,7 +80,7 @@ yield_to(const {{prefix_type}}TaskId to) {{prefix_const}}REENTRANT
     internal_assert(to < {{tasks.length}}, ERROR_ID_INTERNAL_INVALID_ID);
 
     current_task = to;
-    context_switch(get_task_context(from), get_task_context(to));
+    context_switch(task_context(from), task_context(to));
 }
 
 static void
@@ -62,7 +90,7 @@ block(void) {{prefix_const}}REENTRANT
     {{prefix_func}}yield();
 }
 
-static void
+static RAMFUNC void
 unblock(const {{prefix_type}}TaskId task)
 {
     sched_set_runnable(task);
@@ -70,6 +98,7 @@ unblock(const {{prefix_type}}TaskId task)
 
 /* entry point trampolines */
 {{#tasks}}
+{{^stack_group}}
 static void
 entry_{{name}}(void)
 {
@@ -79,7 +108,37 @@ entry_{{name}}(void)
     api_error(ERROR_ID_TASK_FUNCTION_RETURNS);
 }
 
+{{/stack_group}}
 {{/tasks}}
+{{#stack_groups.length}}
+/* Entry point of the shared context of each stack group.
+ * Whichever task of the group the scheduler selects runs in this context.
+ * Each start signal it has received activates its task function once, which must run to completion without yielding
+ * or blocking.
+ * Therefore, the stack is empty again whenever the context switches to another task, so that all tasks of the group can
+ * share it. */
+static void
+stack_group_entry(void)
+{
+    for (;;)
+    {
+        const {{prefix_type}}TaskId task = get_current_task();
+
+        if (signal_recv(&PENDING_SIGNALS(task), {{prefix_const}}SIGNAL_SET__RTOS_UTIL) !=
+                {{prefix_const}}SIGNAL_SET_EMPTY)
+        {
+            run_to_completion = true;
+            task_functions[task]();
+            run_to_completion = false;
+        }
+        else
+        {
+            block();
+        }
+    }
+}
+
+{{/stack_groups.length}}
 
 /*| public_functions |*/
 void
@@ -92,7 +151,13 @@ void
 void
 {{prefix_func}}yield(void) {{prefix_const}}REENTRANT
 {
-    {{prefix_type}}TaskId to = interrupt_event_get_next();
+    {{prefix_type}}TaskId to;
+{{#stack_groups.length}}
+
+    api_assert(!run_to_completion, ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS);
+{{/stack_groups.length}}
+
+    to = interrupt_event_get_next();
     yield_to(to);
 }
 
@@ -102,9 +167,19 @@ void
     message_queue_init();
 
     {{#tasks}}
+    {{^stack_group}}
     context_init(get_task_context({{idx}}), entry_{{name}}, stack_{{idx}}, {{stack_size}});
+    {{/stack_group}}
+    {{#stack_group}}
+    {{#start}}
+    signal_send_set({{idx}}, {{prefix_const}}SIGNAL_SET__RTOS_UTIL);
+    {{/start}}
+    {{/stack_group}}
     sched_set_runnable({{idx}});
     {{/tasks}}
+    {{#stack_groups}}
+    context_init(get_task_context({{owner}}), stack_group_entry, stack_group_{{name}}, {{stack_size}});
+    {{/stack_groups}}
 
-    context_switch_first(get_task_context({{prefix_const}}TASK_ID_ZERO));
+    context_switch_first(task_context({{prefix_const}}TASK_ID_ZERO));
 }
@@ -0,0 +1,13 @@
+/*| public_headers |*/
+
+/*| public_types |*/
+
+/*| public_structures |*/
+
+/*| public_object_like_macros |*/
+
+/*| public_function_like_macros |*/
+
+/*| public_state |*/
+
+/*| public_function_declarations |*/
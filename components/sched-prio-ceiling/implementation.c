@@ -113,7 +113,7 @@ sched_set_mutex_unlocked(const {{prefix_type}}MutexId mutex_id)
 }
 {{/mutexes.length}}
 
-static [[#assume_runnable]]{{prefix_type}}TaskId[[/assume_runnable]][[^assume_runnable]]TaskIdOption[[/assume_runnable]]
+static RAMFUNC [[#assume_runnable]]{{prefix_type}}TaskId[[/assume_runnable]][[^assume_runnable]]TaskIdOption[[/assume_runnable]]
 sched_get_next(void)
 {
     /*
@@ -123,6 +123,7 @@ sched_get_next(void)
     SchedIndexOption sched_idx, next_idx;
     SchedIndex idx;
 
+    /* loop bound: {{mutex_tasks_length}} */
     for (idx = SCHED_INDEX_ZERO; idx <= sched_max_index(); idx++) {
         sched_idx = idx;
 
@@ -1,7 +1,19 @@
 /*| headers |*/
+[[#time_slicing]]
+{{#time_slice}}
+#include <stdbool.h>
+#include <stdint.h>
+{{/time_slice}}
+[[/time_slicing]]
 
 /*| object_like_macros |*/
 #define SCHED_INDEX_ZERO ((SchedIndex) {{prefix_const}}TASK_ID_ZERO)
+[[#time_slicing]]
+{{#time_slice}}
+#define SCHED_LEVEL_ZERO ((SchedIndex) 0)
+#define SCHED_TIME_SLICE ((uint16_t) {{time_slice}})
+{{/time_slice}}
+[[/time_slicing]]
 
 /*| types |*/
 typedef {{prefix_type}}TaskId SchedIndex;
@@ -14,9 +26,24 @@ struct sched_task {
 /*
  * NOTE: An RTOS variant using the scheduler must ensure that tasks
  * array is sorted by priority.
+[[#time_slicing]]
+{{#time_slice}}
+ * Tasks of equal priority form a priority level and must be adjacent in the tasks array.
+ * The scheduler selects between the tasks of a level in round-robin order, starting with the task at the level's
+ * offset.
+{{/time_slice}}
+[[/time_slicing]]
  */
 struct sched {
     struct sched_task tasks[{{tasks.length}}];
+[[#time_slicing]]
+{{#time_slice}}
+    SchedIndex level_offsets[{{priority_levels.length}}];
+    TaskIdOption slice_task;
+    SchedIndex slice_level;
+    uint16_t slice_remaining;
+{{/time_slice}}
+[[/time_slicing]]
 };
 
 /*| extern_declarations |*/
@@ -25,17 +52,40 @@ struct sched {
 static void sched_set_runnable(const {{prefix_type}}TaskId task_id);
 static void sched_set_blocked_on(const {{prefix_type}}TaskId task_id, const {{prefix_type}}TaskId blocker);
 static [[#assume_runnable]]{{prefix_type}}TaskId[[/assume_runnable]][[^assume_runnable]]TaskIdOption[[/assume_runnable]] sched_get_next(void);
+[[#time_slicing]]
+{{#time_slice}}
+static bool sched_time_slice_tick(void);
+{{/time_slice}}
+[[/time_slicing]]
 
 /*| state |*/
 static struct sched sched_tasks;
+[[#time_slicing]]
+{{#time_slice}}
+/* The index of the first task of each priority level, followed by the number of tasks */
+static const SchedIndex sched_level_bounds[{{priority_levels.length}} + 1] = {
+{{#priority_levels}}
+    {{first}},
+{{/priority_levels}}
+    {{tasks.length}}
+};
+{{/time_slice}}
+[[/time_slicing]]
 
 /*| function_like_macros |*/
 #define sched_set_blocked(task_id) sched_set_blocked_on(task_id, TASK_ID_NONE)
-#define sched_runnable(task_id) (SCHED_OBJ(task_id).runnable)
+#define sched_runnable(task_id) (SCHED_OBJ(task_id).blocked_on == (task_id))
 #define sched_max_index() (SchedIndex)({{tasks.length}} - 1U)
 #define sched_index_to_taskid(sched_index) ({{prefix_type}}TaskId)(sched_index)
 #define sched_taskid_to_index(task_id) (SchedIndex)(task_id)
 #define SCHED_OBJ(task_id) sched_tasks.tasks[task_id]
+[[#time_slicing]]
+{{#time_slice}}
+#define sched_max_level() (SchedIndex)({{priority_levels.length}} - 1U)
+#define sched_level_size(level) (SchedIndex)(sched_level_bounds[(level) + 1] - sched_level_bounds[level])
+#define sched_level_next_offset(level, offset) (SchedIndex)((offset) + 1U == sched_level_size(level) ? 0 : (offset) + 1U)
+{{/time_slice}}
+[[/time_slicing]]
 
 /*| functions |*/
 static void
@@ -50,7 +100,10 @@ sched_set_blocked_on(const {{prefix_type}}TaskId task_id, const {{prefix_type}}T
     SCHED_OBJ(task_id).blocked_on = blocker;
 }
 
-static [[#assume_runnable]]{{prefix_type}}TaskId[[/assume_runnable]][[^assume_runnable]]TaskIdOption[[/assume_runnable]]
+[[#time_slicing]]
+{{^time_slice}}
+[[/time_slicing]]
+static RAMFUNC [[#assume_runnable]]{{prefix_type}}TaskId[[/assume_runnable]][[^assume_runnable]]TaskIdOption[[/assume_runnable]]
 sched_get_next(void)
 {
     /* NOTE: In the case where assume_runnable is true and no runnable
@@ -60,9 +113,11 @@ sched_get_next(void)
     TaskIdOption task, next_task;
     SchedIndex idx;
 
+    /* loop bound: {{tasks.length}} */
     for (idx = SCHED_INDEX_ZERO; idx <= sched_max_index(); idx++)
     {
         task = sched_index_to_taskid(idx);
+        /* loop bound: {{tasks.length}} */
         do
         {
             next_task = SCHED_OBJ(task).blocked_on;
@@ -77,5 +132,79 @@ sched_get_next(void)
 found:
     return [[#assume_runnable]]({{prefix_type}}TaskId)[[/assume_runnable]] task;
 }
+[[#time_slicing]]
+{{/time_slice}}
+{{#time_slice}}
+static RAMFUNC [[#assume_runnable]]{{prefix_type}}TaskId[[/assume_runnable]][[^assume_runnable]]TaskIdOption[[/assume_runnable]]
+sched_get_next(void)
+{
+    /* NOTE: In the case where assume_runnable is true and no runnable
+       tasks are found, then an undefined task will be returned from this
+       function.
+    */
+    TaskIdOption task = TASK_ID_NONE, next_task;
+    SchedIndex level, offset, count;
+
+    /* loop bound: {{priority_levels.length}} */
+    for (level = SCHED_LEVEL_ZERO; level <= sched_max_level(); level++)
+    {
+        offset = sched_tasks.level_offsets[level];
+        /* loop bound: {{tasks.length}} */
+        for (count = sched_level_size(level); count != 0; count--)
+        {
+            task = sched_index_to_taskid(sched_level_bounds[level] + offset);
+            /* loop bound: {{tasks.length}} */
+            do
+            {
+                next_task = SCHED_OBJ(task).blocked_on;
+                if (next_task == task)
+                {
+                    /* Keep selecting this task of the level until its time slice expires or it blocks */
+                    sched_tasks.level_offsets[level] = offset;
+                    goto found;
+                }
+                task = next_task;
+            }
+            while (task != TASK_ID_NONE);
+            offset = sched_level_next_offset(level, offset);
+        }
+    }
+[[^assume_runnable]]
+    return TASK_ID_NONE;
+[[/assume_runnable]]
+found:
+    if (task != sched_tasks.slice_task)
+    {
+        sched_tasks.slice_task = task;
+        sched_tasks.slice_level = level;
+        sched_tasks.slice_remaining = SCHED_TIME_SLICE;
+    }
+    return [[#assume_runnable]]({{prefix_type}}TaskId)[[/assume_runnable]] task;
+}
+
+/*
+ * Called for each tick.
+ * When the time slice of the most recently selected task expires, the scheduler moves on to the next task of the
+ * priority level the task was selected from.
+ * Returns whether the time slice expired, in which case the caller must trigger a scheduling decision for the rotation
+ * to take effect.
+ */
+static bool
+sched_time_slice_tick(void)
+{
+    const SchedIndex level = sched_tasks.slice_level;
+
+    if (sched_tasks.slice_remaining > 1)
+    {
+        sched_tasks.slice_remaining--;
+        return false;
+    }
+
+    sched_tasks.level_offsets[level] = sched_level_next_offset(level, sched_tasks.level_offsets[level]);
+    sched_tasks.slice_task = TASK_ID_NONE;
+    return true;
+}
+{{/time_slice}}
+[[/time_slicing]]
 
 /*| public_functions |*/
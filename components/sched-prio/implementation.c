@@ -1,23 +1,23 @@
 /*| headers |*/
 #include <stdbool.h>
+#include <stdint.h>
 
 /*| object_like_macros |*/
 #define SCHED_INDEX_ZERO ((SchedIndex) {{prefix_const}}TASK_ID_ZERO)
+#define SCHED_WORDS ((({{tasks.length}} - 1U) / 32U) + 1U)
 
 /*| types |*/
 typedef {{prefix_type}}TaskId SchedIndex;
+typedef uint32_t SchedWord;
 
 /*| structures |*/
-struct sched_task {
-    bool runnable;
-};
-
 /*
  * NOTE: An RTOS variant using the scheduler must ensure that tasks
  * array is sorted by priority.
+ * The runnable tasks are a bitmap of 32 tasks per word, so that the scheduler can skip over 32 blocked tasks at a time.
  */
 struct sched {
-    struct sched_task tasks[{{tasks.length}}];
+    SchedWord runnable[SCHED_WORDS];
 };
 
 /*| extern_declarations |*/
@@ -31,38 +31,55 @@ static [[#assume_runnable]]{{prefix_type}}TaskId[[/assume_runnable]][[^assume_ru
 static struct sched sched_tasks;
 
 /*| function_like_macros |*/
-#define sched_runnable(task_id) (SCHED_OBJ(task_id).runnable)
+#define sched_runnable(task_id) ((SCHED_WORD(task_id) & SCHED_BIT(task_id)) != 0)
 #define sched_max_index() (SchedIndex)({{tasks.length}} - 1U)
 #define sched_index_to_taskid(sched_index) ({{prefix_type}}TaskId)(sched_index)
-#define SCHED_OBJ(task_id) sched_tasks.tasks[task_id]
+#define SCHED_WORD(task_id) sched_tasks.runnable[(task_id) / 32U]
+#define SCHED_BIT(task_id) ((SchedWord) 1U << ((task_id) % 32U))
 
 /*| functions |*/
 static void
 sched_set_runnable(const {{prefix_type}}TaskId task_id)
 {
-    SCHED_OBJ(task_id).runnable = true;
+    SCHED_WORD(task_id) |= SCHED_BIT(task_id);
 }
 
 static void
 sched_set_blocked(const {{prefix_type}}TaskId task_id)
 {
-    SCHED_OBJ(task_id).runnable = false;
+    SCHED_WORD(task_id) &= ~SCHED_BIT(task_id);
 }
 
-static [[#assume_runnable]]{{prefix_type}}TaskId[[/assume_runnable]][[^assume_runnable]]TaskIdOption[[/assume_runnable]]
+static RAMFUNC [[#assume_runnable]]{{prefix_type}}TaskId[[/assume_runnable]][[^assume_runnable]]TaskIdOption[[/assume_runnable]]
 sched_get_next(void)
 {
     /* NOTE: In the case where assume_runnable is true and no runnable
        tasks are found, then an undefined task will be returned from this
        function.
     */
-    {{prefix_type}}TaskId[[^assume_runnable]]Option[[/assume_runnable]] task[[^assume_runnable]] = TASK_ID_NONE[[/assume_runnable]];
-    SchedIndex idx;
+[[#assume_runnable]]
+    {{prefix_type}}TaskId task;
+[[/assume_runnable]]
+[[^assume_runnable]]
+    TaskIdOption task = TASK_ID_NONE;
+[[/assume_runnable]]
+    SchedIndex word, idx;
+    SchedWord runnable;
 
-    for (idx = SCHED_INDEX_ZERO; idx <= sched_max_index(); idx++)
+    /* loop bound: ({{tasks.length}} - 1) / 32 + 1 */
+    for (word = 0; word < SCHED_WORDS; word++)
     {
-        if (sched_runnable(sched_index_to_taskid(idx)))
+        runnable = sched_tasks.runnable[word];
+        if (runnable != 0)
         {
+            /* The lowest set bit of the first non-empty word is the runnable task with the highest priority */
+            idx = (SchedIndex) (word * 32U);
+            /* loop bound: 31 */
+            while ((runnable & 1U) == 0)
+            {
+                runnable >>= 1;
+                idx++;
+            }
             task = sched_index_to_taskid(idx);
             break;
         }
@@ -1,19 +1,18 @@
 /*| headers |*/
 #include <stdbool.h>
+#include <stdint.h>
 
 /*| object_like_macros |*/
+#define SCHED_WORDS ((({{tasks.length}} - 1U) / 32U) + 1U)
 
 /*| types |*/
 typedef {{prefix_type}}TaskId SchedIndex;
+typedef uint32_t SchedWord;
 
 /*| structures |*/
-struct sched_task {
-    bool runnable;
-};
-
 struct sched {
     SchedIndex cur; /* The index of the currently scheduled task */
-    struct sched_task tasks[{{tasks.length}}];
+    SchedWord runnable[SCHED_WORDS]; /* A bitmap of the runnable tasks, 32 tasks per word */
 };
 
 /*| extern_declarations |*/
@@ -27,34 +26,36 @@ static [[#assume_runnable]]{{prefix_type}}TaskId[[/assume_runnable]][[^assume_ru
 static struct sched sched_tasks;
 
 /*| function_like_macros |*/
-#define sched_runnable(task_id) (SCHED_OBJ(task_id).runnable)
+#define sched_runnable(task_id) ((SCHED_WORD(task_id) & SCHED_BIT(task_id)) != 0)
 #define sched_next_index(cur) (((cur) == sched_max_index()) ? 0 : ((cur) + 1))
 #define sched_get_cur_index() (sched_tasks.cur)
 #define sched_set_cur_index(idx) sched_tasks.cur = (idx)
 #define sched_max_index() (SchedIndex)({{tasks.length}} - 1U)
 #define sched_index_to_taskid(sched_index) ({{prefix_type}}TaskId)(sched_index)
-#define SCHED_OBJ(task_id) sched_tasks.tasks[task_id]
+#define SCHED_WORD(task_id) sched_tasks.runnable[(task_id) / 32U]
+#define SCHED_BIT(task_id) ((SchedWord) 1U << ((task_id) % 32U))
 
 /*| functions |*/
 static void
 sched_set_runnable(const {{prefix_type}}TaskId task_id)
 {
-    SCHED_OBJ(task_id).runnable = true;
+    SCHED_WORD(task_id) |= SCHED_BIT(task_id);
 }
 
 static void
 sched_set_blocked(const {{prefix_type}}TaskId task_id)
 {
-    SCHED_OBJ(task_id).runnable = false;
+    SCHED_WORD(task_id) &= ~SCHED_BIT(task_id);
 }
 
-static [[#assume_runnable]]{{prefix_type}}TaskId[[/assume_runnable]][[^assume_runnable]]TaskIdOption[[/assume_runnable]]
+static RAMFUNC [[#assume_runnable]]{{prefix_type}}TaskId[[/assume_runnable]][[^assume_runnable]]TaskIdOption[[/assume_runnable]]
 sched_get_next(void)
 {
     [[#assume_runnable]]{{prefix_type}}TaskId[[/assume_runnable]][[^assume_runnable]]TaskIdOption[[/assume_runnable]] task;
     SchedIndex next = sched_get_cur_index();
     bool found = false;
 
+    /* loop bound: {{tasks.length}} */
     do
     {
         next = sched_next_index(next);
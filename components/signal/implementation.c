@@ -55,7 +55,7 @@ signal_recv({{prefix_type}}SignalSet *const pending_signals, const {{prefix_type
     return received_signals;
 }
 
-static void
+static RAMFUNC void
 signal_send_set(const {{prefix_type}}TaskId task_id, const {{prefix_type}}SignalSet signals)
 {
     precondition_preemption_disabled();
@@ -142,7 +142,7 @@ signal_wait_set_blocked_on(const {{prefix_type}}SignalSet requested_signals, con
     return pending_signals & requested_signals;
 }
 
-void
+RAMFUNC void
 {{prefix_func}}signal_send_set(const {{prefix_type}}TaskId task_id, const {{prefix_type}}SignalSet signals)
 {
     assert_task_valid(task_id);
@@ -120,6 +120,7 @@ void
 
     if (semaphores[s].value == SEM_VALUE_ZERO)
     {
+        /* loop bound: {{tasks.length}} */
         for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
         {
             if (sem_waiters[t] == s)
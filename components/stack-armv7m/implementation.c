@@ -14,8 +14,19 @@
 
 /*| state |*/
 {{#tasks}}
+[[#stack_groups]]
+{{^stack_group}}
+[[/stack_groups]]
 static uint32_t stack_{{idx}}[{{stack_size}}] __attribute__((aligned(8)));
+[[#stack_groups]]
+{{/stack_group}}
+[[/stack_groups]]
 {{/tasks}}
+[[#stack_groups]]
+{{#stack_groups}}
+static uint32_t stack_group_{{name}}[{{stack_size}}] __attribute__((aligned(8)));
+{{/stack_groups}}
+[[/stack_groups]]
 
 /*| function_like_macros |*/
 
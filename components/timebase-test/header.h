@@ -0,0 +1,25 @@
+/*| public_headers |*/
+#include <stdint.h>
+
+/*| public_types |*/
+typedef uint8_t {{prefix_type}}TaskId;
+typedef uint8_t {{prefix_type}}TimerId;
+typedef uint{{ticksrelative_size}}_t {{prefix_type}}TicksRelative;
+typedef uint32_t {{prefix_type}}TicksAbsolute;
+
+/*| public_structures |*/
+
+/*| public_object_like_macros |*/
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+
+/*| public_function_like_macros |*/
+
+/*| public_state |*/
+extern {{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+
+/*| public_function_declarations |*/
+void {{prefix_func}}timer_tick(void);
+void pub_timebase_init(void);
+void pub_set_current_task({{prefix_type}}TaskId task_id);
+void pub_set_interrupt_ptr(void (*y)(void));
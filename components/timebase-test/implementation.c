@@ -0,0 +1,131 @@
+/*| headers |*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rtos-timebase-test.h"
+
+/*| object_like_macros |*/
+#define {{prefix_const}}SIGNAL_ID__TASK_TIMER UINT8_C(1)
+
+/*| types |*/
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+static uint32_t cycle_counter_get(void);
+static void timer_oneshot({{prefix_type}}TimerId timer_id, {{prefix_type}}TicksRelative timeout);
+static {{prefix_type}}TaskId get_current_task(void);
+
+/*| state |*/
+static {{prefix_type}}TaskId current_task;
+static void (*interrupt_ptr)(void);
+static const {{prefix_type}}TimerId task_timers[{{tasks.length}}] = {
+{{#tasks}}
+    {{idx}},
+{{/tasks}}
+};
+{{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+uint32_t pub_cycles;
+uint32_t pub_ticks;
+{{prefix_type}}TimerId pub_oneshot_timer;
+{{prefix_type}}TicksRelative pub_oneshot_timeout;
+uint8_t pub_waits;
+{{prefix_type}}ErrorId pub_fatal_error_id;
+
+/*| function_like_macros |*/
+#define preempt_disable()
+#define preempt_enable()
+#define cycle_counter_init()
+#define assert_timer_valid(timer) api_assert((timer) <= {{prefix_const}}TASK_ID_MAX, ERROR_ID_INVALID_ID)
+#define signal_wait(requested_set) (pub_waits++)
+
+/*| functions |*/
+/*
+ * The interrupt, if one is set, occurs immediately after the cycle counter is read, so that the reader straddles it.
+ */
+static uint32_t
+cycle_counter_get(void)
+{
+    const uint32_t cycles = pub_cycles;
+    void (*const interrupt)(void) = interrupt_ptr;
+
+    if (interrupt != NULL)
+    {
+        interrupt_ptr = NULL;
+        interrupt();
+    }
+
+    return cycles;
+}
+
+static void
+timer_oneshot(const {{prefix_type}}TimerId timer_id, const {{prefix_type}}TicksRelative timeout)
+{
+    pub_oneshot_timer = timer_id;
+    pub_oneshot_timeout = timeout;
+}
+
+static {{prefix_type}}TaskId
+get_current_task(void)
+{
+    return current_task;
+}
+
+void
+test_fatal_error(const {{prefix_type}}ErrorId error_id)
+{
+    pub_fatal_error_id = error_id;
+}
+
+/*| public_functions |*/
+void
+{{prefix_func}}timer_tick(void)
+{
+    pub_ticks++;
+}
+
+void
+pub_timebase_init(void)
+{
+    /* For testing purposes, the network time, steps and adjustment are reset, too */
+    timebase_clock.sequence = 0;
+    timebase_clock.ticks = 0;
+    timebase_clock.seconds = 0;
+    timebase_clock.nanoseconds = 0;
+    timebase_clock.fraction = 0;
+    timebase_clock.step_seconds = 0;
+    timebase_clock.step_nanoseconds = 0;
+    timebase_steps[0].seconds = 0;
+    timebase_steps[0].nanoseconds = 0;
+    timebase_steps[1].seconds = 0;
+    timebase_steps[1].nanoseconds = 0;
+    timebase_step_sequence = 0;
+    timebase_adjustment = 0;
+    timebase_applied_adjustment = 0;
+
+    current_task = {{prefix_const}}TASK_ID_ZERO;
+    interrupt_ptr = NULL;
+    {{prefix_func}}timer_current_ticks = 0;
+    pub_cycles = 0;
+    pub_ticks = 0;
+    pub_oneshot_timer = 0;
+    pub_oneshot_timeout = 0;
+    pub_waits = 0;
+    pub_fatal_error_id = ERROR_ID_NONE;
+
+    timebase_init();
+}
+
+void
+pub_set_current_task(const {{prefix_type}}TaskId task_id)
+{
+    current_task = task_id;
+}
+
+void
+pub_set_interrupt_ptr(void (*y)(void))
+{
+    interrupt_ptr = y;
+}
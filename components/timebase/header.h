@@ -0,0 +1,34 @@
+/*| public_headers |*/
+#include <stdint.h>
+
+/*| public_types |*/
+
+/*| public_structures |*/
+{{#timebase}}
+/* A network time, e.g., a PTP timestamp, in seconds and nanoseconds since the epoch of the network's time scale */
+typedef struct {
+    uint32_t seconds;
+    uint32_t nanoseconds;
+} {{prefix_type}}NetworkTime;
+{{/timebase}}
+
+/*| public_object_like_macros |*/
+{{#timebase}}
+#define {{prefix_const}}TIMEBASE_TICK_CYCLES UINT32_C({{tick_cycles}})
+{{/timebase}}
+
+/*| public_function_like_macros |*/
+
+/*| public_state |*/
+
+/*| public_function_declarations |*/
+{{#timebase}}
+uint32_t {{prefix_func}}timebase_tick(void);
+uint32_t {{prefix_func}}timebase_cycles(void);
+void {{prefix_func}}timebase_now({{prefix_type}}NetworkTime *time);
+void {{prefix_func}}timebase_from_cycles(uint32_t cycles, {{prefix_type}}NetworkTime *time);
+void {{prefix_func}}timebase_set(const {{prefix_type}}NetworkTime *time);
+void {{prefix_func}}timebase_adjust(int32_t ppb);
+void {{prefix_func}}timer_oneshot_at({{prefix_type}}TimerId timer_id, const {{prefix_type}}NetworkTime *time);
+void {{prefix_func}}sleep_until(const {{prefix_type}}NetworkTime *time) {{prefix_const}}REENTRANT;
+{{/timebase}}
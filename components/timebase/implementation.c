@@ -0,0 +1,382 @@
+/*| headers |*/
+#include <stdint.h>
+
+/*| object_like_macros |*/
+{{#timebase}}
+#define TIMEBASE_NANOSECONDS_PER_SECOND UINT32_C(1000000000)
+#define TIMEBASE_TICK_PERIOD UINT32_C({{tick_period}})
+#define TIMEBASE_TICKS_PER_SECOND UINT32_C({{ticks_per_second}})
+#define TIMEBASE_RATE UINT64_C({{rate}})
+#define TIMEBASE_RATE_PER_PPB INT64_C({{rate_per_ppb}})
+#define TIMEBASE_CYCLES_PER_NANOSECOND UINT64_C({{cycles_per_nanosecond}})
+#define TIMEBASE_CYCLES_PER_NANOSECOND_PER_PPB INT64_C({{cycles_per_nanosecond_per_ppb}})
+#define TIMEBASE_ADJUSTMENT_MAX INT32_C(1000000)
+#define TIMEBASE_SECONDS_MAX ((UINT{{ticksrelative_size}}_MAX - 2U) / TIMEBASE_TICKS_PER_SECOND - 1U)
+{{/timebase}}
+
+/*| types |*/
+
+/*| structures |*/
+{{#timebase}}
+/*
+ * The network time at the most recent tick, and the value of the cycle counter when the tick interrupt handler sampled
+ * it.
+ * The rate converts cycles to nanoseconds, with 32 fractional bits, and the fraction holds the fraction of a
+ * nanosecond that the network time had reached at the tick.
+ * The step is the total of all steps that the clock includes.
+ * The sequence number increments at each tick, so that readers detect that a tick interrupted them.
+ */
+struct timebase_clock {
+    uint32_t sequence;
+    {{prefix_type}}TicksAbsolute ticks;
+    uint32_t cycles;
+    uint32_t seconds;
+    uint32_t nanoseconds;
+    uint32_t fraction;
+    uint64_t rate;
+    uint32_t step_seconds;
+    uint32_t step_nanoseconds;
+};
+
+/*
+ * The total of all steps of the network time that tasks requested, modulo 2^32 seconds.
+ * The next tick applies the difference to the total that the clock includes.
+ */
+struct timebase_step {
+    uint32_t seconds;
+    uint32_t nanoseconds;
+};
+{{/timebase}}
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+{{#timebase}}
+static void timebase_init(void);
+{{/timebase}}
+
+/*| state |*/
+{{#timebase}}
+static volatile struct timebase_clock timebase_clock;
+/*
+ * Tasks publish a new total step by writing the slot that the step sequence number does not select and then
+ * incrementing it, so that the tick interrupt handler never reads a partially written total
+ */
+static volatile struct timebase_step timebase_steps[2];
+static volatile uint32_t timebase_step_sequence;
+static volatile int32_t timebase_adjustment;
+/* Only the tick interrupt handler accesses the following */
+static int32_t timebase_applied_adjustment;
+static uint64_t timebase_cycles_per_nanosecond;
+static uint32_t timebase_reload;
+{{/timebase}}
+
+/*| function_like_macros |*/
+
+/*| functions |*/
+{{#timebase}}
+/*
+ * Advance a network time by the network time that elapses during the given number of cycles at the given rate.
+ * The fraction of a nanosecond that the network time reaches carries over between calls in 'fraction'.
+ * The multiplication is split into 32-bit halves of the rate, so that the product of up to 2^32 cycles does not
+ * overflow.
+ */
+static void
+timebase_advance({{prefix_type}}NetworkTime *const time, uint32_t *const fraction, const uint32_t cycles,
+                 const uint64_t rate)
+{
+    const uint64_t low = (uint64_t) cycles * (uint32_t) rate + *fraction;
+    uint64_t nanoseconds = (uint64_t) cycles * (uint32_t) (rate >> 32) + (low >> 32) + time->nanoseconds;
+
+    *fraction = (uint32_t) low;
+    /* loop bound: {{wrap_seconds}} */
+    while (nanoseconds >= TIMEBASE_NANOSECONDS_PER_SECOND)
+    {
+        nanoseconds -= TIMEBASE_NANOSECONDS_PER_SECOND;
+        time->seconds++;
+    }
+    time->nanoseconds = (uint32_t) nanoseconds;
+}
+
+/*
+ * Add a signed number of seconds and nanoseconds to a network time.
+ * The magnitude of the nanoseconds must be less than one second.
+ */
+static void
+timebase_add({{prefix_type}}NetworkTime *const time, const int32_t seconds, const int32_t nanoseconds)
+{
+    int32_t sum = (int32_t) time->nanoseconds + nanoseconds;
+
+    time->seconds += (uint32_t) seconds;
+    if (sum < 0)
+    {
+        sum += (int32_t) TIMEBASE_NANOSECONDS_PER_SECOND;
+        time->seconds--;
+    }
+    else if (sum >= (int32_t) TIMEBASE_NANOSECONDS_PER_SECOND)
+    {
+        sum -= (int32_t) TIMEBASE_NANOSECONDS_PER_SECOND;
+        time->seconds++;
+    }
+    time->nanoseconds = (uint32_t) sum;
+}
+
+/*
+ * Add the part of the requested total step that the clock does not include yet to a network time.
+ */
+static void
+timebase_add_step({{prefix_type}}NetworkTime *const time, const uint32_t step_sequence, const uint32_t step_seconds,
+                  const uint32_t step_nanoseconds)
+{
+    const volatile struct timebase_step *const step = &timebase_steps[step_sequence & 1U];
+
+    timebase_add(time, (int32_t) (step->seconds - step_seconds),
+                 (int32_t) step->nanoseconds - (int32_t) step_nanoseconds);
+}
+
+/*
+ * Take a consistent copy of the clock, including a step that the next tick is yet to apply, and return the number of
+ * cycles between the tick and the given cycle counter value, which may precede the tick.
+ * The copy is retried if a tick or a task that steps the network time interrupts it.
+ */
+static int32_t
+timebase_read(struct timebase_clock *const clock, {{prefix_type}}NetworkTime *const time, const uint32_t cycles)
+{
+    uint32_t sequence, step_sequence;
+
+    /* loop bound: retries */
+    do
+    {
+        sequence = timebase_clock.sequence;
+        step_sequence = timebase_step_sequence;
+        clock->ticks = timebase_clock.ticks;
+        clock->cycles = timebase_clock.cycles;
+        clock->fraction = timebase_clock.fraction;
+        clock->rate = timebase_clock.rate;
+        time->seconds = timebase_clock.seconds;
+        time->nanoseconds = timebase_clock.nanoseconds;
+        timebase_add_step(time, step_sequence, timebase_clock.step_seconds, timebase_clock.step_nanoseconds);
+    }
+    while (sequence != timebase_clock.sequence || step_sequence != timebase_step_sequence);
+
+    return (int32_t) (cycles - clock->cycles);
+}
+
+/*
+ * Convert a cycle counter value within half the range of the cycle counter of the most recent tick to network time.
+ */
+static void
+timebase_at(const uint32_t cycles, {{prefix_type}}NetworkTime *const time)
+{
+    struct timebase_clock clock;
+    const int32_t elapsed = timebase_read(&clock, time, cycles);
+
+    if (elapsed >= 0)
+    {
+        timebase_advance(time, &clock.fraction, (uint32_t) elapsed, clock.rate);
+    }
+    else
+    {
+        {{prefix_type}}NetworkTime before = { 0, 0 };
+
+        clock.fraction = 0;
+        timebase_advance(&before, &clock.fraction, (uint32_t) -elapsed, clock.rate);
+        timebase_add(time, -(int32_t) before.seconds, -(int32_t) before.nanoseconds);
+    }
+}
+
+/*
+ * Convert a network time to the relative number of ticks after which the RTOS processes the first tick at or after the
+ * network time.
+ * Network times in the past convert to the next tick the RTOS processes.
+ */
+static {{prefix_type}}TicksRelative
+timebase_ticks_until(const {{prefix_type}}NetworkTime *const time)
+{
+    struct timebase_clock clock;
+    {{prefix_type}}NetworkTime tick;
+    uint32_t seconds;
+    int32_t nanoseconds;
+    {{prefix_type}}TicksAbsolute ticks;
+
+    (void) timebase_read(&clock, &tick, cycle_counter_get());
+
+    seconds = time->seconds - tick.seconds;
+    nanoseconds = (int32_t) time->nanoseconds - (int32_t) tick.nanoseconds;
+    if (nanoseconds < 0)
+    {
+        nanoseconds += (int32_t) TIMEBASE_NANOSECONDS_PER_SECOND;
+        seconds--;
+    }
+
+    if ((int32_t) seconds < 0)
+    {
+        ticks = 0;
+    }
+    else if (seconds > TIMEBASE_SECONDS_MAX)
+    {
+        api_error(ERROR_ID_TIMEBASE_TIME_TOO_FAR);
+        ticks = TIMEBASE_SECONDS_MAX * TIMEBASE_TICKS_PER_SECOND;
+    }
+    else
+    {
+        ticks = seconds * TIMEBASE_TICKS_PER_SECOND +
+            ((uint32_t) nanoseconds + TIMEBASE_TICK_PERIOD - 1U) / TIMEBASE_TICK_PERIOD;
+    }
+
+    /* The tick interrupt handler may have counted ticks that the RTOS is yet to process */
+    return ({{prefix_type}}TicksRelative) (ticks + (clock.ticks - {{prefix_func}}timer_current_ticks));
+}
+
+static void
+timebase_init(void)
+{
+    cycle_counter_init();
+    timebase_clock.cycles = cycle_counter_get();
+    timebase_clock.rate = TIMEBASE_RATE;
+    timebase_cycles_per_nanosecond = TIMEBASE_CYCLES_PER_NANOSECOND;
+    timebase_reload = {{prefix_const}}TIMEBASE_TICK_CYCLES;
+}
+{{/timebase}}
+
+/*| public_functions |*/
+{{#timebase}}
+/*
+ * The tick interrupt handler calls this function at each tick, in place of timer_tick().
+ * The period that ends at the next tick is already loaded into the tick timer, so the returned reload value applies
+ * to the period after it.
+ * It is chosen so that the period ends at the multiple of the tick period that is nearest to one tick period after the
+ * next tick in network time, which keeps ticks aligned to network time while the network time is adjusted or stepped.
+ */
+uint32_t
+{{prefix_func}}timebase_tick(void)
+{
+    const uint32_t cycles = cycle_counter_get();
+    const int32_t adjustment = timebase_adjustment;
+    const uint32_t step_sequence = timebase_step_sequence;
+    {{prefix_type}}NetworkTime time;
+    uint32_t fraction = timebase_clock.fraction;
+    uint64_t rate = timebase_clock.rate;
+    uint32_t phase, period;
+
+    time.seconds = timebase_clock.seconds;
+    time.nanoseconds = timebase_clock.nanoseconds;
+    timebase_advance(&time, &fraction, cycles - timebase_clock.cycles, rate);
+
+    timebase_add_step(&time, step_sequence, timebase_clock.step_seconds, timebase_clock.step_nanoseconds);
+
+    /* The adjustment applies from this tick onwards, relative to the nominal rates */
+    if (adjustment != timebase_applied_adjustment)
+    {
+        rate = TIMEBASE_RATE + (uint64_t) ((adjustment * TIMEBASE_RATE_PER_PPB) >> 16);
+        timebase_cycles_per_nanosecond = TIMEBASE_CYCLES_PER_NANOSECOND -
+            (uint64_t) ((adjustment * TIMEBASE_CYCLES_PER_NANOSECOND_PER_PPB) >> 16);
+        timebase_applied_adjustment = adjustment;
+    }
+
+    timebase_clock.ticks++;
+    timebase_clock.cycles = cycles;
+    timebase_clock.seconds = time.seconds;
+    timebase_clock.nanoseconds = time.nanoseconds;
+    timebase_clock.fraction = fraction;
+    timebase_clock.rate = rate;
+    timebase_clock.step_seconds = timebase_steps[step_sequence & 1U].seconds;
+    timebase_clock.step_nanoseconds = timebase_steps[step_sequence & 1U].nanoseconds;
+    timebase_clock.sequence++;
+
+    /* Predict the network time of the next tick, and end the following period at a multiple of the tick period */
+    timebase_advance(&time, &fraction, timebase_reload, rate);
+    phase = time.nanoseconds % TIMEBASE_TICK_PERIOD;
+    period = (phase < TIMEBASE_TICK_PERIOD / 2U ? 1U : 2U) * TIMEBASE_TICK_PERIOD - phase;
+    timebase_reload = (uint32_t) (((uint64_t) period * timebase_cycles_per_nanosecond) >> 32);
+
+    {{prefix_func}}timer_tick();
+
+    return timebase_reload;
+}
+
+uint32_t
+{{prefix_func}}timebase_cycles(void)
+{
+    return cycle_counter_get();
+}
+
+void
+{{prefix_func}}timebase_now({{prefix_type}}NetworkTime *const time)
+{
+    timebase_at(cycle_counter_get(), time);
+}
+
+void
+{{prefix_func}}timebase_from_cycles(const uint32_t cycles, {{prefix_type}}NetworkTime *const time)
+{
+    timebase_at(cycles, time);
+}
+
+void
+{{prefix_func}}timebase_set(const {{prefix_type}}NetworkTime *const time)
+{
+    {{prefix_type}}NetworkTime now, total;
+    uint32_t step_sequence;
+
+    preempt_disable();
+
+    /*
+     * Only tasks publish steps, so the total does not change while preemption is disabled.
+     * The current network time includes it, whether or not a tick has applied it to the clock, so the new total
+     * differs from it by the difference between the requested and the current network time.
+     */
+    step_sequence = timebase_step_sequence;
+    timebase_at(cycle_counter_get(), &now);
+    total.seconds = timebase_steps[step_sequence & 1U].seconds;
+    total.nanoseconds = timebase_steps[step_sequence & 1U].nanoseconds;
+    timebase_add(&total, (int32_t) (time->seconds - now.seconds),
+                 (int32_t) time->nanoseconds - (int32_t) now.nanoseconds);
+
+    timebase_steps[(step_sequence + 1U) & 1U].seconds = total.seconds;
+    timebase_steps[(step_sequence + 1U) & 1U].nanoseconds = total.nanoseconds;
+    timebase_step_sequence = step_sequence + 1U;
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}timebase_adjust(const int32_t ppb)
+{
+    if (ppb > TIMEBASE_ADJUSTMENT_MAX)
+    {
+        timebase_adjustment = TIMEBASE_ADJUSTMENT_MAX;
+    }
+    else if (ppb < -TIMEBASE_ADJUSTMENT_MAX)
+    {
+        timebase_adjustment = -TIMEBASE_ADJUSTMENT_MAX;
+    }
+    else
+    {
+        timebase_adjustment = ppb;
+    }
+}
+
+void
+{{prefix_func}}timer_oneshot_at(const {{prefix_type}}TimerId timer_id, const {{prefix_type}}NetworkTime *const time)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_oneshot(timer_id, timebase_ticks_until(time));
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}sleep_until(const {{prefix_type}}NetworkTime *const time) {{prefix_const}}REENTRANT
+{
+    preempt_disable();
+
+    timer_oneshot(task_timers[get_current_task()], timebase_ticks_until(time));
+    signal_wait({{prefix_const}}SIGNAL_ID__TASK_TIMER);
+
+    preempt_enable();
+}
+{{/timebase}}
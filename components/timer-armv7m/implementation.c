@@ -20,15 +20,23 @@ static volatile uint8_t timer_pending_ticks;
 #define timer_pending_ticks_check() ((bool)timer_pending_ticks)
 
 /*| functions |*/
+/*
+ * This uses an exclusive access rather than masking interrupts, so that it does not delay zero-latency interrupts.
+ * Exception entry and return clear the exclusive monitor, so the strexb fails and the loop retries if timer_tick
+ * interrupts it.
+ */
 static uint8_t
 timer_pending_ticks_get_and_clear_atomically(void)
 {
-    uint8_t pending_ticks;
-    asm volatile("cpsid i");
-    pending_ticks = timer_pending_ticks;
-    timer_pending_ticks = 0;
-    asm volatile("cpsie i");
-    return pending_ticks;
+    uint32_t pending_ticks;
+    uint32_t failed;
+    /* loop bound: retries */
+    do
+    {
+        asm volatile("ldrexb %0, [%1]" : "=r" (pending_ticks) : "r" (&timer_pending_ticks) : "memory");
+        asm volatile("strexb %0, %1, [%2]" : "=&r" (failed) : "r" (0), "r" (&timer_pending_ticks) : "memory");
+    } while (failed);
+    return (uint8_t) pending_ticks;
 }
 
 /*| public_functions |*/
@@ -0,0 +1,29 @@
+/*| public_headers |*/
+#include <stdint.h>
+
+/*| public_types |*/
+typedef uint8_t {{prefix_type}}TaskId;
+typedef uint8_t {{prefix_type}}SignalId;
+typedef uint8_t {{prefix_type}}SignalSet;
+typedef uint8_t {{prefix_type}}ErrorId;
+
+/*| public_structures |*/
+
+/*| public_object_like_macros |*/
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+{{#tasks}}
+#define {{prefix_const}}TASK_ID_{{name|u}} (({{prefix_type}}TaskId) UINT8_C({{idx}}))
+{{/tasks}}
+#define {{prefix_const}}SIGNAL_SET_EMPTY (({{prefix_type}}SignalSet) UINT8_C(0))
+{{#signal_labels}}
+#define {{prefix_const}}SIGNAL_ID_{{name|u}} (({{prefix_type}}SignalId) UINT8_C({{idx}}))
+#define {{prefix_const}}SIGNAL_SET_{{name|u}} (({{prefix_type}}SignalSet) UINT8_C(1U << {{idx}}))
+{{/signal_labels}}
+
+/*| public_function_like_macros |*/
+
+/*| public_state |*/
+
+/*| public_function_declarations |*/
+void pub_tick(void);
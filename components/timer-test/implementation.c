@@ -0,0 +1,141 @@
+/*| headers |*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "rtos-timer-test.h"
+
+/*| object_like_macros |*/
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+#define ERROR_ID_NONE (({{prefix_type}}ErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW (({{prefix_type}}ErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID (({{prefix_type}}ErrorId) UINT8_C(2))
+#define ERROR_ID_TIMER_TASK_NOT_PERIODIC (({{prefix_type}}ErrorId) UINT8_C(3))
+#define ERROR_ID_TEST_WAIT_TIMEOUT (({{prefix_type}}ErrorId) UINT8_C(4))
+#define TEST_WAIT_TICKS_MAX 0x10000UL
+
+/*| types |*/
+typedef {{prefix_type}}TaskId TaskIdOption;
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+static bool signal_pending({{prefix_type}}TaskId task_id, {{prefix_type}}SignalSet signal_set);
+static void signal_send_set({{prefix_type}}TaskId task_id, {{prefix_type}}SignalSet signal_set);
+static {{prefix_type}}SignalSet signal_wait_set({{prefix_type}}SignalSet requested_set) {{prefix_const}}REENTRANT;
+static void signal_wait({{prefix_type}}SignalId signal_id) {{prefix_const}}REENTRANT;
+static uint8_t timer_pending_ticks_get_and_clear_atomically(void);
+static {{prefix_type}}TaskId get_current_task(void);
+static void test_fatal_error({{prefix_type}}ErrorId error_id);
+
+/*| state |*/
+static {{prefix_type}}SignalSet pending_signals[{{tasks.length}}];
+static {{prefix_type}}TaskId current_task;
+static uint8_t pending_ticks;
+static const {{prefix_type}}TimerId task_timers[{{tasks.length}}] = {
+{{#tasks}}
+    {{prefix_const}}TIMER_ID__TASK_{{name|u}},
+{{/tasks}}
+};
+{{prefix_type}}ErrorId pub_fatal_error_id;
+
+/*| function_like_macros |*/
+#define preempt_disable()
+#define preempt_enable()
+#define precondition_preemption_disabled()
+#define postcondition_preemption_disabled()
+#define api_assert(expression, error_id) do { } while(0)
+
+/*| functions |*/
+static bool
+signal_pending(const {{prefix_type}}TaskId task_id, const {{prefix_type}}SignalSet signal_set)
+{
+    return (pending_signals[task_id] & signal_set) != 0;
+}
+
+static void
+signal_send_set(const {{prefix_type}}TaskId task_id, const {{prefix_type}}SignalSet signal_set)
+{
+    pending_signals[task_id] |= signal_set;
+}
+
+/*
+ * While the current task waits for signals, ticks pass until one of the requested signals is pending.
+ */
+static {{prefix_type}}SignalSet
+signal_wait_set(const {{prefix_type}}SignalSet requested_set) {{prefix_const}}REENTRANT
+{
+    {{prefix_type}}SignalSet received_set;
+    unsigned long ticks = 0;
+
+    while ((pending_signals[current_task] & requested_set) == 0)
+    {
+        if (++ticks > TEST_WAIT_TICKS_MAX)
+        {
+            test_fatal_error(ERROR_ID_TEST_WAIT_TIMEOUT);
+            return {{prefix_const}}SIGNAL_SET_EMPTY;
+        }
+        pub_tick();
+    }
+
+    received_set = pending_signals[current_task] & requested_set;
+    pending_signals[current_task] &= ~requested_set;
+
+    return received_set;
+}
+
+static void
+signal_wait(const {{prefix_type}}SignalId signal_id) {{prefix_const}}REENTRANT
+{
+    (void) signal_wait_set(({{prefix_type}}SignalSet) (1U << signal_id));
+}
+
+static uint8_t
+timer_pending_ticks_get_and_clear_atomically(void)
+{
+    const uint8_t ticks = pending_ticks;
+
+    pending_ticks = 0;
+
+    return ticks;
+}
+
+static {{prefix_type}}TaskId
+get_current_task(void)
+{
+    return current_task;
+}
+
+static void
+test_fatal_error(const {{prefix_type}}ErrorId error_id)
+{
+    pub_fatal_error_id = error_id;
+}
+
+/*| public_functions |*/
+void
+pub_tick(void)
+{
+    pending_ticks = 1;
+    timer_tick_process();
+}
+
+void
+pub_set_current_task(const {{prefix_type}}TaskId task_id)
+{
+    current_task = task_id;
+}
+
+void
+pub_timer_init(void)
+{
+    {{prefix_type}}TaskId task_id;
+
+    /* For testing purposes, signals and errors are reset, but timers keep their state */
+    for (task_id = {{prefix_const}}TASK_ID_ZERO; task_id <= {{prefix_const}}TASK_ID_MAX; task_id++)
+    {
+        pending_signals[task_id] = {{prefix_const}}SIGNAL_SET_EMPTY;
+    }
+    current_task = {{prefix_const}}TASK_ID_ZERO;
+    pub_fatal_error_id = ERROR_ID_NONE;
+}
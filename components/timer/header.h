@@ -2,21 +2,43 @@
 #include <stdint.h>
 
 /*| public_types |*/
-typedef uint8_t {{prefix_type}}TimerId;
+typedef uint{{timerid_size}}_t {{prefix_type}}TimerId;
 typedef uint32_t {{prefix_type}}TicksAbsolute;
-typedef uint16_t {{prefix_type}}TicksRelative;
+typedef uint{{ticksrelative_size}}_t {{prefix_type}}TicksRelative;
 
 /*| public_structures |*/
+{{#periodic_tasks.length}}
+/* The timing statistics of the completed jobs of a periodic task, in ticks.
+ * The averages are the totals divided by the number of jobs. */
+typedef struct {
+    uint32_t jobs;
+    uint32_t deadline_misses;
+    uint32_t jitter_total;
+    uint32_t response_total;
+    {{prefix_type}}TicksRelative jitter_min;
+    {{prefix_type}}TicksRelative jitter_max;
+    {{prefix_type}}TicksRelative response_min;
+    {{prefix_type}}TicksRelative response_max;
+} {{prefix_type}}PeriodicStats;
+{{/periodic_tasks.length}}
 
 /*| public_object_like_macros |*/
 {{#timers}}
-#define {{prefix_const}}TIMER_ID_{{name|u}} (({{prefix_type}}TimerId) UINT8_C({{idx}}))
+#define {{prefix_const}}TIMER_ID_{{name|u}} (({{prefix_type}}TimerId) UINT{{timerid_size}}_C({{idx}}))
 {{/timers}}
 
+{{#periodic_tasks.length}}
+#define {{prefix_const}}PERIODIC_STATS_INIT \
+    { 0, 0, 0, 0, UINT{{ticksrelative_size}}_MAX, 0, UINT{{ticksrelative_size}}_MAX, 0 }
+{{/periodic_tasks.length}}
+
 /*| public_function_like_macros |*/
 
 /*| public_state |*/
 extern {{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+{{#periodic_tasks.length}}
+extern {{prefix_type}}PeriodicStats {{prefix_func}}periodic_stats[{{periodic_tasks.length}}];
+{{/periodic_tasks.length}}
 
 /*| public_function_declarations |*/
 void {{prefix_func}}sleep({{prefix_type}}TicksRelative ticks) {{prefix_const}}REENTRANT;
@@ -30,3 +52,7 @@ void {{prefix_func}}timer_reload_set({{prefix_type}}TimerId timer_id, {{prefix_t
 void {{prefix_func}}timer_error_set({{prefix_type}}TimerId timer_id, {{prefix_type}}ErrorId error_id);
 void {{prefix_func}}timer_signal_set({{prefix_type}}TimerId timer_id, {{prefix_type}}TaskId task_id, {{prefix_type}}SignalSet signal_set);
 {{/timers.length}}
+{{#periodic_tasks.length}}
+void {{prefix_func}}periodic_wait_next(void) {{prefix_const}}REENTRANT;
+void {{prefix_func}}periodic_stats_clear(void);
+{{/periodic_tasks.length}}
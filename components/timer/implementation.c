@@ -4,100 +4,158 @@
 
 /*| object_like_macros |*/
 {{#timers.length}}
-#define TIMER_ID_ZERO (({{prefix_type}}TimerId) UINT8_C(0))
-#define TIMER_ID_MAX (({{prefix_type}}TimerId) UINT8_C({{timers.length}} - 1U))
+#define TIMER_ID_ZERO (({{prefix_type}}TimerId) UINT{{timerid_size}}_C(0))
+#define TIMER_ID_MAX (({{prefix_type}}TimerId) UINT{{timerid_size}}_C({{timers.length}} - 1U))
+#define TIMER_WORDS {{timer_enabled_words.length}}U
 {{/timers.length}}
+{{#periodic_tasks.length}}
+#define PERIODIC_INDEX_MAX ((PeriodicIndex) UINT8_C({{periodic_tasks.length}} - 1U))
+#define PERIODIC_INDEX_NONE ((PeriodicIndex) UINT8_MAX)
+{{/periodic_tasks.length}}
 
 /*| types |*/
-typedef uint16_t TicksTimeout;
+typedef uint{{ticksrelative_size}}_t TicksTimeout;
+typedef uint32_t TimerWord;
+typedef uint8_t PeriodicIndex;
 
 /*| structures |*/
-{{#timers.length}}
-struct timer
+{{#periodic_tasks.length}}
+struct periodic_task
 {
-    bool enabled;
-    bool overflow;
-    TicksTimeout expiry;
-    {{prefix_type}}TicksRelative reload;
-
-    /*
-     * when error_id is not ERROR_ID_NONE, the timer calls
-     * the application error function with this error_id.
-     */
-    {{prefix_type}}ErrorId error_id;
-
+    /* The nominal release time of the current job, or of the job before the first one */
+    {{prefix_type}}TicksAbsolute release;
+    {{prefix_type}}TicksRelative period;
+    {{prefix_type}}TicksRelative deadline;
     {{prefix_type}}TaskId task_id;
     {{prefix_type}}SignalSet signal_set;
+    bool job_active;
+    {{prefix_type}}TicksRelative job_jitter;
 };
-{{/timers.length}}
+{{/periodic_tasks.length}}
 
 /*| extern_declarations |*/
 
 /*| function_declarations |*/
 {{#timers.length}}
-static void timer_process_one(struct timer *timer);
+static void timer_process_one({{prefix_type}}TimerId timer_id);
 static void timer_enable({{prefix_type}}TimerId timer_id);
 static void timer_oneshot({{prefix_type}}TimerId timer_id, {{prefix_type}}TicksRelative timeout);
 {{/timers.length}}
 static void timer_tick_process(void);
+{{#periodic_tasks.length}}
+static void periodic_release_process(void);
+static PeriodicIndex periodic_index_get({{prefix_type}}TaskId task_id);
+static void periodic_stats_record(PeriodicIndex idx, {{prefix_type}}TicksRelative jitter,
+                                  {{prefix_type}}TicksRelative response);
+{{/periodic_tasks.length}}
 
 /*| state |*/
 {{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
 {{#timers.length}}
-static struct timer timers[{{timers.length}}] = {
+/*
+ * The state of the timers is laid out as one array per field, indexed by timer ID.
+ * The enabled and overflow flags are packed into bitmaps of 32 timers per word, so that tick processing only visits
+ * the enabled timers.
+ */
+static TimerWord timers_enabled[TIMER_WORDS] = {
+{{#timer_enabled_words}}
+    UINT32_C({{.}}),
+{{/timer_enabled_words}}
+};
+static TimerWord timers_overflow[TIMER_WORDS];
+static TicksTimeout timer_expiries[{{timers.length}}] = {
+{{#timers}}
+    {{#enabled}}{{reload}}{{/enabled}}{{^enabled}}0{{/enabled}},
+{{/timers}}
+};
+static {{prefix_type}}TicksRelative timer_reloads[{{timers.length}}] = {
+{{#timers}}
+    {{reload}},
+{{/timers}}
+};
+/* When the error ID of a timer is not ERROR_ID_NONE, the timer calls the application error function with it */
+static {{prefix_type}}ErrorId timer_error_ids[{{timers.length}}] = {
 {{#timers}}
+    {{error}},
+{{/timers}}
+};
+static {{prefix_type}}TaskId timer_task_ids[{{timers.length}}] = {
+{{#timers}}
+    {{#task}}{{prefix_const}}TASK_ID_{{name|u}}{{/task}}{{^task}}TASK_ID_NONE{{/task}},
+{{/timers}}
+};
+static {{prefix_type}}SignalSet timer_signal_sets[{{timers.length}}] = {
+{{#timers}}
+    {{#sig_set}}{{prefix_const}}SIGNAL_SET_{{.|u}}{{/sig_set}}{{^sig_set}}{{prefix_const}}SIGNAL_SET_EMPTY{{/sig_set}},
+{{/timers}}
+};
+{{/timers.length}}
+{{#periodic_tasks.length}}
+static struct periodic_task periodic_tasks[{{periodic_tasks.length}}] = {
+{{#periodic_tasks}}
     {
-        {{#enabled}}true{{/enabled}}{{^enabled}}false{{/enabled}},
+        ({{prefix_type}}TicksAbsolute) {{phase}} - {{period}},
+        {{period}},
+        {{deadline}},
+        {{prefix_const}}TASK_ID_{{task.name|u}},
+        {{prefix_const}}SIGNAL_SET_{{sig_set|u}},
         false,
-        {{#enabled}}{{reload}}{{/enabled}}{{^enabled}}0{{/enabled}},
-        {{reload}},
-        {{error}},
-        {{#task}}{{prefix_const}}TASK_ID_{{name|u}}{{/task}}{{^task}}TASK_ID_NONE{{/task}},
-        {{#sig_set}}{{prefix_const}}SIGNAL_SET_{{.|u}}{{/sig_set}}{{^sig_set}}{{prefix_const}}SIGNAL_SET_EMPTY{{/sig_set}}
+        0
     },
-{{/timers}}
+{{/periodic_tasks}}
 };
-{{/timers.length}}
+{{prefix_type}}PeriodicStats {{prefix_func}}periodic_stats[{{periodic_tasks.length}}] = {
+{{#periodic_tasks}}
+    {{prefix_const}}PERIODIC_STATS_INIT,
+{{/periodic_tasks}}
+};
+{{/periodic_tasks.length}}
 
 /*| function_like_macros |*/
 {{#timers.length}}
-#define timer_expired(timer, timeout) ((timer)->enabled && (timer)->expiry == timeout)
-#define timer_is_periodic(timer) ((timer)->reload > 0)
-#define timer_reload_set(timer_id, ticks) timers[timer_id].reload = ticks
-#define timer_disable(timer_id) timers[timer_id].enabled = false
+#define TIMER_WORD(timer_id) ((timer_id) / 32U)
+#define TIMER_BIT(timer_id) ((TimerWord) 1U << ((timer_id) % 32U))
+#define timer_is_enabled(timer_id) ((timers_enabled[TIMER_WORD(timer_id)] & TIMER_BIT(timer_id)) != 0)
+#define timer_is_periodic(timer_id) (timer_reloads[timer_id] > 0)
+#define timer_reload_set(timer_id, ticks) timer_reloads[timer_id] = ticks
+#define timer_disable(timer_id) timers_enabled[TIMER_WORD(timer_id)] &= ~TIMER_BIT(timer_id)
 #define current_timeout() ((TicksTimeout) {{prefix_func}}timer_current_ticks)
-#define TIMER_PTR(timer_id) (&timers[timer_id])
 {{/timers.length}}
 #define assert_timer_valid(timer) api_assert(timer_id < {{timers.length}}, ERROR_ID_INVALID_ID)
+{{#periodic_tasks.length}}
+#define periodic_ticks_clamp(ticks) \
+    ((ticks) > UINT{{ticksrelative_size}}_MAX ? ({{prefix_type}}TicksRelative) UINT{{ticksrelative_size}}_MAX :\
+     ({{prefix_type}}TicksRelative) (ticks))
+{{/periodic_tasks.length}}
 
 
 /*| functions |*/
 {{#timers.length}}
 static void
-timer_process_one(struct timer *const timer)
+timer_process_one(const {{prefix_type}}TimerId timer_id)
 {
     precondition_preemption_disabled();
 
-    if (timer_is_periodic(timer))
+    if (timer_is_periodic(timer_id))
     {
-        timer->expiry += timer->reload;
+        timer_expiries[timer_id] += timer_reloads[timer_id];
     }
     else
     {
-        timer->enabled = false;
+        timer_disable(timer_id);
     }
 
-    if (timer->error_id != ERROR_ID_NONE)
+    if (timer_error_ids[timer_id] != ERROR_ID_NONE)
     {
-        {{fatal_error}}(timer->error_id);
+        {{fatal_error}}(timer_error_ids[timer_id]);
     }
     else
     {
-        if (signal_pending(timer->task_id, timer->signal_set))
+        if (signal_pending(timer_task_ids[timer_id], timer_signal_sets[timer_id]))
         {
-            timer->overflow = true;
+            timers_overflow[TIMER_WORD(timer_id)] |= TIMER_BIT(timer_id);
         }
-        signal_send_set(timer->task_id, timer->signal_set);
+        signal_send_set(timer_task_ids[timer_id], timer_signal_sets[timer_id]);
     }
 
     postcondition_preemption_disabled();
@@ -108,14 +166,14 @@ timer_enable(const {{prefix_type}}TimerId timer_id)
 {
     precondition_preemption_disabled();
 
-    if (timers[timer_id].reload == 0)
+    if (timer_reloads[timer_id] == 0)
     {
-        timer_process_one(&timers[timer_id]);
+        timer_process_one(timer_id);
     }
     else
     {
-        timers[timer_id].expiry = current_timeout() + timers[timer_id].reload;
-        timers[timer_id].enabled = true;
+        timer_expiries[timer_id] = current_timeout() + timer_reloads[timer_id];
+        timers_enabled[TIMER_WORD(timer_id)] |= TIMER_BIT(timer_id);
     }
 
     postcondition_preemption_disabled();
@@ -149,22 +207,40 @@ timer_tick_process(void)
         if (pending_ticks)
         {
             {{#timers.length}}
-            {{prefix_type}}TimerId timer_id;
-            struct timer *timer;
+            {{prefix_type}}TimerId word, timer_id;
+            TimerWord enabled;
             TicksTimeout timeout;
             {{/timers.length}}
 
             {{prefix_func}}timer_current_ticks++;
+{{#periodic_tasks.length}}
+            periodic_release_process();
+{{/periodic_tasks.length}}
+[[#time_slicing]]
+{{#time_slice}}
+            /* The tick interrupt does not pend a preemption by itself, so the expiry of a time slice does */
+            if (sched_time_slice_tick())
+            {
+                preempt_pend();
+            }
+{{/time_slice}}
+[[/time_slicing]]
 
             {{#timers.length}}
             timeout = current_timeout();
 
-            for (timer_id = TIMER_ID_ZERO; timer_id <= TIMER_ID_MAX; timer_id++)
+            /* loop bound: {{timer_enabled_words.length}} */
+            for (word = 0; word < TIMER_WORDS; word++)
             {
-                timer = TIMER_PTR(timer_id);
-                if (timer_expired(timer, timeout))
+                /* Visit the enabled timers of the word, up to the last one */
+                enabled = timers_enabled[word];
+                /* loop bound: 32 */
+                for (timer_id = ({{prefix_type}}TimerId) (word * 32U); enabled != 0; timer_id++, enabled >>= 1)
                 {
-                    timer_process_one(timer);
+                    if ((enabled & 1U) != 0 && timer_expiries[timer_id] == timeout)
+                    {
+                        timer_process_one(timer_id);
+                    }
                 }
             }
             {{/timers.length}}
@@ -172,6 +248,84 @@ timer_tick_process(void)
     }
     postcondition_preemption_disabled();
 }
+{{#periodic_tasks.length}}
+
+/*
+ * Signal the tasks whose next job is released at the current tick.
+ * If a task is still executing an earlier job, the signal remains pending and periodic_wait_next() checks the release
+ * time rather than relying on the number of signals received.
+ */
+static void
+periodic_release_process(void)
+{
+    PeriodicIndex idx;
+    struct periodic_task *periodic;
+
+    precondition_preemption_disabled();
+
+    /* loop bound: {{periodic_tasks.length}} */
+    for (idx = 0; idx <= PERIODIC_INDEX_MAX; idx++)
+    {
+        periodic = &periodic_tasks[idx];
+        if ({{prefix_func}}timer_current_ticks == periodic->release + periodic->period)
+        {
+            signal_send_set(periodic->task_id, periodic->signal_set);
+        }
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static PeriodicIndex
+periodic_index_get(const {{prefix_type}}TaskId task_id)
+{
+    PeriodicIndex idx;
+
+    /* loop bound: {{periodic_tasks.length}} */
+    for (idx = 0; idx <= PERIODIC_INDEX_MAX; idx++)
+    {
+        if (periodic_tasks[idx].task_id == task_id)
+        {
+            return idx;
+        }
+    }
+
+    return PERIODIC_INDEX_NONE;
+}
+
+static void
+periodic_stats_record(const PeriodicIndex idx, const {{prefix_type}}TicksRelative jitter,
+                      const {{prefix_type}}TicksRelative response)
+{
+    {{prefix_type}}PeriodicStats *const stats = &{{prefix_func}}periodic_stats[idx];
+
+    stats->jobs++;
+    if (response > periodic_tasks[idx].deadline)
+    {
+        stats->deadline_misses++;
+    }
+
+    stats->jitter_total += jitter;
+    if (jitter < stats->jitter_min)
+    {
+        stats->jitter_min = jitter;
+    }
+    if (jitter > stats->jitter_max)
+    {
+        stats->jitter_max = jitter;
+    }
+
+    stats->response_total += response;
+    if (response < stats->response_min)
+    {
+        stats->response_min = response;
+    }
+    if (response > stats->response_max)
+    {
+        stats->response_max = response;
+    }
+}
+{{/periodic_tasks.length}}
 
 /*| public_functions |*/
 void
@@ -203,7 +357,11 @@ void
 {
     assert_timer_valid(timer_id);
 
+    preempt_disable();
+
     timer_disable(timer_id);
+
+    preempt_enable();
 }
 
 void
@@ -227,8 +385,8 @@ bool
 
     preempt_disable();
 
-    r = timers[timer_id].overflow;
-    timers[timer_id].overflow = false;
+    r = (timers_overflow[TIMER_WORD(timer_id)] & TIMER_BIT(timer_id)) != 0;
+    timers_overflow[TIMER_WORD(timer_id)] &= ~TIMER_BIT(timer_id);
 
     preempt_enable();
 
@@ -244,7 +402,7 @@ bool
 
     preempt_disable();
 
-    remaining = timers[timer_id].enabled ? timers[timer_id].expiry - current_timeout() : 0;
+    remaining = timer_is_enabled(timer_id) ? timer_expiries[timer_id] - current_timeout() : 0;
 
     preempt_enable();
 
@@ -267,9 +425,9 @@ void
 
     preempt_disable();
 
-    timers[timer_id].error_id = ERROR_ID_NONE;
-    timers[timer_id].task_id = task_id;
-    timers[timer_id].signal_set = signal_set;
+    timer_error_ids[timer_id] = ERROR_ID_NONE;
+    timer_task_ids[timer_id] = task_id;
+    timer_signal_sets[timer_id] = signal_set;
 
     preempt_enable();
 }
@@ -279,6 +437,60 @@ void
 {
     assert_timer_valid(timer_id);
 
-    timers[timer_id].error_id = error_id;
+    timer_error_ids[timer_id] = error_id;
 }
 {{/timers.length}}
+{{#periodic_tasks.length}}
+
+void
+{{prefix_func}}periodic_wait_next(void) {{prefix_const}}REENTRANT
+{
+    const PeriodicIndex idx = periodic_index_get(get_current_task());
+    struct periodic_task *periodic;
+    {{prefix_type}}TicksAbsolute release;
+
+    api_assert(idx != PERIODIC_INDEX_NONE, ERROR_ID_TIMER_TASK_NOT_PERIODIC);
+    periodic = &periodic_tasks[idx];
+
+    preempt_disable();
+
+    if (periodic->job_active)
+    {
+        periodic_stats_record(idx, periodic->job_jitter,
+                              periodic_ticks_clamp({{prefix_func}}timer_current_ticks - periodic->release));
+    }
+
+    /*
+     * The release time of the current job determines when periodic_release_process() signals the next one, so it
+     * only advances once the next job is released
+     */
+    release = periodic->release + periodic->period;
+    while ((int32_t) ({{prefix_func}}timer_current_ticks - release) < 0)
+    {
+        (void) signal_wait_set(periodic->signal_set);
+    }
+    periodic->release = release;
+
+    periodic->job_jitter = periodic_ticks_clamp({{prefix_func}}timer_current_ticks - release);
+    periodic->job_active = true;
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}periodic_stats_clear(void)
+{
+    PeriodicIndex idx;
+    const {{prefix_type}}PeriodicStats initial_stats = {{prefix_const}}PERIODIC_STATS_INIT;
+
+    preempt_disable();
+
+    /* loop bound: {{periodic_tasks.length}} */
+    for (idx = 0; idx <= PERIODIC_INDEX_MAX; idx++)
+    {
+        {{prefix_func}}periodic_stats[idx] = initial_stats;
+    }
+
+    preempt_enable();
+}
+{{/periodic_tasks.length}}
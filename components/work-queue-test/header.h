@@ -0,0 +1,35 @@
+/*| public_headers |*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*| public_types |*/
+typedef uint8_t {{prefix_type}}TaskId;
+typedef uint8_t {{prefix_type}}InterruptEventId;
+typedef uint8_t {{prefix_type}}SignalSet;
+
+/*| public_structures |*/
+
+/*| public_object_like_macros |*/
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+{{#tasks}}
+#define {{prefix_const}}TASK_ID_{{name|u}} (({{prefix_type}}TaskId) UINT8_C({{idx}}))
+{{/tasks}}
+{{#interrupt_events}}
+#define {{prefix_const}}INTERRUPT_EVENT_ID_{{name|u}} (({{prefix_type}}InterruptEventId) UINT8_C({{idx}}))
+{{/interrupt_events}}
+#define {{prefix_const}}SIGNAL_SET__WORK (({{prefix_type}}SignalSet) UINT8_C(2))
+
+/*| public_function_like_macros |*/
+
+/*| public_state |*/
+
+/*| public_function_declarations |*/
+void {{prefix_func}}interrupt_event_raise({{prefix_type}}InterruptEventId interrupt_event_id);
+{{prefix_type}}SignalSet {{prefix_func}}signal_wait_set({{prefix_type}}SignalSet requested_signals);
+void pub_work_queue_init(void);
+void pub_work_queue_set_position({{prefix_type}}WorkQueueId work_queue, uint32_t position);
+void pub_set_interrupt_ptr(void (*y)(void), uint32_t compare_and_swap_count);
+void pub_set_wait_ptr(bool (*y)(void));
+void pub_work_queue_run({{prefix_type}}WorkQueueId work_queue);
+void *pub_work_queue_dequeue({{prefix_type}}WorkQueueId work_queue);
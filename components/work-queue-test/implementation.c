@@ -0,0 +1,166 @@
+/*| headers |*/
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rtos-work-queue-test.h"
+
+/*| object_like_macros |*/
+
+/*| types |*/
+
+/*| structures |*/
+
+/*| extern_declarations |*/
+
+/*| function_declarations |*/
+static bool atomic_compare_and_swap(volatile uint32_t *word, uint32_t expected, uint32_t desired);
+static void signal_send_set({{prefix_type}}TaskId task_id, {{prefix_type}}SignalSet signals);
+
+/*| state |*/
+static void (*interrupt_ptr)(void);
+static uint32_t interrupt_compare_and_swap_count;
+static bool (*wait_ptr)(void);
+static jmp_buf worker_jmp_buf;
+{{prefix_type}}SignalSet pub_signals[{{tasks.length}}];
+bool pub_interrupt_events[{{interrupt_events.length}}];
+uint32_t pub_waits;
+
+/*| function_like_macros |*/
+#define preempt_disable()
+#define preempt_enable()
+#define api_assert(expression, error_id) do { } while(0)
+
+/*| functions |*/
+/*
+ * The interrupt, if one is set, occurs immediately before the given compare-and-swap operation, i.e., after the
+ * caller has read the value that it expects.
+ */
+static bool
+atomic_compare_and_swap(volatile uint32_t *const word, const uint32_t expected, const uint32_t desired)
+{
+    void (*const interrupt)(void) = interrupt_ptr;
+
+    if (interrupt != NULL && --interrupt_compare_and_swap_count == 0)
+    {
+        interrupt_ptr = NULL;
+        interrupt();
+    }
+
+    if (*word != expected)
+    {
+        return false;
+    }
+    *word = desired;
+    return true;
+}
+
+static void
+signal_send_set(const {{prefix_type}}TaskId task_id, const {{prefix_type}}SignalSet signals)
+{
+    pub_signals[task_id] |= signals;
+}
+
+/*| public_functions |*/
+void
+{{prefix_func}}interrupt_event_raise(const {{prefix_type}}InterruptEventId interrupt_event_id)
+{
+    pub_interrupt_events[interrupt_event_id] = true;
+}
+
+/*
+ * While a worker waits, the wait function that the test sets runs other tasks and interrupt handlers.
+ * The worker stops when the wait function returns false, or when the test sets none.
+ */
+{{prefix_type}}SignalSet
+{{prefix_func}}signal_wait_set(const {{prefix_type}}SignalSet requested_signals)
+{
+    pub_waits++;
+    if (wait_ptr == NULL || !wait_ptr())
+    {
+        longjmp(worker_jmp_buf, 1);
+    }
+    return requested_signals;
+}
+
+void
+pub_work_queue_init(void)
+{
+    {{prefix_type}}WorkQueueId work_queue;
+    {{prefix_type}}TaskId task_id;
+    {{prefix_type}}InterruptEventId interrupt_event_id;
+
+    /* For testing purposes, the positions of the work queues are reset, too */
+    for (work_queue = 0; work_queue < {{work_queues.length}}; work_queue++)
+    {
+        work_queue_states[work_queue].enqueue_pos = 0;
+        work_queue_states[work_queue].dequeue_pos = 0;
+    }
+    work_queue_init();
+    for (task_id = {{prefix_const}}TASK_ID_ZERO; task_id <= {{prefix_const}}TASK_ID_MAX; task_id++)
+    {
+        pub_signals[task_id] = 0;
+    }
+    for (interrupt_event_id = 0; interrupt_event_id < {{interrupt_events.length}}; interrupt_event_id++)
+    {
+        pub_interrupt_events[interrupt_event_id] = false;
+    }
+    interrupt_ptr = NULL;
+    wait_ptr = NULL;
+    pub_waits = 0;
+}
+
+/*
+ * Move the positions of an empty work queue, e.g., close to the wrap-around of the 32-bit positions.
+ */
+void
+pub_work_queue_set_position(const {{prefix_type}}WorkQueueId work_queue, const uint32_t position)
+{
+    const uint32_t mask = work_queues[work_queue].mask;
+    uint32_t slot;
+
+    work_queue_states[work_queue].enqueue_pos = position;
+    work_queue_states[work_queue].dequeue_pos = position;
+    /* Each slot can next hold the first position from the given one onwards that maps to it */
+    for (slot = 0; slot <= mask; slot++)
+    {
+        work_queues[work_queue].slots[slot].sequence = position + ((slot - position) & mask);
+    }
+}
+
+void
+pub_set_interrupt_ptr(void (*y)(void), const uint32_t compare_and_swap_count)
+{
+    interrupt_ptr = y;
+    interrupt_compare_and_swap_count = compare_and_swap_count;
+}
+
+void
+pub_set_wait_ptr(bool (*y)(void))
+{
+    wait_ptr = y;
+}
+
+/*
+ * Run the worker of a work queue until it stops waiting.
+ */
+void
+pub_work_queue_run(const {{prefix_type}}WorkQueueId work_queue)
+{
+    if (setjmp(worker_jmp_buf) == 0)
+    {
+        {{prefix_func}}work_queue_worker(work_queue);
+    }
+}
+
+/*
+ * Dequeue an item as another worker would, and return its context, or NULL if the work queue is empty.
+ */
+void *
+pub_work_queue_dequeue(const {{prefix_type}}WorkQueueId work_queue)
+{
+    {{prefix_type}}WorkFunction function;
+    void *context;
+
+    return work_queue_dequeue(work_queue, &function, &context) ? context : NULL;
+}
@@ -0,0 +1,27 @@
+/*| public_headers |*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*| public_types |*/
+typedef uint8_t {{prefix_type}}WorkQueueId;
+typedef void (*{{prefix_type}}WorkFunction)(void *context);
+
+/*| public_structures |*/
+
+/*| public_object_like_macros |*/
+{{#work_queues}}
+#define {{prefix_const}}WORK_QUEUE_ID_{{name|u}} (({{prefix_type}}WorkQueueId) UINT8_C({{idx}}))
+{{/work_queues}}
+
+/*| public_function_like_macros |*/
+
+/*| public_state |*/
+
+/*| public_function_declarations |*/
+{{#work_queues.length}}
+bool {{prefix_func}}work_queue_submit({{prefix_type}}WorkQueueId work_queue, {{prefix_type}}WorkFunction function,
+                                    void *context);
+bool {{prefix_func}}work_queue_submit_from_interrupt({{prefix_type}}WorkQueueId work_queue,
+                                                   {{prefix_type}}WorkFunction function, void *context);
+void {{prefix_func}}work_queue_worker({{prefix_type}}WorkQueueId work_queue) {{prefix_const}}REENTRANT;
+{{/work_queues.length}}
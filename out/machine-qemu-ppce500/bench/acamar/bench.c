@@ -0,0 +1,125 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+/*
+ * Kernel benchmarks shared by every RTOS variant.
+ *
+ * The system provides two tasks: 'main', which drives the benchmarks and
+ * takes the measurements, and 'helper', which is the other end of every
+ * context switch.
+ * On preemptive variants 'helper' must have the higher priority.
+ *
+ * Each result is printed on a single line:
+ *
+ *   bench: <name> <param> <iterations> <elapsed>
+ *
+ * with the numeric fields in hexadecimal and 'elapsed' in units of the platform's bench clock.
+ * The line 'bench: done' marks the end of the run.
+ * 'x.py bench' parses this output.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "rtos-acamar.h"
+#include "debug.h"
+
+#define BENCH_ITERATIONS 1000
+
+/* Provided by the platform's bench-platform module. */
+extern void bench_clock_init(void);
+extern uint32_t bench_clock(void);
+extern void bench_exit(void);
+
+
+
+static void
+bench_report(const char *const name, const uint32_t param, const uint32_t iterations, const uint32_t elapsed)
+{
+    debug_print("bench: ");
+    debug_print(name);
+    debug_print(" ");
+    debug_printhex32(param);
+    debug_print(" ");
+    debug_printhex32(iterations);
+    debug_print(" ");
+    debug_printhex32(elapsed);
+    debug_println("");
+}
+
+static void
+bench_done(void)
+{
+    debug_println("bench: done");
+    bench_exit();
+    for (;;)
+    {
+    }
+}
+
+static void
+bench_context_switch(void)
+{
+    uint32_t i;
+    uint32_t start;
+
+    start = bench_clock();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        rtos_yield_to(RTOS_TASK_ID_HELPER);
+    }
+    bench_report("cswitch-yield-to", 0, 2 * BENCH_ITERATIONS, bench_clock() - start);
+}
+
+void
+bench_main(void)
+{
+    bench_clock_init();
+    /* Tasks do not all start out runnable; make both of them runnable in whichever way the variant provides. */
+
+    bench_context_switch();
+
+    bench_done();
+}
+
+void
+bench_helper(void)
+{
+    for (;;)
+    {
+        rtos_yield_to(RTOS_TASK_ID_MAIN);
+    }
+}
+
+int
+main(void)
+{
+    rtos_start();
+    for (;;)
+    {
+    }
+}
@@ -0,0 +1,524 @@
+
+#include <stdint.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdbool.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+#include "rtos-acrux.h"
+
+
+/**
+ * This implementation follows the conventions of the PowerPC EABI specification, obtained from:
+ *
+ * http://www.freescale.com/files/32bit/doc/app_note/PPCEABI.pdf
+ *
+ * The PowerPC EABI is also documented in detail in the following application note:
+ *
+ * https://www-01.ibm.com/chips/techlib/techlib.nsf/techdocs/852569B20050FF77852569970071B0D6/
+ *
+ * PowerPC EABI register usage:
+ *  R0      Volatile: Language-specific
+ *  R1      Dedicated: SP
+ *  R2      Dedicated: Read-only small data area anchor
+ *  R3-R4   Volatile: Parameter passing / return values
+ *  R5-R10  Volatile: Parameter passing
+ *  R11-R12 Volatile
+ *  R13     Dedicated: Read-write small data area anchor
+ *  R14-R31 Nonvolatile
+ *  F0      Volatile: Language-specific
+ *  F1      Volatile: Parameter passing / return values
+ *  F2-F8   Volatile: Parameter passing
+ *  F9-F13  Volatile
+ *  F14-F31 Nonvolatile
+ *  Fields CR2-CR4      Nonvolatile
+ *  (Other CR fields)   Volatile
+ *  (Other registers)   Volatile
+ *
+ * R0-R31 are the general-purpose registers (GPRs) and F0-F31 are the floating-point registers (FPRs).
+ * CRn refers to the n'th of the eight 4-bit fields of the 32-bit condition register (CR).
+ *
+ * On context switch, we push non-volatile registers onto the stack following the EABI stack frame conventions:
+ * The stack grows downwards, from high to low addresses, and is padded to ensure each stack frame is 8-byte aligned.
+ * The creation of a stack frame takes place in the prologue of a function being called, and is optional in the sense
+ * that leaf functions (that do not call any other functions) may opt not to do this.
+ *
+ * PowerPC EABI stack frame:
+ *     +------------------------------------------------------------+ Highest address
+ *     | FPR save area (optional)                                   |
+ *     +------------------------------------------------------------+
+ *     | GPR save area (optional)                                   |
+ *     +------------------------------------------------------------+
+ *     | CR save word (optional)                                    |
+ *     +------------------------------------------------------------+
+ *     | Local variables area (optional)                            |
+ *     +------------------------------------------------------------+
+ *     | Function parameters area (optional)                        |
+ *     +------------------------------------------------------------+
+ *     | Padding to adjust size to multiple of 8 bytes (1-7 bytes)  |
+ *     +------------------------------------------------------------+
+ *     | LR Save Word                                               |
+ *     +------------------------------------------------------------+
+ *     | Back Chain Word                                            |
+ *     +------------------------------------------------------------+ Lowest address
+ *
+ * The bottom two words (LR Save & Back Chain) comprise the stack frame's header, and are the only compulsory fields.
+ * The LR is the link register, used to track function return addresses.
+ * The EABI states that the LR is to be saved in the LR save word of calling function's stack frame, not in the stack
+ * frame of the currently executing function.
+ * The back chain word points to the previous stack frame's back chain word field, forming a linked list.
+ * The first (uppermost) stack frame shall have a back chain of 0 (NULL).
+ */
+#define CONTEXT_BC_IDX 0
+#define CONTEXT_LR_IDX 1
+#define CONTEXT_HEADER_SIZE (CONTEXT_LR_IDX + 1)
+#define CONTEXT_GPR14_IDX 2
+#define CONTEXT_GPR15_IDX 3
+#define CONTEXT_GPR16_IDX 4
+#define CONTEXT_GPR17_IDX 5
+#define CONTEXT_GPR18_IDX 6
+#define CONTEXT_GPR19_IDX 7
+#define CONTEXT_GPR20_IDX 8
+#define CONTEXT_GPR21_IDX 9
+#define CONTEXT_GPR22_IDX 10
+#define CONTEXT_GPR23_IDX 11
+#define CONTEXT_GPR24_IDX 12
+#define CONTEXT_GPR25_IDX 13
+#define CONTEXT_GPR26_IDX 14
+#define CONTEXT_GPR27_IDX 15
+#define CONTEXT_GPR28_IDX 16
+#define CONTEXT_GPR29_IDX 17
+#define CONTEXT_GPR30_IDX 18
+#define CONTEXT_GPR31_IDX 19
+#define CONTEXT_FRAME_SIZE (CONTEXT_GPR31_IDX + 1)
+
+
+
+
+
+#define ERROR_ID_NONE ((RtosErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW ((RtosErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID ((RtosErrorId) UINT8_C(2))
+#define ERROR_ID_NOT_HOLDING_MUTEX ((RtosErrorId) UINT8_C(3))
+#define ERROR_ID_DEADLOCK ((RtosErrorId) UINT8_C(4))
+#define ERROR_ID_TASK_FUNCTION_RETURNS ((RtosErrorId) UINT8_C(5))
+#define ERROR_ID_INTERNAL_CURRENT_TASK_INVALID ((RtosErrorId) UINT8_C(6))
+#define ERROR_ID_INTERNAL_INVALID_ID ((RtosErrorId) UINT8_C(7))
+#define ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP ((RtosErrorId) UINT8_C(8))
+#define ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(9))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(10))
+#define ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER ((RtosErrorId) UINT8_C(11))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW ((RtosErrorId) UINT8_C(12))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION ((RtosErrorId) UINT8_C(13))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_CONFIGURATION ((RtosErrorId) UINT8_C(14))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_HEAD ((RtosErrorId) UINT8_C(15))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE ((RtosErrorId) UINT8_C(16))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_ID_IN_WAITERS ((RtosErrorId) UINT8_C(17))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TASKS_BLOCKED_DESPITE_AVAILABLE_MESSAGES ((RtosErrorId) UINT8_C(18))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_WAITING_TASK_IS_NOT_BLOCKED ((RtosErrorId) UINT8_C(19))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGES_POINTER ((RtosErrorId) UINT8_C(20))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGE_SIZE ((RtosErrorId) UINT8_C(21))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH ((RtosErrorId) UINT8_C(22))
+#define ERROR_ID_INTERNAL_PRECONDITION_VIOLATED ((RtosErrorId) UINT8_C(23))
+#define ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED ((RtosErrorId) UINT8_C(24))
+#define ERROR_ID_SEMAPHORE_MAX_INVALID ((RtosErrorId) UINT8_C(25))
+#define ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT ((RtosErrorId) UINT8_C(26))
+#define ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT ((RtosErrorId) UINT8_C(27))
+#define ERROR_ID_SEMAPHORE_MAX_EXCEEDED ((RtosErrorId) UINT8_C(28))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED ((RtosErrorId) UINT8_C(29))
+#define ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX ((RtosErrorId) UINT8_C(30))
+#define ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED ((RtosErrorId) UINT8_C(31))
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+#define current_task rtos_internal_current_task
+#define tasks rtos_internal_tasks
+
+typedef uint32_t* context_t;
+typedef RtosTaskId SchedIndex;
+typedef RtosTaskId TaskIdOption;
+
+
+
+
+struct sched_task {
+    bool runnable;
+};
+
+struct sched {
+    SchedIndex cur; /* The index of the currently scheduled task */
+    struct sched_task tasks[2];
+};
+
+
+struct mutex {
+    bool locked;
+};
+
+struct task
+{
+    context_t ctx;
+};
+
+
+
+extern void rtos_internal_context_switch(context_t *, context_t *) RTOS_REENTRANT;
+extern void rtos_internal_context_switch_first(context_t *) RTOS_REENTRANT;
+
+
+extern void rtos_internal_interrupts_disable(void);
+extern void rtos_internal_interrupts_enable(void);
+extern void rtos_internal_interrupts_wait(void);
+extern bool rtos_internal_check_interrupts_enabled(void);
+
+
+extern void None(RtosErrorId error_id);
+extern void bench_main(void);
+extern void bench_helper(void);
+
+
+
+/**
+ * Set up the initial execution context of a task.
+ * This function is invoked exactly once for each task in the system.
+  *
+ * @param ctx An output parameter interpreted by the RTOS as the initial context for each task.
+ *  After this function returns, the RTOS uses the value of ctx for task/context/stack switching.
+ *  The concept of a context and of the context_t type is abstract and may have different implementations on
+ *  different platforms.
+ *  It can be, e.g., a stack pointer or a data structure for user-level task switching as on POSIX.
+ *  This function is expected to set ctx to a value that the RTOS can pass to this platform's implementation of
+ *  context_switch() and context_switch_first().
+ *  The context must be set up such that the destination task of a task switch executes the code at the address fn
+ *  using the memory region defined by stack_base and stack_size as its stack.
+ *  For hardware platforms, this typically requires the following set up steps:
+ *  - The value of ctx points to either the beginning or the end of the stack area.
+ *  - The stack area contains fn so that the context-switch functions can pop it off the stack as a return address to
+ *    begin execution at.
+ *  - Optionally reserve additional stack space if the context-switch functions depend on it.
+ * @param fn Points to a code address at which the given execution context shall start executing.
+ *  This is typically a pointer to a parameter-less function that is assumed to never return.
+ * @param stack_base Points to the lowest address of the memory area this execution context shall use as a stack.
+ * @param stack_size The size in bytes of the stack memory area reserved for this execution context.
+ */
+static void context_init(context_t *ctx, void (*fn)(void), uint32_t *stack_base, size_t stack_size);
+
+static void sched_set_runnable(const RtosTaskId task_id);
+static void sched_set_blocked(const RtosTaskId task_id);
+static TaskIdOption sched_get_next(void);
+static void interrupt_event_process(void);
+static void interrupt_event_wait(void);
+RtosTaskId rtos_internal_interrupt_event_get_next(void);
+
+
+static void interrupt_event_handle(RtosInterruptEventId interrupt_event_id);
+
+/*
+ * PowerPC EABI stack is 8-byte aligned.
+ * See ppce500-context-switch.c
+ */
+static uint32_t stack_0[8192] __attribute__((aligned(8)));
+static uint32_t stack_1[8192] __attribute__((aligned(8)));
+
+
+static struct sched sched_tasks;
+static volatile uint32_t interrupt_event;
+static bool system_is_idle;
+static struct mutex mutexes[1];
+
+RtosTaskId rtos_internal_current_task;
+struct task rtos_internal_tasks[2];
+
+
+
+#define context_switch(from, to) rtos_internal_context_switch(to, from)
+#define context_switch_first(to) rtos_internal_context_switch_first(to)
+#define preempt_disable()
+#define preempt_enable()
+#define preempt_clear()
+#define precondition_preemption_disabled()
+#define postcondition_preemption_disabled()
+#define sched_runnable(task_id) (SCHED_OBJ(task_id).runnable)
+#define sched_next_index(cur) (((cur) == sched_max_index()) ? 0 : ((cur) + 1))
+#define sched_get_cur_index() (sched_tasks.cur)
+#define sched_set_cur_index(idx) sched_tasks.cur = (idx)
+#define sched_max_index() (SchedIndex)(2 - 1U)
+#define sched_index_to_taskid(sched_index) (RtosTaskId)(sched_index)
+#define SCHED_OBJ(task_id) sched_tasks.tasks[task_id]
+/* Return true if there are any pending interrupts, false otherwise. */
+#define interrupt_application_event_check() (interrupt_event != 0)
+#define interrupts_disable() rtos_internal_interrupts_disable()
+#define interrupts_enable() rtos_internal_interrupts_enable()
+#define interrupts_wait() rtos_internal_interrupts_wait()
+#define irqs_enabled() rtos_internal_check_interrupts_enabled()
+#define precondition_interrupts_disabled() internal_assert(!irqs_enabled(), ERROR_ID_INTERNAL_PRECONDITION_VIOLATED)
+#define precondition_interrupts_enabled() internal_assert(irqs_enabled(), ERROR_ID_INTERNAL_PRECONDITION_VIOLATED)
+#define postcondition_interrupts_disabled() internal_assert(!irqs_enabled(), ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED)
+#define postcondition_interrupts_enabled() internal_assert(irqs_enabled(), ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED)
+#define interrupt_event_check() (interrupt_application_event_check() || interrupt_system_event_check())
+#define interrupt_system_event_check() false
+#define interrupt_event_get_next() rtos_internal_interrupt_event_get_next()
+#define assert_mutex_valid(mutex) api_assert(mutex < 1, ERROR_ID_INVALID_ID)
+#define api_error(error_id) do { } while(0)
+#define api_assert(expression, error_id) do { } while(0)
+
+#define internal_error(error_id) do { } while(0)
+#define internal_assert(expression, error_id) do { } while(0)
+#define get_current_task() current_task
+#define get_task_context(task_id) &tasks[task_id].ctx
+#define internal_assert_task_valid(task) internal_assert(task < 2, ERROR_ID_INTERNAL_INVALID_ID)
+#define assert_task_valid(task) api_assert(task < 2, ERROR_ID_INVALID_ID)
+#define interrupt_event_id_to_taskid(interrupt_event_id) ((RtosTaskId)(interrupt_event_id))
+
+
+static void
+context_init(context_t *const ctx, void (*const fn)(void), uint32_t *const stack_base, const size_t stack_size)
+{
+    uint32_t *const init_context = stack_base + stack_size - CONTEXT_HEADER_SIZE;
+    uint32_t *const context = init_context - CONTEXT_FRAME_SIZE;
+
+    /**
+     * Set up an initial stack frame header containing just the back chain word and the LR save word.
+     * The EABI specification requires that the back chain be NULL-terminated.
+     * We set the LR save word to the task entry point.
+     */
+    init_context[CONTEXT_BC_IDX] = 0;
+    init_context[CONTEXT_LR_IDX] = (uint32_t) fn;
+
+    /**
+     * Immediately below the dummy stack frame header, create a full-size stack frame containing register values for
+     * the initial context.
+     * The EABI spec requires that the back chain word always points to the previous frame's back chain word field.
+     * LR save and back chain words in this frame are ignored by rtos_internal_context_switch (ctxt-switch.s)
+     */
+    context[CONTEXT_BC_IDX] = (uint32_t) &init_context[CONTEXT_BC_IDX];
+    *ctx = context;
+}
+
+static void
+sched_set_runnable(const RtosTaskId task_id)
+{
+    SCHED_OBJ(task_id).runnable = true;
+}
+
+static void
+sched_set_blocked(const RtosTaskId task_id)
+{
+    SCHED_OBJ(task_id).runnable = false;
+}
+
+static TaskIdOption
+sched_get_next(void)
+{
+    TaskIdOption task;
+    SchedIndex next = sched_get_cur_index();
+    bool found = false;
+
+    do
+    {
+        next = sched_next_index(next);
+        found = sched_runnable(sched_index_to_taskid(next));
+    } while (
+        (!found)
+        && (next != (sched_get_cur_index()))
+        );
+
+    if (found)
+    {
+        task = sched_index_to_taskid(next);
+    }
+    else
+    {
+        next = sched_max_index();
+        task = TASK_ID_NONE;
+    }
+
+    sched_set_cur_index(next);
+
+    return task;
+}
+/* Clear the pending status for any outstanding interrupts and take the RTOS-defined action for each. */
+static void
+interrupt_event_process(void)
+{
+    uint32_t tmp;
+
+    /* Take and operate on a copy so we're guaranteed to return after handling each pending event no more than once,
+     * since an already-handled interrupt event may well arrive again during execution of the loop.
+     *
+     * If an interrupt comes in between the preempt_clear and the taking of the copy, it will be taken into account by
+     * the scheduling run but the pending preempt will force the scheduler to be run again, unnecessarily.
+     *
+     * This is somewhat a lesser evil than placing the preempt_clear after the taking of the copy, in which case an
+     * interrupt that comes in between may result in the scheduling invariant being violated, since the interrupt will
+     * not affect the current scheduling run, nor will it trigger a re-run of the scheduler.
+     *
+     * To prevent either case, we turn the two actions into a single atomic step by disabling interrupts. */
+#ifdef PREEMPTION_SUPPORT
+    interrupts_disable();
+    preempt_clear();
+    tmp = interrupt_event;
+    interrupts_enable();
+#else
+    tmp = interrupt_event;
+#endif
+    while (tmp != 0)
+    {
+        /* __builtin_ffs(x) returns 1 + the index of the least significant 1-bit in x, or returns zero if x is 0 */
+        const RtosInterruptEventId i = __builtin_ffs(tmp) - 1;
+        interrupt_event &= ~(1U << i);
+        interrupt_event_handle(i);
+        tmp &= ~(1U << i);
+    }
+}
+
+/* Check if there are any pending interrupt events, and if not, wait until an interrupt event has occurred. */
+static void
+interrupt_event_wait(void)
+{
+    interrupts_disable();
+    if (!interrupt_event_check())
+    {
+        interrupts_wait();
+    }
+    interrupts_enable();
+}
+RtosTaskId
+rtos_internal_interrupt_event_get_next(void)
+{
+    TaskIdOption next;
+
+    for (;;)
+    {
+        interrupt_event_process();
+        next = sched_get_next();
+
+        if (next == TASK_ID_NONE)
+        {
+            system_is_idle = true;
+            interrupt_event_wait();
+        }
+        else
+        {
+            system_is_idle = false;
+            break;
+        }
+    }
+
+    internal_assert_task_valid(next);
+
+    return next;
+}
+static bool
+internal_mutex_try_lock(const RtosMutexId m)
+{
+    if (mutexes[m].locked)
+    {
+        return false;
+    }
+    else
+    {
+        mutexes[m].locked = true;
+        return true;
+    }
+}
+
+static void
+interrupt_event_handle(const RtosInterruptEventId interrupt_event_id)
+{
+    sched_set_runnable(interrupt_event_id_to_taskid(interrupt_event_id));
+}
+
+
+
+
+
+/* Set the pending status for the given interrupt event id. */
+void
+rtos_interrupt_event_raise(const RtosInterruptEventId interrupt_event_id)
+{
+    interrupt_event |= (1U << interrupt_event_id);
+}
+
+void
+rtos_mutex_lock(const RtosMutexId m) RTOS_REENTRANT
+{
+    assert_mutex_valid(m);
+
+    preempt_disable();
+
+    while (!internal_mutex_try_lock(m))
+    {
+        rtos_yield();
+    }
+
+    preempt_enable();
+}
+
+void
+rtos_mutex_unlock(const RtosMutexId m)
+{
+    assert_mutex_valid(m);
+
+    /* Note: assumes writing a single word is atomic */
+    mutexes[m].locked = false;
+}
+
+bool
+rtos_mutex_try_lock(const RtosMutexId m)
+{
+    bool r;
+
+    assert_mutex_valid(m);
+
+    preempt_disable();
+    r = internal_mutex_try_lock(m);
+    preempt_enable();
+
+    return r;
+}
+
+RtosTaskId
+rtos_task_current(void)
+{
+    return get_current_task();
+}
+void
+rtos_yield_to(const RtosTaskId to) RTOS_REENTRANT
+{
+    const RtosTaskId from = get_current_task();
+    current_task = to;
+    context_switch(get_task_context(from), get_task_context(to));
+}
+
+void
+rtos_yield(void) RTOS_REENTRANT
+{
+    const RtosTaskId to = interrupt_event_get_next();
+    rtos_yield_to(to);
+}
+
+void
+rtos_block(void) RTOS_REENTRANT
+{
+    sched_set_blocked(get_current_task());
+    rtos_yield();
+}
+
+void
+rtos_unblock(const RtosTaskId task)
+{
+    sched_set_runnable(task);
+}
+
+void
+rtos_start(void)
+{
+    context_init(get_task_context(0), bench_main, stack_0, 8192);
+    context_init(get_task_context(1), bench_helper, stack_1, 8192);
+
+    context_switch_first(get_task_context(RTOS_TASK_ID_ZERO));
+}
@@ -0,0 +1,84 @@
+#ifndef RTOS_GATRIA_H
+#define RTOS_GATRIA_H
+
+
+
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+
+
+
+
+
+
+typedef uint8_t RtosMutexId;
+typedef uint8_t RtosErrorId;
+typedef uint8_t RtosTaskId;
+
+
+
+
+
+
+
+
+
+
+#define RTOS_REENTRANT 
+
+
+
+
+#define RTOS_MUTEX_ID_BENCH ((RtosMutexId) UINT8_C(0))
+
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(2 - 1))
+#define RTOS_TASK_ID_MAIN ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_HELPER ((RtosTaskId) UINT8_C(1))
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+
+
+void rtos_mutex_lock(RtosMutexId) RTOS_REENTRANT;
+bool rtos_mutex_try_lock(RtosMutexId);
+void rtos_mutex_unlock(RtosMutexId);
+
+RtosTaskId rtos_task_current(void);
+void rtos_yield_to(RtosTaskId) RTOS_REENTRANT;
+void rtos_yield(void) RTOS_REENTRANT;
+void rtos_block(void) RTOS_REENTRANT;
+void rtos_unblock(RtosTaskId);
+void rtos_start(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_GATRIA_H */
\ No newline at end of file
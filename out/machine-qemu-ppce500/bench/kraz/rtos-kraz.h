@@ -0,0 +1,106 @@
+#ifndef RTOS_KRAZ_H
+#define RTOS_KRAZ_H
+
+
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+
+
+
+
+
+
+typedef uint8_t RtosSignalSet;
+typedef RtosSignalSet RtosSignalId;
+typedef uint8_t RtosMutexId;
+typedef uint8_t RtosErrorId;
+typedef uint8_t RtosTaskId;
+
+
+
+
+
+
+
+
+
+
+
+#define RTOS_REENTRANT 
+
+
+
+
+#define RTOS_SIGNAL_SET_EMPTY ((RtosSignalSet) UINT8_C(0))
+#define RTOS_SIGNAL_SET_ALL ((RtosSignalSet) UINT8_MAX)
+#define RTOS_SIGNAL_SET_BENCH ((RtosSignalSet) UINT8_C(1))
+#define RTOS_SIGNAL_ID_BENCH ((RtosSignalId) RTOS_SIGNAL_SET_BENCH)
+#define RTOS_MUTEX_ID_BENCH ((RtosMutexId) UINT8_C(0))
+
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(2 - 1))
+#define RTOS_TASK_ID_MAIN ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_HELPER ((RtosTaskId) UINT8_C(1))
+
+
+
+
+
+
+#define rtos_signal_wait(requested_signal) \
+    (void) rtos_signal_wait_set(requested_signal)
+
+#define rtos_signal_poll(requested_signal) \
+    (rtos_signal_poll_set(requested_signal) != RTOS_SIGNAL_SET_EMPTY)
+
+#define rtos_signal_peek(requested_signal) \
+    (rtos_signal_peek_set(requested_signal) != RTOS_SIGNAL_SET_EMPTY)
+
+#define rtos_signal_send(task_id, signal) \
+    rtos_signal_send_set(task_id, signal)
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+
+
+RtosSignalSet rtos_signal_wait_set(RtosSignalSet requested_signals) RTOS_REENTRANT;
+RtosSignalSet rtos_signal_poll_set(RtosSignalSet requested_signals);
+RtosSignalSet rtos_signal_peek_set(RtosSignalSet requested_signals);
+void rtos_signal_send_set(RtosTaskId task_id, RtosSignalSet signals);
+void rtos_mutex_lock(RtosMutexId) RTOS_REENTRANT;
+bool rtos_mutex_try_lock(RtosMutexId);
+void rtos_mutex_unlock(RtosMutexId);
+
+RtosTaskId rtos_task_current(void);
+void rtos_yield(void) RTOS_REENTRANT;
+void rtos_start(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_KRAZ_H */
\ No newline at end of file
@@ -0,0 +1,1538 @@
+
+#include <stdint.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdbool.h>
+
+
+
+#include <stdint.h>
+#include <stdint.h>
+#include "rtos-phact.h"
+
+
+#define PREEMPTION_SUPPORT
+#define PREEMPT_RESTORE_DISABLED 1
+#define PREEMPT_RESTORE_VOLATILES 2
+
+/* The 'external interrupts enable' (EE) bit of the PowerPC e500 machine state register (MSR) */
+#define PPCE500_MSR_EE_SET 0x8000
+
+/*
+ * The unified stack frame structure used here both to preserve interrupted contexts and to implement context switch
+ * on RTOS variants that support task preemption by interrupts is defined in vectable.s, and all magic numbers used in
+ * this file should match the stack frame structure documented there.
+ */
+#define CONTEXT_BC_IDX 0
+#define CONTEXT_LR_IDX 1
+#define CONTEXT_HEADER_SIZE (CONTEXT_LR_IDX + 1)
+#define CONTEXT_INTERRUPTED_LR_IDX 2
+#define CONTEXT_SRR0_IDX 3
+#define CONTEXT_SRR1_IDX 4
+#define CONTEXT_XER_IDX 5
+#define CONTEXT_CTR_IDX 6
+#define CONTEXT_CR_IDX 7
+#define CONTEXT_GPR0_IDX 8
+#define CONTEXT_GPR3_IDX 9
+#define CONTEXT_GPR4_IDX 10
+#define CONTEXT_GPR5_IDX 11
+#define CONTEXT_GPR6_IDX 12
+#define CONTEXT_GPR7_IDX 13
+#define CONTEXT_GPR8_IDX 14
+#define CONTEXT_GPR9_IDX 15
+#define CONTEXT_GPR10_IDX 16
+#define CONTEXT_GPR11_IDX 17
+#define CONTEXT_GPR12_IDX 18
+#define CONTEXT_GPR14_IDX 19
+#define CONTEXT_GPR15_IDX 20
+#define CONTEXT_GPR16_IDX 21
+#define CONTEXT_GPR17_IDX 22
+#define CONTEXT_GPR18_IDX 23
+#define CONTEXT_GPR19_IDX 24
+#define CONTEXT_GPR20_IDX 25
+#define CONTEXT_GPR21_IDX 26
+#define CONTEXT_GPR22_IDX 27
+#define CONTEXT_GPR23_IDX 28
+#define CONTEXT_GPR24_IDX 29
+#define CONTEXT_GPR25_IDX 30
+#define CONTEXT_GPR26_IDX 31
+#define CONTEXT_GPR27_IDX 32
+#define CONTEXT_GPR28_IDX 33
+#define CONTEXT_GPR29_IDX 34
+#define CONTEXT_GPR30_IDX 35
+#define CONTEXT_GPR31_IDX 36
+#define CONTEXT_PREEMPT_RESTORE_STATUS 37
+#define CONTEXT_FRAME_SIZE (CONTEXT_PREEMPT_RESTORE_STATUS + 1)
+#define SCHED_INDEX_ZERO ((SchedIndex) UINT8_C(0))
+#define SCHED_INDEX_NONE ((SchedIndexOption) UINT8_MAX)
+
+
+#define TIMER_ID_ZERO ((RtosTimerId) UINT8_C(0))
+#define TIMER_ID_MAX ((RtosTimerId) UINT8_C(10 - 1U))
+
+
+
+#define MUTEX_ID_NONE ((MutexIdOption) UINT8_MAX)
+#define SEM_ID_NONE ((SemIdOption) UINT8_MAX)
+#define SEM_VALUE_ZERO ((RtosSemValue) UINT8_C(0))
+#define ERROR_ID_NONE ((RtosErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW ((RtosErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID ((RtosErrorId) UINT8_C(2))
+#define ERROR_ID_NOT_HOLDING_MUTEX ((RtosErrorId) UINT8_C(3))
+#define ERROR_ID_DEADLOCK ((RtosErrorId) UINT8_C(4))
+#define ERROR_ID_TASK_FUNCTION_RETURNS ((RtosErrorId) UINT8_C(5))
+#define ERROR_ID_INTERNAL_CURRENT_TASK_INVALID ((RtosErrorId) UINT8_C(6))
+#define ERROR_ID_INTERNAL_INVALID_ID ((RtosErrorId) UINT8_C(7))
+#define ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP ((RtosErrorId) UINT8_C(8))
+#define ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(9))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(10))
+#define ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER ((RtosErrorId) UINT8_C(11))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW ((RtosErrorId) UINT8_C(12))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION ((RtosErrorId) UINT8_C(13))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_CONFIGURATION ((RtosErrorId) UINT8_C(14))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_HEAD ((RtosErrorId) UINT8_C(15))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE ((RtosErrorId) UINT8_C(16))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_ID_IN_WAITERS ((RtosErrorId) UINT8_C(17))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TASKS_BLOCKED_DESPITE_AVAILABLE_MESSAGES ((RtosErrorId) UINT8_C(18))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_WAITING_TASK_IS_NOT_BLOCKED ((RtosErrorId) UINT8_C(19))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGES_POINTER ((RtosErrorId) UINT8_C(20))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGE_SIZE ((RtosErrorId) UINT8_C(21))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH ((RtosErrorId) UINT8_C(22))
+#define ERROR_ID_INTERNAL_PRECONDITION_VIOLATED ((RtosErrorId) UINT8_C(23))
+#define ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED ((RtosErrorId) UINT8_C(24))
+#define ERROR_ID_SEMAPHORE_MAX_INVALID ((RtosErrorId) UINT8_C(25))
+#define ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT ((RtosErrorId) UINT8_C(26))
+#define ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT ((RtosErrorId) UINT8_C(27))
+#define ERROR_ID_SEMAPHORE_MAX_EXCEEDED ((RtosErrorId) UINT8_C(28))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED ((RtosErrorId) UINT8_C(29))
+#define ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX ((RtosErrorId) UINT8_C(30))
+#define ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED ((RtosErrorId) UINT8_C(31))
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+#define current_task rtos_internal_current_task
+#define tasks rtos_internal_tasks
+
+typedef uint32_t* context_t;
+typedef uint8_t SchedIndex;
+typedef uint16_t TicksTimeout;
+typedef RtosMutexId MutexIdOption;
+typedef RtosSemId SemIdOption;
+typedef RtosTaskId TaskIdOption;
+typedef SchedIndex SchedIndexOption;
+
+
+
+/*
+ * The 'locked_by' field can take the following values:
+ * locked_by == SCHED_INDEX_NONE indicates this entry is either a mutex that is not locked, or a task that is blocked.
+ * locked_by == (the 'sched_queue' index of this entry) indicates this entry is a task that is runnable.
+ * Else this entry is a locked mutex, with locked_by indicating the 'sched_queue' index of the task holding it.
+ */
+struct sched_entry {
+    SchedIndexOption locked_by;
+};
+
+/*
+ * A RTOS variant using the priority-ceiling protocol scheduler must ensure that the 'sched_queue' array (whose
+ * entries represent mutexes and tasks) is sorted by descending priority.
+ */
+struct sched {
+    struct sched_entry entries[3];
+};
+struct signal_task {
+    RtosSignalSet signals;
+};
+
+struct signal {
+    struct signal_task tasks[2];
+};
+
+struct timer
+{
+    bool enabled;
+    bool overflow;
+    TicksTimeout expiry;
+    RtosTicksRelative reload;
+
+    /*
+     * when error_id is not ERROR_ID_NONE, the timer calls
+     * the application error function with this error_id.
+     */
+    RtosErrorId error_id;
+
+    RtosTaskId task_id;
+    RtosSignalSet signal_set;
+};
+
+
+struct interrupt_event_handler {
+    RtosTaskId task;
+    RtosSignalSet sig_set;
+};
+
+struct mutex {
+    TaskIdOption holder;
+};
+struct semaphore {
+    RtosSemValue value;
+};
+
+struct task
+{
+    context_t ctx;
+};
+
+
+
+extern void rtos_internal_yield_syscall(RtosTaskId to, bool return_with_preempt_disabled);
+extern void rtos_internal_restore_preempted_context(bool restore_volatiles, context_t ctxt_to);
+
+
+
+
+extern void rtos_internal_interrupts_disable(void);
+extern void rtos_internal_interrupts_enable(void);
+extern void rtos_internal_interrupts_wait(void);
+extern bool rtos_internal_check_interrupts_enabled(void);
+
+
+
+
+extern void fatal(RtosErrorId error_id);
+extern void bench_helper(void);
+extern void bench_main(void);
+extern void bench_helper(void);
+extern void bench_main(void);
+
+
+/**
+ * Common helper for context-switching due to an internal yield or preempt_enable.
+ *
+ * @param return_with_preempt_disabled A bool indicating whether this function should return with preemption disabled.
+ */
+static void yield_common(bool return_with_preempt_disabled);
+
+/**
+ * Trigger a context-switch to the next task runnable as determined by the scheduler.
+ * Intended to be used by the RTOS internally after taking actions that change the set of schedulable tasks.
+ */
+static void yield(void);
+
+/**
+ * Enable preemption, and in doing so, cause any pending preemption to happen immediately.
+ */
+static void preempt_enable(void);
+
+/**
+ * Invoke the scheduler repeatedly until no preemptions are pending, to determine which task should currently be
+ * running.
+ * Each scheduler invocation occurs with interrupts enabled, during which time new preemptions can become pending.
+ *
+ * @return The identifier of the task that should currently be running.
+ */
+static RtosTaskId preempt_irq_invoke_scheduler(void);
+
+/**
+ * Modify preemption state and invoke the scheduler to determine if preemption is necessary.
+ *
+ * @return The identifier of the task to switch to, or TASK_ID_NONE if no context switch is necessary.
+ */
+RtosTaskId rtos_internal_preempt_irq_scheduler_wrapper(void);
+
+/**
+ * Context switch from one task to another.
+ * Does not return.
+ *
+ * @param to The identifier of the task to switch to.
+ * @param ctxt The partially constructed context of the task to be switched away from.
+ * @param restore_preempt_disabled A boolean indicating whether the task we are switching away from should be restored
+ *  with preemption disabled.
+ * @param restore_volatiles A boolean indicating whether the task we are switching away from needs to have its
+ *  volatile registers restored from the stored context.
+ */
+void rtos_internal_context_switch(RtosTaskId to, context_t ctxt, bool restore_preempt_disabled,
+        bool restore_volatiles);
+
+/**
+ * Initial context switch to a task.
+ * Does not return.
+ *
+ * @param to The identifier of the task to switch to.
+ */
+static void context_switch_first(RtosTaskId to);
+
+/**
+ * Set up the initial execution context of a task.
+ * This function is invoked exactly once for each task in the system.
+ *
+ * @param ctx An output parameter interpreted by the RTOS as the initial context for each task.
+ *  After this function returns, the RTOS uses the value of ctx for task/context/stack switching.
+ *  The context must be set up such that the destination task of a task switch executes the code at the address fn
+ *  using the memory region defined by stack_base and stack_size as its stack.
+ * @param fn Points to a code address at which the given execution context shall start executing.
+ *  This is typically a pointer to a parameter-less function that is assumed to never return.
+ * @param stack_base Points to the lowest address of the memory area this execution context shall use as a stack.
+ * @param stack_size The size in bytes of the stack memory area reserved for this execution context.
+ */
+static void context_init(context_t *ctx, void (*fn)(void), uint32_t *stack_base, size_t stack_size);
+static void sched_set_runnable(RtosTaskId task_id);
+static void sched_set_blocked(RtosTaskId task_id);
+static void sched_set_mutex_locked_by(RtosMutexId mutex_id, RtosTaskId task_id);
+static void sched_set_mutex_unlocked(RtosMutexId mutex_id);
+static TaskIdOption sched_get_next(void);
+static RtosSignalSet signal_recv(RtosSignalSet *pending_signals, RtosSignalSet requested_signals);
+static void signal_send_set(RtosTaskId task_id, RtosSignalSet signals);
+static RtosSignalSet signal_wait_set(RtosSignalSet requested_signals) RTOS_REENTRANT;
+
+static uint8_t timer_pending_ticks_get_and_clear_atomically(void);
+static void timer_process_one(struct timer *timer);
+static void timer_enable(RtosTimerId timer_id);
+static void timer_oneshot(RtosTimerId timer_id, RtosTicksRelative timeout);
+static void timer_tick_process(void);
+static void interrupt_event_process(void);
+static void interrupt_event_wait(void);
+RtosTaskId rtos_internal_interrupt_event_get_next(void);
+static void interrupt_event_handle(RtosInterruptEventId interrupt_event_id);
+
+static bool internal_sem_try_wait(const RtosSemId s);
+
+static void block();
+static void unblock(RtosTaskId task);
+static void mutex_core_locked_by(RtosMutexId mutex, RtosTaskId task);
+static void mutex_core_unlocked(RtosMutexId mutex);
+
+/*
+ * PowerPC EABI stack is 8-byte aligned.
+ * See ppce500-context-switch.c
+ */
+static uint32_t stack_0[8192] __attribute__((aligned(8)));
+static uint32_t stack_1[8192] __attribute__((aligned(8)));
+static volatile bool preempt_disabled = true;
+static volatile bool preempt_pending;
+static struct sched sched_queue = {
+    {
+        {SCHED_INDEX_NONE},
+        {SCHED_INDEX_NONE},
+        {SCHED_INDEX_NONE},
+    }
+};
+
+static const SchedIndex mutex_to_index[1] = {
+    1,
+};
+
+static const SchedIndex task_to_index[2] = {
+    0,
+    2,
+};
+
+static const SchedIndex index_to_mutex_task[3] = {
+    0,
+    0,
+    1,
+};
+static struct signal signal_tasks;
+static volatile uint8_t timer_pending_ticks;
+RtosTicksAbsolute rtos_timer_current_ticks;
+static struct timer timers[10] = {
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        0,
+        0,
+        RTOS_TASK_ID_HELPER,
+        RTOS_SIGNAL_SET__TASK_TIMER
+    },
+    {
+        false,
+        false,
+        0,
+        0,
+        0,
+        RTOS_TASK_ID_MAIN,
+        RTOS_SIGNAL_SET__TASK_TIMER
+    },
+};
+static volatile uint32_t interrupt_event;
+static bool system_is_idle;
+struct interrupt_event_handler interrupt_events[1] = {
+    { RTOS_TASK_ID_HELPER, RTOS_SIGNAL_SET_BENCH },
+};
+static struct mutex mutexes[1] = {
+    {TASK_ID_NONE},
+};
+static MutexIdOption mutex_waiters[2] = {
+    MUTEX_ID_NONE,
+    MUTEX_ID_NONE,
+};
+static struct semaphore semaphores[2];
+static SemIdOption sem_waiters[2];
+
+RtosTaskId rtos_internal_current_task;
+struct task rtos_internal_tasks[2];
+static RtosTimerId task_timers[2] = {
+    RTOS_TIMER_ID__TASK_HELPER,
+    RTOS_TIMER_ID__TASK_MAIN,
+};
+
+
+#define preempt_init()
+#define preempt_disable() preempt_disabled = true
+#define preempt_pend() preempt_pending = true
+#define preempt_clear() preempt_pending = false
+#define precondition_preemption_disabled() internal_assert(preempt_disabled, ERROR_ID_INTERNAL_PRECONDITION_VIOLATED)
+#define postcondition_preemption_disabled() internal_assert(preempt_disabled, ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED)
+#define postcondition_preemption_enabled() internal_assert(!preempt_disabled, ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED)
+#define postcondition_conditional_preempt_disabled(cond, target) \
+        if (cond) { \
+            internal_assert(preempt_disabled == target, ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED); \
+        } else { \
+            postcondition_preemption_disabled(); \
+        }
+#define sched_runnable(task_id) (SCHED_OBJ_TASK(task_id).runnable)
+#define sched_max_index() (SchedIndex)(3 - 1U)
+#define sched_index_to_taskid(sched_index) (RtosTaskId)(index_to_mutex_task[sched_index])
+#define sched_taskid_to_index(task_id) (SchedIndex)(task_to_index[task_id])
+#define SCHED_OBJ(idx) sched_queue.entries[idx]
+#define SCHED_OBJ_TASK(task_id) sched_queue.entries[sched_taskid_to_index(task_id)]
+#define sched_index_to_mutexid(sched_index) (RtosMutexId)(index_to_mutex_task[sched_index])
+#define sched_mutexid_to_index(mutex_id) (SchedIndex)(mutex_to_index[mutex_id])
+#define SCHED_OBJ_MUTEX(mutex_id) sched_queue.entries[sched_mutexid_to_index(mutex_id)]
+
+#define signal_wait(requested_signals) signal_wait_set(requested_signals)
+#define signal_peek(pending_signals, requested_signals) (((pending_signals) & (requested_signals)) != RTOS_SIGNAL_SET_EMPTY)
+#define signal_pending(task_id, mask) ((PENDING_SIGNALS(task_id) & mask) == mask)
+#define PENDING_SIGNALS(task_id) signal_tasks.tasks[task_id].signals
+#define timer_pending_ticks_check() ((bool)timer_pending_ticks)
+#define timer_expired(timer, timeout) ((timer)->enabled && (timer)->expiry == timeout)
+#define timer_is_periodic(timer) ((timer)->reload > 0)
+#define timer_reload_set(timer_id, ticks) timers[timer_id].reload = ticks
+#define timer_disable(timer_id) timers[timer_id].enabled = false
+#define current_timeout() ((TicksTimeout) rtos_timer_current_ticks)
+#define TIMER_PTR(timer_id) (&timers[timer_id])
+#define assert_timer_valid(timer) api_assert(timer_id < 10, ERROR_ID_INVALID_ID)
+/* Return true if there are any pending interrupts, false otherwise. */
+#define interrupt_application_event_check() (interrupt_event != 0)
+#define interrupts_disable() rtos_internal_interrupts_disable()
+#define interrupts_enable() rtos_internal_interrupts_enable()
+#define interrupts_wait() rtos_internal_interrupts_wait()
+#define irqs_enabled() rtos_internal_check_interrupts_enabled()
+#define precondition_interrupts_disabled() internal_assert(!irqs_enabled(), ERROR_ID_INTERNAL_PRECONDITION_VIOLATED)
+#define precondition_interrupts_enabled() internal_assert(irqs_enabled(), ERROR_ID_INTERNAL_PRECONDITION_VIOLATED)
+#define postcondition_interrupts_disabled() internal_assert(!irqs_enabled(), ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED)
+#define postcondition_interrupts_enabled() internal_assert(irqs_enabled(), ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED)
+#define interrupt_event_check() (interrupt_application_event_check() || interrupt_system_event_check())
+#define interrupt_system_event_check() timer_pending_ticks_check()
+#define interrupt_event_get_next() rtos_internal_interrupt_event_get_next()
+
+#define assert_mutex_valid(mutex) api_assert(mutex < 1, ERROR_ID_INVALID_ID)
+#define assert_sem_valid(sem) api_assert(sem < 2, ERROR_ID_INVALID_ID)
+#define api_error(error_id) do { } while(0)
+#define api_assert(expression, error_id) do { } while(0)
+
+#define internal_error(error_id) do { } while(0)
+#define internal_assert(expression, error_id) do { } while(0)
+#define get_current_task() current_task
+#define get_task_context(task_id) &tasks[task_id].ctx
+#define internal_assert_task_valid(task) internal_assert(task < 2, ERROR_ID_INTERNAL_INVALID_ID)
+#define assert_task_valid(task) api_assert(task < 2, ERROR_ID_INVALID_ID)
+#define mutex_core_block_on(blocker) signal_wait(RTOS_SIGNAL_ID__TASK_TIMER)
+#define mutex_core_unblock(task) signal_send_set(task, RTOS_SIGNAL_ID__TASK_TIMER)
+#define sem_core_block() signal_wait(RTOS_SIGNAL_ID__TASK_TIMER)
+#define sem_core_unblock(task) signal_send_set(task, RTOS_SIGNAL_ID__TASK_TIMER)
+
+
+static void
+yield_common(const bool return_with_preempt_disabled)
+{
+    precondition_interrupts_enabled();
+    precondition_preemption_disabled();
+
+    {
+        const RtosTaskId from = get_current_task();
+        /* The scheduler invocation returns with interrupts disabled.
+         * This is to ensure that no interrupts come in and change the scheduler state between this call and the
+         * context switch, or at least, the reenabling of preemption. */
+        const RtosTaskId to = preempt_irq_invoke_scheduler();
+
+        if (from != to) {
+            rtos_internal_yield_syscall(to, return_with_preempt_disabled);
+        } else {
+            preempt_disabled = return_with_preempt_disabled;
+        }
+
+        interrupts_enable();
+    }
+
+    postcondition_conditional_preempt_disabled(true, return_with_preempt_disabled);
+    postcondition_interrupts_enabled();
+}
+
+static void
+yield(void)
+{
+    precondition_preemption_disabled();
+
+    yield_common(true);
+
+    postcondition_preemption_disabled();
+}
+
+/* Enabling preemption means checking immediately if a preemption needs to occur, because simply continuing to run the
+ * current task would violate the scheduler requirement if a higher-priority task is meant to preempt it. */
+static void
+preempt_enable(void)
+{
+    precondition_interrupts_enabled();
+    precondition_preemption_disabled();
+
+    /* Avoid invoking the scheduler if there's no preemption pending */
+    interrupts_disable();
+    if (preempt_pending) {
+        interrupts_enable();
+        yield_common(false);
+    } else {
+        preempt_disabled = false;
+        interrupts_enable();
+    }
+
+    postcondition_preemption_enabled();
+    postcondition_interrupts_enabled();
+}
+
+static RtosTaskId
+preempt_irq_invoke_scheduler(void)
+{
+    RtosTaskId next;
+
+    /* Precondition: interrupts are allowed to be either enabled or disabled */
+    precondition_preemption_disabled();
+
+    /* While interrupts are enabled in the following do-loop, another interrupt may set preempt_pending back to true,
+     * but the precondition that preemption is disabled ensures we don't get runaway interrupt recursion. */
+    do {
+        interrupts_enable();
+
+        /* this unsets preempt_pending */
+        next = interrupt_event_get_next();
+
+        interrupts_disable();
+    } while (preempt_pending);
+
+    postcondition_preemption_disabled();
+    postcondition_interrupts_disabled();
+
+    return next;
+}
+
+#if (8 != 8)
+#error "Assembly implementation assumes a taskid_size of 8. See vectable.s"
+#endif
+/* This function, called directly from the common assembly code for preemption-supporting interrupts (see vectable.s),
+ * is responsible for modifying preemption state, and invoking the scheduler to determine if preemption is necessary.
+ * It returns the TaskId of the task to switch to, or TASK_ID_NONE if no context switch is required.
+ * It is NOT responsible for setting current_task = to!
+ * Note also that although we impose a pre and postcondition that interrupts are disabled, the call to
+ * preempt_irq_invoke_scheduler will enable interrupts one or more times during its execution. */
+RtosTaskId
+rtos_internal_preempt_irq_scheduler_wrapper(void)
+{
+    RtosTaskId to = TASK_ID_NONE;
+
+    precondition_interrupts_disabled();
+    {
+        /* Precondition: preemption is allowed to be either enabled or disabled */
+        const bool initial_preempt_disabled = preempt_disabled;
+
+        preempt_pending = true;
+
+        if (preempt_disabled) {
+            goto end;
+        }
+
+        preempt_disabled = true;
+
+        to = preempt_irq_invoke_scheduler();
+        if (to == get_current_task()) {
+            to = TASK_ID_NONE;
+            preempt_disabled = initial_preempt_disabled;
+        }
+end:
+        postcondition_conditional_preempt_disabled(to == TASK_ID_NONE, initial_preempt_disabled);
+    }
+    postcondition_interrupts_disabled();
+
+    return to;
+}
+
+/* This context switch routine is invoked directly from the assembly wrappers for preemption-supporting interrupt
+ * vector code (see vectable.s).
+ * At the end it jumps directly to context_switch_first which implements its 2nd half, and never returns. */
+void
+rtos_internal_context_switch(const RtosTaskId to, const context_t ctxt, const bool restore_preempt_disabled,
+        const bool restore_volatiles)
+{
+    precondition_interrupts_disabled();
+    precondition_preemption_disabled();
+    {
+        context_t *const ctxt_from = get_task_context(get_current_task());
+        uint32_t preempt_status = 0;
+
+        if (restore_preempt_disabled) {
+            preempt_status |= PREEMPT_RESTORE_DISABLED;
+        }
+
+        if (restore_volatiles) {
+            preempt_status |= PREEMPT_RESTORE_VOLATILES;
+        }
+
+        ctxt[CONTEXT_PREEMPT_RESTORE_STATUS] = preempt_status;
+
+        /* Commit the constructed stack frame of the outgoing task */
+        *ctxt_from = ctxt;
+    }
+
+    /* This never returns */
+    context_switch_first(to);
+}
+
+/* This is used by the RTOS start function to start the very first task, but is also identical with the latter half of
+ * the context switch process.
+ * At the end it jumps directly to task context restoration assembly routines (see vectable.s), and never returns. */
+static void
+context_switch_first(const RtosTaskId to)
+{
+    precondition_interrupts_disabled();
+    precondition_preemption_disabled();
+    {
+        const context_t ctxt_to = *(get_task_context(to));
+        bool restore_volatiles;
+
+        /* Set the current task id to the incoming one */
+        current_task = to;
+
+        if (!(ctxt_to[CONTEXT_PREEMPT_RESTORE_STATUS] & PREEMPT_RESTORE_DISABLED)) {
+            /* only need the enable case because we entered with preemption disabled */
+            preempt_disabled = false;
+        }
+
+        restore_volatiles = (ctxt_to[CONTEXT_PREEMPT_RESTORE_STATUS] & PREEMPT_RESTORE_VOLATILES);
+
+        /* This never returns */
+        rtos_internal_restore_preempted_context(restore_volatiles, ctxt_to);
+    }
+}
+
+static void
+context_init(context_t *const ctx, void (*const fn)(void), uint32_t *const stack_base, const size_t stack_size)
+{
+    uint32_t *const init_context = stack_base + stack_size - CONTEXT_HEADER_SIZE;
+    uint32_t *const context = init_context - CONTEXT_FRAME_SIZE;
+    uint32_t current_msr;
+
+    /**
+     * Set up an initial stack frame header containing just the back chain word and the LR save word.
+     * The EABI specification requires that the back chain be NULL-terminated.
+     */
+    init_context[CONTEXT_BC_IDX] = 0;
+
+    /**
+     * Immediately below the initial stack frame header, create a full-size stack frame containing register values for
+     * the initial context.
+     * The EABI spec requires that the back chain word always points to the previous frame's back chain word field.
+     */
+    /* Set SRR0 to the task entry point */
+    context[CONTEXT_SRR0_IDX] = (uint32_t) fn;
+    /* Set MSR[EE] = 1 (interrupts enabled) initially for all tasks */
+    asm volatile("mfmsr %0":"=r"(current_msr)::);
+    context[CONTEXT_SRR1_IDX] = current_msr | PPCE500_MSR_EE_SET;
+    context[CONTEXT_PREEMPT_RESTORE_STATUS] = PREEMPT_RESTORE_DISABLED | PREEMPT_RESTORE_VOLATILES;
+    context[CONTEXT_BC_IDX] = (uint32_t) &init_context[CONTEXT_BC_IDX];
+    *ctx = context;
+}
+static void
+sched_set_runnable(const RtosTaskId task_id)
+{
+    SCHED_OBJ_TASK(task_id).locked_by = sched_taskid_to_index(task_id);
+}
+
+static void
+sched_set_blocked(const RtosTaskId task_id)
+{
+    SCHED_OBJ_TASK(task_id).locked_by = SCHED_INDEX_NONE;
+}
+
+static void
+sched_set_mutex_locked_by(const RtosMutexId mutex_id, const RtosTaskId task_id)
+{
+    internal_assert(SCHED_OBJ_MUTEX(mutex_id).locked_by == SCHED_INDEX_NONE,
+            ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED);
+    /* Lower array indices correspond to higher priorities */
+    internal_assert(sched_mutexid_to_index(mutex_id) < sched_taskid_to_index(task_id),
+            ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX);
+    SCHED_OBJ_MUTEX(mutex_id).locked_by = sched_taskid_to_index(task_id);
+}
+
+static void
+sched_set_mutex_unlocked(const RtosMutexId mutex_id)
+{
+    SCHED_OBJ_MUTEX(mutex_id).locked_by = SCHED_INDEX_NONE;
+}
+
+static TaskIdOption
+sched_get_next(void)
+{
+    /*
+     * In the case where assume_runnable is true and no runnable tasks are found, then an undefined task will be
+     * returned from this function.
+     */
+    SchedIndexOption sched_idx, next_idx;
+    SchedIndex idx;
+
+    for (idx = SCHED_INDEX_ZERO; idx <= sched_max_index(); idx++) {
+        sched_idx = idx;
+
+        next_idx = SCHED_OBJ(sched_idx).locked_by;
+        if (next_idx == SCHED_INDEX_NONE) {
+            /* An unlocked mutex, or a non-runnable task */
+            continue;
+        } else if (next_idx == sched_idx) {
+            /* A runnable task */
+            break;
+        } else if (SCHED_OBJ(next_idx).locked_by == next_idx) {
+            /* A mutex locked by a runnable task */
+            sched_idx = next_idx;
+            break;
+        }
+    }
+
+    return (TaskIdOption) sched_index_to_taskid(sched_idx);
+}
+static RtosSignalSet
+signal_recv(RtosSignalSet *const pending_signals, const RtosSignalSet requested_signals)
+{
+    const RtosSignalSet received_signals = *pending_signals & requested_signals;
+
+    precondition_preemption_disabled();
+
+    *pending_signals &= ~received_signals;
+
+    postcondition_preemption_disabled();
+
+    return received_signals;
+}
+
+static void
+signal_send_set(const RtosTaskId task_id, const RtosSignalSet signals)
+{
+    precondition_preemption_disabled();
+
+    PENDING_SIGNALS(task_id) |= signals;
+    unblock(task_id);
+
+    postcondition_preemption_disabled();
+}
+
+static RtosSignalSet
+signal_wait_set(const RtosSignalSet requested_signals) RTOS_REENTRANT
+{
+    RtosSignalSet received_signals;
+
+    precondition_preemption_disabled();
+    {
+        RtosSignalSet *const pending_signals = &PENDING_SIGNALS(get_current_task());
+
+        if (signal_peek(*pending_signals, requested_signals))
+        {
+            yield();
+        }
+        else
+        {
+            do
+            {
+                block();
+            } while (!signal_peek(*pending_signals, requested_signals));
+        }
+
+        received_signals = signal_recv(pending_signals, requested_signals);
+    }
+    postcondition_preemption_disabled();
+
+    return received_signals;
+}
+static uint8_t
+timer_pending_ticks_get_and_clear_atomically(void)
+{
+    uint8_t pending_ticks;
+
+    interrupts_disable();
+
+    pending_ticks = timer_pending_ticks;
+    timer_pending_ticks = 0;
+
+    interrupts_enable();
+
+    return pending_ticks;
+}
+static void
+timer_process_one(struct timer *const timer)
+{
+    precondition_preemption_disabled();
+
+    if (timer_is_periodic(timer))
+    {
+        timer->expiry += timer->reload;
+    }
+    else
+    {
+        timer->enabled = false;
+    }
+
+    if (timer->error_id != ERROR_ID_NONE)
+    {
+        fatal(timer->error_id);
+    }
+    else
+    {
+        if (signal_pending(timer->task_id, timer->signal_set))
+        {
+            timer->overflow = true;
+        }
+        signal_send_set(timer->task_id, timer->signal_set);
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_enable(const RtosTimerId timer_id)
+{
+    precondition_preemption_disabled();
+
+    if (timers[timer_id].reload == 0)
+    {
+        timer_process_one(&timers[timer_id]);
+    }
+    else
+    {
+        timers[timer_id].expiry = current_timeout() + timers[timer_id].reload;
+        timers[timer_id].enabled = true;
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_oneshot(const RtosTimerId timer_id, const RtosTicksRelative timeout)
+{
+    precondition_preemption_disabled();
+
+    timer_reload_set(timer_id, timeout);
+    timer_enable(timer_id);
+    timer_reload_set(timer_id, 0);
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_tick_process(void)
+{
+    precondition_preemption_disabled();
+    {
+        const uint8_t pending_ticks = timer_pending_ticks_get_and_clear_atomically();
+
+        if (pending_ticks > 1)
+        {
+            fatal(ERROR_ID_TICK_OVERFLOW);
+        }
+
+        if (pending_ticks)
+        {
+            RtosTimerId timer_id;
+            struct timer *timer;
+            TicksTimeout timeout;
+
+            rtos_timer_current_ticks++;
+
+            timeout = current_timeout();
+
+            for (timer_id = TIMER_ID_ZERO; timer_id <= TIMER_ID_MAX; timer_id++)
+            {
+                timer = TIMER_PTR(timer_id);
+                if (timer_expired(timer, timeout))
+                {
+                    timer_process_one(timer);
+                }
+            }
+        }
+    }
+    postcondition_preemption_disabled();
+}
+/* Clear the pending status for any outstanding interrupts and take the RTOS-defined action for each. */
+static void
+interrupt_event_process(void)
+{
+    uint32_t tmp;
+
+    /* Take and operate on a copy so we're guaranteed to return after handling each pending event no more than once,
+     * since an already-handled interrupt event may well arrive again during execution of the loop.
+     *
+     * If an interrupt comes in between the preempt_clear and the taking of the copy, it will be taken into account by
+     * the scheduling run but the pending preempt will force the scheduler to be run again, unnecessarily.
+     *
+     * This is somewhat a lesser evil than placing the preempt_clear after the taking of the copy, in which case an
+     * interrupt that comes in between may result in the scheduling invariant being violated, since the interrupt will
+     * not affect the current scheduling run, nor will it trigger a re-run of the scheduler.
+     *
+     * To prevent either case, we turn the two actions into a single atomic step by disabling interrupts. */
+#ifdef PREEMPTION_SUPPORT
+    interrupts_disable();
+    preempt_clear();
+    tmp = interrupt_event;
+    interrupts_enable();
+#else
+    tmp = interrupt_event;
+#endif
+    while (tmp != 0)
+    {
+        /* __builtin_ffs(x) returns 1 + the index of the least significant 1-bit in x, or returns zero if x is 0 */
+        const RtosInterruptEventId i = __builtin_ffs(tmp) - 1;
+        interrupt_event &= ~(1U << i);
+        interrupt_event_handle(i);
+        tmp &= ~(1U << i);
+    }
+}
+
+/* Check if there are any pending interrupt events, and if not, wait until an interrupt event has occurred. */
+static void
+interrupt_event_wait(void)
+{
+    interrupts_disable();
+    if (!interrupt_event_check())
+    {
+        interrupts_wait();
+    }
+    interrupts_enable();
+}
+RtosTaskId
+rtos_internal_interrupt_event_get_next(void)
+{
+    TaskIdOption next;
+
+    for (;;)
+    {
+        interrupt_event_process();
+        timer_tick_process();
+        next = sched_get_next();
+
+        if (next == TASK_ID_NONE)
+        {
+            system_is_idle = true;
+            interrupt_event_wait();
+        }
+        else
+        {
+            system_is_idle = false;
+            break;
+        }
+    }
+
+    internal_assert_task_valid(next);
+
+    return next;
+}
+static void
+interrupt_event_handle(const RtosInterruptEventId interrupt_event_id)
+{
+    precondition_preemption_disabled();
+
+    internal_assert(interrupt_event_id < 1, ERROR_ID_INTERNAL_INVALID_ID);
+
+#ifdef PREEMPTION_SUPPORT
+    signal_send_set(interrupt_events[interrupt_event_id].task, interrupt_events[interrupt_event_id].sig_set);
+#else
+    rtos_signal_send_set(interrupt_events[interrupt_event_id].task,
+            interrupt_events[interrupt_event_id].sig_set);
+#endif
+
+    postcondition_preemption_disabled();
+}
+static bool
+mutex_try_lock(const RtosMutexId m)
+{
+    const bool r = mutexes[m].holder == TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    if (r)
+    {
+        mutexes[m].holder = get_current_task();
+        mutex_core_locked_by(m, get_current_task());
+    }
+
+    postcondition_preemption_disabled();
+
+    return r;
+}
+static void
+sem_init(void)
+{
+    RtosTaskId t;
+
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        sem_waiters[t] = SEM_ID_NONE;
+    }
+}
+
+static bool
+internal_sem_try_wait(const RtosSemId s)
+{
+    precondition_preemption_disabled();
+
+    if (semaphores[s].value == SEM_VALUE_ZERO)
+    {
+        return false;
+    }
+    else
+    {
+        semaphores[s].value--;
+        return true;
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+entry_helper(void)
+{
+    precondition_preemption_disabled();
+
+    preempt_enable();
+    bench_helper();
+}
+static void
+entry_main(void)
+{
+    precondition_preemption_disabled();
+
+    preempt_enable();
+    bench_main();
+}
+
+static void
+block(void)
+{
+    precondition_preemption_disabled();
+
+    sched_set_blocked(get_current_task());
+    yield();
+
+    postcondition_preemption_disabled();
+}
+
+static void
+mutex_core_block_on_timeout(const RtosTaskId t, const RtosTicksRelative ticks)
+{
+    precondition_preemption_disabled();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    mutex_core_block_on(t);
+    timer_disable(task_timers[get_current_task()]);
+
+    postcondition_preemption_disabled();
+}
+
+static void
+sem_core_block_timeout(const RtosTicksRelative ticks)
+{
+    precondition_preemption_disabled();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    sem_core_block();
+    timer_disable(task_timers[get_current_task()]);
+
+    postcondition_preemption_disabled();
+}
+
+static void
+unblock(const RtosTaskId task)
+{
+    precondition_preemption_disabled();
+
+    sched_set_runnable(task);
+
+    /* Yield when we later re-enable preemption, because we may have set a higher priority task runnable. */
+    preempt_pend();
+
+    postcondition_preemption_disabled();
+}
+
+static void
+mutex_core_locked_by(const RtosMutexId mutex, const RtosTaskId task)
+{
+    precondition_preemption_disabled();
+
+    sched_set_mutex_locked_by(mutex, task);
+
+    postcondition_preemption_disabled();
+}
+
+static void
+mutex_core_unlocked(const RtosMutexId mutex)
+{
+    precondition_preemption_disabled();
+
+    sched_set_mutex_unlocked(mutex);
+
+    /* Yield when we later re-enable preemption, because this task will have reverted from the mutex's priority
+     * ceiling back to its original (and necessarily lower) explicitly assigned priority. */
+    preempt_pend();
+
+    postcondition_preemption_disabled();
+}
+
+
+
+
+RtosSignalSet
+rtos_signal_wait_set(const RtosSignalSet requested_signals) RTOS_REENTRANT
+{
+    RtosSignalSet received_signals;
+
+    preempt_disable();
+
+    received_signals = signal_wait_set(requested_signals);
+
+    preempt_enable();
+
+    return received_signals;
+}
+
+RtosSignalSet
+rtos_signal_poll_set(const RtosSignalSet requested_signals)
+{
+    RtosSignalSet *const pending_signals = &PENDING_SIGNALS(get_current_task());
+    RtosSignalSet received_signals;
+
+    preempt_disable();
+
+    received_signals = signal_recv(pending_signals, requested_signals);
+
+    preempt_enable();
+
+    return received_signals;
+}
+
+RtosSignalSet
+rtos_signal_peek_set(const RtosSignalSet requested_signals)
+{
+    const RtosSignalSet pending_signals = PENDING_SIGNALS(get_current_task());
+    return pending_signals & requested_signals;
+}
+
+void
+rtos_signal_send_set(const RtosTaskId task_id, const RtosSignalSet signals)
+{
+    assert_task_valid(task_id);
+
+    preempt_disable();
+
+    signal_send_set(task_id, signals);
+
+    preempt_enable();
+}
+void
+rtos_timer_tick(void)
+{
+    /* If time_pending_ticks > 1, a timer overflow has occurred, which is considered fatal.
+     * We discard any ticks after that to prevent the the variable from wrapping back to zero. */
+    if (timer_pending_ticks < 2) {
+        timer_pending_ticks += 1;
+    }
+}
+void
+rtos_sleep(const RtosTicksRelative ticks) RTOS_REENTRANT
+{
+    preempt_disable();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    signal_wait(RTOS_SIGNAL_ID__TASK_TIMER);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_enable(const RtosTimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_enable(timer_id);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_disable(const RtosTimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    timer_disable(timer_id);
+}
+
+void
+rtos_timer_oneshot(const RtosTimerId timer_id, const RtosTicksRelative timeout)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_oneshot(timer_id, timeout);
+
+    preempt_enable();
+}
+
+bool
+rtos_timer_check_overflow(const RtosTimerId timer_id)
+{
+    bool r;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    r = timers[timer_id].overflow;
+    timers[timer_id].overflow = false;
+
+    preempt_enable();
+
+    return r;
+}
+
+RtosTicksRelative
+rtos_timer_remaining(const RtosTimerId timer_id)
+{
+    RtosTicksRelative remaining;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    remaining = timers[timer_id].enabled ? timers[timer_id].expiry - current_timeout() : 0;
+
+    preempt_enable();
+
+    return remaining;
+}
+
+/* Configuration functions */
+void
+rtos_timer_reload_set(const RtosTimerId timer_id, const RtosTicksRelative reload)
+{
+    assert_timer_valid(timer_id);
+
+    timer_reload_set(timer_id, reload);
+}
+
+void
+rtos_timer_signal_set(const RtosTimerId timer_id, const RtosTaskId task_id, const RtosSignalSet signal_set)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timers[timer_id].error_id = ERROR_ID_NONE;
+    timers[timer_id].task_id = task_id;
+    timers[timer_id].signal_set = signal_set;
+
+    preempt_enable();
+}
+
+void
+rtos_timer_error_set(const RtosTimerId timer_id, const RtosErrorId error_id)
+{
+    assert_timer_valid(timer_id);
+
+    timers[timer_id].error_id = error_id;
+}
+/* Set the pending status for the given interrupt event id. */
+void
+rtos_interrupt_event_raise(const RtosInterruptEventId interrupt_event_id)
+{
+    interrupt_event |= (1U << interrupt_event_id);
+}
+
+
+void
+rtos_mutex_lock(const RtosMutexId m) RTOS_REENTRANT
+{
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder != get_current_task(), ERROR_ID_DEADLOCK);
+
+    preempt_disable();
+
+    while (!mutex_try_lock(m))
+    {
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on(mutexes[m].holder);
+    }
+
+    preempt_enable();
+
+}
+
+bool
+rtos_mutex_lock_timeout(const RtosMutexId m, const RtosTicksRelative timeout)
+        RTOS_REENTRANT
+{
+    bool ret;
+    const RtosTicksAbsolute absolute_timeout = rtos_timer_current_ticks + timeout;
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder != get_current_task(), ERROR_ID_DEADLOCK);
+
+    preempt_disable();
+
+    ret = mutex_try_lock(m);
+    while (!ret && absolute_timeout > rtos_timer_current_ticks) {
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on_timeout(mutexes[m].holder, absolute_timeout - rtos_timer_current_ticks);
+        ret = mutex_try_lock(m);
+    }
+
+    preempt_enable();
+
+
+    return ret;
+}
+
+void
+rtos_mutex_unlock(const RtosMutexId m)
+{
+    RtosTaskId t;
+
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    mutex_core_unlocked(m);
+
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        if (mutex_waiters[t] == m)
+        {
+            mutex_waiters[t] = MUTEX_ID_NONE;
+            mutex_core_unblock(t);
+        }
+    }
+
+    mutexes[m].holder = TASK_ID_NONE;
+
+    preempt_enable();
+}
+
+bool
+rtos_mutex_try_lock(const RtosMutexId m)
+{
+    bool r;
+
+    assert_mutex_valid(m);
+
+    preempt_disable();
+
+    r = mutex_try_lock(m);
+
+    preempt_enable();
+
+    return r;
+}
+
+/* A macro implementation would be preferable to eliminate function call overhead when compilers don't support implicit
+ * inlining, but at present this would involve exposing too many implementation internals in the public API header. */
+bool
+rtos_mutex_holder_is_current(const RtosMutexId m)
+{
+    assert_mutex_valid(m);
+    return mutexes[m].holder == get_current_task();
+}
+
+void
+rtos_sem_wait(const RtosSemId s) RTOS_REENTRANT
+{
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+    while (!internal_sem_try_wait(s))
+    {
+        sem_waiters[get_current_task()] = s;
+        sem_core_block();
+    }
+
+    preempt_enable();
+}
+
+bool
+rtos_sem_wait_timeout(const RtosSemId s, const RtosTicksRelative timeout)
+        RTOS_REENTRANT
+{
+    bool ret;
+    const RtosTicksAbsolute absolute_timeout = rtos_timer_current_ticks + timeout;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+    while (!(ret = internal_sem_try_wait(s)) && absolute_timeout > rtos_timer_current_ticks) {
+        sem_waiters[get_current_task()] = s;
+        sem_core_block_timeout(absolute_timeout - rtos_timer_current_ticks);
+    }
+
+    preempt_enable();
+
+    return ret;
+}
+
+void
+rtos_sem_post(const RtosSemId s)
+{
+    RtosTaskId t;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+
+    if (semaphores[s].value == SEM_VALUE_ZERO)
+    {
+        for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+        {
+            if (sem_waiters[t] == s)
+            {
+                sem_waiters[t] = SEM_ID_NONE;
+                sem_core_unblock(t);
+            }
+        }
+    }
+
+    semaphores[s].value++;
+
+    preempt_enable();
+}
+
+bool
+rtos_sem_try_wait(const RtosSemId s)
+{
+    bool r;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+    r = internal_sem_try_wait(s);
+    preempt_enable();
+
+    return r;
+}
+
+
+RtosTaskId
+rtos_task_current(void)
+{
+    return get_current_task();
+}
+void
+rtos_start(void)
+{
+    sem_init();
+    preempt_init();
+
+    context_init(get_task_context(0), entry_helper, stack_0, 8192);
+    sched_set_runnable(0);
+    context_init(get_task_context(1), entry_main, stack_1, 8192);
+    sched_set_runnable(1);
+
+    context_switch_first(RTOS_TASK_ID_ZERO);
+}
@@ -0,0 +1,165 @@
+
+#include "rtos-acamar.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdint.h>
+
+
+
+#define CONTEXT_SIZE 10
+#define CONTEXT_V1_IDX 0
+#define CONTEXT_V2_IDX 1
+#define CONTEXT_V3_IDX 2
+#define CONTEXT_V4_IDX 3
+#define CONTEXT_V5_IDX 4
+#define CONTEXT_V6_IDX 5
+#define CONTEXT_V7_IDX 6
+#define CONTEXT_V8_IDX 7
+#define CONTEXT_IP_IDX 8
+#define CONTEXT_PC_IDX 9
+#define ERROR_ID_NONE ((RtosErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW ((RtosErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID ((RtosErrorId) UINT8_C(2))
+#define ERROR_ID_NOT_HOLDING_MUTEX ((RtosErrorId) UINT8_C(3))
+#define ERROR_ID_DEADLOCK ((RtosErrorId) UINT8_C(4))
+#define ERROR_ID_TASK_FUNCTION_RETURNS ((RtosErrorId) UINT8_C(5))
+#define ERROR_ID_INTERNAL_CURRENT_TASK_INVALID ((RtosErrorId) UINT8_C(6))
+#define ERROR_ID_INTERNAL_INVALID_ID ((RtosErrorId) UINT8_C(7))
+#define ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP ((RtosErrorId) UINT8_C(8))
+#define ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(9))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(10))
+#define ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER ((RtosErrorId) UINT8_C(11))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW ((RtosErrorId) UINT8_C(12))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION ((RtosErrorId) UINT8_C(13))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_CONFIGURATION ((RtosErrorId) UINT8_C(14))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_HEAD ((RtosErrorId) UINT8_C(15))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE ((RtosErrorId) UINT8_C(16))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_ID_IN_WAITERS ((RtosErrorId) UINT8_C(17))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TASKS_BLOCKED_DESPITE_AVAILABLE_MESSAGES ((RtosErrorId) UINT8_C(18))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_WAITING_TASK_IS_NOT_BLOCKED ((RtosErrorId) UINT8_C(19))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGES_POINTER ((RtosErrorId) UINT8_C(20))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGE_SIZE ((RtosErrorId) UINT8_C(21))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH ((RtosErrorId) UINT8_C(22))
+#define ERROR_ID_INTERNAL_PRECONDITION_VIOLATED ((RtosErrorId) UINT8_C(23))
+#define ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED ((RtosErrorId) UINT8_C(24))
+#define ERROR_ID_SEMAPHORE_MAX_INVALID ((RtosErrorId) UINT8_C(25))
+#define ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT ((RtosErrorId) UINT8_C(26))
+#define ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT ((RtosErrorId) UINT8_C(27))
+#define ERROR_ID_SEMAPHORE_MAX_EXCEEDED ((RtosErrorId) UINT8_C(28))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED ((RtosErrorId) UINT8_C(29))
+#define ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX ((RtosErrorId) UINT8_C(30))
+#define ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED ((RtosErrorId) UINT8_C(31))
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+#define current_task rtos_internal_current_task
+#define tasks rtos_internal_tasks
+typedef uint32_t* context_t;
+typedef RtosTaskId TaskIdOption;
+
+
+
+
+
+struct task
+{
+    context_t ctx;
+};
+
+
+
+extern void rtos_internal_context_switch(context_t *, context_t *) RTOS_REENTRANT;
+extern void rtos_internal_context_switch_first(context_t *) RTOS_REENTRANT;
+extern void rtos_internal_trampoline(void);
+extern void None(RtosErrorId error_id);
+extern void bench_main(void);
+extern void bench_helper(void);
+
+
+
+/**
+ * Set up the initial execution context of a task.
+ * This function is invoked exactly once for each task in the system.
+  *
+ * @param ctx An output parameter interpreted by the RTOS as the initial context for each task.
+ *  After this function returns, the RTOS uses the value of ctx for task/context/stack switching.
+ *  The concept of a context and of the context_t type is abstract and may have different implementations on
+ *  different platforms.
+ *  It can be, e.g., a stack pointer or a data structure for user-level task switching as on POSIX.
+ *  This function is expected to set ctx to a value that the RTOS can pass to this platform's implementation of
+ *  context_switch() and context_switch_first().
+ *  The context must be set up such that the destination task of a task switch executes the code at the address fn
+ *  using the memory region defined by stack_base and stack_size as its stack.
+ *  For hardware platforms, this typically requires the following set up steps:
+ *  - The value of ctx points to either the beginning or the end of the stack area.
+ *  - The stack area contains fn so that the context-switch functions can pop it off the stack as a return address to
+ *    begin execution at.
+ *  - Optionally reserve additional stack space if the context-switch functions depend on it.
+ * @param fn Points to a code address at which the given execution context shall start executing.
+ *  This is typically a pointer to a parameter-less function that is assumed to never return.
+ * @param stack_base Points to the lowest address of the memory area this execution context shall use as a stack.
+ * @param stack_size The size in bytes of the stack memory area reserved for this execution context.
+ */
+static void context_init(context_t *const ctx, void (*const fn)(void), uint32_t *const stack_base, const size_t stack_size);
+
+
+
+static uint32_t stack_0[1024] __attribute__((aligned(8)));
+static uint32_t stack_1[1024] __attribute__((aligned(8)));
+
+
+RtosTaskId rtos_internal_current_task;
+struct task rtos_internal_tasks[2];
+
+
+
+#define context_switch(from, to) rtos_internal_context_switch(to, from)
+#define context_switch_first(to) rtos_internal_context_switch_first(to)
+#define api_error(error_id) do { } while(0)
+#define api_assert(expression, error_id) do { } while(0)
+
+#define internal_error(error_id) do { } while(0)
+#define internal_assert(expression, error_id) do { } while(0)
+#define get_current_task() current_task
+#define get_task_context(task_id) &tasks[task_id].ctx
+#define internal_assert_task_valid(task) internal_assert(task < 2, ERROR_ID_INTERNAL_INVALID_ID)
+#define assert_task_valid(task) api_assert(task < 2, ERROR_ID_INVALID_ID)
+
+
+
+static void
+context_init(context_t *const ctx, void (*const fn)(void), uint32_t *const stack_base, const size_t stack_size)
+{
+    uint32_t *context;
+    context = stack_base + stack_size - CONTEXT_SIZE;
+    context[CONTEXT_V1_IDX] = (uint32_t) fn;
+    context[CONTEXT_PC_IDX] = (uint32_t) rtos_internal_trampoline;
+    *ctx = context;
+}
+
+
+void
+rtos_yield_to(const RtosTaskId to) RTOS_REENTRANT
+{
+    const RtosTaskId from = get_current_task();
+    current_task = to;
+    context_switch(get_task_context(from), get_task_context(to));
+}
+
+void
+rtos_start(void)
+{
+    context_init(get_task_context(0), bench_main, stack_0, 1024);
+    context_init(get_task_context(1), bench_helper, stack_1, 1024);
+
+    context_switch_first(get_task_context(RTOS_TASK_ID_ZERO));
+}
+
+
+
+RtosTaskId
+rtos_task_current(void)
+{
+    return get_current_task();
+}
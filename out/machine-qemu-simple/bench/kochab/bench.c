@@ -0,0 +1,330 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+/*
+ * Kernel benchmarks shared by every RTOS variant.
+ *
+ * The system provides two tasks: 'main', which drives the benchmarks and
+ * takes the measurements, and 'helper', which is the other end of every
+ * context switch.
+ * On preemptive variants 'helper' must have the higher priority.
+ *
+ * Each result is printed on a single line:
+ *
+ *   bench: <name> <param> <iterations> <elapsed>
+ *
+ * with the numeric fields in hexadecimal and 'elapsed' in units of the platform's bench clock.
+ * The line 'bench: done' marks the end of the run.
+ * 'x.py bench' parses this output.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "rtos-kochab.h"
+#include "debug.h"
+
+#define BENCH_ITERATIONS 1000
+
+/* Provided by the platform's bench-platform module. */
+extern void bench_clock_init(void);
+extern uint32_t bench_clock(void);
+extern void bench_exit(void);
+extern void bench_irq_trigger(void);
+extern void bench_irq_clear(void);
+
+
+/* Requests handled by the helper task when it receives the 'bench' signal. */
+enum bench_command {
+    BENCH_COMMAND_PING,
+    BENCH_COMMAND_MUTEX,
+    BENCH_COMMAND_SEM,
+    BENCH_COMMAND_MSGQ
+};
+
+static volatile enum bench_command bench_command;
+static volatile uint32_t bench_wake;
+static volatile enum {
+    BENCH_IRQ_EVENT,
+    BENCH_IRQ_TICK
+} bench_irq_action;
+static volatile uint32_t bench_irq_count;
+
+void
+fatal(const RtosErrorId error_id)
+{
+    debug_print("FATAL ERROR: ");
+    debug_printhex32(error_id);
+    debug_println("");
+    for (;;)
+    {
+    }
+}
+
+static void
+bench_report(const char *const name, const uint32_t param, const uint32_t iterations, const uint32_t elapsed)
+{
+    debug_print("bench: ");
+    debug_print(name);
+    debug_print(" ");
+    debug_printhex32(param);
+    debug_print(" ");
+    debug_printhex32(iterations);
+    debug_print(" ");
+    debug_printhex32(elapsed);
+    debug_println("");
+}
+
+static void
+bench_done(void)
+{
+    debug_println("bench: done");
+    bench_exit();
+    for (;;)
+    {
+    }
+}
+
+/* Handler for the platform's bench interrupt; the system installs it as a preempting handler. */
+bool
+bench_irq_handler(void)
+{
+    bench_irq_clear();
+    if (bench_irq_action == BENCH_IRQ_TICK)
+    {
+        rtos_timer_tick();
+    }
+    else
+    {
+        rtos_interrupt_event_raise(RTOS_INTERRUPT_EVENT_ID_BENCH);
+    }
+    bench_irq_count++;
+
+    return true;
+}
+
+/* Trigger the bench interrupt and return once its handler, and any task it woke, has run. */
+static void
+bench_irq_raise(void)
+{
+    const uint32_t count = bench_irq_count;
+
+    bench_irq_trigger();
+    while (bench_irq_count == count)
+    {
+    }
+}
+
+/* Hand a command to the helper task and return once it has been carried out.
+ * Returns the bench clock value taken immediately before the helper was signalled. */
+static uint32_t
+bench_request(const enum bench_command command)
+{
+    uint32_t start;
+
+    bench_command = command;
+    start = bench_clock();
+    rtos_signal_send(RTOS_TASK_ID_HELPER, RTOS_SIGNAL_ID_BENCH);
+
+    return start;
+}
+
+static void
+bench_context_switch(void)
+{
+    uint32_t i;
+    uint32_t start;
+    uint32_t request;
+    uint32_t latency = 0;
+
+    start = bench_clock();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        request = bench_request(BENCH_COMMAND_PING);
+        latency += bench_wake - request;
+    }
+    bench_report("cswitch-preempt", 0, 2 * BENCH_ITERATIONS, bench_clock() - start);
+    bench_report("signal-wake", 0, BENCH_ITERATIONS, latency);
+}
+
+static void
+bench_mutex(void)
+{
+    uint32_t i;
+    uint32_t start;
+    uint32_t elapsed = 0;
+
+    start = bench_clock();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        rtos_mutex_lock(RTOS_MUTEX_ID_BENCH);
+        rtos_mutex_unlock(RTOS_MUTEX_ID_BENCH);
+    }
+    bench_report("mutex-uncontended", 0, BENCH_ITERATIONS, bench_clock() - start);
+
+    /* The helper preempts, finds the mutex held and blocks; unlocking hands the mutex over to it. */
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        start = bench_clock();
+        rtos_mutex_lock(RTOS_MUTEX_ID_BENCH);
+        (void) bench_request(BENCH_COMMAND_MUTEX);
+        rtos_mutex_unlock(RTOS_MUTEX_ID_BENCH);
+        elapsed += bench_clock() - start;
+    }
+    bench_report("mutex-contended", 0, BENCH_ITERATIONS, elapsed);
+}
+
+static void
+bench_sem(void)
+{
+    uint32_t i;
+    uint32_t start;
+
+    (void) bench_request(BENCH_COMMAND_SEM);
+    start = bench_clock();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        rtos_sem_post(RTOS_SEM_ID_PING);
+        rtos_sem_wait(RTOS_SEM_ID_PONG);
+    }
+    bench_report("sem-pingpong", 0, BENCH_ITERATIONS, bench_clock() - start);
+}
+
+/* Ticks are raised by the bench interrupt's handler. */
+/* None of the enabled timers comes close to expiring, so the measurement is the cost of processing a tick as a
+ * function of the number of timers that the kernel has to update. */
+static void
+bench_timer(void)
+{
+    static const uint32_t timer_counts[] = { 0, 1, 2, 4, 8 };
+    uint32_t c;
+    uint32_t i;
+    uint32_t start;
+
+    bench_irq_action = BENCH_IRQ_TICK;
+    for (c = 0; c < sizeof(timer_counts) / sizeof(timer_counts[0]); c++)
+    {
+        for (i = 0; i < timer_counts[c]; i++)
+        {
+            rtos_timer_reload_set((RtosTimerId) i, 60000);
+            rtos_timer_enable((RtosTimerId) i);
+        }
+
+        start = bench_clock();
+        for (i = 0; i < BENCH_ITERATIONS; i++)
+        {
+            bench_irq_raise();
+        }
+        bench_report("timer-tick", timer_counts[c], BENCH_ITERATIONS, bench_clock() - start);
+
+        for (i = 0; i < timer_counts[c]; i++)
+        {
+            rtos_timer_disable((RtosTimerId) i);
+        }
+    }
+}
+
+/* The interrupt event is raised by the bench interrupt's handler; the latency runs from triggering the interrupt to
+ * the helper task waking. */
+static void
+bench_irq(void)
+{
+    uint32_t i;
+    uint32_t start;
+    uint32_t latency = 0;
+
+    bench_command = BENCH_COMMAND_PING;
+    bench_irq_action = BENCH_IRQ_EVENT;
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        start = bench_clock();
+        bench_irq_raise();
+        latency += bench_wake - start;
+    }
+    bench_report("irq-wake", 0, BENCH_ITERATIONS, latency);
+}
+
+void
+bench_main(void)
+{
+    bench_clock_init();
+    /* Tasks do not all start out runnable; make both of them runnable in whichever way the variant provides. */
+
+    bench_context_switch();
+    bench_mutex();
+    bench_sem();
+    bench_timer();
+    bench_irq();
+
+    bench_done();
+}
+
+static void
+bench_helper_sem(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        rtos_sem_wait(RTOS_SEM_ID_PING);
+        rtos_sem_post(RTOS_SEM_ID_PONG);
+    }
+}
+
+void
+bench_helper(void)
+{
+    for (;;)
+    {
+        (void) rtos_signal_wait(RTOS_SIGNAL_ID_BENCH);
+        bench_wake = bench_clock();
+
+        switch (bench_command)
+        {
+        case BENCH_COMMAND_PING:
+            break;
+        case BENCH_COMMAND_MUTEX:
+            rtos_mutex_lock(RTOS_MUTEX_ID_BENCH);
+            rtos_mutex_unlock(RTOS_MUTEX_ID_BENCH);
+            break;
+        case BENCH_COMMAND_SEM:
+            bench_helper_sem();
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+int
+main(void)
+{
+    rtos_start();
+    for (;;)
+    {
+    }
+}
@@ -0,0 +1,1289 @@
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitband.h"
+#include <stdbool.h>
+
+
+
+#include <stdint.h>
+#include <stdint.h>
+#include "rtos-kochab.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+
+#define PREEMPTION_SUPPORT
+
+/* To support preemption of tasks by exception handlers, we define a context stack frame that includes the exception
+ * frame automatically stored onto the stack by the CPU when it takes an exception.
+ *
+ * The ARM stack grows downwards, from high to low addresses.
+ * Therefore, the context stack frame entries with the lowest index numbers are the last to be pushed to the stack.
+ * Note that the Procedure Call Standard for the ARM Architecture (ARM IHI 0042E, ABI release 2.09) says that at a
+ * public interface, the stack must be double-word (8-byte) aligned.
+ * Please see http://infocenter.arm.com/help/topic/com.arm.doc.ihi0042e/index.html for more details.
+ *
+ * The lower-address half of the context stack frame is for register values and task state that the RTOS must manually
+ * push onto the stack before it switches context. */
+
+#define CONTEXT_PREEMPT_DISABLED 0
+#define CONTEXT_R4_IDX 1
+#define CONTEXT_R5_IDX 2
+#define CONTEXT_R6_IDX 3
+#define CONTEXT_R7_IDX 4
+#define CONTEXT_R8_IDX 5
+#define CONTEXT_R9_IDX 6
+#define CONTEXT_R10_IDX 7
+#define CONTEXT_R11_IDX 8
+#define CONTEXT_EXCEPTION_RETURN_IDX 9
+#define CONTEXT_S16_IDX 10
+#define CONTEXT_S17_IDX 11
+#define CONTEXT_S18_IDX 12
+#define CONTEXT_S19_IDX 13
+#define CONTEXT_S20_IDX 14
+#define CONTEXT_S21_IDX 15
+#define CONTEXT_S22_IDX 16
+#define CONTEXT_S23_IDX 17
+#define CONTEXT_S24_IDX 18
+#define CONTEXT_S25_IDX 19
+#define CONTEXT_S26_IDX 20
+#define CONTEXT_S27_IDX 21
+#define CONTEXT_S28_IDX 22
+#define CONTEXT_S29_IDX 23
+#define CONTEXT_S30_IDX 24
+#define CONTEXT_S31_IDX 25
+
+/* The higher-address half of the context stack frame is the exception frame automatically pushed by the CPU.
+ * We generally assume this is pushed and popped correctly by the CPU on exception entry and return, and only really
+ * manipulate parts of this region for the setting up of initial task states. */
+
+#define CONTEXT_R0_IDX 26
+#define CONTEXT_R1_IDX 27
+#define CONTEXT_R2_IDX 28
+#define CONTEXT_R3_IDX 29
+#define CONTEXT_IP_IDX 30
+#define CONTEXT_LR_IDX 31
+#define CONTEXT_PC_IDX 32
+#define CONTEXT_PSR_IDX 33
+
+#define CONTEXT_NONFP_SIZE 34
+
+/* The very highest portion of the exception frame is only pushed/popped by the CPU if floating-point is enabled.
+ * Since we set the initial task state to have floating-point disabled, we exclude these entries when creating the
+ * initial context stack frames for each task, and generally don't interfere with this region subsequently.
+ * All we must do is ensure that the EXC_RETURN is set correctly for the destination task on exception return. */
+
+#define CONTEXT_S0_IDX 34
+#define CONTEXT_S1_IDX 35
+#define CONTEXT_S2_IDX 36
+#define CONTEXT_S3_IDX 37
+#define CONTEXT_S4_IDX 38
+#define CONTEXT_S5_IDX 39
+#define CONTEXT_S6_IDX 40
+#define CONTEXT_S7_IDX 41
+#define CONTEXT_S8_IDX 42
+#define CONTEXT_S9_IDX 43
+#define CONTEXT_S10_IDX 44
+#define CONTEXT_S11_IDX 45
+#define CONTEXT_S12_IDX 46
+#define CONTEXT_S13_IDX 47
+#define CONTEXT_S14_IDX 48
+#define CONTEXT_S15_IDX 49
+#define CONTEXT_FPSCR_IDX 50
+#define CONTEXT_ALIGNER_IDX 51
+
+#define CONTEXT_FP_SIZE 52
+
+/* Definitions for ARM-specific initialization.
+ *
+ * We define the SVCALL priority to be a higher level (i.e. lower numerical value) than PENDSV so that when we disable
+ * preemption by setting BASEPRI to PENDSV's priority, PENDSV is disabled but SVCALL remains enabled.
+ * This reflects our desire for the RTOS to be able to manually yield (via svc) when preemption is disabled.
+ *
+ * Some platforms do not implement the low 4 bits of priority.
+ * Thus, we choose priority values that are distinct regardless of the lower 4 bits.
+ * The armv7m.vectable module validates the configured interrupt priorities against these values. */
+
+#define SVCALL_PRIORITY 224u
+#define PENDSV_PRIORITY 240u
+
+/* System Handler Priority Registers (SHPR) */
+#define SHPR2_PHYSADDR 0xE000ED1C
+#define SHPR3_PHYSADDR 0xE000ED20
+
+#define SHPR2_SVCALL_PRIO_MASK 0x00ffffff
+#define SHPR2_SVCALL_PRIO_OFFSET 24
+
+#define SHPR3_PENDSV_PRIO_MASK 0xff00ffff
+#define SHPR3_PENDSV_PRIO_OFFSET 16
+
+/* Execution Program Status Register (EPSR)
+ * T-bit is the Thumb state bit, which must be 1 for the Cortex-M4 because it only supports Thumb instructions. */
+#define EPSR_THUMB_BIT_OFFSET 24
+
+/* For EXC_RETURN of the first task, we choose this value, which means "Return to Thread mode, exception return uses
+ * non-floating-point state from MSP and execution uses MSP after return" according to the Cortex-M4 Devices Generic
+ * User Guide (ARM DUI 0553A).
+ * Please see http://infocenter.arm.com/help/topic/com.arm.doc.dui0553a/index.html for more details. */
+#define EXC_RETURN_INITIAL_TASK 0xfffffff9
+#define SCHED_INDEX_ZERO ((SchedIndex) RTOS_TASK_ID_ZERO)
+
+
+#define TIMER_ID_ZERO ((RtosTimerId) UINT8_C(0))
+#define TIMER_ID_MAX ((RtosTimerId) UINT8_C(10 - 1U))
+#define interrupt_event rtos_internal_interrupt_event
+#define interrupt_event_bitband rtos_internal_interrupt_event_bitband
+#define SCR_PHYSADDR 0xE000ED10
+#define SCR_SEVONPEND (1u << 4)
+
+
+#define MUTEX_ID_NONE ((MutexIdOption) UINT8_MAX)
+#define SEM_ID_NONE ((SemIdOption) UINT8_MAX)
+#define SEM_VALUE_ZERO ((RtosSemValue) UINT8_C(0))
+#define ERROR_ID_NONE ((RtosErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW ((RtosErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID ((RtosErrorId) UINT8_C(2))
+#define ERROR_ID_NOT_HOLDING_MUTEX ((RtosErrorId) UINT8_C(3))
+#define ERROR_ID_DEADLOCK ((RtosErrorId) UINT8_C(4))
+#define ERROR_ID_TASK_FUNCTION_RETURNS ((RtosErrorId) UINT8_C(5))
+#define ERROR_ID_INTERNAL_CURRENT_TASK_INVALID ((RtosErrorId) UINT8_C(6))
+#define ERROR_ID_INTERNAL_INVALID_ID ((RtosErrorId) UINT8_C(7))
+#define ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP ((RtosErrorId) UINT8_C(8))
+#define ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(9))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(10))
+#define ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER ((RtosErrorId) UINT8_C(11))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW ((RtosErrorId) UINT8_C(12))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION ((RtosErrorId) UINT8_C(13))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_CONFIGURATION ((RtosErrorId) UINT8_C(14))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_HEAD ((RtosErrorId) UINT8_C(15))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE ((RtosErrorId) UINT8_C(16))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_ID_IN_WAITERS ((RtosErrorId) UINT8_C(17))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TASKS_BLOCKED_DESPITE_AVAILABLE_MESSAGES ((RtosErrorId) UINT8_C(18))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_WAITING_TASK_IS_NOT_BLOCKED ((RtosErrorId) UINT8_C(19))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGES_POINTER ((RtosErrorId) UINT8_C(20))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGE_SIZE ((RtosErrorId) UINT8_C(21))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH ((RtosErrorId) UINT8_C(22))
+#define ERROR_ID_INTERNAL_PRECONDITION_VIOLATED ((RtosErrorId) UINT8_C(23))
+#define ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED ((RtosErrorId) UINT8_C(24))
+#define ERROR_ID_SEMAPHORE_MAX_INVALID ((RtosErrorId) UINT8_C(25))
+#define ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT ((RtosErrorId) UINT8_C(26))
+#define ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT ((RtosErrorId) UINT8_C(27))
+#define ERROR_ID_SEMAPHORE_MAX_EXCEEDED ((RtosErrorId) UINT8_C(28))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED ((RtosErrorId) UINT8_C(29))
+#define ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX ((RtosErrorId) UINT8_C(30))
+#define ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED ((RtosErrorId) UINT8_C(31))
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+#define current_task rtos_internal_current_task
+#define tasks rtos_internal_tasks
+
+typedef uint32_t* context_t;
+typedef RtosTaskId SchedIndex;
+typedef uint16_t TicksTimeout;
+typedef RtosMutexId MutexIdOption;
+typedef RtosSemId SemIdOption;
+typedef RtosTaskId TaskIdOption;
+
+
+
+struct sched_task {
+    TaskIdOption blocked_on;
+};
+
+/*
+ * NOTE: An RTOS variant using the scheduler must ensure that tasks
+ * array is sorted by priority.
+ */
+struct sched {
+    struct sched_task tasks[2];
+};
+struct signal_task {
+    RtosSignalSet signals;
+};
+
+struct signal {
+    struct signal_task tasks[2];
+};
+
+struct timer
+{
+    bool enabled;
+    bool overflow;
+    TicksTimeout expiry;
+    RtosTicksRelative reload;
+
+    /*
+     * when error_id is not ERROR_ID_NONE, the timer calls
+     * the application error function with this error_id.
+     */
+    RtosErrorId error_id;
+
+    RtosTaskId task_id;
+    RtosSignalSet signal_set;
+};
+
+
+struct interrupt_event_handler {
+    RtosTaskId task;
+    RtosSignalSet sig_set;
+};
+
+struct mutex {
+    TaskIdOption holder;
+};
+struct semaphore {
+    RtosSemValue value;
+};
+
+struct task
+{
+    context_t ctx;
+};
+
+
+
+extern void rtos_internal_context_switch_first(context_t *);
+extern void rtos_internal_task_entry_trampoline(void);
+extern bool rtos_internal_check_preempt_disabled(void);
+extern void rtos_internal_yield(void);
+extern void rtos_internal_preempt_enable(void);
+extern void rtos_internal_preempt_disable(void);
+extern void rtos_internal_preempt_pend(void);
+
+
+
+
+
+
+
+
+
+extern void fatal(RtosErrorId error_id);
+extern void bench_helper(void);
+extern void bench_main(void);
+extern void bench_helper(void);
+extern void bench_main(void);
+
+
+/**
+ * Platform-specific initialization for the preemption implementation called once at RTOS start time.
+ */
+static void preempt_init(void);
+
+/**
+ * Set up the initial execution context of a task.
+ * This function is invoked exactly once for each task in the system.
+ *
+ * @param ctx An output parameter interpreted by the RTOS as the initial context for each task.
+ *  After this function returns, the RTOS uses the value of ctx for task/context/stack switching.
+ *  The context must be set up such that the destination task of a task switch executes the code at the address fn
+ *  using the memory region defined by stack_base and stack_size as its stack.
+ * @param fn Points to a code address at which the given execution context shall start executing.
+ *  This is typically a pointer to a parameter-less function that is assumed to never return.
+ * @param stack_base Points to the lowest address of the memory area this execution context shall use as a stack.
+ * @param stack_size The size in bytes of the stack memory area reserved for this execution context.
+ */
+static void context_init(context_t *ctx, void (*fn)(void), uint32_t *stack_base, size_t stack_size);
+static void sched_set_runnable(const RtosTaskId task_id);
+static void sched_set_blocked_on(const RtosTaskId task_id, const RtosTaskId blocker);
+static TaskIdOption sched_get_next(void);
+static RtosSignalSet signal_recv(RtosSignalSet *pending_signals, RtosSignalSet requested_signals);
+static void signal_send_set(RtosTaskId task_id, RtosSignalSet signals);
+static RtosSignalSet signal_wait_set_blocked_on(RtosSignalSet requested_signals,
+        RtosTaskId blocker) RTOS_REENTRANT;
+
+static uint8_t timer_pending_ticks_get_and_clear_atomically(void);
+static void timer_process_one(struct timer *timer);
+static void timer_enable(RtosTimerId timer_id);
+static void timer_oneshot(RtosTimerId timer_id, RtosTicksRelative timeout);
+static void timer_tick_process(void);
+static void interrupt_event_process(void);
+static inline bool interrupt_application_event_check(void);
+static inline void interrupt_event_wait(void);
+RtosTaskId rtos_internal_interrupt_event_get_next(void);
+static void interrupt_event_handle(RtosInterruptEventId interrupt_event_id);
+
+static bool internal_sem_try_wait(const RtosSemId s);
+
+static void block_on(RtosTaskId blocker);
+static void mutex_core_block_on_timeout(RtosTaskId t, RtosTicksRelative ticks);
+static void sem_core_block_timeout(RtosTicksRelative ticks);
+static void unblock(RtosTaskId task);
+
+static uint32_t stack_0[1024] __attribute__((aligned(8)));
+static uint32_t stack_1[1024] __attribute__((aligned(8)));
+
+static struct sched sched_tasks;
+static struct signal signal_tasks;
+static volatile uint8_t timer_pending_ticks;
+RtosTicksAbsolute rtos_timer_current_ticks;
+static struct timer timers[10] = {
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        60000,
+        0,
+        TASK_ID_NONE,
+        RTOS_SIGNAL_SET_EMPTY
+    },
+    {
+        false,
+        false,
+        0,
+        0,
+        0,
+        RTOS_TASK_ID_HELPER,
+        RTOS_SIGNAL_SET__TASK_TIMER
+    },
+    {
+        false,
+        false,
+        0,
+        0,
+        0,
+        RTOS_TASK_ID_MAIN,
+        RTOS_SIGNAL_SET__TASK_TIMER
+    },
+};
+VOLATILE_BITBAND_VAR(uint32_t, rtos_internal_interrupt_event);
+static bool system_is_idle;
+struct interrupt_event_handler interrupt_events[1] = {
+    { RTOS_TASK_ID_HELPER, RTOS_SIGNAL_SET_BENCH },
+};
+static struct mutex mutexes[1] = {
+    {TASK_ID_NONE},
+};
+static MutexIdOption mutex_waiters[2] = {
+    MUTEX_ID_NONE,
+    MUTEX_ID_NONE,
+};
+static struct semaphore semaphores[2];
+static SemIdOption sem_waiters[2];
+
+RtosTaskId rtos_internal_current_task;
+struct task rtos_internal_tasks[2];
+static RtosTimerId task_timers[2] = {
+    RTOS_TIMER_ID__TASK_HELPER,
+    RTOS_TIMER_ID__TASK_MAIN,
+};
+
+
+#define context_switch_first(to) rtos_internal_context_switch_first(get_task_context(to))
+#define yield() rtos_internal_yield()
+#define preempt_disable() rtos_internal_preempt_disable()
+#define preempt_enable() rtos_internal_preempt_enable()
+#define preempt_pend() rtos_internal_preempt_pend()
+#define precondition_preemption_disabled() internal_assert(rtos_internal_check_preempt_disabled(), \
+        ERROR_ID_INTERNAL_PRECONDITION_VIOLATED)
+#define postcondition_preemption_disabled() internal_assert(rtos_internal_check_preempt_disabled(), \
+        ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED)
+#define postcondition_preemption_enabled() internal_assert(!rtos_internal_check_preempt_disabled(), \
+        ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED)
+#define sched_set_blocked(task_id) sched_set_blocked_on(task_id, TASK_ID_NONE)
+#define sched_runnable(task_id) (SCHED_OBJ(task_id).runnable)
+#define sched_max_index() (SchedIndex)(2 - 1U)
+#define sched_index_to_taskid(sched_index) (RtosTaskId)(sched_index)
+#define sched_taskid_to_index(task_id) (SchedIndex)(task_id)
+#define SCHED_OBJ(task_id) sched_tasks.tasks[task_id]
+
+#define signal_wait_blocked_on(requested_signals, blocker) signal_wait_set_blocked_on(requested_signals, blocker)
+#define signal_wait_set(requested_signals) signal_wait_set_blocked_on(requested_signals, TASK_ID_NONE)
+#define signal_wait(requested_signals) signal_wait_set(requested_signals)
+#define signal_peek(pending_signals, requested_signals) (((pending_signals) & (requested_signals)) != RTOS_SIGNAL_SET_EMPTY)
+#define signal_pending(task_id, mask) ((PENDING_SIGNALS(task_id) & mask) == mask)
+#define PENDING_SIGNALS(task_id) signal_tasks.tasks[task_id].signals
+#define timer_pending_ticks_check() ((bool)timer_pending_ticks)
+#define timer_expired(timer, timeout) ((timer)->enabled && (timer)->expiry == timeout)
+#define timer_is_periodic(timer) ((timer)->reload > 0)
+#define timer_reload_set(timer_id, ticks) timers[timer_id].reload = ticks
+#define timer_disable(timer_id) timers[timer_id].enabled = false
+#define current_timeout() ((TicksTimeout) rtos_timer_current_ticks)
+#define TIMER_PTR(timer_id) (&timers[timer_id])
+#define assert_timer_valid(timer) api_assert(timer_id < 10, ERROR_ID_INVALID_ID)
+
+#define interrupt_event_check() (interrupt_application_event_check() || interrupt_system_event_check())
+#define interrupt_system_event_check() timer_pending_ticks_check()
+#define interrupt_event_get_next() rtos_internal_interrupt_event_get_next()
+
+#define assert_mutex_valid(mutex) api_assert(mutex < 1, ERROR_ID_INVALID_ID)
+#define assert_sem_valid(sem) api_assert(sem < 2, ERROR_ID_INVALID_ID)
+#define api_error(error_id) do { } while(0)
+#define api_assert(expression, error_id) do { } while(0)
+
+#define internal_error(error_id) do { } while(0)
+#define internal_assert(expression, error_id) do { } while(0)
+#define get_current_task() current_task
+#define get_task_context(task_id) &tasks[task_id].ctx
+#define internal_assert_task_valid(task) internal_assert(task < 2, ERROR_ID_INTERNAL_INVALID_ID)
+#define assert_task_valid(task) api_assert(task < 2, ERROR_ID_INVALID_ID)
+#define block() block_on(TASK_ID_NONE)
+#define mutex_core_block_on(blocker) signal_wait_blocked_on(RTOS_SIGNAL_ID__TASK_TIMER, blocker)
+#define mutex_core_unblock(task) signal_send_set(task, RTOS_SIGNAL_ID__TASK_TIMER)
+#define sem_core_block() signal_wait(RTOS_SIGNAL_ID__TASK_TIMER)
+#define sem_core_unblock(task) signal_send_set(task, RTOS_SIGNAL_ID__TASK_TIMER)
+
+
+
+/* ARM specific initialization */
+static void
+preempt_init(void)
+{
+    /* Set the priority of handlers */
+    volatile uint32_t *shpr2 = (uint32_t *) SHPR2_PHYSADDR;
+    volatile uint32_t *shpr3 = (uint32_t *) SHPR3_PHYSADDR;
+    *shpr2 = (SVCALL_PRIORITY << SHPR2_SVCALL_PRIO_OFFSET) | (SHPR2_SVCALL_PRIO_MASK & *shpr2);
+    *shpr3 = (PENDSV_PRIORITY << SHPR3_PENDSV_PRIO_OFFSET) | (SHPR3_PENDSV_PRIO_MASK & *shpr3);
+
+    preempt_disable();
+}
+
+static void
+context_init(context_t *const ctx, void (*const fn)(void), uint32_t *const stack_base, const size_t stack_size)
+{
+    /* We use the NONFP size because EXC_RETURN of all tasks is set initially to a non-floating-point state. */
+    uint32_t *const context = stack_base + stack_size - CONTEXT_NONFP_SIZE;
+
+    /* Start all tasks with preemption disabled by setting this field to a non-zero value. */
+    context[CONTEXT_PREEMPT_DISABLED] = true;
+    /* Set R4 to the task entry point, for the task entry trampoline to bounce to. */
+    context[CONTEXT_R4_IDX] = (uint32_t) fn;
+    context[CONTEXT_PC_IDX] = (uint32_t) rtos_internal_task_entry_trampoline;
+    context[CONTEXT_PSR_IDX] = (uint32_t) (1u << EPSR_THUMB_BIT_OFFSET); /* make sure the T-bit is set! */
+    context[CONTEXT_EXCEPTION_RETURN_IDX] = (uint32_t) EXC_RETURN_INITIAL_TASK;
+
+    *ctx = context;
+}
+static void
+sched_set_runnable(const RtosTaskId task_id)
+{
+    SCHED_OBJ(task_id).blocked_on = task_id;
+}
+
+static void
+sched_set_blocked_on(const RtosTaskId task_id, const RtosTaskId blocker)
+{
+    SCHED_OBJ(task_id).blocked_on = blocker;
+}
+
+static RAMFUNC TaskIdOption
+sched_get_next(void)
+{
+    /* NOTE: In the case where assume_runnable is true and no runnable
+       tasks are found, then an undefined task will be returned from this
+       function.
+    */
+    TaskIdOption task, next_task;
+    SchedIndex idx;
+
+    for (idx = SCHED_INDEX_ZERO; idx <= sched_max_index(); idx++)
+    {
+        task = sched_index_to_taskid(idx);
+        do
+        {
+            next_task = SCHED_OBJ(task).blocked_on;
+            if (next_task == task)
+            {
+                goto found;
+            }
+            task = next_task;
+        }
+        while (task != TASK_ID_NONE);
+    }
+found:
+    return  task;
+}
+static RtosSignalSet
+signal_recv(RtosSignalSet *const pending_signals, const RtosSignalSet requested_signals)
+{
+    const RtosSignalSet received_signals = *pending_signals & requested_signals;
+
+    precondition_preemption_disabled();
+
+    *pending_signals &= ~received_signals;
+
+    postcondition_preemption_disabled();
+
+    return received_signals;
+}
+
+static RAMFUNC void
+signal_send_set(const RtosTaskId task_id, const RtosSignalSet signals)
+{
+    precondition_preemption_disabled();
+
+    PENDING_SIGNALS(task_id) |= signals;
+    unblock(task_id);
+
+    postcondition_preemption_disabled();
+}
+
+static RtosSignalSet
+signal_wait_set_blocked_on(const RtosSignalSet requested_signals, const RtosTaskId blocker)
+        RTOS_REENTRANT
+{
+    RtosSignalSet received_signals;
+
+    precondition_preemption_disabled();
+    {
+        RtosSignalSet *const pending_signals = &PENDING_SIGNALS(get_current_task());
+
+        if (signal_peek(*pending_signals, requested_signals))
+        {
+            yield();
+        }
+        else
+        {
+            do
+            {
+                block_on(blocker);
+            } while (!signal_peek(*pending_signals, requested_signals));
+        }
+
+        received_signals = signal_recv(pending_signals, requested_signals);
+    }
+    postcondition_preemption_disabled();
+
+    return received_signals;
+}
+/*
+ * This uses an exclusive access rather than masking interrupts, so that it does not delay zero-latency interrupts.
+ * Exception entry and return clear the exclusive monitor, so the strexb fails and the loop retries if timer_tick
+ * interrupts it.
+ */
+static uint8_t
+timer_pending_ticks_get_and_clear_atomically(void)
+{
+    uint32_t pending_ticks;
+    uint32_t failed;
+    do
+    {
+        asm volatile("ldrexb %0, [%1]" : "=r" (pending_ticks) : "r" (&timer_pending_ticks) : "memory");
+        asm volatile("strexb %0, %1, [%2]" : "=&r" (failed) : "r" (0), "r" (&timer_pending_ticks) : "memory");
+    } while (failed);
+    return (uint8_t) pending_ticks;
+}
+static void
+timer_process_one(struct timer *const timer)
+{
+    precondition_preemption_disabled();
+
+    if (timer_is_periodic(timer))
+    {
+        timer->expiry += timer->reload;
+    }
+    else
+    {
+        timer->enabled = false;
+    }
+
+    if (timer->error_id != ERROR_ID_NONE)
+    {
+        fatal(timer->error_id);
+    }
+    else
+    {
+        if (signal_pending(timer->task_id, timer->signal_set))
+        {
+            timer->overflow = true;
+        }
+        signal_send_set(timer->task_id, timer->signal_set);
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_enable(const RtosTimerId timer_id)
+{
+    precondition_preemption_disabled();
+
+    if (timers[timer_id].reload == 0)
+    {
+        timer_process_one(&timers[timer_id]);
+    }
+    else
+    {
+        timers[timer_id].expiry = current_timeout() + timers[timer_id].reload;
+        timers[timer_id].enabled = true;
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_oneshot(const RtosTimerId timer_id, const RtosTicksRelative timeout)
+{
+    precondition_preemption_disabled();
+
+    timer_reload_set(timer_id, timeout);
+    timer_enable(timer_id);
+    timer_reload_set(timer_id, 0);
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_tick_process(void)
+{
+    precondition_preemption_disabled();
+    {
+        const uint8_t pending_ticks = timer_pending_ticks_get_and_clear_atomically();
+
+        if (pending_ticks > 1)
+        {
+            fatal(ERROR_ID_TICK_OVERFLOW);
+        }
+
+        if (pending_ticks)
+        {
+            RtosTimerId timer_id;
+            struct timer *timer;
+            TicksTimeout timeout;
+
+            rtos_timer_current_ticks++;
+
+            timeout = current_timeout();
+
+            for (timer_id = TIMER_ID_ZERO; timer_id <= TIMER_ID_MAX; timer_id++)
+            {
+                timer = TIMER_PTR(timer_id);
+                if (timer_expired(timer, timeout))
+                {
+                    timer_process_one(timer);
+                }
+            }
+        }
+    }
+    postcondition_preemption_disabled();
+}
+static void
+interrupt_event_process(void)
+{
+    uint32_t tmp = interrupt_event;
+    while (tmp != 0)
+    {
+        const RtosInterruptEventId i = __builtin_ffs(tmp) - 1;
+        interrupt_event_bitband[i] = 0;
+        interrupt_event_handle(i);
+        tmp &= ~(1U << i);
+    }
+}
+
+static inline bool
+interrupt_application_event_check(void)
+{
+    return interrupt_event != 0;
+}
+
+/*
+ * Waiting for an interrupt event must not mask interrupts, so that the RTOS never delays zero-latency interrupts.
+ * Instead, SEVONPEND makes every interrupt that becomes pending set the event register.
+ * An interrupt that occurs after the check therefore causes the wfe to return immediately rather than being lost.
+ * Spurious returns from wfe are harmless, as the caller checks for interrupt events again.
+ */
+static inline void
+interrupt_event_wait(void)
+{
+    volatile uint32_t *scr = (uint32_t *) SCR_PHYSADDR;
+
+    *scr |= SCR_SEVONPEND;
+    if (!interrupt_event_check())
+    {
+        asm volatile("wfe");
+    }
+}
+RAMFUNC RtosTaskId
+rtos_internal_interrupt_event_get_next(void)
+{
+    TaskIdOption next;
+
+    for (;;)
+    {
+        interrupt_event_process();
+        timer_tick_process();
+        next = sched_get_next();
+
+        if (next == TASK_ID_NONE)
+        {
+            system_is_idle = true;
+            interrupt_event_wait();
+        }
+        else
+        {
+            system_is_idle = false;
+            break;
+        }
+    }
+
+    internal_assert_task_valid(next);
+
+    return next;
+}
+static RAMFUNC void
+interrupt_event_handle(const RtosInterruptEventId interrupt_event_id)
+{
+    precondition_preemption_disabled();
+
+    internal_assert(interrupt_event_id < 1, ERROR_ID_INTERNAL_INVALID_ID);
+
+#ifdef PREEMPTION_SUPPORT
+    signal_send_set(interrupt_events[interrupt_event_id].task, interrupt_events[interrupt_event_id].sig_set);
+#else
+    rtos_signal_send_set(interrupt_events[interrupt_event_id].task,
+            interrupt_events[interrupt_event_id].sig_set);
+#endif
+
+    postcondition_preemption_disabled();
+}
+static bool
+mutex_try_lock(const RtosMutexId m)
+{
+    const bool r = mutexes[m].holder == TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    if (r)
+    {
+        mutexes[m].holder = get_current_task();
+    }
+
+    postcondition_preemption_disabled();
+
+    return r;
+}
+static void
+sem_init(void)
+{
+    RtosTaskId t;
+
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        sem_waiters[t] = SEM_ID_NONE;
+    }
+}
+
+static bool
+internal_sem_try_wait(const RtosSemId s)
+{
+    precondition_preemption_disabled();
+
+    if (semaphores[s].value == SEM_VALUE_ZERO)
+    {
+        return false;
+    }
+    else
+    {
+        semaphores[s].value--;
+        return true;
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+entry_helper(void)
+{
+    precondition_preemption_disabled();
+
+    preempt_enable();
+    bench_helper();
+}
+static void
+entry_main(void)
+{
+    precondition_preemption_disabled();
+
+    preempt_enable();
+    bench_main();
+}
+
+static void
+block_on(const RtosTaskId blocker)
+{
+    precondition_preemption_disabled();
+
+    sched_set_blocked_on(get_current_task(), blocker);
+    yield();
+
+    postcondition_preemption_disabled();
+}
+
+
+static void
+mutex_core_block_on_timeout(const RtosTaskId t, const RtosTicksRelative ticks)
+{
+    precondition_preemption_disabled();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    mutex_core_block_on(t);
+    timer_disable(task_timers[get_current_task()]);
+
+    postcondition_preemption_disabled();
+}
+
+static void
+sem_core_block_timeout(const RtosTicksRelative ticks)
+{
+    precondition_preemption_disabled();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    sem_core_block();
+    timer_disable(task_timers[get_current_task()]);
+
+    postcondition_preemption_disabled();
+}
+
+static RAMFUNC void
+unblock(const RtosTaskId task)
+{
+    precondition_preemption_disabled();
+
+    sched_set_runnable(task);
+
+    /* Note: When preemption is enabled a yield should be forced as a higher priority task may have been scheduled. */
+    preempt_pend();
+
+    postcondition_preemption_disabled();
+}
+
+
+
+
+RtosSignalSet
+rtos_signal_wait_set(const RtosSignalSet requested_signals) RTOS_REENTRANT
+{
+    RtosSignalSet received_signals;
+
+    preempt_disable();
+
+    received_signals = signal_wait_set(requested_signals);
+
+    preempt_enable();
+
+    return received_signals;
+}
+
+RtosSignalSet
+rtos_signal_poll_set(const RtosSignalSet requested_signals)
+{
+    RtosSignalSet *const pending_signals = &PENDING_SIGNALS(get_current_task());
+    RtosSignalSet received_signals;
+
+    preempt_disable();
+
+    received_signals = signal_recv(pending_signals, requested_signals);
+
+    preempt_enable();
+
+    return received_signals;
+}
+
+RtosSignalSet
+rtos_signal_peek_set(const RtosSignalSet requested_signals)
+{
+    const RtosSignalSet pending_signals = PENDING_SIGNALS(get_current_task());
+    return pending_signals & requested_signals;
+}
+
+RAMFUNC void
+rtos_signal_send_set(const RtosTaskId task_id, const RtosSignalSet signals)
+{
+    assert_task_valid(task_id);
+
+    preempt_disable();
+
+    signal_send_set(task_id, signals);
+
+    preempt_enable();
+}
+void
+rtos_timer_tick(void)
+{
+    if (timer_pending_ticks < 2)
+    {
+        timer_pending_ticks += 1;
+    }
+}
+void
+rtos_sleep(const RtosTicksRelative ticks) RTOS_REENTRANT
+{
+    preempt_disable();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    signal_wait(RTOS_SIGNAL_ID__TASK_TIMER);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_enable(const RtosTimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_enable(timer_id);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_disable(const RtosTimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    timer_disable(timer_id);
+}
+
+void
+rtos_timer_oneshot(const RtosTimerId timer_id, const RtosTicksRelative timeout)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_oneshot(timer_id, timeout);
+
+    preempt_enable();
+}
+
+bool
+rtos_timer_check_overflow(const RtosTimerId timer_id)
+{
+    bool r;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    r = timers[timer_id].overflow;
+    timers[timer_id].overflow = false;
+
+    preempt_enable();
+
+    return r;
+}
+
+RtosTicksRelative
+rtos_timer_remaining(const RtosTimerId timer_id)
+{
+    RtosTicksRelative remaining;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    remaining = timers[timer_id].enabled ? timers[timer_id].expiry - current_timeout() : 0;
+
+    preempt_enable();
+
+    return remaining;
+}
+
+/* Configuration functions */
+void
+rtos_timer_reload_set(const RtosTimerId timer_id, const RtosTicksRelative reload)
+{
+    assert_timer_valid(timer_id);
+
+    timer_reload_set(timer_id, reload);
+}
+
+void
+rtos_timer_signal_set(const RtosTimerId timer_id, const RtosTaskId task_id, const RtosSignalSet signal_set)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timers[timer_id].error_id = ERROR_ID_NONE;
+    timers[timer_id].task_id = task_id;
+    timers[timer_id].signal_set = signal_set;
+
+    preempt_enable();
+}
+
+void
+rtos_timer_error_set(const RtosTimerId timer_id, const RtosErrorId error_id)
+{
+    assert_timer_valid(timer_id);
+
+    timers[timer_id].error_id = error_id;
+}
+void
+rtos_interrupt_event_raise(const RtosInterruptEventId interrupt_event_id)
+{
+    interrupt_event_bitband[interrupt_event_id] = 1;
+}
+
+
+void
+rtos_mutex_lock(const RtosMutexId m) RTOS_REENTRANT
+{
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder != get_current_task(), ERROR_ID_DEADLOCK);
+
+    preempt_disable();
+
+    while (!mutex_try_lock(m))
+    {
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on(mutexes[m].holder);
+    }
+
+    preempt_enable();
+
+}
+
+bool
+rtos_mutex_lock_timeout(const RtosMutexId m, const RtosTicksRelative timeout)
+        RTOS_REENTRANT
+{
+    bool ret;
+    const RtosTicksAbsolute absolute_timeout = rtos_timer_current_ticks + timeout;
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder != get_current_task(), ERROR_ID_DEADLOCK);
+
+    preempt_disable();
+
+    ret = mutex_try_lock(m);
+    while (!ret && absolute_timeout > rtos_timer_current_ticks) {
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on_timeout(mutexes[m].holder, absolute_timeout - rtos_timer_current_ticks);
+        ret = mutex_try_lock(m);
+    }
+
+    preempt_enable();
+
+
+    return ret;
+}
+
+void
+rtos_mutex_unlock(const RtosMutexId m)
+{
+    RtosTaskId t;
+
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        if (mutex_waiters[t] == m)
+        {
+            mutex_waiters[t] = MUTEX_ID_NONE;
+            mutex_core_unblock(t);
+        }
+    }
+
+    mutexes[m].holder = TASK_ID_NONE;
+
+    preempt_enable();
+}
+
+bool
+rtos_mutex_try_lock(const RtosMutexId m)
+{
+    bool r;
+
+    assert_mutex_valid(m);
+
+    preempt_disable();
+
+    r = mutex_try_lock(m);
+
+    preempt_enable();
+
+    return r;
+}
+
+/* A macro implementation would be preferable to eliminate function call overhead when compilers don't support implicit
+ * inlining, but at present this would involve exposing too many implementation internals in the public API header. */
+bool
+rtos_mutex_holder_is_current(const RtosMutexId m)
+{
+    assert_mutex_valid(m);
+    return mutexes[m].holder == get_current_task();
+}
+
+void
+rtos_sem_wait(const RtosSemId s) RTOS_REENTRANT
+{
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+    while (!internal_sem_try_wait(s))
+    {
+        sem_waiters[get_current_task()] = s;
+        sem_core_block();
+    }
+
+    preempt_enable();
+}
+
+bool
+rtos_sem_wait_timeout(const RtosSemId s, const RtosTicksRelative timeout)
+        RTOS_REENTRANT
+{
+    bool ret;
+    const RtosTicksAbsolute absolute_timeout = rtos_timer_current_ticks + timeout;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+    while (!(ret = internal_sem_try_wait(s)) && absolute_timeout > rtos_timer_current_ticks) {
+        sem_waiters[get_current_task()] = s;
+        sem_core_block_timeout(absolute_timeout - rtos_timer_current_ticks);
+    }
+
+    preempt_enable();
+
+    return ret;
+}
+
+void
+rtos_sem_post(const RtosSemId s)
+{
+    RtosTaskId t;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+
+    if (semaphores[s].value == SEM_VALUE_ZERO)
+    {
+        for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+        {
+            if (sem_waiters[t] == s)
+            {
+                sem_waiters[t] = SEM_ID_NONE;
+                sem_core_unblock(t);
+            }
+        }
+    }
+
+    semaphores[s].value++;
+
+    preempt_enable();
+}
+
+bool
+rtos_sem_try_wait(const RtosSemId s)
+{
+    bool r;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+    r = internal_sem_try_wait(s);
+    preempt_enable();
+
+    return r;
+}
+
+
+RtosTaskId
+rtos_task_current(void)
+{
+    return get_current_task();
+}
+void
+rtos_start(void)
+{
+    sem_init();
+    preempt_init();
+
+    context_init(get_task_context(0), entry_helper, stack_0, 1024);
+    sched_set_runnable(0);
+    context_init(get_task_context(1), entry_main, stack_1, 1024);
+    sched_set_runnable(1);
+
+    context_switch_first(RTOS_TASK_ID_ZERO);
+}
@@ -0,0 +1,241 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+/*
+ * Kernel benchmarks shared by every RTOS variant.
+ *
+ * The system provides two tasks: 'main', which drives the benchmarks and
+ * takes the measurements, and 'helper', which is the other end of every
+ * context switch.
+ * On preemptive variants 'helper' must have the higher priority.
+ *
+ * Each result is printed on a single line:
+ *
+ *   bench: <name> <param> <iterations> <elapsed>
+ *
+ * with the numeric fields in hexadecimal and 'elapsed' in units of the platform's bench clock.
+ * The line 'bench: done' marks the end of the run.
+ * 'x.py bench' parses this output.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "rtos-kraz.h"
+#include "debug.h"
+
+#define BENCH_ITERATIONS 1000
+
+/* Provided by the platform's bench-platform module. */
+extern void bench_clock_init(void);
+extern uint32_t bench_clock(void);
+extern void bench_exit(void);
+
+/* The phase tells the helper task what the main task is currently measuring.
+ * Only cooperative variants need this; on preemptive variants the helper runs only when it is signalled. */
+enum bench_phase {
+    BENCH_PHASE_YIELD,
+    BENCH_PHASE_MUTEX,
+    BENCH_PHASE_IRQ,
+    BENCH_PHASE_SERVER
+};
+
+static volatile enum bench_phase bench_phase;
+
+/* Requests handled by the helper task when it receives the 'bench' signal. */
+enum bench_command {
+    BENCH_COMMAND_PING,
+    BENCH_COMMAND_MUTEX,
+    BENCH_COMMAND_SEM,
+    BENCH_COMMAND_MSGQ
+};
+
+static volatile enum bench_command bench_command;
+static volatile uint32_t bench_wake;
+
+
+static void
+bench_report(const char *const name, const uint32_t param, const uint32_t iterations, const uint32_t elapsed)
+{
+    debug_print("bench: ");
+    debug_print(name);
+    debug_print(" ");
+    debug_printhex32(param);
+    debug_print(" ");
+    debug_printhex32(iterations);
+    debug_print(" ");
+    debug_printhex32(elapsed);
+    debug_println("");
+}
+
+static void
+bench_done(void)
+{
+    debug_println("bench: done");
+    bench_exit();
+    for (;;)
+    {
+    }
+}
+
+/* Hand a command to the helper task and return once it has been carried out.
+ * Returns the bench clock value taken immediately before the helper was signalled. */
+static uint32_t
+bench_request(const enum bench_command command)
+{
+    uint32_t start;
+
+    bench_command = command;
+    start = bench_clock();
+    rtos_signal_send(RTOS_TASK_ID_HELPER, RTOS_SIGNAL_ID_BENCH);
+    (void) rtos_signal_wait(RTOS_SIGNAL_ID_BENCH);
+
+    return start;
+}
+
+static void
+bench_context_switch(void)
+{
+    uint32_t i;
+    uint32_t start;
+
+    bench_phase = BENCH_PHASE_YIELD;
+    start = bench_clock();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        rtos_yield();
+    }
+    bench_report("cswitch-coop", 0, 2 * BENCH_ITERATIONS, bench_clock() - start);
+}
+
+static void
+bench_mutex(void)
+{
+    uint32_t i;
+    uint32_t start;
+    uint32_t elapsed = 0;
+
+    start = bench_clock();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        rtos_mutex_lock(RTOS_MUTEX_ID_BENCH);
+        rtos_mutex_unlock(RTOS_MUTEX_ID_BENCH);
+    }
+    bench_report("mutex-uncontended", 0, BENCH_ITERATIONS, bench_clock() - start);
+
+    /* The helper attempts to take the mutex while it is held, then takes it once it has been released. */
+    bench_phase = BENCH_PHASE_MUTEX;
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        start = bench_clock();
+        rtos_mutex_lock(RTOS_MUTEX_ID_BENCH);
+        rtos_yield();
+        rtos_mutex_unlock(RTOS_MUTEX_ID_BENCH);
+        rtos_yield();
+        elapsed += bench_clock() - start;
+    }
+    bench_report("mutex-contended", 0, BENCH_ITERATIONS, elapsed);
+}
+
+static void
+bench_signal(void)
+{
+    uint32_t i;
+    uint32_t start;
+    uint32_t request;
+    uint32_t latency = 0;
+
+    start = bench_clock();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        request = bench_request(BENCH_COMMAND_PING);
+        latency += bench_wake - request;
+    }
+    bench_report("signal-roundtrip", 0, BENCH_ITERATIONS, bench_clock() - start);
+    bench_report("signal-wake", 0, BENCH_ITERATIONS, latency);
+}
+
+void
+bench_main(void)
+{
+    bench_clock_init();
+    /* Tasks do not all start out runnable; make both of them runnable in whichever way the variant provides. */
+    rtos_signal_send_set(RTOS_TASK_ID_MAIN, 0);
+    rtos_signal_send_set(RTOS_TASK_ID_HELPER, 0);
+
+    bench_context_switch();
+    bench_mutex();
+    /* Let the helper leave the mutex phase and wait for commands. */
+    bench_phase = BENCH_PHASE_SERVER;
+    rtos_yield();
+    bench_signal();
+
+    bench_done();
+}
+
+void
+bench_helper(void)
+{
+    while (bench_phase == BENCH_PHASE_YIELD)
+    {
+        rtos_yield();
+    }
+    while (bench_phase == BENCH_PHASE_MUTEX)
+    {
+        rtos_mutex_lock(RTOS_MUTEX_ID_BENCH);
+        rtos_mutex_unlock(RTOS_MUTEX_ID_BENCH);
+        rtos_yield();
+    }
+    for (;;)
+    {
+        (void) rtos_signal_wait(RTOS_SIGNAL_ID_BENCH);
+        bench_wake = bench_clock();
+
+        switch (bench_command)
+        {
+        case BENCH_COMMAND_PING:
+            break;
+        case BENCH_COMMAND_MUTEX:
+            rtos_mutex_lock(RTOS_MUTEX_ID_BENCH);
+            rtos_mutex_unlock(RTOS_MUTEX_ID_BENCH);
+            break;
+        default:
+            break;
+        }
+
+        rtos_signal_send(RTOS_TASK_ID_MAIN, RTOS_SIGNAL_ID_BENCH);
+    }
+}
+
+int
+main(void)
+{
+    rtos_start();
+    for (;;)
+    {
+    }
+}
@@ -0,0 +1,193 @@
+#ifndef RTOS_RIGEL_H
+#define RTOS_RIGEL_H
+
+
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <stdint.h>
+
+#include <stdint.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+
+
+
+
+
+
+typedef uint8_t RtosSignalSet;
+typedef RtosSignalSet RtosSignalId;
+
+typedef uint8_t RtosTimerId;
+typedef uint32_t RtosTicksAbsolute;
+typedef uint16_t RtosTicksRelative;
+
+typedef uint8_t RtosInterruptEventId;
+
+typedef uint8_t RtosMutexId;
+
+typedef uint8_t RtosMessageQueueId;
+typedef uint8_t RtosErrorId;
+typedef uint8_t RtosTaskId;
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+#define RTOS_REENTRANT 
+
+
+
+
+#define RTOS_SIGNAL_SET_EMPTY ((RtosSignalSet) UINT8_C(0))
+#define RTOS_SIGNAL_SET_ALL ((RtosSignalSet) UINT8_MAX)
+#define RTOS_SIGNAL_SET_BENCH ((RtosSignalSet) UINT8_C(2))
+#define RTOS_SIGNAL_ID_BENCH ((RtosSignalId) RTOS_SIGNAL_SET_BENCH)
+#define RTOS_SIGNAL_SET__TASK_TIMER ((RtosSignalSet) UINT8_C(1))
+#define RTOS_SIGNAL_ID__TASK_TIMER ((RtosSignalId) RTOS_SIGNAL_SET__TASK_TIMER)
+#define RTOS_SIGNAL_SET__RTOS_UTIL ((RtosSignalSet) UINT8_C(4))
+#define RTOS_SIGNAL_ID__RTOS_UTIL ((RtosSignalId) RTOS_SIGNAL_SET__RTOS_UTIL)
+
+#define RTOS_TIMER_ID_BENCH0 ((RtosTimerId) UINT8_C(0))
+#define RTOS_TIMER_ID_BENCH1 ((RtosTimerId) UINT8_C(1))
+#define RTOS_TIMER_ID_BENCH2 ((RtosTimerId) UINT8_C(2))
+#define RTOS_TIMER_ID_BENCH3 ((RtosTimerId) UINT8_C(3))
+#define RTOS_TIMER_ID_BENCH4 ((RtosTimerId) UINT8_C(4))
+#define RTOS_TIMER_ID_BENCH5 ((RtosTimerId) UINT8_C(5))
+#define RTOS_TIMER_ID_BENCH6 ((RtosTimerId) UINT8_C(6))
+#define RTOS_TIMER_ID_BENCH7 ((RtosTimerId) UINT8_C(7))
+#define RTOS_TIMER_ID__TASK_MAIN ((RtosTimerId) UINT8_C(8))
+#define RTOS_TIMER_ID__TASK_HELPER ((RtosTimerId) UINT8_C(9))
+
+#define RTOS_INTERRUPT_EVENT_ID_BENCH ((RtosInterruptEventId) UINT8_C(0))
+
+#define RTOS_MUTEX_ID_ZERO ((RtosMutexId) UINT8_C(0))
+#define RTOS_MUTEX_ID_MAX ((RtosMutexId) UINT8_C(1 - 1))
+#define RTOS_MUTEX_ID_BENCH ((RtosMutexId) UINT8_C(0))
+
+#define RTOS_MESSAGE_QUEUE_ID_BENCH4 ((RtosMessageQueueId) UINT8_C(0))
+#define RTOS_MESSAGE_QUEUE_ID_BENCH32 ((RtosMessageQueueId) UINT8_C(1))
+#define RTOS_MESSAGE_QUEUE_ID_BENCH128 ((RtosMessageQueueId) UINT8_C(2))
+
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(2 - 1))
+#define RTOS_TASK_ID_MAIN ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_HELPER ((RtosTaskId) UINT8_C(1))
+
+
+
+
+
+
+#define rtos_signal_wait(requested_signal) \
+    (void) rtos_signal_wait_set(requested_signal)
+
+#define rtos_signal_poll(requested_signal) \
+    (rtos_signal_poll_set(requested_signal) != RTOS_SIGNAL_SET_EMPTY)
+
+#define rtos_signal_peek(requested_signal) \
+    (rtos_signal_peek_set(requested_signal) != RTOS_SIGNAL_SET_EMPTY)
+
+#define rtos_signal_send(task_id, signal) \
+    rtos_signal_send_set(task_id, signal)
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+extern RtosTicksAbsolute rtos_timer_current_ticks;
+
+
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+
+
+RtosSignalSet rtos_signal_wait_set(RtosSignalSet requested_signals) RTOS_REENTRANT;
+RtosSignalSet rtos_signal_poll_set(RtosSignalSet requested_signals);
+RtosSignalSet rtos_signal_peek_set(RtosSignalSet requested_signals);
+void rtos_signal_send_set(RtosTaskId task_id, RtosSignalSet signals);
+void rtos_timer_tick(void);
+void rtos_sleep(RtosTicksRelative ticks) RTOS_REENTRANT;
+void rtos_timer_enable(RtosTimerId timer_id);
+void rtos_timer_disable(RtosTimerId timer_id);
+void rtos_timer_oneshot(RtosTimerId timer_id, RtosTicksRelative timeout);
+bool rtos_timer_check_overflow(RtosTimerId timer_id);
+RtosTicksRelative rtos_timer_remaining(RtosTimerId timer_id);
+void rtos_timer_reload_set(RtosTimerId timer_id, RtosTicksRelative reload);
+void rtos_timer_error_set(RtosTimerId timer_id, RtosErrorId error_id);
+void rtos_timer_signal_set(RtosTimerId timer_id, RtosTaskId task_id, RtosSignalSet signal_set);
+void rtos_interrupt_event_raise(RtosInterruptEventId event);
+
+void rtos_interrupt_event_task_set(RtosInterruptEventId interrupt_event_id, RtosTaskId task_id);
+
+void rtos_mutex_lock(RtosMutexId) RTOS_REENTRANT;
+bool rtos_mutex_try_lock(RtosMutexId);
+void rtos_mutex_unlock(RtosMutexId);
+bool rtos_mutex_holder_is_current(RtosMutexId);
+void rtos_message_queue_put(RtosMessageQueueId message_queue, const void *message)
+        RTOS_REENTRANT;
+bool rtos_message_queue_try_put(RtosMessageQueueId message_queue, const void *message);
+bool rtos_message_queue_put_timeout(RtosMessageQueueId message_queue, const void *message,
+                                              RtosTicksRelative timeout) RTOS_REENTRANT;
+void rtos_message_queue_get(RtosMessageQueueId message_queue, void *message)
+        RTOS_REENTRANT;
+bool rtos_message_queue_try_get(RtosMessageQueueId message_queue, void *message);
+bool rtos_message_queue_get_timeout(RtosMessageQueueId message_queue, void *message,
+                                              RtosTicksRelative timeout) RTOS_REENTRANT;
+
+
+RtosTaskId rtos_task_current(void);
+void rtos_start(void);
+void rtos_yield(void) RTOS_REENTRANT;
+void rtos_task_start(RtosTaskId task);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_RIGEL_H */
\ No newline at end of file
@@ -0,0 +1,961 @@
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+#include <stdint.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "rtos-rigel.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+
+#define CONTEXT_SIZE 10
+#define CONTEXT_V1_IDX 0
+#define CONTEXT_V2_IDX 1
+#define CONTEXT_V3_IDX 2
+#define CONTEXT_V4_IDX 3
+#define CONTEXT_V5_IDX 4
+#define CONTEXT_V6_IDX 5
+#define CONTEXT_V7_IDX 6
+#define CONTEXT_V8_IDX 7
+#define CONTEXT_IP_IDX 8
+#define CONTEXT_PC_IDX 9
+
+#define SCHED_WORDS (((3 - 1U) / 32U) + 1U)
+
+
+#define TIMER_ID_ZERO ((RtosTimerId) UINT8_C(0))
+#define TIMER_ID_MAX ((RtosTimerId) UINT8_C(3 - 1U))
+#define TIMER_WORDS 1U
+#define interrupt_event rtos_internal_interrupt_event
+#define interrupt_event_bitband rtos_internal_interrupt_event_bitband
+#define SCR_PHYSADDR 0xE000ED10
+#define SCR_SEVONPEND (1u << 4)
+
+
+
+#define MESSAGE_QUEUE_ID_NONE ((MessageQueueIdOption)UINT8_C(255))
+
+#define ERROR_ID_NONE ((RtosErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW ((RtosErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID ((RtosErrorId) UINT8_C(2))
+#define ERROR_ID_NOT_HOLDING_MUTEX ((RtosErrorId) UINT8_C(3))
+#define ERROR_ID_DEADLOCK ((RtosErrorId) UINT8_C(4))
+#define ERROR_ID_TASK_FUNCTION_RETURNS ((RtosErrorId) UINT8_C(5))
+#define ERROR_ID_INTERNAL_CURRENT_TASK_INVALID ((RtosErrorId) UINT8_C(6))
+#define ERROR_ID_INTERNAL_INVALID_ID ((RtosErrorId) UINT8_C(7))
+#define ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP ((RtosErrorId) UINT8_C(8))
+#define ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(9))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(10))
+#define ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER ((RtosErrorId) UINT8_C(11))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW ((RtosErrorId) UINT8_C(12))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION ((RtosErrorId) UINT8_C(13))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_CONFIGURATION ((RtosErrorId) UINT8_C(14))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_HEAD ((RtosErrorId) UINT8_C(15))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE ((RtosErrorId) UINT8_C(16))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_ID_IN_WAITERS ((RtosErrorId) UINT8_C(17))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TASKS_BLOCKED_DESPITE_AVAILABLE_MESSAGES ((RtosErrorId) UINT8_C(18))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_WAITING_TASK_IS_NOT_BLOCKED ((RtosErrorId) UINT8_C(19))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGES_POINTER ((RtosErrorId) UINT8_C(20))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGE_SIZE ((RtosErrorId) UINT8_C(21))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH ((RtosErrorId) UINT8_C(22))
+#define ERROR_ID_INTERNAL_PRECONDITION_VIOLATED ((RtosErrorId) UINT8_C(23))
+#define ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED ((RtosErrorId) UINT8_C(24))
+#define ERROR_ID_SEMAPHORE_MAX_INVALID ((RtosErrorId) UINT8_C(25))
+#define ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT ((RtosErrorId) UINT8_C(26))
+#define ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT ((RtosErrorId) UINT8_C(27))
+#define ERROR_ID_SEMAPHORE_MAX_EXCEEDED ((RtosErrorId) UINT8_C(28))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED ((RtosErrorId) UINT8_C(29))
+#define ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX ((RtosErrorId) UINT8_C(30))
+#define ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED ((RtosErrorId) UINT8_C(31))
+#define ERROR_ID_SCHED_EDF_TASK_NOT_PERIODIC ((RtosErrorId) UINT8_C(32))
+#define ERROR_ID_TIMER_TASK_NOT_PERIODIC ((RtosErrorId) UINT8_C(33))
+#define ERROR_ID_POOL_INVALID_BLOCK ((RtosErrorId) UINT8_C(34))
+#define ERROR_ID_BROADCAST_NOT_SUBSCRIBED ((RtosErrorId) UINT8_C(35))
+#define ERROR_ID_BROADCAST_INVALID_POINTER ((RtosErrorId) UINT8_C(36))
+#define ERROR_ID_WORK_QUEUE_INVALID_FUNCTION ((RtosErrorId) UINT8_C(37))
+#define ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS ((RtosErrorId) UINT8_C(38))
+#define ERROR_ID_TIMEBASE_TIME_TOO_FAR ((RtosErrorId) UINT8_C(39))
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+#define current_task rtos_internal_current_task
+#define tasks rtos_internal_tasks
+
+typedef uint32_t* context_t;
+typedef RtosTaskId SchedIndex;
+typedef uint32_t SchedWord;
+typedef uint16_t TicksTimeout;
+typedef uint32_t TimerWord;
+typedef uint8_t PeriodicIndex;
+typedef RtosMutexId MutexIdOption;
+typedef uint8_t MessageQueueIdOption;
+typedef uint8_t BroadcastSubscriptionIndex;
+typedef RtosTaskId TaskIdOption;
+
+
+
+
+struct sched {
+    SchedIndex cur; /* The index of the currently scheduled task */
+    SchedWord runnable[SCHED_WORDS]; /* A bitmap of the runnable tasks, 32 tasks per word */
+};
+struct signal_task {
+    RtosSignalSet signals;
+};
+
+struct signal {
+    struct signal_task tasks[3];
+};
+
+
+
+struct interrupt_event_handler {
+    RtosTaskId task;
+    RtosSignalSet sig_set;
+};
+
+struct mutex {
+    TaskIdOption holder;
+};
+
+/* representation of a message queue instance
+ * sorted by size of fields */
+struct message_queue
+{
+    /* pointer to the array holding the message data
+     * the array contains message_size * queue_length bytes */
+    uint8_t *messages;
+    /* size of each message in bytes */
+    const uint8_t message_size;
+    /* maximum number of messages this queue can hold */
+    const uint8_t queue_length;
+    /* index of the oldest message that has been put into the queue but not yet been retrieved
+     * 0 <= head < queue_length */
+    uint8_t head;
+    /* number of messages that have been put into the queue but not yet been retrieved
+     * 0 <= available < queue_length */
+    uint8_t available;
+};
+/* representation of a broadcast channel instance */
+struct broadcast
+{
+    /* pointer to the array holding the record data
+     * the array contains record_size * length bytes */
+    uint8_t *records;
+    /* size of each record in bytes */
+    uint16_t record_size;
+    /* number of records the channel retains for its subscribers */
+    uint8_t length;
+    /* index of the slot the next record is published into
+     * 0 <= head < length */
+    uint8_t head;
+    /* sequence number of the next record to be published */
+    uint32_t published;
+    /* range of the subscriptions of the channel in the broadcast_subscriptions array */
+    BroadcastSubscriptionIndex first_subscription;
+    BroadcastSubscriptionIndex subscription_count;
+    /* signal set sent to all subscribers when a record is published */
+    RtosSignalSet sig_set;
+};
+
+/* the per-subscriber state of a broadcast channel */
+struct broadcast_subscription
+{
+    RtosTaskId task;
+    /* sequence number of the next record the subscriber retrieves */
+    uint32_t cursor;
+    /* number of records that were overwritten before the subscriber retrieved them */
+    uint32_t lost;
+};
+
+struct task
+{
+    context_t ctx;
+};
+
+
+
+extern void rtos_internal_context_switch(context_t *, context_t *) RTOS_REENTRANT;
+extern void rtos_internal_context_switch_first(context_t *) RTOS_REENTRANT;
+extern void rtos_internal_trampoline(void);
+
+
+
+
+
+
+
+
+
+
+
+
+extern void fatal(RtosErrorId error_id);
+extern void fn_a(void);
+extern void fn_c(void);
+extern void fn_d(void);
+
+
+
+/**
+ * Set up the initial execution context of a task.
+ * This function is invoked exactly once for each task in the system.
+  *
+ * @param ctx An output parameter interpreted by the RTOS as the initial context for each task.
+ *  After this function returns, the RTOS uses the value of ctx for task/context/stack switching.
+ *  The concept of a context and of the context_t type is abstract and may have different implementations on
+ *  different platforms.
+ *  It can be, e.g., a stack pointer or a data structure for user-level task switching as on POSIX.
+ *  This function is expected to set ctx to a value that the RTOS can pass to this platform's implementation of
+ *  context_switch() and context_switch_first().
+ *  The context must be set up such that the destination task of a task switch executes the code at the address fn
+ *  using the memory region defined by stack_base and stack_size as its stack.
+ *  For hardware platforms, this typically requires the following set up steps:
+ *  - The value of ctx points to either the beginning or the end of the stack area.
+ *  - The stack area contains fn so that the context-switch functions can pop it off the stack as a return address to
+ *    begin execution at.
+ *  - Optionally reserve additional stack space if the context-switch functions depend on it.
+ * @param fn Points to a code address at which the given execution context shall start executing.
+ *  This is typically a pointer to a parameter-less function that is assumed to never return.
+ * @param stack_base Points to the lowest address of the memory area this execution context shall use as a stack.
+ * @param stack_size The size in bytes of the stack memory area reserved for this execution context.
+ */
+static void context_init(context_t *const ctx, void (*const fn)(void), uint32_t *const stack_base, const size_t stack_size);
+
+static void sched_set_runnable(const RtosTaskId task_id);
+static void sched_set_blocked(const RtosTaskId task_id);
+static TaskIdOption sched_get_next(void);
+static RtosSignalSet signal_recv(RtosSignalSet *pending_signals, RtosSignalSet requested_signals);
+static void signal_send_set(RtosTaskId task_id, RtosSignalSet signals);
+static RtosSignalSet signal_wait_set(RtosSignalSet requested_signals) RTOS_REENTRANT;
+
+static uint8_t timer_pending_ticks_get_and_clear_atomically(void);
+static void timer_process_one(RtosTimerId timer_id);
+static void timer_enable(RtosTimerId timer_id);
+static void timer_oneshot(RtosTimerId timer_id, RtosTicksRelative timeout);
+static void timer_tick_process(void);
+static void interrupt_event_process(void);
+static inline bool interrupt_application_event_check(void);
+static inline void interrupt_event_wait(void);
+RtosTaskId rtos_internal_interrupt_event_get_next(void);
+
+
+
+static void yield_to(RtosTaskId to) RTOS_REENTRANT;
+static void block(void) RTOS_REENTRANT;
+static void unblock(RtosTaskId task);
+static void stack_group_entry(void);
+
+static uint32_t stack_0[256] __attribute__((aligned(8)));
+static uint32_t stack_group_handlers[256] __attribute__((aligned(8)));
+
+
+
+static struct sched sched_tasks;
+static struct signal signal_tasks;
+static volatile uint8_t timer_pending_ticks;
+RtosTicksAbsolute rtos_timer_current_ticks;
+/*
+ * The state of the timers is laid out as one array per field, indexed by timer ID.
+ * The enabled and overflow flags are packed into bitmaps of 32 timers per word, so that tick processing only visits
+ * the enabled timers.
+ */
+static TimerWord timers_enabled[TIMER_WORDS] = {
+    UINT32_C(0x0),
+};
+static TimerWord timers_overflow[TIMER_WORDS];
+static TicksTimeout timer_expiries[3] = {
+    0,
+    0,
+    0,
+};
+static RtosTicksRelative timer_reloads[3] = {
+    0,
+    0,
+    0,
+};
+/* When the error ID of a timer is not ERROR_ID_NONE, the timer calls the application error function with it */
+static RtosErrorId timer_error_ids[3] = {
+    0,
+    0,
+    0,
+};
+static RtosTaskId timer_task_ids[3] = {
+    RTOS_TASK_ID_A,
+    RTOS_TASK_ID_C,
+    RTOS_TASK_ID_D,
+};
+static RtosSignalSet timer_signal_sets[3] = {
+    RTOS_SIGNAL_SET__TASK_TIMER,
+    RTOS_SIGNAL_SET__TASK_TIMER,
+    RTOS_SIGNAL_SET__TASK_TIMER,
+};
+static bool system_is_idle;
+
+RtosTaskId rtos_internal_current_task;
+struct task rtos_internal_tasks[3];
+static RtosTimerId task_timers[3] = {
+    RTOS_TIMER_ID__TASK_A,
+    RTOS_TIMER_ID__TASK_C,
+    RTOS_TIMER_ID__TASK_D,
+};
+
+/* The tasks of a stack group share the stack and the execution context of the first task of the group */
+static const RtosTaskId task_context_owners[3] = {
+    0,
+    1,
+    1,
+};
+
+static void (*const task_functions[3])(void) = {
+    fn_a,
+    fn_c,
+    fn_d,
+};
+
+/* Whether the current task is a run-to-completion task that is executing its task function */
+static bool run_to_completion;
+
+
+#define context_switch(from, to) rtos_internal_context_switch(to, from)
+#define context_switch_first(to) rtos_internal_context_switch_first(to)
+#define preempt_disable()
+#define preempt_enable()
+#define preempt_clear()
+#define precondition_preemption_disabled()
+#define postcondition_preemption_disabled()
+#define sched_runnable(task_id) ((SCHED_WORD(task_id) & SCHED_BIT(task_id)) != 0)
+#define sched_next_index(cur) (((cur) == sched_max_index()) ? 0 : ((cur) + 1))
+#define sched_get_cur_index() (sched_tasks.cur)
+#define sched_set_cur_index(idx) sched_tasks.cur = (idx)
+#define sched_max_index() (SchedIndex)(3 - 1U)
+#define sched_index_to_taskid(sched_index) (RtosTaskId)(sched_index)
+#define SCHED_WORD(task_id) sched_tasks.runnable[(task_id) / 32U]
+#define SCHED_BIT(task_id) ((SchedWord) 1U << ((task_id) % 32U))
+
+#define signal_wait(requested_signals) signal_wait_set(requested_signals)
+#define signal_peek(pending_signals, requested_signals) (((pending_signals) & (requested_signals)) != RTOS_SIGNAL_SET_EMPTY)
+#define signal_pending(task_id, mask) ((PENDING_SIGNALS(task_id) & mask) == mask)
+#define PENDING_SIGNALS(task_id) signal_tasks.tasks[task_id].signals
+#define timer_pending_ticks_check() ((bool)timer_pending_ticks)
+#define TIMER_WORD(timer_id) ((timer_id) / 32U)
+#define TIMER_BIT(timer_id) ((TimerWord) 1U << ((timer_id) % 32U))
+#define timer_is_enabled(timer_id) ((timers_enabled[TIMER_WORD(timer_id)] & TIMER_BIT(timer_id)) != 0)
+#define timer_is_periodic(timer_id) (timer_reloads[timer_id] > 0)
+#define timer_reload_set(timer_id, ticks) timer_reloads[timer_id] = ticks
+#define timer_disable(timer_id) timers_enabled[TIMER_WORD(timer_id)] &= ~TIMER_BIT(timer_id)
+#define current_timeout() ((TicksTimeout) rtos_timer_current_ticks)
+#define assert_timer_valid(timer) api_assert(timer_id < 3, ERROR_ID_INVALID_ID)
+
+#define interrupt_event_check() (interrupt_application_event_check() || interrupt_system_event_check())
+#define interrupt_system_event_check() timer_pending_ticks_check()
+#define interrupt_event_get_next() rtos_internal_interrupt_event_get_next()
+
+
+#define message_queue_init() do {} while(0)
+#define api_error(error_id) fatal(error_id)
+#define api_assert(expression, error_id) do { if (!(expression)) { api_error(error_id); } } while(0)
+
+#define internal_error(error_id) do { } while(0)
+#define internal_assert(expression, error_id) do { } while(0)
+#define get_current_task() current_task
+#define get_task_context(task_id) &tasks[task_id].ctx
+#define internal_assert_task_valid(task) internal_assert(task < 3, ERROR_ID_INTERNAL_INVALID_ID)
+#define assert_task_valid(task) api_assert(task < 3, ERROR_ID_INVALID_ID)
+#define yield() rtos_yield()
+#define task_context(task_id) get_task_context(task_context_owners[task_id])
+#define interrupt_event_id_to_taskid(interrupt_event_id) ((RtosTaskId)(interrupt_event_id))
+#define mutex_core_block_on(unused_task) rtos_signal_wait(RTOS_SIGNAL_ID__TASK_TIMER)
+#define mutex_core_unblock(task) rtos_signal_send(task, RTOS_SIGNAL_ID__TASK_TIMER)
+#define message_queue_core_block() rtos_signal_wait(RTOS_SIGNAL_ID__TASK_TIMER)
+/* sleep() may return before the timeout occurs because another task may send the timeout signal to indicate that the
+ * state of the message queue has changed.
+ * Therefore, disable the timer whenever sleep() returns to make sure the timer is no longer active.
+ * Note that in the current message-queue implementation, this is not necessary for correctness.
+ * The message-queue implementation handles spurious timer signals gracefully.
+ * However, disabling the timer avoids confusion and provides a minor benefit in run-time efficiency. */
+#define message_queue_core_block_timeout(timeout)\
+do\
+{\
+    rtos_sleep((timeout));\
+    rtos_timer_disable(task_timers[get_current_task()]);\
+}\
+while (0)
+#define message_queue_core_unblock(task) rtos_signal_send((task), RTOS_SIGNAL_ID__TASK_TIMER)
+#define message_queue_core_is_unblocked(task) sched_runnable((task))
+
+
+static void
+context_init(context_t *const ctx, void (*const fn)(void), uint32_t *const stack_base, const size_t stack_size)
+{
+    uint32_t *context;
+    context = stack_base + stack_size - CONTEXT_SIZE;
+    context[CONTEXT_V1_IDX] = (uint32_t) fn;
+    context[CONTEXT_PC_IDX] = (uint32_t) rtos_internal_trampoline;
+    *ctx = context;
+}
+
+static void
+sched_set_runnable(const RtosTaskId task_id)
+{
+    SCHED_WORD(task_id) |= SCHED_BIT(task_id);
+}
+
+static void
+sched_set_blocked(const RtosTaskId task_id)
+{
+    SCHED_WORD(task_id) &= ~SCHED_BIT(task_id);
+}
+
+static RAMFUNC TaskIdOption
+sched_get_next(void)
+{
+    TaskIdOption task;
+    SchedIndex next = sched_get_cur_index();
+    bool found = false;
+
+    /* loop bound: 3 */
+    do
+    {
+        next = sched_next_index(next);
+        found = sched_runnable(sched_index_to_taskid(next));
+    } while (
+        (!found)
+        && (next != (sched_get_cur_index()))
+        );
+
+    if (found)
+    {
+        task = sched_index_to_taskid(next);
+    }
+    else
+    {
+        next = sched_max_index();
+        task = TASK_ID_NONE;
+    }
+
+    sched_set_cur_index(next);
+
+    return task;
+}
+static RtosSignalSet
+signal_recv(RtosSignalSet *const pending_signals, const RtosSignalSet requested_signals)
+{
+    const RtosSignalSet received_signals = *pending_signals & requested_signals;
+
+    precondition_preemption_disabled();
+
+    *pending_signals &= ~received_signals;
+
+    postcondition_preemption_disabled();
+
+    return received_signals;
+}
+
+static RAMFUNC void
+signal_send_set(const RtosTaskId task_id, const RtosSignalSet signals)
+{
+    precondition_preemption_disabled();
+
+    PENDING_SIGNALS(task_id) |= signals;
+    unblock(task_id);
+
+    postcondition_preemption_disabled();
+}
+
+static RtosSignalSet
+signal_wait_set(const RtosSignalSet requested_signals) RTOS_REENTRANT
+{
+    RtosSignalSet received_signals;
+
+    precondition_preemption_disabled();
+    {
+        RtosSignalSet *const pending_signals = &PENDING_SIGNALS(get_current_task());
+
+        if (signal_peek(*pending_signals, requested_signals))
+        {
+            yield();
+        }
+        else
+        {
+            do
+            {
+                block();
+            } while (!signal_peek(*pending_signals, requested_signals));
+        }
+
+        received_signals = signal_recv(pending_signals, requested_signals);
+    }
+    postcondition_preemption_disabled();
+
+    return received_signals;
+}
+/*
+ * This uses an exclusive access rather than masking interrupts, so that it does not delay zero-latency interrupts.
+ * Exception entry and return clear the exclusive monitor, so the strexb fails and the loop retries if timer_tick
+ * interrupts it.
+ */
+static uint8_t
+timer_pending_ticks_get_and_clear_atomically(void)
+{
+    uint32_t pending_ticks;
+    uint32_t failed;
+    /* loop bound: retries */
+    do
+    {
+        asm volatile("ldrexb %0, [%1]" : "=r" (pending_ticks) : "r" (&timer_pending_ticks) : "memory");
+        asm volatile("strexb %0, %1, [%2]" : "=&r" (failed) : "r" (0), "r" (&timer_pending_ticks) : "memory");
+    } while (failed);
+    return (uint8_t) pending_ticks;
+}
+static void
+timer_process_one(const RtosTimerId timer_id)
+{
+    precondition_preemption_disabled();
+
+    if (timer_is_periodic(timer_id))
+    {
+        timer_expiries[timer_id] += timer_reloads[timer_id];
+    }
+    else
+    {
+        timer_disable(timer_id);
+    }
+
+    if (timer_error_ids[timer_id] != ERROR_ID_NONE)
+    {
+        fatal(timer_error_ids[timer_id]);
+    }
+    else
+    {
+        if (signal_pending(timer_task_ids[timer_id], timer_signal_sets[timer_id]))
+        {
+            timers_overflow[TIMER_WORD(timer_id)] |= TIMER_BIT(timer_id);
+        }
+        signal_send_set(timer_task_ids[timer_id], timer_signal_sets[timer_id]);
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_enable(const RtosTimerId timer_id)
+{
+    precondition_preemption_disabled();
+
+    if (timer_reloads[timer_id] == 0)
+    {
+        timer_process_one(timer_id);
+    }
+    else
+    {
+        timer_expiries[timer_id] = current_timeout() + timer_reloads[timer_id];
+        timers_enabled[TIMER_WORD(timer_id)] |= TIMER_BIT(timer_id);
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_oneshot(const RtosTimerId timer_id, const RtosTicksRelative timeout)
+{
+    precondition_preemption_disabled();
+
+    timer_reload_set(timer_id, timeout);
+    timer_enable(timer_id);
+    timer_reload_set(timer_id, 0);
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_tick_process(void)
+{
+    precondition_preemption_disabled();
+    {
+        const uint8_t pending_ticks = timer_pending_ticks_get_and_clear_atomically();
+
+        if (pending_ticks > 1)
+        {
+            fatal(ERROR_ID_TICK_OVERFLOW);
+        }
+
+        if (pending_ticks)
+        {
+            RtosTimerId word, timer_id;
+            TimerWord enabled;
+            TicksTimeout timeout;
+
+            rtos_timer_current_ticks++;
+
+            timeout = current_timeout();
+
+            /* loop bound: 1 */
+            for (word = 0; word < TIMER_WORDS; word++)
+            {
+                /* Visit the enabled timers of the word, up to the last one */
+                enabled = timers_enabled[word];
+                /* loop bound: 32 */
+                for (timer_id = (RtosTimerId) (word * 32U); enabled != 0; timer_id++, enabled >>= 1)
+                {
+                    if ((enabled & 1U) != 0 && timer_expiries[timer_id] == timeout)
+                    {
+                        timer_process_one(timer_id);
+                    }
+                }
+            }
+        }
+    }
+    postcondition_preemption_disabled();
+}
+static void
+interrupt_event_process(void)
+{
+}
+
+static inline bool
+interrupt_application_event_check(void)
+{
+    return false;
+}
+
+/*
+ * Waiting for an interrupt event must not mask interrupts, so that the RTOS never delays zero-latency interrupts.
+ * Instead, SEVONPEND makes every interrupt that becomes pending set the event register.
+ * An interrupt that occurs after the check therefore causes the wfe to return immediately rather than being lost.
+ * Spurious returns from wfe are harmless, as the caller checks for interrupt events again.
+ */
+static inline void
+interrupt_event_wait(void)
+{
+    volatile uint32_t *scr = (uint32_t *) SCR_PHYSADDR;
+
+    *scr |= SCR_SEVONPEND;
+    if (!interrupt_event_check())
+    {
+        asm volatile("wfe");
+    }
+}
+RAMFUNC RtosTaskId
+rtos_internal_interrupt_event_get_next(void)
+{
+    TaskIdOption next;
+
+    /* loop bound: 3 + 1 */
+    for (;;)
+    {
+        interrupt_event_process();
+        timer_tick_process();
+        next = sched_get_next();
+
+        if (next == TASK_ID_NONE)
+        {
+            system_is_idle = true;
+            interrupt_event_wait();
+        }
+        else
+        {
+            system_is_idle = false;
+            break;
+        }
+    }
+
+    internal_assert_task_valid(next);
+
+    return next;
+}
+
+
+static void
+yield_to(const RtosTaskId to) RTOS_REENTRANT
+{
+    const RtosTaskId from = get_current_task();
+
+    internal_assert(to < 3, ERROR_ID_INTERNAL_INVALID_ID);
+
+    current_task = to;
+    context_switch(task_context(from), task_context(to));
+}
+
+static void
+block(void) RTOS_REENTRANT
+{
+    sched_set_blocked(get_current_task());
+    rtos_yield();
+}
+
+static RAMFUNC void
+unblock(const RtosTaskId task)
+{
+    sched_set_runnable(task);
+}
+
+/* entry point trampolines */
+static void
+entry_a(void)
+{
+    
+    fn_a();
+
+    api_error(ERROR_ID_TASK_FUNCTION_RETURNS);
+}
+
+/* Entry point of the shared context of each stack group.
+ * Whichever task of the group the scheduler selects runs in this context.
+ * Each start signal it has received activates its task function once, which must run to completion without yielding
+ * or blocking.
+ * Therefore, the stack is empty again whenever the context switches to another task, so that all tasks of the group can
+ * share it. */
+static void
+stack_group_entry(void)
+{
+    for (;;)
+    {
+        const RtosTaskId task = get_current_task();
+
+        if (signal_recv(&PENDING_SIGNALS(task), RTOS_SIGNAL_SET__RTOS_UTIL) !=
+                RTOS_SIGNAL_SET_EMPTY)
+        {
+            run_to_completion = true;
+            task_functions[task]();
+            run_to_completion = false;
+        }
+        else
+        {
+            block();
+        }
+    }
+}
+
+
+
+
+
+
+RtosSignalSet
+rtos_signal_wait_set(const RtosSignalSet requested_signals) RTOS_REENTRANT
+{
+    RtosSignalSet received_signals;
+
+    preempt_disable();
+
+    received_signals = signal_wait_set(requested_signals);
+
+    preempt_enable();
+
+    return received_signals;
+}
+
+RtosSignalSet
+rtos_signal_poll_set(const RtosSignalSet requested_signals)
+{
+    RtosSignalSet *const pending_signals = &PENDING_SIGNALS(get_current_task());
+    RtosSignalSet received_signals;
+
+    preempt_disable();
+
+    received_signals = signal_recv(pending_signals, requested_signals);
+
+    preempt_enable();
+
+    return received_signals;
+}
+
+RtosSignalSet
+rtos_signal_peek_set(const RtosSignalSet requested_signals)
+{
+    const RtosSignalSet pending_signals = PENDING_SIGNALS(get_current_task());
+    return pending_signals & requested_signals;
+}
+
+RAMFUNC void
+rtos_signal_send_set(const RtosTaskId task_id, const RtosSignalSet signals)
+{
+    assert_task_valid(task_id);
+
+    preempt_disable();
+
+    signal_send_set(task_id, signals);
+
+    preempt_enable();
+}
+void
+rtos_timer_tick(void)
+{
+    if (timer_pending_ticks < 2)
+    {
+        timer_pending_ticks += 1;
+    }
+}
+void
+rtos_sleep(const RtosTicksRelative ticks) RTOS_REENTRANT
+{
+    preempt_disable();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    signal_wait(RTOS_SIGNAL_ID__TASK_TIMER);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_enable(const RtosTimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_enable(timer_id);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_disable(const RtosTimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_disable(timer_id);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_oneshot(const RtosTimerId timer_id, const RtosTicksRelative timeout)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_oneshot(timer_id, timeout);
+
+    preempt_enable();
+}
+
+bool
+rtos_timer_check_overflow(const RtosTimerId timer_id)
+{
+    bool r;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    r = (timers_overflow[TIMER_WORD(timer_id)] & TIMER_BIT(timer_id)) != 0;
+    timers_overflow[TIMER_WORD(timer_id)] &= ~TIMER_BIT(timer_id);
+
+    preempt_enable();
+
+    return r;
+}
+
+RtosTicksRelative
+rtos_timer_remaining(const RtosTimerId timer_id)
+{
+    RtosTicksRelative remaining;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    remaining = timer_is_enabled(timer_id) ? timer_expiries[timer_id] - current_timeout() : 0;
+
+    preempt_enable();
+
+    return remaining;
+}
+
+/* Configuration functions */
+void
+rtos_timer_reload_set(const RtosTimerId timer_id, const RtosTicksRelative reload)
+{
+    assert_timer_valid(timer_id);
+
+    timer_reload_set(timer_id, reload);
+}
+
+void
+rtos_timer_signal_set(const RtosTimerId timer_id, const RtosTaskId task_id, const RtosSignalSet signal_set)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_error_ids[timer_id] = ERROR_ID_NONE;
+    timer_task_ids[timer_id] = task_id;
+    timer_signal_sets[timer_id] = signal_set;
+
+    preempt_enable();
+}
+
+void
+rtos_timer_error_set(const RtosTimerId timer_id, const RtosErrorId error_id)
+{
+    assert_timer_valid(timer_id);
+
+    timer_error_ids[timer_id] = error_id;
+}
+
+
+
+RtosTaskId
+rtos_task_current(void)
+{
+    return get_current_task();
+}
+void
+rtos_task_start(const RtosTaskId task)
+{
+    assert_task_valid(task);
+    rtos_signal_send(task, RTOS_SIGNAL_ID__RTOS_UTIL);
+}
+
+void
+rtos_yield(void) RTOS_REENTRANT
+{
+    RtosTaskId to;
+
+    api_assert(!run_to_completion, ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS);
+
+    to = interrupt_event_get_next();
+    yield_to(to);
+}
+
+void
+rtos_start(void)
+{
+    message_queue_init();
+
+    context_init(get_task_context(0), entry_a, stack_0, 256);
+    sched_set_runnable(0);
+    sched_set_runnable(1);
+    sched_set_runnable(2);
+    context_init(get_task_context(1), stack_group_entry, stack_group_handlers, 256);
+
+    context_switch_first(task_context(RTOS_TASK_ID_ZERO));
+}
@@ -0,0 +1,337 @@
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+#include "rtos-sched-edf-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+#define SCHED_INDEX_ZERO ((SchedIndex) TASK_ID_ZERO)
+#define SCHED_HEAP_POS_NONE ((SchedIndex) TASK_ID_NONE)
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+typedef uint8_t TaskId;
+typedef uint32_t TicksAbsolute;
+typedef TaskId SchedIndex;
+typedef TaskId TaskIdOption;
+
+struct sched_task {
+    TaskIdOption blocked_on;
+    SchedIndex heap_pos;
+    TicksAbsolute deadline;
+};
+
+/*
+ * The heap contains the tasks that are runnable or blocked on a specific task.
+ * It is a binary min-heap ordered by absolute deadline (ties are broken by task ID), so its root is the task with the
+ * earliest deadline.
+ */
+struct sched {
+    struct sched_task tasks[40];
+    TaskId heap[40];
+    SchedIndex heap_size;
+};
+
+
+
+
+
+static bool sched_task_before(const TaskId task_a, const TaskId task_b);
+static void sched_heap_swap(SchedIndex pos_a, SchedIndex pos_b);
+static void sched_heap_sift_up(SchedIndex pos);
+static void sched_heap_sift_down(SchedIndex pos);
+static void sched_heap_insert(const TaskId task_id);
+static void sched_heap_remove(const TaskId task_id);
+static TaskIdOption sched_resolve_blocked_on(TaskId task_id);
+static void sched_set_runnable(const TaskId task_id);
+static void sched_set_blocked_on(const TaskId task_id, const TaskId blocker);
+static void sched_set_deadline(const TaskId task_id, const TicksAbsolute deadline);
+static TaskIdOption sched_get_next(void);
+
+
+static struct sched sched_tasks = {
+    {
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+    },
+    { 0 },
+    0
+};
+
+
+#define sched_set_blocked(task_id) sched_set_blocked_on(task_id, TASK_ID_NONE)
+#define sched_runnable(task_id) (SCHED_OBJ(task_id).blocked_on == (task_id))
+#define sched_in_heap(task_id) (SCHED_OBJ(task_id).heap_pos != SCHED_HEAP_POS_NONE)
+#define sched_deadline_get(task_id) (SCHED_OBJ(task_id).deadline)
+/* Deadlines are compared modulo the tick counter wrap-around, so they must lie within half its range of each other. */
+#define sched_deadline_before(deadline_a, deadline_b) ((int32_t) ((deadline_a) - (deadline_b)) < 0)
+#define SCHED_OBJ(task_id) sched_tasks.tasks[task_id]
+#define preempt_disable()
+#define preempt_enable()
+
+static bool
+sched_task_before(const TaskId task_a, const TaskId task_b)
+{
+    const TicksAbsolute deadline_a = SCHED_OBJ(task_a).deadline;
+    const TicksAbsolute deadline_b = SCHED_OBJ(task_b).deadline;
+
+    return sched_deadline_before(deadline_a, deadline_b) || (deadline_a == deadline_b && task_a < task_b);
+}
+
+static void
+sched_heap_swap(const SchedIndex pos_a, const SchedIndex pos_b)
+{
+    const TaskId task_a = sched_tasks.heap[pos_a];
+    const TaskId task_b = sched_tasks.heap[pos_b];
+
+    sched_tasks.heap[pos_a] = task_b;
+    sched_tasks.heap[pos_b] = task_a;
+    SCHED_OBJ(task_a).heap_pos = pos_b;
+    SCHED_OBJ(task_b).heap_pos = pos_a;
+}
+
+static void
+sched_heap_sift_up(SchedIndex pos)
+{
+    SchedIndex parent;
+
+    /* loop bound: 40 */
+    while (pos > SCHED_INDEX_ZERO)
+    {
+        parent = (pos - 1U) / 2U;
+        if (!sched_task_before(sched_tasks.heap[pos], sched_tasks.heap[parent]))
+        {
+            break;
+        }
+        sched_heap_swap(pos, parent);
+        pos = parent;
+    }
+}
+
+static void
+sched_heap_sift_down(SchedIndex pos)
+{
+    SchedIndex child;
+
+    /* Checking against half the heap size first ensures that computing the child index cannot overflow */
+    /* loop bound: 40 */
+    while (pos < sched_tasks.heap_size / 2U)
+    {
+        child = (2U * pos) + 1U;
+        if (child + 1U < sched_tasks.heap_size &&
+            sched_task_before(sched_tasks.heap[child + 1U], sched_tasks.heap[child]))
+        {
+            child++;
+        }
+        if (!sched_task_before(sched_tasks.heap[child], sched_tasks.heap[pos]))
+        {
+            break;
+        }
+        sched_heap_swap(pos, child);
+        pos = child;
+    }
+}
+
+static void
+sched_heap_insert(const TaskId task_id)
+{
+    const SchedIndex pos = sched_tasks.heap_size;
+
+    sched_tasks.heap_size++;
+    sched_tasks.heap[pos] = task_id;
+    SCHED_OBJ(task_id).heap_pos = pos;
+    sched_heap_sift_up(pos);
+}
+
+static void
+sched_heap_remove(const TaskId task_id)
+{
+    const SchedIndex pos = SCHED_OBJ(task_id).heap_pos;
+    TaskId last;
+
+    sched_tasks.heap_size--;
+    SCHED_OBJ(task_id).heap_pos = SCHED_HEAP_POS_NONE;
+    if (pos != sched_tasks.heap_size)
+    {
+        last = sched_tasks.heap[sched_tasks.heap_size];
+        sched_tasks.heap[pos] = last;
+        SCHED_OBJ(last).heap_pos = pos;
+        sched_heap_sift_up(pos);
+        sched_heap_sift_down(SCHED_OBJ(last).heap_pos);
+    }
+}
+
+/*
+ * Follow the chain of tasks that the given task is blocked on to the runnable task at its end.
+ * Returns TASK_ID_NONE if the chain ends in a task that is blocked on no specific task.
+ */
+static RAMFUNC TaskIdOption
+sched_resolve_blocked_on(TaskId task_id)
+{
+    TaskIdOption next_task;
+
+    /* loop bound: 40 */
+    for (;;)
+    {
+        next_task = SCHED_OBJ(task_id).blocked_on;
+        if (next_task == task_id || next_task == TASK_ID_NONE)
+        {
+            return next_task;
+        }
+        task_id = next_task;
+    }
+}
+
+static void
+sched_set_runnable(const TaskId task_id)
+{
+    SCHED_OBJ(task_id).blocked_on = task_id;
+    if (!sched_in_heap(task_id))
+    {
+        sched_heap_insert(task_id);
+    }
+}
+
+static void
+sched_set_blocked_on(const TaskId task_id, const TaskId blocker)
+{
+    SCHED_OBJ(task_id).blocked_on = blocker;
+    if (blocker == TASK_ID_NONE)
+    {
+        if (sched_in_heap(task_id))
+        {
+            sched_heap_remove(task_id);
+        }
+    }
+    else if (!sched_in_heap(task_id))
+    {
+        sched_heap_insert(task_id);
+    }
+}
+
+static void
+sched_set_deadline(const TaskId task_id, const TicksAbsolute deadline)
+{
+    SCHED_OBJ(task_id).deadline = deadline;
+    if (sched_in_heap(task_id))
+    {
+        sched_heap_sift_up(SCHED_OBJ(task_id).heap_pos);
+        sched_heap_sift_down(SCHED_OBJ(task_id).heap_pos);
+    }
+}
+
+static RAMFUNC TaskIdOption
+sched_get_next(void)
+{
+    /* NOTE: In the case where assume_runnable is true and no runnable
+       tasks are found, then an undefined task will be returned from this
+       function.
+    */
+    TaskIdOption task = TASK_ID_NONE;
+    TaskIdOption candidate;
+    TaskIdOption earliest = TASK_ID_NONE;
+    SchedIndex pos;
+
+    if (sched_tasks.heap_size > 0)
+    {
+        task = sched_resolve_blocked_on(sched_tasks.heap[0]);
+        if (task == TASK_ID_NONE)
+        {
+            /*
+             * The task with the earliest deadline is blocked on a task that waits for something other than a task.
+             * This is rare, so fall back to searching the heap for the earliest task whose chain ends in a runnable
+             * task.
+             */
+            /* loop bound: 40 */
+            for (pos = 1; pos < sched_tasks.heap_size; pos++)
+            {
+                candidate = sched_resolve_blocked_on(sched_tasks.heap[pos]);
+                if (candidate != TASK_ID_NONE &&
+                    (earliest == TASK_ID_NONE || sched_task_before(sched_tasks.heap[pos], earliest)))
+                {
+                    earliest = sched_tasks.heap[pos];
+                    task = candidate;
+                }
+            }
+        }
+    }
+
+    return  task;
+}
+
+
+
+void
+pub_sched_set_runnable(const TaskId task_id)
+{
+    sched_set_runnable(task_id);
+}
+
+void
+pub_sched_set_blocked(const TaskId task_id)
+{
+    sched_set_blocked(task_id);
+}
+
+void
+pub_sched_set_blocked_on(const TaskId task_id, const TaskId blocked_on)
+{
+    sched_set_blocked_on(task_id, blocked_on);
+}
+
+void
+pub_sched_set_deadline(const TaskId task_id, const TicksAbsolute deadline)
+{
+    sched_set_deadline(task_id, deadline);
+}
+
+TaskIdOption
+pub_sched_get_next(void)
+{
+    return sched_get_next();
+}
+
+struct sched * pub_sched_tasks = &sched_tasks;
@@ -0,0 +1,32 @@
+#ifndef RTOS_SCHED_EDF_TEST_H
+#define RTOS_SCHED_EDF_TEST_H
+
+
+
+
+
+
+
+
+
+#define REENTRANT 
+
+#define TASK_ID_ZERO ((TaskId) UINT8_C(0))
+#define TASK_ID_MAX ((TaskId)UINT8_C(40 - 1))
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_SCHED_EDF_TEST_H */
\ No newline at end of file
@@ -0,0 +1,126 @@
+
+
+#include <stdint.h>
+#include "rtos-sched-prio-inherit-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+#define SCHED_INDEX_ZERO ((SchedIndex) TASK_ID_ZERO)
+
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+typedef uint8_t TaskId;
+typedef TaskId SchedIndex;
+typedef TaskId TaskIdOption;
+
+struct sched_task {
+    TaskIdOption blocked_on;
+};
+
+/*
+ * NOTE: An RTOS variant using the scheduler must ensure that tasks
+ * array is sorted by priority.
+ */
+struct sched {
+    struct sched_task tasks[40];
+};
+
+
+
+
+
+static void sched_set_runnable(const TaskId task_id);
+static void sched_set_blocked_on(const TaskId task_id, const TaskId blocker);
+static TaskIdOption sched_get_next(void);
+
+
+
+static struct sched sched_tasks;
+
+
+
+#define sched_set_blocked(task_id) sched_set_blocked_on(task_id, TASK_ID_NONE)
+#define sched_runnable(task_id) (SCHED_OBJ(task_id).blocked_on == (task_id))
+#define sched_max_index() (SchedIndex)(40 - 1U)
+#define sched_index_to_taskid(sched_index) (TaskId)(sched_index)
+#define sched_taskid_to_index(task_id) (SchedIndex)(task_id)
+#define SCHED_OBJ(task_id) sched_tasks.tasks[task_id]
+
+#define preempt_disable()
+#define preempt_enable()
+
+static void
+sched_set_runnable(const TaskId task_id)
+{
+    SCHED_OBJ(task_id).blocked_on = task_id;
+}
+
+static void
+sched_set_blocked_on(const TaskId task_id, const TaskId blocker)
+{
+    SCHED_OBJ(task_id).blocked_on = blocker;
+}
+
+static RAMFUNC TaskIdOption
+sched_get_next(void)
+{
+    /* NOTE: In the case where assume_runnable is true and no runnable
+       tasks are found, then an undefined task will be returned from this
+       function.
+    */
+    TaskIdOption task, next_task;
+    SchedIndex idx;
+
+    /* loop bound: 40 */
+    for (idx = SCHED_INDEX_ZERO; idx <= sched_max_index(); idx++)
+    {
+        task = sched_index_to_taskid(idx);
+        /* loop bound: 40 */
+        do
+        {
+            next_task = SCHED_OBJ(task).blocked_on;
+            if (next_task == task)
+            {
+                goto found;
+            }
+            task = next_task;
+        }
+        while (task != TASK_ID_NONE);
+    }
+found:
+    return  task;
+}
+
+
+
+
+void
+pub_sched_set_runnable(const TaskId task_id)
+{
+    sched_set_runnable(task_id);
+}
+
+void
+pub_sched_set_blocked(const TaskId task_id)
+{
+    sched_set_blocked(task_id);
+}
+
+void
+pub_sched_set_blocked_on(const TaskId task_id, const TaskId blocked_on)
+{
+    sched_set_blocked_on(task_id, blocked_on);
+}
+
+TaskIdOption
+pub_sched_get_next(void)
+{
+    return sched_get_next();
+}
+
+struct sched * pub_sched_tasks = &sched_tasks;
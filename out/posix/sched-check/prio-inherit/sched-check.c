@@ -0,0 +1,352 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+
+/*
+ * Scheduler equivalence checker.
+ *
+ * The system links this file with a scheduler test module (e.g. posix.rtos-sched-rr-test) into a native executable.
+ * It drives the generated scheduler through its pub_sched_* functions and mirrors every operation on a
+ * straightforward reference model of the scheduling policy, comparing the task selected by both after each step.
+ *
+ * The check runs in two phases:
+ *
+ *  - An exhaustive phase enumerates every combination of task states of 'exhaustive_tasks' tasks, half of them taken
+ *    from the start and half from the end of the task array so that the combinations straddle bitmap words and wrap
+ *    around in round-robin order.
+ *    All other tasks are blocked.
+ *    A task's state is runnable, blocked, or (with priority inheritance) blocked on each of the other tasks and (with
+ *    EDF) combined with one of a small set of deadlines, so that deadlines tie.
+ *    States with cycles of tasks blocked on each other are skipped, as the mutex layer never creates them.
+ *    Each combination is checked from every position the history of selections can leave the scheduler in with
+ *    respect to the enumerated tasks: after each of them for round-robin, and with each combination of offsets of
+ *    the priority levels containing them for prio_inherit_rr.
+ *    The scheduler is moved to a position by selecting a single runnable task before the combination is applied.
+ *  - A randomized phase then applies 'samples' random operations to all tasks.
+ *
+ * The remaining time slice state is not enumerated but carried over from one state to the next, and each state is
+ * checked with several consecutive selections.
+ *
+ * The executable prints the number of states checked per second for each phase and exits with status 1 on the first
+ * mismatch, after printing the state it occurred in.
+ * 'x.py test sched-check' builds and runs all such systems.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define TASKS 40U
+#define EXHAUSTIVE_TASKS 7U
+#define SAMPLES 1000000UL
+#define TASK_NONE ((TaskId) UINT8_MAX)
+/* Runnable, blocked, or blocked on one of the other exhaustive tasks */
+#define STATE_CHOICES (EXHAUSTIVE_TASKS + 1U)
+#define DEADLINE_CHOICES 1U
+
+typedef uint8_t TaskId;
+
+/* Provided by the scheduler test module */
+extern void pub_sched_set_runnable(TaskId task_id);
+extern void pub_sched_set_blocked(TaskId task_id);
+extern void pub_sched_set_blocked_on(TaskId task_id, TaskId blocked_on);
+extern TaskId pub_sched_get_next(void);
+
+/* The reference model. Each task is blocked on itself when runnable and on TASK_NONE when blocked. */
+static TaskId ref_blocked_on[TASKS];
+
+static uint32_t random_state = 1U;
+static unsigned long states;
+
+static uint32_t
+random_next(void)
+{
+    /* xorshift32 */
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+/* Follow the chain of tasks the given task is blocked on; returns the runnable task at its end or TASK_NONE. */
+static TaskId
+ref_resolve(TaskId task_id)
+{
+    while (task_id != TASK_NONE && ref_blocked_on[task_id] != task_id)
+    {
+        task_id = ref_blocked_on[task_id];
+    }
+    return task_id;
+}
+
+static TaskId
+ref_get_next(void)
+{
+    /* The end of the blocked-on chain of the highest priority task whose chain ends in a runnable task */
+    TaskId task_id;
+
+    for (task_id = 0; task_id < TASKS; task_id++)
+    {
+        if (ref_resolve(task_id) != TASK_NONE)
+        {
+            return ref_resolve(task_id);
+        }
+    }
+    return TASK_NONE;
+}
+
+static void
+set_runnable(const TaskId task_id)
+{
+    pub_sched_set_runnable(task_id);
+    ref_blocked_on[task_id] = task_id;
+}
+
+static void
+set_blocked(const TaskId task_id)
+{
+    pub_sched_set_blocked(task_id);
+    ref_blocked_on[task_id] = TASK_NONE;
+}
+
+static void
+set_blocked_on(const TaskId task_id, const TaskId blocker)
+{
+    pub_sched_set_blocked_on(task_id, blocker);
+    ref_blocked_on[task_id] = blocker;
+}
+
+/* Whether blocking the given task on the given blocker would create a cycle */
+static bool
+creates_cycle(const TaskId task_id, TaskId blocker)
+{
+    while (blocker != TASK_NONE && blocker != task_id && ref_blocked_on[blocker] != blocker)
+    {
+        blocker = ref_blocked_on[blocker];
+    }
+    return blocker == task_id;
+}
+
+static void
+fail(const char *const phase, const TaskId expected, const TaskId actual)
+{
+    TaskId task_id;
+
+    printf("sched-check: prio_inherit %s: mismatch after %lu states: expected task %u, got %u\n",
+           phase, states, expected, actual);
+    printf("sched-check: blocked on:");
+    for (task_id = 0; task_id < TASKS; task_id++)
+    {
+        printf(" %u", ref_blocked_on[task_id]);
+    }
+    printf("\n");
+    exit(1);
+}
+
+static void
+check_next(const char *const phase)
+{
+    const TaskId expected = ref_get_next();
+    const TaskId actual = pub_sched_get_next();
+
+    if (actual != expected)
+    {
+        fail(phase, expected, actual);
+    }
+}
+
+/* Check the selections in the current state; they also advance the history-dependent state */
+static void
+check_state(const char *const phase)
+{
+    check_next(phase);
+    states++;
+}
+
+static void
+report(const char *const phase, const clock_t start)
+{
+    const double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    printf("sched-check: prio_inherit %s: %lu states in %.3f s (%.0f states/s)\n",
+           phase, states, seconds, seconds > 0 ? states / seconds : 0.0);
+}
+
+/* Map the index of an exhaustively enumerated task to its task ID: the first half from the start of the task array,
+ * the rest from its end. */
+static TaskId
+exhaustive_task(const TaskId idx)
+{
+    return idx < EXHAUSTIVE_TASKS / 2U ? idx : TASKS - EXHAUSTIVE_TASKS + idx;
+}
+
+/* Apply one task's enumerated choice; returns false if its state would create a blocked-on cycle */
+static bool
+apply_choice(const TaskId idx, const unsigned int choice)
+{
+    const TaskId task_id = exhaustive_task(idx);
+    const unsigned int state = choice / DEADLINE_CHOICES;
+    TaskId blocker;
+
+    if (state == 0)
+    {
+        set_runnable(task_id);
+    }
+    else if (state == 1)
+    {
+        set_blocked(task_id);
+    }
+    else
+    {
+        /* Skip the task itself */
+        blocker = state - 2U < idx ? state - 2U : state - 1U;
+        blocker = exhaustive_task(blocker);
+        if (creates_cycle(task_id, blocker))
+        {
+            return false;
+        }
+        set_blocked_on(task_id, blocker);
+    }
+    return true;
+}
+
+
+/* Selections do not depend on their history */
+static unsigned int
+exhaustive_positions(void)
+{
+    return 1;
+}
+
+/* Move the scheduler to the given position; all tasks must be blocked */
+static void
+set_position(unsigned int position)
+{
+    (void) position;
+}
+
+static void
+check_exhaustive(void)
+{
+    unsigned int choices[EXHAUSTIVE_TASKS] = { 0 };
+    unsigned int position = 0;
+    const unsigned int positions = exhaustive_positions();
+    TaskId idx;
+    bool valid;
+    const clock_t start = clock();
+
+    states = 0;
+    for (;;)
+    {
+        /*
+         * Blocking all enumerated tasks first means that a cycle can only be closed by the task whose choice closes
+         * it, and that an applied state never contains one.
+         */
+        for (idx = 0; idx < EXHAUSTIVE_TASKS; idx++)
+        {
+            set_blocked(exhaustive_task(idx));
+        }
+        set_position(position);
+        valid = true;
+        for (idx = 0; idx < EXHAUSTIVE_TASKS && valid; idx++)
+        {
+            valid = apply_choice(idx, choices[idx]);
+        }
+        if (valid)
+        {
+            check_state("exhaustive");
+        }
+
+        for (idx = 0; idx < EXHAUSTIVE_TASKS; idx++)
+        {
+            if (++choices[idx] < STATE_CHOICES * DEADLINE_CHOICES)
+            {
+                break;
+            }
+            choices[idx] = 0;
+        }
+        if (idx == EXHAUSTIVE_TASKS && ++position == positions)
+        {
+            break;
+        }
+    }
+    report("exhaustive", start);
+}
+
+static void
+check_random(void)
+{
+    unsigned long sample;
+    TaskId task_id;
+    TaskId blocker;
+    const clock_t start = clock();
+
+    states = 0;
+    for (sample = 0; sample < SAMPLES; sample++)
+    {
+        task_id = random_next() % TASKS;
+        switch (random_next() % 4U)
+        {
+        case 0:
+            set_runnable(task_id);
+            break;
+        case 1:
+            set_blocked(task_id);
+            break;
+        case 2:
+            blocker = random_next() % TASKS;
+            if (blocker != task_id && !creates_cycle(task_id, blocker))
+            {
+                set_blocked_on(task_id, blocker);
+            }
+            break;
+        default:
+            break;
+        }
+        check_state("random");
+    }
+    report("random", start);
+}
+
+int
+main(void)
+{
+    TaskId task_id;
+
+    for (task_id = 0; task_id < TASKS; task_id++)
+    {
+        set_blocked(task_id);
+    }
+
+    check_exhaustive();
+    check_random();
+    printf("sched-check: prio_inherit: passed\n");
+
+    return 0;
+}
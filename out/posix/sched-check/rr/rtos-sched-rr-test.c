@@ -0,0 +1,113 @@
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+#define SCHED_WORDS (((40 - 1U) / 32U) + 1U)
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+typedef uint32_t SchedWord;
+typedef uint8_t TaskId;
+typedef TaskId TaskIdOption;
+typedef TaskId SchedIndex;
+
+struct sched {
+    SchedIndex cur; /* The index of the currently scheduled task */
+    SchedWord runnable[SCHED_WORDS]; /* A bitmap of the runnable tasks, 32 tasks per word */
+};
+
+
+
+
+
+static void sched_set_runnable(const TaskId task_id);
+static void sched_set_blocked(const TaskId task_id);
+static TaskIdOption sched_get_next(void);
+
+
+static struct sched sched_tasks;
+
+
+#define sched_runnable(task_id) ((SCHED_WORD(task_id) & SCHED_BIT(task_id)) != 0)
+#define sched_next_index(cur) (((cur) == sched_max_index()) ? 0 : ((cur) + 1))
+#define sched_get_cur_index() (sched_tasks.cur)
+#define sched_set_cur_index(idx) sched_tasks.cur = (idx)
+#define sched_max_index() (SchedIndex)(40 - 1U)
+#define sched_index_to_taskid(sched_index) (TaskId)(sched_index)
+#define SCHED_WORD(task_id) sched_tasks.runnable[(task_id) / 32U]
+#define SCHED_BIT(task_id) ((SchedWord) 1U << ((task_id) % 32U))
+#define preempt_disable()
+#define preempt_enable()
+
+static void
+sched_set_runnable(const TaskId task_id)
+{
+    SCHED_WORD(task_id) |= SCHED_BIT(task_id);
+}
+
+static void
+sched_set_blocked(const TaskId task_id)
+{
+    SCHED_WORD(task_id) &= ~SCHED_BIT(task_id);
+}
+
+static RAMFUNC TaskIdOption
+sched_get_next(void)
+{
+    TaskIdOption task;
+    SchedIndex next = sched_get_cur_index();
+    bool found = false;
+
+    /* loop bound: 40 */
+    do
+    {
+        next = sched_next_index(next);
+        found = sched_runnable(sched_index_to_taskid(next));
+    } while (
+        (!found)
+        && (next != (sched_get_cur_index()))
+        );
+
+    if (found)
+    {
+        task = sched_index_to_taskid(next);
+    }
+    else
+    {
+        next = sched_max_index();
+        task = TASK_ID_NONE;
+    }
+
+    sched_set_cur_index(next);
+
+    return task;
+}
+
+
+
+void
+pub_sched_set_runnable(const TaskId task_id)
+{
+    sched_set_runnable(task_id);
+}
+
+void
+pub_sched_set_blocked(const TaskId task_id)
+{
+    sched_set_blocked(task_id);
+}
+
+TaskIdOption
+pub_sched_get_next(void)
+{
+    return sched_get_next();
+}
+
+struct sched * pub_sched_tasks = &sched_tasks;
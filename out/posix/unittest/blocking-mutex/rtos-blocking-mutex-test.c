@@ -0,0 +1,243 @@
+
+
+#include <stddef.h>
+#include "rtos-blocking-mutex-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+#define MUTEX_ID_NONE ((MutexIdOption) UINT8_MAX)
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+typedef RtosMutexId MutexIdOption;
+typedef RtosTaskId TaskIdOption;
+
+
+struct mutex {
+    TaskIdOption holder;
+};
+
+
+
+
+
+static bool mutex_try_lock(RtosMutexId m);
+static bool mutex_acquire(RtosMutexId m) RTOS_REENTRANT;
+static void mutex_release(RtosMutexId m);
+static void mutex_core_block_on(RtosTaskId task) RTOS_REENTRANT;
+static void mutex_core_unblock(RtosTaskId task);
+static RtosTaskId get_current_task(void);
+
+static struct mutex mutexes[10] = {
+    {TASK_ID_NONE},
+    {TASK_ID_NONE},
+    {TASK_ID_NONE},
+    {TASK_ID_NONE},
+    {TASK_ID_NONE},
+    {TASK_ID_NONE},
+    {TASK_ID_NONE},
+    {TASK_ID_NONE},
+    {TASK_ID_NONE},
+    {TASK_ID_NONE},
+};
+static MutexIdOption mutex_waiters[3] = {
+    MUTEX_ID_NONE,
+    MUTEX_ID_NONE,
+    MUTEX_ID_NONE,
+};
+void (*block_on_ptr)(RtosTaskId);
+void (*unblock_ptr)(RtosTaskId);
+RtosTaskId (*get_current_task_ptr)(void);
+
+#define assert_mutex_valid(mutex) api_assert(mutex < 10, ERROR_ID_INVALID_ID)
+#define preempt_disable()
+#define preempt_enable()
+#define precondition_preemption_disabled()
+#define postcondition_preemption_disabled()
+#define api_assert(expression, error_id) do { } while(0)
+
+static bool
+mutex_try_lock(const RtosMutexId m)
+{
+    const bool r = mutexes[m].holder == TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    if (r)
+    {
+        mutexes[m].holder = get_current_task();
+    }
+
+    postcondition_preemption_disabled();
+
+    return r;
+}
+
+/*
+ * Lock the mutex, blocking the current task while another task holds it.
+ * Returns whether the mutex was contended.
+ */
+static bool
+mutex_acquire(const RtosMutexId m) RTOS_REENTRANT
+{
+    bool contended = false;
+
+    precondition_preemption_disabled();
+
+    while (!mutex_try_lock(m))
+    {
+        contended = true;
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on(mutexes[m].holder);
+    }
+
+    postcondition_preemption_disabled();
+
+    return contended;
+}
+
+static void
+mutex_release(const RtosMutexId m)
+{
+    RtosTaskId t;
+
+    precondition_preemption_disabled();
+
+
+    /* loop bound: 3 */
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        if (mutex_waiters[t] == m)
+        {
+            mutex_waiters[t] = MUTEX_ID_NONE;
+            mutex_core_unblock(t);
+        }
+    }
+
+    mutexes[m].holder = TASK_ID_NONE;
+
+    postcondition_preemption_disabled();
+}
+static void
+mutex_core_block_on(RtosTaskId task) RTOS_REENTRANT
+{
+    if (block_on_ptr != NULL)
+    {
+        block_on_ptr(task);
+    }
+}
+
+static void
+mutex_core_unblock(RtosTaskId task)
+{
+    if (unblock_ptr != NULL)
+    {
+        unblock_ptr(task);
+    }
+}
+
+static RtosTaskId
+get_current_task(void)
+{
+    if (get_current_task_ptr != NULL)
+    {
+        return get_current_task_ptr();
+    }
+    return RTOS_TASK_ID_ZERO;
+}
+
+void
+rtos_mutex_lock(const RtosMutexId m) RTOS_REENTRANT
+{
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder != get_current_task(), ERROR_ID_DEADLOCK);
+
+    preempt_disable();
+
+    (void) mutex_acquire(m);
+
+    preempt_enable();
+
+}
+
+
+void
+rtos_mutex_unlock(const RtosMutexId m)
+{
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    mutex_release(m);
+
+    preempt_enable();
+}
+
+bool
+rtos_mutex_try_lock(const RtosMutexId m)
+{
+    bool r;
+
+    assert_mutex_valid(m);
+
+    preempt_disable();
+
+    r = mutex_try_lock(m);
+
+    preempt_enable();
+
+    return r;
+}
+
+/* A macro implementation would be preferable to eliminate function call overhead when compilers don't support implicit
+ * inlining, but at present this would involve exposing too many implementation internals in the public API header. */
+bool
+rtos_mutex_holder_is_current(const RtosMutexId m)
+{
+    assert_mutex_valid(m);
+    return mutexes[m].holder == get_current_task();
+}
+
+
+struct mutex * pub_mutexes = mutexes;
+
+void
+pub_set_block_on_ptr(void (*y)(RtosTaskId))
+{
+    block_on_ptr = y;
+}
+
+void
+pub_set_unblock_ptr(void (*y)(RtosTaskId))
+{
+    unblock_ptr = y;
+}
+
+void
+pub_set_get_current_task_ptr(RtosTaskId (*y)(void))
+{
+    get_current_task_ptr = y;
+}
+
+void pub_mutex_init(void)
+{
+    RtosMutexId mutex_id;
+    RtosTaskId task_id;
+    /* For testing purposes we also reset all mutexes */
+    for (mutex_id = RTOS_MUTEX_ID_ZERO; mutex_id <= RTOS_MUTEX_ID_MAX; mutex_id++)
+    {
+        mutexes[mutex_id].holder = TASK_ID_NONE;
+    }
+    for (task_id = RTOS_TASK_ID_ZERO; task_id <= RTOS_TASK_ID_MAX; task_id++)
+    {
+        mutex_waiters[task_id] = MUTEX_ID_NONE;
+    }
+    block_on_ptr = NULL;
+    unblock_ptr = NULL;
+    get_current_task_ptr = NULL;
+}
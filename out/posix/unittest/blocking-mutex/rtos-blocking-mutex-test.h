@@ -0,0 +1,46 @@
+#ifndef RTOS_BLOCKING_MUTEX_TEST_H
+#define RTOS_BLOCKING_MUTEX_TEST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+
+typedef uint8_t RtosMutexId;
+typedef uint8_t RtosTaskId;
+
+
+
+#define RTOS_REENTRANT 
+#define RTOS_MUTEX_ID_ZERO ((RtosMutexId) UINT8_C(0))
+#define RTOS_MUTEX_ID_MAX ((RtosMutexId) UINT8_C(10 - 1))
+#define RTOS_MUTEX_ID_M1 ((RtosMutexId) UINT8_C(0))
+#define RTOS_MUTEX_ID_M2 ((RtosMutexId) UINT8_C(1))
+#define RTOS_MUTEX_ID_M3 ((RtosMutexId) UINT8_C(2))
+#define RTOS_MUTEX_ID_M4 ((RtosMutexId) UINT8_C(3))
+#define RTOS_MUTEX_ID_M5 ((RtosMutexId) UINT8_C(4))
+#define RTOS_MUTEX_ID_M6 ((RtosMutexId) UINT8_C(5))
+#define RTOS_MUTEX_ID_M7 ((RtosMutexId) UINT8_C(6))
+#define RTOS_MUTEX_ID_M8 ((RtosMutexId) UINT8_C(7))
+#define RTOS_MUTEX_ID_M9 ((RtosMutexId) UINT8_C(8))
+#define RTOS_MUTEX_ID_M10 ((RtosMutexId) UINT8_C(9))
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(3 - 1))
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void rtos_mutex_lock(RtosMutexId) RTOS_REENTRANT;
+bool rtos_mutex_try_lock(RtosMutexId);
+void rtos_mutex_unlock(RtosMutexId);
+bool rtos_mutex_holder_is_current(RtosMutexId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_BLOCKING_MUTEX_TEST_H */
\ No newline at end of file
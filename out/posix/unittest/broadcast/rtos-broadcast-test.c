@@ -0,0 +1,362 @@
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rtos-broadcast-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+#define ERROR_ID_NONE ((RtosErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW ((RtosErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID ((RtosErrorId) UINT8_C(2))
+#define ERROR_ID_NOT_HOLDING_MUTEX ((RtosErrorId) UINT8_C(3))
+#define ERROR_ID_DEADLOCK ((RtosErrorId) UINT8_C(4))
+#define ERROR_ID_TASK_FUNCTION_RETURNS ((RtosErrorId) UINT8_C(5))
+#define ERROR_ID_INTERNAL_CURRENT_TASK_INVALID ((RtosErrorId) UINT8_C(6))
+#define ERROR_ID_INTERNAL_INVALID_ID ((RtosErrorId) UINT8_C(7))
+#define ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP ((RtosErrorId) UINT8_C(8))
+#define ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(9))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(10))
+#define ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER ((RtosErrorId) UINT8_C(11))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW ((RtosErrorId) UINT8_C(12))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION ((RtosErrorId) UINT8_C(13))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_CONFIGURATION ((RtosErrorId) UINT8_C(14))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_HEAD ((RtosErrorId) UINT8_C(15))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE ((RtosErrorId) UINT8_C(16))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_ID_IN_WAITERS ((RtosErrorId) UINT8_C(17))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TASKS_BLOCKED_DESPITE_AVAILABLE_MESSAGES ((RtosErrorId) UINT8_C(18))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_WAITING_TASK_IS_NOT_BLOCKED ((RtosErrorId) UINT8_C(19))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGES_POINTER ((RtosErrorId) UINT8_C(20))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGE_SIZE ((RtosErrorId) UINT8_C(21))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH ((RtosErrorId) UINT8_C(22))
+#define ERROR_ID_INTERNAL_PRECONDITION_VIOLATED ((RtosErrorId) UINT8_C(23))
+#define ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED ((RtosErrorId) UINT8_C(24))
+#define ERROR_ID_SEMAPHORE_MAX_INVALID ((RtosErrorId) UINT8_C(25))
+#define ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT ((RtosErrorId) UINT8_C(26))
+#define ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT ((RtosErrorId) UINT8_C(27))
+#define ERROR_ID_SEMAPHORE_MAX_EXCEEDED ((RtosErrorId) UINT8_C(28))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED ((RtosErrorId) UINT8_C(29))
+#define ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX ((RtosErrorId) UINT8_C(30))
+#define ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED ((RtosErrorId) UINT8_C(31))
+#define ERROR_ID_SCHED_EDF_TASK_NOT_PERIODIC ((RtosErrorId) UINT8_C(32))
+#define ERROR_ID_TIMER_TASK_NOT_PERIODIC ((RtosErrorId) UINT8_C(33))
+#define ERROR_ID_POOL_INVALID_BLOCK ((RtosErrorId) UINT8_C(34))
+#define ERROR_ID_BROADCAST_NOT_SUBSCRIBED ((RtosErrorId) UINT8_C(35))
+#define ERROR_ID_BROADCAST_INVALID_POINTER ((RtosErrorId) UINT8_C(36))
+#define ERROR_ID_WORK_QUEUE_INVALID_FUNCTION ((RtosErrorId) UINT8_C(37))
+#define ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS ((RtosErrorId) UINT8_C(38))
+#define ERROR_ID_TIMEBASE_TIME_TOO_FAR ((RtosErrorId) UINT8_C(39))
+
+
+typedef uint8_t BroadcastSubscriptionIndex;
+
+
+/* representation of a broadcast channel instance */
+struct broadcast
+{
+    /* pointer to the array holding the record data
+     * the array contains record_size * length bytes */
+    uint8_t *records;
+    /* size of each record in bytes */
+    uint16_t record_size;
+    /* number of records the channel retains for its subscribers */
+    uint8_t length;
+    /* index of the slot the next record is published into
+     * 0 <= head < length */
+    uint8_t head;
+    /* sequence number of the next record to be published */
+    uint32_t published;
+    /* range of the subscriptions of the channel in the broadcast_subscriptions array */
+    BroadcastSubscriptionIndex first_subscription;
+    BroadcastSubscriptionIndex subscription_count;
+    /* signal set sent to all subscribers when a record is published */
+    RtosSignalSet sig_set;
+};
+
+/* the per-subscriber state of a broadcast channel */
+struct broadcast_subscription
+{
+    RtosTaskId task;
+    /* sequence number of the next record the subscriber retrieves */
+    uint32_t cursor;
+    /* number of records that were overwritten before the subscriber retrieved them */
+    uint32_t lost;
+};
+
+
+extern void test_fatal_error(RtosErrorId error_id);
+
+
+
+
+static struct broadcast_subscription *broadcast_subscription_get(RtosBroadcastId broadcast);
+static void broadcast_copy(uint8_t *dst, const uint8_t *src, uint16_t length);
+static void signal_send_set(RtosTaskId task_id, RtosSignalSet signals);
+static RtosSignalSet signal_wait_set(RtosSignalSet requested_signals) RTOS_REENTRANT;
+static RtosTaskId get_current_task(void);
+
+
+static uint8_t broadcast_b0_records[4][4];
+static uint8_t broadcast_b1_records[1][sizeof(uint16_t)];
+static struct broadcast broadcasts[2] =
+{
+    {
+        (uint8_t*)broadcast_b0_records,
+        4,
+        4,
+        0,
+        0,
+        0,
+        2,
+        RTOS_SIGNAL_SET_B0
+    },
+    {
+        (uint8_t*)broadcast_b1_records,
+        sizeof(uint16_t),
+        1,
+        0,
+        0,
+        2,
+        1,
+        RTOS_SIGNAL_SET_B1
+    },
+};
+static struct broadcast_subscription broadcast_subscriptions[3] =
+{
+    { RTOS_TASK_ID_T0, 0, 0 },
+    { RTOS_TASK_ID_T1, 0, 0 },
+    { RTOS_TASK_ID_T2, 0, 0 },
+};
+
+static RtosTaskId current_task;
+static void (*wait_ptr)(void);
+RtosSignalSet pub_signals[3];
+uint8_t pub_waits;
+RtosErrorId pub_fatal_error_id;
+
+#define api_error(error_id) test_fatal_error(error_id)
+#define api_assert(expression, error_id) do { if (!(expression)) { api_error(error_id); } } while(0)
+
+#define internal_error(error_id) do { } while(0)
+#define internal_assert(expression, error_id) do { } while(0)
+#define broadcast_api_assert_valid(broadcast) api_assert(broadcast < 2, ERROR_ID_INVALID_ID)
+
+
+
+
+static struct broadcast_subscription *
+broadcast_subscription_get(const RtosBroadcastId broadcast)
+{
+    const struct broadcast *const b = &broadcasts[broadcast];
+    BroadcastSubscriptionIndex s;
+
+    /* loop bound: 3 */
+    for (s = b->first_subscription; s < b->first_subscription + b->subscription_count; s += 1)
+    {
+        if (broadcast_subscriptions[s].task == get_current_task())
+        {
+            return &broadcast_subscriptions[s];
+        }
+    }
+
+    api_error(ERROR_ID_BROADCAST_NOT_SUBSCRIBED);
+    return &broadcast_subscriptions[b->first_subscription];
+}
+
+/* called broadcast_copy instead of memcpy to not conflict with gcc's built-in memcpy declaration on unit test
+ * targets */
+static void
+broadcast_copy(uint8_t *dst, const uint8_t *src, const uint16_t length)
+{
+    uint8_t *const dst_end = dst + length;
+
+    /* loop bound: 65535 */
+    while (dst < dst_end)
+    {
+        *dst++ = *src++;
+    }
+}
+
+static void
+signal_send_set(const RtosTaskId task_id, const RtosSignalSet signals)
+{
+    pub_signals[task_id] |= signals;
+}
+
+/*
+ * While the current task waits, other tasks run in the wait function that the test sets.
+ */
+static RtosSignalSet
+signal_wait_set(const RtosSignalSet requested_signals) RTOS_REENTRANT
+{
+    const RtosTaskId task = current_task;
+
+    pub_waits++;
+    pub_signals[task] &= ~requested_signals;
+    if (wait_ptr != NULL)
+    {
+        wait_ptr();
+    }
+    current_task = task;
+
+    return requested_signals;
+}
+
+static RtosTaskId
+get_current_task(void)
+{
+    return current_task;
+}
+
+void
+test_fatal_error(const RtosErrorId error_id)
+{
+    pub_fatal_error_id = error_id;
+}
+
+
+void
+rtos_broadcast_publish(const RtosBroadcastId broadcast, const void *const record)
+{
+    struct broadcast *b;
+    BroadcastSubscriptionIndex s;
+
+    broadcast_api_assert_valid(broadcast);
+    api_assert(record, ERROR_ID_BROADCAST_INVALID_POINTER);
+
+    b = &broadcasts[broadcast];
+
+    /* The record is copied once, regardless of the number of subscribers.
+     * The producer never waits for subscribers: slow subscribers lose the oldest records instead. */
+    broadcast_copy(&b->records[(uint16_t) b->head * b->record_size], (const uint8_t*)record, b->record_size);
+    b->head = (b->head + 1) % b->length;
+    b->published += 1;
+
+    /* Sending the signal only makes the subscribers runnable; they run in the order the scheduler selects them after
+     * the publishing task yields. */
+    /* loop bound: 3 */
+    for (s = b->first_subscription; s < b->first_subscription + b->subscription_count; s += 1)
+    {
+        signal_send_set(broadcast_subscriptions[s].task, b->sig_set);
+    }
+}
+
+bool
+rtos_broadcast_try_get(const RtosBroadcastId broadcast, void *const record)
+{
+    const struct broadcast *b;
+    struct broadcast_subscription *subscription;
+    uint32_t pending;
+
+    broadcast_api_assert_valid(broadcast);
+    api_assert(record, ERROR_ID_BROADCAST_INVALID_POINTER);
+
+    b = &broadcasts[broadcast];
+    subscription = broadcast_subscription_get(broadcast);
+    pending = b->published - subscription->cursor;
+
+    if (pending == 0)
+    {
+        return false;
+    }
+
+    if (pending > b->length)
+    {
+        /* The records the subscriber has not retrieved yet have been overwritten, so skip to the oldest record the
+         * channel still retains */
+        subscription->lost += pending - b->length;
+        subscription->cursor = b->published - b->length;
+        pending = b->length;
+    }
+
+    broadcast_copy((uint8_t*)record,
+                   &b->records[(uint16_t) ((b->head + b->length - pending) % b->length) * b->record_size],
+                   b->record_size);
+    subscription->cursor += 1;
+
+    return true;
+}
+
+void
+rtos_broadcast_get(const RtosBroadcastId broadcast, void *const record) RTOS_REENTRANT
+{
+    broadcast_api_assert_valid(broadcast);
+    api_assert(record, ERROR_ID_BROADCAST_INVALID_POINTER);
+
+    while (!rtos_broadcast_try_get(broadcast, record))
+    {
+        (void) signal_wait_set(broadcasts[broadcast].sig_set);
+    }
+}
+
+uint32_t
+rtos_broadcast_lost(const RtosBroadcastId broadcast)
+{
+    struct broadcast_subscription *subscription;
+    const struct broadcast *b;
+    uint32_t lost;
+
+    broadcast_api_assert_valid(broadcast);
+
+    b = &broadcasts[broadcast];
+    subscription = broadcast_subscription_get(broadcast);
+    lost = subscription->lost;
+
+    /* Records that have been overwritten but not skipped by broadcast_try_get() yet are lost as well */
+    if (b->published - subscription->cursor > b->length)
+    {
+        lost += b->published - subscription->cursor - b->length;
+        subscription->cursor = b->published - b->length;
+    }
+    subscription->lost = 0;
+
+    return lost;
+}
+
+void
+pub_broadcast_init(void)
+{
+    RtosBroadcastId broadcast;
+    BroadcastSubscriptionIndex s;
+    RtosTaskId task_id;
+
+    /* For testing purposes, all channels and subscriptions are reset */
+    for (broadcast = 0; broadcast < 2; broadcast++)
+    {
+        broadcasts[broadcast].head = 0;
+        broadcasts[broadcast].published = 0;
+    }
+    for (s = 0; s < 3; s++)
+    {
+        broadcast_subscriptions[s].cursor = 0;
+        broadcast_subscriptions[s].lost = 0;
+    }
+    for (task_id = RTOS_TASK_ID_ZERO; task_id <= RTOS_TASK_ID_MAX; task_id++)
+    {
+        pub_signals[task_id] = 0;
+    }
+    current_task = RTOS_TASK_ID_ZERO;
+    wait_ptr = NULL;
+    pub_waits = 0;
+    pub_fatal_error_id = ERROR_ID_NONE;
+}
+
+void
+pub_set_current_task(const RtosTaskId task_id)
+{
+    current_task = task_id;
+}
+
+void
+pub_set_wait_ptr(void (*y)(void))
+{
+    wait_ptr = y;
+}
@@ -0,0 +1,53 @@
+#ifndef RTOS_BROADCAST_TEST_H
+#define RTOS_BROADCAST_TEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+
+typedef uint8_t RtosErrorId;
+typedef uint8_t RtosBroadcastId;
+typedef uint8_t RtosTaskId;
+typedef uint8_t RtosSignalSet;
+
+
+
+
+#define RTOS_REENTRANT 
+
+#define RTOS_BROADCAST_ID_B0 ((RtosBroadcastId) UINT8_C(0))
+#define RTOS_BROADCAST_ID_B1 ((RtosBroadcastId) UINT8_C(1))
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(3 - 1))
+#define RTOS_TASK_ID_T0 ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_T1 ((RtosTaskId) UINT8_C(1))
+#define RTOS_TASK_ID_T2 ((RtosTaskId) UINT8_C(2))
+#define RTOS_SIGNAL_SET_B0 ((RtosSignalSet) UINT8_C(1))
+#define RTOS_SIGNAL_SET_B1 ((RtosSignalSet) UINT8_C(1))
+
+
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+void rtos_broadcast_publish(RtosBroadcastId broadcast, const void *record);
+bool rtos_broadcast_try_get(RtosBroadcastId broadcast, void *record);
+void rtos_broadcast_get(RtosBroadcastId broadcast, void *record) RTOS_REENTRANT;
+uint32_t rtos_broadcast_lost(RtosBroadcastId broadcast);
+
+void pub_broadcast_init(void);
+void pub_set_current_task(RtosTaskId task_id);
+void pub_set_wait_ptr(void (*y)(void));
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_BROADCAST_TEST_H */
\ No newline at end of file
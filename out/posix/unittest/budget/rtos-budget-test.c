@@ -0,0 +1,401 @@
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "rtos-budget-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+#define SCHED_INDEX_ZERO ((SchedIndex) RTOS_TASK_ID_ZERO)
+#define SCHED_WORDS (((3 - 1U) / 32U) + 1U)
+#define BUDGET_REPLENISHMENTS_MAX 4U
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+typedef RtosTaskId SchedIndex;
+typedef uint32_t SchedWord;
+typedef RtosTaskId TaskIdOption;
+
+/*
+ * NOTE: An RTOS variant using the scheduler must ensure that tasks
+ * array is sorted by priority.
+ * The runnable tasks are a bitmap of 32 tasks per word, so that the scheduler can skip over 32 blocked tasks at a time.
+ */
+struct sched {
+    SchedWord runnable[SCHED_WORDS];
+};
+struct budget_replenishment {
+    RtosTicksAbsolute due;
+    uint32_t amount;
+};
+
+struct budget {
+    /* Signed, because the RTOS only notices an exhausted budget at the next scheduling point, so a task may overrun
+     * its budget by the cycles it executes until then. */
+    int32_t remaining;
+    uint32_t consumed;
+    RtosTicksAbsolute activation;
+    bool active;
+    bool throttled;
+    uint8_t replenishment_head;
+    uint8_t replenishment_count;
+    struct budget_replenishment replenishments[BUDGET_REPLENISHMENTS_MAX];
+};
+
+
+
+extern void test_budget_overrun(RtosTaskId task);
+
+
+static void sched_set_runnable(const RtosTaskId task_id);
+static void sched_set_blocked(const RtosTaskId task_id);
+static TaskIdOption sched_get_next(void);
+static void budget_init(void);
+static void budget_activate(RtosTaskId task);
+static void budget_post(RtosTaskId task);
+static void budget_charge(RtosTaskId task);
+static bool budget_throttle(RtosTaskId task);
+static void budget_replenish_process(void);
+static void budget_switch(RtosTaskId from, RtosTaskId to);
+static uint32_t cycle_counter_get(void);
+static void interrupt_event_wait(void);
+
+static struct sched sched_tasks;
+static struct budget budgets[3];
+static uint32_t budget_switch_in;
+static const uint32_t budget_capacities[3] = {
+    UINT32_C(1000),
+    UINT32_C(500),
+    UINT32_C(0),
+};
+static const RtosTicksRelative budget_periods[3] = {
+    10,
+    20,
+    0,
+};
+static RtosTaskId current_task;
+RtosTicksAbsolute rtos_timer_current_ticks;
+uint32_t pub_cycles;
+uint32_t pub_idle_ticks;
+uint8_t pub_overruns[3];
+
+#define sched_runnable(task_id) ((SCHED_WORD(task_id) & SCHED_BIT(task_id)) != 0)
+#define sched_max_index() (SchedIndex)(3 - 1U)
+#define sched_index_to_taskid(sched_index) (RtosTaskId)(sched_index)
+#define SCHED_WORD(task_id) sched_tasks.runnable[(task_id) / 32U]
+#define SCHED_BIT(task_id) ((SchedWord) 1U << ((task_id) % 32U))
+#define budget_limited(task) (budget_capacities[task] != 0)
+#define cycle_counter_init()
+
+static void
+sched_set_runnable(const RtosTaskId task_id)
+{
+    SCHED_WORD(task_id) |= SCHED_BIT(task_id);
+}
+
+static void
+sched_set_blocked(const RtosTaskId task_id)
+{
+    SCHED_WORD(task_id) &= ~SCHED_BIT(task_id);
+}
+
+static RAMFUNC TaskIdOption
+sched_get_next(void)
+{
+    /* NOTE: In the case where assume_runnable is true and no runnable
+       tasks are found, then an undefined task will be returned from this
+       function.
+    */
+    TaskIdOption task = TASK_ID_NONE;
+    SchedIndex word, idx;
+    SchedWord runnable;
+
+    /* loop bound: (3 - 1) / 32 + 1 */
+    for (word = 0; word < SCHED_WORDS; word++)
+    {
+        runnable = sched_tasks.runnable[word];
+        if (runnable != 0)
+        {
+            /* The lowest set bit of the first non-empty word is the runnable task with the highest priority */
+            idx = (SchedIndex) (word * 32U);
+            /* loop bound: 31 */
+            while ((runnable & 1U) == 0)
+            {
+                runnable >>= 1;
+                idx++;
+            }
+            task = sched_index_to_taskid(idx);
+            break;
+        }
+    }
+
+    return task;
+}
+static void
+budget_init(void)
+{
+    RtosTaskId task;
+
+    cycle_counter_init();
+
+    for (task = RTOS_TASK_ID_ZERO; task <= RTOS_TASK_ID_MAX; task++)
+    {
+        budgets[task].remaining = (int32_t) budget_capacities[task];
+    }
+
+    budget_activate(RTOS_TASK_ID_ZERO);
+    budget_switch_in = cycle_counter_get();
+}
+
+static void
+budget_activate(const RtosTaskId task)
+{
+    if (budget_limited(task))
+    {
+        budgets[task].activation = rtos_timer_current_ticks;
+        budgets[task].active = true;
+    }
+}
+
+/*
+ * Schedule the replenishment of the cycles a task has consumed since its activation, one replenishment period after
+ * the activation.
+ * When all replenishment slots of the task are in use, the cycles are added to the latest replenishment instead,
+ * which is deferred accordingly.
+ * That returns budget later than a sporadic server with unlimited replenishments would, but never earlier.
+ */
+static void
+budget_post(const RtosTaskId task)
+{
+    struct budget *const budget = &budgets[task];
+    struct budget_replenishment *replenishment;
+
+    if (budget->consumed != 0)
+    {
+        if (budget->replenishment_count < BUDGET_REPLENISHMENTS_MAX)
+        {
+            replenishment = &budget->replenishments[(budget->replenishment_head + budget->replenishment_count) %
+                                                    BUDGET_REPLENISHMENTS_MAX];
+            replenishment->amount = 0;
+            budget->replenishment_count++;
+        }
+        else
+        {
+            replenishment = &budget->replenishments[(budget->replenishment_head + BUDGET_REPLENISHMENTS_MAX - 1) %
+                                                    BUDGET_REPLENISHMENTS_MAX];
+        }
+        replenishment->due = budget->activation + budget_periods[task];
+        replenishment->amount += budget->consumed;
+        budget->consumed = 0;
+    }
+    budget->active = false;
+}
+
+/*
+ * Charge the cycles since the last scheduling decision to the task that executed them.
+ * The active period of the task ends when it exhausts its budget or when it blocks.
+ */
+static RAMFUNC void
+budget_charge(const RtosTaskId task)
+{
+    const uint32_t now = cycle_counter_get();
+    const uint32_t elapsed = now - budget_switch_in;
+    struct budget *const budget = &budgets[task];
+
+    budget_switch_in = now;
+
+    if (budget_limited(task))
+    {
+        budget->remaining -= (int32_t) elapsed;
+        budget->consumed += elapsed;
+
+        if (budget->remaining <= 0)
+        {
+            budget_post(task);
+            test_budget_overrun(task);
+        }
+        else if (!sched_runnable(task))
+        {
+            budget_post(task);
+        }
+    }
+}
+
+/*
+ * Block a task the scheduler selected if its budget is exhausted, until budget_replenish_process() makes it runnable
+ * again.
+ */
+static RAMFUNC bool
+budget_throttle(const RtosTaskId task)
+{
+    if (budget_limited(task) && budgets[task].remaining <= 0)
+    {
+        sched_set_blocked(task);
+        budgets[task].throttled = true;
+        return true;
+    }
+
+    return false;
+}
+
+static RAMFUNC void
+budget_replenish_process(void)
+{
+    RtosTaskId task;
+    struct budget *budget;
+    struct budget_replenishment *replenishment;
+
+    /* loop bound: 3 */
+    for (task = RTOS_TASK_ID_ZERO; task <= RTOS_TASK_ID_MAX; task++)
+    {
+        budget = &budgets[task];
+        /* loop bound: 4 */
+        while (budget->replenishment_count != 0)
+        {
+            replenishment = &budget->replenishments[budget->replenishment_head];
+            if ((int32_t) (rtos_timer_current_ticks - replenishment->due) < 0)
+            {
+                break;
+            }
+
+            budget->remaining += (int32_t) replenishment->amount;
+            if (budget->remaining > (int32_t) budget_capacities[task])
+            {
+                budget->remaining = (int32_t) budget_capacities[task];
+            }
+            budget->replenishment_head = (budget->replenishment_head + 1) % BUDGET_REPLENISHMENTS_MAX;
+            budget->replenishment_count--;
+        }
+
+        if (budget->throttled && budget->remaining > 0)
+        {
+            budget->throttled = false;
+            sched_set_runnable(task);
+        }
+    }
+}
+
+/*
+ * A task that is switched out ends its active period, so that its replenishment is scheduled relative to when it
+ * started running rather than to when it next runs.
+ * The cycles executed between budget_charge() and this function, i.e., by the scheduler and while the system is idle,
+ * are not charged to any task.
+ */
+static RAMFUNC void
+budget_switch(const RtosTaskId from, const RtosTaskId to)
+{
+    if (from != to && budgets[from].active)
+    {
+        budget_post(from);
+    }
+
+    if (!budgets[to].active)
+    {
+        budget_activate(to);
+    }
+
+    budget_switch_in = cycle_counter_get();
+}
+static uint32_t
+cycle_counter_get(void)
+{
+    return pub_cycles;
+}
+
+/*
+ * While no task is runnable, the system idles until the next tick.
+ */
+static void
+interrupt_event_wait(void)
+{
+    rtos_timer_current_ticks++;
+    pub_idle_ticks++;
+}
+
+void
+test_budget_overrun(const RtosTaskId task)
+{
+    pub_overruns[task]++;
+}
+
+
+
+void
+pub_budget_init(void)
+{
+    memset(budgets, 0, sizeof(budgets));
+    memset(&sched_tasks, 0, sizeof(sched_tasks));
+    memset(pub_overruns, 0, sizeof(pub_overruns));
+    current_task = RTOS_TASK_ID_ZERO;
+    rtos_timer_current_ticks = 0;
+    pub_cycles = 0;
+    pub_idle_ticks = 0;
+    budget_init();
+}
+
+void
+pub_sched_set_runnable(const RtosTaskId task_id)
+{
+    sched_set_runnable(task_id);
+}
+
+void
+pub_sched_set_blocked(const RtosTaskId task_id)
+{
+    sched_set_blocked(task_id);
+}
+
+bool
+pub_sched_runnable(const RtosTaskId task_id)
+{
+    return sched_runnable(task_id);
+}
+
+/*
+ * Make a scheduling decision the way the interrupt-event component does, and switch to the selected task.
+ */
+RtosTaskId
+pub_budget_select(void)
+{
+    TaskIdOption next;
+
+    budget_charge(current_task);
+
+    for (;;)
+    {
+        budget_replenish_process();
+        next = sched_get_next();
+        if (next != TASK_ID_NONE && budget_throttle(next))
+        {
+            continue;
+        }
+
+        if (next == TASK_ID_NONE)
+        {
+            interrupt_event_wait();
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    budget_switch(current_task, next);
+    current_task = next;
+
+    return next;
+}
+
+int32_t
+pub_budget_remaining(const RtosTaskId task_id)
+{
+    return budgets[task_id].remaining;
+}
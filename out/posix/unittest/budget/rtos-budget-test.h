@@ -0,0 +1,40 @@
+#ifndef RTOS_BUDGET_TEST_H
+#define RTOS_BUDGET_TEST_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+typedef uint8_t RtosTaskId;
+typedef uint16_t RtosTicksRelative;
+typedef uint32_t RtosTicksAbsolute;
+
+
+
+#define RTOS_REENTRANT 
+
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(3 - 1))
+
+
+
+
+
+extern RtosTicksAbsolute rtos_timer_current_ticks;
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+void pub_budget_init(void);
+void pub_sched_set_runnable(RtosTaskId task_id);
+void pub_sched_set_blocked(RtosTaskId task_id);
+bool pub_sched_runnable(RtosTaskId task_id);
+RtosTaskId pub_budget_select(void);
+int32_t pub_budget_remaining(RtosTaskId task_id);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_BUDGET_TEST_H */
\ No newline at end of file
@@ -0,0 +1,483 @@
+
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rtos-condition-variable-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+#define MUTEX_ID_NONE ((MutexIdOption) UINT8_MAX)
+#define COND_ID_NONE ((CondIdOption) UINT8_MAX)
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+typedef RtosMutexId MutexIdOption;
+typedef RtosCondId CondIdOption;
+typedef RtosTaskId TaskIdOption;
+
+
+struct mutex {
+    TaskIdOption holder;
+};
+
+
+
+
+
+
+
+static bool mutex_try_lock(RtosMutexId m);
+static bool mutex_acquire(RtosMutexId m) RTOS_REENTRANT;
+static void mutex_release(RtosMutexId m);
+static void cond_wake(RtosCondId cond, bool all);
+static void test_block(TaskIdOption blocker) RTOS_REENTRANT;
+static void mutex_core_block_on(RtosTaskId blocker) RTOS_REENTRANT;
+static void cond_core_block(void) RTOS_REENTRANT;
+static void cond_core_block_timeout(RtosTicksRelative timeout) RTOS_REENTRANT;
+static void test_unblock(RtosTaskId task);
+static void test_preempt_enable(void);
+static RtosTaskId get_current_task(void);
+
+static struct mutex mutexes[2] = {
+    {TASK_ID_NONE},
+    {TASK_ID_NONE},
+};
+static MutexIdOption mutex_waiters[4] = {
+    MUTEX_ID_NONE,
+    MUTEX_ID_NONE,
+    MUTEX_ID_NONE,
+    MUTEX_ID_NONE,
+};
+/* The condition variable each task waits on, if any.
+ * A task waiting on a condition variable holds no mutex and is blocked without a blocker, so no task inherits its
+ * priority until it is woken up and waits for the mutex again. */
+static CondIdOption cond_waiters[4] = {
+    COND_ID_NONE,
+    COND_ID_NONE,
+    COND_ID_NONE,
+    COND_ID_NONE,
+};
+static RtosTaskId current_task;
+static bool preemption_disabled;
+static bool preemption_pending;
+static void (*block_ptr)(RtosTaskId);
+static void (*block_timeout_ptr)(RtosTicksRelative);
+static void (*preempt_ptr)(void);
+RtosTicksAbsolute rtos_timer_current_ticks;
+bool pub_unblocked[4];
+uint8_t pub_deadlocks;
+uint8_t pub_preemption_errors;
+
+#define assert_mutex_valid(mutex) api_assert(mutex < 2, ERROR_ID_INVALID_ID)
+#define assert_cond_valid(cond) api_assert(cond < 2, ERROR_ID_INVALID_ID)
+#define preempt_disable() (preemption_disabled = true)
+#define preempt_enable() test_preempt_enable()
+#define precondition_preemption_disabled() \
+    do { if (!preemption_disabled) { pub_preemption_errors++; } } while (0)
+#define postcondition_preemption_disabled() precondition_preemption_disabled()
+#define api_assert(expression, error_id) do { } while(0)
+#define mutex_core_unblock(task) test_unblock(task)
+#define cond_core_unblock(task) test_unblock(task)
+#define cond_core_higher_priority(t1, t2) ((t1) < (t2))
+
+static bool
+mutex_try_lock(const RtosMutexId m)
+{
+    const bool r = mutexes[m].holder == TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    if (r)
+    {
+        mutexes[m].holder = get_current_task();
+    }
+
+    postcondition_preemption_disabled();
+
+    return r;
+}
+
+/*
+ * Lock the mutex, blocking the current task while another task holds it.
+ * Returns whether the mutex was contended.
+ */
+static bool
+mutex_acquire(const RtosMutexId m) RTOS_REENTRANT
+{
+    bool contended = false;
+
+    precondition_preemption_disabled();
+
+    while (!mutex_try_lock(m))
+    {
+        contended = true;
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on(mutexes[m].holder);
+    }
+
+    postcondition_preemption_disabled();
+
+    return contended;
+}
+
+static void
+mutex_release(const RtosMutexId m)
+{
+    RtosTaskId t;
+
+    precondition_preemption_disabled();
+
+
+    /* loop bound: 4 */
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        if (mutex_waiters[t] == m)
+        {
+            mutex_waiters[t] = MUTEX_ID_NONE;
+            mutex_core_unblock(t);
+        }
+    }
+
+    mutexes[m].holder = TASK_ID_NONE;
+
+    postcondition_preemption_disabled();
+}
+static void
+cond_wake(const RtosCondId cond, const bool all)
+{
+    RtosTaskId t;
+    TaskIdOption waiter = TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    /* loop bound: 4 */
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        if (cond_waiters[t] == cond)
+        {
+            if (all)
+            {
+                cond_waiters[t] = COND_ID_NONE;
+                cond_core_unblock(t);
+            }
+            else if (waiter == TASK_ID_NONE || cond_core_higher_priority(t, waiter))
+            {
+                waiter = t;
+            }
+        }
+    }
+
+    if (waiter != TASK_ID_NONE)
+    {
+        cond_waiters[waiter] = COND_ID_NONE;
+        cond_core_unblock(waiter);
+    }
+
+    postcondition_preemption_disabled();
+}
+/*
+ * While the current task is blocked, other tasks run in the block function that the test sets.
+ * The block function receives the task that holds the mutex the current task waits for, if any.
+ * Each block function runs once, so that the test lays out exactly which tasks run at which point.
+ * When no other task runs, nothing can unblock the current task.
+ * Instead of blocking forever, the task records the deadlock and stops waiting, so that a failing test does not hang.
+ */
+static void
+test_block(const TaskIdOption blocker) RTOS_REENTRANT
+{
+    const RtosTaskId task = current_task;
+    void (*const block)(RtosTaskId) = block_ptr;
+
+    precondition_preemption_disabled();
+
+    pub_unblocked[task] = false;
+    block_ptr = NULL;
+    if (block != NULL)
+    {
+        /* Other tasks start with preemption enabled */
+        preemption_disabled = false;
+        block(blocker);
+        preemption_disabled = true;
+    }
+    current_task = task;
+
+    if (!pub_unblocked[task])
+    {
+        pub_deadlocks++;
+        cond_waiters[task] = COND_ID_NONE;
+        if (mutex_waiters[task] != MUTEX_ID_NONE)
+        {
+            mutexes[mutex_waiters[task]].holder = TASK_ID_NONE;
+            mutex_waiters[task] = MUTEX_ID_NONE;
+        }
+    }
+}
+
+static void
+mutex_core_block_on(const RtosTaskId blocker) RTOS_REENTRANT
+{
+    test_block(blocker);
+}
+
+static void
+cond_core_block(void) RTOS_REENTRANT
+{
+    test_block(TASK_ID_NONE);
+}
+
+/*
+ * Without a block function, no other task runs and the timeout expires.
+ */
+static void
+cond_core_block_timeout(const RtosTicksRelative timeout) RTOS_REENTRANT
+{
+    const RtosTaskId task = current_task;
+    void (*const block_timeout)(RtosTicksRelative) = block_timeout_ptr;
+
+    precondition_preemption_disabled();
+
+    pub_unblocked[task] = false;
+    block_timeout_ptr = NULL;
+    if (block_timeout != NULL)
+    {
+        preemption_disabled = false;
+        block_timeout(timeout);
+        preemption_disabled = true;
+    }
+    else
+    {
+        rtos_timer_current_ticks += timeout;
+    }
+    current_task = task;
+}
+
+static void
+test_unblock(const RtosTaskId task)
+{
+    precondition_preemption_disabled();
+
+    pub_unblocked[task] = true;
+    preemption_pending = true;
+}
+
+/*
+ * An unblocked task preempts the current task as soon as preemption is enabled again, if the test sets a preempt
+ * function.
+ */
+static void
+test_preempt_enable(void)
+{
+    const RtosTaskId task = current_task;
+    void (*const preempt)(void) = preempt_ptr;
+
+    preemption_disabled = false;
+    if (preemption_pending)
+    {
+        preemption_pending = false;
+        if (preempt != NULL)
+        {
+            preempt_ptr = NULL;
+            preempt();
+            current_task = task;
+        }
+    }
+}
+
+static RtosTaskId
+get_current_task(void)
+{
+    return current_task;
+}
+
+void
+rtos_mutex_lock(const RtosMutexId m) RTOS_REENTRANT
+{
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder != get_current_task(), ERROR_ID_DEADLOCK);
+
+    preempt_disable();
+
+    (void) mutex_acquire(m);
+
+    preempt_enable();
+
+}
+
+
+void
+rtos_mutex_unlock(const RtosMutexId m)
+{
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    mutex_release(m);
+
+    preempt_enable();
+}
+
+bool
+rtos_mutex_try_lock(const RtosMutexId m)
+{
+    bool r;
+
+    assert_mutex_valid(m);
+
+    preempt_disable();
+
+    r = mutex_try_lock(m);
+
+    preempt_enable();
+
+    return r;
+}
+
+/* A macro implementation would be preferable to eliminate function call overhead when compilers don't support implicit
+ * inlining, but at present this would involve exposing too many implementation internals in the public API header. */
+bool
+rtos_mutex_holder_is_current(const RtosMutexId m)
+{
+    assert_mutex_valid(m);
+    return mutexes[m].holder == get_current_task();
+}
+
+void
+rtos_cond_wait(const RtosCondId cond, const RtosMutexId m) RTOS_REENTRANT
+{
+    assert_cond_valid(cond);
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    /* With preemption disabled, no other task can signal the condition variable between releasing the mutex and
+     * blocking, so the wakeup cannot be lost. */
+    cond_waiters[get_current_task()] = cond;
+    mutex_release(m);
+
+    /* The task may also receive the blocking signal for reasons other than being woken up, e.g., a stale signal of an
+     * earlier timeout, so block until it is actually removed from the waiters. */
+    do
+    {
+        cond_core_block();
+    } while (cond_waiters[get_current_task()] == cond);
+
+    (void) mutex_acquire(m);
+
+    preempt_enable();
+}
+
+bool
+rtos_cond_wait_timeout(const RtosCondId cond, const RtosMutexId m,
+                                 const RtosTicksRelative timeout) RTOS_REENTRANT
+{
+    bool signaled;
+    const RtosTicksAbsolute absolute_timeout = rtos_timer_current_ticks + timeout;
+
+    assert_cond_valid(cond);
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    cond_waiters[get_current_task()] = cond;
+    mutex_release(m);
+
+    while (cond_waiters[get_current_task()] == cond && absolute_timeout > rtos_timer_current_ticks)
+    {
+        cond_core_block_timeout(absolute_timeout - rtos_timer_current_ticks);
+    }
+    signaled = cond_waiters[get_current_task()] != cond;
+    cond_waiters[get_current_task()] = COND_ID_NONE;
+
+    (void) mutex_acquire(m);
+
+    preempt_enable();
+
+    return signaled;
+}
+
+void
+rtos_cond_signal(const RtosCondId cond)
+{
+    assert_cond_valid(cond);
+
+    preempt_disable();
+
+    cond_wake(cond, false);
+
+    preempt_enable();
+}
+
+void
+rtos_cond_broadcast(const RtosCondId cond)
+{
+    assert_cond_valid(cond);
+
+    preempt_disable();
+
+    cond_wake(cond, true);
+
+    preempt_enable();
+}
+
+struct mutex * pub_mutexes = mutexes;
+
+void
+pub_cond_init(void)
+{
+    RtosMutexId mutex_id;
+    RtosTaskId task_id;
+
+    /* For testing purposes, all mutexes and waiters are reset, too */
+    for (mutex_id = RTOS_MUTEX_ID_ZERO; mutex_id <= RTOS_MUTEX_ID_MAX; mutex_id++)
+    {
+        mutexes[mutex_id].holder = TASK_ID_NONE;
+    }
+    for (task_id = RTOS_TASK_ID_ZERO; task_id <= RTOS_TASK_ID_MAX; task_id++)
+    {
+        mutex_waiters[task_id] = MUTEX_ID_NONE;
+        cond_waiters[task_id] = COND_ID_NONE;
+        pub_unblocked[task_id] = false;
+    }
+    current_task = RTOS_TASK_ID_ZERO;
+    preemption_disabled = false;
+    preemption_pending = false;
+    block_ptr = NULL;
+    block_timeout_ptr = NULL;
+    preempt_ptr = NULL;
+    rtos_timer_current_ticks = 0;
+    pub_deadlocks = 0;
+    pub_preemption_errors = 0;
+}
+
+void
+pub_set_current_task(const RtosTaskId task_id)
+{
+    current_task = task_id;
+}
+
+void
+pub_set_block_ptr(void (*y)(RtosTaskId))
+{
+    block_ptr = y;
+}
+
+void
+pub_set_block_timeout_ptr(void (*y)(RtosTicksRelative))
+{
+    block_timeout_ptr = y;
+}
+
+void
+pub_set_preempt_ptr(void (*y)(void))
+{
+    preempt_ptr = y;
+}
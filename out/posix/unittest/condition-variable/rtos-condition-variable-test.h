@@ -0,0 +1,60 @@
+#ifndef RTOS_CONDITION_VARIABLE_TEST_H
+#define RTOS_CONDITION_VARIABLE_TEST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint8_t RtosMutexId;
+typedef uint8_t RtosCondId;
+typedef uint8_t RtosTaskId;
+typedef uint16_t RtosTicksRelative;
+typedef uint32_t RtosTicksAbsolute;
+
+
+
+
+#define RTOS_REENTRANT 
+#define RTOS_MUTEX_ID_ZERO ((RtosMutexId) UINT8_C(0))
+#define RTOS_MUTEX_ID_MAX ((RtosMutexId) UINT8_C(2 - 1))
+#define RTOS_MUTEX_ID_M0 ((RtosMutexId) UINT8_C(0))
+#define RTOS_MUTEX_ID_M1 ((RtosMutexId) UINT8_C(1))
+#define RTOS_COND_ID_ZERO ((RtosCondId) UINT8_C(0))
+#define RTOS_COND_ID_MAX ((RtosCondId) UINT8_C(2 - 1))
+#define RTOS_COND_ID_C0 ((RtosCondId) UINT8_C(0))
+#define RTOS_COND_ID_C1 ((RtosCondId) UINT8_C(1))
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(4 - 1))
+
+
+
+
+
+
+extern RtosTicksAbsolute rtos_timer_current_ticks;
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void rtos_mutex_lock(RtosMutexId) RTOS_REENTRANT;
+bool rtos_mutex_try_lock(RtosMutexId);
+void rtos_mutex_unlock(RtosMutexId);
+bool rtos_mutex_holder_is_current(RtosMutexId);
+void rtos_cond_wait(RtosCondId cond, RtosMutexId m) RTOS_REENTRANT;
+bool rtos_cond_wait_timeout(RtosCondId cond, RtosMutexId m,
+                                    RtosTicksRelative timeout) RTOS_REENTRANT;
+void rtos_cond_signal(RtosCondId cond);
+void rtos_cond_broadcast(RtosCondId cond);
+void pub_cond_init(void);
+void pub_set_current_task(RtosTaskId task_id);
+void pub_set_block_ptr(void (*y)(RtosTaskId));
+void pub_set_block_timeout_ptr(void (*y)(RtosTicksRelative));
+void pub_set_preempt_ptr(void (*y)(void));
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_CONDITION_VARIABLE_TEST_H */
\ No newline at end of file
@@ -0,0 +1,471 @@
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rtos-pool-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+#define ERROR_ID_NONE ((RtosErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW ((RtosErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID ((RtosErrorId) UINT8_C(2))
+#define ERROR_ID_NOT_HOLDING_MUTEX ((RtosErrorId) UINT8_C(3))
+#define ERROR_ID_DEADLOCK ((RtosErrorId) UINT8_C(4))
+#define ERROR_ID_TASK_FUNCTION_RETURNS ((RtosErrorId) UINT8_C(5))
+#define ERROR_ID_INTERNAL_CURRENT_TASK_INVALID ((RtosErrorId) UINT8_C(6))
+#define ERROR_ID_INTERNAL_INVALID_ID ((RtosErrorId) UINT8_C(7))
+#define ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP ((RtosErrorId) UINT8_C(8))
+#define ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(9))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(10))
+#define ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER ((RtosErrorId) UINT8_C(11))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW ((RtosErrorId) UINT8_C(12))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION ((RtosErrorId) UINT8_C(13))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_CONFIGURATION ((RtosErrorId) UINT8_C(14))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_HEAD ((RtosErrorId) UINT8_C(15))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE ((RtosErrorId) UINT8_C(16))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_ID_IN_WAITERS ((RtosErrorId) UINT8_C(17))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TASKS_BLOCKED_DESPITE_AVAILABLE_MESSAGES ((RtosErrorId) UINT8_C(18))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_WAITING_TASK_IS_NOT_BLOCKED ((RtosErrorId) UINT8_C(19))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGES_POINTER ((RtosErrorId) UINT8_C(20))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGE_SIZE ((RtosErrorId) UINT8_C(21))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH ((RtosErrorId) UINT8_C(22))
+#define ERROR_ID_INTERNAL_PRECONDITION_VIOLATED ((RtosErrorId) UINT8_C(23))
+#define ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED ((RtosErrorId) UINT8_C(24))
+#define ERROR_ID_SEMAPHORE_MAX_INVALID ((RtosErrorId) UINT8_C(25))
+#define ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT ((RtosErrorId) UINT8_C(26))
+#define ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT ((RtosErrorId) UINT8_C(27))
+#define ERROR_ID_SEMAPHORE_MAX_EXCEEDED ((RtosErrorId) UINT8_C(28))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED ((RtosErrorId) UINT8_C(29))
+#define ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX ((RtosErrorId) UINT8_C(30))
+#define ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED ((RtosErrorId) UINT8_C(31))
+#define ERROR_ID_SCHED_EDF_TASK_NOT_PERIODIC ((RtosErrorId) UINT8_C(32))
+#define ERROR_ID_TIMER_TASK_NOT_PERIODIC ((RtosErrorId) UINT8_C(33))
+#define ERROR_ID_POOL_INVALID_BLOCK ((RtosErrorId) UINT8_C(34))
+#define ERROR_ID_BROADCAST_NOT_SUBSCRIBED ((RtosErrorId) UINT8_C(35))
+#define ERROR_ID_BROADCAST_INVALID_POINTER ((RtosErrorId) UINT8_C(36))
+#define ERROR_ID_WORK_QUEUE_INVALID_FUNCTION ((RtosErrorId) UINT8_C(37))
+#define ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS ((RtosErrorId) UINT8_C(38))
+#define ERROR_ID_TIMEBASE_TIME_TOO_FAR ((RtosErrorId) UINT8_C(39))
+#define POOL_ID_NONE ((PoolIdOption) UINT8_MAX)
+#define POOL_BLOCK_NONE ((uint16_t) UINT16_MAX)
+#ifdef __GNUC__
+#define POOL_ALIGNED(alignment) __attribute__((aligned(alignment)))
+#else
+#define POOL_ALIGNED(alignment)
+#endif
+
+typedef RtosPoolId PoolIdOption;
+
+
+struct pool {
+    uint8_t *storage;
+    uint16_t block_stride;
+    uint16_t block_count;
+};
+
+/*
+ * The free blocks of a pool form a singly-linked list, with the index of the next free block stored in the first two
+ * bytes of each free block.
+ * The head of the list is a word that holds the index of the first free block in its lower half and a tag in its upper
+ * half.
+ * Every update of the head increments the tag, so that a compare-and-swap based on an outdated head fails even if the
+ * same block has been allocated and freed again in the meantime (the ABA problem).
+ */
+struct pool_state {
+    volatile uint32_t head;
+    volatile uint32_t used;
+    volatile uint32_t high_water_mark;
+};
+
+
+extern void test_fatal_error(RtosErrorId error_id);
+
+
+
+
+static void pool_init(void);
+static void *pool_try_alloc(RtosPoolId pool);
+static void pool_used_add(RtosPoolId pool, int32_t delta);
+static bool atomic_compare_and_swap(volatile uint32_t *word, uint32_t expected, uint32_t desired);
+static void sem_core_block(void) RTOS_REENTRANT;
+static void sem_core_block_timeout(RtosTicksRelative timeout) RTOS_REENTRANT;
+static void sem_core_unblock(RtosTaskId task);
+static RtosTaskId get_current_task(void);
+
+
+static uint8_t pool_storage_p0[4U * 8U] POOL_ALIGNED(4);
+static uint8_t pool_storage_p1[2U * 2U] POOL_ALIGNED(2);
+static const struct pool pools[2] = {
+    { pool_storage_p0, 8U, 4U },
+    { pool_storage_p1, 2U, 2U },
+};
+static struct pool_state pool_states[2];
+static PoolIdOption pool_waiters[3];
+static RtosTaskId current_task;
+static void (*interrupt_ptr)(void);
+static uint32_t interrupt_compare_and_swap_count;
+static void (*block_ptr)(void);
+static void (*block_timeout_ptr)(RtosTicksRelative);
+static jmp_buf fatal_error_jmp_buf;
+static bool fatal_error_jmp_buf_valid;
+RtosTicksAbsolute rtos_timer_current_ticks;
+bool pub_unblocked[3];
+RtosErrorId pub_fatal_error_id;
+
+#define api_error(error_id) test_fatal_error(error_id)
+#define api_assert(expression, error_id) do { if (!(expression)) { api_error(error_id); } } while(0)
+
+#define internal_error(error_id) do { } while(0)
+#define internal_assert(expression, error_id) do { } while(0)
+#define pool_block(pool, index) (&pools[pool].storage[(uint32_t) (index) * pools[pool].block_stride])
+#define pool_block_next(block) (*((volatile uint16_t *) (block)))
+#define pool_head_index(head) ((uint16_t) ((head) & 0xffffU))
+#define pool_head_next(head, index) (((((head) >> 16) + 1U) << 16) | (uint32_t) (index))
+#define assert_pool_valid(pool) api_assert(pool < 2, ERROR_ID_INVALID_ID)
+#define preempt_disable()
+#define preempt_enable()
+
+
+static void
+pool_init(void)
+{
+    RtosPoolId pool;
+    RtosTaskId t;
+    uint16_t index;
+
+    for (pool = 0; pool < 2; pool++)
+    {
+        for (index = 0; index < pools[pool].block_count; index++)
+        {
+            pool_block_next(pool_block(pool, index)) = index + 1U < pools[pool].block_count ? index + 1U : POOL_BLOCK_NONE;
+        }
+        pool_states[pool].head = 0;
+    }
+
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        pool_waiters[t] = POOL_ID_NONE;
+    }
+}
+
+static void
+pool_used_add(const RtosPoolId pool, const int32_t delta)
+{
+    struct pool_state *const state = &pool_states[pool];
+    uint32_t used;
+    uint32_t high_water_mark;
+
+    /* loop bound: retries */
+    do
+    {
+        used = state->used;
+    } while (!atomic_compare_and_swap(&state->used, used, used + (uint32_t) delta));
+
+    used += (uint32_t) delta;
+    /* loop bound: retries */
+    do
+    {
+        high_water_mark = state->high_water_mark;
+    } while (used > high_water_mark && !atomic_compare_and_swap(&state->high_water_mark, high_water_mark, used));
+}
+
+static RAMFUNC void *
+pool_try_alloc(const RtosPoolId pool)
+{
+    struct pool_state *const state = &pool_states[pool];
+    uint32_t head;
+    uint16_t index;
+    uint8_t *block;
+
+    /* loop bound: retries */
+    do
+    {
+        head = state->head;
+        index = pool_head_index(head);
+        if (index == POOL_BLOCK_NONE)
+        {
+            return NULL;
+        }
+        block = pool_block(pool, index);
+        /* If another allocation takes the block before the compare-and-swap, next may be garbage, but then the tag of
+         * the head has changed and the compare-and-swap fails. */
+    } while (!atomic_compare_and_swap(&state->head, head, pool_head_next(head, pool_block_next(block))));
+
+    pool_used_add(pool, 1);
+
+    return block;
+}
+/*
+ * The interrupt, if one is set, occurs immediately before the given compare-and-swap operation, i.e., after the
+ * caller has read the value that it expects.
+ */
+static bool
+atomic_compare_and_swap(volatile uint32_t *const word, const uint32_t expected, const uint32_t desired)
+{
+    void (*const interrupt)(void) = interrupt_ptr;
+
+    if (interrupt != NULL && --interrupt_compare_and_swap_count == 0)
+    {
+        interrupt_ptr = NULL;
+        interrupt();
+    }
+
+    if (*word != expected)
+    {
+        return false;
+    }
+    *word = desired;
+    return true;
+}
+
+/*
+ * While the current task is blocked, other tasks and interrupt handlers run in the block functions that the test sets.
+ */
+static void
+sem_core_block(void) RTOS_REENTRANT
+{
+    const RtosTaskId task = current_task;
+
+    pub_unblocked[task] = false;
+    if (block_ptr != NULL)
+    {
+        block_ptr();
+    }
+    current_task = task;
+}
+
+static void
+sem_core_block_timeout(const RtosTicksRelative timeout) RTOS_REENTRANT
+{
+    const RtosTaskId task = current_task;
+
+    pub_unblocked[task] = false;
+    if (block_timeout_ptr != NULL)
+    {
+        block_timeout_ptr(timeout);
+    }
+    current_task = task;
+}
+
+static void
+sem_core_unblock(const RtosTaskId task)
+{
+    pub_unblocked[task] = true;
+}
+
+static RtosTaskId
+get_current_task(void)
+{
+    return current_task;
+}
+
+void
+test_fatal_error(const RtosErrorId error_id)
+{
+    pub_fatal_error_id = error_id;
+    if (fatal_error_jmp_buf_valid)
+    {
+        longjmp(fatal_error_jmp_buf, 1);
+    }
+}
+
+
+void *
+rtos_pool_alloc(const RtosPoolId pool)
+{
+    assert_pool_valid(pool);
+
+    return pool_try_alloc(pool);
+}
+
+void *
+rtos_pool_alloc_wait(const RtosPoolId pool) RTOS_REENTRANT
+{
+    void *block;
+
+    assert_pool_valid(pool);
+
+    preempt_disable();
+
+    while ((block = pool_try_alloc(pool)) == NULL)
+    {
+        pool_waiters[get_current_task()] = pool;
+        sem_core_block();
+    }
+    /* A block freed by an interrupt handler does not make the task runnable, so it may still be a waiter */
+    pool_waiters[get_current_task()] = POOL_ID_NONE;
+
+    preempt_enable();
+
+    return block;
+}
+
+void *
+rtos_pool_alloc_timeout(const RtosPoolId pool, const RtosTicksRelative timeout)
+        RTOS_REENTRANT
+{
+    void *block;
+    const RtosTicksAbsolute absolute_timeout = rtos_timer_current_ticks + timeout;
+
+    assert_pool_valid(pool);
+
+    preempt_disable();
+
+    while ((block = pool_try_alloc(pool)) == NULL && absolute_timeout > rtos_timer_current_ticks)
+    {
+        pool_waiters[get_current_task()] = pool;
+        sem_core_block_timeout(absolute_timeout - rtos_timer_current_ticks);
+    }
+    pool_waiters[get_current_task()] = POOL_ID_NONE;
+
+    preempt_enable();
+
+    return block;
+}
+
+void
+rtos_pool_free(const RtosPoolId pool, void *const block)
+{
+    RtosTaskId t;
+
+    rtos_pool_free_from_interrupt(pool, block);
+
+    preempt_disable();
+
+    /* loop bound: 3 */
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        if (pool_waiters[t] == pool)
+        {
+            pool_waiters[t] = POOL_ID_NONE;
+            sem_core_unblock(t);
+        }
+    }
+
+    preempt_enable();
+}
+
+/*
+ * Interrupt handlers must not unblock tasks, so tasks waiting for a block of the pool only notice a block freed by an
+ * interrupt handler when a task frees a block or their timeout expires.
+ */
+void
+rtos_pool_free_from_interrupt(const RtosPoolId pool, void *const block)
+{
+    struct pool_state *state;
+    uint32_t offset;
+    uint16_t index;
+    uint32_t head;
+
+    assert_pool_valid(pool);
+    api_assert((uint8_t *) block >= pools[pool].storage, ERROR_ID_POOL_INVALID_BLOCK);
+
+    state = &pool_states[pool];
+    offset = (uint32_t) ((uint8_t *) block - pools[pool].storage);
+    index = (uint16_t) (offset / pools[pool].block_stride);
+    api_assert(offset % pools[pool].block_stride == 0 && offset / pools[pool].block_stride < pools[pool].block_count,
+               ERROR_ID_POOL_INVALID_BLOCK);
+    /* A block that is freed twice without being allocated in between is detected if it is still the first free block,
+     * or if no block of the pool is allocated. */
+    api_assert(pool_head_index(state->head) != index && state->used != 0, ERROR_ID_POOL_INVALID_BLOCK);
+
+    /* loop bound: retries */
+    do
+    {
+        head = state->head;
+        pool_block_next(block) = pool_head_index(head);
+    } while (!atomic_compare_and_swap(&state->head, head, pool_head_next(head, index)));
+
+    pool_used_add(pool, -1);
+}
+
+uint16_t
+rtos_pool_high_water_mark(const RtosPoolId pool)
+{
+    assert_pool_valid(pool);
+
+    return (uint16_t) pool_states[pool].high_water_mark;
+}
+void
+pub_pool_init(void)
+{
+    RtosPoolId pool;
+    RtosTaskId task_id;
+
+    /* For testing purposes, the usage statistics of the pools are reset, too */
+    pool_init();
+    for (pool = 0; pool < 2; pool++)
+    {
+        pool_states[pool].used = 0;
+        pool_states[pool].high_water_mark = 0;
+    }
+    for (task_id = RTOS_TASK_ID_ZERO; task_id <= RTOS_TASK_ID_MAX; task_id++)
+    {
+        pub_unblocked[task_id] = false;
+    }
+    current_task = RTOS_TASK_ID_ZERO;
+    interrupt_ptr = NULL;
+    block_ptr = NULL;
+    block_timeout_ptr = NULL;
+    rtos_timer_current_ticks = 0;
+    pub_fatal_error_id = ERROR_ID_NONE;
+}
+
+void
+pub_set_current_task(const RtosTaskId task_id)
+{
+    current_task = task_id;
+}
+
+void
+pub_set_interrupt_ptr(void (*y)(void), const uint32_t compare_and_swap_count)
+{
+    interrupt_ptr = y;
+    interrupt_compare_and_swap_count = compare_and_swap_count;
+}
+
+void
+pub_set_block_ptr(void (*y)(void))
+{
+    block_ptr = y;
+}
+
+void
+pub_set_block_timeout_ptr(void (*y)(RtosTicksRelative))
+{
+    block_timeout_ptr = y;
+}
+
+uint32_t
+pub_pool_head(const RtosPoolId pool)
+{
+    return pool_states[pool].head;
+}
+
+/*
+ * Free a block and return the ID of the fatal error that this raises, which does not return, or ERROR_ID_NONE.
+ */
+RtosErrorId
+pub_pool_free_fatal_error(const RtosPoolId pool, void *const block)
+{
+    pub_fatal_error_id = ERROR_ID_NONE;
+    if (setjmp(fatal_error_jmp_buf) == 0)
+    {
+        fatal_error_jmp_buf_valid = true;
+        rtos_pool_free_from_interrupt(pool, block);
+    }
+    fatal_error_jmp_buf_valid = false;
+
+    return pub_fatal_error_id;
+}
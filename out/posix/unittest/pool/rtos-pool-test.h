@@ -0,0 +1,56 @@
+#ifndef RTOS_POOL_TEST_H
+#define RTOS_POOL_TEST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint8_t RtosErrorId;
+typedef uint8_t RtosPoolId;
+typedef uint8_t RtosTaskId;
+typedef uint16_t RtosTicksRelative;
+typedef uint32_t RtosTicksAbsolute;
+
+
+
+
+#define RTOS_REENTRANT 
+
+#define RTOS_POOL_ID_P0 ((RtosPoolId) UINT8_C(0))
+#define RTOS_POOL_ID_P1 ((RtosPoolId) UINT8_C(1))
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(3 - 1))
+
+
+
+
+
+
+
+extern RtosTicksAbsolute rtos_timer_current_ticks;
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+void *rtos_pool_alloc(RtosPoolId pool);
+void *rtos_pool_alloc_wait(RtosPoolId pool) RTOS_REENTRANT;
+void *rtos_pool_alloc_timeout(RtosPoolId pool, RtosTicksRelative timeout)
+        RTOS_REENTRANT;
+void rtos_pool_free(RtosPoolId pool, void *block);
+void rtos_pool_free_from_interrupt(RtosPoolId pool, void *block);
+uint16_t rtos_pool_high_water_mark(RtosPoolId pool);
+void pub_pool_init(void);
+void pub_set_current_task(RtosTaskId task_id);
+void pub_set_interrupt_ptr(void (*y)(void), uint32_t compare_and_swap_count);
+void pub_set_block_ptr(void (*y)(void));
+void pub_set_block_timeout_ptr(void (*y)(RtosTicksRelative));
+uint32_t pub_pool_head(RtosPoolId pool);
+RtosErrorId pub_pool_free_fatal_error(RtosPoolId pool, void *block);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_POOL_TEST_H */
\ No newline at end of file
@@ -0,0 +1,193 @@
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "rtos-sched-prio-inherit-rr-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+#define SCHED_INDEX_ZERO ((SchedIndex) TASK_ID_ZERO)
+#define SCHED_LEVEL_ZERO ((SchedIndex) 0)
+#define SCHED_TIME_SLICE ((uint16_t) 2)
+
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+typedef uint8_t TaskId;
+typedef TaskId SchedIndex;
+typedef TaskId TaskIdOption;
+
+struct sched_task {
+    TaskIdOption blocked_on;
+};
+
+/*
+ * NOTE: An RTOS variant using the scheduler must ensure that tasks
+ * array is sorted by priority.
+ * Tasks of equal priority form a priority level and must be adjacent in the tasks array.
+ * The scheduler selects between the tasks of a level in round-robin order, starting with the task at the level's
+ * offset.
+ */
+struct sched {
+    struct sched_task tasks[5];
+    SchedIndex level_offsets[3];
+    TaskIdOption slice_task;
+    SchedIndex slice_level;
+    uint16_t slice_remaining;
+};
+
+
+
+
+
+static void sched_set_runnable(const TaskId task_id);
+static void sched_set_blocked_on(const TaskId task_id, const TaskId blocker);
+static TaskIdOption sched_get_next(void);
+static bool sched_time_slice_tick(void);
+
+
+
+static struct sched sched_tasks;
+/* The index of the first task of each priority level, followed by the number of tasks */
+static const SchedIndex sched_level_bounds[3 + 1] = {
+    0,
+    1,
+    4,
+    5
+};
+
+
+
+#define sched_set_blocked(task_id) sched_set_blocked_on(task_id, TASK_ID_NONE)
+#define sched_runnable(task_id) (SCHED_OBJ(task_id).blocked_on == (task_id))
+#define sched_max_index() (SchedIndex)(5 - 1U)
+#define sched_index_to_taskid(sched_index) (TaskId)(sched_index)
+#define sched_taskid_to_index(task_id) (SchedIndex)(task_id)
+#define SCHED_OBJ(task_id) sched_tasks.tasks[task_id]
+#define sched_max_level() (SchedIndex)(3 - 1U)
+#define sched_level_size(level) (SchedIndex)(sched_level_bounds[(level) + 1] - sched_level_bounds[level])
+#define sched_level_next_offset(level, offset) (SchedIndex)((offset) + 1U == sched_level_size(level) ? 0 : (offset) + 1U)
+
+#define preempt_disable()
+#define preempt_enable()
+
+static void
+sched_set_runnable(const TaskId task_id)
+{
+    SCHED_OBJ(task_id).blocked_on = task_id;
+}
+
+static void
+sched_set_blocked_on(const TaskId task_id, const TaskId blocker)
+{
+    SCHED_OBJ(task_id).blocked_on = blocker;
+}
+
+static RAMFUNC TaskIdOption
+sched_get_next(void)
+{
+    /* NOTE: In the case where assume_runnable is true and no runnable
+       tasks are found, then an undefined task will be returned from this
+       function.
+    */
+    TaskIdOption task = TASK_ID_NONE, next_task;
+    SchedIndex level, offset, count;
+
+    /* loop bound: 3 */
+    for (level = SCHED_LEVEL_ZERO; level <= sched_max_level(); level++)
+    {
+        offset = sched_tasks.level_offsets[level];
+        /* loop bound: 5 */
+        for (count = sched_level_size(level); count != 0; count--)
+        {
+            task = sched_index_to_taskid(sched_level_bounds[level] + offset);
+            /* loop bound: 5 */
+            do
+            {
+                next_task = SCHED_OBJ(task).blocked_on;
+                if (next_task == task)
+                {
+                    /* Keep selecting this task of the level until its time slice expires or it blocks */
+                    sched_tasks.level_offsets[level] = offset;
+                    goto found;
+                }
+                task = next_task;
+            }
+            while (task != TASK_ID_NONE);
+            offset = sched_level_next_offset(level, offset);
+        }
+    }
+    return TASK_ID_NONE;
+found:
+    if (task != sched_tasks.slice_task)
+    {
+        sched_tasks.slice_task = task;
+        sched_tasks.slice_level = level;
+        sched_tasks.slice_remaining = SCHED_TIME_SLICE;
+    }
+    return  task;
+}
+
+/*
+ * Called for each tick.
+ * When the time slice of the most recently selected task expires, the scheduler moves on to the next task of the
+ * priority level the task was selected from.
+ * Returns whether the time slice expired, in which case the caller must trigger a scheduling decision for the rotation
+ * to take effect.
+ */
+static bool
+sched_time_slice_tick(void)
+{
+    const SchedIndex level = sched_tasks.slice_level;
+
+    if (sched_tasks.slice_remaining > 1)
+    {
+        sched_tasks.slice_remaining--;
+        return false;
+    }
+
+    sched_tasks.level_offsets[level] = sched_level_next_offset(level, sched_tasks.level_offsets[level]);
+    sched_tasks.slice_task = TASK_ID_NONE;
+    return true;
+}
+
+
+
+
+void
+pub_sched_set_runnable(const TaskId task_id)
+{
+    sched_set_runnable(task_id);
+}
+
+void
+pub_sched_set_blocked(const TaskId task_id)
+{
+    sched_set_blocked(task_id);
+}
+
+void
+pub_sched_set_blocked_on(const TaskId task_id, const TaskId blocked_on)
+{
+    sched_set_blocked_on(task_id, blocked_on);
+}
+
+TaskIdOption
+pub_sched_get_next(void)
+{
+    return sched_get_next();
+}
+
+bool
+pub_sched_time_slice_tick(void)
+{
+    return sched_time_slice_tick();
+}
+
+struct sched * pub_sched_tasks = &sched_tasks;
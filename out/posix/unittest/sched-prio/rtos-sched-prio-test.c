@@ -0,0 +1,117 @@
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+#include "rtos-sched-prio-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+#define SCHED_INDEX_ZERO ((SchedIndex) TASK_ID_ZERO)
+#define SCHED_WORDS (((10 - 1U) / 32U) + 1U)
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+typedef uint32_t SchedWord;
+typedef uint8_t TaskId;
+typedef TaskId SchedIndex;
+typedef TaskId TaskIdOption;
+
+/*
+ * NOTE: An RTOS variant using the scheduler must ensure that tasks
+ * array is sorted by priority.
+ * The runnable tasks are a bitmap of 32 tasks per word, so that the scheduler can skip over 32 blocked tasks at a time.
+ */
+struct sched {
+    SchedWord runnable[SCHED_WORDS];
+};
+
+
+
+
+
+static void sched_set_runnable(const TaskId task_id);
+static void sched_set_blocked(const TaskId task_id);
+static TaskIdOption sched_get_next(void);
+
+
+static struct sched sched_tasks;
+
+
+#define sched_runnable(task_id) ((SCHED_WORD(task_id) & SCHED_BIT(task_id)) != 0)
+#define sched_max_index() (SchedIndex)(10 - 1U)
+#define sched_index_to_taskid(sched_index) (TaskId)(sched_index)
+#define SCHED_WORD(task_id) sched_tasks.runnable[(task_id) / 32U]
+#define SCHED_BIT(task_id) ((SchedWord) 1U << ((task_id) % 32U))
+#define preempt_disable()
+#define preempt_enable()
+
+static void
+sched_set_runnable(const TaskId task_id)
+{
+    SCHED_WORD(task_id) |= SCHED_BIT(task_id);
+}
+
+static void
+sched_set_blocked(const TaskId task_id)
+{
+    SCHED_WORD(task_id) &= ~SCHED_BIT(task_id);
+}
+
+static RAMFUNC TaskIdOption
+sched_get_next(void)
+{
+    /* NOTE: In the case where assume_runnable is true and no runnable
+       tasks are found, then an undefined task will be returned from this
+       function.
+    */
+    TaskIdOption task = TASK_ID_NONE;
+    SchedIndex word, idx;
+    SchedWord runnable;
+
+    /* loop bound: (10 - 1) / 32 + 1 */
+    for (word = 0; word < SCHED_WORDS; word++)
+    {
+        runnable = sched_tasks.runnable[word];
+        if (runnable != 0)
+        {
+            /* The lowest set bit of the first non-empty word is the runnable task with the highest priority */
+            idx = (SchedIndex) (word * 32U);
+            /* loop bound: 31 */
+            while ((runnable & 1U) == 0)
+            {
+                runnable >>= 1;
+                idx++;
+            }
+            task = sched_index_to_taskid(idx);
+            break;
+        }
+    }
+
+    return task;
+}
+
+
+
+void
+pub_sched_set_runnable(const TaskId task_id)
+{
+    sched_set_runnable(task_id);
+}
+
+void
+pub_sched_set_blocked(const TaskId task_id)
+{
+    sched_set_blocked(task_id);
+}
+
+TaskIdOption
+pub_sched_get_next(void)
+{
+    return sched_get_next();
+}
+
+struct sched * pub_sched_tasks = &sched_tasks;
@@ -0,0 +1,103 @@
+
+#include <stdbool.h>
+#include "rtos-simple-mutex-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+
+
+
+
+struct mutex {
+    bool locked;
+};
+
+
+
+
+
+
+
+
+static struct mutex mutexes[10];
+
+
+#define assert_mutex_valid(mutex) api_assert(mutex < 10, ERROR_ID_INVALID_ID)
+#define preempt_enable()
+#define preempt_disable()
+#define api_assert(expression, error_id) do { } while(0)
+
+static bool
+internal_mutex_try_lock(const RtosMutexId m)
+{
+    if (mutexes[m].locked)
+    {
+        return false;
+    }
+    else
+    {
+        mutexes[m].locked = true;
+        return true;
+    }
+}
+
+
+void
+rtos_mutex_lock(const RtosMutexId m) RTOS_REENTRANT
+{
+    assert_mutex_valid(m);
+
+    preempt_disable();
+
+    while (!internal_mutex_try_lock(m))
+    {
+        rtos_yield();
+    }
+
+    preempt_enable();
+}
+
+void
+rtos_mutex_unlock(const RtosMutexId m)
+{
+    assert_mutex_valid(m);
+
+    /* Note: assumes writing a single word is atomic */
+    mutexes[m].locked = false;
+}
+
+bool
+rtos_mutex_try_lock(const RtosMutexId m)
+{
+    bool r;
+
+    assert_mutex_valid(m);
+
+    preempt_disable();
+    r = internal_mutex_try_lock(m);
+    preempt_enable();
+
+    return r;
+}
+
+void (*yield_ptr)(void);
+struct mutex * pub_mutexes = mutexes;
+
+void pub_set_yield_ptr(void (*y)(void))
+{
+    yield_ptr = y;
+}
+
+void rtos_yield(void) RTOS_REENTRANT
+{
+    if (yield_ptr != NULL)
+    {
+        yield_ptr();
+    }
+}
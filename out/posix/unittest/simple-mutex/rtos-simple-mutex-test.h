@@ -0,0 +1,44 @@
+#ifndef RTOS_SIMPLE_MUTEX_TEST_H
+#define RTOS_SIMPLE_MUTEX_TEST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+typedef uint8_t RtosMutexId;
+
+
+
+
+#define RTOS_REENTRANT 
+#define RTOS_MUTEX_ID_M1 ((RtosMutexId) UINT8_C(0))
+#define RTOS_MUTEX_ID_M2 ((RtosMutexId) UINT8_C(1))
+#define RTOS_MUTEX_ID_M3 ((RtosMutexId) UINT8_C(2))
+#define RTOS_MUTEX_ID_M4 ((RtosMutexId) UINT8_C(3))
+#define RTOS_MUTEX_ID_M5 ((RtosMutexId) UINT8_C(4))
+#define RTOS_MUTEX_ID_M6 ((RtosMutexId) UINT8_C(5))
+#define RTOS_MUTEX_ID_M7 ((RtosMutexId) UINT8_C(6))
+#define RTOS_MUTEX_ID_M8 ((RtosMutexId) UINT8_C(7))
+#define RTOS_MUTEX_ID_M9 ((RtosMutexId) UINT8_C(8))
+#define RTOS_MUTEX_ID_M10 ((RtosMutexId) UINT8_C(9))
+
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void rtos_mutex_lock(RtosMutexId) RTOS_REENTRANT;
+bool rtos_mutex_try_lock(RtosMutexId);
+void rtos_mutex_unlock(RtosMutexId);
+void rtos_yield(void) RTOS_REENTRANT;
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_SIMPLE_MUTEX_TEST_H */
\ No newline at end of file
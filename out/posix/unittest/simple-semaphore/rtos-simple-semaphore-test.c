@@ -0,0 +1,202 @@
+
+
+
+#include <stdio.h>
+#include <stddef.h>
+#include "rtos-simple-semaphore-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+
+#define SEM_ID_NONE ((SemIdOption) UINT8_MAX)
+#define SEM_VALUE_ZERO ((RtosSemValue) UINT8_C(0))
+
+typedef RtosSemId SemIdOption;
+
+
+struct semaphore {
+    RtosSemValue value;
+};
+
+
+
+
+
+
+
+static bool internal_sem_try_wait(const RtosSemId s);
+
+
+
+static struct semaphore semaphores[10];
+static SemIdOption sem_waiters[10];
+static void (*block_ptr)(void);
+static void (*unblock_ptr)(RtosTaskId);
+static RtosTaskId (*get_current_task_ptr)(void);
+
+#define preempt_disable()
+#define preempt_enable()
+#define preempt_clear()
+#define precondition_preemption_disabled()
+#define postcondition_preemption_disabled()
+#define assert_sem_valid(sem) api_assert(sem < 10, ERROR_ID_INVALID_ID)
+#define sem_core_block() block()
+#define sem_core_unblock(task_id) unblock(task_id)
+#define api_assert(expression, error_id) do { } while(0)
+
+
+static void
+sem_init(void)
+{
+    RtosTaskId t;
+
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        sem_waiters[t] = SEM_ID_NONE;
+    }
+}
+
+static bool
+internal_sem_try_wait(const RtosSemId s)
+{
+    precondition_preemption_disabled();
+
+    if (semaphores[s].value == SEM_VALUE_ZERO)
+    {
+        return false;
+    }
+    else
+    {
+        semaphores[s].value--;
+        return true;
+    }
+
+    postcondition_preemption_disabled();
+}
+static void
+block(void) RTOS_REENTRANT
+{
+    if (block_ptr != NULL)
+    {
+        block_ptr();
+    }
+}
+
+static void
+unblock(RtosTaskId task_id)
+{
+    if (unblock_ptr != NULL)
+    {
+        unblock_ptr(task_id);
+    }
+}
+
+static RtosTaskId
+get_current_task(void)
+{
+    if (get_current_task_ptr != NULL)
+    {
+        return get_current_task_ptr();
+    }
+
+    return RTOS_TASK_ID_ZERO;
+}
+
+
+void
+rtos_sem_wait(const RtosSemId s) RTOS_REENTRANT
+{
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+    while (!internal_sem_try_wait(s))
+    {
+        sem_waiters[get_current_task()] = s;
+        sem_core_block();
+    }
+
+    preempt_enable();
+}
+
+
+void
+rtos_sem_post(const RtosSemId s)
+{
+    RtosTaskId t;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+
+    if (semaphores[s].value == SEM_VALUE_ZERO)
+    {
+        /* loop bound: 10 */
+        for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+        {
+            if (sem_waiters[t] == s)
+            {
+                sem_waiters[t] = SEM_ID_NONE;
+                sem_core_unblock(t);
+            }
+        }
+    }
+
+    semaphores[s].value++;
+
+    preempt_enable();
+}
+
+bool
+rtos_sem_try_wait(const RtosSemId s)
+{
+    bool r;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+    r = internal_sem_try_wait(s);
+    preempt_enable();
+
+    return r;
+}
+
+
+struct semaphore * pub_semaphores = semaphores;
+RtosTaskId * pub_waiters = sem_waiters;
+
+void pub_set_block_ptr(void (*fn)(void))
+{
+    block_ptr = fn;
+}
+
+void pub_set_unblock_ptr(void (*fn)(RtosTaskId))
+{
+    unblock_ptr = fn;
+}
+
+void pub_set_get_current_task_ptr(RtosTaskId (*y)(void))
+{
+    get_current_task_ptr = y;
+}
+
+void pub_sem_init(void)
+{
+    RtosSemId sem_id;
+    sem_init();
+    /* For testing purposes we also reset the value of all semaphores to zero */
+    for (sem_id = RTOS_SEM_ID_ZERO; sem_id <= RTOS_SEM_ID_MAX; sem_id++)
+    {
+        semaphores[sem_id].value = SEM_VALUE_ZERO;
+    }
+    block_ptr = NULL;
+    unblock_ptr = NULL;
+    get_current_task_ptr = NULL;
+}
@@ -0,0 +1,55 @@
+#ifndef RTOS_SIMPLE_SEMAPHORE_TEST_H
+#define RTOS_SIMPLE_SEMAPHORE_TEST_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+
+typedef uint8_t RtosSemId;
+typedef uint8_t RtosSemValue;
+typedef uint8_t RtosTaskId;
+
+
+
+
+#define RTOS_REENTRANT 
+
+#define RTOS_SEM_ID_ZERO ((RtosSemId) UINT8_C(0))
+#define RTOS_SEM_ID_MAX ((RtosSemId) UINT8_C(10 - 1))
+#define RTOS_SEM_ID_S0 ((RtosSemId) UINT8_C(0))
+#define RTOS_SEM_ID_S1 ((RtosSemId) UINT8_C(1))
+#define RTOS_SEM_ID_S2 ((RtosSemId) UINT8_C(2))
+#define RTOS_SEM_ID_S3 ((RtosSemId) UINT8_C(3))
+#define RTOS_SEM_ID_S4 ((RtosSemId) UINT8_C(4))
+#define RTOS_SEM_ID_S5 ((RtosSemId) UINT8_C(5))
+#define RTOS_SEM_ID_S6 ((RtosSemId) UINT8_C(6))
+#define RTOS_SEM_ID_S7 ((RtosSemId) UINT8_C(7))
+#define RTOS_SEM_ID_S8 ((RtosSemId) UINT8_C(8))
+#define RTOS_SEM_ID_S9 ((RtosSemId) UINT8_C(9))
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(10 - 1))
+
+
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+void rtos_sem_post(RtosSemId);
+bool rtos_sem_try_wait(RtosSemId);
+void rtos_sem_wait(RtosSemId) RTOS_REENTRANT;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_SIMPLE_SEMAPHORE_TEST_H */
\ No newline at end of file
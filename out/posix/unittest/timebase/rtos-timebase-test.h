@@ -0,0 +1,56 @@
+#ifndef RTOS_TIMEBASE_TEST_H
+#define RTOS_TIMEBASE_TEST_H
+
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+
+typedef uint8_t RtosErrorId;
+
+typedef uint8_t RtosTaskId;
+typedef uint8_t RtosTimerId;
+typedef uint16_t RtosTicksRelative;
+typedef uint32_t RtosTicksAbsolute;
+
+
+/* A network time, e.g., a PTP timestamp, in seconds and nanoseconds since the epoch of the network's time scale */
+typedef struct {
+    uint32_t seconds;
+    uint32_t nanoseconds;
+} RtosNetworkTime;
+
+#define RTOS_REENTRANT 
+
+#define RTOS_TIMEBASE_TICK_CYCLES UINT32_C(3000)
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(2 - 1))
+
+
+
+
+
+
+
+extern RtosTicksAbsolute rtos_timer_current_ticks;
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+uint32_t rtos_timebase_tick(void);
+uint32_t rtos_timebase_cycles(void);
+void rtos_timebase_now(RtosNetworkTime *time);
+void rtos_timebase_from_cycles(uint32_t cycles, RtosNetworkTime *time);
+void rtos_timebase_set(const RtosNetworkTime *time);
+void rtos_timebase_adjust(int32_t ppb);
+void rtos_timer_oneshot_at(RtosTimerId timer_id, const RtosNetworkTime *time);
+void rtos_sleep_until(const RtosNetworkTime *time) RTOS_REENTRANT;
+void rtos_timer_tick(void);
+void pub_timebase_init(void);
+void pub_set_current_task(RtosTaskId task_id);
+void pub_set_interrupt_ptr(void (*y)(void));
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_TIMEBASE_TEST_H */
\ No newline at end of file
@@ -0,0 +1,575 @@
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "rtos-timer-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+#define TIMER_ID_ZERO ((RtosTimerId) UINT8_C(0))
+#define TIMER_ID_MAX ((RtosTimerId) UINT8_C(2 - 1U))
+#define TIMER_WORDS 1U
+#define PERIODIC_INDEX_MAX ((PeriodicIndex) UINT8_C(2 - 1U))
+#define PERIODIC_INDEX_NONE ((PeriodicIndex) UINT8_MAX)
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+#define ERROR_ID_NONE ((RtosErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW ((RtosErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID ((RtosErrorId) UINT8_C(2))
+#define ERROR_ID_TIMER_TASK_NOT_PERIODIC ((RtosErrorId) UINT8_C(3))
+#define ERROR_ID_TEST_WAIT_TIMEOUT ((RtosErrorId) UINT8_C(4))
+#define TEST_WAIT_TICKS_MAX 0x10000UL
+typedef uint16_t TicksTimeout;
+typedef uint32_t TimerWord;
+typedef uint8_t PeriodicIndex;
+typedef RtosTaskId TaskIdOption;
+
+struct periodic_task
+{
+    /* The nominal release time of the current job, or of the job before the first one */
+    RtosTicksAbsolute release;
+    RtosTicksRelative period;
+    RtosTicksRelative deadline;
+    RtosTaskId task_id;
+    RtosSignalSet signal_set;
+    bool job_active;
+    RtosTicksRelative job_jitter;
+};
+
+
+
+
+
+static void timer_process_one(RtosTimerId timer_id);
+static void timer_enable(RtosTimerId timer_id);
+static void timer_oneshot(RtosTimerId timer_id, RtosTicksRelative timeout);
+static void timer_tick_process(void);
+static void periodic_release_process(void);
+static PeriodicIndex periodic_index_get(RtosTaskId task_id);
+static void periodic_stats_record(PeriodicIndex idx, RtosTicksRelative jitter,
+                                  RtosTicksRelative response);
+static bool signal_pending(RtosTaskId task_id, RtosSignalSet signal_set);
+static void signal_send_set(RtosTaskId task_id, RtosSignalSet signal_set);
+static RtosSignalSet signal_wait_set(RtosSignalSet requested_set) RTOS_REENTRANT;
+static void signal_wait(RtosSignalId signal_id) RTOS_REENTRANT;
+static uint8_t timer_pending_ticks_get_and_clear_atomically(void);
+static RtosTaskId get_current_task(void);
+static void test_fatal_error(RtosErrorId error_id);
+
+RtosTicksAbsolute rtos_timer_current_ticks;
+/*
+ * The state of the timers is laid out as one array per field, indexed by timer ID.
+ * The enabled and overflow flags are packed into bitmaps of 32 timers per word, so that tick processing only visits
+ * the enabled timers.
+ */
+static TimerWord timers_enabled[TIMER_WORDS] = {
+    UINT32_C(0x0),
+};
+static TimerWord timers_overflow[TIMER_WORDS];
+static TicksTimeout timer_expiries[2] = {
+    0,
+    0,
+};
+static RtosTicksRelative timer_reloads[2] = {
+    0,
+    0,
+};
+/* When the error ID of a timer is not ERROR_ID_NONE, the timer calls the application error function with it */
+static RtosErrorId timer_error_ids[2] = {
+    0,
+    0,
+};
+static RtosTaskId timer_task_ids[2] = {
+    RTOS_TASK_ID_T0,
+    RTOS_TASK_ID_T1,
+};
+static RtosSignalSet timer_signal_sets[2] = {
+    RTOS_SIGNAL_SET__TASK_TIMER,
+    RTOS_SIGNAL_SET__TASK_TIMER,
+};
+static struct periodic_task periodic_tasks[2] = {
+    {
+        (RtosTicksAbsolute) 5 - 10,
+        10,
+        10,
+        RTOS_TASK_ID_T0,
+        RTOS_SIGNAL_SET_RELEASE_T0,
+        false,
+        0
+    },
+    {
+        (RtosTicksAbsolute) 100 - 20,
+        20,
+        8,
+        RTOS_TASK_ID_T1,
+        RTOS_SIGNAL_SET_RELEASE_T1,
+        false,
+        0
+    },
+};
+RtosPeriodicStats rtos_periodic_stats[2] = {
+    RTOS_PERIODIC_STATS_INIT,
+    RTOS_PERIODIC_STATS_INIT,
+};
+static RtosSignalSet pending_signals[2];
+static RtosTaskId current_task;
+static uint8_t pending_ticks;
+static const RtosTimerId task_timers[2] = {
+    RTOS_TIMER_ID__TASK_T0,
+    RTOS_TIMER_ID__TASK_T1,
+};
+RtosErrorId pub_fatal_error_id;
+
+#define TIMER_WORD(timer_id) ((timer_id) / 32U)
+#define TIMER_BIT(timer_id) ((TimerWord) 1U << ((timer_id) % 32U))
+#define timer_is_enabled(timer_id) ((timers_enabled[TIMER_WORD(timer_id)] & TIMER_BIT(timer_id)) != 0)
+#define timer_is_periodic(timer_id) (timer_reloads[timer_id] > 0)
+#define timer_reload_set(timer_id, ticks) timer_reloads[timer_id] = ticks
+#define timer_disable(timer_id) timers_enabled[TIMER_WORD(timer_id)] &= ~TIMER_BIT(timer_id)
+#define current_timeout() ((TicksTimeout) rtos_timer_current_ticks)
+#define assert_timer_valid(timer) api_assert(timer_id < 2, ERROR_ID_INVALID_ID)
+#define periodic_ticks_clamp(ticks) \
+    ((ticks) > UINT16_MAX ? (RtosTicksRelative) UINT16_MAX :\
+     (RtosTicksRelative) (ticks))
+#define preempt_disable()
+#define preempt_enable()
+#define precondition_preemption_disabled()
+#define postcondition_preemption_disabled()
+#define api_assert(expression, error_id) do { } while(0)
+
+static void
+timer_process_one(const RtosTimerId timer_id)
+{
+    precondition_preemption_disabled();
+
+    if (timer_is_periodic(timer_id))
+    {
+        timer_expiries[timer_id] += timer_reloads[timer_id];
+    }
+    else
+    {
+        timer_disable(timer_id);
+    }
+
+    if (timer_error_ids[timer_id] != ERROR_ID_NONE)
+    {
+        test_fatal_error(timer_error_ids[timer_id]);
+    }
+    else
+    {
+        if (signal_pending(timer_task_ids[timer_id], timer_signal_sets[timer_id]))
+        {
+            timers_overflow[TIMER_WORD(timer_id)] |= TIMER_BIT(timer_id);
+        }
+        signal_send_set(timer_task_ids[timer_id], timer_signal_sets[timer_id]);
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_enable(const RtosTimerId timer_id)
+{
+    precondition_preemption_disabled();
+
+    if (timer_reloads[timer_id] == 0)
+    {
+        timer_process_one(timer_id);
+    }
+    else
+    {
+        timer_expiries[timer_id] = current_timeout() + timer_reloads[timer_id];
+        timers_enabled[TIMER_WORD(timer_id)] |= TIMER_BIT(timer_id);
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_oneshot(const RtosTimerId timer_id, const RtosTicksRelative timeout)
+{
+    precondition_preemption_disabled();
+
+    timer_reload_set(timer_id, timeout);
+    timer_enable(timer_id);
+    timer_reload_set(timer_id, 0);
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_tick_process(void)
+{
+    precondition_preemption_disabled();
+    {
+        const uint8_t pending_ticks = timer_pending_ticks_get_and_clear_atomically();
+
+        if (pending_ticks > 1)
+        {
+            test_fatal_error(ERROR_ID_TICK_OVERFLOW);
+        }
+
+        if (pending_ticks)
+        {
+            RtosTimerId word, timer_id;
+            TimerWord enabled;
+            TicksTimeout timeout;
+
+            rtos_timer_current_ticks++;
+            periodic_release_process();
+
+            timeout = current_timeout();
+
+            /* loop bound: 1 */
+            for (word = 0; word < TIMER_WORDS; word++)
+            {
+                /* Visit the enabled timers of the word, up to the last one */
+                enabled = timers_enabled[word];
+                /* loop bound: 32 */
+                for (timer_id = (RtosTimerId) (word * 32U); enabled != 0; timer_id++, enabled >>= 1)
+                {
+                    if ((enabled & 1U) != 0 && timer_expiries[timer_id] == timeout)
+                    {
+                        timer_process_one(timer_id);
+                    }
+                }
+            }
+        }
+    }
+    postcondition_preemption_disabled();
+}
+
+/*
+ * Signal the tasks whose next job is released at the current tick.
+ * If a task is still executing an earlier job, the signal remains pending and periodic_wait_next() checks the release
+ * time rather than relying on the number of signals received.
+ */
+static void
+periodic_release_process(void)
+{
+    PeriodicIndex idx;
+    struct periodic_task *periodic;
+
+    precondition_preemption_disabled();
+
+    /* loop bound: 2 */
+    for (idx = 0; idx <= PERIODIC_INDEX_MAX; idx++)
+    {
+        periodic = &periodic_tasks[idx];
+        if (rtos_timer_current_ticks == periodic->release + periodic->period)
+        {
+            signal_send_set(periodic->task_id, periodic->signal_set);
+        }
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static PeriodicIndex
+periodic_index_get(const RtosTaskId task_id)
+{
+    PeriodicIndex idx;
+
+    /* loop bound: 2 */
+    for (idx = 0; idx <= PERIODIC_INDEX_MAX; idx++)
+    {
+        if (periodic_tasks[idx].task_id == task_id)
+        {
+            return idx;
+        }
+    }
+
+    return PERIODIC_INDEX_NONE;
+}
+
+static void
+periodic_stats_record(const PeriodicIndex idx, const RtosTicksRelative jitter,
+                      const RtosTicksRelative response)
+{
+    RtosPeriodicStats *const stats = &rtos_periodic_stats[idx];
+
+    stats->jobs++;
+    if (response > periodic_tasks[idx].deadline)
+    {
+        stats->deadline_misses++;
+    }
+
+    stats->jitter_total += jitter;
+    if (jitter < stats->jitter_min)
+    {
+        stats->jitter_min = jitter;
+    }
+    if (jitter > stats->jitter_max)
+    {
+        stats->jitter_max = jitter;
+    }
+
+    stats->response_total += response;
+    if (response < stats->response_min)
+    {
+        stats->response_min = response;
+    }
+    if (response > stats->response_max)
+    {
+        stats->response_max = response;
+    }
+}
+static bool
+signal_pending(const RtosTaskId task_id, const RtosSignalSet signal_set)
+{
+    return (pending_signals[task_id] & signal_set) != 0;
+}
+
+static void
+signal_send_set(const RtosTaskId task_id, const RtosSignalSet signal_set)
+{
+    pending_signals[task_id] |= signal_set;
+}
+
+/*
+ * While the current task waits for signals, ticks pass until one of the requested signals is pending.
+ */
+static RtosSignalSet
+signal_wait_set(const RtosSignalSet requested_set) RTOS_REENTRANT
+{
+    RtosSignalSet received_set;
+    unsigned long ticks = 0;
+
+    while ((pending_signals[current_task] & requested_set) == 0)
+    {
+        if (++ticks > TEST_WAIT_TICKS_MAX)
+        {
+            test_fatal_error(ERROR_ID_TEST_WAIT_TIMEOUT);
+            return RTOS_SIGNAL_SET_EMPTY;
+        }
+        pub_tick();
+    }
+
+    received_set = pending_signals[current_task] & requested_set;
+    pending_signals[current_task] &= ~requested_set;
+
+    return received_set;
+}
+
+static void
+signal_wait(const RtosSignalId signal_id) RTOS_REENTRANT
+{
+    (void) signal_wait_set((RtosSignalSet) (1U << signal_id));
+}
+
+static uint8_t
+timer_pending_ticks_get_and_clear_atomically(void)
+{
+    const uint8_t ticks = pending_ticks;
+
+    pending_ticks = 0;
+
+    return ticks;
+}
+
+static RtosTaskId
+get_current_task(void)
+{
+    return current_task;
+}
+
+static void
+test_fatal_error(const RtosErrorId error_id)
+{
+    pub_fatal_error_id = error_id;
+}
+
+void
+rtos_sleep(const RtosTicksRelative ticks) RTOS_REENTRANT
+{
+    preempt_disable();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    signal_wait(RTOS_SIGNAL_ID__TASK_TIMER);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_enable(const RtosTimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_enable(timer_id);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_disable(const RtosTimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_disable(timer_id);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_oneshot(const RtosTimerId timer_id, const RtosTicksRelative timeout)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_oneshot(timer_id, timeout);
+
+    preempt_enable();
+}
+
+bool
+rtos_timer_check_overflow(const RtosTimerId timer_id)
+{
+    bool r;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    r = (timers_overflow[TIMER_WORD(timer_id)] & TIMER_BIT(timer_id)) != 0;
+    timers_overflow[TIMER_WORD(timer_id)] &= ~TIMER_BIT(timer_id);
+
+    preempt_enable();
+
+    return r;
+}
+
+RtosTicksRelative
+rtos_timer_remaining(const RtosTimerId timer_id)
+{
+    RtosTicksRelative remaining;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    remaining = timer_is_enabled(timer_id) ? timer_expiries[timer_id] - current_timeout() : 0;
+
+    preempt_enable();
+
+    return remaining;
+}
+
+/* Configuration functions */
+void
+rtos_timer_reload_set(const RtosTimerId timer_id, const RtosTicksRelative reload)
+{
+    assert_timer_valid(timer_id);
+
+    timer_reload_set(timer_id, reload);
+}
+
+void
+rtos_timer_signal_set(const RtosTimerId timer_id, const RtosTaskId task_id, const RtosSignalSet signal_set)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_error_ids[timer_id] = ERROR_ID_NONE;
+    timer_task_ids[timer_id] = task_id;
+    timer_signal_sets[timer_id] = signal_set;
+
+    preempt_enable();
+}
+
+void
+rtos_timer_error_set(const RtosTimerId timer_id, const RtosErrorId error_id)
+{
+    assert_timer_valid(timer_id);
+
+    timer_error_ids[timer_id] = error_id;
+}
+
+void
+rtos_periodic_wait_next(void) RTOS_REENTRANT
+{
+    const PeriodicIndex idx = periodic_index_get(get_current_task());
+    struct periodic_task *periodic;
+    RtosTicksAbsolute release;
+
+    api_assert(idx != PERIODIC_INDEX_NONE, ERROR_ID_TIMER_TASK_NOT_PERIODIC);
+    periodic = &periodic_tasks[idx];
+
+    preempt_disable();
+
+    if (periodic->job_active)
+    {
+        periodic_stats_record(idx, periodic->job_jitter,
+                              periodic_ticks_clamp(rtos_timer_current_ticks - periodic->release));
+    }
+
+    /*
+     * The release time of the current job determines when periodic_release_process() signals the next one, so it
+     * only advances once the next job is released
+     */
+    release = periodic->release + periodic->period;
+    while ((int32_t) (rtos_timer_current_ticks - release) < 0)
+    {
+        (void) signal_wait_set(periodic->signal_set);
+    }
+    periodic->release = release;
+
+    periodic->job_jitter = periodic_ticks_clamp(rtos_timer_current_ticks - release);
+    periodic->job_active = true;
+
+    preempt_enable();
+}
+
+void
+rtos_periodic_stats_clear(void)
+{
+    PeriodicIndex idx;
+    const RtosPeriodicStats initial_stats = RTOS_PERIODIC_STATS_INIT;
+
+    preempt_disable();
+
+    /* loop bound: 2 */
+    for (idx = 0; idx <= PERIODIC_INDEX_MAX; idx++)
+    {
+        rtos_periodic_stats[idx] = initial_stats;
+    }
+
+    preempt_enable();
+}
+void
+pub_tick(void)
+{
+    pending_ticks = 1;
+    timer_tick_process();
+}
+
+void
+pub_set_current_task(const RtosTaskId task_id)
+{
+    current_task = task_id;
+}
+
+void
+pub_timer_init(void)
+{
+    RtosTaskId task_id;
+
+    /* For testing purposes, signals and errors are reset, but timers keep their state */
+    for (task_id = RTOS_TASK_ID_ZERO; task_id <= RTOS_TASK_ID_MAX; task_id++)
+    {
+        pending_signals[task_id] = RTOS_SIGNAL_SET_EMPTY;
+    }
+    current_task = RTOS_TASK_ID_ZERO;
+    pub_fatal_error_id = ERROR_ID_NONE;
+}
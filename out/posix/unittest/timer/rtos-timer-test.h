@@ -0,0 +1,72 @@
+#ifndef RTOS_TIMER_TEST_H
+#define RTOS_TIMER_TEST_H
+
+#include <stdint.h>
+#include <stdint.h>
+
+typedef uint8_t RtosTimerId;
+typedef uint32_t RtosTicksAbsolute;
+typedef uint16_t RtosTicksRelative;
+typedef uint8_t RtosTaskId;
+typedef uint8_t RtosSignalId;
+typedef uint8_t RtosSignalSet;
+typedef uint8_t RtosErrorId;
+
+/* The timing statistics of the completed jobs of a periodic task, in ticks.
+ * The averages are the totals divided by the number of jobs. */
+typedef struct {
+    uint32_t jobs;
+    uint32_t deadline_misses;
+    uint32_t jitter_total;
+    uint32_t response_total;
+    RtosTicksRelative jitter_min;
+    RtosTicksRelative jitter_max;
+    RtosTicksRelative response_min;
+    RtosTicksRelative response_max;
+} RtosPeriodicStats;
+
+#define RTOS_REENTRANT 
+#define RTOS_TIMER_ID__TASK_T0 ((RtosTimerId) UINT8_C(0))
+#define RTOS_TIMER_ID__TASK_T1 ((RtosTimerId) UINT8_C(1))
+
+#define RTOS_PERIODIC_STATS_INIT \
+    { 0, 0, 0, 0, UINT16_MAX, 0, UINT16_MAX, 0 }
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(2 - 1))
+#define RTOS_TASK_ID_T0 ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_T1 ((RtosTaskId) UINT8_C(1))
+#define RTOS_SIGNAL_SET_EMPTY ((RtosSignalSet) UINT8_C(0))
+#define RTOS_SIGNAL_ID_RELEASE_T0 ((RtosSignalId) UINT8_C(0))
+#define RTOS_SIGNAL_SET_RELEASE_T0 ((RtosSignalSet) UINT8_C(1U << 0))
+#define RTOS_SIGNAL_ID_RELEASE_T1 ((RtosSignalId) UINT8_C(1))
+#define RTOS_SIGNAL_SET_RELEASE_T1 ((RtosSignalSet) UINT8_C(1U << 1))
+#define RTOS_SIGNAL_ID__TASK_TIMER ((RtosSignalId) UINT8_C(2))
+#define RTOS_SIGNAL_SET__TASK_TIMER ((RtosSignalSet) UINT8_C(1U << 2))
+
+
+
+
+extern RtosTicksAbsolute rtos_timer_current_ticks;
+extern RtosPeriodicStats rtos_periodic_stats[2];
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void rtos_sleep(RtosTicksRelative ticks) RTOS_REENTRANT;
+void rtos_timer_enable(RtosTimerId timer_id);
+void rtos_timer_disable(RtosTimerId timer_id);
+void rtos_timer_oneshot(RtosTimerId timer_id, RtosTicksRelative timeout);
+bool rtos_timer_check_overflow(RtosTimerId timer_id);
+RtosTicksRelative rtos_timer_remaining(RtosTimerId timer_id);
+void rtos_timer_reload_set(RtosTimerId timer_id, RtosTicksRelative reload);
+void rtos_timer_error_set(RtosTimerId timer_id, RtosErrorId error_id);
+void rtos_timer_signal_set(RtosTimerId timer_id, RtosTaskId task_id, RtosSignalSet signal_set);
+void rtos_periodic_wait_next(void) RTOS_REENTRANT;
+void rtos_periodic_stats_clear(void);
+void pub_tick(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_TIMER_TEST_H */
\ No newline at end of file
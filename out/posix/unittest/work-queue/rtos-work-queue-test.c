@@ -0,0 +1,392 @@
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rtos-work-queue-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+
+
+typedef uint8_t WorkerIndex;
+
+/*
+ * The slots of a work queue form a bounded ring that multiple producers and consumers access without locks.
+ * The sequence number of a slot tells which position of the ring the slot can hold next:
+ * a slot at position pos is free for a producer if its sequence is pos, and holds an item for a consumer if its
+ * sequence is pos + 1.
+ * Producers and consumers claim positions with a compare-and-swap on enqueue_pos and dequeue_pos, respectively, and
+ * release the slot by updating its sequence once they have written or read the item.
+ */
+struct work_slot {
+    volatile uint32_t sequence;
+    /* The item fields are volatile so that the compiler keeps their accesses ordered with those of the sequence */
+    RtosWorkFunction volatile function;
+    void *volatile context;
+};
+
+struct work_queue {
+    struct work_slot *slots;
+    uint32_t mask;
+    WorkerIndex first_worker;
+    WorkerIndex worker_count;
+};
+
+struct work_queue_worker {
+    RtosTaskId task;
+    RtosInterruptEventId interrupt_event;
+};
+
+struct work_queue_state {
+    volatile uint32_t enqueue_pos;
+    volatile uint32_t dequeue_pos;
+};
+
+
+
+
+
+static void work_queue_init(void);
+static bool work_queue_enqueue(RtosWorkQueueId work_queue, RtosWorkFunction function,
+                               void *context);
+static bool work_queue_dequeue(RtosWorkQueueId work_queue, RtosWorkFunction *function,
+                               void **context);
+static bool atomic_compare_and_swap(volatile uint32_t *word, uint32_t expected, uint32_t desired);
+static void signal_send_set(RtosTaskId task_id, RtosSignalSet signals);
+
+static struct work_slot work_queue_q0_slots[4];
+static struct work_slot work_queue_q1_slots[2];
+static const struct work_queue work_queues[2] = {
+    { work_queue_q0_slots, 4U - 1U, 0, 2 },
+    { work_queue_q1_slots, 2U - 1U, 2, 1 },
+};
+static const struct work_queue_worker work_queue_workers[3] = {
+    { RTOS_TASK_ID_T1, RTOS_INTERRUPT_EVENT_ID__WORK_Q0_T1 },
+    { RTOS_TASK_ID_T2, RTOS_INTERRUPT_EVENT_ID__WORK_Q0_T2 },
+    { RTOS_TASK_ID_T3, RTOS_INTERRUPT_EVENT_ID__WORK_Q1_T3 },
+};
+static struct work_queue_state work_queue_states[2];
+static void (*interrupt_ptr)(void);
+static uint32_t interrupt_compare_and_swap_count;
+static bool (*wait_ptr)(void);
+static jmp_buf worker_jmp_buf;
+RtosSignalSet pub_signals[4];
+bool pub_interrupt_events[3];
+uint32_t pub_waits;
+
+#define assert_work_queue_valid(work_queue) api_assert(work_queue < 2, ERROR_ID_INVALID_ID)
+#define preempt_disable()
+#define preempt_enable()
+#define api_assert(expression, error_id) do { } while(0)
+
+static void
+work_queue_init(void)
+{
+    RtosWorkQueueId work_queue;
+    uint32_t pos;
+
+    for (work_queue = 0; work_queue < 2; work_queue++)
+    {
+        for (pos = 0; pos <= work_queues[work_queue].mask; pos++)
+        {
+            work_queues[work_queue].slots[pos].sequence = pos;
+        }
+    }
+}
+
+/*
+ * Tasks and interrupt handlers may enqueue concurrently.
+ * A producer that is interrupted after claiming a position but before releasing its slot delays consumers until it
+ * continues, but it never blocks other producers.
+ * Since producers wake up the workers only after releasing the slot, a worker that finds the slot not yet released
+ * and waits is woken up again.
+ */
+static bool
+work_queue_enqueue(const RtosWorkQueueId work_queue, const RtosWorkFunction function,
+                   void *const context)
+{
+    const struct work_queue *const q = &work_queues[work_queue];
+    struct work_queue_state *const state = &work_queue_states[work_queue];
+    struct work_slot *slot;
+    uint32_t pos;
+
+    /* loop bound: retries */
+    for (;;)
+    {
+        pos = state->enqueue_pos;
+        slot = &q->slots[pos & q->mask];
+        if (slot->sequence == pos)
+        {
+            if (atomic_compare_and_swap(&state->enqueue_pos, pos, pos + 1))
+            {
+                break;
+            }
+        }
+        else if ((int32_t) (slot->sequence - pos) < 0)
+        {
+            /* The slot still holds the item of the previous round, so the queue is full */
+            return false;
+        }
+        /* Otherwise, another producer has claimed the position in the meantime */
+    }
+
+    slot->function = function;
+    slot->context = context;
+    slot->sequence = pos + 1;
+
+    return true;
+}
+
+static bool
+work_queue_dequeue(const RtosWorkQueueId work_queue, RtosWorkFunction *const function,
+                   void **const context)
+{
+    const struct work_queue *const q = &work_queues[work_queue];
+    struct work_queue_state *const state = &work_queue_states[work_queue];
+    struct work_slot *slot;
+    uint32_t pos;
+
+    /* loop bound: retries */
+    for (;;)
+    {
+        pos = state->dequeue_pos;
+        slot = &q->slots[pos & q->mask];
+        if (slot->sequence == pos + 1)
+        {
+            if (atomic_compare_and_swap(&state->dequeue_pos, pos, pos + 1))
+            {
+                break;
+            }
+        }
+        else if ((int32_t) (slot->sequence - (pos + 1)) < 0)
+        {
+            /* No producer has released the slot at this position yet, so the queue is empty */
+            return false;
+        }
+        /* Otherwise, another worker has claimed the position in the meantime */
+    }
+
+    *function = slot->function;
+    *context = slot->context;
+    slot->sequence = pos + q->mask + 1;
+
+    return true;
+}
+/*
+ * The interrupt, if one is set, occurs immediately before the given compare-and-swap operation, i.e., after the
+ * caller has read the value that it expects.
+ */
+static bool
+atomic_compare_and_swap(volatile uint32_t *const word, const uint32_t expected, const uint32_t desired)
+{
+    void (*const interrupt)(void) = interrupt_ptr;
+
+    if (interrupt != NULL && --interrupt_compare_and_swap_count == 0)
+    {
+        interrupt_ptr = NULL;
+        interrupt();
+    }
+
+    if (*word != expected)
+    {
+        return false;
+    }
+    *word = desired;
+    return true;
+}
+
+static void
+signal_send_set(const RtosTaskId task_id, const RtosSignalSet signals)
+{
+    pub_signals[task_id] |= signals;
+}
+
+bool
+rtos_work_queue_submit(const RtosWorkQueueId work_queue, const RtosWorkFunction function,
+                                 void *const context)
+{
+    WorkerIndex w;
+
+    assert_work_queue_valid(work_queue);
+    api_assert(function != NULL, ERROR_ID_WORK_QUEUE_INVALID_FUNCTION);
+
+    if (!work_queue_enqueue(work_queue, function, context))
+    {
+        return false;
+    }
+
+    preempt_disable();
+
+    /* loop bound: 3 */
+    for (w = work_queues[work_queue].first_worker;
+         w < work_queues[work_queue].first_worker + work_queues[work_queue].worker_count; w++)
+    {
+        signal_send_set(work_queue_workers[w].task, RTOS_SIGNAL_SET__WORK);
+    }
+
+    preempt_enable();
+
+    return true;
+}
+
+/*
+ * Interrupt handlers must not interact with the scheduler directly, so they wake up the workers by raising their
+ * interrupt events.
+ * Raising an interrupt event that is already pending has no further effect, so a burst of submissions results in a
+ * single wakeup of each worker.
+ */
+bool
+rtos_work_queue_submit_from_interrupt(const RtosWorkQueueId work_queue,
+                                                const RtosWorkFunction function, void *const context)
+{
+    WorkerIndex w;
+
+    assert_work_queue_valid(work_queue);
+    api_assert(function != NULL, ERROR_ID_WORK_QUEUE_INVALID_FUNCTION);
+
+    if (!work_queue_enqueue(work_queue, function, context))
+    {
+        return false;
+    }
+
+    /* loop bound: 3 */
+    for (w = work_queues[work_queue].first_worker;
+         w < work_queues[work_queue].first_worker + work_queues[work_queue].worker_count; w++)
+    {
+        rtos_interrupt_event_raise(work_queue_workers[w].interrupt_event);
+    }
+
+    return true;
+}
+
+void
+rtos_work_queue_worker(const RtosWorkQueueId work_queue) RTOS_REENTRANT
+{
+    RtosWorkFunction function;
+    void *context;
+
+    assert_work_queue_valid(work_queue);
+
+    for (;;)
+    {
+        /* Drain all items that have been submitted up to now before waiting again */
+        while (work_queue_dequeue(work_queue, &function, &context))
+        {
+            function(context);
+        }
+
+        (void) rtos_signal_wait_set(RTOS_SIGNAL_SET__WORK);
+    }
+}
+void
+rtos_interrupt_event_raise(const RtosInterruptEventId interrupt_event_id)
+{
+    pub_interrupt_events[interrupt_event_id] = true;
+}
+
+/*
+ * While a worker waits, the wait function that the test sets runs other tasks and interrupt handlers.
+ * The worker stops when the wait function returns false, or when the test sets none.
+ */
+RtosSignalSet
+rtos_signal_wait_set(const RtosSignalSet requested_signals)
+{
+    pub_waits++;
+    if (wait_ptr == NULL || !wait_ptr())
+    {
+        longjmp(worker_jmp_buf, 1);
+    }
+    return requested_signals;
+}
+
+void
+pub_work_queue_init(void)
+{
+    RtosWorkQueueId work_queue;
+    RtosTaskId task_id;
+    RtosInterruptEventId interrupt_event_id;
+
+    /* For testing purposes, the positions of the work queues are reset, too */
+    for (work_queue = 0; work_queue < 2; work_queue++)
+    {
+        work_queue_states[work_queue].enqueue_pos = 0;
+        work_queue_states[work_queue].dequeue_pos = 0;
+    }
+    work_queue_init();
+    for (task_id = RTOS_TASK_ID_ZERO; task_id <= RTOS_TASK_ID_MAX; task_id++)
+    {
+        pub_signals[task_id] = 0;
+    }
+    for (interrupt_event_id = 0; interrupt_event_id < 3; interrupt_event_id++)
+    {
+        pub_interrupt_events[interrupt_event_id] = false;
+    }
+    interrupt_ptr = NULL;
+    wait_ptr = NULL;
+    pub_waits = 0;
+}
+
+/*
+ * Move the positions of an empty work queue, e.g., close to the wrap-around of the 32-bit positions.
+ */
+void
+pub_work_queue_set_position(const RtosWorkQueueId work_queue, const uint32_t position)
+{
+    const uint32_t mask = work_queues[work_queue].mask;
+    uint32_t slot;
+
+    work_queue_states[work_queue].enqueue_pos = position;
+    work_queue_states[work_queue].dequeue_pos = position;
+    /* Each slot can next hold the first position from the given one onwards that maps to it */
+    for (slot = 0; slot <= mask; slot++)
+    {
+        work_queues[work_queue].slots[slot].sequence = position + ((slot - position) & mask);
+    }
+}
+
+void
+pub_set_interrupt_ptr(void (*y)(void), const uint32_t compare_and_swap_count)
+{
+    interrupt_ptr = y;
+    interrupt_compare_and_swap_count = compare_and_swap_count;
+}
+
+void
+pub_set_wait_ptr(bool (*y)(void))
+{
+    wait_ptr = y;
+}
+
+/*
+ * Run the worker of a work queue until it stops waiting.
+ */
+void
+pub_work_queue_run(const RtosWorkQueueId work_queue)
+{
+    if (setjmp(worker_jmp_buf) == 0)
+    {
+        rtos_work_queue_worker(work_queue);
+    }
+}
+
+/*
+ * Dequeue an item as another worker would, and return its context, or NULL if the work queue is empty.
+ */
+void *
+pub_work_queue_dequeue(const RtosWorkQueueId work_queue)
+{
+    RtosWorkFunction function;
+    void *context;
+
+    return work_queue_dequeue(work_queue, &function, &context) ? context : NULL;
+}
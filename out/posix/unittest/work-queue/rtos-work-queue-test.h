@@ -0,0 +1,57 @@
+#ifndef RTOS_WORK_QUEUE_TEST_H
+#define RTOS_WORK_QUEUE_TEST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint8_t RtosWorkQueueId;
+typedef void (*RtosWorkFunction)(void *context);
+typedef uint8_t RtosTaskId;
+typedef uint8_t RtosInterruptEventId;
+typedef uint8_t RtosSignalSet;
+
+
+
+#define RTOS_REENTRANT 
+#define RTOS_WORK_QUEUE_ID_Q0 ((RtosWorkQueueId) UINT8_C(0))
+#define RTOS_WORK_QUEUE_ID_Q1 ((RtosWorkQueueId) UINT8_C(1))
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(4 - 1))
+#define RTOS_TASK_ID_T0 ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_T1 ((RtosTaskId) UINT8_C(1))
+#define RTOS_TASK_ID_T2 ((RtosTaskId) UINT8_C(2))
+#define RTOS_TASK_ID_T3 ((RtosTaskId) UINT8_C(3))
+#define RTOS_INTERRUPT_EVENT_ID__WORK_Q0_T1 ((RtosInterruptEventId) UINT8_C(0))
+#define RTOS_INTERRUPT_EVENT_ID__WORK_Q0_T2 ((RtosInterruptEventId) UINT8_C(1))
+#define RTOS_INTERRUPT_EVENT_ID__WORK_Q1_T3 ((RtosInterruptEventId) UINT8_C(2))
+#define RTOS_SIGNAL_SET__WORK ((RtosSignalSet) UINT8_C(2))
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool rtos_work_queue_submit(RtosWorkQueueId work_queue, RtosWorkFunction function,
+                                    void *context);
+bool rtos_work_queue_submit_from_interrupt(RtosWorkQueueId work_queue,
+                                                   RtosWorkFunction function, void *context);
+void rtos_work_queue_worker(RtosWorkQueueId work_queue) RTOS_REENTRANT;
+void rtos_interrupt_event_raise(RtosInterruptEventId interrupt_event_id);
+RtosSignalSet rtos_signal_wait_set(RtosSignalSet requested_signals);
+void pub_work_queue_init(void);
+void pub_work_queue_set_position(RtosWorkQueueId work_queue, uint32_t position);
+void pub_set_interrupt_ptr(void (*y)(void), uint32_t compare_and_swap_count);
+void pub_set_wait_ptr(bool (*y)(void));
+void pub_work_queue_run(RtosWorkQueueId work_queue);
+void *pub_work_queue_dequeue(RtosWorkQueueId work_queue);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_WORK_QUEUE_TEST_H */
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef RTOS_ACAMAR_H
+#define RTOS_ACAMAR_H
+
+
+
+
+#include <stdint.h>
+#include <stdint.h>
+
+
+
+
+typedef uint8_t RtosErrorId;
+typedef uint8_t RtosTaskId;
+
+
+
+
+
+
+#define RTOS_REENTRANT 
+
+
+
+
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(2 - 1))
+#define RTOS_TASK_ID_A ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_B ((RtosTaskId) UINT8_C(1))
+
+
+
+
+
+
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void rtos_yield_to(RtosTaskId) RTOS_REENTRANT;
+void rtos_start(void);
+
+
+
+RtosTaskId rtos_task_current(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_ACAMAR_H */
\ No newline at end of file
@@ -0,0 +1,98 @@
+#ifndef RTOS_ACRUX_H
+#define RTOS_ACRUX_H
+
+
+
+
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+
+
+
+
+
+
+
+typedef uint8_t RtosInterruptEventId;
+typedef uint8_t RtosMutexId;
+typedef uint8_t RtosErrorId;
+typedef uint8_t RtosTaskId;
+
+
+
+
+
+
+
+
+
+
+
+
+#define RTOS_REENTRANT 
+
+
+
+
+
+#define RTOS_INTERRUPT_EVENT_ID_DUMMY ((RtosInterruptEventId) UINT8_C(0))
+#define RTOS_MUTEX_ID_DUMMY ((RtosMutexId) UINT8_C(0))
+
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(2 - 1))
+#define RTOS_TASK_ID_A ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_B ((RtosTaskId) UINT8_C(1))
+
+
+
+
+
+
+#define rtos_interrupt_event_raise(event)
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+
+
+
+
+void rtos_mutex_lock(RtosMutexId) RTOS_REENTRANT;
+bool rtos_mutex_try_lock(RtosMutexId);
+void rtos_mutex_unlock(RtosMutexId);
+
+RtosTaskId rtos_task_current(void);
+void rtos_yield_to(RtosTaskId to) RTOS_REENTRANT;
+void rtos_yield(void) RTOS_REENTRANT;
+void rtos_block(void) RTOS_REENTRANT;
+void rtos_unblock(RtosTaskId task);
+void rtos_start(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_ACRUX_H */
\ No newline at end of file
@@ -0,0 +1,2461 @@
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+
+#include <stdbool.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdbool.h>
+
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+#include "rtos-kochab.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+
+#define PREEMPTION_SUPPORT
+#define SCHED_INDEX_ZERO ((SchedIndex) RTOS_TASK_ID_ZERO)
+#define SCHED_LEVEL_ZERO ((SchedIndex) 0)
+#define SCHED_TIME_SLICE ((uint16_t) 5)
+
+
+
+#define TIMER_ID_ZERO ((RtosTimerId) UINT8_C(0))
+#define TIMER_ID_MAX ((RtosTimerId) UINT8_C(2 - 1U))
+#define TIMER_WORDS 1U
+#define PERIODIC_INDEX_MAX ((PeriodicIndex) UINT8_C(1 - 1U))
+#define PERIODIC_INDEX_NONE ((PeriodicIndex) UINT8_MAX)
+
+#define BUDGET_REPLENISHMENTS_MAX 4U
+#define TIMEBASE_NANOSECONDS_PER_SECOND UINT32_C(1000000000)
+#define TIMEBASE_TICK_PERIOD UINT32_C(1000000)
+#define TIMEBASE_TICKS_PER_SECOND UINT32_C(1000)
+#define TIMEBASE_RATE UINT64_C(53687091200)
+#define TIMEBASE_RATE_PER_PPB INT64_C(3518437)
+#define TIMEBASE_CYCLES_PER_NANOSECOND UINT64_C(343597384)
+#define TIMEBASE_CYCLES_PER_NANOSECOND_PER_PPB INT64_C(22518)
+#define TIMEBASE_ADJUSTMENT_MAX INT32_C(1000000)
+#define TIMEBASE_SECONDS_MAX ((UINT16_MAX - 2U) / TIMEBASE_TICKS_PER_SECOND - 1U)
+
+
+
+#define MUTEX_ID_NONE ((MutexIdOption) UINT8_MAX)
+#define COND_ID_NONE ((CondIdOption) UINT8_MAX)
+#define SEM_ID_NONE ((SemIdOption) UINT8_MAX)
+#define SEM_VALUE_ZERO ((RtosSemValue) UINT8_C(0))
+
+#define POOL_ID_NONE ((PoolIdOption) UINT8_MAX)
+#define POOL_BLOCK_NONE ((uint16_t) UINT16_MAX)
+#ifdef __GNUC__
+#define POOL_ALIGNED(alignment) __attribute__((aligned(alignment)))
+#else
+#define POOL_ALIGNED(alignment)
+#endif
+
+#define ERROR_ID_NONE ((RtosErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW ((RtosErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID ((RtosErrorId) UINT8_C(2))
+#define ERROR_ID_NOT_HOLDING_MUTEX ((RtosErrorId) UINT8_C(3))
+#define ERROR_ID_DEADLOCK ((RtosErrorId) UINT8_C(4))
+#define ERROR_ID_TASK_FUNCTION_RETURNS ((RtosErrorId) UINT8_C(5))
+#define ERROR_ID_INTERNAL_CURRENT_TASK_INVALID ((RtosErrorId) UINT8_C(6))
+#define ERROR_ID_INTERNAL_INVALID_ID ((RtosErrorId) UINT8_C(7))
+#define ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP ((RtosErrorId) UINT8_C(8))
+#define ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(9))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(10))
+#define ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER ((RtosErrorId) UINT8_C(11))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW ((RtosErrorId) UINT8_C(12))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION ((RtosErrorId) UINT8_C(13))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_CONFIGURATION ((RtosErrorId) UINT8_C(14))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_HEAD ((RtosErrorId) UINT8_C(15))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE ((RtosErrorId) UINT8_C(16))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_ID_IN_WAITERS ((RtosErrorId) UINT8_C(17))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TASKS_BLOCKED_DESPITE_AVAILABLE_MESSAGES ((RtosErrorId) UINT8_C(18))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_WAITING_TASK_IS_NOT_BLOCKED ((RtosErrorId) UINT8_C(19))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGES_POINTER ((RtosErrorId) UINT8_C(20))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGE_SIZE ((RtosErrorId) UINT8_C(21))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH ((RtosErrorId) UINT8_C(22))
+#define ERROR_ID_INTERNAL_PRECONDITION_VIOLATED ((RtosErrorId) UINT8_C(23))
+#define ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED ((RtosErrorId) UINT8_C(24))
+#define ERROR_ID_SEMAPHORE_MAX_INVALID ((RtosErrorId) UINT8_C(25))
+#define ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT ((RtosErrorId) UINT8_C(26))
+#define ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT ((RtosErrorId) UINT8_C(27))
+#define ERROR_ID_SEMAPHORE_MAX_EXCEEDED ((RtosErrorId) UINT8_C(28))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED ((RtosErrorId) UINT8_C(29))
+#define ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX ((RtosErrorId) UINT8_C(30))
+#define ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED ((RtosErrorId) UINT8_C(31))
+#define ERROR_ID_SCHED_EDF_TASK_NOT_PERIODIC ((RtosErrorId) UINT8_C(32))
+#define ERROR_ID_TIMER_TASK_NOT_PERIODIC ((RtosErrorId) UINT8_C(33))
+#define ERROR_ID_POOL_INVALID_BLOCK ((RtosErrorId) UINT8_C(34))
+#define ERROR_ID_BROADCAST_NOT_SUBSCRIBED ((RtosErrorId) UINT8_C(35))
+#define ERROR_ID_BROADCAST_INVALID_POINTER ((RtosErrorId) UINT8_C(36))
+#define ERROR_ID_WORK_QUEUE_INVALID_FUNCTION ((RtosErrorId) UINT8_C(37))
+#define ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS ((RtosErrorId) UINT8_C(38))
+#define ERROR_ID_TIMEBASE_TIME_TOO_FAR ((RtosErrorId) UINT8_C(39))
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+#define current_task rtos_internal_current_task
+#define tasks rtos_internal_tasks
+
+typedef int context_t;
+typedef RtosTaskId SchedIndex;
+typedef uint16_t TicksTimeout;
+typedef uint32_t TimerWord;
+typedef uint8_t PeriodicIndex;
+typedef RtosMutexId MutexIdOption;
+typedef RtosCondId CondIdOption;
+typedef RtosSemId SemIdOption;
+typedef RtosPoolId PoolIdOption;
+typedef uint8_t WorkerIndex;
+typedef RtosTaskId TaskIdOption;
+
+
+
+struct sched_task {
+    TaskIdOption blocked_on;
+};
+
+/*
+ * NOTE: An RTOS variant using the scheduler must ensure that tasks
+ * array is sorted by priority.
+ * Tasks of equal priority form a priority level and must be adjacent in the tasks array.
+ * The scheduler selects between the tasks of a level in round-robin order, starting with the task at the level's
+ * offset.
+ */
+struct sched {
+    struct sched_task tasks[2];
+    SchedIndex level_offsets[2];
+    TaskIdOption slice_task;
+    SchedIndex slice_level;
+    uint16_t slice_remaining;
+};
+struct signal_task {
+    RtosSignalSet signals;
+};
+
+struct signal {
+    struct signal_task tasks[2];
+};
+
+struct periodic_task
+{
+    /* The nominal release time of the current job, or of the job before the first one */
+    RtosTicksAbsolute release;
+    RtosTicksRelative period;
+    RtosTicksRelative deadline;
+    RtosTaskId task_id;
+    RtosSignalSet signal_set;
+    bool job_active;
+    RtosTicksRelative job_jitter;
+};
+
+struct budget_replenishment {
+    RtosTicksAbsolute due;
+    uint32_t amount;
+};
+
+struct budget {
+    /* Signed, because the RTOS only notices an exhausted budget at the next scheduling point, so a task may overrun
+     * its budget by the cycles it executes until then. */
+    int32_t remaining;
+    uint32_t consumed;
+    RtosTicksAbsolute activation;
+    bool active;
+    bool throttled;
+    uint8_t replenishment_head;
+    uint8_t replenishment_count;
+    struct budget_replenishment replenishments[BUDGET_REPLENISHMENTS_MAX];
+};
+/*
+ * The network time at the most recent tick, and the value of the cycle counter when the tick interrupt handler sampled
+ * it.
+ * The rate converts cycles to nanoseconds, with 32 fractional bits, and the fraction holds the fraction of a
+ * nanosecond that the network time had reached at the tick.
+ * The step is the total of all steps that the clock includes.
+ * The sequence number increments at each tick, so that readers detect that a tick interrupted them.
+ */
+struct timebase_clock {
+    uint32_t sequence;
+    RtosTicksAbsolute ticks;
+    uint32_t cycles;
+    uint32_t seconds;
+    uint32_t nanoseconds;
+    uint32_t fraction;
+    uint64_t rate;
+    uint32_t step_seconds;
+    uint32_t step_nanoseconds;
+};
+
+/*
+ * The total of all steps of the network time that tasks requested, modulo 2^32 seconds.
+ * The next tick applies the difference to the total that the clock includes.
+ */
+struct timebase_step {
+    uint32_t seconds;
+    uint32_t nanoseconds;
+};
+
+
+struct interrupt_event_handler {
+    RtosTaskId task;
+    RtosSignalSet sig_set;
+};
+
+struct mutex {
+    TaskIdOption holder;
+};
+
+struct semaphore {
+    RtosSemValue value;
+};
+
+struct pool {
+    uint8_t *storage;
+    uint16_t block_stride;
+    uint16_t block_count;
+};
+
+/*
+ * The free blocks of a pool form a singly-linked list, with the index of the next free block stored in the first two
+ * bytes of each free block.
+ * The head of the list is a word that holds the index of the first free block in its lower half and a tag in its upper
+ * half.
+ * Every update of the head increments the tag, so that a compare-and-swap based on an outdated head fails even if the
+ * same block has been allocated and freed again in the meantime (the ABA problem).
+ */
+struct pool_state {
+    volatile uint32_t head;
+    volatile uint32_t used;
+    volatile uint32_t high_water_mark;
+};
+/*
+ * The slots of a work queue form a bounded ring that multiple producers and consumers access without locks.
+ * The sequence number of a slot tells which position of the ring the slot can hold next:
+ * a slot at position pos is free for a producer if its sequence is pos, and holds an item for a consumer if its
+ * sequence is pos + 1.
+ * Producers and consumers claim positions with a compare-and-swap on enqueue_pos and dequeue_pos, respectively, and
+ * release the slot by updating its sequence once they have written or read the item.
+ */
+struct work_slot {
+    volatile uint32_t sequence;
+    /* The item fields are volatile so that the compiler keeps their accesses ordered with those of the sequence */
+    RtosWorkFunction volatile function;
+    void *volatile context;
+};
+
+struct work_queue {
+    struct work_slot *slots;
+    uint32_t mask;
+    WorkerIndex first_worker;
+    WorkerIndex worker_count;
+};
+
+struct work_queue_worker {
+    RtosTaskId task;
+    RtosInterruptEventId interrupt_event;
+};
+
+struct work_queue_state {
+    volatile uint32_t enqueue_pos;
+    volatile uint32_t dequeue_pos;
+};
+
+struct task
+{
+    context_t ctx;
+};
+
+
+
+
+
+
+
+
+
+extern void budget_overrun(RtosTaskId task);
+
+
+
+
+
+
+
+
+
+
+extern void fatal(RtosErrorId error_id);
+extern void fn_a(void);
+extern void fn_b(void);
+extern void fn_a(void);
+extern void fn_b(void);
+
+
+
+static void sched_set_runnable(const RtosTaskId task_id);
+static void sched_set_blocked_on(const RtosTaskId task_id, const RtosTaskId blocker);
+static TaskIdOption sched_get_next(void);
+static bool sched_time_slice_tick(void);
+
+static RtosSignalSet signal_recv(RtosSignalSet *pending_signals, RtosSignalSet requested_signals);
+static void signal_send_set(RtosTaskId task_id, RtosSignalSet signals);
+static RtosSignalSet signal_wait_set_blocked_on(RtosSignalSet requested_signals,
+        RtosTaskId blocker) RTOS_REENTRANT;
+
+
+static void timer_process_one(RtosTimerId timer_id);
+static void timer_enable(RtosTimerId timer_id);
+static void timer_oneshot(RtosTimerId timer_id, RtosTicksRelative timeout);
+static void timer_tick_process(void);
+static void periodic_release_process(void);
+static PeriodicIndex periodic_index_get(RtosTaskId task_id);
+static void periodic_stats_record(PeriodicIndex idx, RtosTicksRelative jitter,
+                                  RtosTicksRelative response);
+
+static void budget_init(void);
+static void budget_activate(RtosTaskId task);
+static void budget_post(RtosTaskId task);
+static void budget_charge(RtosTaskId task);
+static bool budget_throttle(RtosTaskId task);
+static void budget_replenish_process(void);
+static void budget_switch(RtosTaskId from, RtosTaskId to);
+static void timebase_init(void);
+static void interrupt_event_process(void);
+RtosTaskId rtos_internal_interrupt_event_get_next(void);
+static void interrupt_event_handle(RtosInterruptEventId interrupt_event_id);
+static bool mutex_try_lock(RtosMutexId m);
+static bool mutex_acquire(RtosMutexId m) RTOS_REENTRANT;
+static void mutex_release(RtosMutexId m);
+static void cond_wake(RtosCondId cond, bool all);
+static bool internal_sem_try_wait(const RtosSemId s);
+static bool atomic_compare_and_swap(volatile uint32_t *word, uint32_t expected, uint32_t desired);
+static void pool_init(void);
+static void *pool_try_alloc(RtosPoolId pool);
+static void pool_used_add(RtosPoolId pool, int32_t delta);
+static void work_queue_init(void);
+static bool work_queue_enqueue(RtosWorkQueueId work_queue, RtosWorkFunction function,
+                               void *context);
+static bool work_queue_dequeue(RtosWorkQueueId work_queue, RtosWorkFunction *function,
+                               void **context);
+
+static RtosTaskId get_current_task_check(void);
+static void block_on(RtosTaskId blocker);
+static void mutex_core_block_on_timeout(RtosTaskId t, RtosTicksRelative ticks);
+static void sem_core_block_timeout(RtosTicksRelative ticks);
+static void unblock(RtosTaskId task);
+
+
+void (*entry_point_ptr)(void);
+static struct sched sched_tasks;
+/* The index of the first task of each priority level, followed by the number of tasks */
+static const SchedIndex sched_level_bounds[2 + 1] = {
+    0,
+    1,
+    2
+};
+
+static struct signal signal_tasks;
+
+RtosTicksAbsolute rtos_timer_current_ticks;
+/*
+ * The state of the timers is laid out as one array per field, indexed by timer ID.
+ * The enabled and overflow flags are packed into bitmaps of 32 timers per word, so that tick processing only visits
+ * the enabled timers.
+ */
+static TimerWord timers_enabled[TIMER_WORDS] = {
+    UINT32_C(0x0),
+};
+static TimerWord timers_overflow[TIMER_WORDS];
+static TicksTimeout timer_expiries[2] = {
+    0,
+    0,
+};
+static RtosTicksRelative timer_reloads[2] = {
+    0,
+    0,
+};
+/* When the error ID of a timer is not ERROR_ID_NONE, the timer calls the application error function with it */
+static RtosErrorId timer_error_ids[2] = {
+    0,
+    0,
+};
+static RtosTaskId timer_task_ids[2] = {
+    RTOS_TASK_ID_A,
+    RTOS_TASK_ID_B,
+};
+static RtosSignalSet timer_signal_sets[2] = {
+    RTOS_SIGNAL_SET__TASK_TIMER,
+    RTOS_SIGNAL_SET__TASK_TIMER,
+};
+static struct periodic_task periodic_tasks[1] = {
+    {
+        (RtosTicksAbsolute) 5 - 20,
+        20,
+        15,
+        RTOS_TASK_ID_B,
+        RTOS_SIGNAL_SET_RELEASE,
+        false,
+        0
+    },
+};
+RtosPeriodicStats rtos_periodic_stats[1] = {
+    RTOS_PERIODIC_STATS_INIT,
+};
+
+static struct budget budgets[2];
+static uint32_t budget_switch_in;
+static const uint32_t budget_capacities[2] = {
+    UINT32_C(0),
+    UINT32_C(100000),
+};
+static const RtosTicksRelative budget_periods[2] = {
+    0,
+    10,
+};
+static volatile struct timebase_clock timebase_clock;
+/*
+ * Tasks publish a new total step by writing the slot that the step sequence number does not select and then
+ * incrementing it, so that the tick interrupt handler never reads a partially written total
+ */
+static volatile struct timebase_step timebase_steps[2];
+static volatile uint32_t timebase_step_sequence;
+static volatile int32_t timebase_adjustment;
+/* Only the tick interrupt handler accesses the following */
+static int32_t timebase_applied_adjustment;
+static uint64_t timebase_cycles_per_nanosecond;
+static uint32_t timebase_reload;
+
+static bool system_is_idle;
+struct interrupt_event_handler interrupt_events[2] = {
+    { RTOS_TASK_ID_A, RTOS_SIGNAL_SET_TIMER },
+    { RTOS_TASK_ID_B, RTOS_SIGNAL_SET__WORK },
+};
+static struct mutex mutexes[1] = {
+    {TASK_ID_NONE},
+};
+static MutexIdOption mutex_waiters[2] = {
+    MUTEX_ID_NONE,
+    MUTEX_ID_NONE,
+};
+/* The condition variable each task waits on, if any.
+ * A task waiting on a condition variable holds no mutex and is blocked without a blocker, so no task inherits its
+ * priority until it is woken up and waits for the mutex again. */
+static CondIdOption cond_waiters[2] = {
+    COND_ID_NONE,
+    COND_ID_NONE,
+};
+static struct semaphore semaphores[1];
+static SemIdOption sem_waiters[2];
+
+static uint8_t pool_storage_buffers[8U * 64U] POOL_ALIGNED(4);
+static const struct pool pools[1] = {
+    { pool_storage_buffers, 64U, 8U },
+};
+static struct pool_state pool_states[1];
+static PoolIdOption pool_waiters[2];
+static struct work_slot work_queue_deferred_slots[8];
+static const struct work_queue work_queues[1] = {
+    { work_queue_deferred_slots, 8U - 1U, 0, 1 },
+};
+static const struct work_queue_worker work_queue_workers[1] = {
+    { RTOS_TASK_ID_B, RTOS_INTERRUPT_EVENT_ID__WORK_DEFERRED_B },
+};
+static struct work_queue_state work_queue_states[1];
+
+RtosTaskId rtos_internal_current_task;
+struct task rtos_internal_tasks[2];
+static RtosTimerId task_timers[2] = {
+    RTOS_TIMER_ID__TASK_A,
+    RTOS_TIMER_ID__TASK_B,
+};
+
+
+#define preempt_init()
+#define context_init(ctx, fn, stack_base, stack_size) (entry_point_ptr = fn)
+#define context_switch_first(to)
+#define yield()
+#define preempt_disable()
+#define preempt_enable()
+#define preempt_pend()
+#define precondition_preemption_disabled()
+#define postcondition_preemption_disabled()
+#define postcondition_preemption_enabled()
+#define sched_set_blocked(task_id) sched_set_blocked_on(task_id, TASK_ID_NONE)
+#define sched_runnable(task_id) (SCHED_OBJ(task_id).blocked_on == (task_id))
+#define sched_max_index() (SchedIndex)(2 - 1U)
+#define sched_index_to_taskid(sched_index) (RtosTaskId)(sched_index)
+#define sched_taskid_to_index(task_id) (SchedIndex)(task_id)
+#define SCHED_OBJ(task_id) sched_tasks.tasks[task_id]
+#define sched_max_level() (SchedIndex)(2 - 1U)
+#define sched_level_size(level) (SchedIndex)(sched_level_bounds[(level) + 1] - sched_level_bounds[level])
+#define sched_level_next_offset(level, offset) (SchedIndex)((offset) + 1U == sched_level_size(level) ? 0 : (offset) + 1U)
+
+
+#define signal_wait_blocked_on(requested_signals, blocker) signal_wait_set_blocked_on(requested_signals, blocker)
+#define signal_wait_set(requested_signals) signal_wait_set_blocked_on(requested_signals, TASK_ID_NONE)
+#define signal_wait(requested_signals) signal_wait_set(requested_signals)
+#define signal_peek(pending_signals, requested_signals) (((pending_signals) & (requested_signals)) != RTOS_SIGNAL_SET_EMPTY)
+#define signal_pending(task_id, mask) ((PENDING_SIGNALS(task_id) & mask) == mask)
+#define PENDING_SIGNALS(task_id) signal_tasks.tasks[task_id].signals
+#define timer_pending_ticks_get_and_clear_atomically() 0
+#define timer_pending_ticks_check() (false)
+#define TIMER_WORD(timer_id) ((timer_id) / 32U)
+#define TIMER_BIT(timer_id) ((TimerWord) 1U << ((timer_id) % 32U))
+#define timer_is_enabled(timer_id) ((timers_enabled[TIMER_WORD(timer_id)] & TIMER_BIT(timer_id)) != 0)
+#define timer_is_periodic(timer_id) (timer_reloads[timer_id] > 0)
+#define timer_reload_set(timer_id, ticks) timer_reloads[timer_id] = ticks
+#define timer_disable(timer_id) timers_enabled[TIMER_WORD(timer_id)] &= ~TIMER_BIT(timer_id)
+#define current_timeout() ((TicksTimeout) rtos_timer_current_ticks)
+#define assert_timer_valid(timer) api_assert(timer_id < 2, ERROR_ID_INVALID_ID)
+#define periodic_ticks_clamp(ticks) \
+    ((ticks) > UINT16_MAX ? (RtosTicksRelative) UINT16_MAX :\
+     (RtosTicksRelative) (ticks))
+#define cycle_counter_init()
+#define cycle_counter_get() ((uint32_t) 0)
+#define budget_limited(task) (budget_capacities[task] != 0)
+
+#define interrupt_application_event_check()
+#define interrupt_event_wait()
+#define interrupt_event_check() (interrupt_application_event_check() || interrupt_system_event_check())
+#define interrupt_system_event_check() timer_pending_ticks_check()
+#define interrupt_event_get_next() rtos_internal_interrupt_event_get_next()
+
+#define assert_mutex_valid(mutex) api_assert(mutex < 1, ERROR_ID_INVALID_ID)
+#define assert_cond_valid(cond) api_assert(cond < 1, ERROR_ID_INVALID_ID)
+#define assert_sem_valid(sem) api_assert(sem < 1, ERROR_ID_INVALID_ID)
+
+#define pool_block(pool, index) (&pools[pool].storage[(uint32_t) (index) * pools[pool].block_stride])
+#define pool_block_next(block) (*((volatile uint16_t *) (block)))
+#define pool_head_index(head) ((uint16_t) ((head) & 0xffffU))
+#define pool_head_next(head, index) (((((head) >> 16) + 1U) << 16) | (uint32_t) (index))
+#define assert_pool_valid(pool) api_assert(pool < 1, ERROR_ID_INVALID_ID)
+#define assert_work_queue_valid(work_queue) api_assert(work_queue < 1, ERROR_ID_INVALID_ID)
+#define api_error(error_id) do { } while(0)
+#define api_assert(expression, error_id) do { } while(0)
+
+#define internal_error(error_id) fatal(error_id)
+#define internal_assert(expression, error_id) do { if (!(expression)) { internal_error(error_id); } } while(0)
+#define get_current_task() get_current_task_check()
+#define get_task_context(task_id) &tasks[task_id].ctx
+#define internal_assert_task_valid(task) internal_assert(task < 2, ERROR_ID_INTERNAL_INVALID_ID)
+#define assert_task_valid(task) api_assert(task < 2, ERROR_ID_INVALID_ID)
+#define block() block_on(TASK_ID_NONE)
+#define mutex_core_block_on(blocker) signal_wait_blocked_on(RTOS_SIGNAL_ID__TASK_TIMER, blocker)
+#define mutex_core_unblock(task) signal_send_set(task, RTOS_SIGNAL_ID__TASK_TIMER)
+#define sem_core_block() signal_wait(RTOS_SIGNAL_ID__TASK_TIMER)
+#define sem_core_unblock(task) signal_send_set(task, RTOS_SIGNAL_ID__TASK_TIMER)
+#define cond_core_block() signal_wait(RTOS_SIGNAL_ID__TASK_TIMER)
+#define cond_core_block_timeout(ticks) sem_core_block_timeout(ticks)
+#define cond_core_unblock(task) signal_send_set(task, RTOS_SIGNAL_ID__TASK_TIMER)
+/* Tasks are sorted by priority, so a lower task ID means a higher priority */
+#define cond_core_higher_priority(task_a, task_b) ((task_a) < (task_b))
+
+
+
+static void
+sched_set_runnable(const RtosTaskId task_id)
+{
+    SCHED_OBJ(task_id).blocked_on = task_id;
+}
+
+static void
+sched_set_blocked_on(const RtosTaskId task_id, const RtosTaskId blocker)
+{
+    SCHED_OBJ(task_id).blocked_on = blocker;
+}
+
+static RAMFUNC TaskIdOption
+sched_get_next(void)
+{
+    /* NOTE: In the case where assume_runnable is true and no runnable
+       tasks are found, then an undefined task will be returned from this
+       function.
+    */
+    TaskIdOption task = TASK_ID_NONE, next_task;
+    SchedIndex level, offset, count;
+
+    /* loop bound: 2 */
+    for (level = SCHED_LEVEL_ZERO; level <= sched_max_level(); level++)
+    {
+        offset = sched_tasks.level_offsets[level];
+        /* loop bound: 2 */
+        for (count = sched_level_size(level); count != 0; count--)
+        {
+            task = sched_index_to_taskid(sched_level_bounds[level] + offset);
+            /* loop bound: 2 */
+            do
+            {
+                next_task = SCHED_OBJ(task).blocked_on;
+                if (next_task == task)
+                {
+                    /* Keep selecting this task of the level until its time slice expires or it blocks */
+                    sched_tasks.level_offsets[level] = offset;
+                    goto found;
+                }
+                task = next_task;
+            }
+            while (task != TASK_ID_NONE);
+            offset = sched_level_next_offset(level, offset);
+        }
+    }
+    return TASK_ID_NONE;
+found:
+    if (task != sched_tasks.slice_task)
+    {
+        sched_tasks.slice_task = task;
+        sched_tasks.slice_level = level;
+        sched_tasks.slice_remaining = SCHED_TIME_SLICE;
+    }
+    return  task;
+}
+
+/*
+ * Called for each tick.
+ * When the time slice of the most recently selected task expires, the scheduler moves on to the next task of the
+ * priority level the task was selected from.
+ * Returns whether the time slice expired, in which case the caller must trigger a scheduling decision for the rotation
+ * to take effect.
+ */
+static bool
+sched_time_slice_tick(void)
+{
+    const SchedIndex level = sched_tasks.slice_level;
+
+    if (sched_tasks.slice_remaining > 1)
+    {
+        sched_tasks.slice_remaining--;
+        return false;
+    }
+
+    sched_tasks.level_offsets[level] = sched_level_next_offset(level, sched_tasks.level_offsets[level]);
+    sched_tasks.slice_task = TASK_ID_NONE;
+    return true;
+}
+
+static RtosSignalSet
+signal_recv(RtosSignalSet *const pending_signals, const RtosSignalSet requested_signals)
+{
+    const RtosSignalSet received_signals = *pending_signals & requested_signals;
+
+    precondition_preemption_disabled();
+
+    *pending_signals &= ~received_signals;
+
+    postcondition_preemption_disabled();
+
+    return received_signals;
+}
+
+static RAMFUNC void
+signal_send_set(const RtosTaskId task_id, const RtosSignalSet signals)
+{
+    precondition_preemption_disabled();
+
+    PENDING_SIGNALS(task_id) |= signals;
+    unblock(task_id);
+
+    postcondition_preemption_disabled();
+}
+
+static RtosSignalSet
+signal_wait_set_blocked_on(const RtosSignalSet requested_signals, const RtosTaskId blocker)
+        RTOS_REENTRANT
+{
+    RtosSignalSet received_signals;
+
+    precondition_preemption_disabled();
+    {
+        RtosSignalSet *const pending_signals = &PENDING_SIGNALS(get_current_task());
+
+        if (signal_peek(*pending_signals, requested_signals))
+        {
+            yield();
+        }
+        else
+        {
+            do
+            {
+                block_on(blocker);
+            } while (!signal_peek(*pending_signals, requested_signals));
+        }
+
+        received_signals = signal_recv(pending_signals, requested_signals);
+    }
+    postcondition_preemption_disabled();
+
+    return received_signals;
+}
+
+static void
+timer_process_one(const RtosTimerId timer_id)
+{
+    precondition_preemption_disabled();
+
+    if (timer_is_periodic(timer_id))
+    {
+        timer_expiries[timer_id] += timer_reloads[timer_id];
+    }
+    else
+    {
+        timer_disable(timer_id);
+    }
+
+    if (timer_error_ids[timer_id] != ERROR_ID_NONE)
+    {
+        fatal(timer_error_ids[timer_id]);
+    }
+    else
+    {
+        if (signal_pending(timer_task_ids[timer_id], timer_signal_sets[timer_id]))
+        {
+            timers_overflow[TIMER_WORD(timer_id)] |= TIMER_BIT(timer_id);
+        }
+        signal_send_set(timer_task_ids[timer_id], timer_signal_sets[timer_id]);
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_enable(const RtosTimerId timer_id)
+{
+    precondition_preemption_disabled();
+
+    if (timer_reloads[timer_id] == 0)
+    {
+        timer_process_one(timer_id);
+    }
+    else
+    {
+        timer_expiries[timer_id] = current_timeout() + timer_reloads[timer_id];
+        timers_enabled[TIMER_WORD(timer_id)] |= TIMER_BIT(timer_id);
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_oneshot(const RtosTimerId timer_id, const RtosTicksRelative timeout)
+{
+    precondition_preemption_disabled();
+
+    timer_reload_set(timer_id, timeout);
+    timer_enable(timer_id);
+    timer_reload_set(timer_id, 0);
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_tick_process(void)
+{
+    precondition_preemption_disabled();
+    {
+        const uint8_t pending_ticks = timer_pending_ticks_get_and_clear_atomically();
+
+        if (pending_ticks > 1)
+        {
+            fatal(ERROR_ID_TICK_OVERFLOW);
+        }
+
+        if (pending_ticks)
+        {
+            RtosTimerId word, timer_id;
+            TimerWord enabled;
+            TicksTimeout timeout;
+
+            rtos_timer_current_ticks++;
+            periodic_release_process();
+            /* The tick interrupt does not pend a preemption by itself, so the expiry of a time slice does */
+            if (sched_time_slice_tick())
+            {
+                preempt_pend();
+            }
+
+            timeout = current_timeout();
+
+            /* loop bound: 1 */
+            for (word = 0; word < TIMER_WORDS; word++)
+            {
+                /* Visit the enabled timers of the word, up to the last one */
+                enabled = timers_enabled[word];
+                /* loop bound: 32 */
+                for (timer_id = (RtosTimerId) (word * 32U); enabled != 0; timer_id++, enabled >>= 1)
+                {
+                    if ((enabled & 1U) != 0 && timer_expiries[timer_id] == timeout)
+                    {
+                        timer_process_one(timer_id);
+                    }
+                }
+            }
+        }
+    }
+    postcondition_preemption_disabled();
+}
+
+/*
+ * Signal the tasks whose next job is released at the current tick.
+ * If a task is still executing an earlier job, the signal remains pending and periodic_wait_next() checks the release
+ * time rather than relying on the number of signals received.
+ */
+static void
+periodic_release_process(void)
+{
+    PeriodicIndex idx;
+    struct periodic_task *periodic;
+
+    precondition_preemption_disabled();
+
+    /* loop bound: 1 */
+    for (idx = 0; idx <= PERIODIC_INDEX_MAX; idx++)
+    {
+        periodic = &periodic_tasks[idx];
+        if (rtos_timer_current_ticks == periodic->release + periodic->period)
+        {
+            signal_send_set(periodic->task_id, periodic->signal_set);
+        }
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static PeriodicIndex
+periodic_index_get(const RtosTaskId task_id)
+{
+    PeriodicIndex idx;
+
+    /* loop bound: 1 */
+    for (idx = 0; idx <= PERIODIC_INDEX_MAX; idx++)
+    {
+        if (periodic_tasks[idx].task_id == task_id)
+        {
+            return idx;
+        }
+    }
+
+    return PERIODIC_INDEX_NONE;
+}
+
+static void
+periodic_stats_record(const PeriodicIndex idx, const RtosTicksRelative jitter,
+                      const RtosTicksRelative response)
+{
+    RtosPeriodicStats *const stats = &rtos_periodic_stats[idx];
+
+    stats->jobs++;
+    if (response > periodic_tasks[idx].deadline)
+    {
+        stats->deadline_misses++;
+    }
+
+    stats->jitter_total += jitter;
+    if (jitter < stats->jitter_min)
+    {
+        stats->jitter_min = jitter;
+    }
+    if (jitter > stats->jitter_max)
+    {
+        stats->jitter_max = jitter;
+    }
+
+    stats->response_total += response;
+    if (response < stats->response_min)
+    {
+        stats->response_min = response;
+    }
+    if (response > stats->response_max)
+    {
+        stats->response_max = response;
+    }
+}
+
+static void
+budget_init(void)
+{
+    RtosTaskId task;
+
+    cycle_counter_init();
+
+    for (task = RTOS_TASK_ID_ZERO; task <= RTOS_TASK_ID_MAX; task++)
+    {
+        budgets[task].remaining = (int32_t) budget_capacities[task];
+    }
+
+    budget_activate(RTOS_TASK_ID_ZERO);
+    budget_switch_in = cycle_counter_get();
+}
+
+static void
+budget_activate(const RtosTaskId task)
+{
+    if (budget_limited(task))
+    {
+        budgets[task].activation = rtos_timer_current_ticks;
+        budgets[task].active = true;
+    }
+}
+
+/*
+ * Schedule the replenishment of the cycles a task has consumed since its activation, one replenishment period after
+ * the activation.
+ * When all replenishment slots of the task are in use, the cycles are added to the latest replenishment instead,
+ * which is deferred accordingly.
+ * That returns budget later than a sporadic server with unlimited replenishments would, but never earlier.
+ */
+static void
+budget_post(const RtosTaskId task)
+{
+    struct budget *const budget = &budgets[task];
+    struct budget_replenishment *replenishment;
+
+    if (budget->consumed != 0)
+    {
+        if (budget->replenishment_count < BUDGET_REPLENISHMENTS_MAX)
+        {
+            replenishment = &budget->replenishments[(budget->replenishment_head + budget->replenishment_count) %
+                                                    BUDGET_REPLENISHMENTS_MAX];
+            replenishment->amount = 0;
+            budget->replenishment_count++;
+        }
+        else
+        {
+            replenishment = &budget->replenishments[(budget->replenishment_head + BUDGET_REPLENISHMENTS_MAX - 1) %
+                                                    BUDGET_REPLENISHMENTS_MAX];
+        }
+        replenishment->due = budget->activation + budget_periods[task];
+        replenishment->amount += budget->consumed;
+        budget->consumed = 0;
+    }
+    budget->active = false;
+}
+
+/*
+ * Charge the cycles since the last scheduling decision to the task that executed them.
+ * The active period of the task ends when it exhausts its budget or when it blocks.
+ */
+static RAMFUNC void
+budget_charge(const RtosTaskId task)
+{
+    const uint32_t now = cycle_counter_get();
+    const uint32_t elapsed = now - budget_switch_in;
+    struct budget *const budget = &budgets[task];
+
+    budget_switch_in = now;
+
+    if (budget_limited(task))
+    {
+        budget->remaining -= (int32_t) elapsed;
+        budget->consumed += elapsed;
+
+        if (budget->remaining <= 0)
+        {
+            budget_post(task);
+            budget_overrun(task);
+        }
+        else if (!sched_runnable(task))
+        {
+            budget_post(task);
+        }
+    }
+}
+
+/*
+ * Block a task the scheduler selected if its budget is exhausted, until budget_replenish_process() makes it runnable
+ * again.
+ */
+static RAMFUNC bool
+budget_throttle(const RtosTaskId task)
+{
+    if (budget_limited(task) && budgets[task].remaining <= 0)
+    {
+        sched_set_blocked(task);
+        budgets[task].throttled = true;
+        return true;
+    }
+
+    return false;
+}
+
+static RAMFUNC void
+budget_replenish_process(void)
+{
+    RtosTaskId task;
+    struct budget *budget;
+    struct budget_replenishment *replenishment;
+
+    /* loop bound: 2 */
+    for (task = RTOS_TASK_ID_ZERO; task <= RTOS_TASK_ID_MAX; task++)
+    {
+        budget = &budgets[task];
+        /* loop bound: 4 */
+        while (budget->replenishment_count != 0)
+        {
+            replenishment = &budget->replenishments[budget->replenishment_head];
+            if ((int32_t) (rtos_timer_current_ticks - replenishment->due) < 0)
+            {
+                break;
+            }
+
+            budget->remaining += (int32_t) replenishment->amount;
+            if (budget->remaining > (int32_t) budget_capacities[task])
+            {
+                budget->remaining = (int32_t) budget_capacities[task];
+            }
+            budget->replenishment_head = (budget->replenishment_head + 1) % BUDGET_REPLENISHMENTS_MAX;
+            budget->replenishment_count--;
+        }
+
+        if (budget->throttled && budget->remaining > 0)
+        {
+            budget->throttled = false;
+            sched_set_runnable(task);
+        }
+    }
+}
+
+/*
+ * A task that is switched out ends its active period, so that its replenishment is scheduled relative to when it
+ * started running rather than to when it next runs.
+ * The cycles executed between budget_charge() and this function, i.e., by the scheduler and while the system is idle,
+ * are not charged to any task.
+ */
+static RAMFUNC void
+budget_switch(const RtosTaskId from, const RtosTaskId to)
+{
+    if (from != to && budgets[from].active)
+    {
+        budget_post(from);
+    }
+
+    if (!budgets[to].active)
+    {
+        budget_activate(to);
+    }
+
+    budget_switch_in = cycle_counter_get();
+}
+/*
+ * Advance a network time by the network time that elapses during the given number of cycles at the given rate.
+ * The fraction of a nanosecond that the network time reaches carries over between calls in 'fraction'.
+ * The multiplication is split into 32-bit halves of the rate, so that the product of up to 2^32 cycles does not
+ * overflow.
+ */
+static void
+timebase_advance(RtosNetworkTime *const time, uint32_t *const fraction, const uint32_t cycles,
+                 const uint64_t rate)
+{
+    const uint64_t low = (uint64_t) cycles * (uint32_t) rate + *fraction;
+    uint64_t nanoseconds = (uint64_t) cycles * (uint32_t) (rate >> 32) + (low >> 32) + time->nanoseconds;
+
+    *fraction = (uint32_t) low;
+    /* loop bound: 56 */
+    while (nanoseconds >= TIMEBASE_NANOSECONDS_PER_SECOND)
+    {
+        nanoseconds -= TIMEBASE_NANOSECONDS_PER_SECOND;
+        time->seconds++;
+    }
+    time->nanoseconds = (uint32_t) nanoseconds;
+}
+
+/*
+ * Add a signed number of seconds and nanoseconds to a network time.
+ * The magnitude of the nanoseconds must be less than one second.
+ */
+static void
+timebase_add(RtosNetworkTime *const time, const int32_t seconds, const int32_t nanoseconds)
+{
+    int32_t sum = (int32_t) time->nanoseconds + nanoseconds;
+
+    time->seconds += (uint32_t) seconds;
+    if (sum < 0)
+    {
+        sum += (int32_t) TIMEBASE_NANOSECONDS_PER_SECOND;
+        time->seconds--;
+    }
+    else if (sum >= (int32_t) TIMEBASE_NANOSECONDS_PER_SECOND)
+    {
+        sum -= (int32_t) TIMEBASE_NANOSECONDS_PER_SECOND;
+        time->seconds++;
+    }
+    time->nanoseconds = (uint32_t) sum;
+}
+
+/*
+ * Add the part of the requested total step that the clock does not include yet to a network time.
+ */
+static void
+timebase_add_step(RtosNetworkTime *const time, const uint32_t step_sequence, const uint32_t step_seconds,
+                  const uint32_t step_nanoseconds)
+{
+    const volatile struct timebase_step *const step = &timebase_steps[step_sequence & 1U];
+
+    timebase_add(time, (int32_t) (step->seconds - step_seconds),
+                 (int32_t) step->nanoseconds - (int32_t) step_nanoseconds);
+}
+
+/*
+ * Take a consistent copy of the clock, including a step that the next tick is yet to apply, and return the number of
+ * cycles between the tick and the given cycle counter value, which may precede the tick.
+ * The copy is retried if a tick or a task that steps the network time interrupts it.
+ */
+static int32_t
+timebase_read(struct timebase_clock *const clock, RtosNetworkTime *const time, const uint32_t cycles)
+{
+    uint32_t sequence, step_sequence;
+
+    /* loop bound: retries */
+    do
+    {
+        sequence = timebase_clock.sequence;
+        step_sequence = timebase_step_sequence;
+        clock->ticks = timebase_clock.ticks;
+        clock->cycles = timebase_clock.cycles;
+        clock->fraction = timebase_clock.fraction;
+        clock->rate = timebase_clock.rate;
+        time->seconds = timebase_clock.seconds;
+        time->nanoseconds = timebase_clock.nanoseconds;
+        timebase_add_step(time, step_sequence, timebase_clock.step_seconds, timebase_clock.step_nanoseconds);
+    }
+    while (sequence != timebase_clock.sequence || step_sequence != timebase_step_sequence);
+
+    return (int32_t) (cycles - clock->cycles);
+}
+
+/*
+ * Convert a cycle counter value within half the range of the cycle counter of the most recent tick to network time.
+ */
+static void
+timebase_at(const uint32_t cycles, RtosNetworkTime *const time)
+{
+    struct timebase_clock clock;
+    const int32_t elapsed = timebase_read(&clock, time, cycles);
+
+    if (elapsed >= 0)
+    {
+        timebase_advance(time, &clock.fraction, (uint32_t) elapsed, clock.rate);
+    }
+    else
+    {
+        RtosNetworkTime before = { 0, 0 };
+
+        clock.fraction = 0;
+        timebase_advance(&before, &clock.fraction, (uint32_t) -elapsed, clock.rate);
+        timebase_add(time, -(int32_t) before.seconds, -(int32_t) before.nanoseconds);
+    }
+}
+
+/*
+ * Convert a network time to the relative number of ticks after which the RTOS processes the first tick at or after the
+ * network time.
+ * Network times in the past convert to the next tick the RTOS processes.
+ */
+static RtosTicksRelative
+timebase_ticks_until(const RtosNetworkTime *const time)
+{
+    struct timebase_clock clock;
+    RtosNetworkTime tick;
+    uint32_t seconds;
+    int32_t nanoseconds;
+    RtosTicksAbsolute ticks;
+
+    (void) timebase_read(&clock, &tick, cycle_counter_get());
+
+    seconds = time->seconds - tick.seconds;
+    nanoseconds = (int32_t) time->nanoseconds - (int32_t) tick.nanoseconds;
+    if (nanoseconds < 0)
+    {
+        nanoseconds += (int32_t) TIMEBASE_NANOSECONDS_PER_SECOND;
+        seconds--;
+    }
+
+    if ((int32_t) seconds < 0)
+    {
+        ticks = 0;
+    }
+    else if (seconds > TIMEBASE_SECONDS_MAX)
+    {
+        api_error(ERROR_ID_TIMEBASE_TIME_TOO_FAR);
+        ticks = TIMEBASE_SECONDS_MAX * TIMEBASE_TICKS_PER_SECOND;
+    }
+    else
+    {
+        ticks = seconds * TIMEBASE_TICKS_PER_SECOND +
+            ((uint32_t) nanoseconds + TIMEBASE_TICK_PERIOD - 1U) / TIMEBASE_TICK_PERIOD;
+    }
+
+    /* The tick interrupt handler may have counted ticks that the RTOS is yet to process */
+    return (RtosTicksRelative) (ticks + (clock.ticks - rtos_timer_current_ticks));
+}
+
+static void
+timebase_init(void)
+{
+    cycle_counter_init();
+    timebase_clock.cycles = cycle_counter_get();
+    timebase_clock.rate = TIMEBASE_RATE;
+    timebase_cycles_per_nanosecond = TIMEBASE_CYCLES_PER_NANOSECOND;
+    timebase_reload = RTOS_TIMEBASE_TICK_CYCLES;
+}
+static void
+interrupt_event_process(void)
+{
+    interrupt_event_handle(0);
+}
+RAMFUNC RtosTaskId
+rtos_internal_interrupt_event_get_next(void)
+{
+    TaskIdOption next;
+
+    budget_charge(get_current_task());
+
+    /* loop bound: 2 + 1 */
+    for (;;)
+    {
+        interrupt_event_process();
+        timer_tick_process();
+        budget_replenish_process();
+        next = sched_get_next();
+        if (next != TASK_ID_NONE && budget_throttle(next))
+        {
+            continue;
+        }
+
+        if (next == TASK_ID_NONE)
+        {
+            system_is_idle = true;
+            interrupt_event_wait();
+        }
+        else
+        {
+            system_is_idle = false;
+            break;
+        }
+    }
+
+    internal_assert_task_valid(next);
+    budget_switch(get_current_task(), next);
+
+    return next;
+}
+static RAMFUNC void
+interrupt_event_handle(const RtosInterruptEventId interrupt_event_id)
+{
+    precondition_preemption_disabled();
+
+    internal_assert(interrupt_event_id < 2, ERROR_ID_INTERNAL_INVALID_ID);
+
+#ifdef PREEMPTION_SUPPORT
+    signal_send_set(interrupt_events[interrupt_event_id].task, interrupt_events[interrupt_event_id].sig_set);
+#else
+    rtos_signal_send_set(interrupt_events[interrupt_event_id].task,
+            interrupt_events[interrupt_event_id].sig_set);
+#endif
+
+    postcondition_preemption_disabled();
+}
+static bool
+mutex_try_lock(const RtosMutexId m)
+{
+    const bool r = mutexes[m].holder == TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    if (r)
+    {
+        mutexes[m].holder = get_current_task();
+    }
+
+    postcondition_preemption_disabled();
+
+    return r;
+}
+
+/*
+ * Lock the mutex, blocking the current task while another task holds it.
+ * Returns whether the mutex was contended.
+ */
+static bool
+mutex_acquire(const RtosMutexId m) RTOS_REENTRANT
+{
+    bool contended = false;
+
+    precondition_preemption_disabled();
+
+    while (!mutex_try_lock(m))
+    {
+        contended = true;
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on(mutexes[m].holder);
+    }
+
+    postcondition_preemption_disabled();
+
+    return contended;
+}
+
+static void
+mutex_release(const RtosMutexId m)
+{
+    RtosTaskId t;
+
+    precondition_preemption_disabled();
+
+
+    /* loop bound: 2 */
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        if (mutex_waiters[t] == m)
+        {
+            mutex_waiters[t] = MUTEX_ID_NONE;
+            mutex_core_unblock(t);
+        }
+    }
+
+    mutexes[m].holder = TASK_ID_NONE;
+
+    postcondition_preemption_disabled();
+}
+static void
+cond_wake(const RtosCondId cond, const bool all)
+{
+    RtosTaskId t;
+    TaskIdOption waiter = TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    /* loop bound: 2 */
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        if (cond_waiters[t] == cond)
+        {
+            if (all)
+            {
+                cond_waiters[t] = COND_ID_NONE;
+                cond_core_unblock(t);
+            }
+            else if (waiter == TASK_ID_NONE || cond_core_higher_priority(t, waiter))
+            {
+                waiter = t;
+            }
+        }
+    }
+
+    if (waiter != TASK_ID_NONE)
+    {
+        cond_waiters[waiter] = COND_ID_NONE;
+        cond_core_unblock(waiter);
+    }
+
+    postcondition_preemption_disabled();
+}
+static void
+sem_init(void)
+{
+    RtosTaskId t;
+
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        sem_waiters[t] = SEM_ID_NONE;
+    }
+}
+
+static bool
+internal_sem_try_wait(const RtosSemId s)
+{
+    precondition_preemption_disabled();
+
+    if (semaphores[s].value == SEM_VALUE_ZERO)
+    {
+        return false;
+    }
+    else
+    {
+        semaphores[s].value--;
+        return true;
+    }
+
+    postcondition_preemption_disabled();
+}
+static bool
+atomic_compare_and_swap(volatile uint32_t *const word, const uint32_t expected, const uint32_t desired)
+{
+    if (*word != expected)
+    {
+        return false;
+    }
+    *word = desired;
+    return true;
+}
+static void
+pool_init(void)
+{
+    RtosPoolId pool;
+    RtosTaskId t;
+    uint16_t index;
+
+    for (pool = 0; pool < 1; pool++)
+    {
+        for (index = 0; index < pools[pool].block_count; index++)
+        {
+            pool_block_next(pool_block(pool, index)) = index + 1U < pools[pool].block_count ? index + 1U : POOL_BLOCK_NONE;
+        }
+        pool_states[pool].head = 0;
+    }
+
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        pool_waiters[t] = POOL_ID_NONE;
+    }
+}
+
+static void
+pool_used_add(const RtosPoolId pool, const int32_t delta)
+{
+    struct pool_state *const state = &pool_states[pool];
+    uint32_t used;
+    uint32_t high_water_mark;
+
+    /* loop bound: retries */
+    do
+    {
+        used = state->used;
+    } while (!atomic_compare_and_swap(&state->used, used, used + (uint32_t) delta));
+
+    used += (uint32_t) delta;
+    /* loop bound: retries */
+    do
+    {
+        high_water_mark = state->high_water_mark;
+    } while (used > high_water_mark && !atomic_compare_and_swap(&state->high_water_mark, high_water_mark, used));
+}
+
+static RAMFUNC void *
+pool_try_alloc(const RtosPoolId pool)
+{
+    struct pool_state *const state = &pool_states[pool];
+    uint32_t head;
+    uint16_t index;
+    uint8_t *block;
+
+    /* loop bound: retries */
+    do
+    {
+        head = state->head;
+        index = pool_head_index(head);
+        if (index == POOL_BLOCK_NONE)
+        {
+            return NULL;
+        }
+        block = pool_block(pool, index);
+        /* If another allocation takes the block before the compare-and-swap, next may be garbage, but then the tag of
+         * the head has changed and the compare-and-swap fails. */
+    } while (!atomic_compare_and_swap(&state->head, head, pool_head_next(head, pool_block_next(block))));
+
+    pool_used_add(pool, 1);
+
+    return block;
+}
+static void
+work_queue_init(void)
+{
+    RtosWorkQueueId work_queue;
+    uint32_t pos;
+
+    for (work_queue = 0; work_queue < 1; work_queue++)
+    {
+        for (pos = 0; pos <= work_queues[work_queue].mask; pos++)
+        {
+            work_queues[work_queue].slots[pos].sequence = pos;
+        }
+    }
+}
+
+/*
+ * Tasks and interrupt handlers may enqueue concurrently.
+ * A producer that is interrupted after claiming a position but before releasing its slot delays consumers until it
+ * continues, but it never blocks other producers.
+ * Since producers wake up the workers only after releasing the slot, a worker that finds the slot not yet released
+ * and waits is woken up again.
+ */
+static bool
+work_queue_enqueue(const RtosWorkQueueId work_queue, const RtosWorkFunction function,
+                   void *const context)
+{
+    const struct work_queue *const q = &work_queues[work_queue];
+    struct work_queue_state *const state = &work_queue_states[work_queue];
+    struct work_slot *slot;
+    uint32_t pos;
+
+    /* loop bound: retries */
+    for (;;)
+    {
+        pos = state->enqueue_pos;
+        slot = &q->slots[pos & q->mask];
+        if (slot->sequence == pos)
+        {
+            if (atomic_compare_and_swap(&state->enqueue_pos, pos, pos + 1))
+            {
+                break;
+            }
+        }
+        else if ((int32_t) (slot->sequence - pos) < 0)
+        {
+            /* The slot still holds the item of the previous round, so the queue is full */
+            return false;
+        }
+        /* Otherwise, another producer has claimed the position in the meantime */
+    }
+
+    slot->function = function;
+    slot->context = context;
+    slot->sequence = pos + 1;
+
+    return true;
+}
+
+static bool
+work_queue_dequeue(const RtosWorkQueueId work_queue, RtosWorkFunction *const function,
+                   void **const context)
+{
+    const struct work_queue *const q = &work_queues[work_queue];
+    struct work_queue_state *const state = &work_queue_states[work_queue];
+    struct work_slot *slot;
+    uint32_t pos;
+
+    /* loop bound: retries */
+    for (;;)
+    {
+        pos = state->dequeue_pos;
+        slot = &q->slots[pos & q->mask];
+        if (slot->sequence == pos + 1)
+        {
+            if (atomic_compare_and_swap(&state->dequeue_pos, pos, pos + 1))
+            {
+                break;
+            }
+        }
+        else if ((int32_t) (slot->sequence - (pos + 1)) < 0)
+        {
+            /* No producer has released the slot at this position yet, so the queue is empty */
+            return false;
+        }
+        /* Otherwise, another worker has claimed the position in the meantime */
+    }
+
+    *function = slot->function;
+    *context = slot->context;
+    slot->sequence = pos + q->mask + 1;
+
+    return true;
+}
+
+static RtosTaskId
+get_current_task_check(void)
+{
+    internal_assert(current_task < 2, ERROR_ID_INTERNAL_CURRENT_TASK_INVALID);
+    return current_task;
+}
+static void
+entry_a(void)
+{
+    precondition_preemption_disabled();
+
+    preempt_enable();
+    fn_a();
+}
+static void
+entry_b(void)
+{
+    precondition_preemption_disabled();
+
+    preempt_enable();
+    fn_b();
+}
+
+static void
+block_on(const RtosTaskId blocker)
+{
+    precondition_preemption_disabled();
+
+    sched_set_blocked_on(get_current_task(), blocker);
+    yield();
+
+    postcondition_preemption_disabled();
+}
+
+
+static void
+mutex_core_block_on_timeout(const RtosTaskId t, const RtosTicksRelative ticks)
+{
+    precondition_preemption_disabled();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    mutex_core_block_on(t);
+    timer_disable(task_timers[get_current_task()]);
+
+    postcondition_preemption_disabled();
+}
+
+static void
+sem_core_block_timeout(const RtosTicksRelative ticks)
+{
+    precondition_preemption_disabled();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    sem_core_block();
+    timer_disable(task_timers[get_current_task()]);
+
+    postcondition_preemption_disabled();
+}
+
+static RAMFUNC void
+unblock(const RtosTaskId task)
+{
+    precondition_preemption_disabled();
+
+    sched_set_runnable(task);
+
+    /* Note: When preemption is enabled a yield should be forced as a higher priority task may have been scheduled. */
+    preempt_pend();
+
+    postcondition_preemption_disabled();
+}
+
+
+
+
+RtosSignalSet
+rtos_signal_wait_set(const RtosSignalSet requested_signals) RTOS_REENTRANT
+{
+    RtosSignalSet received_signals;
+
+    preempt_disable();
+
+    received_signals = signal_wait_set(requested_signals);
+
+    preempt_enable();
+
+    return received_signals;
+}
+
+RtosSignalSet
+rtos_signal_poll_set(const RtosSignalSet requested_signals)
+{
+    RtosSignalSet *const pending_signals = &PENDING_SIGNALS(get_current_task());
+    RtosSignalSet received_signals;
+
+    preempt_disable();
+
+    received_signals = signal_recv(pending_signals, requested_signals);
+
+    preempt_enable();
+
+    return received_signals;
+}
+
+RtosSignalSet
+rtos_signal_peek_set(const RtosSignalSet requested_signals)
+{
+    const RtosSignalSet pending_signals = PENDING_SIGNALS(get_current_task());
+    return pending_signals & requested_signals;
+}
+
+RAMFUNC void
+rtos_signal_send_set(const RtosTaskId task_id, const RtosSignalSet signals)
+{
+    assert_task_valid(task_id);
+
+    preempt_disable();
+
+    signal_send_set(task_id, signals);
+
+    preempt_enable();
+}
+
+void
+rtos_sleep(const RtosTicksRelative ticks) RTOS_REENTRANT
+{
+    preempt_disable();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    signal_wait(RTOS_SIGNAL_ID__TASK_TIMER);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_enable(const RtosTimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_enable(timer_id);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_disable(const RtosTimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_disable(timer_id);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_oneshot(const RtosTimerId timer_id, const RtosTicksRelative timeout)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_oneshot(timer_id, timeout);
+
+    preempt_enable();
+}
+
+bool
+rtos_timer_check_overflow(const RtosTimerId timer_id)
+{
+    bool r;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    r = (timers_overflow[TIMER_WORD(timer_id)] & TIMER_BIT(timer_id)) != 0;
+    timers_overflow[TIMER_WORD(timer_id)] &= ~TIMER_BIT(timer_id);
+
+    preempt_enable();
+
+    return r;
+}
+
+RtosTicksRelative
+rtos_timer_remaining(const RtosTimerId timer_id)
+{
+    RtosTicksRelative remaining;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    remaining = timer_is_enabled(timer_id) ? timer_expiries[timer_id] - current_timeout() : 0;
+
+    preempt_enable();
+
+    return remaining;
+}
+
+/* Configuration functions */
+void
+rtos_timer_reload_set(const RtosTimerId timer_id, const RtosTicksRelative reload)
+{
+    assert_timer_valid(timer_id);
+
+    timer_reload_set(timer_id, reload);
+}
+
+void
+rtos_timer_signal_set(const RtosTimerId timer_id, const RtosTaskId task_id, const RtosSignalSet signal_set)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_error_ids[timer_id] = ERROR_ID_NONE;
+    timer_task_ids[timer_id] = task_id;
+    timer_signal_sets[timer_id] = signal_set;
+
+    preempt_enable();
+}
+
+void
+rtos_timer_error_set(const RtosTimerId timer_id, const RtosErrorId error_id)
+{
+    assert_timer_valid(timer_id);
+
+    timer_error_ids[timer_id] = error_id;
+}
+
+void
+rtos_periodic_wait_next(void) RTOS_REENTRANT
+{
+    const PeriodicIndex idx = periodic_index_get(get_current_task());
+    struct periodic_task *periodic;
+    RtosTicksAbsolute release;
+
+    api_assert(idx != PERIODIC_INDEX_NONE, ERROR_ID_TIMER_TASK_NOT_PERIODIC);
+    periodic = &periodic_tasks[idx];
+
+    preempt_disable();
+
+    if (periodic->job_active)
+    {
+        periodic_stats_record(idx, periodic->job_jitter,
+                              periodic_ticks_clamp(rtos_timer_current_ticks - periodic->release));
+    }
+
+    /*
+     * The release time of the current job determines when periodic_release_process() signals the next one, so it
+     * only advances once the next job is released
+     */
+    release = periodic->release + periodic->period;
+    while ((int32_t) (rtos_timer_current_ticks - release) < 0)
+    {
+        (void) signal_wait_set(periodic->signal_set);
+    }
+    periodic->release = release;
+
+    periodic->job_jitter = periodic_ticks_clamp(rtos_timer_current_ticks - release);
+    periodic->job_active = true;
+
+    preempt_enable();
+}
+
+void
+rtos_periodic_stats_clear(void)
+{
+    PeriodicIndex idx;
+    const RtosPeriodicStats initial_stats = RTOS_PERIODIC_STATS_INIT;
+
+    preempt_disable();
+
+    /* loop bound: 1 */
+    for (idx = 0; idx <= PERIODIC_INDEX_MAX; idx++)
+    {
+        rtos_periodic_stats[idx] = initial_stats;
+    }
+
+    preempt_enable();
+}
+
+
+/*
+ * The tick interrupt handler calls this function at each tick, in place of timer_tick().
+ * The period that ends at the next tick is already loaded into the tick timer, so the returned reload value applies
+ * to the period after it.
+ * It is chosen so that the period ends at the multiple of the tick period that is nearest to one tick period after the
+ * next tick in network time, which keeps ticks aligned to network time while the network time is adjusted or stepped.
+ */
+uint32_t
+rtos_timebase_tick(void)
+{
+    const uint32_t cycles = cycle_counter_get();
+    const int32_t adjustment = timebase_adjustment;
+    const uint32_t step_sequence = timebase_step_sequence;
+    RtosNetworkTime time;
+    uint32_t fraction = timebase_clock.fraction;
+    uint64_t rate = timebase_clock.rate;
+    uint32_t phase, period;
+
+    time.seconds = timebase_clock.seconds;
+    time.nanoseconds = timebase_clock.nanoseconds;
+    timebase_advance(&time, &fraction, cycles - timebase_clock.cycles, rate);
+
+    timebase_add_step(&time, step_sequence, timebase_clock.step_seconds, timebase_clock.step_nanoseconds);
+
+    /* The adjustment applies from this tick onwards, relative to the nominal rates */
+    if (adjustment != timebase_applied_adjustment)
+    {
+        rate = TIMEBASE_RATE + (uint64_t) ((adjustment * TIMEBASE_RATE_PER_PPB) >> 16);
+        timebase_cycles_per_nanosecond = TIMEBASE_CYCLES_PER_NANOSECOND -
+            (uint64_t) ((adjustment * TIMEBASE_CYCLES_PER_NANOSECOND_PER_PPB) >> 16);
+        timebase_applied_adjustment = adjustment;
+    }
+
+    timebase_clock.ticks++;
+    timebase_clock.cycles = cycles;
+    timebase_clock.seconds = time.seconds;
+    timebase_clock.nanoseconds = time.nanoseconds;
+    timebase_clock.fraction = fraction;
+    timebase_clock.rate = rate;
+    timebase_clock.step_seconds = timebase_steps[step_sequence & 1U].seconds;
+    timebase_clock.step_nanoseconds = timebase_steps[step_sequence & 1U].nanoseconds;
+    timebase_clock.sequence++;
+
+    /* Predict the network time of the next tick, and end the following period at a multiple of the tick period */
+    timebase_advance(&time, &fraction, timebase_reload, rate);
+    phase = time.nanoseconds % TIMEBASE_TICK_PERIOD;
+    period = (phase < TIMEBASE_TICK_PERIOD / 2U ? 1U : 2U) * TIMEBASE_TICK_PERIOD - phase;
+    timebase_reload = (uint32_t) (((uint64_t) period * timebase_cycles_per_nanosecond) >> 32);
+
+    rtos_timer_tick();
+
+    return timebase_reload;
+}
+
+uint32_t
+rtos_timebase_cycles(void)
+{
+    return cycle_counter_get();
+}
+
+void
+rtos_timebase_now(RtosNetworkTime *const time)
+{
+    timebase_at(cycle_counter_get(), time);
+}
+
+void
+rtos_timebase_from_cycles(const uint32_t cycles, RtosNetworkTime *const time)
+{
+    timebase_at(cycles, time);
+}
+
+void
+rtos_timebase_set(const RtosNetworkTime *const time)
+{
+    RtosNetworkTime now, total;
+    uint32_t step_sequence;
+
+    preempt_disable();
+
+    /*
+     * Only tasks publish steps, so the total does not change while preemption is disabled.
+     * The current network time includes it, whether or not a tick has applied it to the clock, so the new total
+     * differs from it by the difference between the requested and the current network time.
+     */
+    step_sequence = timebase_step_sequence;
+    timebase_at(cycle_counter_get(), &now);
+    total.seconds = timebase_steps[step_sequence & 1U].seconds;
+    total.nanoseconds = timebase_steps[step_sequence & 1U].nanoseconds;
+    timebase_add(&total, (int32_t) (time->seconds - now.seconds),
+                 (int32_t) time->nanoseconds - (int32_t) now.nanoseconds);
+
+    timebase_steps[(step_sequence + 1U) & 1U].seconds = total.seconds;
+    timebase_steps[(step_sequence + 1U) & 1U].nanoseconds = total.nanoseconds;
+    timebase_step_sequence = step_sequence + 1U;
+
+    preempt_enable();
+}
+
+void
+rtos_timebase_adjust(const int32_t ppb)
+{
+    if (ppb > TIMEBASE_ADJUSTMENT_MAX)
+    {
+        timebase_adjustment = TIMEBASE_ADJUSTMENT_MAX;
+    }
+    else if (ppb < -TIMEBASE_ADJUSTMENT_MAX)
+    {
+        timebase_adjustment = -TIMEBASE_ADJUSTMENT_MAX;
+    }
+    else
+    {
+        timebase_adjustment = ppb;
+    }
+}
+
+void
+rtos_timer_oneshot_at(const RtosTimerId timer_id, const RtosNetworkTime *const time)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_oneshot(timer_id, timebase_ticks_until(time));
+
+    preempt_enable();
+}
+
+void
+rtos_sleep_until(const RtosNetworkTime *const time) RTOS_REENTRANT
+{
+    preempt_disable();
+
+    timer_oneshot(task_timers[get_current_task()], timebase_ticks_until(time));
+    signal_wait(RTOS_SIGNAL_ID__TASK_TIMER);
+
+    preempt_enable();
+}
+
+
+
+void
+rtos_mutex_lock(const RtosMutexId m) RTOS_REENTRANT
+{
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder != get_current_task(), ERROR_ID_DEADLOCK);
+
+    preempt_disable();
+
+    (void) mutex_acquire(m);
+
+    preempt_enable();
+
+}
+
+bool
+rtos_mutex_lock_timeout(const RtosMutexId m, const RtosTicksRelative timeout)
+        RTOS_REENTRANT
+{
+    bool ret;
+    const RtosTicksAbsolute absolute_timeout = rtos_timer_current_ticks + timeout;
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder != get_current_task(), ERROR_ID_DEADLOCK);
+
+    preempt_disable();
+
+    ret = mutex_try_lock(m);
+    while (!ret && absolute_timeout > rtos_timer_current_ticks) {
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on_timeout(mutexes[m].holder, absolute_timeout - rtos_timer_current_ticks);
+        ret = mutex_try_lock(m);
+    }
+
+    preempt_enable();
+
+
+    return ret;
+}
+
+void
+rtos_mutex_unlock(const RtosMutexId m)
+{
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    mutex_release(m);
+
+    preempt_enable();
+}
+
+bool
+rtos_mutex_try_lock(const RtosMutexId m)
+{
+    bool r;
+
+    assert_mutex_valid(m);
+
+    preempt_disable();
+
+    r = mutex_try_lock(m);
+
+    preempt_enable();
+
+    return r;
+}
+
+/* A macro implementation would be preferable to eliminate function call overhead when compilers don't support implicit
+ * inlining, but at present this would involve exposing too many implementation internals in the public API header. */
+bool
+rtos_mutex_holder_is_current(const RtosMutexId m)
+{
+    assert_mutex_valid(m);
+    return mutexes[m].holder == get_current_task();
+}
+
+void
+rtos_cond_wait(const RtosCondId cond, const RtosMutexId m) RTOS_REENTRANT
+{
+    assert_cond_valid(cond);
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    /* With preemption disabled, no other task can signal the condition variable between releasing the mutex and
+     * blocking, so the wakeup cannot be lost. */
+    cond_waiters[get_current_task()] = cond;
+    mutex_release(m);
+
+    /* The task may also receive the blocking signal for reasons other than being woken up, e.g., a stale signal of an
+     * earlier timeout, so block until it is actually removed from the waiters. */
+    do
+    {
+        cond_core_block();
+    } while (cond_waiters[get_current_task()] == cond);
+
+    (void) mutex_acquire(m);
+
+    preempt_enable();
+}
+
+bool
+rtos_cond_wait_timeout(const RtosCondId cond, const RtosMutexId m,
+                                 const RtosTicksRelative timeout) RTOS_REENTRANT
+{
+    bool signaled;
+    const RtosTicksAbsolute absolute_timeout = rtos_timer_current_ticks + timeout;
+
+    assert_cond_valid(cond);
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    cond_waiters[get_current_task()] = cond;
+    mutex_release(m);
+
+    while (cond_waiters[get_current_task()] == cond && absolute_timeout > rtos_timer_current_ticks)
+    {
+        cond_core_block_timeout(absolute_timeout - rtos_timer_current_ticks);
+    }
+    signaled = cond_waiters[get_current_task()] != cond;
+    cond_waiters[get_current_task()] = COND_ID_NONE;
+
+    (void) mutex_acquire(m);
+
+    preempt_enable();
+
+    return signaled;
+}
+
+void
+rtos_cond_signal(const RtosCondId cond)
+{
+    assert_cond_valid(cond);
+
+    preempt_disable();
+
+    cond_wake(cond, false);
+
+    preempt_enable();
+}
+
+void
+rtos_cond_broadcast(const RtosCondId cond)
+{
+    assert_cond_valid(cond);
+
+    preempt_disable();
+
+    cond_wake(cond, true);
+
+    preempt_enable();
+}
+void
+rtos_sem_wait(const RtosSemId s) RTOS_REENTRANT
+{
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+    while (!internal_sem_try_wait(s))
+    {
+        sem_waiters[get_current_task()] = s;
+        sem_core_block();
+    }
+
+    preempt_enable();
+}
+
+bool
+rtos_sem_wait_timeout(const RtosSemId s, const RtosTicksRelative timeout)
+        RTOS_REENTRANT
+{
+    bool ret;
+    const RtosTicksAbsolute absolute_timeout = rtos_timer_current_ticks + timeout;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+    while (!(ret = internal_sem_try_wait(s)) && absolute_timeout > rtos_timer_current_ticks) {
+        sem_waiters[get_current_task()] = s;
+        sem_core_block_timeout(absolute_timeout - rtos_timer_current_ticks);
+    }
+
+    preempt_enable();
+
+    return ret;
+}
+
+void
+rtos_sem_post(const RtosSemId s)
+{
+    RtosTaskId t;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+
+    if (semaphores[s].value == SEM_VALUE_ZERO)
+    {
+        /* loop bound: 2 */
+        for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+        {
+            if (sem_waiters[t] == s)
+            {
+                sem_waiters[t] = SEM_ID_NONE;
+                sem_core_unblock(t);
+            }
+        }
+    }
+
+    semaphores[s].value++;
+
+    preempt_enable();
+}
+
+bool
+rtos_sem_try_wait(const RtosSemId s)
+{
+    bool r;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+    r = internal_sem_try_wait(s);
+    preempt_enable();
+
+    return r;
+}
+
+
+void *
+rtos_pool_alloc(const RtosPoolId pool)
+{
+    assert_pool_valid(pool);
+
+    return pool_try_alloc(pool);
+}
+
+void *
+rtos_pool_alloc_wait(const RtosPoolId pool) RTOS_REENTRANT
+{
+    void *block;
+
+    assert_pool_valid(pool);
+
+    preempt_disable();
+
+    while ((block = pool_try_alloc(pool)) == NULL)
+    {
+        pool_waiters[get_current_task()] = pool;
+        sem_core_block();
+    }
+    /* A block freed by an interrupt handler does not make the task runnable, so it may still be a waiter */
+    pool_waiters[get_current_task()] = POOL_ID_NONE;
+
+    preempt_enable();
+
+    return block;
+}
+
+void *
+rtos_pool_alloc_timeout(const RtosPoolId pool, const RtosTicksRelative timeout)
+        RTOS_REENTRANT
+{
+    void *block;
+    const RtosTicksAbsolute absolute_timeout = rtos_timer_current_ticks + timeout;
+
+    assert_pool_valid(pool);
+
+    preempt_disable();
+
+    while ((block = pool_try_alloc(pool)) == NULL && absolute_timeout > rtos_timer_current_ticks)
+    {
+        pool_waiters[get_current_task()] = pool;
+        sem_core_block_timeout(absolute_timeout - rtos_timer_current_ticks);
+    }
+    pool_waiters[get_current_task()] = POOL_ID_NONE;
+
+    preempt_enable();
+
+    return block;
+}
+
+void
+rtos_pool_free(const RtosPoolId pool, void *const block)
+{
+    RtosTaskId t;
+
+    rtos_pool_free_from_interrupt(pool, block);
+
+    preempt_disable();
+
+    /* loop bound: 2 */
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        if (pool_waiters[t] == pool)
+        {
+            pool_waiters[t] = POOL_ID_NONE;
+            sem_core_unblock(t);
+        }
+    }
+
+    preempt_enable();
+}
+
+/*
+ * Interrupt handlers must not unblock tasks, so tasks waiting for a block of the pool only notice a block freed by an
+ * interrupt handler when a task frees a block or their timeout expires.
+ */
+void
+rtos_pool_free_from_interrupt(const RtosPoolId pool, void *const block)
+{
+    struct pool_state *state;
+    uint32_t offset;
+    uint16_t index;
+    uint32_t head;
+
+    assert_pool_valid(pool);
+    api_assert((uint8_t *) block >= pools[pool].storage, ERROR_ID_POOL_INVALID_BLOCK);
+
+    state = &pool_states[pool];
+    offset = (uint32_t) ((uint8_t *) block - pools[pool].storage);
+    index = (uint16_t) (offset / pools[pool].block_stride);
+    api_assert(offset % pools[pool].block_stride == 0 && offset / pools[pool].block_stride < pools[pool].block_count,
+               ERROR_ID_POOL_INVALID_BLOCK);
+    /* A block that is freed twice without being allocated in between is detected if it is still the first free block,
+     * or if no block of the pool is allocated. */
+    api_assert(pool_head_index(state->head) != index && state->used != 0, ERROR_ID_POOL_INVALID_BLOCK);
+
+    /* loop bound: retries */
+    do
+    {
+        head = state->head;
+        pool_block_next(block) = pool_head_index(head);
+    } while (!atomic_compare_and_swap(&state->head, head, pool_head_next(head, index)));
+
+    pool_used_add(pool, -1);
+}
+
+uint16_t
+rtos_pool_high_water_mark(const RtosPoolId pool)
+{
+    assert_pool_valid(pool);
+
+    return (uint16_t) pool_states[pool].high_water_mark;
+}
+bool
+rtos_work_queue_submit(const RtosWorkQueueId work_queue, const RtosWorkFunction function,
+                                 void *const context)
+{
+    WorkerIndex w;
+
+    assert_work_queue_valid(work_queue);
+    api_assert(function != NULL, ERROR_ID_WORK_QUEUE_INVALID_FUNCTION);
+
+    if (!work_queue_enqueue(work_queue, function, context))
+    {
+        return false;
+    }
+
+    preempt_disable();
+
+    /* loop bound: 1 */
+    for (w = work_queues[work_queue].first_worker;
+         w < work_queues[work_queue].first_worker + work_queues[work_queue].worker_count; w++)
+    {
+        signal_send_set(work_queue_workers[w].task, RTOS_SIGNAL_SET__WORK);
+    }
+
+    preempt_enable();
+
+    return true;
+}
+
+/*
+ * Interrupt handlers must not interact with the scheduler directly, so they wake up the workers by raising their
+ * interrupt events.
+ * Raising an interrupt event that is already pending has no further effect, so a burst of submissions results in a
+ * single wakeup of each worker.
+ */
+bool
+rtos_work_queue_submit_from_interrupt(const RtosWorkQueueId work_queue,
+                                                const RtosWorkFunction function, void *const context)
+{
+    WorkerIndex w;
+
+    assert_work_queue_valid(work_queue);
+    api_assert(function != NULL, ERROR_ID_WORK_QUEUE_INVALID_FUNCTION);
+
+    if (!work_queue_enqueue(work_queue, function, context))
+    {
+        return false;
+    }
+
+    /* loop bound: 1 */
+    for (w = work_queues[work_queue].first_worker;
+         w < work_queues[work_queue].first_worker + work_queues[work_queue].worker_count; w++)
+    {
+        rtos_interrupt_event_raise(work_queue_workers[w].interrupt_event);
+    }
+
+    return true;
+}
+
+void
+rtos_work_queue_worker(const RtosWorkQueueId work_queue) RTOS_REENTRANT
+{
+    RtosWorkFunction function;
+    void *context;
+
+    assert_work_queue_valid(work_queue);
+
+    for (;;)
+    {
+        /* Drain all items that have been submitted up to now before waiting again */
+        while (work_queue_dequeue(work_queue, &function, &context))
+        {
+            function(context);
+        }
+
+        (void) rtos_signal_wait_set(RTOS_SIGNAL_SET__WORK);
+    }
+}
+
+RtosTaskId
+rtos_task_current(void)
+{
+    return get_current_task();
+}
+void
+rtos_start(void)
+{
+    sem_init();
+    preempt_init();
+
+    context_init(get_task_context(0), entry_a, stack_0, 8192);
+    sched_set_runnable(0);
+    context_init(get_task_context(1), entry_b, stack_1, 8192);
+    sched_set_runnable(1);
+
+    budget_init();
+
+    timebase_init();
+
+    pool_init();
+
+    work_queue_init();
+
+    context_switch_first(RTOS_TASK_ID_ZERO);
+}
@@ -0,0 +1,247 @@
+#ifndef RTOS_KOCHAB_H
+#define RTOS_KOCHAB_H
+
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <stdint.h>
+#include <stdint.h>
+
+#include <stdint.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+
+
+
+
+typedef uint8_t RtosSignalSet;
+typedef RtosSignalSet RtosSignalId;
+
+typedef uint8_t RtosTimerId;
+typedef uint32_t RtosTicksAbsolute;
+typedef uint16_t RtosTicksRelative;
+
+
+typedef uint8_t RtosInterruptEventId;
+
+typedef uint8_t RtosMutexId;
+typedef uint8_t RtosCondId;
+typedef uint8_t RtosSemId;
+typedef uint8_t RtosSemValue;
+typedef uint8_t RtosPoolId;
+typedef uint8_t RtosWorkQueueId;
+typedef void (*RtosWorkFunction)(void *context);
+typedef uint8_t RtosErrorId;
+typedef uint8_t RtosTaskId;
+
+
+
+
+
+
+
+/* The timing statistics of the completed jobs of a periodic task, in ticks.
+ * The averages are the totals divided by the number of jobs. */
+typedef struct {
+    uint32_t jobs;
+    uint32_t deadline_misses;
+    uint32_t jitter_total;
+    uint32_t response_total;
+    RtosTicksRelative jitter_min;
+    RtosTicksRelative jitter_max;
+    RtosTicksRelative response_min;
+    RtosTicksRelative response_max;
+} RtosPeriodicStats;
+/* A network time, e.g., a PTP timestamp, in seconds and nanoseconds since the epoch of the network's time scale */
+typedef struct {
+    uint32_t seconds;
+    uint32_t nanoseconds;
+} RtosNetworkTime;
+
+
+
+
+
+
+
+
+
+
+
+#define RTOS_REENTRANT 
+
+
+
+#define RTOS_SIGNAL_SET_EMPTY ((RtosSignalSet) UINT8_C(0))
+#define RTOS_SIGNAL_SET_ALL ((RtosSignalSet) UINT8_MAX)
+#define RTOS_SIGNAL_SET_TIMER ((RtosSignalSet) UINT8_C(1))
+#define RTOS_SIGNAL_ID_TIMER ((RtosSignalId) RTOS_SIGNAL_SET_TIMER)
+#define RTOS_SIGNAL_SET_TEST ((RtosSignalSet) UINT8_C(2))
+#define RTOS_SIGNAL_ID_TEST ((RtosSignalId) RTOS_SIGNAL_SET_TEST)
+#define RTOS_SIGNAL_SET_RELEASE ((RtosSignalSet) UINT8_C(4))
+#define RTOS_SIGNAL_ID_RELEASE ((RtosSignalId) RTOS_SIGNAL_SET_RELEASE)
+#define RTOS_SIGNAL_SET__TASK_TIMER ((RtosSignalSet) UINT8_C(8))
+#define RTOS_SIGNAL_ID__TASK_TIMER ((RtosSignalId) RTOS_SIGNAL_SET__TASK_TIMER)
+#define RTOS_SIGNAL_SET__WORK ((RtosSignalSet) UINT8_C(16))
+#define RTOS_SIGNAL_ID__WORK ((RtosSignalId) RTOS_SIGNAL_SET__WORK)
+
+#define RTOS_TIMER_ID__TASK_A ((RtosTimerId) UINT8_C(0))
+#define RTOS_TIMER_ID__TASK_B ((RtosTimerId) UINT8_C(1))
+
+#define RTOS_PERIODIC_STATS_INIT \
+    { 0, 0, 0, 0, UINT16_MAX, 0, UINT16_MAX, 0 }
+#define RTOS_TIMEBASE_TICK_CYCLES UINT32_C(80000)
+
+#define RTOS_INTERRUPT_EVENT_ID_TICK ((RtosInterruptEventId) UINT8_C(0))
+#define RTOS_INTERRUPT_EVENT_ID__WORK_DEFERRED_B ((RtosInterruptEventId) UINT8_C(1))
+
+#define RTOS_MUTEX_ID_ZERO ((RtosMutexId) UINT8_C(0))
+#define RTOS_MUTEX_ID_MAX ((RtosMutexId) UINT8_C(1 - 1))
+#define RTOS_MUTEX_ID_M0 ((RtosMutexId) UINT8_C(0))
+#define RTOS_COND_ID_ZERO ((RtosCondId) UINT8_C(0))
+#define RTOS_COND_ID_MAX ((RtosCondId) UINT8_C(1 - 1))
+#define RTOS_COND_ID_C0 ((RtosCondId) UINT8_C(0))
+#define RTOS_SEM_ID_ZERO ((RtosSemId) UINT8_C(0))
+#define RTOS_SEM_ID_MAX ((RtosSemId) UINT8_C(1 - 1))
+#define RTOS_SEM_ID_SEM0 ((RtosSemId) UINT8_C(0))
+#define RTOS_POOL_ID_BUFFERS ((RtosPoolId) UINT8_C(0))
+#define RTOS_WORK_QUEUE_ID_DEFERRED ((RtosWorkQueueId) UINT8_C(0))
+
+#define RTOS_TASK_ID_ZERO ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_MAX ((RtosTaskId)UINT8_C(2 - 1))
+#define RTOS_TASK_ID_A ((RtosTaskId) UINT8_C(0))
+#define RTOS_TASK_ID_B ((RtosTaskId) UINT8_C(1))
+
+
+
+
+
+#define rtos_signal_wait(requested_signal) \
+    (void) rtos_signal_wait_set(requested_signal)
+
+#define rtos_signal_poll(requested_signal) \
+    (rtos_signal_poll_set(requested_signal) != RTOS_SIGNAL_SET_EMPTY)
+
+#define rtos_signal_peek(requested_signal) \
+    (rtos_signal_peek_set(requested_signal) != RTOS_SIGNAL_SET_EMPTY)
+
+#define rtos_signal_send(task_id, signal) \
+    rtos_signal_send_set(task_id, signal)
+#define rtos_timer_tick()
+
+
+#define rtos_interrupt_event_raise(event)
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+extern RtosTicksAbsolute rtos_timer_current_ticks;
+extern RtosPeriodicStats rtos_periodic_stats[1];
+
+
+
+
+
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+
+RtosSignalSet rtos_signal_wait_set(RtosSignalSet requested_signals) RTOS_REENTRANT;
+RtosSignalSet rtos_signal_poll_set(RtosSignalSet requested_signals);
+RtosSignalSet rtos_signal_peek_set(RtosSignalSet requested_signals);
+void rtos_signal_send_set(RtosTaskId task_id, RtosSignalSet signals);
+
+void rtos_sleep(RtosTicksRelative ticks) RTOS_REENTRANT;
+void rtos_timer_enable(RtosTimerId timer_id);
+void rtos_timer_disable(RtosTimerId timer_id);
+void rtos_timer_oneshot(RtosTimerId timer_id, RtosTicksRelative timeout);
+bool rtos_timer_check_overflow(RtosTimerId timer_id);
+RtosTicksRelative rtos_timer_remaining(RtosTimerId timer_id);
+void rtos_timer_reload_set(RtosTimerId timer_id, RtosTicksRelative reload);
+void rtos_timer_error_set(RtosTimerId timer_id, RtosErrorId error_id);
+void rtos_timer_signal_set(RtosTimerId timer_id, RtosTaskId task_id, RtosSignalSet signal_set);
+void rtos_periodic_wait_next(void) RTOS_REENTRANT;
+void rtos_periodic_stats_clear(void);
+uint32_t rtos_timebase_tick(void);
+uint32_t rtos_timebase_cycles(void);
+void rtos_timebase_now(RtosNetworkTime *time);
+void rtos_timebase_from_cycles(uint32_t cycles, RtosNetworkTime *time);
+void rtos_timebase_set(const RtosNetworkTime *time);
+void rtos_timebase_adjust(int32_t ppb);
+void rtos_timer_oneshot_at(RtosTimerId timer_id, const RtosNetworkTime *time);
+void rtos_sleep_until(const RtosNetworkTime *time) RTOS_REENTRANT;
+
+
+
+void rtos_mutex_lock(RtosMutexId) RTOS_REENTRANT;
+bool rtos_mutex_lock_timeout(RtosMutexId, RtosTicksRelative) RTOS_REENTRANT;
+bool rtos_mutex_try_lock(RtosMutexId);
+void rtos_mutex_unlock(RtosMutexId);
+bool rtos_mutex_holder_is_current(RtosMutexId);
+void rtos_cond_wait(RtosCondId cond, RtosMutexId m) RTOS_REENTRANT;
+bool rtos_cond_wait_timeout(RtosCondId cond, RtosMutexId m,
+                                    RtosTicksRelative timeout) RTOS_REENTRANT;
+void rtos_cond_signal(RtosCondId cond);
+void rtos_cond_broadcast(RtosCondId cond);
+void rtos_sem_post(RtosSemId);
+bool rtos_sem_try_wait(RtosSemId);
+void rtos_sem_wait(RtosSemId) RTOS_REENTRANT;
+bool rtos_sem_wait_timeout(RtosSemId, RtosTicksRelative timeout)
+        RTOS_REENTRANT;
+void *rtos_pool_alloc(RtosPoolId pool);
+void *rtos_pool_alloc_wait(RtosPoolId pool) RTOS_REENTRANT;
+void *rtos_pool_alloc_timeout(RtosPoolId pool, RtosTicksRelative timeout)
+        RTOS_REENTRANT;
+void rtos_pool_free(RtosPoolId pool, void *block);
+void rtos_pool_free_from_interrupt(RtosPoolId pool, void *block);
+uint16_t rtos_pool_high_water_mark(RtosPoolId pool);
+bool rtos_work_queue_submit(RtosWorkQueueId work_queue, RtosWorkFunction function,
+                                    void *context);
+bool rtos_work_queue_submit_from_interrupt(RtosWorkQueueId work_queue,
+                                                   RtosWorkFunction function, void *context);
+void rtos_work_queue_worker(RtosWorkQueueId work_queue) RTOS_REENTRANT;
+
+RtosTaskId rtos_task_current(void);
+void rtos_start(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_KOCHAB_H */
\ No newline at end of file
@@ -0,0 +1,1583 @@
+
+
+#include <stdint.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <stdbool.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdbool.h>
+
+
+#include <stdint.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "rtos-rigel.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+
+
+
+#define SCHED_WORDS (((4 - 1U) / 32U) + 1U)
+
+
+#define TIMER_ID_ZERO ((RtosTimerId) UINT8_C(0))
+#define TIMER_ID_MAX ((RtosTimerId) UINT8_C(6 - 1U))
+#define TIMER_WORDS 1U
+
+
+
+#define MUTEX_ID_NONE ((MutexIdOption) UINT8_MAX)
+
+#define MESSAGE_QUEUE_ID_NONE ((MessageQueueIdOption)UINT8_C(255))
+
+#define ERROR_ID_NONE ((RtosErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW ((RtosErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID ((RtosErrorId) UINT8_C(2))
+#define ERROR_ID_NOT_HOLDING_MUTEX ((RtosErrorId) UINT8_C(3))
+#define ERROR_ID_DEADLOCK ((RtosErrorId) UINT8_C(4))
+#define ERROR_ID_TASK_FUNCTION_RETURNS ((RtosErrorId) UINT8_C(5))
+#define ERROR_ID_INTERNAL_CURRENT_TASK_INVALID ((RtosErrorId) UINT8_C(6))
+#define ERROR_ID_INTERNAL_INVALID_ID ((RtosErrorId) UINT8_C(7))
+#define ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP ((RtosErrorId) UINT8_C(8))
+#define ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(9))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_ZERO_TIMEOUT ((RtosErrorId) UINT8_C(10))
+#define ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER ((RtosErrorId) UINT8_C(11))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW ((RtosErrorId) UINT8_C(12))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION ((RtosErrorId) UINT8_C(13))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_CONFIGURATION ((RtosErrorId) UINT8_C(14))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_HEAD ((RtosErrorId) UINT8_C(15))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE ((RtosErrorId) UINT8_C(16))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_ID_IN_WAITERS ((RtosErrorId) UINT8_C(17))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TASKS_BLOCKED_DESPITE_AVAILABLE_MESSAGES ((RtosErrorId) UINT8_C(18))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_WAITING_TASK_IS_NOT_BLOCKED ((RtosErrorId) UINT8_C(19))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGES_POINTER ((RtosErrorId) UINT8_C(20))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGE_SIZE ((RtosErrorId) UINT8_C(21))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH ((RtosErrorId) UINT8_C(22))
+#define ERROR_ID_INTERNAL_PRECONDITION_VIOLATED ((RtosErrorId) UINT8_C(23))
+#define ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED ((RtosErrorId) UINT8_C(24))
+#define ERROR_ID_SEMAPHORE_MAX_INVALID ((RtosErrorId) UINT8_C(25))
+#define ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT ((RtosErrorId) UINT8_C(26))
+#define ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT ((RtosErrorId) UINT8_C(27))
+#define ERROR_ID_SEMAPHORE_MAX_EXCEEDED ((RtosErrorId) UINT8_C(28))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED ((RtosErrorId) UINT8_C(29))
+#define ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX ((RtosErrorId) UINT8_C(30))
+#define ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED ((RtosErrorId) UINT8_C(31))
+#define ERROR_ID_SCHED_EDF_TASK_NOT_PERIODIC ((RtosErrorId) UINT8_C(32))
+#define ERROR_ID_TIMER_TASK_NOT_PERIODIC ((RtosErrorId) UINT8_C(33))
+#define ERROR_ID_POOL_INVALID_BLOCK ((RtosErrorId) UINT8_C(34))
+#define ERROR_ID_BROADCAST_NOT_SUBSCRIBED ((RtosErrorId) UINT8_C(35))
+#define ERROR_ID_BROADCAST_INVALID_POINTER ((RtosErrorId) UINT8_C(36))
+#define ERROR_ID_WORK_QUEUE_INVALID_FUNCTION ((RtosErrorId) UINT8_C(37))
+#define ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS ((RtosErrorId) UINT8_C(38))
+#define ERROR_ID_TIMEBASE_TIME_TOO_FAR ((RtosErrorId) UINT8_C(39))
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+#define current_task rtos_internal_current_task
+#define tasks rtos_internal_tasks
+
+typedef int context_t;
+typedef RtosTaskId SchedIndex;
+typedef uint32_t SchedWord;
+typedef uint16_t TicksTimeout;
+typedef uint32_t TimerWord;
+typedef uint8_t PeriodicIndex;
+typedef RtosMutexId MutexIdOption;
+typedef uint8_t MessageQueueIdOption;
+typedef uint8_t BroadcastSubscriptionIndex;
+typedef RtosTaskId TaskIdOption;
+
+
+
+
+struct sched {
+    SchedIndex cur; /* The index of the currently scheduled task */
+    SchedWord runnable[SCHED_WORDS]; /* A bitmap of the runnable tasks, 32 tasks per word */
+};
+struct signal_task {
+    RtosSignalSet signals;
+};
+
+struct signal {
+    struct signal_task tasks[4];
+};
+
+
+
+struct interrupt_event_handler {
+    RtosTaskId task;
+    RtosSignalSet sig_set;
+};
+
+struct mutex {
+    TaskIdOption holder;
+};
+struct mutex_stat {
+    uint32_t mutex_lock_counter;
+    uint32_t mutex_lock_contended_counter;
+    RtosTicksRelative mutex_lock_max_wait_time;
+};
+
+/* representation of a message queue instance
+ * sorted by size of fields */
+struct message_queue
+{
+    /* pointer to the array holding the message data
+     * the array contains message_size * queue_length bytes */
+    uint8_t *messages;
+    /* size of each message in bytes */
+    const uint8_t message_size;
+    /* maximum number of messages this queue can hold */
+    const uint8_t queue_length;
+    /* index of the oldest message that has been put into the queue but not yet been retrieved
+     * 0 <= head < queue_length */
+    uint8_t head;
+    /* number of messages that have been put into the queue but not yet been retrieved
+     * 0 <= available < queue_length */
+    uint8_t available;
+};
+/* representation of a broadcast channel instance */
+struct broadcast
+{
+    /* pointer to the array holding the record data
+     * the array contains record_size * length bytes */
+    uint8_t *records;
+    /* size of each record in bytes */
+    uint16_t record_size;
+    /* number of records the channel retains for its subscribers */
+    uint8_t length;
+    /* index of the slot the next record is published into
+     * 0 <= head < length */
+    uint8_t head;
+    /* sequence number of the next record to be published */
+    uint32_t published;
+    /* range of the subscriptions of the channel in the broadcast_subscriptions array */
+    BroadcastSubscriptionIndex first_subscription;
+    BroadcastSubscriptionIndex subscription_count;
+    /* signal set sent to all subscribers when a record is published */
+    RtosSignalSet sig_set;
+};
+
+/* the per-subscriber state of a broadcast channel */
+struct broadcast_subscription
+{
+    RtosTaskId task;
+    /* sequence number of the next record the subscriber retrieves */
+    uint32_t cursor;
+    /* number of records that were overwritten before the subscriber retrieved them */
+    uint32_t lost;
+};
+
+struct task
+{
+    context_t ctx;
+};
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+extern void fatal(RtosErrorId error_id);
+extern void fn_a(void);
+extern void fn_b(void);
+extern void fn_c(void);
+extern void fn_d(void);
+
+
+
+static void context_switch(context_t *from, context_t *to);
+
+static void sched_set_runnable(const RtosTaskId task_id);
+static void sched_set_blocked(const RtosTaskId task_id);
+static TaskIdOption sched_get_next(void);
+static RtosSignalSet signal_recv(RtosSignalSet *pending_signals, RtosSignalSet requested_signals);
+static void signal_send_set(RtosTaskId task_id, RtosSignalSet signals);
+static RtosSignalSet signal_wait_set(RtosSignalSet requested_signals) RTOS_REENTRANT;
+
+
+static void timer_process_one(RtosTimerId timer_id);
+static void timer_enable(RtosTimerId timer_id);
+static void timer_oneshot(RtosTimerId timer_id, RtosTicksRelative timeout);
+static void timer_tick_process(void);
+static void interrupt_event_process(void);
+RtosTaskId rtos_internal_interrupt_event_get_next(void);
+static void interrupt_event_handle(RtosInterruptEventId interrupt_event_id);
+static bool mutex_try_lock(RtosMutexId m);
+static bool mutex_acquire(RtosMutexId m) RTOS_REENTRANT;
+static void mutex_release(RtosMutexId m);
+
+
+static struct broadcast_subscription *broadcast_subscription_get(RtosBroadcastId broadcast);
+static void broadcast_copy(uint8_t *dst, const uint8_t *src, uint16_t length);
+
+static RtosTaskId get_current_task_check(void);
+static void yield_to(RtosTaskId to) RTOS_REENTRANT;
+static void block(void) RTOS_REENTRANT;
+static void unblock(RtosTaskId task);
+static void stack_group_entry(void);
+
+
+void (*entry_point_ptr)(void);
+
+static struct sched sched_tasks;
+static struct signal signal_tasks;
+
+RtosTicksAbsolute rtos_timer_current_ticks;
+/*
+ * The state of the timers is laid out as one array per field, indexed by timer ID.
+ * The enabled and overflow flags are packed into bitmaps of 32 timers per word, so that tick processing only visits
+ * the enabled timers.
+ */
+static TimerWord timers_enabled[TIMER_WORDS] = {
+    UINT32_C(0x1),
+};
+static TimerWord timers_overflow[TIMER_WORDS];
+static TicksTimeout timer_expiries[6] = {
+    10,
+    0,
+    0,
+    0,
+    0,
+    0,
+};
+static RtosTicksRelative timer_reloads[6] = {
+    10,
+    10,
+    0,
+    0,
+    0,
+    0,
+};
+/* When the error ID of a timer is not ERROR_ID_NONE, the timer calls the application error function with it */
+static RtosErrorId timer_error_ids[6] = {
+    0,
+    2,
+    0,
+    0,
+    0,
+    0,
+};
+static RtosTaskId timer_task_ids[6] = {
+    RTOS_TASK_ID_A,
+    TASK_ID_NONE,
+    RTOS_TASK_ID_A,
+    RTOS_TASK_ID_B,
+    RTOS_TASK_ID_C,
+    RTOS_TASK_ID_D,
+};
+static RtosSignalSet timer_signal_sets[6] = {
+    RTOS_SIGNAL_SET_TIMER,
+    RTOS_SIGNAL_SET_EMPTY,
+    RTOS_SIGNAL_SET__TASK_TIMER,
+    RTOS_SIGNAL_SET__TASK_TIMER,
+    RTOS_SIGNAL_SET__TASK_TIMER,
+    RTOS_SIGNAL_SET__TASK_TIMER,
+};
+
+static bool system_is_idle;
+struct interrupt_event_handler interrupt_events[1] = {
+    { RTOS_TASK_ID_A, RTOS_SIGNAL_SET_TEST },
+};
+static struct mutex mutexes[1] = {
+    {TASK_ID_NONE},
+};
+static MutexIdOption mutex_waiters[4] = {
+    MUTEX_ID_NONE,
+    MUTEX_ID_NONE,
+    MUTEX_ID_NONE,
+    MUTEX_ID_NONE,
+};
+bool rtos_mutex_stats_enabled;
+static struct mutex_stat mutex_stats[1];
+
+static uint32_t profiling_task_uptimes[4 + 1];
+
+static uint8_t message_queue_test_messages[2][2];
+static struct message_queue message_queues[] =
+{
+    {
+        (uint8_t*)message_queue_test_messages,
+        2,
+        2,
+        0,
+        0,
+    },
+};
+static MessageQueueIdOption message_queue_waiters[] =
+{
+    MESSAGE_QUEUE_ID_NONE,
+    MESSAGE_QUEUE_ID_NONE,
+    MESSAGE_QUEUE_ID_NONE,
+    MESSAGE_QUEUE_ID_NONE,
+};
+
+static uint8_t broadcast_test_records[4][4];
+static struct broadcast broadcasts[1] =
+{
+    {
+        (uint8_t*)broadcast_test_records,
+        4,
+        4,
+        0,
+        0,
+        0,
+        2,
+        RTOS_SIGNAL_SET_TIMER
+    },
+};
+static struct broadcast_subscription broadcast_subscriptions[2] =
+{
+    { RTOS_TASK_ID_A, 0, 0 },
+    { RTOS_TASK_ID_B, 0, 0 },
+};
+
+
+RtosTaskId rtos_internal_current_task;
+struct task rtos_internal_tasks[4];
+static RtosTimerId task_timers[4] = {
+    RTOS_TIMER_ID__TASK_A,
+    RTOS_TIMER_ID__TASK_B,
+    RTOS_TIMER_ID__TASK_C,
+    RTOS_TIMER_ID__TASK_D,
+};
+
+/* The tasks of a stack group share the stack and the execution context of the first task of the group */
+static const RtosTaskId task_context_owners[4] = {
+    0,
+    1,
+    2,
+    2,
+};
+
+static void (*const task_functions[4])(void) = {
+    fn_a,
+    fn_b,
+    fn_c,
+    fn_d,
+};
+
+/* Whether the current task is a run-to-completion task that is executing its task function */
+static bool run_to_completion;
+
+
+#define context_init(ctx, fn, stack_base, stack_size) (entry_point_ptr = fn)
+#define context_switch_first(to)
+#define preempt_disable()
+#define preempt_enable()
+#define preempt_clear()
+#define precondition_preemption_disabled()
+#define postcondition_preemption_disabled()
+#define sched_runnable(task_id) ((SCHED_WORD(task_id) & SCHED_BIT(task_id)) != 0)
+#define sched_next_index(cur) (((cur) == sched_max_index()) ? 0 : ((cur) + 1))
+#define sched_get_cur_index() (sched_tasks.cur)
+#define sched_set_cur_index(idx) sched_tasks.cur = (idx)
+#define sched_max_index() (SchedIndex)(4 - 1U)
+#define sched_index_to_taskid(sched_index) (RtosTaskId)(sched_index)
+#define SCHED_WORD(task_id) sched_tasks.runnable[(task_id) / 32U]
+#define SCHED_BIT(task_id) ((SchedWord) 1U << ((task_id) % 32U))
+
+#define signal_wait(requested_signals) signal_wait_set(requested_signals)
+#define signal_peek(pending_signals, requested_signals) (((pending_signals) & (requested_signals)) != RTOS_SIGNAL_SET_EMPTY)
+#define signal_pending(task_id, mask) ((PENDING_SIGNALS(task_id) & mask) == mask)
+#define PENDING_SIGNALS(task_id) signal_tasks.tasks[task_id].signals
+#define timer_pending_ticks_get_and_clear_atomically() 0
+#define timer_pending_ticks_check() (false)
+#define TIMER_WORD(timer_id) ((timer_id) / 32U)
+#define TIMER_BIT(timer_id) ((TimerWord) 1U << ((timer_id) % 32U))
+#define timer_is_enabled(timer_id) ((timers_enabled[TIMER_WORD(timer_id)] & TIMER_BIT(timer_id)) != 0)
+#define timer_is_periodic(timer_id) (timer_reloads[timer_id] > 0)
+#define timer_reload_set(timer_id, ticks) timer_reloads[timer_id] = ticks
+#define timer_disable(timer_id) timers_enabled[TIMER_WORD(timer_id)] &= ~TIMER_BIT(timer_id)
+#define current_timeout() ((TicksTimeout) rtos_timer_current_ticks)
+#define assert_timer_valid(timer) api_assert(timer_id < 6, ERROR_ID_INVALID_ID)
+#define interrupt_application_event_check()
+#define interrupt_event_wait()
+#define interrupt_event_check() (interrupt_application_event_check() || interrupt_system_event_check())
+#define interrupt_system_event_check() timer_pending_ticks_check()
+#define interrupt_event_get_next() rtos_internal_interrupt_event_get_next()
+
+#define assert_mutex_valid(mutex) api_assert(mutex < 1, ERROR_ID_INVALID_ID)
+
+#define message_queue_api_assert_valid(message_queue) api_assert(message_queue < 1,\
+                                                                 ERROR_ID_INVALID_ID)
+#define message_queue_internal_assert_valid(message_queue) internal_assert(message_queue < 1,\
+                                                                           ERROR_ID_INVALID_ID)
+
+#define broadcast_api_assert_valid(broadcast) api_assert(broadcast < 1, ERROR_ID_INVALID_ID)
+
+#define api_error(error_id) fatal(error_id)
+#define api_assert(expression, error_id) do { if (!(expression)) { api_error(error_id); } } while(0)
+
+#define internal_error(error_id) fatal(error_id)
+#define internal_assert(expression, error_id) do { if (!(expression)) { internal_error(error_id); } } while(0)
+#define get_current_task() get_current_task_check()
+#define get_task_context(task_id) &tasks[task_id].ctx
+#define internal_assert_task_valid(task) internal_assert(task < 4, ERROR_ID_INTERNAL_INVALID_ID)
+#define assert_task_valid(task) api_assert(task < 4, ERROR_ID_INVALID_ID)
+#define yield() rtos_yield()
+#define task_context(task_id) get_task_context(task_context_owners[task_id])
+#define interrupt_event_id_to_taskid(interrupt_event_id) ((RtosTaskId)(interrupt_event_id))
+#define mutex_core_block_on(unused_task) rtos_signal_wait(RTOS_SIGNAL_ID__TASK_TIMER)
+#define mutex_core_unblock(task) rtos_signal_send(task, RTOS_SIGNAL_ID__TASK_TIMER)
+#define message_queue_core_block() rtos_signal_wait(RTOS_SIGNAL_ID__TASK_TIMER)
+/* sleep() may return before the timeout occurs because another task may send the timeout signal to indicate that the
+ * state of the message queue has changed.
+ * Therefore, disable the timer whenever sleep() returns to make sure the timer is no longer active.
+ * Note that in the current message-queue implementation, this is not necessary for correctness.
+ * The message-queue implementation handles spurious timer signals gracefully.
+ * However, disabling the timer avoids confusion and provides a minor benefit in run-time efficiency. */
+#define message_queue_core_block_timeout(timeout)\
+do\
+{\
+    rtos_sleep((timeout));\
+    rtos_timer_disable(task_timers[get_current_task()]);\
+}\
+while (0)
+#define message_queue_core_unblock(task) rtos_signal_send((task), RTOS_SIGNAL_ID__TASK_TIMER)
+#define message_queue_core_is_unblocked(task) sched_runnable((task))
+
+
+static void
+context_switch(context_t *from, context_t *to)
+{
+    from = from;
+    to = to;
+}
+
+static void
+sched_set_runnable(const RtosTaskId task_id)
+{
+    SCHED_WORD(task_id) |= SCHED_BIT(task_id);
+}
+
+static void
+sched_set_blocked(const RtosTaskId task_id)
+{
+    SCHED_WORD(task_id) &= ~SCHED_BIT(task_id);
+}
+
+static RAMFUNC TaskIdOption
+sched_get_next(void)
+{
+    TaskIdOption task;
+    SchedIndex next = sched_get_cur_index();
+    bool found = false;
+
+    /* loop bound: 4 */
+    do
+    {
+        next = sched_next_index(next);
+        found = sched_runnable(sched_index_to_taskid(next));
+    } while (
+        (!found)
+        && (next != (sched_get_cur_index()))
+        );
+
+    if (found)
+    {
+        task = sched_index_to_taskid(next);
+    }
+    else
+    {
+        next = sched_max_index();
+        task = TASK_ID_NONE;
+    }
+
+    sched_set_cur_index(next);
+
+    return task;
+}
+static RtosSignalSet
+signal_recv(RtosSignalSet *const pending_signals, const RtosSignalSet requested_signals)
+{
+    const RtosSignalSet received_signals = *pending_signals & requested_signals;
+
+    precondition_preemption_disabled();
+
+    *pending_signals &= ~received_signals;
+
+    postcondition_preemption_disabled();
+
+    return received_signals;
+}
+
+static RAMFUNC void
+signal_send_set(const RtosTaskId task_id, const RtosSignalSet signals)
+{
+    precondition_preemption_disabled();
+
+    PENDING_SIGNALS(task_id) |= signals;
+    unblock(task_id);
+
+    postcondition_preemption_disabled();
+}
+
+static RtosSignalSet
+signal_wait_set(const RtosSignalSet requested_signals) RTOS_REENTRANT
+{
+    RtosSignalSet received_signals;
+
+    precondition_preemption_disabled();
+    {
+        RtosSignalSet *const pending_signals = &PENDING_SIGNALS(get_current_task());
+
+        if (signal_peek(*pending_signals, requested_signals))
+        {
+            yield();
+        }
+        else
+        {
+            do
+            {
+                block();
+            } while (!signal_peek(*pending_signals, requested_signals));
+        }
+
+        received_signals = signal_recv(pending_signals, requested_signals);
+    }
+    postcondition_preemption_disabled();
+
+    return received_signals;
+}
+
+static void
+timer_process_one(const RtosTimerId timer_id)
+{
+    precondition_preemption_disabled();
+
+    if (timer_is_periodic(timer_id))
+    {
+        timer_expiries[timer_id] += timer_reloads[timer_id];
+    }
+    else
+    {
+        timer_disable(timer_id);
+    }
+
+    if (timer_error_ids[timer_id] != ERROR_ID_NONE)
+    {
+        fatal(timer_error_ids[timer_id]);
+    }
+    else
+    {
+        if (signal_pending(timer_task_ids[timer_id], timer_signal_sets[timer_id]))
+        {
+            timers_overflow[TIMER_WORD(timer_id)] |= TIMER_BIT(timer_id);
+        }
+        signal_send_set(timer_task_ids[timer_id], timer_signal_sets[timer_id]);
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_enable(const RtosTimerId timer_id)
+{
+    precondition_preemption_disabled();
+
+    if (timer_reloads[timer_id] == 0)
+    {
+        timer_process_one(timer_id);
+    }
+    else
+    {
+        timer_expiries[timer_id] = current_timeout() + timer_reloads[timer_id];
+        timers_enabled[TIMER_WORD(timer_id)] |= TIMER_BIT(timer_id);
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_oneshot(const RtosTimerId timer_id, const RtosTicksRelative timeout)
+{
+    precondition_preemption_disabled();
+
+    timer_reload_set(timer_id, timeout);
+    timer_enable(timer_id);
+    timer_reload_set(timer_id, 0);
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_tick_process(void)
+{
+    precondition_preemption_disabled();
+    {
+        const uint8_t pending_ticks = timer_pending_ticks_get_and_clear_atomically();
+
+        if (pending_ticks > 1)
+        {
+            fatal(ERROR_ID_TICK_OVERFLOW);
+        }
+
+        if (pending_ticks)
+        {
+            RtosTimerId word, timer_id;
+            TimerWord enabled;
+            TicksTimeout timeout;
+
+            rtos_timer_current_ticks++;
+
+            timeout = current_timeout();
+
+            /* loop bound: 1 */
+            for (word = 0; word < TIMER_WORDS; word++)
+            {
+                /* Visit the enabled timers of the word, up to the last one */
+                enabled = timers_enabled[word];
+                /* loop bound: 32 */
+                for (timer_id = (RtosTimerId) (word * 32U); enabled != 0; timer_id++, enabled >>= 1)
+                {
+                    if ((enabled & 1U) != 0 && timer_expiries[timer_id] == timeout)
+                    {
+                        timer_process_one(timer_id);
+                    }
+                }
+            }
+        }
+    }
+    postcondition_preemption_disabled();
+}
+static void
+interrupt_event_process(void)
+{
+    interrupt_event_handle(0);
+}
+RAMFUNC RtosTaskId
+rtos_internal_interrupt_event_get_next(void)
+{
+    TaskIdOption next;
+
+    /* loop bound: 4 + 1 */
+    for (;;)
+    {
+        interrupt_event_process();
+        timer_tick_process();
+        next = sched_get_next();
+
+        if (next == TASK_ID_NONE)
+        {
+            system_is_idle = true;
+            interrupt_event_wait();
+        }
+        else
+        {
+            system_is_idle = false;
+            break;
+        }
+    }
+
+    internal_assert_task_valid(next);
+
+    return next;
+}
+static RAMFUNC void
+interrupt_event_handle(const RtosInterruptEventId interrupt_event_id)
+{
+    precondition_preemption_disabled();
+
+    internal_assert(interrupt_event_id < 1, ERROR_ID_INTERNAL_INVALID_ID);
+
+#ifdef PREEMPTION_SUPPORT
+    signal_send_set(interrupt_events[interrupt_event_id].task, interrupt_events[interrupt_event_id].sig_set);
+#else
+    rtos_signal_send_set(interrupt_events[interrupt_event_id].task,
+            interrupt_events[interrupt_event_id].sig_set);
+#endif
+
+    postcondition_preemption_disabled();
+}
+static bool
+mutex_try_lock(const RtosMutexId m)
+{
+    const bool r = mutexes[m].holder == TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    if (r)
+    {
+        mutexes[m].holder = get_current_task();
+    }
+
+    postcondition_preemption_disabled();
+
+    return r;
+}
+
+/*
+ * Lock the mutex, blocking the current task while another task holds it.
+ * Returns whether the mutex was contended.
+ */
+static bool
+mutex_acquire(const RtosMutexId m) RTOS_REENTRANT
+{
+    bool contended = false;
+
+    precondition_preemption_disabled();
+
+    while (!mutex_try_lock(m))
+    {
+        contended = true;
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on(mutexes[m].holder);
+    }
+
+    postcondition_preemption_disabled();
+
+    return contended;
+}
+
+static void
+mutex_release(const RtosMutexId m)
+{
+    RtosTaskId t;
+
+    precondition_preemption_disabled();
+
+
+    /* loop bound: 4 */
+    for (t = RTOS_TASK_ID_ZERO; t <= RTOS_TASK_ID_MAX; t++)
+    {
+        if (mutex_waiters[t] == m)
+        {
+            mutex_waiters[t] = MUTEX_ID_NONE;
+            mutex_core_unblock(t);
+        }
+    }
+
+    mutexes[m].holder = TASK_ID_NONE;
+
+    postcondition_preemption_disabled();
+}
+
+static void
+mutex_stats_update(const RtosMutexId m, const bool contended, const RtosTicksAbsolute
+        wait_start_ticks)
+{
+    if (rtos_mutex_stats_enabled) {
+        mutex_stats[m].mutex_lock_counter += 1;
+        if (contended) {
+            RtosTicksRelative wait_time = rtos_timer_current_ticks - wait_start_ticks;
+
+            mutex_stats[m].mutex_lock_contended_counter += 1;
+            if (wait_time > mutex_stats[m].mutex_lock_max_wait_time)
+            {
+                mutex_stats[m].mutex_lock_max_wait_time = wait_time;
+            }
+        }
+    }
+}
+
+static void
+message_queue_init(void)
+{
+    RtosMessageQueueId message_queue = 1 - 1;
+    RtosTaskId task;
+
+    /* do not use for loop to work around buggy compiler optimization when there is only one message queue */
+    do
+    {
+        struct message_queue *mq = &message_queues[message_queue];
+
+        internal_assert(mq->messages &&
+                        mq->message_size &&
+                        mq->queue_length &&
+                        !mq->head &&
+                        !mq->available, ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION);
+    } while (message_queue--);
+
+    for (task = 0; task <= RTOS_TASK_ID_MAX; task += 1)
+    {
+        internal_assert(message_queue_waiters[task] == MESSAGE_QUEUE_ID_NONE,\
+                        ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION);
+    }
+}
+
+static void
+message_queue_invariants_check(void)
+{
+    RtosMessageQueueId message_queue;
+    RtosTaskId task;
+
+    internal_assert(message_queues[0].messages == (uint8_t*)message_queue_test_messages,
+                    ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGES_POINTER);
+    internal_assert(message_queues[0].message_size == 2,
+                    ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGE_SIZE);
+    internal_assert(message_queues[0].queue_length == 2,
+                    ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH);
+
+    /* loop bound: 1 */
+    for (message_queue = 0; message_queue < 1; message_queue += 1)
+    {
+        const struct message_queue *const mq = &message_queues[message_queue];
+
+        internal_assert(mq->messages && mq->message_size && mq->queue_length,
+                        ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_CONFIGURATION);
+        internal_assert(mq->head < mq->queue_length, ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_HEAD);
+        internal_assert(mq->available <= mq->queue_length,
+                        ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE);
+    }
+
+    /* loop bound: 4 */
+    for (task = 0; task <= RTOS_TASK_ID_MAX; task += 1)
+    {
+        message_queue = message_queue_waiters[task];
+
+        internal_assert((message_queue < 1) || (message_queue == MESSAGE_QUEUE_ID_NONE),\
+                        ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_ID_IN_WAITERS);
+
+        if (message_queue != MESSAGE_QUEUE_ID_NONE)
+        {
+            const struct message_queue *const mq = &message_queues[message_queue];
+
+            internal_assert((mq->available == 0) || (mq->available == mq->queue_length),\
+                ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TASKS_BLOCKED_DESPITE_AVAILABLE_MESSAGES);
+            internal_assert(!message_queue_core_is_unblocked(task),\
+                            ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_WAITING_TASK_IS_NOT_BLOCKED);
+        }
+    }
+
+    /* The timer of the current task is expected to be disabled.
+     * It is expected to be only enabled while the current task is blocked in message_queue_wait_timeout().
+     * Unfortunately, we cannot make any assumptions about the relationship between the states of message queues and
+     * other timers.
+     * The timers of tasks depends not only on the message queue implementation but also on how other components use
+     * those task timers. */
+    internal_assert(!timer_is_enabled(task_timers[get_current_task()]),\
+                    ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED);
+}
+
+static void
+message_queue_waiters_wakeup(const RtosMessageQueueId message_queue)
+{
+    RtosTaskId task;
+
+    message_queue_internal_assert_valid(message_queue);
+
+    /* loop bound: 4 */
+    for (task = RTOS_TASK_ID_ZERO; task <= RTOS_TASK_ID_MAX; task += 1)
+    {
+        if (message_queue_waiters[task] == message_queue)
+        {
+            message_queue_core_unblock(task);
+            message_queue_waiters[task] = MESSAGE_QUEUE_ID_NONE;
+        }
+    }
+}
+
+static void
+message_queue_wait(const RtosMessageQueueId message_queue) RTOS_REENTRANT
+{
+    message_queue_internal_assert_valid(message_queue);
+    message_queue_invariants_check();
+
+    message_queue_waiters[get_current_task()] = message_queue;
+    message_queue_core_block();
+
+    message_queue_invariants_check();
+}
+
+static void
+message_queue_wait_timeout(const RtosMessageQueueId message_queue,
+                           const RtosTicksRelative timeout) RTOS_REENTRANT
+{
+    message_queue_internal_assert_valid(message_queue);
+    internal_assert(timeout, ERROR_ID_MESSAGE_QUEUE_INTERNAL_ZERO_TIMEOUT);
+    message_queue_invariants_check();
+
+    message_queue_waiters[get_current_task()] = message_queue;
+    message_queue_core_block_timeout(timeout);
+    message_queue_waiters[get_current_task()] = MESSAGE_QUEUE_ID_NONE;
+
+    message_queue_invariants_check();
+}
+
+/* assumptions: max length 255, no overlap of dst & src */
+/* called memcopy instead of memcpy to not conflict with gcc's built-in memcpy declaration on unit test targets */
+static void
+memcopy(uint8_t *dst, const uint8_t *src, const uint8_t length)
+{
+    uint8_t *const dst_end = dst + length;
+
+    api_assert((dst < src) || (dst >= (src + length)), ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP);
+
+    /* loop bound: 255 */
+    while (dst < dst_end)
+    {
+        *dst++ = *src++;
+    }
+}
+
+static struct broadcast_subscription *
+broadcast_subscription_get(const RtosBroadcastId broadcast)
+{
+    const struct broadcast *const b = &broadcasts[broadcast];
+    BroadcastSubscriptionIndex s;
+
+    /* loop bound: 2 */
+    for (s = b->first_subscription; s < b->first_subscription + b->subscription_count; s += 1)
+    {
+        if (broadcast_subscriptions[s].task == get_current_task())
+        {
+            return &broadcast_subscriptions[s];
+        }
+    }
+
+    api_error(ERROR_ID_BROADCAST_NOT_SUBSCRIBED);
+    return &broadcast_subscriptions[b->first_subscription];
+}
+
+/* called broadcast_copy instead of memcpy to not conflict with gcc's built-in memcpy declaration on unit test
+ * targets */
+static void
+broadcast_copy(uint8_t *dst, const uint8_t *src, const uint16_t length)
+{
+    uint8_t *const dst_end = dst + length;
+
+    /* loop bound: 65535 */
+    while (dst < dst_end)
+    {
+        *dst++ = *src++;
+    }
+}
+
+
+static RtosTaskId
+get_current_task_check(void)
+{
+    internal_assert(current_task < 4, ERROR_ID_INTERNAL_CURRENT_TASK_INVALID);
+    return current_task;
+}
+static void
+yield_to(const RtosTaskId to) RTOS_REENTRANT
+{
+    const RtosTaskId from = get_current_task();
+
+    internal_assert(to < 4, ERROR_ID_INTERNAL_INVALID_ID);
+
+    current_task = to;
+    context_switch(task_context(from), task_context(to));
+}
+
+static void
+block(void) RTOS_REENTRANT
+{
+    sched_set_blocked(get_current_task());
+    rtos_yield();
+}
+
+static RAMFUNC void
+unblock(const RtosTaskId task)
+{
+    sched_set_runnable(task);
+}
+
+/* entry point trampolines */
+static void
+entry_a(void)
+{
+    
+    fn_a();
+
+    api_error(ERROR_ID_TASK_FUNCTION_RETURNS);
+}
+
+static void
+entry_b(void)
+{
+    rtos_signal_wait(RTOS_SIGNAL_ID__RTOS_UTIL);
+    fn_b();
+
+    api_error(ERROR_ID_TASK_FUNCTION_RETURNS);
+}
+
+/* Entry point of the shared context of each stack group.
+ * Whichever task of the group the scheduler selects runs in this context.
+ * Each start signal it has received activates its task function once, which must run to completion without yielding
+ * or blocking.
+ * Therefore, the stack is empty again whenever the context switches to another task, so that all tasks of the group can
+ * share it. */
+static void
+stack_group_entry(void)
+{
+    for (;;)
+    {
+        const RtosTaskId task = get_current_task();
+
+        if (signal_recv(&PENDING_SIGNALS(task), RTOS_SIGNAL_SET__RTOS_UTIL) !=
+                RTOS_SIGNAL_SET_EMPTY)
+        {
+            run_to_completion = true;
+            task_functions[task]();
+            run_to_completion = false;
+        }
+        else
+        {
+            block();
+        }
+    }
+}
+
+
+
+
+
+
+RtosSignalSet
+rtos_signal_wait_set(const RtosSignalSet requested_signals) RTOS_REENTRANT
+{
+    RtosSignalSet received_signals;
+
+    preempt_disable();
+
+    received_signals = signal_wait_set(requested_signals);
+
+    preempt_enable();
+
+    return received_signals;
+}
+
+RtosSignalSet
+rtos_signal_poll_set(const RtosSignalSet requested_signals)
+{
+    RtosSignalSet *const pending_signals = &PENDING_SIGNALS(get_current_task());
+    RtosSignalSet received_signals;
+
+    preempt_disable();
+
+    received_signals = signal_recv(pending_signals, requested_signals);
+
+    preempt_enable();
+
+    return received_signals;
+}
+
+RtosSignalSet
+rtos_signal_peek_set(const RtosSignalSet requested_signals)
+{
+    const RtosSignalSet pending_signals = PENDING_SIGNALS(get_current_task());
+    return pending_signals & requested_signals;
+}
+
+RAMFUNC void
+rtos_signal_send_set(const RtosTaskId task_id, const RtosSignalSet signals)
+{
+    assert_task_valid(task_id);
+
+    preempt_disable();
+
+    signal_send_set(task_id, signals);
+
+    preempt_enable();
+}
+
+void
+rtos_sleep(const RtosTicksRelative ticks) RTOS_REENTRANT
+{
+    preempt_disable();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    signal_wait(RTOS_SIGNAL_ID__TASK_TIMER);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_enable(const RtosTimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_enable(timer_id);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_disable(const RtosTimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_disable(timer_id);
+
+    preempt_enable();
+}
+
+void
+rtos_timer_oneshot(const RtosTimerId timer_id, const RtosTicksRelative timeout)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_oneshot(timer_id, timeout);
+
+    preempt_enable();
+}
+
+bool
+rtos_timer_check_overflow(const RtosTimerId timer_id)
+{
+    bool r;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    r = (timers_overflow[TIMER_WORD(timer_id)] & TIMER_BIT(timer_id)) != 0;
+    timers_overflow[TIMER_WORD(timer_id)] &= ~TIMER_BIT(timer_id);
+
+    preempt_enable();
+
+    return r;
+}
+
+RtosTicksRelative
+rtos_timer_remaining(const RtosTimerId timer_id)
+{
+    RtosTicksRelative remaining;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    remaining = timer_is_enabled(timer_id) ? timer_expiries[timer_id] - current_timeout() : 0;
+
+    preempt_enable();
+
+    return remaining;
+}
+
+/* Configuration functions */
+void
+rtos_timer_reload_set(const RtosTimerId timer_id, const RtosTicksRelative reload)
+{
+    assert_timer_valid(timer_id);
+
+    timer_reload_set(timer_id, reload);
+}
+
+void
+rtos_timer_signal_set(const RtosTimerId timer_id, const RtosTaskId task_id, const RtosSignalSet signal_set)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_error_ids[timer_id] = ERROR_ID_NONE;
+    timer_task_ids[timer_id] = task_id;
+    timer_signal_sets[timer_id] = signal_set;
+
+    preempt_enable();
+}
+
+void
+rtos_timer_error_set(const RtosTimerId timer_id, const RtosErrorId error_id)
+{
+    assert_timer_valid(timer_id);
+
+    timer_error_ids[timer_id] = error_id;
+}
+
+
+void
+rtos_interrupt_event_task_set(const RtosInterruptEventId interrupt_event_id, const RtosTaskId task_id)
+{
+    api_assert(interrupt_event_id < 1, ERROR_ID_INVALID_ID);
+    api_assert(task_id < 4, ERROR_ID_INVALID_ID);
+    interrupt_events[interrupt_event_id].task = task_id;
+}
+
+void
+rtos_mutex_lock(const RtosMutexId m) RTOS_REENTRANT
+{
+    bool contended;
+    const RtosTicksAbsolute wait_start_ticks = rtos_timer_current_ticks;
+
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder != get_current_task(), ERROR_ID_DEADLOCK);
+
+    preempt_disable();
+
+    contended = mutex_acquire(m);
+
+    preempt_enable();
+
+    mutex_stats_update(m, contended, wait_start_ticks);
+}
+
+
+void
+rtos_mutex_unlock(const RtosMutexId m)
+{
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    mutex_release(m);
+
+    preempt_enable();
+}
+
+bool
+rtos_mutex_try_lock(const RtosMutexId m)
+{
+    bool r;
+
+    assert_mutex_valid(m);
+
+    preempt_disable();
+
+    r = mutex_try_lock(m);
+
+    preempt_enable();
+
+    return r;
+}
+
+/* A macro implementation would be preferable to eliminate function call overhead when compilers don't support implicit
+ * inlining, but at present this would involve exposing too many implementation internals in the public API header. */
+bool
+rtos_mutex_holder_is_current(const RtosMutexId m)
+{
+    assert_mutex_valid(m);
+    return mutexes[m].holder == get_current_task();
+}
+
+void rtos_mutex_stats_clear(void)
+{
+    /* memset would be preferable, but string.h is not available on all platforms */
+    uint8_t mutex_index;
+    /* loop bound: 1 */
+    for (mutex_index = 0; mutex_index < 1; mutex_index += 1)
+    {
+        mutex_stats[mutex_index].mutex_lock_counter = 0;
+        mutex_stats[mutex_index].mutex_lock_contended_counter = 0;
+        mutex_stats[mutex_index].mutex_lock_max_wait_time = 0;
+    }
+}
+
+/* MAINTENANCE:
+ * When modifying or extending the profiling component, ensure that its code is covered by at least one of the example
+ * systems to ensure it builds correctly.
+ */
+
+void
+rtos_profiling_record_sample(void)
+{
+    RtosTaskId idx;
+
+    if (!system_is_idle)
+    {
+        idx = get_current_task();
+    }
+    else
+    {
+        idx = 4;
+    }
+
+    profiling_task_uptimes[idx] += 1;
+}
+
+void
+rtos_message_queue_put(const RtosMessageQueueId message_queue, const void *const message)
+        RTOS_REENTRANT
+{
+    message_queue_api_assert_valid(message_queue);
+    api_assert(message, ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER);
+
+    while (!rtos_message_queue_try_put(message_queue, message))
+    {
+        message_queue_wait(message_queue);
+    }
+}
+
+bool
+rtos_message_queue_try_put(const RtosMessageQueueId message_queue, const void *message)
+{
+    message_queue_api_assert_valid(message_queue);
+    api_assert(message, ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER);
+    message_queue_invariants_check();
+
+    {
+        struct message_queue *const mq = &message_queues[message_queue];
+
+        if (mq->available == mq->queue_length)
+        {
+            return false;
+        }
+        else
+        {
+            const uint8_t buffer_index = (mq->head + mq->available) % mq->queue_length;
+            const uint16_t buffer_offset = buffer_index * mq->message_size;
+            memcopy(&mq->messages[buffer_offset], message, mq->message_size);
+            mq->available += 1;
+
+            if (mq->available == 1)
+            {
+                message_queue_waiters_wakeup(message_queue);
+            }
+
+            message_queue_invariants_check();
+            return true;
+        }
+    }
+}
+
+bool
+rtos_message_queue_put_timeout(const RtosMessageQueueId message_queue, const void *const message,
+                                         const RtosTicksRelative timeout) RTOS_REENTRANT
+{
+    const RtosTicksAbsolute absolute_timeout = rtos_timer_current_ticks + timeout;
+
+    message_queue_api_assert_valid(message_queue);
+    api_assert(message, ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER);
+    api_assert(timeout, ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT);
+    internal_assert(rtos_timer_current_ticks < (UINT32_MAX - timeout),\
+                    ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW);
+    message_queue_invariants_check();
+
+    while ((message_queues[message_queue].available == message_queues[message_queue].queue_length) &&
+            (absolute_timeout > rtos_timer_current_ticks))
+    {
+        message_queue_wait_timeout(message_queue, absolute_timeout - rtos_timer_current_ticks);
+    }
+
+    return rtos_message_queue_try_put(message_queue, message);
+}
+
+void
+rtos_message_queue_get(const RtosMessageQueueId message_queue, void *const message)
+        RTOS_REENTRANT
+{
+    message_queue_api_assert_valid(message_queue);
+    api_assert(message, ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER);
+
+    while (!rtos_message_queue_try_get(message_queue, message))
+    {
+        message_queue_wait(message_queue);
+    }
+}
+
+bool
+rtos_message_queue_try_get(const RtosMessageQueueId message_queue, void *message)
+{
+    message_queue_api_assert_valid(message_queue);
+    api_assert(message, ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER);
+    message_queue_invariants_check();
+
+    {
+        struct message_queue *const mq = &message_queues[message_queue];
+
+        if (mq->available == 0)
+        {
+            return false;
+        }
+        else
+        {
+            const uint16_t buffer_offset = mq->head * mq->message_size;
+            memcopy((uint8_t*)message, &mq->messages[buffer_offset], mq->message_size);
+            mq->head = (mq->head + 1) % mq->queue_length;
+            mq->available -= 1;
+
+            if (mq->available == (1 - 1))
+            {
+                message_queue_waiters_wakeup(message_queue);
+            }
+
+            message_queue_invariants_check();
+            return true;
+        }
+    }
+}
+
+bool
+rtos_message_queue_get_timeout(const RtosMessageQueueId message_queue, void *const message,
+                                         const RtosTicksRelative timeout) RTOS_REENTRANT
+{
+    const RtosTicksAbsolute absolute_timeout = rtos_timer_current_ticks + timeout;
+
+    message_queue_api_assert_valid(message_queue);
+    api_assert(message, ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER);
+    api_assert(timeout, ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT);
+    internal_assert(rtos_timer_current_ticks < (UINT32_MAX - timeout),\
+                    ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW);
+    message_queue_invariants_check();
+
+    while ((message_queues[message_queue].available == 0) &&
+            (absolute_timeout > rtos_timer_current_ticks))
+    {
+        message_queue_wait_timeout(message_queue, absolute_timeout - rtos_timer_current_ticks);
+    }
+
+    return rtos_message_queue_try_get(message_queue, message);
+}
+
+void
+rtos_broadcast_publish(const RtosBroadcastId broadcast, const void *const record)
+{
+    struct broadcast *b;
+    BroadcastSubscriptionIndex s;
+
+    broadcast_api_assert_valid(broadcast);
+    api_assert(record, ERROR_ID_BROADCAST_INVALID_POINTER);
+
+    b = &broadcasts[broadcast];
+
+    /* The record is copied once, regardless of the number of subscribers.
+     * The producer never waits for subscribers: slow subscribers lose the oldest records instead. */
+    broadcast_copy(&b->records[(uint16_t) b->head * b->record_size], (const uint8_t*)record, b->record_size);
+    b->head = (b->head + 1) % b->length;
+    b->published += 1;
+
+    /* Sending the signal only makes the subscribers runnable; they run in the order the scheduler selects them after
+     * the publishing task yields. */
+    /* loop bound: 2 */
+    for (s = b->first_subscription; s < b->first_subscription + b->subscription_count; s += 1)
+    {
+        signal_send_set(broadcast_subscriptions[s].task, b->sig_set);
+    }
+}
+
+bool
+rtos_broadcast_try_get(const RtosBroadcastId broadcast, void *const record)
+{
+    const struct broadcast *b;
+    struct broadcast_subscription *subscription;
+    uint32_t pending;
+
+    broadcast_api_assert_valid(broadcast);
+    api_assert(record, ERROR_ID_BROADCAST_INVALID_POINTER);
+
+    b = &broadcasts[broadcast];
+    subscription = broadcast_subscription_get(broadcast);
+    pending = b->published - subscription->cursor;
+
+    if (pending == 0)
+    {
+        return false;
+    }
+
+    if (pending > b->length)
+    {
+        /* The records the subscriber has not retrieved yet have been overwritten, so skip to the oldest record the
+         * channel still retains */
+        subscription->lost += pending - b->length;
+        subscription->cursor = b->published - b->length;
+        pending = b->length;
+    }
+
+    broadcast_copy((uint8_t*)record,
+                   &b->records[(uint16_t) ((b->head + b->length - pending) % b->length) * b->record_size],
+                   b->record_size);
+    subscription->cursor += 1;
+
+    return true;
+}
+
+void
+rtos_broadcast_get(const RtosBroadcastId broadcast, void *const record) RTOS_REENTRANT
+{
+    broadcast_api_assert_valid(broadcast);
+    api_assert(record, ERROR_ID_BROADCAST_INVALID_POINTER);
+
+    while (!rtos_broadcast_try_get(broadcast, record))
+    {
+        (void) signal_wait_set(broadcasts[broadcast].sig_set);
+    }
+}
+
+uint32_t
+rtos_broadcast_lost(const RtosBroadcastId broadcast)
+{
+    struct broadcast_subscription *subscription;
+    const struct broadcast *b;
+    uint32_t lost;
+
+    broadcast_api_assert_valid(broadcast);
+
+    b = &broadcasts[broadcast];
+    subscription = broadcast_subscription_get(broadcast);
+    lost = subscription->lost;
+
+    /* Records that have been overwritten but not skipped by broadcast_try_get() yet are lost as well */
+    if (b->published - subscription->cursor > b->length)
+    {
+        lost += b->published - subscription->cursor - b->length;
+        subscription->cursor = b->published - b->length;
+    }
+    subscription->lost = 0;
+
+    return lost;
+}
+
+
+RtosTaskId
+rtos_task_current(void)
+{
+    return get_current_task();
+}
+void
+rtos_task_start(const RtosTaskId task)
+{
+    assert_task_valid(task);
+    rtos_signal_send(task, RTOS_SIGNAL_ID__RTOS_UTIL);
+}
+
+void
+rtos_yield(void) RTOS_REENTRANT
+{
+    RtosTaskId to;
+
+    api_assert(!run_to_completion, ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS);
+
+    to = interrupt_event_get_next();
+    yield_to(to);
+}
+
+void
+rtos_start(void)
+{
+    message_queue_init();
+
+    context_init(get_task_context(0), entry_a, stack_0, 64);
+    sched_set_runnable(0);
+    context_init(get_task_context(1), entry_b, stack_1, 64);
+    sched_set_runnable(1);
+    signal_send_set(2, RTOS_SIGNAL_SET__RTOS_UTIL);
+    sched_set_runnable(2);
+    sched_set_runnable(3);
+    context_init(get_task_context(2), stack_group_entry, stack_group_handlers, 96);
+
+    context_switch_first(task_context(RTOS_TASK_ID_ZERO));
+}
@@ -0,0 +1,121 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+/*
+ * Platform support for the rtos-bench systems.
+ *
+ * The bench clock counts processor cycles with a free-running SysTick.
+ * SysTick only has 24 bits, so its wrap-around exception extends the count to 32 bits.
+ * The system must use bench_clock_irq as its systick handler.
+ *
+ * Preemptive systems measure interrupt handling with external interrupt 0, which bench_irq_trigger pends in software.
+ * Its handler is installed by the system, usually through an armv7m.exception-preempt trampoline.
+ */
+
+#include <stdint.h>
+
+#define SYST_CSR_REG 0xE000E010
+#define SYST_RVR_REG 0xE000E014
+#define SYST_CVR_REG 0xE000E018
+
+#define SYST_CSR_READ() (*((volatile uint32_t*)SYST_CSR_REG))
+#define SYST_CSR_WRITE(x) (*((volatile uint32_t*)SYST_CSR_REG) = x)
+
+#define SYST_RVR_WRITE(x) (*((volatile uint32_t*)SYST_RVR_REG) = x)
+
+#define SYST_CVR_READ() (*((volatile uint32_t*)SYST_CVR_REG))
+#define SYST_CVR_WRITE(x) (*((volatile uint32_t*)SYST_CVR_REG) = x)
+
+#define SYST_RELOAD 0xffffffU
+
+#define NVIC_ISER0_REG 0xE000E100
+#define NVIC_ISPR0_REG 0xE000E200
+
+#define NVIC_ISER0_WRITE(x) (*((volatile uint32_t*)NVIC_ISER0_REG) = x)
+#define NVIC_ISPR0_WRITE(x) (*((volatile uint32_t*)NVIC_ISPR0_REG) = x)
+
+#define BENCH_IRQ_BIT (1U << 0)
+
+/* Semihosting SYS_EXIT with reason ADP_Stopped_ApplicationExit */
+#define SEMIHOST_SYS_EXIT 0x18
+#define SEMIHOST_APPLICATION_EXIT 0x20026
+
+static volatile uint32_t bench_clock_wraps;
+
+void
+bench_clock_irq(void)
+{
+    bench_clock_wraps++;
+}
+
+void
+bench_clock_init(void)
+{
+    SYST_RVR_WRITE(SYST_RELOAD);
+    SYST_CVR_WRITE(0);
+    /* Enable, interrupt on wrap, processor clock */
+    SYST_CSR_WRITE((1 << 2) | (1 << 1) | 1);
+
+    NVIC_ISER0_WRITE(BENCH_IRQ_BIT);
+}
+
+uint32_t
+bench_clock(void)
+{
+    uint32_t wraps;
+    uint32_t current;
+
+    /* Retry if the counter wrapped between reading the wrap count and the current value. */
+    do
+    {
+        wraps = bench_clock_wraps;
+        current = SYST_CVR_READ();
+    } while (wraps != bench_clock_wraps);
+
+    return (wraps << 24) | (SYST_RELOAD - current);
+}
+
+void
+bench_irq_trigger(void)
+{
+    NVIC_ISPR0_WRITE(BENCH_IRQ_BIT);
+}
+
+void
+bench_irq_clear(void)
+{
+    /* The NVIC clears the pending bit on exception entry. */
+}
+
+void
+bench_exit(void)
+{
+    register uint32_t r0 asm("r0") = SEMIHOST_SYS_EXIT;
+    register uint32_t r1 asm("r1") = SEMIHOST_APPLICATION_EXIT;
+
+    asm volatile("bkpt 0xab" : : "r" (r0), "r" (r1) : "memory");
+}
@@ -29,19 +29,19 @@
 #define BITBAND_H
 
 #define BITBAND_VAR(TYPE, NAME) \
-    TYPE NAME __attribute__ ((section (".data.bitband"))); \
+    TYPE NAME __attribute__ ((section (".data.bitband"), used)); \
     extern uint32_t NAME##_bitband[sizeof NAME]
 
 #define BITBAND_VAR_ARRAY(TYPE, NAME, NELEM) \
-    TYPE NAME[NELEM] __attribute__ ((section (".data.bitband"))); \
+    TYPE NAME[NELEM] __attribute__ ((section (".data.bitband"), used)); \
     extern uint32_t NAME##_bitband[sizeof NAME]
 
 #define VOLATILE_BITBAND_VAR(TYPE, NAME) \
-    volatile TYPE NAME __attribute__ ((section (".data.bitband"))); \
+    volatile TYPE NAME __attribute__ ((section (".data.bitband"), used)); \
     extern volatile uint32_t NAME##_bitband[sizeof NAME]
 
 #define VOLATILE_BITBAND_VAR_ARRAY(TYPE, NAME, NELEM) \
-    volatile TYPE NAME[NELEM] __attribute__ ((section (".data.bitband"))); \
+    volatile TYPE NAME[NELEM] __attribute__ ((section (".data.bitband"), used)); \
     extern volatile uint32_t NAME##_bitband[sizeof NAME]
 
 
@@ -57,7 +57,8 @@
  */
 
 .syntax unified
-.section .text
+/* The context switching and preemption code is on the hot paths of the RTOS (see RAMFUNC in the RTOS) */
+.section .ramfunc, "ax"
 
 /* The Base Priority Mask Register (BASEPRI) is used to define the minimum priority for exception processing.
  * When set to a nonzero value, it prevents the activation of all exceptions with the same or lower priority level.
@@ -26,7 +26,8 @@
  */
 
 .syntax unified
-.section .text
+/* The context switching and preemption code is on the hot paths of the RTOS (see RAMFUNC in the RTOS) */
+.section .ramfunc, "ax"
 
 /*
  * A subroutine must preserve the contents of the registers r4-r8,
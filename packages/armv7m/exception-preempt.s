@@ -47,7 +47,8 @@
  * See ctxt-switch-preempt.s for more details. */
 
 .syntax unified
-.section .text
+/* The context switching and preemption code is on the hot paths of the RTOS (see RAMFUNC in the RTOS) */
+.section .ramfunc, "ax"
 
 /* This macro is used to set the 'preemption pending' status. */
 .macro asm_preempt_pend scratch0 scratch1
@@ -0,0 +1,2303 @@
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+{{#interrupt_events.length}}
+#include <stdbool.h>
+#include "bitband.h"
+{{/interrupt_events.length}}
+#include <stdbool.h>
+
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+#include "rtos-pherkad.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+
+#define PREEMPTION_SUPPORT
+
+/* To support preemption of tasks by exception handlers, we define a context stack frame that includes the exception
+ * frame automatically stored onto the stack by the CPU when it takes an exception.
+ *
+ * The ARM stack grows downwards, from high to low addresses.
+ * Therefore, the context stack frame entries with the lowest index numbers are the last to be pushed to the stack.
+ * Note that the Procedure Call Standard for the ARM Architecture (ARM IHI 0042E, ABI release 2.09) says that at a
+ * public interface, the stack must be double-word (8-byte) aligned.
+ * Please see http://infocenter.arm.com/help/topic/com.arm.doc.ihi0042e/index.html for more details.
+ *
+ * The lower-address half of the context stack frame is for register values and task state that the RTOS must manually
+ * push onto the stack before it switches context. */
+
+#define CONTEXT_PREEMPT_DISABLED 0
+#define CONTEXT_R4_IDX 1
+#define CONTEXT_R5_IDX 2
+#define CONTEXT_R6_IDX 3
+#define CONTEXT_R7_IDX 4
+#define CONTEXT_R8_IDX 5
+#define CONTEXT_R9_IDX 6
+#define CONTEXT_R10_IDX 7
+#define CONTEXT_R11_IDX 8
+#define CONTEXT_EXCEPTION_RETURN_IDX 9
+#define CONTEXT_S16_IDX 10
+#define CONTEXT_S17_IDX 11
+#define CONTEXT_S18_IDX 12
+#define CONTEXT_S19_IDX 13
+#define CONTEXT_S20_IDX 14
+#define CONTEXT_S21_IDX 15
+#define CONTEXT_S22_IDX 16
+#define CONTEXT_S23_IDX 17
+#define CONTEXT_S24_IDX 18
+#define CONTEXT_S25_IDX 19
+#define CONTEXT_S26_IDX 20
+#define CONTEXT_S27_IDX 21
+#define CONTEXT_S28_IDX 22
+#define CONTEXT_S29_IDX 23
+#define CONTEXT_S30_IDX 24
+#define CONTEXT_S31_IDX 25
+
+/* The higher-address half of the context stack frame is the exception frame automatically pushed by the CPU.
+ * We generally assume this is pushed and popped correctly by the CPU on exception entry and return, and only really
+ * manipulate parts of this region for the setting up of initial task states. */
+
+#define CONTEXT_R0_IDX 26
+#define CONTEXT_R1_IDX 27
+#define CONTEXT_R2_IDX 28
+#define CONTEXT_R3_IDX 29
+#define CONTEXT_IP_IDX 30
+#define CONTEXT_LR_IDX 31
+#define CONTEXT_PC_IDX 32
+#define CONTEXT_PSR_IDX 33
+
+#define CONTEXT_NONFP_SIZE 34
+
+/* The very highest portion of the exception frame is only pushed/popped by the CPU if floating-point is enabled.
+ * Since we set the initial task state to have floating-point disabled, we exclude these entries when creating the
+ * initial context stack frames for each task, and generally don't interfere with this region subsequently.
+ * All we must do is ensure that the EXC_RETURN is set correctly for the destination task on exception return. */
+
+#define CONTEXT_S0_IDX 34
+#define CONTEXT_S1_IDX 35
+#define CONTEXT_S2_IDX 36
+#define CONTEXT_S3_IDX 37
+#define CONTEXT_S4_IDX 38
+#define CONTEXT_S5_IDX 39
+#define CONTEXT_S6_IDX 40
+#define CONTEXT_S7_IDX 41
+#define CONTEXT_S8_IDX 42
+#define CONTEXT_S9_IDX 43
+#define CONTEXT_S10_IDX 44
+#define CONTEXT_S11_IDX 45
+#define CONTEXT_S12_IDX 46
+#define CONTEXT_S13_IDX 47
+#define CONTEXT_S14_IDX 48
+#define CONTEXT_S15_IDX 49
+#define CONTEXT_FPSCR_IDX 50
+#define CONTEXT_ALIGNER_IDX 51
+
+#define CONTEXT_FP_SIZE 52
+
+/* Definitions for ARM-specific initialization.
+ *
+ * We define the SVCALL priority to be a higher level (i.e. lower numerical value) than PENDSV so that when we disable
+ * preemption by setting BASEPRI to PENDSV's priority, PENDSV is disabled but SVCALL remains enabled.
+ * This reflects our desire for the RTOS to be able to manually yield (via svc) when preemption is disabled.
+ *
+ * Some platforms do not implement the low 4 bits of priority.
+ * Thus, we choose priority values that are distinct regardless of the lower 4 bits.
+ * The armv7m.vectable module validates the configured interrupt priorities against these values. */
+
+#define SVCALL_PRIORITY 224u
+#define PENDSV_PRIORITY 240u
+
+/* System Handler Priority Registers (SHPR) */
+#define SHPR2_PHYSADDR 0xE000ED1C
+#define SHPR3_PHYSADDR 0xE000ED20
+
+#define SHPR2_SVCALL_PRIO_MASK 0x00ffffff
+#define SHPR2_SVCALL_PRIO_OFFSET 24
+
+#define SHPR3_PENDSV_PRIO_MASK 0xff00ffff
+#define SHPR3_PENDSV_PRIO_OFFSET 16
+
+/* Execution Program Status Register (EPSR)
+ * T-bit is the Thumb state bit, which must be 1 for the Cortex-M4 because it only supports Thumb instructions. */
+#define EPSR_THUMB_BIT_OFFSET 24
+
+/* For EXC_RETURN of the first task, we choose this value, which means "Return to Thread mode, exception return uses
+ * non-floating-point state from MSP and execution uses MSP after return" according to the Cortex-M4 Devices Generic
+ * User Guide (ARM DUI 0553A).
+ * Please see http://infocenter.arm.com/help/topic/com.arm.doc.dui0553a/index.html for more details. */
+#define EXC_RETURN_INITIAL_TASK 0xfffffff9
+#define SCHED_INDEX_ZERO ((SchedIndex) {{prefix_const}}TASK_ID_ZERO)
+#define SCHED_HEAP_POS_NONE ((SchedIndex) TASK_ID_NONE)
+
+
+{{#timers.length}}
+#define TIMER_ID_ZERO (({{prefix_type}}TimerId) UINT{{timerid_size}}_C(0))
+#define TIMER_ID_MAX (({{prefix_type}}TimerId) UINT{{timerid_size}}_C({{timers.length}} - 1U))
+#define TIMER_WORDS {{timer_enabled_words.length}}U
+{{/timers.length}}
+{{#periodic_tasks.length}}
+#define PERIODIC_INDEX_MAX ((PeriodicIndex) UINT8_C({{periodic_tasks.length}} - 1U))
+#define PERIODIC_INDEX_NONE ((PeriodicIndex) UINT8_MAX)
+{{/periodic_tasks.length}}
+#define interrupt_event rtos_internal_interrupt_event
+#define interrupt_event_bitband rtos_internal_interrupt_event_bitband
+#define SCR_PHYSADDR 0xE000ED10
+#define SCR_SEVONPEND (1u << 4)
+
+
+{{#mutexes.length}}
+#define MUTEX_ID_NONE ((MutexIdOption) UINT8_MAX)
+{{/mutexes.length}}
+{{#condition_variables.length}}
+#define COND_ID_NONE ((CondIdOption) UINT8_MAX)
+{{/condition_variables.length}}
+#define SEM_ID_NONE ((SemIdOption) UINT8_MAX)
+#define SEM_VALUE_ZERO (({{prefix_type}}SemValue) UINT{{semaphore_value_size}}_C(0))
+{{#semaphore_enable_max}}
+#define SEM_VALUE_MAX (({{prefix_type}}SemValue) UINT{{semaphore_value_size}}_MAX)
+{{/semaphore_enable_max}}
+
+{{#pools.length}}
+#define POOL_ID_NONE ((PoolIdOption) UINT8_MAX)
+#define POOL_BLOCK_NONE ((uint16_t) UINT16_MAX)
+#ifdef __GNUC__
+#define POOL_ALIGNED(alignment) __attribute__((aligned(alignment)))
+#else
+#define POOL_ALIGNED(alignment)
+#endif
+{{/pools.length}}
+#define ERROR_ID_NONE (({{prefix_type}}ErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW (({{prefix_type}}ErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID (({{prefix_type}}ErrorId) UINT8_C(2))
+#define ERROR_ID_NOT_HOLDING_MUTEX (({{prefix_type}}ErrorId) UINT8_C(3))
+#define ERROR_ID_DEADLOCK (({{prefix_type}}ErrorId) UINT8_C(4))
+#define ERROR_ID_TASK_FUNCTION_RETURNS (({{prefix_type}}ErrorId) UINT8_C(5))
+#define ERROR_ID_INTERNAL_CURRENT_TASK_INVALID (({{prefix_type}}ErrorId) UINT8_C(6))
+#define ERROR_ID_INTERNAL_INVALID_ID (({{prefix_type}}ErrorId) UINT8_C(7))
+#define ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP (({{prefix_type}}ErrorId) UINT8_C(8))
+#define ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT (({{prefix_type}}ErrorId) UINT8_C(9))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_ZERO_TIMEOUT (({{prefix_type}}ErrorId) UINT8_C(10))
+#define ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER (({{prefix_type}}ErrorId) UINT8_C(11))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW (({{prefix_type}}ErrorId) UINT8_C(12))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION (({{prefix_type}}ErrorId) UINT8_C(13))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_CONFIGURATION (({{prefix_type}}ErrorId) UINT8_C(14))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_HEAD (({{prefix_type}}ErrorId) UINT8_C(15))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE (({{prefix_type}}ErrorId) UINT8_C(16))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_ID_IN_WAITERS (({{prefix_type}}ErrorId) UINT8_C(17))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TASKS_BLOCKED_DESPITE_AVAILABLE_MESSAGES (({{prefix_type}}ErrorId) UINT8_C(18))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_WAITING_TASK_IS_NOT_BLOCKED (({{prefix_type}}ErrorId) UINT8_C(19))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGES_POINTER (({{prefix_type}}ErrorId) UINT8_C(20))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGE_SIZE (({{prefix_type}}ErrorId) UINT8_C(21))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH (({{prefix_type}}ErrorId) UINT8_C(22))
+#define ERROR_ID_INTERNAL_PRECONDITION_VIOLATED (({{prefix_type}}ErrorId) UINT8_C(23))
+#define ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED (({{prefix_type}}ErrorId) UINT8_C(24))
+#define ERROR_ID_SEMAPHORE_MAX_INVALID (({{prefix_type}}ErrorId) UINT8_C(25))
+#define ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT (({{prefix_type}}ErrorId) UINT8_C(26))
+#define ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT (({{prefix_type}}ErrorId) UINT8_C(27))
+#define ERROR_ID_SEMAPHORE_MAX_EXCEEDED (({{prefix_type}}ErrorId) UINT8_C(28))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED (({{prefix_type}}ErrorId) UINT8_C(29))
+#define ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX (({{prefix_type}}ErrorId) UINT8_C(30))
+#define ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED (({{prefix_type}}ErrorId) UINT8_C(31))
+#define ERROR_ID_SCHED_EDF_TASK_NOT_PERIODIC (({{prefix_type}}ErrorId) UINT8_C(32))
+#define ERROR_ID_TIMER_TASK_NOT_PERIODIC (({{prefix_type}}ErrorId) UINT8_C(33))
+#define ERROR_ID_POOL_INVALID_BLOCK (({{prefix_type}}ErrorId) UINT8_C(34))
+#define ERROR_ID_BROADCAST_NOT_SUBSCRIBED (({{prefix_type}}ErrorId) UINT8_C(35))
+#define ERROR_ID_BROADCAST_INVALID_POINTER (({{prefix_type}}ErrorId) UINT8_C(36))
+#define ERROR_ID_WORK_QUEUE_INVALID_FUNCTION (({{prefix_type}}ErrorId) UINT8_C(37))
+#define ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS (({{prefix_type}}ErrorId) UINT8_C(38))
+#define ERROR_ID_TIMEBASE_TIME_TOO_FAR (({{prefix_type}}ErrorId) UINT8_C(39))
+#define TASK_ID_NONE ((TaskIdOption) UINT{{taskid_size}}_MAX)
+#define current_task rtos_internal_current_task
+#define tasks rtos_internal_tasks
+
+typedef uint32_t* context_t;
+typedef {{prefix_type}}TaskId SchedIndex;
+typedef uint{{ticksrelative_size}}_t TicksTimeout;
+typedef uint32_t TimerWord;
+typedef uint8_t PeriodicIndex;
+typedef {{prefix_type}}MutexId MutexIdOption;
+typedef {{prefix_type}}CondId CondIdOption;
+typedef {{prefix_type}}SemId SemIdOption;
+typedef {{prefix_type}}PoolId PoolIdOption;
+typedef {{prefix_type}}TaskId TaskIdOption;
+
+
+
+struct sched_task {
+    TaskIdOption blocked_on;
+    SchedIndex heap_pos;
+    {{prefix_type}}TicksAbsolute deadline;
+};
+
+/*
+ * The heap contains the tasks that are runnable or blocked on a specific task.
+ * It is a binary min-heap ordered by absolute deadline (ties are broken by task ID), so its root is the task with the
+ * earliest deadline.
+ */
+struct sched {
+    struct sched_task tasks[{{tasks.length}}];
+    {{prefix_type}}TaskId heap[{{tasks.length}}];
+    SchedIndex heap_size;
+};
+struct signal_task {
+    {{prefix_type}}SignalSet signals;
+};
+
+struct signal {
+    struct signal_task tasks[{{tasks.length}}];
+};
+
+{{#periodic_tasks.length}}
+struct periodic_task
+{
+    /* The nominal release time of the current job, or of the job before the first one */
+    {{prefix_type}}TicksAbsolute release;
+    {{prefix_type}}TicksRelative period;
+    {{prefix_type}}TicksRelative deadline;
+    {{prefix_type}}TaskId task_id;
+    {{prefix_type}}SignalSet signal_set;
+    bool job_active;
+    {{prefix_type}}TicksRelative job_jitter;
+};
+{{/periodic_tasks.length}}
+
+
+struct interrupt_event_handler {
+    {{prefix_type}}TaskId task;
+    {{prefix_type}}SignalSet sig_set;
+};
+
+struct mutex {
+    TaskIdOption holder;
+};
+{{#mutex.stats}}
+struct mutex_stat {
+    uint32_t mutex_lock_counter;
+    uint32_t mutex_lock_contended_counter;
+    {{prefix_type}}TicksRelative mutex_lock_max_wait_time;
+};
+{{/mutex.stats}}
+
+struct semaphore {
+    {{prefix_type}}SemValue value;
+{{#semaphore_enable_max}}
+    {{prefix_type}}SemValue max;
+{{/semaphore_enable_max}}
+};
+
+{{#pools.length}}
+struct pool {
+    uint8_t *storage;
+    uint16_t block_stride;
+    uint16_t block_count;
+};
+
+/*
+ * The free blocks of a pool form a singly-linked list, with the index of the next free block stored in the first two
+ * bytes of each free block.
+ * The head of the list is a word that holds the index of the first free block in its lower half and a tag in its upper
+ * half.
+ * Every update of the head increments the tag, so that a compare-and-swap based on an outdated head fails even if the
+ * same block has been allocated and freed again in the meantime (the ABA problem).
+ */
+struct pool_state {
+    volatile uint32_t head;
+    volatile uint32_t used;
+    volatile uint32_t high_water_mark;
+};
+{{/pools.length}}
+
+struct task
+{
+    context_t ctx;
+};
+
+
+
+extern void rtos_internal_context_switch_first(context_t *);
+extern void rtos_internal_task_entry_trampoline(void);
+extern bool rtos_internal_check_preempt_disabled(void);
+extern void rtos_internal_yield(void);
+extern void rtos_internal_preempt_enable(void);
+extern void rtos_internal_preempt_disable(void);
+extern void rtos_internal_preempt_pend(void);
+
+
+
+
+
+
+
+
+
+
+
+
+extern void {{fatal_error}}({{prefix_type}}ErrorId error_id);
+{{#tasks}}
+extern void {{function}}(void);
+{{/tasks}}
+{{#tasks}}
+extern void {{function}}(void);
+{{/tasks}}
+
+
+/**
+ * Platform-specific initialization for the preemption implementation called once at RTOS start time.
+ */
+static void preempt_init(void);
+
+/**
+ * Set up the initial execution context of a task.
+ * This function is invoked exactly once for each task in the system.
+ *
+ * @param ctx An output parameter interpreted by the RTOS as the initial context for each task.
+ *  After this function returns, the RTOS uses the value of ctx for task/context/stack switching.
+ *  The context must be set up such that the destination task of a task switch executes the code at the address fn
+ *  using the memory region defined by stack_base and stack_size as its stack.
+ * @param fn Points to a code address at which the given execution context shall start executing.
+ *  This is typically a pointer to a parameter-less function that is assumed to never return.
+ * @param stack_base Points to the lowest address of the memory area this execution context shall use as a stack.
+ * @param stack_size The size in bytes of the stack memory area reserved for this execution context.
+ */
+static void context_init(context_t *ctx, void (*fn)(void), uint32_t *stack_base, size_t stack_size);
+static bool sched_task_before(const {{prefix_type}}TaskId task_a, const {{prefix_type}}TaskId task_b);
+static void sched_heap_swap(SchedIndex pos_a, SchedIndex pos_b);
+static void sched_heap_sift_up(SchedIndex pos);
+static void sched_heap_sift_down(SchedIndex pos);
+static void sched_heap_insert(const {{prefix_type}}TaskId task_id);
+static void sched_heap_remove(const {{prefix_type}}TaskId task_id);
+static TaskIdOption sched_resolve_blocked_on({{prefix_type}}TaskId task_id);
+static void sched_set_runnable(const {{prefix_type}}TaskId task_id);
+static void sched_set_blocked_on(const {{prefix_type}}TaskId task_id, const {{prefix_type}}TaskId blocker);
+static void sched_set_deadline(const {{prefix_type}}TaskId task_id, const {{prefix_type}}TicksAbsolute deadline);
+static TaskIdOption sched_get_next(void);
+static {{prefix_type}}SignalSet signal_recv({{prefix_type}}SignalSet *pending_signals, {{prefix_type}}SignalSet requested_signals);
+static void signal_send_set({{prefix_type}}TaskId task_id, {{prefix_type}}SignalSet signals);
+static {{prefix_type}}SignalSet signal_wait_set_blocked_on({{prefix_type}}SignalSet requested_signals,
+        {{prefix_type}}TaskId blocker) {{prefix_const}}REENTRANT;
+
+static uint8_t timer_pending_ticks_get_and_clear_atomically(void);
+{{#timers.length}}
+static void timer_process_one({{prefix_type}}TimerId timer_id);
+static void timer_enable({{prefix_type}}TimerId timer_id);
+static void timer_oneshot({{prefix_type}}TimerId timer_id, {{prefix_type}}TicksRelative timeout);
+{{/timers.length}}
+static void timer_tick_process(void);
+{{#periodic_tasks.length}}
+static void periodic_release_process(void);
+static PeriodicIndex periodic_index_get({{prefix_type}}TaskId task_id);
+static void periodic_stats_record(PeriodicIndex idx, {{prefix_type}}TicksRelative jitter,
+                                  {{prefix_type}}TicksRelative response);
+{{/periodic_tasks.length}}
+static void interrupt_event_process(void);
+static inline bool interrupt_application_event_check(void);
+static inline void interrupt_event_wait(void);
+{{prefix_type}}TaskId rtos_internal_interrupt_event_get_next(void);
+{{#interrupt_events.length}}
+static void interrupt_event_handle({{prefix_type}}InterruptEventId interrupt_event_id);
+{{/interrupt_events.length}}
+{{#mutexes.length}}
+static bool mutex_try_lock({{prefix_type}}MutexId m);
+static bool mutex_acquire({{prefix_type}}MutexId m) {{prefix_const}}REENTRANT;
+static void mutex_release({{prefix_type}}MutexId m);
+{{/mutexes.length}}
+{{#condition_variables.length}}
+static void cond_wake({{prefix_type}}CondId cond, bool all);
+{{/condition_variables.length}}
+static bool internal_sem_try_wait(const {{prefix_type}}SemId s);
+{{#atomics}}
+static bool atomic_compare_and_swap(volatile uint32_t *word, uint32_t expected, uint32_t desired);
+{{/atomics}}
+{{#pools.length}}
+static void pool_init(void);
+static void *pool_try_alloc({{prefix_type}}PoolId pool);
+static void pool_used_add({{prefix_type}}PoolId pool, int32_t delta);
+{{/pools.length}}
+
+{{#internal_asserts}}
+static {{prefix_type}}TaskId get_current_task_check(void);
+{{/internal_asserts}}
+static void block_on({{prefix_type}}TaskId blocker);
+{{#mutexes.length}}
+static void mutex_core_block_on_timeout({{prefix_type}}TaskId t, {{prefix_type}}TicksRelative ticks);
+{{/mutexes.length}}
+static void sem_core_block_timeout({{prefix_type}}TicksRelative ticks);
+static void unblock({{prefix_type}}TaskId task);
+
+{{#tasks}}
+static uint32_t stack_{{idx}}[{{stack_size}}] __attribute__((aligned(8)));
+{{/tasks}}
+
+
+static struct sched sched_tasks = {
+    {
+{{#tasks}}
+        { TASK_ID_NONE, SCHED_HEAP_POS_NONE, 0 },
+{{/tasks}}
+    },
+    { 0 },
+    0
+};
+static struct signal signal_tasks;
+static volatile uint8_t timer_pending_ticks;
+{{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+{{#timers.length}}
+/*
+ * The state of the timers is laid out as one array per field, indexed by timer ID.
+ * The enabled and overflow flags are packed into bitmaps of 32 timers per word, so that tick processing only visits
+ * the enabled timers.
+ */
+static TimerWord timers_enabled[TIMER_WORDS] = {
+{{#timer_enabled_words}}
+    UINT32_C({{.}}),
+{{/timer_enabled_words}}
+};
+static TimerWord timers_overflow[TIMER_WORDS];
+static TicksTimeout timer_expiries[{{timers.length}}] = {
+{{#timers}}
+    {{#enabled}}{{reload}}{{/enabled}}{{^enabled}}0{{/enabled}},
+{{/timers}}
+};
+static {{prefix_type}}TicksRelative timer_reloads[{{timers.length}}] = {
+{{#timers}}
+    {{reload}},
+{{/timers}}
+};
+/* When the error ID of a timer is not ERROR_ID_NONE, the timer calls the application error function with it */
+static {{prefix_type}}ErrorId timer_error_ids[{{timers.length}}] = {
+{{#timers}}
+    {{error}},
+{{/timers}}
+};
+static {{prefix_type}}TaskId timer_task_ids[{{timers.length}}] = {
+{{#timers}}
+    {{#task}}{{prefix_const}}TASK_ID_{{name|u}}{{/task}}{{^task}}TASK_ID_NONE{{/task}},
+{{/timers}}
+};
+static {{prefix_type}}SignalSet timer_signal_sets[{{timers.length}}] = {
+{{#timers}}
+    {{#sig_set}}{{prefix_const}}SIGNAL_SET_{{.|u}}{{/sig_set}}{{^sig_set}}{{prefix_const}}SIGNAL_SET_EMPTY{{/sig_set}},
+{{/timers}}
+};
+{{/timers.length}}
+{{#periodic_tasks.length}}
+static struct periodic_task periodic_tasks[{{periodic_tasks.length}}] = {
+{{#periodic_tasks}}
+    {
+        ({{prefix_type}}TicksAbsolute) {{phase}} - {{period}},
+        {{period}},
+        {{deadline}},
+        {{prefix_const}}TASK_ID_{{task.name|u}},
+        {{prefix_const}}SIGNAL_SET_{{sig_set|u}},
+        false,
+        0
+    },
+{{/periodic_tasks}}
+};
+{{prefix_type}}PeriodicStats {{prefix_func}}periodic_stats[{{periodic_tasks.length}}] = {
+{{#periodic_tasks}}
+    {{prefix_const}}PERIODIC_STATS_INIT,
+{{/periodic_tasks}}
+};
+{{/periodic_tasks.length}}
+{{#interrupt_events.length}}
+VOLATILE_BITBAND_VAR(uint32_t, rtos_internal_interrupt_event);
+{{/interrupt_events.length}}
+static bool system_is_idle;
+{{#interrupt_events.length}}
+struct interrupt_event_handler interrupt_events[{{interrupt_events.length}}] = {
+{{#interrupt_events}}
+    { {{prefix_const}}TASK_ID_{{task.name|u}}, {{prefix_const}}SIGNAL_SET_{{sig_set|u}} },
+{{/interrupt_events}}
+};
+{{/interrupt_events.length}}
+{{#mutexes.length}}
+static struct mutex mutexes[{{mutexes.length}}] = {
+{{#mutexes}}
+    {TASK_ID_NONE},
+{{/mutexes}}
+};
+static MutexIdOption mutex_waiters[{{tasks.length}}] = {
+{{#tasks}}
+    MUTEX_ID_NONE,
+{{/tasks}}
+};
+{{#mutex.stats}}
+bool {{prefix_func}}mutex_stats_enabled;
+static struct mutex_stat mutex_stats[{{mutexes.length}}];
+{{/mutex.stats}}
+{{/mutexes.length}}
+{{#condition_variables.length}}
+/* The condition variable each task waits on, if any.
+ * A task waiting on a condition variable holds no mutex and is blocked without a blocker, so no task inherits its
+ * priority until it is woken up and waits for the mutex again. */
+static CondIdOption cond_waiters[{{tasks.length}}] = {
+{{#tasks}}
+    COND_ID_NONE,
+{{/tasks}}
+};
+{{/condition_variables.length}}
+static struct semaphore semaphores[{{semaphores.length}}];
+static SemIdOption sem_waiters[{{tasks.length}}];
+
+{{#pools.length}}
+{{#pools}}
+static uint8_t pool_storage_{{name}}[{{block_count}}U * {{stride}}U] POOL_ALIGNED({{alignment}});
+{{/pools}}
+static const struct pool pools[{{pools.length}}] = {
+{{#pools}}
+    { pool_storage_{{name}}, {{stride}}U, {{block_count}}U },
+{{/pools}}
+};
+static struct pool_state pool_states[{{pools.length}}];
+static PoolIdOption pool_waiters[{{tasks.length}}];
+{{/pools.length}}
+
+{{prefix_type}}TaskId rtos_internal_current_task;
+struct task rtos_internal_tasks[{{tasks.length}}];
+{{#timers.length}}
+static {{prefix_type}}TimerId task_timers[{{tasks.length}}] = {
+{{#tasks}}
+    {{prefix_const}}TIMER_ID_{{timer.name|u}},
+{{/tasks}}
+};
+{{/timers.length}}
+static const {{prefix_type}}TicksRelative task_deadlines[{{tasks.length}}] = {
+{{#tasks}}
+    {{deadline}},
+{{/tasks}}
+};
+static const {{prefix_type}}TicksRelative task_periods[{{tasks.length}}] = {
+{{#tasks}}
+    {{period}},
+{{/tasks}}
+};
+/* The tick at which each periodic task was most recently released */
+static {{prefix_type}}TicksAbsolute task_releases[{{tasks.length}}];
+
+
+#define context_switch_first(to) rtos_internal_context_switch_first(get_task_context(to))
+#define yield() rtos_internal_yield()
+#define preempt_disable() rtos_internal_preempt_disable()
+#define preempt_enable() rtos_internal_preempt_enable()
+#define preempt_pend() rtos_internal_preempt_pend()
+#define precondition_preemption_disabled() internal_assert(rtos_internal_check_preempt_disabled(), \
+        ERROR_ID_INTERNAL_PRECONDITION_VIOLATED)
+#define postcondition_preemption_disabled() internal_assert(rtos_internal_check_preempt_disabled(), \
+        ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED)
+#define postcondition_preemption_enabled() internal_assert(!rtos_internal_check_preempt_disabled(), \
+        ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED)
+#define sched_set_blocked(task_id) sched_set_blocked_on(task_id, TASK_ID_NONE)
+#define sched_runnable(task_id) (SCHED_OBJ(task_id).blocked_on == (task_id))
+#define sched_in_heap(task_id) (SCHED_OBJ(task_id).heap_pos != SCHED_HEAP_POS_NONE)
+#define sched_deadline_get(task_id) (SCHED_OBJ(task_id).deadline)
+/* Deadlines are compared modulo the tick counter wrap-around, so they must lie within half its range of each other. */
+#define sched_deadline_before(deadline_a, deadline_b) ((int32_t) ((deadline_a) - (deadline_b)) < 0)
+#define SCHED_OBJ(task_id) sched_tasks.tasks[task_id]
+
+#define signal_wait_blocked_on(requested_signals, blocker) signal_wait_set_blocked_on(requested_signals, blocker)
+#define signal_wait_set(requested_signals) signal_wait_set_blocked_on(requested_signals, TASK_ID_NONE)
+#define signal_wait(requested_signals) signal_wait_set(requested_signals)
+#define signal_peek(pending_signals, requested_signals) (((pending_signals) & (requested_signals)) != {{prefix_const}}SIGNAL_SET_EMPTY)
+#define signal_pending(task_id, mask) ((PENDING_SIGNALS(task_id) & mask) == mask)
+#define PENDING_SIGNALS(task_id) signal_tasks.tasks[task_id].signals
+#define timer_pending_ticks_check() ((bool)timer_pending_ticks)
+{{#timers.length}}
+#define TIMER_WORD(timer_id) ((timer_id) / 32U)
+#define TIMER_BIT(timer_id) ((TimerWord) 1U << ((timer_id) % 32U))
+#define timer_is_enabled(timer_id) ((timers_enabled[TIMER_WORD(timer_id)] & TIMER_BIT(timer_id)) != 0)
+#define timer_is_periodic(timer_id) (timer_reloads[timer_id] > 0)
+#define timer_reload_set(timer_id, ticks) timer_reloads[timer_id] = ticks
+#define timer_disable(timer_id) timers_enabled[TIMER_WORD(timer_id)] &= ~TIMER_BIT(timer_id)
+#define current_timeout() ((TicksTimeout) {{prefix_func}}timer_current_ticks)
+{{/timers.length}}
+#define assert_timer_valid(timer) api_assert(timer_id < {{timers.length}}, ERROR_ID_INVALID_ID)
+{{#periodic_tasks.length}}
+#define periodic_ticks_clamp(ticks) \
+    ((ticks) > UINT{{ticksrelative_size}}_MAX ? ({{prefix_type}}TicksRelative) UINT{{ticksrelative_size}}_MAX :\
+     ({{prefix_type}}TicksRelative) (ticks))
+{{/periodic_tasks.length}}
+
+#define interrupt_event_check() (interrupt_application_event_check() || interrupt_system_event_check())
+#define interrupt_system_event_check() timer_pending_ticks_check()
+#define interrupt_event_get_next() rtos_internal_interrupt_event_get_next()
+
+{{#mutexes.length}}
+#define assert_mutex_valid(mutex) api_assert(mutex < {{mutexes.length}}, ERROR_ID_INVALID_ID)
+{{/mutexes.length}}
+{{#condition_variables.length}}
+#define assert_cond_valid(cond) api_assert(cond < {{condition_variables.length}}, ERROR_ID_INVALID_ID)
+{{/condition_variables.length}}
+#define assert_sem_valid(sem) api_assert(sem < {{semaphores.length}}, ERROR_ID_INVALID_ID)
+
+{{#pools.length}}
+#define pool_block(pool, index) (&pools[pool].storage[(uint32_t) (index) * pools[pool].block_stride])
+#define pool_block_next(block) (*((volatile uint16_t *) (block)))
+#define pool_head_index(head) ((uint16_t) ((head) & 0xffffU))
+#define pool_head_next(head, index) (((((head) >> 16) + 1U) << 16) | (uint32_t) (index))
+{{/pools.length}}
+#define assert_pool_valid(pool) api_assert(pool < {{pools.length}}, ERROR_ID_INVALID_ID)
+{{#api_asserts}}
+#define api_error(error_id) {{fatal_error}}(error_id)
+{{/api_asserts}}
+{{^api_asserts}}
+#define api_error(error_id) do { } while(0)
+{{/api_asserts}}
+{{#api_asserts}}
+#define api_assert(expression, error_id) do { if (!(expression)) { api_error(error_id); } } while(0)
+{{/api_asserts}}
+{{^api_asserts}}
+#define api_assert(expression, error_id) do { } while(0)
+{{/api_asserts}}
+
+{{#internal_asserts}}
+#define internal_error(error_id) {{fatal_error}}(error_id)
+{{/internal_asserts}}
+{{^internal_asserts}}
+#define internal_error(error_id) do { } while(0)
+{{/internal_asserts}}
+{{#internal_asserts}}
+#define internal_assert(expression, error_id) do { if (!(expression)) { internal_error(error_id); } } while(0)
+{{/internal_asserts}}
+{{^internal_asserts}}
+#define internal_assert(expression, error_id) do { } while(0)
+{{/internal_asserts}}
+{{#internal_asserts}}
+#define get_current_task() get_current_task_check()
+{{/internal_asserts}}
+{{^internal_asserts}}
+#define get_current_task() current_task
+{{/internal_asserts}}
+#define get_task_context(task_id) &tasks[task_id].ctx
+#define internal_assert_task_valid(task) internal_assert(task < {{tasks.length}}, ERROR_ID_INTERNAL_INVALID_ID)
+#define assert_task_valid(task) api_assert(task < {{tasks.length}}, ERROR_ID_INVALID_ID)
+#define block() block_on(TASK_ID_NONE)
+#define mutex_core_block_on(blocker) signal_wait_blocked_on({{prefix_const}}SIGNAL_ID__TASK_TIMER, blocker)
+#define mutex_core_unblock(task) signal_send_set(task, {{prefix_const}}SIGNAL_ID__TASK_TIMER)
+#define sem_core_block() signal_wait({{prefix_const}}SIGNAL_ID__TASK_TIMER)
+#define sem_core_unblock(task) signal_send_set(task, {{prefix_const}}SIGNAL_ID__TASK_TIMER)
+#define cond_core_block() signal_wait({{prefix_const}}SIGNAL_ID__TASK_TIMER)
+#define cond_core_block_timeout(ticks) sem_core_block_timeout(ticks)
+#define cond_core_unblock(task) signal_send_set(task, {{prefix_const}}SIGNAL_ID__TASK_TIMER)
+/* Under EDF scheduling, the task with the earlier deadline has the higher priority */
+#define cond_core_higher_priority(task_a, task_b) sched_deadline_before(sched_deadline_get(task_a), \
+                                                                        sched_deadline_get(task_b))
+
+
+
+/* ARM specific initialization */
+static void
+preempt_init(void)
+{
+    /* Set the priority of handlers */
+    volatile uint32_t *shpr2 = (uint32_t *) SHPR2_PHYSADDR;
+    volatile uint32_t *shpr3 = (uint32_t *) SHPR3_PHYSADDR;
+    *shpr2 = (SVCALL_PRIORITY << SHPR2_SVCALL_PRIO_OFFSET) | (SHPR2_SVCALL_PRIO_MASK & *shpr2);
+    *shpr3 = (PENDSV_PRIORITY << SHPR3_PENDSV_PRIO_OFFSET) | (SHPR3_PENDSV_PRIO_MASK & *shpr3);
+
+    preempt_disable();
+}
+
+static void
+context_init(context_t *const ctx, void (*const fn)(void), uint32_t *const stack_base, const size_t stack_size)
+{
+    /* We use the NONFP size because EXC_RETURN of all tasks is set initially to a non-floating-point state. */
+    uint32_t *const context = stack_base + stack_size - CONTEXT_NONFP_SIZE;
+
+    /* Start all tasks with preemption disabled by setting this field to a non-zero value. */
+    context[CONTEXT_PREEMPT_DISABLED] = true;
+    /* Set R4 to the task entry point, for the task entry trampoline to bounce to. */
+    context[CONTEXT_R4_IDX] = (uint32_t) fn;
+    context[CONTEXT_PC_IDX] = (uint32_t) rtos_internal_task_entry_trampoline;
+    context[CONTEXT_PSR_IDX] = (uint32_t) (1u << EPSR_THUMB_BIT_OFFSET); /* make sure the T-bit is set! */
+    context[CONTEXT_EXCEPTION_RETURN_IDX] = (uint32_t) EXC_RETURN_INITIAL_TASK;
+
+    *ctx = context;
+}
+static bool
+sched_task_before(const {{prefix_type}}TaskId task_a, const {{prefix_type}}TaskId task_b)
+{
+    const {{prefix_type}}TicksAbsolute deadline_a = SCHED_OBJ(task_a).deadline;
+    const {{prefix_type}}TicksAbsolute deadline_b = SCHED_OBJ(task_b).deadline;
+
+    return sched_deadline_before(deadline_a, deadline_b) || (deadline_a == deadline_b && task_a < task_b);
+}
+
+static void
+sched_heap_swap(const SchedIndex pos_a, const SchedIndex pos_b)
+{
+    const {{prefix_type}}TaskId task_a = sched_tasks.heap[pos_a];
+    const {{prefix_type}}TaskId task_b = sched_tasks.heap[pos_b];
+
+    sched_tasks.heap[pos_a] = task_b;
+    sched_tasks.heap[pos_b] = task_a;
+    SCHED_OBJ(task_a).heap_pos = pos_b;
+    SCHED_OBJ(task_b).heap_pos = pos_a;
+}
+
+static void
+sched_heap_sift_up(SchedIndex pos)
+{
+    SchedIndex parent;
+
+    /* loop bound: {{tasks.length}} */
+    while (pos > SCHED_INDEX_ZERO)
+    {
+        parent = (pos - 1U) / 2U;
+        if (!sched_task_before(sched_tasks.heap[pos], sched_tasks.heap[parent]))
+        {
+            break;
+        }
+        sched_heap_swap(pos, parent);
+        pos = parent;
+    }
+}
+
+static void
+sched_heap_sift_down(SchedIndex pos)
+{
+    SchedIndex child;
+
+    /* Checking against half the heap size first ensures that computing the child index cannot overflow */
+    /* loop bound: {{tasks.length}} */
+    while (pos < sched_tasks.heap_size / 2U)
+    {
+        child = (2U * pos) + 1U;
+        if (child + 1U < sched_tasks.heap_size &&
+            sched_task_before(sched_tasks.heap[child + 1U], sched_tasks.heap[child]))
+        {
+            child++;
+        }
+        if (!sched_task_before(sched_tasks.heap[child], sched_tasks.heap[pos]))
+        {
+            break;
+        }
+        sched_heap_swap(pos, child);
+        pos = child;
+    }
+}
+
+static void
+sched_heap_insert(const {{prefix_type}}TaskId task_id)
+{
+    const SchedIndex pos = sched_tasks.heap_size;
+
+    sched_tasks.heap_size++;
+    sched_tasks.heap[pos] = task_id;
+    SCHED_OBJ(task_id).heap_pos = pos;
+    sched_heap_sift_up(pos);
+}
+
+static void
+sched_heap_remove(const {{prefix_type}}TaskId task_id)
+{
+    const SchedIndex pos = SCHED_OBJ(task_id).heap_pos;
+    {{prefix_type}}TaskId last;
+
+    sched_tasks.heap_size--;
+    SCHED_OBJ(task_id).heap_pos = SCHED_HEAP_POS_NONE;
+    if (pos != sched_tasks.heap_size)
+    {
+        last = sched_tasks.heap[sched_tasks.heap_size];
+        sched_tasks.heap[pos] = last;
+        SCHED_OBJ(last).heap_pos = pos;
+        sched_heap_sift_up(pos);
+        sched_heap_sift_down(SCHED_OBJ(last).heap_pos);
+    }
+}
+
+/*
+ * Follow the chain of tasks that the given task is blocked on to the runnable task at its end.
+ * Returns TASK_ID_NONE if the chain ends in a task that is blocked on no specific task.
+ */
+static RAMFUNC TaskIdOption
+sched_resolve_blocked_on({{prefix_type}}TaskId task_id)
+{
+    TaskIdOption next_task;
+
+    /* loop bound: {{tasks.length}} */
+    for (;;)
+    {
+        next_task = SCHED_OBJ(task_id).blocked_on;
+        if (next_task == task_id || next_task == TASK_ID_NONE)
+        {
+            return next_task;
+        }
+        task_id = next_task;
+    }
+}
+
+static void
+sched_set_runnable(const {{prefix_type}}TaskId task_id)
+{
+    SCHED_OBJ(task_id).blocked_on = task_id;
+    if (!sched_in_heap(task_id))
+    {
+        sched_heap_insert(task_id);
+    }
+}
+
+static void
+sched_set_blocked_on(const {{prefix_type}}TaskId task_id, const {{prefix_type}}TaskId blocker)
+{
+    SCHED_OBJ(task_id).blocked_on = blocker;
+    if (blocker == TASK_ID_NONE)
+    {
+        if (sched_in_heap(task_id))
+        {
+            sched_heap_remove(task_id);
+        }
+    }
+    else if (!sched_in_heap(task_id))
+    {
+        sched_heap_insert(task_id);
+    }
+}
+
+static void
+sched_set_deadline(const {{prefix_type}}TaskId task_id, const {{prefix_type}}TicksAbsolute deadline)
+{
+    SCHED_OBJ(task_id).deadline = deadline;
+    if (sched_in_heap(task_id))
+    {
+        sched_heap_sift_up(SCHED_OBJ(task_id).heap_pos);
+        sched_heap_sift_down(SCHED_OBJ(task_id).heap_pos);
+    }
+}
+
+static RAMFUNC TaskIdOption
+sched_get_next(void)
+{
+    /* NOTE: In the case where assume_runnable is true and no runnable
+       tasks are found, then an undefined task will be returned from this
+       function.
+    */
+    TaskIdOption task = TASK_ID_NONE;
+    TaskIdOption candidate;
+    TaskIdOption earliest = TASK_ID_NONE;
+    SchedIndex pos;
+
+    if (sched_tasks.heap_size > 0)
+    {
+        task = sched_resolve_blocked_on(sched_tasks.heap[0]);
+        if (task == TASK_ID_NONE)
+        {
+            /*
+             * The task with the earliest deadline is blocked on a task that waits for something other than a task.
+             * This is rare, so fall back to searching the heap for the earliest task whose chain ends in a runnable
+             * task.
+             */
+            /* loop bound: {{tasks.length}} */
+            for (pos = 1; pos < sched_tasks.heap_size; pos++)
+            {
+                candidate = sched_resolve_blocked_on(sched_tasks.heap[pos]);
+                if (candidate != TASK_ID_NONE &&
+                    (earliest == TASK_ID_NONE || sched_task_before(sched_tasks.heap[pos], earliest)))
+                {
+                    earliest = sched_tasks.heap[pos];
+                    task = candidate;
+                }
+            }
+        }
+    }
+
+    return  task;
+}
+static {{prefix_type}}SignalSet
+signal_recv({{prefix_type}}SignalSet *const pending_signals, const {{prefix_type}}SignalSet requested_signals)
+{
+    const {{prefix_type}}SignalSet received_signals = *pending_signals & requested_signals;
+
+    precondition_preemption_disabled();
+
+    *pending_signals &= ~received_signals;
+
+    postcondition_preemption_disabled();
+
+    return received_signals;
+}
+
+static RAMFUNC void
+signal_send_set(const {{prefix_type}}TaskId task_id, const {{prefix_type}}SignalSet signals)
+{
+    precondition_preemption_disabled();
+
+    PENDING_SIGNALS(task_id) |= signals;
+    unblock(task_id);
+
+    postcondition_preemption_disabled();
+}
+
+static {{prefix_type}}SignalSet
+signal_wait_set_blocked_on(const {{prefix_type}}SignalSet requested_signals, const {{prefix_type}}TaskId blocker)
+        {{prefix_const}}REENTRANT
+{
+    {{prefix_type}}SignalSet received_signals;
+
+    precondition_preemption_disabled();
+    {
+        {{prefix_type}}SignalSet *const pending_signals = &PENDING_SIGNALS(get_current_task());
+
+        if (signal_peek(*pending_signals, requested_signals))
+        {
+            yield();
+        }
+        else
+        {
+            do
+            {
+                block_on(blocker);
+            } while (!signal_peek(*pending_signals, requested_signals));
+        }
+
+        received_signals = signal_recv(pending_signals, requested_signals);
+    }
+    postcondition_preemption_disabled();
+
+    return received_signals;
+}
+/*
+ * This uses an exclusive access rather than masking interrupts, so that it does not delay zero-latency interrupts.
+ * Exception entry and return clear the exclusive monitor, so the strexb fails and the loop retries if timer_tick
+ * interrupts it.
+ */
+static uint8_t
+timer_pending_ticks_get_and_clear_atomically(void)
+{
+    uint32_t pending_ticks;
+    uint32_t failed;
+    /* loop bound: retries */
+    do
+    {
+        asm volatile("ldrexb %0, [%1]" : "=r" (pending_ticks) : "r" (&timer_pending_ticks) : "memory");
+        asm volatile("strexb %0, %1, [%2]" : "=&r" (failed) : "r" (0), "r" (&timer_pending_ticks) : "memory");
+    } while (failed);
+    return (uint8_t) pending_ticks;
+}
+{{#timers.length}}
+static void
+timer_process_one(const {{prefix_type}}TimerId timer_id)
+{
+    precondition_preemption_disabled();
+
+    if (timer_is_periodic(timer_id))
+    {
+        timer_expiries[timer_id] += timer_reloads[timer_id];
+    }
+    else
+    {
+        timer_disable(timer_id);
+    }
+
+    if (timer_error_ids[timer_id] != ERROR_ID_NONE)
+    {
+        {{fatal_error}}(timer_error_ids[timer_id]);
+    }
+    else
+    {
+        if (signal_pending(timer_task_ids[timer_id], timer_signal_sets[timer_id]))
+        {
+            timers_overflow[TIMER_WORD(timer_id)] |= TIMER_BIT(timer_id);
+        }
+        signal_send_set(timer_task_ids[timer_id], timer_signal_sets[timer_id]);
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_enable(const {{prefix_type}}TimerId timer_id)
+{
+    precondition_preemption_disabled();
+
+    if (timer_reloads[timer_id] == 0)
+    {
+        timer_process_one(timer_id);
+    }
+    else
+    {
+        timer_expiries[timer_id] = current_timeout() + timer_reloads[timer_id];
+        timers_enabled[TIMER_WORD(timer_id)] |= TIMER_BIT(timer_id);
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static void
+timer_oneshot(const {{prefix_type}}TimerId timer_id, const {{prefix_type}}TicksRelative timeout)
+{
+    precondition_preemption_disabled();
+
+    timer_reload_set(timer_id, timeout);
+    timer_enable(timer_id);
+    timer_reload_set(timer_id, 0);
+
+    postcondition_preemption_disabled();
+}
+{{/timers.length}}
+
+static void
+timer_tick_process(void)
+{
+    precondition_preemption_disabled();
+    {
+        const uint8_t pending_ticks = timer_pending_ticks_get_and_clear_atomically();
+
+        if (pending_ticks > 1)
+        {
+            {{fatal_error}}(ERROR_ID_TICK_OVERFLOW);
+        }
+
+        if (pending_ticks)
+        {
+            {{#timers.length}}
+            {{prefix_type}}TimerId word, timer_id;
+            TimerWord enabled;
+            TicksTimeout timeout;
+            {{/timers.length}}
+
+            {{prefix_func}}timer_current_ticks++;
+{{#periodic_tasks.length}}
+            periodic_release_process();
+{{/periodic_tasks.length}}
+
+            {{#timers.length}}
+            timeout = current_timeout();
+
+            /* loop bound: {{timer_enabled_words.length}} */
+            for (word = 0; word < TIMER_WORDS; word++)
+            {
+                /* Visit the enabled timers of the word, up to the last one */
+                enabled = timers_enabled[word];
+                /* loop bound: 32 */
+                for (timer_id = ({{prefix_type}}TimerId) (word * 32U); enabled != 0; timer_id++, enabled >>= 1)
+                {
+                    if ((enabled & 1U) != 0 && timer_expiries[timer_id] == timeout)
+                    {
+                        timer_process_one(timer_id);
+                    }
+                }
+            }
+            {{/timers.length}}
+        }
+    }
+    postcondition_preemption_disabled();
+}
+{{#periodic_tasks.length}}
+
+/*
+ * Signal the tasks whose next job is released at the current tick.
+ * If a task is still executing an earlier job, the signal remains pending and periodic_wait_next() checks the release
+ * time rather than relying on the number of signals received.
+ */
+static void
+periodic_release_process(void)
+{
+    PeriodicIndex idx;
+    struct periodic_task *periodic;
+
+    precondition_preemption_disabled();
+
+    /* loop bound: {{periodic_tasks.length}} */
+    for (idx = 0; idx <= PERIODIC_INDEX_MAX; idx++)
+    {
+        periodic = &periodic_tasks[idx];
+        if ({{prefix_func}}timer_current_ticks == periodic->release + periodic->period)
+        {
+            signal_send_set(periodic->task_id, periodic->signal_set);
+        }
+    }
+
+    postcondition_preemption_disabled();
+}
+
+static PeriodicIndex
+periodic_index_get(const {{prefix_type}}TaskId task_id)
+{
+    PeriodicIndex idx;
+
+    /* loop bound: {{periodic_tasks.length}} */
+    for (idx = 0; idx <= PERIODIC_INDEX_MAX; idx++)
+    {
+        if (periodic_tasks[idx].task_id == task_id)
+        {
+            return idx;
+        }
+    }
+
+    return PERIODIC_INDEX_NONE;
+}
+
+static void
+periodic_stats_record(const PeriodicIndex idx, const {{prefix_type}}TicksRelative jitter,
+                      const {{prefix_type}}TicksRelative response)
+{
+    {{prefix_type}}PeriodicStats *const stats = &{{prefix_func}}periodic_stats[idx];
+
+    stats->jobs++;
+    if (response > periodic_tasks[idx].deadline)
+    {
+        stats->deadline_misses++;
+    }
+
+    stats->jitter_total += jitter;
+    if (jitter < stats->jitter_min)
+    {
+        stats->jitter_min = jitter;
+    }
+    if (jitter > stats->jitter_max)
+    {
+        stats->jitter_max = jitter;
+    }
+
+    stats->response_total += response;
+    if (response < stats->response_min)
+    {
+        stats->response_min = response;
+    }
+    if (response > stats->response_max)
+    {
+        stats->response_max = response;
+    }
+}
+{{/periodic_tasks.length}}
+static void
+interrupt_event_process(void)
+{
+{{#interrupt_events.length}}
+    uint32_t tmp = interrupt_event;
+    /* loop bound: {{interrupt_events.length}} */
+    while (tmp != 0)
+    {
+        const {{prefix_type}}InterruptEventId i = __builtin_ffs(tmp) - 1;
+        interrupt_event_bitband[i] = 0;
+        interrupt_event_handle(i);
+        tmp &= ~(1U << i);
+    }
+{{/interrupt_events.length}}
+}
+
+static inline bool
+interrupt_application_event_check(void)
+{
+{{#interrupt_events.length}}
+    return interrupt_event != 0;
+{{/interrupt_events.length}}
+{{^interrupt_events.length}}
+    return false;
+{{/interrupt_events.length}}
+}
+
+/*
+ * Waiting for an interrupt event must not mask interrupts, so that the RTOS never delays zero-latency interrupts.
+ * Instead, SEVONPEND makes every interrupt that becomes pending set the event register.
+ * An interrupt that occurs after the check therefore causes the wfe to return immediately rather than being lost.
+ * Spurious returns from wfe are harmless, as the caller checks for interrupt events again.
+ */
+static inline void
+interrupt_event_wait(void)
+{
+    volatile uint32_t *scr = (uint32_t *) SCR_PHYSADDR;
+
+    *scr |= SCR_SEVONPEND;
+    if (!interrupt_event_check())
+    {
+        asm volatile("wfe");
+    }
+}
+RAMFUNC {{prefix_type}}TaskId
+rtos_internal_interrupt_event_get_next(void)
+{
+    TaskIdOption next;
+
+    /* loop bound: {{tasks.length}} + 1 */
+    for (;;)
+    {
+        interrupt_event_process();
+        timer_tick_process();
+        next = sched_get_next();
+
+        if (next == TASK_ID_NONE)
+        {
+            system_is_idle = true;
+            interrupt_event_wait();
+        }
+        else
+        {
+            system_is_idle = false;
+            break;
+        }
+    }
+
+    internal_assert_task_valid(next);
+
+    return next;
+}
+{{#interrupt_events.length}}
+static RAMFUNC void
+interrupt_event_handle(const {{prefix_type}}InterruptEventId interrupt_event_id)
+{
+    precondition_preemption_disabled();
+
+    internal_assert(interrupt_event_id < {{interrupt_events.length}}, ERROR_ID_INTERNAL_INVALID_ID);
+
+#ifdef PREEMPTION_SUPPORT
+    signal_send_set(interrupt_events[interrupt_event_id].task, interrupt_events[interrupt_event_id].sig_set);
+#else
+    {{prefix_func}}signal_send_set(interrupt_events[interrupt_event_id].task,
+            interrupt_events[interrupt_event_id].sig_set);
+#endif
+
+    postcondition_preemption_disabled();
+}
+{{/interrupt_events.length}}
+{{#mutexes.length}}
+static bool
+mutex_try_lock(const {{prefix_type}}MutexId m)
+{
+    const bool r = mutexes[m].holder == TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    if (r)
+    {
+        mutexes[m].holder = get_current_task();
+    }
+
+    postcondition_preemption_disabled();
+
+    return r;
+}
+
+/*
+ * Lock the mutex, blocking the current task while another task holds it.
+ * Returns whether the mutex was contended.
+ */
+static bool
+mutex_acquire(const {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT
+{
+    bool contended = false;
+
+    precondition_preemption_disabled();
+
+    while (!mutex_try_lock(m))
+    {
+        contended = true;
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on(mutexes[m].holder);
+    }
+
+    postcondition_preemption_disabled();
+
+    return contended;
+}
+
+static void
+mutex_release(const {{prefix_type}}MutexId m)
+{
+    {{prefix_type}}TaskId t;
+
+    precondition_preemption_disabled();
+
+
+    /* loop bound: {{tasks.length}} */
+    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+    {
+        if (mutex_waiters[t] == m)
+        {
+            mutex_waiters[t] = MUTEX_ID_NONE;
+            mutex_core_unblock(t);
+        }
+    }
+
+    mutexes[m].holder = TASK_ID_NONE;
+
+    postcondition_preemption_disabled();
+}
+{{#mutex.stats}}
+
+static void
+mutex_stats_update(const {{prefix_type}}MutexId m, const bool contended, const {{prefix_type}}TicksAbsolute
+        wait_start_ticks)
+{
+    if ({{prefix_func}}mutex_stats_enabled) {
+        mutex_stats[m].mutex_lock_counter += 1;
+        if (contended) {
+            {{prefix_type}}TicksRelative wait_time = {{prefix_func}}timer_current_ticks - wait_start_ticks;
+
+            mutex_stats[m].mutex_lock_contended_counter += 1;
+            if (wait_time > mutex_stats[m].mutex_lock_max_wait_time)
+            {
+                mutex_stats[m].mutex_lock_max_wait_time = wait_time;
+            }
+        }
+    }
+}
+{{/mutex.stats}}
+{{/mutexes.length}}
+{{#condition_variables.length}}
+static void
+cond_wake(const {{prefix_type}}CondId cond, const bool all)
+{
+    {{prefix_type}}TaskId t;
+    TaskIdOption waiter = TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    /* loop bound: {{tasks.length}} */
+    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+    {
+        if (cond_waiters[t] == cond)
+        {
+            if (all)
+            {
+                cond_waiters[t] = COND_ID_NONE;
+                cond_core_unblock(t);
+            }
+            else if (waiter == TASK_ID_NONE || cond_core_higher_priority(t, waiter))
+            {
+                waiter = t;
+            }
+        }
+    }
+
+    if (waiter != TASK_ID_NONE)
+    {
+        cond_waiters[waiter] = COND_ID_NONE;
+        cond_core_unblock(waiter);
+    }
+
+    postcondition_preemption_disabled();
+}
+{{/condition_variables.length}}
+static void
+sem_init(void)
+{
+    {{prefix_type}}TaskId t;
+
+    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+    {
+        sem_waiters[t] = SEM_ID_NONE;
+    }
+}
+
+static bool
+internal_sem_try_wait(const {{prefix_type}}SemId s)
+{
+    precondition_preemption_disabled();
+
+    if (semaphores[s].value == SEM_VALUE_ZERO)
+    {
+        return false;
+    }
+    else
+    {
+        semaphores[s].value--;
+        return true;
+    }
+
+    postcondition_preemption_disabled();
+}
+{{#atomics}}
+/*
+ * Atomically replace the value of word with desired if it is equal to expected, and return whether it did.
+ * This is safe to use from both tasks and interrupt handlers without masking interrupts.
+ * Exception entry and return clear the exclusive monitor, so the strex fails and the loop retries if an interrupt
+ * handler runs between the ldrex and the strex.
+ */
+static RAMFUNC bool
+atomic_compare_and_swap(volatile uint32_t *const word, const uint32_t expected, const uint32_t desired)
+{
+    uint32_t value;
+    uint32_t failed;
+
+    /* loop bound: retries */
+    do
+    {
+        asm volatile("ldrex %0, [%1]" : "=r" (value) : "r" (word) : "memory");
+        if (value != expected)
+        {
+            asm volatile("clrex" ::: "memory");
+            return false;
+        }
+        asm volatile("strex %0, %1, [%2]" : "=&r" (failed) : "r" (desired), "r" (word) : "memory");
+    } while (failed);
+
+    return true;
+}
+{{/atomics}}
+{{#pools.length}}
+static void
+pool_init(void)
+{
+    {{prefix_type}}PoolId pool;
+    {{prefix_type}}TaskId t;
+    uint16_t index;
+
+    for (pool = 0; pool < {{pools.length}}; pool++)
+    {
+        for (index = 0; index < pools[pool].block_count; index++)
+        {
+            pool_block_next(pool_block(pool, index)) = index + 1U < pools[pool].block_count ? index + 1U : POOL_BLOCK_NONE;
+        }
+        pool_states[pool].head = 0;
+    }
+
+    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+    {
+        pool_waiters[t] = POOL_ID_NONE;
+    }
+}
+
+static void
+pool_used_add(const {{prefix_type}}PoolId pool, const int32_t delta)
+{
+    struct pool_state *const state = &pool_states[pool];
+    uint32_t used;
+    uint32_t high_water_mark;
+
+    /* loop bound: retries */
+    do
+    {
+        used = state->used;
+    } while (!atomic_compare_and_swap(&state->used, used, used + (uint32_t) delta));
+
+    used += (uint32_t) delta;
+    /* loop bound: retries */
+    do
+    {
+        high_water_mark = state->high_water_mark;
+    } while (used > high_water_mark && !atomic_compare_and_swap(&state->high_water_mark, high_water_mark, used));
+}
+
+static RAMFUNC void *
+pool_try_alloc(const {{prefix_type}}PoolId pool)
+{
+    struct pool_state *const state = &pool_states[pool];
+    uint32_t head;
+    uint16_t index;
+    uint8_t *block;
+
+    /* loop bound: retries */
+    do
+    {
+        head = state->head;
+        index = pool_head_index(head);
+        if (index == POOL_BLOCK_NONE)
+        {
+            return NULL;
+        }
+        block = pool_block(pool, index);
+        /* If another allocation takes the block before the compare-and-swap, next may be garbage, but then the tag of
+         * the head has changed and the compare-and-swap fails. */
+    } while (!atomic_compare_and_swap(&state->head, head, pool_head_next(head, pool_block_next(block))));
+
+    pool_used_add(pool, 1);
+
+    return block;
+}
+{{/pools.length}}
+
+{{#internal_asserts}}
+static {{prefix_type}}TaskId
+get_current_task_check(void)
+{
+    internal_assert(current_task < {{tasks.length}}, ERROR_ID_INTERNAL_CURRENT_TASK_INVALID);
+    return current_task;
+}
+{{/internal_asserts}}
+{{#tasks}}
+static void
+entry_{{name}}(void)
+{
+    precondition_preemption_disabled();
+
+    preempt_enable();
+    {{function}}();
+}
+{{/tasks}}
+
+static void
+block_on(const {{prefix_type}}TaskId blocker)
+{
+    precondition_preemption_disabled();
+
+    sched_set_blocked_on(get_current_task(), blocker);
+    yield();
+
+    postcondition_preemption_disabled();
+}
+
+{{#mutexes.length}}
+
+static void
+mutex_core_block_on_timeout(const {{prefix_type}}TaskId t, const {{prefix_type}}TicksRelative ticks)
+{
+    precondition_preemption_disabled();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    mutex_core_block_on(t);
+    timer_disable(task_timers[get_current_task()]);
+
+    postcondition_preemption_disabled();
+}
+{{/mutexes.length}}
+
+static void
+sem_core_block_timeout(const {{prefix_type}}TicksRelative ticks)
+{
+    precondition_preemption_disabled();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    sem_core_block();
+    timer_disable(task_timers[get_current_task()]);
+
+    postcondition_preemption_disabled();
+}
+
+static RAMFUNC void
+unblock(const {{prefix_type}}TaskId task)
+{
+    precondition_preemption_disabled();
+
+    sched_set_runnable(task);
+
+    /* Note: When preemption is enabled a yield should be forced as a task with an earlier deadline may have been
+     * scheduled. */
+    preempt_pend();
+
+    postcondition_preemption_disabled();
+}
+
+
+
+
+{{prefix_type}}SignalSet
+{{prefix_func}}signal_wait_set(const {{prefix_type}}SignalSet requested_signals) {{prefix_const}}REENTRANT
+{
+    {{prefix_type}}SignalSet received_signals;
+
+    preempt_disable();
+
+    received_signals = signal_wait_set(requested_signals);
+
+    preempt_enable();
+
+    return received_signals;
+}
+
+{{prefix_type}}SignalSet
+{{prefix_func}}signal_poll_set(const {{prefix_type}}SignalSet requested_signals)
+{
+    {{prefix_type}}SignalSet *const pending_signals = &PENDING_SIGNALS(get_current_task());
+    {{prefix_type}}SignalSet received_signals;
+
+    preempt_disable();
+
+    received_signals = signal_recv(pending_signals, requested_signals);
+
+    preempt_enable();
+
+    return received_signals;
+}
+
+{{prefix_type}}SignalSet
+{{prefix_func}}signal_peek_set(const {{prefix_type}}SignalSet requested_signals)
+{
+    const {{prefix_type}}SignalSet pending_signals = PENDING_SIGNALS(get_current_task());
+    return pending_signals & requested_signals;
+}
+
+RAMFUNC void
+{{prefix_func}}signal_send_set(const {{prefix_type}}TaskId task_id, const {{prefix_type}}SignalSet signals)
+{
+    assert_task_valid(task_id);
+
+    preempt_disable();
+
+    signal_send_set(task_id, signals);
+
+    preempt_enable();
+}
+void
+{{prefix_func}}timer_tick(void)
+{
+    if (timer_pending_ticks < 2)
+    {
+        timer_pending_ticks += 1;
+    }
+}
+void
+{{prefix_func}}sleep(const {{prefix_type}}TicksRelative ticks) {{prefix_const}}REENTRANT
+{
+    preempt_disable();
+
+    timer_oneshot(task_timers[get_current_task()], ticks);
+    signal_wait({{prefix_const}}SIGNAL_ID__TASK_TIMER);
+
+    preempt_enable();
+}
+
+{{#timers.length}}
+void
+{{prefix_func}}timer_enable(const {{prefix_type}}TimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_enable(timer_id);
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}timer_disable(const {{prefix_type}}TimerId timer_id)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_disable(timer_id);
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}timer_oneshot(const {{prefix_type}}TimerId timer_id, const {{prefix_type}}TicksRelative timeout)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_oneshot(timer_id, timeout);
+
+    preempt_enable();
+}
+
+bool
+{{prefix_func}}timer_check_overflow(const {{prefix_type}}TimerId timer_id)
+{
+    bool r;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    r = (timers_overflow[TIMER_WORD(timer_id)] & TIMER_BIT(timer_id)) != 0;
+    timers_overflow[TIMER_WORD(timer_id)] &= ~TIMER_BIT(timer_id);
+
+    preempt_enable();
+
+    return r;
+}
+
+{{prefix_type}}TicksRelative
+{{prefix_func}}timer_remaining(const {{prefix_type}}TimerId timer_id)
+{
+    {{prefix_type}}TicksRelative remaining;
+
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    remaining = timer_is_enabled(timer_id) ? timer_expiries[timer_id] - current_timeout() : 0;
+
+    preempt_enable();
+
+    return remaining;
+}
+
+/* Configuration functions */
+void
+{{prefix_func}}timer_reload_set(const {{prefix_type}}TimerId timer_id, const {{prefix_type}}TicksRelative reload)
+{
+    assert_timer_valid(timer_id);
+
+    timer_reload_set(timer_id, reload);
+}
+
+void
+{{prefix_func}}timer_signal_set(const {{prefix_type}}TimerId timer_id, const {{prefix_type}}TaskId task_id, const {{prefix_type}}SignalSet signal_set)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_error_ids[timer_id] = ERROR_ID_NONE;
+    timer_task_ids[timer_id] = task_id;
+    timer_signal_sets[timer_id] = signal_set;
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}timer_error_set(const {{prefix_type}}TimerId timer_id, const {{prefix_type}}ErrorId error_id)
+{
+    assert_timer_valid(timer_id);
+
+    timer_error_ids[timer_id] = error_id;
+}
+{{/timers.length}}
+{{#periodic_tasks.length}}
+
+void
+{{prefix_func}}periodic_wait_next(void) {{prefix_const}}REENTRANT
+{
+    const PeriodicIndex idx = periodic_index_get(get_current_task());
+    struct periodic_task *periodic;
+    {{prefix_type}}TicksAbsolute release;
+
+    api_assert(idx != PERIODIC_INDEX_NONE, ERROR_ID_TIMER_TASK_NOT_PERIODIC);
+    periodic = &periodic_tasks[idx];
+
+    preempt_disable();
+
+    if (periodic->job_active)
+    {
+        periodic_stats_record(idx, periodic->job_jitter,
+                              periodic_ticks_clamp({{prefix_func}}timer_current_ticks - periodic->release));
+    }
+
+    /*
+     * The release time of the current job determines when periodic_release_process() signals the next one, so it
+     * only advances once the next job is released
+     */
+    release = periodic->release + periodic->period;
+    while ((int32_t) ({{prefix_func}}timer_current_ticks - release) < 0)
+    {
+        (void) signal_wait_set(periodic->signal_set);
+    }
+    periodic->release = release;
+
+    periodic->job_jitter = periodic_ticks_clamp({{prefix_func}}timer_current_ticks - release);
+    periodic->job_active = true;
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}periodic_stats_clear(void)
+{
+    PeriodicIndex idx;
+    const {{prefix_type}}PeriodicStats initial_stats = {{prefix_const}}PERIODIC_STATS_INIT;
+
+    preempt_disable();
+
+    /* loop bound: {{periodic_tasks.length}} */
+    for (idx = 0; idx <= PERIODIC_INDEX_MAX; idx++)
+    {
+        {{prefix_func}}periodic_stats[idx] = initial_stats;
+    }
+
+    preempt_enable();
+}
+{{/periodic_tasks.length}}
+{{#interrupt_events.length}}
+void
+{{prefix_func}}interrupt_event_raise(const {{prefix_type}}InterruptEventId interrupt_event_id)
+{
+    interrupt_event_bitband[interrupt_event_id] = 1;
+}
+{{/interrupt_events.length}}
+
+
+{{#mutexes.length}}
+void
+{{prefix_func}}mutex_lock(const {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT
+{
+{{#mutex.stats}}
+    bool contended;
+    const {{prefix_type}}TicksAbsolute wait_start_ticks = {{prefix_func}}timer_current_ticks;
+
+{{/mutex.stats}}
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder != get_current_task(), ERROR_ID_DEADLOCK);
+
+    preempt_disable();
+
+{{#mutex.stats}}
+    contended = mutex_acquire(m);
+{{/mutex.stats}}
+{{^mutex.stats}}
+    (void) mutex_acquire(m);
+{{/mutex.stats}}
+
+    preempt_enable();
+
+{{#mutex.stats}}
+    mutex_stats_update(m, contended, wait_start_ticks);
+{{/mutex.stats}}
+}
+
+bool
+{{prefix_func}}mutex_lock_timeout(const {{prefix_type}}MutexId m, const {{prefix_type}}TicksRelative timeout)
+        {{prefix_const}}REENTRANT
+{
+    bool ret;
+    const {{prefix_type}}TicksAbsolute absolute_timeout = {{prefix_func}}timer_current_ticks + timeout;
+{{#mutex.stats}}
+    bool contended = false;
+
+{{/mutex.stats}}
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder != get_current_task(), ERROR_ID_DEADLOCK);
+
+    preempt_disable();
+
+    ret = mutex_try_lock(m);
+{{#mutex.stats}}
+    if (!ret) {
+        contended = true;
+    }
+{{/mutex.stats}}
+    while (!ret && absolute_timeout > {{prefix_func}}timer_current_ticks) {
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on_timeout(mutexes[m].holder, absolute_timeout - {{prefix_func}}timer_current_ticks);
+        ret = mutex_try_lock(m);
+    }
+
+    preempt_enable();
+
+{{#mutex.stats}}
+    mutex_stats_update(m, contended, absolute_timeout - timeout);
+{{/mutex.stats}}
+
+    return ret;
+}
+
+void
+{{prefix_func}}mutex_unlock(const {{prefix_type}}MutexId m)
+{
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    mutex_release(m);
+
+    preempt_enable();
+}
+
+bool
+{{prefix_func}}mutex_try_lock(const {{prefix_type}}MutexId m)
+{
+    bool r;
+
+    assert_mutex_valid(m);
+
+    preempt_disable();
+
+    r = mutex_try_lock(m);
+
+    preempt_enable();
+
+    return r;
+}
+
+/* A macro implementation would be preferable to eliminate function call overhead when compilers don't support implicit
+ * inlining, but at present this would involve exposing too many implementation internals in the public API header. */
+bool
+{{prefix_func}}mutex_holder_is_current(const {{prefix_type}}MutexId m)
+{
+    assert_mutex_valid(m);
+    return mutexes[m].holder == get_current_task();
+}
+
+{{#mutex.stats}}
+void {{prefix_func}}mutex_stats_clear(void)
+{
+    /* memset would be preferable, but string.h is not available on all platforms */
+    uint8_t mutex_index;
+    /* loop bound: {{mutexes.length}} */
+    for (mutex_index = 0; mutex_index < {{mutexes.length}}; mutex_index += 1)
+    {
+        mutex_stats[mutex_index].mutex_lock_counter = 0;
+        mutex_stats[mutex_index].mutex_lock_contended_counter = 0;
+        mutex_stats[mutex_index].mutex_lock_max_wait_time = 0;
+    }
+}
+{{/mutex.stats}}
+{{/mutexes.length}}
+{{#condition_variables.length}}
+void
+{{prefix_func}}cond_wait(const {{prefix_type}}CondId cond, const {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT
+{
+    assert_cond_valid(cond);
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    /* With preemption disabled, no other task can signal the condition variable between releasing the mutex and
+     * blocking, so the wakeup cannot be lost. */
+    cond_waiters[get_current_task()] = cond;
+    mutex_release(m);
+
+    /* The task may also receive the blocking signal for reasons other than being woken up, e.g., a stale signal of an
+     * earlier timeout, so block until it is actually removed from the waiters. */
+    do
+    {
+        cond_core_block();
+    } while (cond_waiters[get_current_task()] == cond);
+
+    (void) mutex_acquire(m);
+
+    preempt_enable();
+}
+
+bool
+{{prefix_func}}cond_wait_timeout(const {{prefix_type}}CondId cond, const {{prefix_type}}MutexId m,
+                                 const {{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT
+{
+    bool signaled;
+    const {{prefix_type}}TicksAbsolute absolute_timeout = {{prefix_func}}timer_current_ticks + timeout;
+
+    assert_cond_valid(cond);
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    cond_waiters[get_current_task()] = cond;
+    mutex_release(m);
+
+    while (cond_waiters[get_current_task()] == cond && absolute_timeout > {{prefix_func}}timer_current_ticks)
+    {
+        cond_core_block_timeout(absolute_timeout - {{prefix_func}}timer_current_ticks);
+    }
+    signaled = cond_waiters[get_current_task()] != cond;
+    cond_waiters[get_current_task()] = COND_ID_NONE;
+
+    (void) mutex_acquire(m);
+
+    preempt_enable();
+
+    return signaled;
+}
+
+void
+{{prefix_func}}cond_signal(const {{prefix_type}}CondId cond)
+{
+    assert_cond_valid(cond);
+
+    preempt_disable();
+
+    cond_wake(cond, false);
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}cond_broadcast(const {{prefix_type}}CondId cond)
+{
+    assert_cond_valid(cond);
+
+    preempt_disable();
+
+    cond_wake(cond, true);
+
+    preempt_enable();
+}
+{{/condition_variables.length}}
+void
+{{prefix_func}}sem_wait(const {{prefix_type}}SemId s) {{prefix_const}}REENTRANT
+{
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+    while (!internal_sem_try_wait(s))
+    {
+        sem_waiters[get_current_task()] = s;
+        sem_core_block();
+    }
+
+    preempt_enable();
+}
+
+bool
+{{prefix_func}}sem_wait_timeout(const {{prefix_type}}SemId s, const {{prefix_type}}TicksRelative timeout)
+        {{prefix_const}}REENTRANT
+{
+    bool ret;
+    const {{prefix_type}}TicksAbsolute absolute_timeout = {{prefix_func}}timer_current_ticks + timeout;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+    while (!(ret = internal_sem_try_wait(s)) && absolute_timeout > {{prefix_func}}timer_current_ticks) {
+        sem_waiters[get_current_task()] = s;
+        sem_core_block_timeout(absolute_timeout - {{prefix_func}}timer_current_ticks);
+    }
+
+    preempt_enable();
+
+    return ret;
+}
+
+void
+{{prefix_func}}sem_post(const {{prefix_type}}SemId s)
+{
+    {{prefix_type}}TaskId t;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+{{#semaphore_enable_max}}
+    api_assert(semaphores[s].max != SEM_VALUE_ZERO, ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT);
+
+    if (semaphores[s].value >= semaphores[s].max) {
+        {{fatal_error}}(ERROR_ID_SEMAPHORE_MAX_EXCEEDED);
+    }
+{{/semaphore_enable_max}}
+
+    if (semaphores[s].value == SEM_VALUE_ZERO)
+    {
+        /* loop bound: {{tasks.length}} */
+        for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+        {
+            if (sem_waiters[t] == s)
+            {
+                sem_waiters[t] = SEM_ID_NONE;
+                sem_core_unblock(t);
+            }
+        }
+    }
+
+    semaphores[s].value++;
+
+    preempt_enable();
+}
+
+bool
+{{prefix_func}}sem_try_wait(const {{prefix_type}}SemId s)
+{
+    bool r;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+    r = internal_sem_try_wait(s);
+    preempt_enable();
+
+    return r;
+}
+
+{{#semaphore_enable_max}}
+void
+{{prefix_func}}sem_max_init(const {{prefix_type}}SemId s, const {{prefix_type}}SemValue max)
+{
+    assert_sem_valid(s);
+
+    api_assert(max != SEM_VALUE_ZERO, ERROR_ID_SEMAPHORE_MAX_INVALID);
+    api_assert(semaphores[s].max == SEM_VALUE_ZERO, ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT);
+
+    semaphores[s].max = max;
+}
+{{/semaphore_enable_max}}
+
+{{#pools.length}}
+void *
+{{prefix_func}}pool_alloc(const {{prefix_type}}PoolId pool)
+{
+    assert_pool_valid(pool);
+
+    return pool_try_alloc(pool);
+}
+
+void *
+{{prefix_func}}pool_alloc_wait(const {{prefix_type}}PoolId pool) {{prefix_const}}REENTRANT
+{
+    void *block;
+
+    assert_pool_valid(pool);
+
+    preempt_disable();
+
+    while ((block = pool_try_alloc(pool)) == NULL)
+    {
+        pool_waiters[get_current_task()] = pool;
+        sem_core_block();
+    }
+    /* A block freed by an interrupt handler does not make the task runnable, so it may still be a waiter */
+    pool_waiters[get_current_task()] = POOL_ID_NONE;
+
+    preempt_enable();
+
+    return block;
+}
+
+void *
+{{prefix_func}}pool_alloc_timeout(const {{prefix_type}}PoolId pool, const {{prefix_type}}TicksRelative timeout)
+        {{prefix_const}}REENTRANT
+{
+    void *block;
+    const {{prefix_type}}TicksAbsolute absolute_timeout = {{prefix_func}}timer_current_ticks + timeout;
+
+    assert_pool_valid(pool);
+
+    preempt_disable();
+
+    while ((block = pool_try_alloc(pool)) == NULL && absolute_timeout > {{prefix_func}}timer_current_ticks)
+    {
+        pool_waiters[get_current_task()] = pool;
+        sem_core_block_timeout(absolute_timeout - {{prefix_func}}timer_current_ticks);
+    }
+    pool_waiters[get_current_task()] = POOL_ID_NONE;
+
+    preempt_enable();
+
+    return block;
+}
+
+void
+{{prefix_func}}pool_free(const {{prefix_type}}PoolId pool, void *const block)
+{
+    {{prefix_type}}TaskId t;
+
+    {{prefix_func}}pool_free_from_interrupt(pool, block);
+
+    preempt_disable();
+
+    /* loop bound: {{tasks.length}} */
+    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+    {
+        if (pool_waiters[t] == pool)
+        {
+            pool_waiters[t] = POOL_ID_NONE;
+            sem_core_unblock(t);
+        }
+    }
+
+    preempt_enable();
+}
+
+/*
+ * Interrupt handlers must not unblock tasks, so tasks waiting for a block of the pool only notice a block freed by an
+ * interrupt handler when a task frees a block or their timeout expires.
+ */
+void
+{{prefix_func}}pool_free_from_interrupt(const {{prefix_type}}PoolId pool, void *const block)
+{
+    struct pool_state *state;
+    uint32_t offset;
+    uint16_t index;
+    uint32_t head;
+
+    assert_pool_valid(pool);
+    api_assert((uint8_t *) block >= pools[pool].storage, ERROR_ID_POOL_INVALID_BLOCK);
+
+    state = &pool_states[pool];
+    offset = (uint32_t) ((uint8_t *) block - pools[pool].storage);
+    index = (uint16_t) (offset / pools[pool].block_stride);
+    api_assert(offset % pools[pool].block_stride == 0 && offset / pools[pool].block_stride < pools[pool].block_count,
+               ERROR_ID_POOL_INVALID_BLOCK);
+    /* A block that is freed twice without being allocated in between is detected if it is still the first free block,
+     * or if no block of the pool is allocated. */
+    api_assert(pool_head_index(state->head) != index && state->used != 0, ERROR_ID_POOL_INVALID_BLOCK);
+
+    /* loop bound: retries */
+    do
+    {
+        head = state->head;
+        pool_block_next(block) = pool_head_index(head);
+    } while (!atomic_compare_and_swap(&state->head, head, pool_head_next(head, index)));
+
+    pool_used_add(pool, -1);
+}
+
+uint16_t
+{{prefix_func}}pool_high_water_mark(const {{prefix_type}}PoolId pool)
+{
+    assert_pool_valid(pool);
+
+    return (uint16_t) pool_states[pool].high_water_mark;
+}
+{{/pools.length}}
+
+{{prefix_type}}TaskId
+{{prefix_func}}task_current(void)
+{
+    return get_current_task();
+}
+void
+{{prefix_func}}start(void)
+{
+    sem_init();
+    preempt_init();
+
+    {{#tasks}}
+    context_init(get_task_context({{idx}}), entry_{{name}}, stack_{{idx}}, {{stack_size}});
+    task_releases[{{idx}}] = {{prefix_func}}timer_current_ticks;
+    sched_set_deadline({{idx}}, {{prefix_func}}timer_current_ticks + {{deadline}});
+    sched_set_runnable({{idx}});
+    {{/tasks}}
+{{#pools.length}}
+
+    pool_init();
+{{/pools.length}}
+
+    context_switch_first(sched_get_next());
+}
+
+void
+{{prefix_func}}release_wait(void)
+{
+    const {{prefix_type}}TaskId task = get_current_task();
+
+    api_assert(task_periods[task] != 0, ERROR_ID_SCHED_EDF_TASK_NOT_PERIODIC);
+
+    preempt_disable();
+
+    /* The deadline of the next job is set before waiting for its release.
+     * If the release has already happened, the task continues with the later deadline, so a task with an earlier
+     * deadline may need to be scheduled instead. */
+    task_releases[task] += task_periods[task];
+    sched_set_deadline(task, task_releases[task] + task_deadlines[task]);
+    preempt_pend();
+    signal_wait({{prefix_const}}SIGNAL_ID__TASK_RELEASE);
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}deadline_set(const {{prefix_type}}TicksRelative deadline)
+{
+    preempt_disable();
+
+    sched_set_deadline(get_current_task(), {{prefix_func}}timer_current_ticks + deadline);
+    preempt_pend();
+
+    preempt_enable();
+}
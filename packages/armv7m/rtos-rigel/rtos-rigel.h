@@ -0,0 +1,257 @@
+#ifndef RTOS_RIGEL_H
+#define RTOS_RIGEL_H
+
+
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <stdint.h>
+
+{{#interrupt_events.length}}
+#include <stdint.h>
+{{/interrupt_events.length}}
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+
+
+
+
+
+
+typedef uint{{signalset_size}}_t {{prefix_type}}SignalSet;
+typedef {{prefix_type}}SignalSet {{prefix_type}}SignalId;
+
+typedef uint{{timerid_size}}_t {{prefix_type}}TimerId;
+typedef uint32_t {{prefix_type}}TicksAbsolute;
+typedef uint{{ticksrelative_size}}_t {{prefix_type}}TicksRelative;
+
+{{#interrupt_events.length}}
+typedef uint{{interrupteventid_size}}_t {{prefix_type}}InterruptEventId;
+{{/interrupt_events.length}}
+
+typedef uint8_t {{prefix_type}}MutexId;
+
+typedef uint8_t {{prefix_type}}MessageQueueId;
+typedef uint8_t {{prefix_type}}BroadcastId;
+typedef uint8_t {{prefix_type}}ErrorId;
+typedef uint{{taskid_size}}_t {{prefix_type}}TaskId;
+
+
+
+
+
+
+
+
+{{#periodic_tasks.length}}
+/* The timing statistics of the completed jobs of a periodic task, in ticks.
+ * The averages are the totals divided by the number of jobs. */
+typedef struct {
+    uint32_t jobs;
+    uint32_t deadline_misses;
+    uint32_t jitter_total;
+    uint32_t response_total;
+    {{prefix_type}}TicksRelative jitter_min;
+    {{prefix_type}}TicksRelative jitter_max;
+    {{prefix_type}}TicksRelative response_min;
+    {{prefix_type}}TicksRelative response_max;
+} {{prefix_type}}PeriodicStats;
+{{/periodic_tasks.length}}
+
+
+
+
+
+
+
+
+
+
+#define {{prefix_const}}REENTRANT {{reentrant}}
+
+
+
+
+#define {{prefix_const}}SIGNAL_SET_EMPTY (({{prefix_type}}SignalSet) UINT{{signalset_size}}_C(0))
+#define {{prefix_const}}SIGNAL_SET_ALL (({{prefix_type}}SignalSet) UINT{{signalset_size}}_MAX)
+{{#signal_sets}}
+#define {{prefix_const}}SIGNAL_SET_{{name|u}} (({{prefix_type}}SignalSet) UINT{{signalset_size}}_C({{value}}))
+{{#singleton}}#define {{prefix_const}}SIGNAL_ID_{{name|u}} (({{prefix_type}}SignalId) {{prefix_const}}SIGNAL_SET_{{name|u}}){{/singleton}}
+{{/signal_sets}}
+
+{{#timers}}
+#define {{prefix_const}}TIMER_ID_{{name|u}} (({{prefix_type}}TimerId) UINT{{timerid_size}}_C({{idx}}))
+{{/timers}}
+
+{{#periodic_tasks.length}}
+#define {{prefix_const}}PERIODIC_STATS_INIT \
+    { 0, 0, 0, 0, UINT{{ticksrelative_size}}_MAX, 0, UINT{{ticksrelative_size}}_MAX, 0 }
+{{/periodic_tasks.length}}
+
+{{#interrupt_events}}
+#define {{prefix_const}}INTERRUPT_EVENT_ID_{{name|u}} (({{prefix_type}}InterruptEventId) UINT{{interrupteventid_size}}_C({{idx}}))
+{{/interrupt_events}}
+
+{{#mutexes.length}}
+#define {{prefix_const}}MUTEX_ID_ZERO (({{prefix_type}}MutexId) UINT8_C(0))
+#define {{prefix_const}}MUTEX_ID_MAX (({{prefix_type}}MutexId) UINT8_C({{mutexes.length}} - 1))
+{{#mutexes}}
+#define {{prefix_const}}MUTEX_ID_{{name|u}} (({{prefix_type}}MutexId) UINT8_C({{idx}}))
+{{/mutexes}}
+{{/mutexes.length}}
+
+{{#message_queues}}
+#define {{prefix_const}}MESSAGE_QUEUE_ID_{{name|u}} (({{prefix_type}}MessageQueueId) UINT8_C({{idx}}))
+{{/message_queues}}
+{{#broadcasts}}
+#define {{prefix_const}}BROADCAST_ID_{{name|u}} (({{prefix_type}}BroadcastId) UINT8_C({{idx}}))
+{{/broadcasts}}
+
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT{{taskid_size}}_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT{{taskid_size}}_C({{tasks.length}} - 1))
+{{#tasks}}
+#define {{prefix_const}}TASK_ID_{{name|u}} (({{prefix_type}}TaskId) UINT{{taskid_size}}_C({{idx}}))
+{{/tasks}}
+
+
+
+
+
+
+#define {{prefix_func}}signal_wait(requested_signal) \
+    (void) {{prefix_func}}signal_wait_set(requested_signal)
+
+#define {{prefix_func}}signal_poll(requested_signal) \
+    ({{prefix_func}}signal_poll_set(requested_signal) != {{prefix_const}}SIGNAL_SET_EMPTY)
+
+#define {{prefix_func}}signal_peek(requested_signal) \
+    ({{prefix_func}}signal_peek_set(requested_signal) != {{prefix_const}}SIGNAL_SET_EMPTY)
+
+#define {{prefix_func}}signal_send(task_id, signal) \
+    {{prefix_func}}signal_send_set(task_id, signal)
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+extern {{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+{{#periodic_tasks.length}}
+extern {{prefix_type}}PeriodicStats {{prefix_func}}periodic_stats[{{periodic_tasks.length}}];
+{{/periodic_tasks.length}}
+
+
+
+{{#mutex.stats}}
+extern bool {{prefix_func}}mutex_stats_enabled;
+{{/mutex.stats}}
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+
+
+{{prefix_type}}SignalSet {{prefix_func}}signal_wait_set({{prefix_type}}SignalSet requested_signals) {{prefix_const}}REENTRANT;
+{{prefix_type}}SignalSet {{prefix_func}}signal_poll_set({{prefix_type}}SignalSet requested_signals);
+{{prefix_type}}SignalSet {{prefix_func}}signal_peek_set({{prefix_type}}SignalSet requested_signals);
+void {{prefix_func}}signal_send_set({{prefix_type}}TaskId task_id, {{prefix_type}}SignalSet signals);
+void {{prefix_func}}timer_tick(void);
+void {{prefix_func}}sleep({{prefix_type}}TicksRelative ticks) {{prefix_const}}REENTRANT;
+{{#timers.length}}
+void {{prefix_func}}timer_enable({{prefix_type}}TimerId timer_id);
+void {{prefix_func}}timer_disable({{prefix_type}}TimerId timer_id);
+void {{prefix_func}}timer_oneshot({{prefix_type}}TimerId timer_id, {{prefix_type}}TicksRelative timeout);
+bool {{prefix_func}}timer_check_overflow({{prefix_type}}TimerId timer_id);
+{{prefix_type}}TicksRelative {{prefix_func}}timer_remaining({{prefix_type}}TimerId timer_id);
+void {{prefix_func}}timer_reload_set({{prefix_type}}TimerId timer_id, {{prefix_type}}TicksRelative reload);
+void {{prefix_func}}timer_error_set({{prefix_type}}TimerId timer_id, {{prefix_type}}ErrorId error_id);
+void {{prefix_func}}timer_signal_set({{prefix_type}}TimerId timer_id, {{prefix_type}}TaskId task_id, {{prefix_type}}SignalSet signal_set);
+{{/timers.length}}
+{{#periodic_tasks.length}}
+void {{prefix_func}}periodic_wait_next(void) {{prefix_const}}REENTRANT;
+void {{prefix_func}}periodic_stats_clear(void);
+{{/periodic_tasks.length}}
+{{#interrupt_events.length}}
+void {{prefix_func}}interrupt_event_raise({{prefix_type}}InterruptEventId event);
+{{/interrupt_events.length}}
+
+{{#interrupt_events.length}}
+void {{prefix_func}}interrupt_event_task_set({{prefix_type}}InterruptEventId interrupt_event_id, {{prefix_type}}TaskId task_id);
+{{/interrupt_events.length}}
+
+{{#mutexes.length}}
+void {{prefix_func}}mutex_lock({{prefix_type}}MutexId) {{prefix_const}}REENTRANT;
+bool {{prefix_func}}mutex_try_lock({{prefix_type}}MutexId);
+void {{prefix_func}}mutex_unlock({{prefix_type}}MutexId);
+bool {{prefix_func}}mutex_holder_is_current({{prefix_type}}MutexId);
+{{#mutex.stats}}
+void {{prefix_func}}mutex_stats_clear(void);
+{{/mutex.stats}}
+{{/mutexes.length}}
+{{#profiling}}
+
+void {{prefix_func}}profiling_record_sample(void);
+
+{{/profiling}}
+{{#message_queues.length}}
+void {{prefix_func}}message_queue_put({{prefix_type}}MessageQueueId message_queue, const void *message)
+        {{prefix_const}}REENTRANT;
+bool {{prefix_func}}message_queue_try_put({{prefix_type}}MessageQueueId message_queue, const void *message);
+bool {{prefix_func}}message_queue_put_timeout({{prefix_type}}MessageQueueId message_queue, const void *message,
+                                              {{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT;
+void {{prefix_func}}message_queue_get({{prefix_type}}MessageQueueId message_queue, void *message)
+        {{prefix_const}}REENTRANT;
+bool {{prefix_func}}message_queue_try_get({{prefix_type}}MessageQueueId message_queue, void *message);
+bool {{prefix_func}}message_queue_get_timeout({{prefix_type}}MessageQueueId message_queue, void *message,
+                                              {{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT;
+
+{{/message_queues.length}}
+{{#broadcasts.length}}
+void {{prefix_func}}broadcast_publish({{prefix_type}}BroadcastId broadcast, const void *record);
+bool {{prefix_func}}broadcast_try_get({{prefix_type}}BroadcastId broadcast, void *record);
+void {{prefix_func}}broadcast_get({{prefix_type}}BroadcastId broadcast, void *record) {{prefix_const}}REENTRANT;
+uint32_t {{prefix_func}}broadcast_lost({{prefix_type}}BroadcastId broadcast);
+
+{{/broadcasts.length}}
+
+{{prefix_type}}TaskId {{prefix_func}}task_current(void);
+void {{prefix_func}}start(void);
+void {{prefix_func}}yield(void) {{prefix_const}}REENTRANT;
+void {{prefix_func}}task_start({{prefix_type}}TaskId task);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_RIGEL_H */
\ No newline at end of file
@@ -25,7 +25,8 @@
 # @TAG(NICTA_AGPL)
 #
 
-from prj import SystemBuildError, Module, ModuleInstance, pystache_render, xml2dict, xml2schema, xml_parse_string
+from prj import SystemBuildError, SystemParseError, Module, ModuleInstance, pystache_render, xml2dict, xml2schema, \
+    xml_error_str, xml_parse_string
 import logging
 import os
 import ply.cpp
@@ -45,6 +46,10 @@ class EntryModule(Module):
     <entry name="bitband_base" type="int" default="0x20000000" />
     <entry name="bitband_size" type="int" default="0x100000" />
     <entry name="bitband_alias" type="int" default="0x22000000" />
+    <entry name="ramfunc" type="bool" default="false" />
+    <entry name="ram_vector_table" type="bool" default="false" />
+    <entry name="priority_bits" type="int" default="4" />
+    <entry name="kernel_priority_threshold" type="int" default="0" />
 
     <entry name="preemption" type="bool" optional="true" default="false" />
 
@@ -57,10 +62,12 @@ class EntryModule(Module):
     <entry name="debug_monitor" type="c_ident" default="reset" />
     <entry name="pendsv" type="c_ident" optional="true" />
     <entry name="systick" type="c_ident" default="reset" />
+    <entry name="systick_priority" type="int" optional="true" />
     <entry name="external_irqs" type="list" default="[]">
         <entry name="external_irq" type="dict">
           <entry name="number" type="int"/>
           <entry name="handler" type="c_ident" default="reset" />
+          <entry name="priority" type="int" optional="true" />
         </entry>
     </entry>
 </schema>"""
@@ -71,12 +78,21 @@ class EntryModule(Module):
         {'input': 'default.ld', 'render': True, 'type': 'linker_script', 'stage': 'post_prepare'},
     ]
 
+    # The priority values that the armv7m.ctxt-switch-preempt module assigns to the SVCall and PendSV exceptions.
+    svcall_priority = 224
+    pendsv_priority = 240
+    # Exception handlers with this prefix are generated by the armv7m.exception-preempt module and call into the RTOS.
+    trampoline_prefix = 'exception_preempt_trampoline_'
+    nvic_ipr_base = 0xe000e400
+    systick_priority_address = 0xe000ed23
+
     def configure(self, xml_config):
         config = {}
         config['external_irqs'] = []
         config['bit_aliases'] = []  # A list of variables that should have bitband aliases created.
 
         config.update(super().configure(xml_config))
+        config['nvic_priorities'] = self._check_priorities(xml_config, config)
         # Fill in external IRQ vector list
         xirqs = [{'handler':'reset'}] * 240
         for xirq in config['external_irqs']:
@@ -85,6 +101,62 @@ class EntryModule(Module):
 
         return config
 
+    def _check_priorities(self, xml_config, config):
+        """Validate the configured exception priorities against the kernel priority threshold.
+
+        Exceptions whose priority is numerically below the threshold are zero-latency interrupts: the RTOS never masks
+        them, but their handlers must not call any RTOS API.
+        All other exceptions are kernel-aware.
+        On preemptive systems, they must be able to preempt the SVCall exception, in whose context the RTOS waits for
+        interrupt events.
+
+        Returns the list of priority registers that the entry function programs.
+
+        """
+        def error(msg):
+            raise SystemParseError(xml_error_str(xml_config, msg))
+
+        bits = config['priority_bits']
+        if not 3 <= bits <= 8:
+            error("priority_bits must be between 3 and 8, not {}".format(bits))
+        # Priority registers ignore the low (8 - priority_bits) bits of a value
+        mask = (0xff << (8 - bits)) & 0xff
+        if config['preemption'] and self.svcall_priority & mask == self.pendsv_priority & mask:
+            error("preemption requires distinct SVCall and PendSV priorities, which {} priority bits do not "
+                  "provide".format(bits))
+
+        threshold = config['kernel_priority_threshold']
+        if not 0 <= threshold < self.svcall_priority or threshold & ~mask:
+            error("kernel_priority_threshold {} is not a priority value below the SVCall priority ({}) that the "
+                  "hardware implements with {} priority bits".format(threshold, self.svcall_priority, bits))
+
+        exceptions = [('systick', config['systick'], config['systick_priority'], self.systick_priority_address)]
+        for xirq in config['external_irqs']:
+            if not 0 <= xirq['number'] < 240:
+                error("external IRQ number {} is out of range".format(xirq['number']))
+            exceptions.append(('IRQ {}'.format(xirq['number']), xirq['handler'], xirq['priority'],
+                               self.nvic_ipr_base + xirq['number']))
+
+        nvic_priorities = []
+        for name, handler, priority, address in exceptions:
+            if priority is not None:
+                if not 0 <= priority <= 0xff:
+                    error("the priority {} of {} is out of range".format(priority, name))
+                nvic_priorities.append({'address': '0x{:08x}'.format(address), 'priority': priority & mask})
+            if handler == 'reset':
+                continue
+            # Exceptions without a configured priority keep their reset priority of 0
+            effective = (priority or 0) & mask
+            if effective < threshold:
+                if handler.startswith(self.trampoline_prefix):
+                    error("{} is a zero-latency interrupt (priority {} is below the kernel priority threshold {}), "
+                          "so its handler {} must not call into the RTOS".format(name, effective, threshold, handler))
+            elif config['preemption'] and effective >= self.svcall_priority:
+                error("{} is a kernel-aware interrupt, so its priority {} must be below the SVCall priority "
+                      "{}".format(name, effective, self.svcall_priority))
+
+        return nvic_priorities
+
     def post_prepare(self, system, config):
         # Now find all the BITBAND variables in all the c_files.
         def cb(macro_name, expanded_args):
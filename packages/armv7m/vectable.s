@@ -30,6 +30,7 @@
 /* See ARMv7M Architecture Reference Manual */
 .set reset_register, 0xe000ed0c
 .set reset_value, 0x05fa0004
+.set vtor_register, 0xe000ed08
 
 .section .vectors, "a"
 .global vector_table
@@ -97,6 +98,9 @@ reset:
 The entry function initialises the C run-time and then jumps to main. (Which should never return!)
 
 Specifically, this loads the .data section from flash in to SRAM, and then zeros the .bss section.
+The .data section includes any code placed in SRAM through the .ramfunc section.
+If configured, it also copies the vector table to SRAM and relocates VTOR to that copy.
+Finally, it assigns the configured priorities of the SysTick exception and the external IRQs.
 */
 .type entry,#function
 entry:
@@ -120,6 +124,32 @@ entry:
         subs r2, #4
         b 1b
 2:
+{{#ram_vector_table}}
+
+        /* Copy the vector table to SRAM */
+        ldr r0, =vector_table
+        ldr r1, =ram_vector_table
+        ldr r2, =vector_table_size
+1:      cbz r2, 2f
+        ldm r0!, {r3}
+        stm r1!, {r3}
+        sub r2, #4
+        b 1b
+2:
+
+        /* Relocate the vector table; the barriers ensure that subsequent exceptions use the new table */
+        ldr r0, =vtor_register
+        ldr r1, =ram_vector_table
+        str r1, [r0]
+        dsb
+        isb
+{{/ram_vector_table}}
+{{#nvic_priorities}}
+
+        ldr r0, ={{address}}
+        mov r1, #{{priority}}
+        strb r1, [r0]
+{{/nvic_priorities}}
 
         b main
 .size entry, .-entry
@@ -0,0 +1,392 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+/*
+ * Host test for the flash update module of StellarisWare (utils/flashupdate.c).
+ *
+ * The flash is modelled by a memory mapping in the low 4 GiB of the address space, so that its addresses fit in the
+ * 32-bit longs that the module uses.  Erasing a page sets it to 0xff and programming can only clear bits, as on the
+ * device.  Images are streamed through the TFTP glue of the module, with the low priority task that programs the flash
+ * (FlashUpdateService) run at random between blocks, so that the page buffers fill and the TFTP acknowledgements are
+ * withheld and resumed.  The test checks that good images are verified and swapped into the active region (including
+ * after a reset during the swap), and that truncated, corrupted, aborted and oversized images are rejected without
+ * touching the active region.
+ *
+ * StellarisWare assumes that long is 32 bits wide, so the module is built with long defined as int (see
+ * flashupdate-test.sh).  The same definition is applied below, after the system headers have been included.
+ */
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define long int
+
+#include "inc/hw_types.h"
+#include "driverlib/flash.h"
+#include "utils/crc.h"
+#include "utils/tftp.h"
+#include "utils/flashupdate.h"
+
+#define PAGE_SIZE FLASH_UPDATE_PAGE_SIZE
+#define REGION_SIZE (16 * PAGE_SIZE)
+#define FLASH_SIZE (2 * REGION_SIZE)
+#define MAX_IMAGE (REGION_SIZE - PAGE_SIZE)
+#define NUM_RUNS 200
+
+/* The state of the simulated flash and of the TFTP connection. */
+static struct
+{
+    unsigned char *pucFlash;
+    unsigned long ulErases;
+    unsigned long ulPrograms;
+    unsigned long ulEraseLimit;
+    jmp_buf sReset;
+    tBoolean bCorrupt;
+
+    unsigned long ulResumes;
+    unsigned long ulBusy;
+    unsigned long ulRandom;
+} g_sSim;
+
+static void
+SimFail(const char *pcMessage)
+{
+    fprintf(stderr, "FAIL: %s\n", pcMessage);
+    exit(1);
+}
+
+static unsigned long
+SimRandom(void)
+{
+    g_sSim.ulRandom = g_sSim.ulRandom * 1103515245 + 12345;
+    return (g_sSim.ulRandom >> 16) & 0x7fff;
+}
+
+static unsigned char *
+SimFlashCheck(unsigned long ulAddress, unsigned long ulCount)
+{
+    unsigned char *pucAddress = (unsigned char *)(size_t)(unsigned)ulAddress;
+
+    if ((pucAddress < g_sSim.pucFlash) || ((pucAddress + ulCount) > (g_sSim.pucFlash + FLASH_SIZE)))
+    {
+        SimFail("flash access out of range");
+    }
+    return pucAddress;
+}
+
+long
+FlashErase(unsigned long ulAddress)
+{
+    unsigned char *pucAddress = SimFlashCheck(ulAddress, PAGE_SIZE);
+
+    if (ulAddress & (PAGE_SIZE - 1))
+    {
+        SimFail("erase of an unaligned page");
+    }
+
+    /* Simulate a reset part way through the erase. */
+    if (g_sSim.ulEraseLimit && (--g_sSim.ulEraseLimit == 0))
+    {
+        memset(pucAddress, 0xff, PAGE_SIZE / 2);
+        longjmp(g_sSim.sReset, 1);
+    }
+
+    memset(pucAddress, 0xff, PAGE_SIZE);
+    g_sSim.ulErases++;
+    return 0;
+}
+
+long
+FlashProgram(unsigned long *pulData, unsigned long ulAddress, unsigned long ulCount)
+{
+    unsigned char *pucAddress = SimFlashCheck(ulAddress, ulCount);
+    unsigned char *pucData = (unsigned char *)pulData;
+    unsigned long ulIdx;
+
+    if ((ulAddress & 3) || (ulCount & 3))
+    {
+        SimFail("program of an unaligned word");
+    }
+    for (ulIdx = 0; ulIdx < ulCount; ulIdx++)
+    {
+        pucAddress[ulIdx] &= pucData[ulIdx];
+    }
+
+    /* Simulate a bit that fails to program. */
+    if (g_sSim.bCorrupt && ulCount == PAGE_SIZE)
+    {
+        pucAddress[SimRandom() % PAGE_SIZE] ^= 0x10;
+        g_sSim.bCorrupt = false;
+    }
+
+    g_sSim.ulPrograms++;
+    return 0;
+}
+
+void
+TFTPDataResume(tTFTPConnection *psTFTP)
+{
+    if (!psTFTP->bAckDeferred)
+    {
+        SimFail("resume without a withheld acknowledgement");
+    }
+    psTFTP->bAckDeferred = false;
+    g_sSim.ulResumes++;
+}
+
+/* The kinds of stream that the test sends. */
+typedef enum
+{
+    STREAM_GOOD,
+    STREAM_BAD_TRAILER,
+    STREAM_CORRUPT_FLASH,
+    STREAM_TRUNCATED,
+    STREAM_ABORTED,
+    STREAM_OVERSIZE
+} tStream;
+
+/*
+ * Send a stream through the TFTP glue, running the flash task at random between blocks as a low priority task would.
+ * Returns the final state of the update.
+ */
+static tFlashUpdateStatus
+SendStream(const unsigned char *pucStream, unsigned long ulLength, unsigned long ulBlockSize,
+           unsigned long ulWindowSize, tBoolean bComplete, tTFTPError *peError)
+{
+    tTFTPConnection sTFTP;
+    unsigned long ulOffset, ulBlock, ulSplit;
+    tTFTPError eRetcode = TFTP_OK;
+
+    memset(&sTFTP, 0, sizeof(sTFTP));
+    sTFTP.ulBlockSize = ulBlockSize;
+    sTFTP.ulWindowSize = ulWindowSize;
+    if (FlashUpdateTFTPStart(&sTFTP) != TFTP_OK)
+    {
+        SimFail("could not start the update");
+    }
+    if ((sTFTP.ulBlockSize > PAGE_SIZE) ||
+        ((sTFTP.ulWindowSize > 1) &&
+         (sTFTP.ulWindowSize * sTFTP.ulBlockSize > (FLASH_UPDATE_BUFFERS - 1) * PAGE_SIZE)))
+    {
+        SimFail("block size or window size not limited");
+    }
+    if (FlashUpdateStart())
+    {
+        SimFail("second update started");
+    }
+
+    /* Send the blocks, in up to two pbufs each.  A block of the stream that is one block size long is followed by an
+     * empty block, as TFTP requires. */
+    for (ulOffset = 0; ulOffset <= ulLength; )
+    {
+        ulBlock = ulLength - ulOffset;
+        if (ulBlock > sTFTP.ulBlockSize)
+        {
+            ulBlock = sTFTP.ulBlockSize;
+        }
+
+        while ((SimRandom() % 3) == 0)
+        {
+            FlashUpdateService();
+        }
+        FlashUpdateTFTPPoll();
+        if (sTFTP.bAckDeferred)
+        {
+            /* The client waits for the acknowledgement before sending more. */
+            FlashUpdateService();
+            continue;
+        }
+
+        ulSplit = ulBlock ? (SimRandom() % (ulBlock + 1)) : 0;
+        sTFTP.ulDataRemaining = 0;
+        sTFTP.pucData = (unsigned char *)pucStream + ulOffset;
+        sTFTP.ulDataLength = ulSplit;
+        eRetcode = sTFTP.pfnPutData(&sTFTP);
+        if (eRetcode == TFTP_BUSY)
+        {
+            /* The TFTP server discards the block and withholds the acknowledgement. */
+            g_sSim.ulBusy++;
+            sTFTP.bAckDeferred = true;
+            continue;
+        }
+        if ((eRetcode == TFTP_OK) && (ulSplit < ulBlock))
+        {
+            sTFTP.ulDataRemaining = ulSplit;
+            sTFTP.pucData = (unsigned char *)pucStream + ulOffset + ulSplit;
+            sTFTP.ulDataLength = ulBlock - ulSplit;
+            eRetcode = sTFTP.pfnPutData(&sTFTP);
+            if (eRetcode == TFTP_BUSY)
+            {
+                SimFail("busy part way through a block");
+            }
+        }
+        if (eRetcode != TFTP_OK)
+        {
+            break;
+        }
+
+        ulOffset += ulBlock;
+        if (ulBlock < sTFTP.ulBlockSize)
+        {
+            break;
+        }
+    }
+
+    *peError = eRetcode;
+    sTFTP.bComplete = bComplete && (eRetcode == TFTP_OK);
+    sTFTP.pfnClose(&sTFTP);
+
+    while (FlashUpdateService())
+    {
+    }
+    return FlashUpdateStatusGet();
+}
+
+static void
+CheckActive(const unsigned char *pucImage, unsigned long ulLength, const char *pcMessage)
+{
+    if (memcmp(g_sSim.pucFlash, pucImage, ulLength))
+    {
+        SimFail(pcMessage);
+    }
+}
+
+int
+main(void)
+{
+    static unsigned char pucStream[REGION_SIZE + 8];
+    static unsigned char pucActive[REGION_SIZE];
+    static const unsigned long pulBlockSizes[] = { 512, 1024, 1428, 256, 100 };
+    unsigned long ulRun, ulLength, ulIdx, ulCrc, ulSwaps = 0, ulResets = 0, ulRejected = 0;
+    tStream eStream;
+    tFlashUpdateStatus eStatus;
+    tTFTPError eError;
+
+    g_sSim.pucFlash = mmap(NULL, FLASH_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+    if (g_sSim.pucFlash == MAP_FAILED)
+    {
+        SimFail("could not map the flash");
+    }
+    memset(g_sSim.pucFlash, 0xff, FLASH_SIZE);
+    g_sSim.ulRandom = 1;
+
+    FlashUpdateInit((unsigned long)(size_t)g_sSim.pucFlash, (unsigned long)(size_t)(g_sSim.pucFlash + REGION_SIZE),
+                    REGION_SIZE, NULL);
+    if (FlashUpdateSwap())
+    {
+        SimFail("swap of an erased staging region");
+    }
+    memcpy(pucActive, g_sSim.pucFlash, REGION_SIZE);
+
+    for (ulRun = 0; ulRun < NUM_RUNS; ulRun++)
+    {
+        eStream = (ulRun % 4) ? STREAM_GOOD : (tStream)(1 + (ulRun / 4) % 5);
+        ulLength = 1 + SimRandom() % MAX_IMAGE;
+        if ((ulRun % 16) == 1)
+        {
+            ulLength = MAX_IMAGE;
+        }
+        if (eStream == STREAM_OVERSIZE)
+        {
+            ulLength = MAX_IMAGE + 1 + SimRandom() % PAGE_SIZE;
+        }
+        for (ulIdx = 0; ulIdx < ulLength; ulIdx++)
+        {
+            pucStream[ulIdx] = SimRandom();
+        }
+        ulCrc = Crc32(0xffffffff, pucStream, ulLength) ^ 0xffffffff;
+        if (eStream == STREAM_BAD_TRAILER)
+        {
+            ulCrc ^= 1 << (SimRandom() % 32);
+        }
+        for (ulIdx = 0; ulIdx < 4; ulIdx++)
+        {
+            pucStream[ulLength + ulIdx] = ulCrc >> (8 * ulIdx);
+        }
+        g_sSim.bCorrupt = (eStream == STREAM_CORRUPT_FLASH);
+
+        eStatus = SendStream(pucStream, ulLength + ((eStream == STREAM_TRUNCATED) ? 2 : 4),
+                             pulBlockSizes[ulRun % 5], 1 + SimRandom() % 8, eStream != STREAM_ABORTED, &eError);
+
+        if (eStream != STREAM_GOOD)
+        {
+            if (eStatus != FLASH_UPDATE_FAILED)
+            {
+                SimFail("bad stream not rejected");
+            }
+            if ((eStream == STREAM_OVERSIZE) && (eError != TFTP_DISK_FULL))
+            {
+                SimFail("oversize image not reported");
+            }
+            if (FlashUpdateSwap())
+            {
+                SimFail("swap of a rejected image");
+            }
+            CheckActive(pucActive, REGION_SIZE, "active region changed by a rejected image");
+            ulRejected++;
+            continue;
+        }
+
+        if ((eStatus != FLASH_UPDATE_COMPLETE) || (eError != TFTP_OK))
+        {
+            SimFail("good stream not verified");
+        }
+        CheckActive(pucActive, REGION_SIZE, "active region changed before the swap");
+
+        /* Reset part way through some of the swaps; the next swap must complete the copy. */
+        if (ulRun % 3 == 0)
+        {
+            g_sSim.ulEraseLimit = 1 + SimRandom() % ((ulLength + PAGE_SIZE - 1) / PAGE_SIZE);
+            if (setjmp(g_sSim.sReset) == 0)
+            {
+                FlashUpdateSwap();
+                SimFail("swap not interrupted");
+            }
+            ulResets++;
+        }
+        if (!FlashUpdateSwap())
+        {
+            SimFail("swap failed");
+        }
+        CheckActive(pucStream, ulLength, "active image not replaced");
+        if (FlashUpdateSwap())
+        {
+            SimFail("swap repeated");
+        }
+        memcpy(pucActive, g_sSim.pucFlash, REGION_SIZE);
+        ulSwaps++;
+    }
+
+    /* long is int here, so the counts are printed as unsigned ints. */
+    printf("flashupdate-test: %u runs, %u swaps (%u after a reset), %u rejected, %u erases, %u programs, "
+           "%u busy blocks, %u resumes\n", NUM_RUNS, ulSwaps, ulResets, ulRejected, g_sSim.ulErases,
+           g_sSim.ulPrograms, g_sSim.ulBusy, g_sSim.ulResumes);
+    return 0;
+}
@@ -0,0 +1,53 @@
+#!/bin/sh
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+
+# Build and run the host test of the flash update module against a simulated flash.  StellarisWare assumes that long
+# is 32 bits wide, so the module is built with long defined as int (which also truncates the pointer to integer casts
+# that it uses for flash addresses, hence the disabled warnings; the test maps its flash below 4 GiB).  The module
+# includes a system header, so the definition is made by a forced include after that header.
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+STELLARISWARE="${HERE}/../stellarisware-min"
+OUT="${OUT:-${HERE}/../../../out/flashupdate-test}"
+CC="${CC:-gcc}"
+CFLAGS="${CFLAGS:--O2 -Wall}"
+
+mkdir -p "${OUT}"
+printf '#include <string.h>\n#define long int\n' > "${OUT}/long32.h"
+
+for SOURCE in crc.c flashupdate.c; do
+    "${CC}" ${CFLAGS} -include "${OUT}/long32.h" -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast -I"${STELLARISWARE}" \
+        -c "${STELLARISWARE}/utils/${SOURCE}" -o "${OUT}/$(basename "${SOURCE}" .c).o"
+done
+"${CC}" ${CFLAGS} -I"${STELLARISWARE}" -c "${HERE}/flashupdate-test.c" -o "${OUT}/flashupdate-test.o"
+"${CC}" -o "${OUT}/flashupdate-test" "${OUT}/flashupdate-test.o" "${OUT}/crc.o" "${OUT}/flashupdate.o"
+
+"${OUT}/flashupdate-test"
@@ -0,0 +1,320 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+/*
+ * Host benchmark for the off-screen display drivers of the Stellaris graphics library.
+ *
+ * A screen containing a push button (with text and an image), a listbox and a slider is rendered repeatedly into a
+ * 1, 4 and 8 BPP off-screen buffer.  For each format, the number of frames rendered per second is reported together
+ * with a checksum of the final frame, so that changes to the drivers can be checked for identical output.  Before
+ * rendering, the 4 and 8 BPP span fills are checked to leave the buffer untouched when they are asked to fill empty
+ * spans.
+ *
+ * A second case redraws a status panel of labels and changing numbers in place, as status screens do many times a
+ * second.  It mostly draws the same few characters and measures the cost of text rendering.
+ *
+ * The graphics library assumes that long is 32 bits wide, so the library is built with long defined as int (see
+ * grlib-bench.sh).  The same definition is applied below, after the system headers have been included.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define long int
+
+#include "grlib/grlib.h"
+#include "grlib/widget.h"
+#include "grlib/pushbutton.h"
+#include "grlib/listbox.h"
+#include "grlib/slider.h"
+
+#define SCREEN_WIDTH 320
+#define SCREEN_HEIGHT 240
+#define IMAGE_WIDTH 48
+#define IMAGE_HEIGHT 24
+#define NUM_ENTRIES 16
+#define DEFAULT_FRAMES 2000
+#define STATUS_LINES 8
+#define STATUS_LINE_HEIGHT 16
+
+static tDisplay g_sDisplay;
+static tContext g_sContext;
+
+static unsigned char g_pucScreen[GrOffScreen8BPPSize(SCREEN_WIDTH, SCREEN_HEIGHT)];
+static unsigned char g_pucImage[GrOffScreen8BPPSize(IMAGE_WIDTH, IMAGE_HEIGHT)];
+static unsigned long g_pulPalette[256];
+
+static const char *g_ppcEntries[NUM_ENTRIES];
+
+static tPushButtonWidget g_sButton =
+    RectangularButtonStruct(0, 0, 0, &g_sDisplay, 10, 10, 140, 40,
+                            PB_STYLE_FILL | PB_STYLE_OUTLINE | PB_STYLE_TEXT | PB_STYLE_IMG,
+                            ClrDarkBlue, ClrRed, ClrWhite, ClrYellow, g_pFontCm12, "Push", 0, 0, 0, 0, 0);
+
+static tListBoxWidget g_sListBox =
+    ListBoxStruct(0, 0, 0, &g_sDisplay, 170, 10, 140, 220, LISTBOX_STYLE_OUTLINE,
+                  ClrBlack, ClrDarkGreen, ClrSilver, ClrWhite, ClrWhite, g_pFontCm12, g_ppcEntries,
+                  NUM_ENTRIES, NUM_ENTRIES, 0);
+
+static tSliderWidget g_sSlider =
+    SliderStruct(0, 0, 0, &g_sDisplay, 10, 70, 150, 30, 0, 100, 0,
+                 SL_STYLE_FILL | SL_STYLE_BACKG_FILL | SL_STYLE_OUTLINE | SL_STYLE_TEXT | SL_STYLE_BACKG_TEXT,
+                 ClrGray, ClrBlack, ClrWhite, ClrWhite, ClrWhite, g_pFontCm12, "Level", 0, 0, 0);
+
+/*
+ * widget.c only provides WidgetMutexGet() for the target toolchains.  The benchmark is single threaded, so a plain
+ * test-and-set suffices.
+ */
+unsigned long
+WidgetMutexGet(unsigned char *pcMutex)
+{
+    if (*pcMutex)
+    {
+        return 1;
+    }
+    *pcMutex = 1;
+    return 0;
+}
+
+static void
+palette_init(void)
+{
+    unsigned long ulIdx;
+
+    /* A 6x6x6 color cube followed by a gray ramp; the 4 BPP buffers use the first 16 entries. */
+    for (ulIdx = 0; ulIdx < 216; ulIdx++)
+    {
+        g_pulPalette[ulIdx] = (((ulIdx / 36) * 51) << ClrRedShift) | ((((ulIdx / 6) % 6) * 51) << ClrGreenShift) |
+                              (((ulIdx % 6) * 51) << ClrBlueShift);
+    }
+    for (; ulIdx < 256; ulIdx++)
+    {
+        g_pulPalette[ulIdx] = ((ulIdx - 216) * 0x060606) + 0x080808;
+    }
+}
+
+static void
+screen_init(unsigned long ulBPP)
+{
+    tDisplay sImageDisplay;
+    tContext sImageContext;
+    tRectangle sRect;
+    long lX;
+
+    /* Set up the screen and the push button image in the same format, with the same palette. */
+    switch (ulBPP)
+    {
+    case 1:
+        GrOffScreen1BPPInit(&g_sDisplay, g_pucScreen, SCREEN_WIDTH, SCREEN_HEIGHT);
+        GrOffScreen1BPPInit(&sImageDisplay, g_pucImage, IMAGE_WIDTH, IMAGE_HEIGHT);
+        break;
+    case 4:
+        GrOffScreen4BPPInit(&g_sDisplay, g_pucScreen, SCREEN_WIDTH, SCREEN_HEIGHT);
+        GrOffScreen4BPPPaletteSet(&g_sDisplay, g_pulPalette, 0, 16);
+        GrOffScreen4BPPInit(&sImageDisplay, g_pucImage, IMAGE_WIDTH, IMAGE_HEIGHT);
+        GrOffScreen4BPPPaletteSet(&sImageDisplay, g_pulPalette, 0, 16);
+        break;
+    default:
+        GrOffScreen8BPPInit(&g_sDisplay, g_pucScreen, SCREEN_WIDTH, SCREEN_HEIGHT);
+        GrOffScreen8BPPPaletteSet(&g_sDisplay, g_pulPalette, 0, 256);
+        GrOffScreen8BPPInit(&sImageDisplay, g_pucImage, IMAGE_WIDTH, IMAGE_HEIGHT);
+        GrOffScreen8BPPPaletteSet(&sImageDisplay, g_pulPalette, 0, 256);
+        break;
+    }
+
+    /* Draw a set of colored stripes into the push button image. */
+    GrContextInit(&sImageContext, &sImageDisplay);
+    for (lX = 0; lX < IMAGE_WIDTH; lX += 6)
+    {
+        sRect.sXMin = lX;
+        sRect.sYMin = 0;
+        sRect.sXMax = lX + 5;
+        sRect.sYMax = IMAGE_HEIGHT - 1;
+        GrContextForegroundSet(&sImageContext, g_pulPalette[(lX * 7) % 216]);
+        GrRectFill(&sImageContext, &sRect);
+    }
+    g_sButton.pucImage = g_pucImage;
+    g_sButton.pucPressImage = g_pucImage;
+
+    GrContextInit(&g_sContext, &g_sDisplay);
+}
+
+static int
+empty_spans_check(void)
+{
+    static unsigned char pucCopy[sizeof(g_pucScreen)];
+    unsigned long ulValue = DpyColorTranslate(&g_sDisplay, ClrWhite);
+    tRectangle sRect;
+    long lX, lCount;
+
+    /* Lines and rectangles of zero or negative width, starting at odd and even X coordinates, cover no pixels. */
+    memcpy(pucCopy, g_pucScreen, sizeof(g_pucScreen));
+    for (lX = 8; lX < 12; lX++)
+    {
+        for (lCount = -1; lCount <= 0; lCount++)
+        {
+            DpyLineDrawH(&g_sDisplay, lX, lX + lCount - 1, 5, ulValue);
+            sRect.sXMin = lX;
+            sRect.sYMin = 20;
+            sRect.sXMax = lX + lCount - 1;
+            sRect.sYMax = 21;
+            DpyRectFill(&g_sDisplay, &sRect, ulValue);
+        }
+    }
+
+    return memcmp(pucCopy, g_pucScreen, sizeof(g_pucScreen)) == 0;
+}
+
+static void
+frame_render(unsigned long ulFrame)
+{
+    tRectangle sRect;
+
+    /* Clear the screen, update the widget state and repaint every widget. */
+    sRect.sXMin = 0;
+    sRect.sYMin = 0;
+    sRect.sXMax = SCREEN_WIDTH - 1;
+    sRect.sYMax = SCREEN_HEIGHT - 1;
+    GrContextForegroundSet(&g_sContext, ClrBlack);
+    GrRectFill(&g_sContext, &sRect);
+
+    if (ulFrame & 1)
+    {
+        g_sButton.ulStyle |= PB_STYLE_PRESSED;
+    }
+    else
+    {
+        g_sButton.ulStyle &= ~PB_STYLE_PRESSED;
+    }
+    ListBoxSelectionSet(&g_sListBox, ulFrame % NUM_ENTRIES);
+    SliderValueSet(&g_sSlider, ulFrame % 101);
+
+    WidgetPaint(WIDGET_ROOT);
+    WidgetMessageQueueProcess();
+}
+
+static void
+status_render(unsigned long ulFrame)
+{
+    static const char *const ppcLabels[STATUS_LINES] =
+    {
+        "Speed", "Left", "Right", "Battery", "Temp", "Heading", "Distance", "Uptime"
+    };
+    char pcValue[16];
+    unsigned long ulLine;
+    long lY;
+
+    /* Redraw each line over its previous contents: a label on the left, and a right-aligned value that changes with
+     * every frame. */
+    GrContextFontSet(&g_sContext, g_pFontCm12);
+    GrContextForegroundSet(&g_sContext, ClrWhite);
+    GrContextBackgroundSet(&g_sContext, ClrDarkBlue);
+    for (ulLine = 0; ulLine < STATUS_LINES; ulLine++)
+    {
+        lY = 10 + (ulLine * STATUS_LINE_HEIGHT);
+        GrStringDraw(&g_sContext, ppcLabels[ulLine], -1, 10, lY, 1);
+        snprintf(pcValue, sizeof(pcValue), "%u.%02u", (unsigned int)((ulFrame * (ulLine + 1)) % 1000),
+                 (unsigned int)((ulFrame + ulLine) % 100));
+        GrStringDraw(&g_sContext, pcValue, -1, 300 - GrStringWidthGet(&g_sContext, pcValue, -1), lY, 1);
+        GrStringDrawCentered(&g_sContext, "OK", -1, 160, lY + (STATUS_LINE_HEIGHT / 2), 0);
+    }
+}
+
+static unsigned long
+screen_checksum(void)
+{
+    unsigned long ulHash = 2166136261u;
+    unsigned long ulIdx;
+
+    /* FNV-1a over the whole buffer, including the header and the palette. */
+    for (ulIdx = 0; ulIdx < sizeof(g_pucScreen); ulIdx++)
+    {
+        ulHash = (ulHash ^ g_pucScreen[ulIdx]) * 16777619u;
+    }
+
+    return ulHash;
+}
+
+int
+main(int argc, char **argv)
+{
+    static const unsigned long pulBPP[] = { 1, 4, 8 };
+    static char ppcText[NUM_ENTRIES][16];
+    struct timespec sStart, sEnd;
+    unsigned long ulFrames, ulFrame, ulIdx;
+    double dSeconds;
+
+    ulFrames = (argc > 1) ? strtoul(argv[1], 0, 0) : DEFAULT_FRAMES;
+
+    palette_init();
+    for (ulIdx = 0; ulIdx < NUM_ENTRIES; ulIdx++)
+    {
+        snprintf(ppcText[ulIdx], sizeof(ppcText[ulIdx]), "Entry %u", (unsigned int)ulIdx);
+        g_ppcEntries[ulIdx] = ppcText[ulIdx];
+    }
+
+    WidgetAdd(WIDGET_ROOT, (tWidget *)&g_sButton);
+    WidgetAdd(WIDGET_ROOT, (tWidget *)&g_sListBox);
+    WidgetAdd(WIDGET_ROOT, (tWidget *)&g_sSlider);
+
+    for (ulIdx = 0; ulIdx < sizeof(pulBPP) / sizeof(pulBPP[0]); ulIdx++)
+    {
+        screen_init(pulBPP[ulIdx]);
+        if ((pulBPP[ulIdx] != 1) && !empty_spans_check())
+        {
+            fprintf(stderr, "%u BPP: empty span written to the buffer\n", (unsigned int)pulBPP[ulIdx]);
+            return 1;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &sStart);
+        for (ulFrame = 0; ulFrame < ulFrames; ulFrame++)
+        {
+            frame_render(ulFrame);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &sEnd);
+
+        dSeconds = (sEnd.tv_sec - sStart.tv_sec) + ((sEnd.tv_nsec - sStart.tv_nsec) / 1e9);
+        printf("%u BPP: %u frames in %.3f s, %.1f frames per second, checksum %08x\n", (unsigned int)pulBPP[ulIdx],
+               (unsigned int)ulFrames, dSeconds, ulFrames / dSeconds, (unsigned int)screen_checksum());
+
+        clock_gettime(CLOCK_MONOTONIC, &sStart);
+        for (ulFrame = 0; ulFrame < ulFrames; ulFrame++)
+        {
+            status_render(ulFrame);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &sEnd);
+
+        dSeconds = (sEnd.tv_sec - sStart.tv_sec) + ((sEnd.tv_nsec - sStart.tv_nsec) / 1e9);
+        printf("%u BPP text: %u frames in %.3f s, %.1f frames per second, checksum %08x\n",
+               (unsigned int)pulBPP[ulIdx], (unsigned int)ulFrames, dSeconds, ulFrames / dSeconds,
+               (unsigned int)screen_checksum());
+    }
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#!/bin/sh
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+
+# Build and run the host benchmark of the graphics library off-screen drivers.
+# The graphics library assumes that long is 32 bits wide, so it is built with
+# long defined as int (which also truncates the pointer to integer casts that
+# it uses for alignment checks, hence the disabled warning).  Any arguments are
+# passed on to the benchmark.
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+STELLARISWARE="${HERE}/../stellarisware-min"
+GRLIB="${STELLARISWARE}/grlib"
+OUT="${OUT:-${HERE}/../../../out/grlib-bench}"
+CC="${CC:-gcc}"
+CFLAGS="${CFLAGS:--O2}"
+
+mkdir -p "${OUT}"
+
+GRLIB_SOURCES="charmap.c circle.c context.c image.c line.c listbox.c offscr1bpp.c offscr4bpp.c offscr8bpp.c
+               pushbutton.c rectangle.c slider.c string.c widget.c fonts/fontcm12.c"
+
+OBJECTS=""
+for SOURCE in ${GRLIB_SOURCES}; do
+    OBJECT="${OUT}/$(basename "${SOURCE}" .c).o"
+    "${CC}" ${CFLAGS} -Wall -Dlong=int -Wno-pointer-to-int-cast \
+        '-DNumLeadingZeros(x)=(((x) != 0) ? __builtin_clz(x) : 32)' -I"${STELLARISWARE}" -c "${GRLIB}/${SOURCE}" -o "${OBJECT}"
+    OBJECTS="${OBJECTS} ${OBJECT}"
+done
+
+"${CC}" ${CFLAGS} -Wall -I"${STELLARISWARE}" -c "${HERE}/grlib-bench.c" -o "${OUT}/grlib-bench.o"
+"${CC}" -o "${OUT}/grlib-bench" "${OUT}/grlib-bench.o" ${OBJECTS}
+
+"${OUT}/grlib-bench" "$@"
@@ -0,0 +1,590 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+
+/*
+ * Host test for the dirty-region tracking of the Stellaris graphics library.
+ *
+ * A 96x16 1 BPP off-screen buffer is drawn through a dirty-region tracking display (grlib/offscrdirty.c), whose flush
+ * function copies the flushed region to a simulated OLED display with Display96x16x1OffScreenDraw().  The simulated
+ * display decodes the I2C transfers of the driver into the memory of the display controller.  The test checks the
+ * region that each flush hands to the flush function, that the display matches the buffer after every flush, and
+ * that only the columns of the region are sent to the display.  It also checks that GrOffScreenDirtyBlit() copies
+ * exactly the requested region, and that WidgetInvalidate() repaints the invalidated widgets, and only them, once.
+ *
+ * StellarisWare assumes that long is 32 bits wide, so the library and the driver are built with long defined as int
+ * (see grlib-dirty-test.sh).  The same definition is applied below, after the system headers have been included.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define long int
+
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/gpio.h"
+#include "driverlib/i2c.h"
+#include "driverlib/sysctl.h"
+#include "grlib/grlib.h"
+#include "grlib/widget.h"
+#include "grlib/listbox.h"
+#include "drivers/display96x16x1.h"
+
+#define SCREEN_WIDTH 96
+#define SCREEN_HEIGHT 16
+#define SSD_ADDR 0x3c
+#define SSD_PAGES 2
+#define SSD_COLUMNS 132
+#define SSD_COLUMN_OFFSET 4
+
+/* The decoding state of an I2C transfer to the display controller. */
+typedef enum
+{
+    SSD_CONTROL,
+    SSD_COMMAND,
+    SSD_DATA
+} tSSDState;
+
+/* The state of the simulated display controller and of the flushes. */
+static struct
+{
+    unsigned char pucRAM[SSD_PAGES][SSD_COLUMNS];
+    tSSDState eState;
+    unsigned long ulPage;
+    unsigned long ulColumn;
+    unsigned char ucData;
+    unsigned long ulDataBytes;
+
+    unsigned long ulFlushes;
+    tRectangle sFlushed;
+} g_sSim;
+
+static unsigned char g_pucScreen[GrOffScreen1BPPSize(SCREEN_WIDTH, SCREEN_HEIGHT)];
+static unsigned char g_pucSource[GrOffScreen1BPPSize(SCREEN_WIDTH, SCREEN_HEIGHT)];
+static tDisplay g_sOffScreen;
+static tDisplay g_sSourceDisplay;
+static tDisplay g_sDisplay;
+static tOffScreenDirty g_sDirty;
+static tContext g_sContext;
+
+static void
+SimFail(const char *pcMessage)
+{
+    fprintf(stderr, "FAIL: %s\n", pcMessage);
+    exit(1);
+}
+
+static void
+SimUnexpected(void)
+{
+    SimFail("unexpected call to the display initialization");
+}
+
+/*
+ * The I2C master as used by the display driver.  Each byte is passed to the display controller when the driver
+ * starts or continues the transfer.
+ */
+void
+I2CMasterSlaveAddrSet(unsigned long ulBase, unsigned char ucSlaveAddr, tBoolean bReceive)
+{
+    if ((ulBase != I2C1_MASTER_BASE) || (ucSlaveAddr != SSD_ADDR) || bReceive)
+    {
+        SimFail("transfer to the wrong device");
+    }
+}
+
+void
+I2CMasterDataPut(unsigned long ulBase, unsigned char ucData)
+{
+    g_sSim.ucData = ucData;
+}
+
+tBoolean
+I2CMasterIntStatus(unsigned long ulBase, tBoolean bMasked)
+{
+    return true;
+}
+
+void
+I2CMasterIntClear(unsigned long ulBase)
+{
+}
+
+void
+I2CMasterControl(unsigned long ulBase, unsigned long ulCmd)
+{
+    unsigned char ucData = g_sSim.ucData;
+
+    if (ulCmd == I2C_MASTER_CMD_BURST_SEND_START)
+    {
+        g_sSim.eState = SSD_CONTROL;
+    }
+    else if ((ulCmd != I2C_MASTER_CMD_BURST_SEND_CONT) && (ulCmd != I2C_MASTER_CMD_BURST_SEND_FINISH))
+    {
+        SimFail("unexpected I2C command");
+    }
+
+    /* A control byte of 0x80 precedes a single command byte, and one of 0x40 makes the rest of the transfer data. */
+    switch (g_sSim.eState)
+    {
+    case SSD_CONTROL:
+        if (ucData == 0x80)
+        {
+            g_sSim.eState = SSD_COMMAND;
+        }
+        else if (ucData == 0x40)
+        {
+            g_sSim.eState = SSD_DATA;
+        }
+        else
+        {
+            SimFail("unexpected control byte");
+        }
+        break;
+    case SSD_COMMAND:
+        if ((ucData & 0xf0) == 0xb0)
+        {
+            g_sSim.ulPage = ucData & 0x0f;
+        }
+        else if ((ucData & 0xf0) == 0x00)
+        {
+            g_sSim.ulColumn = (g_sSim.ulColumn & 0xf0) | (ucData & 0x0f);
+        }
+        else if ((ucData & 0xf0) == 0x10)
+        {
+            g_sSim.ulColumn = (g_sSim.ulColumn & 0x0f) | ((ucData & 0x0f) << 4);
+        }
+        else
+        {
+            SimFail("unexpected command");
+        }
+        g_sSim.eState = SSD_CONTROL;
+        break;
+    default:
+        if ((g_sSim.ulPage >= SSD_PAGES) || (g_sSim.ulColumn >= SSD_COLUMNS))
+        {
+            SimFail("data written outside the display memory");
+        }
+        g_sSim.pucRAM[g_sSim.ulPage][g_sSim.ulColumn++] = ucData;
+        g_sSim.ulDataBytes++;
+        break;
+    }
+}
+
+void
+I2CMasterInitExpClk(unsigned long ulBase, unsigned long ulI2CClk, tBoolean bFast)
+{
+    SimUnexpected();
+}
+
+void
+GPIOPinConfigure(unsigned long ulPinConfig)
+{
+    SimUnexpected();
+}
+
+void
+GPIOPinTypeGPIOOutput(unsigned long ulPort, unsigned char ucPins)
+{
+    SimUnexpected();
+}
+
+void
+GPIOPinTypeI2C(unsigned long ulPort, unsigned char ucPins)
+{
+    SimUnexpected();
+}
+
+void
+GPIOPinWrite(unsigned long ulPort, unsigned char ucPins, unsigned char ucVal)
+{
+    SimUnexpected();
+}
+
+unsigned long
+SysCtlClockGet(void)
+{
+    SimUnexpected();
+    return 0;
+}
+
+void
+SysCtlDelay(unsigned long ulCount)
+{
+    SimUnexpected();
+}
+
+void
+SysCtlPeripheralEnable(unsigned long ulPeripheral)
+{
+    SimUnexpected();
+}
+
+void
+SysCtlPeripheralReset(unsigned long ulPeripheral)
+{
+    SimUnexpected();
+}
+
+/*
+ * widget.c only provides WidgetMutexGet() for the target toolchains.  The test is single threaded, so a plain
+ * test-and-set suffices.
+ */
+unsigned long
+WidgetMutexGet(unsigned char *pcMutex)
+{
+    if (*pcMutex)
+    {
+        return 1;
+    }
+    *pcMutex = 1;
+    return 0;
+}
+
+/* The flush function of the dirty-region tracking display, which copies the region to the OLED display. */
+static void
+FlushRegion(void *pvFlushData, const tRectangle *pRect)
+{
+    if (pvFlushData != g_pucScreen)
+    {
+        SimFail("wrong flush data");
+    }
+    g_sSim.ulFlushes++;
+    g_sSim.sFlushed = *pRect;
+    Display96x16x1OffScreenDraw(g_pucScreen, pRect->sXMin, pRect->sYMin, pRect->sXMax, pRect->sYMax);
+}
+
+static unsigned long
+PixelGet(const unsigned char *pucImage, long lX, long lY)
+{
+    return (pucImage[5 + (lY * ((SCREEN_WIDTH + 7) / 8)) + (lX / 8)] >> (7 - (lX & 7))) & 1;
+}
+
+/* Set a pixel directly in an image buffer, bypassing the dirty-region tracking. */
+static void
+PixelSet(unsigned char *pucImage, long lX, long lY, unsigned long ulValue)
+{
+    unsigned char *pucByte = &pucImage[5 + (lY * ((SCREEN_WIDTH + 7) / 8)) + (lX / 8)];
+
+    *pucByte = (*pucByte & ~(0x80 >> (lX & 7))) | (ulValue << (7 - (lX & 7)));
+}
+
+/*
+ * Flush the display and check that exactly the region from (lX1, lY1) to (lX2, lY2) was flushed, or that nothing
+ * was if lX1 is negative, that only the columns of the region were sent, and that the display matches the buffer.
+ */
+static void
+CheckFlush(long lX1, long lY1, long lX2, long lY2, const char *pcMessage)
+{
+    long lX, lY;
+
+    g_sSim.ulFlushes = 0;
+    g_sSim.ulDataBytes = 0;
+    GrFlush(&g_sContext);
+
+    if (lX1 < 0)
+    {
+        if (g_sSim.ulFlushes || g_sSim.ulDataBytes)
+        {
+            SimFail(pcMessage);
+        }
+        return;
+    }
+    if ((g_sSim.ulFlushes != 1) || (g_sSim.sFlushed.sXMin != lX1) || (g_sSim.sFlushed.sYMin != lY1) ||
+        (g_sSim.sFlushed.sXMax != lX2) || (g_sSim.sFlushed.sYMax != lY2) ||
+        (g_sSim.ulDataBytes != (unsigned long)((lX2 - lX1 + 1) * ((lY2 / 8) - (lY1 / 8) + 1))))
+    {
+        SimFail(pcMessage);
+    }
+
+    for (lY = 0; lY < SCREEN_HEIGHT; lY++)
+    {
+        for (lX = 0; lX < SCREEN_WIDTH; lX++)
+        {
+            if (((g_sSim.pucRAM[lY / 8][lX + SSD_COLUMN_OFFSET] >> (lY & 7)) & 1) != PixelGet(g_pucScreen, lX, lY))
+            {
+                SimFail("display does not match the off-screen buffer");
+            }
+        }
+    }
+}
+
+static void
+TestDrawing(void)
+{
+    tRectangle sRect;
+
+    /* A full flush brings the display in line with the buffer; a flush without drawing does nothing. */
+    sRect.sXMin = 0;
+    sRect.sYMin = 0;
+    sRect.sXMax = SCREEN_WIDTH - 1;
+    sRect.sYMax = SCREEN_HEIGHT - 1;
+    GrOffScreenDirtyAdd(&g_sDirty, &sRect);
+    CheckFlush(0, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1, "full region not flushed");
+    CheckFlush(-1, 0, 0, 0, "flush without drawing");
+
+    GrContextForegroundSet(&g_sContext, ClrWhite);
+    GrPixelDraw(&g_sContext, 10, 3);
+    CheckFlush(10, 3, 10, 3, "pixel region");
+
+    GrLineDrawH(&g_sContext, 40, 50, 2);
+    GrLineDrawV(&g_sContext, 60, 9, 14);
+    CheckFlush(40, 2, 60, 14, "line region");
+
+    sRect.sXMin = 20;
+    sRect.sYMin = 5;
+    sRect.sXMax = 30;
+    sRect.sYMax = 12;
+    GrRectFill(&g_sContext, &sRect);
+    GrContextForegroundSet(&g_sContext, ClrBlack);
+    GrPixelDraw(&g_sContext, 25, 8);
+    CheckFlush(20, 5, 30, 12, "rectangle region");
+
+    /* Drawing outside the clipping region writes no pixels. */
+    GrContextForegroundSet(&g_sContext, ClrWhite);
+    GrLineDrawH(&g_sContext, 10, 20, SCREEN_HEIGHT + 2);
+    CheckFlush(-1, 0, 0, 0, "flush of a clipped line");
+
+    /* Drawing that is discarded is not flushed. */
+    GrPixelDraw(&g_sContext, 90, 15);
+    GrOffScreenDirtyClear(&g_sDirty);
+    CheckFlush(-1, 0, 0, 0, "flush after the region was cleared");
+    GrPixelDraw(&g_sContext, 90, 15);
+    CheckFlush(90, 15, 90, 15, "pixel region after clearing");
+}
+
+static void
+TestBlit(void)
+{
+    static unsigned char pucBefore[sizeof(g_pucScreen)];
+    tContext sSourceContext;
+    tRectangle sRect, sFill;
+    long lX, lY, lIn;
+
+    /* A source image with a pattern in every pixel, and a destination that differs from it everywhere. */
+    GrContextInit(&sSourceContext, &g_sSourceDisplay);
+    for (lY = 0; lY < SCREEN_HEIGHT; lY++)
+    {
+        for (lX = 0; lX < SCREEN_WIDTH; lX++)
+        {
+            GrContextForegroundSet(&sSourceContext, ((lX * 3 + lY * 5) % 7 < 3) ? ClrWhite : ClrBlack);
+            GrPixelDraw(&sSourceContext, lX, lY);
+        }
+    }
+    GrContextForegroundSet(&g_sContext, ClrWhite);
+    GrContextBackgroundSet(&g_sContext, ClrBlack);
+    for (lY = 0; lY < SCREEN_HEIGHT; lY++)
+    {
+        for (lX = 0; lX < SCREEN_WIDTH; lX++)
+        {
+            PixelSet(g_pucScreen, lX, lY, !PixelGet(g_pucSource, lX, lY));
+        }
+    }
+    sFill.sXMin = 0;
+    sFill.sYMin = 0;
+    sFill.sXMax = SCREEN_WIDTH - 1;
+    sFill.sYMax = SCREEN_HEIGHT - 1;
+    GrOffScreenDirtyAdd(&g_sDirty, &sFill);
+    CheckFlush(0, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1, "full region not flushed before the blit");
+
+    /* Copy a region of the source, placed two pixels to the left of and one below the destination origin. */
+    memcpy(pucBefore, g_pucScreen, sizeof(g_pucScreen));
+    sRect.sXMin = 13;
+    sRect.sYMin = 3;
+    sRect.sXMax = 41;
+    sRect.sYMax = 9;
+    GrOffScreenDirtyBlit(&g_sContext, g_pucSource, -2, 1, &sRect);
+    for (lY = 0; lY < SCREEN_HEIGHT; lY++)
+    {
+        for (lX = 0; lX < SCREEN_WIDTH; lX++)
+        {
+            lIn = (lX >= 11) && (lX <= 39) && (lY >= 4) && (lY <= 10);
+            if (PixelGet(g_pucScreen, lX, lY) != (lIn ? PixelGet(g_pucSource, lX + 2, lY - 1) :
+                                                  PixelGet(pucBefore, lX, lY)))
+            {
+                SimFail("blit did not copy exactly the region");
+            }
+        }
+    }
+    CheckFlush(11, 4, 39, 10, "blit region");
+
+    /* Only the part of the region within the clipping region is copied. */
+    sFill.sXMin = 30;
+    sFill.sYMin = 0;
+    sFill.sXMax = 35;
+    sFill.sYMax = 5;
+    GrContextClipRegionSet(&g_sContext, &sFill);
+    GrOffScreenDirtyBlit(&g_sContext, g_pucSource, 0, 0, &sRect);
+    CheckFlush(30, 3, 35, 5, "clipped blit region");
+    sFill.sXMin = 0;
+    sFill.sYMin = 0;
+    sFill.sXMax = SCREEN_WIDTH - 1;
+    sFill.sYMax = SCREEN_HEIGHT - 1;
+    GrContextClipRegionSet(&g_sContext, &sFill);
+}
+
+/* A widget that fills its extent when it is painted, counting its paints. */
+typedef struct
+{
+    tWidget sBase;
+    unsigned long ulPaints;
+} tCounterWidget;
+
+static long
+CounterMsgProc(tWidget *pWidget, unsigned long ulMessage, unsigned long ulParam1, unsigned long ulParam2)
+{
+    tCounterWidget *pCounter = (tCounterWidget *)pWidget;
+
+    if (ulMessage != WIDGET_MSG_PAINT)
+    {
+        return WidgetDefaultMsgProc(pWidget, ulMessage, ulParam1, ulParam2);
+    }
+    pCounter->ulPaints++;
+    GrContextForegroundSet(&g_sContext, (pCounter->ulPaints & 1) ? ClrWhite : ClrBlack);
+    GrRectFill(&g_sContext, &pWidget->sPosition);
+    return 1;
+}
+
+#define CounterStruct(lX1, lX2) \
+    { { sizeof(tCounterWidget), 0, 0, 0, &g_sDisplay, { lX1, 0, lX2, SCREEN_HEIGHT - 1 }, CounterMsgProc }, 0 }
+
+static tCounterWidget g_sParent = CounterStruct(0, 47);
+static tCounterWidget g_sLeft = CounterStruct(0, 23);
+static tCounterWidget g_sRight = CounterStruct(24, 47);
+
+static const char *g_ppcEntries[] = { "One", "Two", "Three" };
+static unsigned long g_ulListPaints;
+
+static tListBoxWidget g_sListBox =
+    ListBoxStruct(0, 0, 0, &g_sDisplay, 56, 0, 40, SCREEN_HEIGHT, 0, ClrBlack, ClrWhite, ClrWhite, ClrBlack, ClrWhite,
+                  g_pFontCm12, g_ppcEntries, 3, 3, 0);
+
+/* The list box message handler, wrapped to count the paints of the list box. */
+static long
+ListMsgProc(tWidget *pWidget, unsigned long ulMessage, unsigned long ulParam1, unsigned long ulParam2)
+{
+    if (ulMessage == WIDGET_MSG_PAINT)
+    {
+        g_ulListPaints++;
+    }
+    return ListBoxMsgProc(pWidget, ulMessage, ulParam1, ulParam2);
+}
+
+/* Process the widget messages and check the number of paints of each widget since the last check. */
+static void
+CheckPaints(unsigned long ulParent, unsigned long ulLeft, unsigned long ulRight, unsigned long ulList,
+            const char *pcMessage)
+{
+    WidgetMessageQueueProcess();
+    if ((g_sParent.ulPaints != ulParent) || (g_sLeft.ulPaints != ulLeft) || (g_sRight.ulPaints != ulRight) ||
+        (g_ulListPaints != ulList))
+    {
+        SimFail(pcMessage);
+    }
+    g_sParent.ulPaints = 0;
+    g_sLeft.ulPaints = 0;
+    g_sRight.ulPaints = 0;
+    g_ulListPaints = 0;
+}
+
+static void
+TestInvalidate(void)
+{
+    g_sListBox.sBase.pfnMsgProc = ListMsgProc;
+    g_sListBox.sSelected = -1;
+    WidgetAdd(WIDGET_ROOT, &g_sParent.sBase);
+    WidgetAdd(&g_sParent.sBase, &g_sLeft.sBase);
+    WidgetAdd(&g_sParent.sBase, &g_sRight.sBase);
+    WidgetAdd(WIDGET_ROOT, &g_sListBox.sBase);
+
+    WidgetPaint(WIDGET_ROOT);
+    CheckPaints(1, 1, 1, 1, "paint of the whole tree");
+    CheckFlush(0, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1, "region of the whole tree");
+
+    CheckPaints(0, 0, 0, 0, "paint without invalidation");
+    CheckFlush(-1, 0, 0, 0, "flush without invalidation");
+
+    /* A widget that is invalidated twice is painted once, and its parent and siblings are not painted. */
+    WidgetInvalidate(&g_sLeft.sBase);
+    WidgetInvalidate(&g_sLeft.sBase);
+    CheckPaints(0, 1, 0, 0, "paint of an invalidated widget");
+    CheckFlush(0, 0, 23, SCREEN_HEIGHT - 1, "region of an invalidated widget");
+
+    /* Invalidating a parent covers its children, whether they are invalidated before or after it. */
+    WidgetInvalidate(&g_sLeft.sBase);
+    WidgetInvalidate(&g_sParent.sBase);
+    WidgetInvalidate(&g_sRight.sBase);
+    CheckPaints(1, 1, 1, 0, "paint of an invalidated tree");
+    CheckFlush(0, 0, 47, SCREEN_HEIGHT - 1, "region of an invalidated tree");
+
+    /* Separate widgets are painted once each. */
+    WidgetInvalidate(&g_sRight.sBase);
+    WidgetInvalidate(&g_sListBox.sBase);
+    WidgetInvalidate(&g_sRight.sBase);
+    CheckPaints(0, 0, 1, 1, "paint of separate widgets");
+    CheckFlush(24, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1, "region of separate widgets");
+
+    /* A tap on the list box changes the selection, which repaints the list box alone. */
+    WidgetPointerMessage(WIDGET_MSG_PTR_DOWN, 60, 2);
+    WidgetPointerMessage(WIDGET_MSG_PTR_UP, 60, 2);
+    CheckPaints(0, 0, 0, 1, "paint after a tap on the list box");
+    if (g_sListBox.sSelected != 0)
+    {
+        SimFail("tap did not select an entry");
+    }
+    g_sSim.ulFlushes = 0;
+    GrFlush(&g_sContext);
+    if ((g_sSim.ulFlushes != 1) || (g_sSim.sFlushed.sXMin < 56))
+    {
+        SimFail("region after a tap on the list box");
+    }
+
+    /* A removed widget is not painted. */
+    WidgetInvalidate(&g_sRight.sBase);
+    WidgetRemove(&g_sRight.sBase);
+    CheckPaints(0, 0, 0, 0, "paint of a removed widget");
+    CheckFlush(-1, 0, 0, 0, "flush of a removed widget");
+}
+
+int
+main(void)
+{
+    GrOffScreen1BPPInit(&g_sOffScreen, g_pucScreen, SCREEN_WIDTH, SCREEN_HEIGHT);
+    GrOffScreen1BPPInit(&g_sSourceDisplay, g_pucSource, SCREEN_WIDTH, SCREEN_HEIGHT);
+    GrOffScreenDirtyInit(&g_sDisplay, &g_sDirty, &g_sOffScreen, FlushRegion, g_pucScreen);
+    GrContextInit(&g_sContext, &g_sDisplay);
+    memset(g_sSim.pucRAM, 0xa5, sizeof(g_sSim.pucRAM));
+
+    TestDrawing();
+    TestBlit();
+    TestInvalidate();
+
+    printf("grlib-dirty-test: passed\n");
+    return 0;
+}
@@ -0,0 +1,75 @@
+#!/bin/sh
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+
+# Build and run the host test of the graphics library dirty-region tracking, with the OLED display driver of the
+# EVALBOT writing to a simulated display controller.  StellarisWare assumes that long is 32 bits wide, so the library
+# and the driver are built with long defined as int (which also truncates the pointer to integer casts that the
+# library uses for alignment checks, hence the disabled warning).  The driver calls the ROM versions of the I2C
+# functions, which are mapped to the functions that the test provides, and defines its own strlen(), hence the
+# disabled built-in functions.
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+STELLARISWARE="${HERE}/../stellarisware-min"
+GRLIB="${STELLARISWARE}/grlib"
+DRIVERS="${STELLARISWARE}/boards/ek-evalbot/drivers"
+OUT="${OUT:-${HERE}/../../../out/grlib-dirty-test}"
+CC="${CC:-gcc}"
+CFLAGS="${CFLAGS:--O2 -Wall}"
+
+mkdir -p "${OUT}"
+{
+    echo '#define long int'
+    for FUNCTION in GPIOPinTypeGPIOOutput GPIOPinTypeI2C GPIOPinWrite I2CMasterControl I2CMasterDataPut \
+                    I2CMasterInitExpClk I2CMasterIntClear I2CMasterIntStatus I2CMasterSlaveAddrSet SysCtlClockGet \
+                    SysCtlPeripheralEnable SysCtlPeripheralReset; do
+        echo "#define ROM_${FUNCTION} ${FUNCTION}"
+    done
+} > "${OUT}/host.h"
+
+GRLIB_SOURCES="charmap.c context.c image.c line.c listbox.c offscr1bpp.c offscrdirty.c rectangle.c string.c widget.c
+               fonts/fontcm12.c"
+
+OBJECTS=""
+for SOURCE in ${GRLIB_SOURCES}; do
+    OBJECT="${OUT}/$(basename "${SOURCE}" .c).o"
+    "${CC}" ${CFLAGS} -Dlong=int -Wno-pointer-to-int-cast \
+        '-DNumLeadingZeros(x)=(((x) != 0) ? __builtin_clz(x) : 32)' -I"${STELLARISWARE}" -c "${GRLIB}/${SOURCE}" \
+        -o "${OBJECT}"
+    OBJECTS="${OBJECTS} ${OBJECT}"
+done
+
+"${CC}" ${CFLAGS} -include "${OUT}/host.h" -fno-builtin -DPART_LM3S9B92 -I"${STELLARISWARE}" \
+    -I"${STELLARISWARE}/boards/ek-evalbot" -c "${DRIVERS}/display96x16x1.c" -o "${OUT}/display96x16x1.o"
+"${CC}" ${CFLAGS} -I"${STELLARISWARE}" -I"${STELLARISWARE}/boards/ek-evalbot" -c "${HERE}/grlib-dirty-test.c" \
+    -o "${OUT}/grlib-dirty-test.o"
+"${CC}" -o "${OUT}/grlib-dirty-test" "${OUT}/grlib-dirty-test.o" "${OUT}/display96x16x1.o" ${OBJECTS}
+
+"${OUT}/grlib-dirty-test"
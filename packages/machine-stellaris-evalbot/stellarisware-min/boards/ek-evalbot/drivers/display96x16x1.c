@@ -823,6 +823,113 @@ Display96x16x1ImageDraw(const unsigned char *pucImage, unsigned long ulX,
     }
 }
 
+//*****************************************************************************
+//
+//! Copies a region of a 1 BPP off-screen buffer to the OLED display.
+//!
+//! \param pucImage is a pointer to a graphics library 1 BPP off-screen image
+//! buffer (as initialized by GrOffScreen1BPPInit()) that is at least 96
+//! columns wide and 16 scan lines tall.
+//! \param ulX1 is the left-most column of the region to copy.
+//! \param ulY1 is the top-most scan line of the region to copy.
+//! \param ulX2 is the right-most column of the region to copy.
+//! \param ulY2 is the bottom-most scan line of the region to copy.
+//!
+//! This function updates the display with the contents of the off-screen
+//! buffer within the given region, which is inclusive of both the minimum and
+//! maximum coordinates.  The off-screen buffer stores eight horizontally
+//! adjacent pixels per byte while the display controller stores eight
+//! vertically adjacent pixels per byte, so the data is transposed as it is
+//! written.  Since the controller can only be written in whole bytes, the
+//! region is widened to the enclosing eight scan line rows, but only the
+//! columns within the region are sent over the I2C bus.
+//!
+//! This is intended to be called with the dirty region of an off-screen buffer
+//! (see GrOffScreenDirtyInit()) so that unchanged pixels are not re-sent to
+//! the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Display96x16x1OffScreenDraw(const unsigned char *pucImage, unsigned long ulX1,
+                            unsigned long ulY1, unsigned long ulX2,
+                            unsigned long ulY2)
+{
+    unsigned long ulBytesPerRow, ulRow, ulX, ulBit;
+    const unsigned char *pucColumn;
+    unsigned char ucData;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pucImage);
+    ASSERT(pucImage[0] == 0x01);
+    ASSERT(ulX1 <= ulX2);
+    ASSERT(ulX2 < 96);
+    ASSERT(ulY1 <= ulY2);
+    ASSERT(ulY2 < 16);
+
+    //
+    // Compute the number of bytes per row in the image buffer, and skip past
+    // the image header to the pixel data.
+    //
+    ulBytesPerRow = (*(unsigned short *)(pucImage + 1) + 7) / 8;
+    pucImage += 5;
+
+    //
+    // Loop through the rows of the display that contain the region.
+    //
+    for(ulRow = ulY1 / 8; ulRow <= (ulY2 / 8); ulRow++)
+    {
+        //
+        // Write the starting address within this row.  The first few columns
+        // of the LCD buffer are not displayed, so the X coordinate is offset
+        // by this amount.
+        //
+        Display96x16x1WriteFirst(0x80);
+        Display96x16x1WriteByte((ulRow == 0) ? 0xb0 : 0xb1);
+        Display96x16x1WriteByte(0x80);
+        Display96x16x1WriteByte((ulX1 + 4) & 0x0f);
+        Display96x16x1WriteByte(0x80);
+        Display96x16x1WriteByte(0x10 | (((ulX1 + 4) >> 4) & 0x0f));
+        Display96x16x1WriteByte(0x40);
+
+        //
+        // Loop through the columns of the region.
+        //
+        for(ulX = ulX1; ulX <= ulX2; ulX++)
+        {
+            //
+            // Gather the eight scan lines of this column from the off-screen
+            // buffer, with the top scan line in the least significant bit.
+            //
+            pucColumn = pucImage + (ulRow * 8 * ulBytesPerRow) + (ulX / 8);
+            for(ulBit = 0, ucData = 0; ulBit < 8;
+                ulBit++, pucColumn += ulBytesPerRow)
+            {
+                if(*pucColumn & (0x80 >> (ulX & 7)))
+                {
+                    ucData |= 1 << ulBit;
+                }
+            }
+
+            //
+            // Write this column to the display, finishing the transfer on the
+            // last column of the region.
+            //
+            if(ulX == ulX2)
+            {
+                Display96x16x1WriteFinal(ucData);
+            }
+            else
+            {
+                Display96x16x1WriteByte(ucData);
+            }
+        }
+    }
+}
+
 //*****************************************************************************
 //
 //! Initialize the OLED display.
@@ -67,6 +67,11 @@ extern void Display96x16x1ImageDraw(const unsigned char *pucImage,
                                   unsigned long ulX, unsigned long ulY,
                                   unsigned long ulWidth,
                                   unsigned long ulHeight);
+extern void Display96x16x1OffScreenDraw(const unsigned char *pucImage,
+                                        unsigned long ulX1,
+                                        unsigned long ulY1,
+                                        unsigned long ulX2,
+                                        unsigned long ulY2);
 extern void Display96x16x1Init(tBoolean bFast);
 extern void Display96x16x1DisplayOn(void);
 extern void Display96x16x1DisplayOff(void);
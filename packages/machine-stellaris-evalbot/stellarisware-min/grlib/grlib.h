@@ -149,6 +149,53 @@ typedef struct
 }
 tDisplay;
 
+//*****************************************************************************
+//
+//! This flag is ORed into the bits per pixel passed to a display driver's
+//! pfnPixelDrawMultiple function on the first row of each image drawn by
+//! GrImageDraw().  It allows a driver to perform per-image work, such as
+//! translating the image palette, once rather than for every pixel; drivers
+//! must therefore mask the bits per pixel with 0xff.
+//! For 4 and 8 BPP images, the byte preceding the palette holds the number of
+//! palette entries minus one (as it does in the image itself).
+//
+//*****************************************************************************
+#define GRLIB_DRIVER_FLAG_NEW_IMAGE 0x40000000
+
+//*****************************************************************************
+//
+//! This structure holds the state of a dirty-region tracking display.  Such a
+//! display passes every drawing operation on to an underlying (typically
+//! off-screen) display and records the bounding box of the pixels that have
+//! been modified, so that a flush only needs to copy the changed region.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    //! The display to which the drawing operations are passed.
+    //
+    const tDisplay *pDisplay;
+
+    //
+    //! The bounding box of the pixels that have been modified since the last
+    //! flush.  The region is empty when sXMin is greater than sXMax.
+    //
+    tRectangle sDirty;
+
+    //
+    //! A pointer to the function that copies the dirty region to the physical
+    //! display when the display is flushed, or zero if there is none.
+    //
+    void (*pfnFlush)(void *pvFlushData, const tRectangle *pRect);
+
+    //
+    //! The data that is passed to the flush function.
+    //
+    void *pvFlushData;
+}
+tOffScreenDirty;
+
 //*****************************************************************************
 //
 //! This structure describes a font used for drawing text onto the screen.
@@ -1196,6 +1243,45 @@ extern void GrContextFontSet(tContext *pContext, const tFont *pFnt);
 #define GrOffScreen8BPPSize(lWidth, lHeight) \
         (6 + (256 * 3) + (lWidth * lHeight))
 
+//*****************************************************************************
+//
+//! Marks the dirty region of a dirty-region tracking display as clean.
+//!
+//! \param psDirty is a pointer to the dirty-region tracking state.
+//!
+//! This function discards the dirty region without flushing it, for example
+//! after the application has copied the off-screen buffer to the display by
+//! other means.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#define GrOffScreenDirtyClear(psDirty)                    \
+        do                                                \
+        {                                                 \
+            tOffScreenDirty *pD = psDirty;                \
+            pD->sDirty.sXMin = pD->pDisplay->usWidth;     \
+            pD->sDirty.sYMin = pD->pDisplay->usHeight;    \
+            pD->sDirty.sXMax = 0;                         \
+            pD->sDirty.sYMax = 0;                         \
+        }                                                 \
+        while(0)
+
+//*****************************************************************************
+//
+//! Determines if a dirty-region tracking display has any modified pixels.
+//!
+//! \param psDirty is a pointer to the dirty-region tracking state.
+//!
+//! This function determines whether any pixels have been drawn since the last
+//! flush of the display.
+//!
+//! \return Returns 1 if the dirty region is empty and 0 otherwise.
+//
+//*****************************************************************************
+#define GrOffScreenDirtyIsEmpty(psDirty)                  \
+        (((psDirty)->sDirty.sXMin > (psDirty)->sDirty.sXMax) ? 1 : 0)
+
 //*****************************************************************************
 //
 //! Draws a pixel.
@@ -2110,6 +2196,17 @@ extern void GrOffScreen8BPPPaletteSet(tDisplay *pDisplay,
                                       unsigned long *pulPalette,
                                       unsigned long ulOffset,
                                       unsigned long ulCount);
+extern void GrOffScreenDirtyInit(tDisplay *pDisplay,
+                                 tOffScreenDirty *psDirty,
+                                 const tDisplay *pOffScreen,
+                                 void (*pfnFlush)(void *pvFlushData,
+                                                  const tRectangle *pRect),
+                                 void *pvFlushData);
+extern void GrOffScreenDirtyAdd(tOffScreenDirty *psDirty,
+                                const tRectangle *pRect);
+extern void GrOffScreenDirtyBlit(const tContext *pContext,
+                                 const unsigned char *pucImage, long lX,
+                                 long lY, const tRectangle *pRect);
 extern void GrRectDraw(const tContext *pContext, const tRectangle *pRect);
 extern void GrRectFill(const tContext *pContext, const tRectangle *pRect);
 extern void GrStringDraw(const tContext *pContext, const char *pcString,
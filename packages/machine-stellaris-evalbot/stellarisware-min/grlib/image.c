@@ -420,7 +420,7 @@ InternalImageDraw(const tContext *pContext, const unsigned char *pucImage,
                   tBoolean bTransparent)
 {
     unsigned long ulByte, ulBits, ulMatch, ulSize, ulIdx, ulCount, ulNum;
-    long lBPP, lWidth, lHeight, lX0, lX1, lX2, lXMask;
+    long lBPP, lWidth, lHeight, lX0, lX1, lX2, lXMask, lNewImage;
     const unsigned char *pucPalette;
     unsigned long pulBWPalette[2];
 
@@ -521,6 +521,12 @@ InternalImageDraw(const tContext *pContext, const unsigned char *pucImage,
         pucImage += (pucImage[0] * 3) + 4;
     }
 
+    //
+    // Let the display driver know that the first row that it is given belongs
+    // to a new image, so that it can prepare to translate the image palette.
+    //
+    lNewImage = GRLIB_DRIVER_FLAG_NEW_IMAGE;
+
     //
     // See if the image is compressed.
     //
@@ -598,8 +604,9 @@ InternalImageDraw(const tContext *pContext, const unsigned char *pucImage,
             else
             {
                 DpyPixelDrawMultiple(pContext->pDisplay, lX + lX0, lY, lXMask,
-                                     lX2 - lX0 + 1, lBPP,
+                                     lX2 - lX0 + 1, lBPP | lNewImage,
                                      pucImage + ((lX0 * lBPP) / 8), pucPalette);
+                lNewImage = 0;
             }
 
             //
@@ -826,9 +833,10 @@ InternalImageDraw(const tContext *pContext, const unsigned char *pucImage,
                             {
                                 DpyPixelDrawMultiple(pContext->pDisplay,
                                                      lX + lX1, lY, lXMask,
-                                                     ulNum, lBPP,
+                                                     ulNum, lBPP | lNewImage,
                                                      g_pucDictionary + ulIdx,
                                                      pucPalette);
+                                lNewImage = 0;
                             }
                         }
 
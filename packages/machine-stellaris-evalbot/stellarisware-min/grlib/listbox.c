@@ -341,7 +341,7 @@ ListBoxPointer(tListBoxWidget *pListBox, unsigned long ulMsg, long lX, long lY)
                 //
                 // Force a repaint of the widget.
                 //
-                WidgetPaint((tWidget *)pListBox);
+                WidgetInvalidate((tWidget *)pListBox);
 
                 //
                 // Tell the client that the selection changed.
@@ -457,7 +457,7 @@ ListBoxPointer(tListBoxWidget *pListBox, unsigned long ulMsg, long lX, long lY)
                     //
                     // Repaint the contents of the widget.
                     //
-                    WidgetPaint((tWidget *)pListBox);
+                    WidgetInvalidate((tWidget *)pListBox);
                 }
             }
 
@@ -176,7 +176,7 @@ GrOffScreen1BPPPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
     // Determine how to interpret the pixel data based on the number of bits
     // per pixel.
     //
-    switch(lBPP)
+    switch(lBPP & 0xff)
     {
         //
         // The pixel data is in 1 bit per pixel format.
@@ -22,6 +22,7 @@
 //
 //*****************************************************************************
 
+#include "inc/hw_types.h"
 #include "driverlib/debug.h"
 #include "grlib/grlib.h"
 
@@ -117,6 +118,252 @@ GrOffScreen4BPPColorTranslate(void *pvDisplayData, unsigned long ulValue)
     return(ulMatchIdx);
 }
 
+//*****************************************************************************
+//
+// The state used to translate the palette of the image that is currently
+// being drawn into an off-screen buffer.  The display and palette pointers
+// identify the image; the translation of each palette index is computed the
+// first time that it is used and then remembered (as indicated by the
+// corresponding bit in g_pulImageValid).  g_bImageMatch is true when the image
+// palette is identical to the off-screen buffer palette, in which case 4 BPP
+// image rows are copied without translation.
+//
+//*****************************************************************************
+static const void *g_pvImageDisplay;
+static const unsigned char *g_pucImagePalette;
+static tBoolean g_bImageMatch;
+static unsigned long g_pulImageValid[256 / 32];
+static unsigned char g_pucImageTranslate[256];
+
+//*****************************************************************************
+//
+//! Prepares to draw a new image into the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param pucPalette is a pointer to the palette of the 4 or 8 BPP image.
+//!
+//! This function discards the palette translations for the previous image and
+//! determines if the palette of the new image matches the palette of the
+//! off-screen buffer.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen4BPPImageStart(void *pvDisplayData,
+                          const unsigned char *pucPalette)
+{
+    const unsigned char *pucBuffer;
+    unsigned long ulIdx, ulCount;
+
+    //
+    // Remember the image that is being drawn.
+    //
+    g_pvImageDisplay = pvDisplayData;
+    g_pucImagePalette = pucPalette;
+
+    //
+    // Forget the palette translations of the previous image.
+    //
+    for(ulIdx = 0; ulIdx < (256 / 32); ulIdx++)
+    {
+        g_pulImageValid[ulIdx] = 0;
+    }
+
+    //
+    // An image palette with more than 16 entries can not match the palette of
+    // the off-screen buffer.  The byte preceding the image palette contains
+    // the number of palette entries minus one.
+    //
+    if(pucPalette[-1] >= 16)
+    {
+        g_bImageMatch = false;
+        return;
+    }
+
+    //
+    // Get a pointer to the palette for the off-screen buffer.
+    //
+    pucBuffer = (unsigned char *)pvDisplayData + 6;
+
+    //
+    // Compare the image palette against the start of the off-screen buffer
+    // palette.
+    //
+    ulCount = (pucPalette[-1] + 1) * 3;
+    for(ulIdx = 0; ulIdx < ulCount; ulIdx++)
+    {
+        if(pucPalette[ulIdx] != pucBuffer[ulIdx])
+        {
+            break;
+        }
+    }
+    g_bImageMatch = (ulIdx == ulCount) ? true : false;
+}
+
+//*****************************************************************************
+//
+//! Translates an image palette index to an off-screen buffer color.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param pucPalette is a pointer to the palette of the 4 or 8 BPP image.
+//! \param ulIndex is the palette index of the image pixel.
+//!
+//! This function translates the given entry of an image palette into the
+//! closest color in the off-screen buffer palette.  If the image is the one
+//! that is currently being drawn, the translation is only computed once for
+//! each palette index.
+//!
+//! \return Returns the off-screen buffer color.
+//
+//*****************************************************************************
+static unsigned long
+GrOffScreen4BPPIndexTranslate(void *pvDisplayData,
+                              const unsigned char *pucPalette,
+                              unsigned long ulIndex)
+{
+    unsigned long ulValue;
+
+    //
+    // See if this pixel belongs to the image that is currently being drawn
+    // and the translation of this palette index is already known.
+    //
+    if((pvDisplayData == g_pvImageDisplay) &&
+       (pucPalette == g_pucImagePalette) &&
+       (g_pulImageValid[ulIndex / 32] & (1 << (ulIndex & 31))))
+    {
+        return(g_pucImageTranslate[ulIndex]);
+    }
+
+    //
+    // Extract the corresponding entry from the palette and translate it.
+    //
+    ulValue = *(unsigned long *)(pucPalette + (ulIndex * 3)) & 0x00ffffff;
+    ulValue = GrOffScreen4BPPColorTranslate(pvDisplayData, ulValue);
+
+    //
+    // Remember the translation if this pixel belongs to the image that is
+    // currently being drawn.
+    //
+    if((pvDisplayData == g_pvImageDisplay) &&
+       (pucPalette == g_pucImagePalette))
+    {
+        g_pucImageTranslate[ulIndex] = ulValue;
+        g_pulImageValid[ulIndex / 32] |= 1 << (ulIndex & 31);
+    }
+
+    //
+    // Return the translated color.
+    //
+    return(ulValue);
+}
+
+//*****************************************************************************
+//
+//! Copies a row of pixels into the off-screen buffer.
+//!
+//! \param pucDst is a pointer to the byte that contains the first destination
+//! pixel.
+//! \param pucSrc is a pointer to the byte that contains the first source
+//! pixel.
+//! \param lOdd is non-zero if the first pixel is the second pixel in its byte
+//! of both the source and the destination.
+//! \param lCount is the number of pixels to copy.
+//!
+//! This function copies pixels that do not require translation.  A partial
+//! byte at either end of the row is merged into the destination, while the
+//! whole bytes in between are copied with aligned word loads and stores when
+//! the source and destination have the same word alignment.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen4BPPRowCopy(unsigned char *pucDst, const unsigned char *pucSrc,
+                       long lOdd, long lCount)
+{
+    unsigned long *pulDst;
+    const unsigned long *pulSrc;
+    long lBytes;
+
+    //
+    // See if the row starts with the second pixel in a byte.
+    //
+    if(lOdd && lCount)
+    {
+        //
+        // Copy the second pixel in the byte.
+        //
+        *pucDst = (*pucDst & 0xf0) | (*pucSrc++ & 0x0f);
+        pucDst++;
+        lCount--;
+    }
+
+    //
+    // Determine the number of whole bytes to copy.
+    //
+    lBytes = lCount / 2;
+
+    //
+    // See if the source and destination have the same word alignment.
+    //
+    if((((unsigned long)pucDst ^ (unsigned long)pucSrc) & 3) == 0)
+    {
+        //
+        // Copy bytes until the pointers are word aligned.
+        //
+        while(((unsigned long)pucDst & 3) && lBytes)
+        {
+            *pucDst++ = *pucSrc++;
+            lBytes--;
+        }
+
+        //
+        // Copy thirty-two pixels at a time, then eight pixels at a time.
+        //
+        pulDst = (unsigned long *)pucDst;
+        pulSrc = (const unsigned long *)pucSrc;
+        while(lBytes >= 16)
+        {
+            pulDst[0] = pulSrc[0];
+            pulDst[1] = pulSrc[1];
+            pulDst[2] = pulSrc[2];
+            pulDst[3] = pulSrc[3];
+            pulDst += 4;
+            pulSrc += 4;
+            lBytes -= 16;
+        }
+        while(lBytes >= 4)
+        {
+            *pulDst++ = *pulSrc++;
+            lBytes -= 4;
+        }
+        pucDst = (unsigned char *)pulDst;
+        pucSrc = (const unsigned char *)pulSrc;
+    }
+
+    //
+    // Copy any remaining whole bytes.
+    //
+    while(lBytes--)
+    {
+        *pucDst++ = *pucSrc++;
+    }
+
+    //
+    // See if the row ends with the first pixel in a byte.
+    //
+    if(lCount & 1)
+    {
+        //
+        // Copy the first pixel in the byte.
+        //
+        *pucDst = (*pucDst & 0x0f) | (*pucSrc & 0xf0);
+    }
+}
+
 //*****************************************************************************
 //
 //! Draws a pixel on the screen.
@@ -239,11 +486,20 @@ GrOffScreen4BPPPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
     //
     lX = (1 - (lX & 1)) * 4;
 
+    //
+    // If this is the first row of a 4 or 8 BPP image, prepare the palette
+    // translation for the image.
+    //
+    if((lBPP & GRLIB_DRIVER_FLAG_NEW_IMAGE) && ((lBPP & 0xff) != 1))
+    {
+        GrOffScreen4BPPImageStart(pvDisplayData, pucPalette);
+    }
+
     //
     // Determine how to interpret the pixel data based on the number of bits
     // per pixel.
     //
-    switch(lBPP)
+    switch(lBPP & 0xff)
     {
         //
         // The pixel data is in 1 bit per pixel format.
@@ -295,6 +551,20 @@ GrOffScreen4BPPPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
         //
         case 4:
         {
+            //
+            // If the image palette matches the off-screen buffer palette and
+            // the source and destination pixels are in the same position
+            // within their bytes, the pixel data can be copied directly into
+            // the buffer.
+            //
+            if((pvDisplayData == g_pvImageDisplay) &&
+               (pucPalette == g_pucImagePalette) && g_bImageMatch &&
+               ((lX0 & 1) == (lX == 0)))
+            {
+                GrOffScreen4BPPRowCopy(pucPtr, pucData, lX0 & 1, lCount);
+                break;
+            }
+
             //
             // Loop while there are more pixels to draw.  "Duff's device" is
             // used to jump into the middle of the loop if the first nibble of
@@ -310,19 +580,12 @@ GrOffScreen4BPPPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
                     while(lCount)
                     {
                         //
-                        // Get the upper nibble of the next byte of pixel data
-                        // and extract the corresponding entry from the
-                        // palette.
-                        //
-                        ulByte = (*pucData >> 4) * 3;
-                        ulByte = (*(unsigned long *)(pucPalette + ulByte) &
-                                  0x00ffffff);
-
-                        //
-                        // Translate this palette entry.
+                        // Translate the upper nibble of the next byte of pixel
+                        // data.
                         //
-                        ulByte = GrOffScreen4BPPColorTranslate(pvDisplayData,
-                                                               ulByte);
+                        ulByte = GrOffScreen4BPPIndexTranslate(pvDisplayData,
+                                                               pucPalette,
+                                                               *pucData >> 4);
 
                         //
                         // Write this pixel to the screen.
@@ -345,20 +608,13 @@ GrOffScreen4BPPPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
                         {
                 case 1:
                             //
-                            // Get the lower nibble of the next byte of pixel
-                            // data and extract the corresponding entry from
-                            // the palette.
-                            //
-                            ulByte = (*pucData++ & 15) * 3;
-                            ulByte = (*(unsigned long *)(pucPalette + ulByte) &
-                                      0x00ffffff);
-
-                            //
-                            // Translate this palette entry.
+                            // Translate the lower nibble of the next byte of
+                            // pixel data.
                             //
                             ulByte =
-                                GrOffScreen4BPPColorTranslate(pvDisplayData,
-                                                              ulByte);
+                                GrOffScreen4BPPIndexTranslate(pvDisplayData,
+                                                              pucPalette,
+                                                              *pucData++ & 15);
 
                             //
                             // Write this pixel to the screen.
@@ -395,16 +651,11 @@ GrOffScreen4BPPPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
             while(lCount--)
             {
                 //
-                // Get the next byte of pixel data and extract the
-                // corresponding entry from the palette.
-                //
-                ulByte = *pucData++ * 3;
-                ulByte = *(unsigned long *)(pucPalette + ulByte) & 0x00ffffff;
-
-                //
-                // Translate this palette entry.
+                // Translate the next byte of pixel data.
                 //
-                ulByte = GrOffScreen4BPPColorTranslate(pvDisplayData, ulByte);
+                ulByte = GrOffScreen4BPPIndexTranslate(pvDisplayData,
+                                                       pucPalette,
+                                                       *pucData++);
 
                 //
                 // Write this pixel to the screen.
@@ -426,141 +677,120 @@ GrOffScreen4BPPPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
 
 //*****************************************************************************
 //
-//! Draws a horizontal line.
+//! Fills a span of pixels within a row of the off-screen buffer.
 //!
-//! \param pvDisplayData is a pointer to the driver-specific data for this
-//! display driver.
-//! \param lX1 is the X coordinate of the start of the line.
-//! \param lX2 is the X coordinate of the end of the line.
-//! \param lY is the Y coordinate of the line.
-//! \param ulValue is the color of the line.
+//! \param pucData is a pointer to the byte of the image buffer that contains
+//! the first pixel of the span.
+//! \param lX is the X coordinate of the first pixel of the span.
+//! \param lCount is the number of pixels in the span.
+//! \param ulValue is the color of the span, copied into all 8 pixels of the
+//! unsigned long.
 //!
-//! This function draws a horizontal line on the display.  The coordinates of
-//! the line are assumed to be within the extents of the display.
+//! This function draws a pixel that shares its byte with a pixel outside the
+//! span at either end by masking it into the byte, the pixels up to the first
+//! word boundary with byte and half-word stores, the middle of the span with
+//! aligned word stores, and the pixels after the last word boundary with
+//! half-word and byte stores.
 //!
 //! \return None.
 //
 //*****************************************************************************
 static void
-GrOffScreen4BPPLineDrawH(void *pvDisplayData, long lX1, long lX2, long lY,
-                         unsigned long ulValue)
+GrOffScreen4BPPSpanFill(unsigned char *pucData, long lX, long lCount,
+                        unsigned long ulValue)
 {
-    unsigned char *pucData;
-    long lBytesPerRow;
-
-    //
-    // Check the arguments.
-    //
-    ASSERT(pvDisplayData);
+    unsigned long *pulData;
 
     //
-    // Create a character pointer for the display-specific data (which points
-    // to the image buffer).
-    //
-    pucData = (unsigned char *)pvDisplayData;
-
-    //
-    // Compute the number of bytes per row in the image buffer.
-    //
-    lBytesPerRow = (*(unsigned short *)(pucData + 1) + 1) / 2;
-
-    //
-    // Get the offset to the byte of the image buffer that contains the
-    // starting pixel.
-    //
-    pucData += (lBytesPerRow * lY) + (lX1 / 2) + 6 + (16 * 3);
-
-    //
-    // Copy the pixel value into all 8 pixels of the unsigned long.  This will
-    // be used later to write multiple pixels into memory (as opposed to one at
-    // a time).
+    // See if the second pixel in a byte is part of the span.
     //
-    ulValue = ((ulValue << 28) | (ulValue << 24) | (ulValue << 20) |
-               (ulValue << 16) | (ulValue << 12) | (ulValue << 8) |
-               (ulValue << 4) | ulValue);
-
-    //
-    // See if the second pixel in a byte is part of the line.
-    //
-    if(lX1 & 1)
+    if((lX & 1) && (lCount > 0))
     {
         //
         // Draw the second pixel in the byte.
         //
         *pucData = (*pucData & 0xf0) | (ulValue & 0x0f);
         pucData++;
-        lX1++;
+        lCount--;
     }
 
     //
     // See if the buffer pointer is not half-word aligned and there are at
     // least two pixels left to draw.
     //
-    if(((unsigned long)pucData & 1) && ((lX2 - lX1) > 0))
+    if(((unsigned long)pucData & 1) && (lCount >= 2))
     {
         //
         // Draw two pixels to half-word align the buffer pointer.
         //
         *pucData++ = ulValue & 0xff;
-        lX1 += 2;
+        lCount -= 2;
     }
 
     //
     // See if the buffer pointer is not word aligned and there are at least
     // four pixels left to draw.
     //
-    if(((unsigned long)pucData & 2) && ((lX2 - lX1) > 2))
+    if(((unsigned long)pucData & 2) && (lCount >= 4))
     {
         //
         // Draw four pixels to word align the buffer pointer.
         //
         *(unsigned short *)pucData = ulValue & 0xffff;
         pucData += 2;
-        lX1 += 4;
+        lCount -= 4;
     }
 
     //
-    // Loop while there are at least eight pixels left to draw.
+    // Draw thirty-two pixels at a time while there are enough left to draw,
+    // then eight pixels at a time.
     //
-    while((lX1 + 7) <= lX2)
+    pulData = (unsigned long *)pucData;
+    while(lCount >= 32)
     {
-        //
-        // Draw eight pixels.
-        //
-        *(unsigned long *)pucData = ulValue;
-        pucData += 4;
-        lX1 += 8;
+        pulData[0] = ulValue;
+        pulData[1] = ulValue;
+        pulData[2] = ulValue;
+        pulData[3] = ulValue;
+        pulData += 4;
+        lCount -= 32;
+    }
+    while(lCount >= 8)
+    {
+        *pulData++ = ulValue;
+        lCount -= 8;
     }
+    pucData = (unsigned char *)pulData;
 
     //
     // See if there are at least four pixels left to draw.
     //
-    if((lX1 + 3) <= lX2)
+    if(lCount >= 4)
     {
         //
         // Draw four pixels, leaving the buffer pointer half-word aligned.
         //
         *(unsigned short *)pucData = ulValue & 0xffff;
         pucData += 2;
-        lX1 += 4;
+        lCount -= 4;
     }
 
     //
     // See if there are at least two pixels left to draw.
     //
-    if((lX1 + 1) <= lX2)
+    if(lCount >= 2)
     {
         //
         // Draw two pixels, leaving the buffer pointer byte aligned.
         //
         *pucData++ = ulValue & 0xff;
-        lX1 += 2;
+        lCount -= 2;
     }
 
     //
     // See if there is one pixel left to draw.
     //
-    if(lX1 == lX2)
+    if(lCount == 1)
     {
         //
         // Draw the final pixel.
@@ -569,6 +799,67 @@ GrOffScreen4BPPLineDrawH(void *pvDisplayData, long lX1, long lX2, long lY,
     }
 }
 
+//*****************************************************************************
+//
+//! Draws a horizontal line.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX1 is the X coordinate of the start of the line.
+//! \param lX2 is the X coordinate of the end of the line.
+//! \param lY is the Y coordinate of the line.
+//! \param ulValue is the color of the line.
+//!
+//! This function draws a horizontal line on the display.  The coordinates of
+//! the line are assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen4BPPLineDrawH(void *pvDisplayData, long lX1, long lX2, long lY,
+                         unsigned long ulValue)
+{
+    unsigned char *pucData;
+    long lBytesPerRow;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+
+    //
+    // Create a character pointer for the display-specific data (which points
+    // to the image buffer).
+    //
+    pucData = (unsigned char *)pvDisplayData;
+
+    //
+    // Compute the number of bytes per row in the image buffer.
+    //
+    lBytesPerRow = (*(unsigned short *)(pucData + 1) + 1) / 2;
+
+    //
+    // Get the offset to the byte of the image buffer that contains the
+    // starting pixel.
+    //
+    pucData += (lBytesPerRow * lY) + (lX1 / 2) + 6 + (16 * 3);
+
+    //
+    // Copy the pixel value into all 8 pixels of the unsigned long.  This will
+    // be used later to write multiple pixels into memory (as opposed to one at
+    // a time).
+    //
+    ulValue = ((ulValue << 28) | (ulValue << 24) | (ulValue << 20) |
+               (ulValue << 16) | (ulValue << 12) | (ulValue << 8) |
+               (ulValue << 4) | ulValue);
+
+    //
+    // Draw the pixels of the line.
+    //
+    GrOffScreen4BPPSpanFill(pucData, lX1, lX2 - lX1 + 1, ulValue);
+}
+
 //*****************************************************************************
 //
 //! Draws a vertical line.
@@ -674,8 +965,8 @@ static void
 GrOffScreen4BPPRectFill(void *pvDisplayData, const tRectangle *pRect,
                         unsigned long ulValue)
 {
-    unsigned char *pucData, *pucColumn;
-    long lBytesPerRow, lX, lY;
+    unsigned char *pucData;
+    long lBytesPerRow, lWidth, lY;
 
     //
     // Check the arguments.
@@ -711,131 +1002,18 @@ GrOffScreen4BPPRectFill(void *pvDisplayData, const tRectangle *pRect,
                (ulValue << 4) | ulValue);
 
     //
-    // Get the starting X coordinate of the rectangle.
-    //
-    lX = pRect->sXMin;
-
-    //
-    // See if the second pixel in a byte is part of the rectangle.
-    //
-    if(lX & 1)
-    {
-        //
-        // Draw the second pixel of this column of the rectangle.
-        //
-        for(lY = pRect->sYMin, pucColumn = pucData; lY <= pRect->sYMax;
-            lY++, pucColumn += lBytesPerRow)
-        {
-            *pucColumn = (*pucColumn & 0xf0) | (ulValue & 0x0f);
-        }
-        pucData++;
-        lX++;
-    }
-
-    //
-    // See if the buffer pointer is not half-word aligned and there are at
-    // least two pixel columns left to draw.
-    //
-    if(((unsigned long)pucData & 1) && (pRect->sXMax - lX) > 0)
-    {
-        //
-        // Draw two pixels in this column of the rectangle.
-        //
-        for(lY = pRect->sYMin, pucColumn = pucData; lY <= pRect->sYMax;
-            lY++, pucColumn += lBytesPerRow)
-        {
-            *pucColumn = ulValue & 0xff;
-        }
-        pucData++;
-        lX += 2;
-    }
-
-    //
-    // See if the buffer pointer is not word aligned and there are at least
-    // four pixel columns left to draw.
-    //
-    if(((unsigned long)pucData & 2) && ((pRect->sXMax - lX) > 2))
-    {
-        //
-        // Draw four pixels in this column of the rectangle.
-        //
-        for(lY = pRect->sYMin, pucColumn = pucData; lY <= pRect->sYMax;
-            lY++, pucColumn += lBytesPerRow)
-        {
-            *(unsigned short *)pucColumn = ulValue & 0xffff;
-        }
-        pucData += 2;
-        lX += 4;
-    }
-
-    //
-    // Loop while there are at least eight pixel columns left to draw.
-    //
-    while((lX + 7) <= pRect->sXMax)
-    {
-        //
-        // Draw eight pixels in this column of the rectangle.
-        //
-        for(lY = pRect->sYMin, pucColumn = pucData; lY <= pRect->sYMax;
-            lY++, pucColumn += lBytesPerRow)
-        {
-            *(unsigned long *)pucColumn = ulValue;
-        }
-        pucData += 4;
-        lX += 8;
-    }
-
-    //
-    // See if there are at least four pixel columns left to draw.
-    //
-    if((lX + 3) <= pRect->sXMax)
-    {
-        //
-        // Draw four pixel columns, leaving the buffer pointer half-word
-        // aligned.
-        //
-        ulValue &= 0xffff;
-        for(lY = pRect->sYMin, pucColumn = pucData; lY <= pRect->sYMax;
-            lY++, pucColumn += lBytesPerRow)
-        {
-            *(unsigned short *)pucColumn = ulValue;
-        }
-        pucData += 2;
-        lX += 4;
-    }
-
-    //
-    // See if there are at least two pixel columns left to draw.
+    // Get the width of the rectangle.
     //
-    if((lX + 1) <= pRect->sXMax)
-    {
-        //
-        // Draw two pixel columns, leaving the buffer pointer byte aligned.
-        //
-        ulValue &= 0xff;
-        for(lY = pRect->sYMin, pucColumn = pucData; lY <= pRect->sYMax;
-            lY++, pucColumn += lBytesPerRow)
-        {
-            *pucColumn = ulValue;
-        }
-        pucData++;
-        lX += 2;
-    }
+    lWidth = pRect->sXMax - pRect->sXMin + 1;
 
     //
-    // See if there is one pixel column left to draw.
+    // Fill the rectangle one row at a time, so that the image buffer is
+    // written sequentially.
     //
-    if(lX == pRect->sXMax)
+    for(lY = pRect->sYMin; lY <= pRect->sYMax; lY++)
     {
-        //
-        // Draw the final pixel column.
-        //
-        ulValue = ulValue & 0xf0;
-        for(lY = pRect->sYMin; lY <= pRect->sYMax;
-            lY++, pucData += lBytesPerRow)
-        {
-            *pucData = (*pucData & 0x0f) | ulValue;
-        }
+        GrOffScreen4BPPSpanFill(pucData, pRect->sXMin, lWidth, ulValue);
+        pucData += lBytesPerRow;
     }
 }
 
@@ -958,6 +1136,12 @@ GrOffScreen4BPPPaletteSet(tDisplay *pDisplay, unsigned long *pulPalette,
     //
     pucData += ulOffset * 3;
 
+    //
+    // Discard any cached palette translations, since they may no longer be
+    // valid.
+    //
+    g_pvImageDisplay = 0;
+
     //
     // Loop while there are more palette entries to add.
     //
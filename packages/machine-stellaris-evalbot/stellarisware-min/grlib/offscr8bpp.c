@@ -22,6 +22,7 @@
 //
 //*****************************************************************************
 
+#include "inc/hw_types.h"
 #include "driverlib/debug.h"
 #include "grlib/grlib.h"
 
@@ -117,6 +118,207 @@ GrOffScreen8BPPColorTranslate(void *pvDisplayData, unsigned long ulValue)
     return(ulMatchIdx);
 }
 
+//*****************************************************************************
+//
+// The state used to translate the palette of the image that is currently
+// being drawn into an off-screen buffer.  The display and palette pointers
+// identify the image; the translation of each palette index is computed the
+// first time that it is used and then remembered (as indicated by the
+// corresponding bit in g_pulImageValid).  g_bImageMatch is true when the image
+// palette is identical to the off-screen buffer palette, in which case 8 BPP
+// image rows are copied without translation.
+//
+//*****************************************************************************
+static const void *g_pvImageDisplay;
+static const unsigned char *g_pucImagePalette;
+static tBoolean g_bImageMatch;
+static unsigned long g_pulImageValid[256 / 32];
+static unsigned char g_pucImageTranslate[256];
+
+//*****************************************************************************
+//
+//! Prepares to draw a new image into the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param pucPalette is a pointer to the palette of the 4 or 8 BPP image.
+//!
+//! This function discards the palette translations for the previous image and
+//! determines if the palette of the new image matches the palette of the
+//! off-screen buffer.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen8BPPImageStart(void *pvDisplayData,
+                          const unsigned char *pucPalette)
+{
+    const unsigned char *pucBuffer;
+    unsigned long ulIdx, ulCount;
+
+    //
+    // Remember the image that is being drawn.
+    //
+    g_pvImageDisplay = pvDisplayData;
+    g_pucImagePalette = pucPalette;
+
+    //
+    // Forget the palette translations of the previous image.
+    //
+    for(ulIdx = 0; ulIdx < (256 / 32); ulIdx++)
+    {
+        g_pulImageValid[ulIdx] = 0;
+    }
+
+    //
+    // Get a pointer to the palette for the off-screen buffer.
+    //
+    pucBuffer = (unsigned char *)pvDisplayData + 6;
+
+    //
+    // Compare the image palette against the start of the off-screen buffer
+    // palette.  The byte preceding the image palette contains the number of
+    // palette entries minus one.
+    //
+    ulCount = (pucPalette[-1] + 1) * 3;
+    for(ulIdx = 0; ulIdx < ulCount; ulIdx++)
+    {
+        if(pucPalette[ulIdx] != pucBuffer[ulIdx])
+        {
+            break;
+        }
+    }
+    g_bImageMatch = (ulIdx == ulCount) ? true : false;
+}
+
+//*****************************************************************************
+//
+//! Translates an image palette index to an off-screen buffer color.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param pucPalette is a pointer to the palette of the 4 or 8 BPP image.
+//! \param ulIndex is the palette index of the image pixel.
+//!
+//! This function translates the given entry of an image palette into the
+//! closest color in the off-screen buffer palette.  If the image is the one
+//! that is currently being drawn, the translation is only computed once for
+//! each palette index.
+//!
+//! \return Returns the off-screen buffer color.
+//
+//*****************************************************************************
+static unsigned long
+GrOffScreen8BPPIndexTranslate(void *pvDisplayData,
+                              const unsigned char *pucPalette,
+                              unsigned long ulIndex)
+{
+    unsigned long ulValue;
+
+    //
+    // See if this pixel belongs to the image that is currently being drawn
+    // and the translation of this palette index is already known.
+    //
+    if((pvDisplayData == g_pvImageDisplay) &&
+       (pucPalette == g_pucImagePalette) &&
+       (g_pulImageValid[ulIndex / 32] & (1 << (ulIndex & 31))))
+    {
+        return(g_pucImageTranslate[ulIndex]);
+    }
+
+    //
+    // Extract the corresponding entry from the palette and translate it.
+    //
+    ulValue = *(unsigned long *)(pucPalette + (ulIndex * 3)) & 0x00ffffff;
+    ulValue = GrOffScreen8BPPColorTranslate(pvDisplayData, ulValue);
+
+    //
+    // Remember the translation if this pixel belongs to the image that is
+    // currently being drawn.
+    //
+    if((pvDisplayData == g_pvImageDisplay) &&
+       (pucPalette == g_pucImagePalette))
+    {
+        g_pucImageTranslate[ulIndex] = ulValue;
+        g_pulImageValid[ulIndex / 32] |= 1 << (ulIndex & 31);
+    }
+
+    //
+    // Return the translated color.
+    //
+    return(ulValue);
+}
+
+//*****************************************************************************
+//
+//! Copies a row of pixels into the off-screen buffer.
+//!
+//! \param pucDst is a pointer to the first destination pixel.
+//! \param pucSrc is a pointer to the first source pixel.
+//! \param lCount is the number of pixels to copy.
+//!
+//! This function copies pixels that do not require translation.  When the
+//! source and destination have the same word alignment, the bulk of the row is
+//! copied with aligned word loads and stores.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen8BPPRowCopy(unsigned char *pucDst, const unsigned char *pucSrc,
+                       long lCount)
+{
+    unsigned long *pulDst;
+    const unsigned long *pulSrc;
+
+    //
+    // See if the source and destination have the same word alignment.
+    //
+    if((((unsigned long)pucDst ^ (unsigned long)pucSrc) & 3) == 0)
+    {
+        //
+        // Copy pixels until the pointers are word aligned.
+        //
+        while(((unsigned long)pucDst & 3) && lCount)
+        {
+            *pucDst++ = *pucSrc++;
+            lCount--;
+        }
+
+        //
+        // Copy sixteen pixels at a time, then four pixels at a time.
+        //
+        pulDst = (unsigned long *)pucDst;
+        pulSrc = (const unsigned long *)pucSrc;
+        while(lCount >= 16)
+        {
+            pulDst[0] = pulSrc[0];
+            pulDst[1] = pulSrc[1];
+            pulDst[2] = pulSrc[2];
+            pulDst[3] = pulSrc[3];
+            pulDst += 4;
+            pulSrc += 4;
+            lCount -= 16;
+        }
+        while(lCount >= 4)
+        {
+            *pulDst++ = *pulSrc++;
+            lCount -= 4;
+        }
+        pucDst = (unsigned char *)pulDst;
+        pucSrc = (const unsigned char *)pulSrc;
+    }
+
+    //
+    // Copy any remaining pixels.
+    //
+    while(lCount--)
+    {
+        *pucDst++ = *pucSrc++;
+    }
+}
+
 //*****************************************************************************
 //
 //! Draws a pixel on the screen.
@@ -215,11 +417,20 @@ GrOffScreen8BPPPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
     //
     pucPtr += (*(unsigned short *)(pucPtr + 1) * lY) + lX + 6 + (256 * 3);
 
+    //
+    // If this is the first row of a 4 or 8 BPP image, prepare the palette
+    // translation for the image.
+    //
+    if((lBPP & GRLIB_DRIVER_FLAG_NEW_IMAGE) && ((lBPP & 0xff) != 1))
+    {
+        GrOffScreen8BPPImageStart(pvDisplayData, pucPalette);
+    }
+
     //
     // Determine how to interpret the pixel data based on the number of bits
     // per pixel.
     //
-    switch(lBPP)
+    switch(lBPP & 0xff)
     {
         //
         // The pixel data is in 1 bit per pixel format.
@@ -281,21 +492,13 @@ GrOffScreen8BPPPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
                     while(lCount)
                     {
                         //
-                        // Get the upper nibble of the next byte of pixel data
-                        // and extract the corresponding entry from the
-                        // palette.
-                        //
-                        ulByte = (*pucData >> 4) * 3;
-                        ulByte = (*(unsigned long *)(pucPalette + ulByte) &
-                                  0x00ffffff);
-
-                        //
-                        // Translate this palette entry and write it to the
-                        // screen.
+                        // Translate the upper nibble of the next byte of pixel
+                        // data and write it to the screen.
                         //
                         *pucPtr++ =
-                            GrOffScreen8BPPColorTranslate(pvDisplayData,
-                                                          ulByte);
+                            GrOffScreen8BPPIndexTranslate(pvDisplayData,
+                                                          pucPalette,
+                                                          *pucData >> 4);
 
                         //
                         // Decrement the count of pixels to draw.
@@ -309,21 +512,13 @@ GrOffScreen8BPPPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
                         {
                 case 1:
                             //
-                            // Get the lower nibble of the next byte of pixel
-                            // data and extract the corresponding entry from
-                            // the palette.
-                            //
-                            ulByte = (*pucData++ & 15) * 3;
-                            ulByte = (*(unsigned long *)(pucPalette + ulByte) &
-                                      0x00ffffff);
-
-                            //
-                            // Translate this palette entry and write it to the
-                            // screen.
+                            // Translate the lower nibble of the next byte of
+                            // pixel data and write it to the screen.
                             //
                             *pucPtr++ =
-                                GrOffScreen8BPPColorTranslate(pvDisplayData,
-                                                              ulByte);
+                                GrOffScreen8BPPIndexTranslate(pvDisplayData,
+                                                              pucPalette,
+                                                              *pucData++ & 15);
 
                             //
                             // Decrement the count of pixels to draw.
@@ -344,23 +539,29 @@ GrOffScreen8BPPPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
         //
         case 8:
         {
+            //
+            // If the image palette matches the off-screen buffer palette, the
+            // pixel data can be copied directly into the buffer.
+            //
+            if((pvDisplayData == g_pvImageDisplay) &&
+               (pucPalette == g_pucImagePalette) && g_bImageMatch)
+            {
+                GrOffScreen8BPPRowCopy(pucPtr, pucData, lCount);
+                break;
+            }
+
             //
             // Loop while there are more pixels to draw.
             //
             while(lCount--)
             {
                 //
-                // Get the next byte of pixel data and extract the
-                // corresponding entry from the palette.
-                //
-                ulByte = *pucData++ * 3;
-                ulByte = *(unsigned long *)(pucPalette + ulByte) & 0x00ffffff;
-
-                //
-                // Translate this palette entry and write it to the screen.
+                // Translate the next byte of pixel data and write it to the
+                // screen.
                 //
-                *pucPtr++ = GrOffScreen8BPPColorTranslate(pvDisplayData,
-                                                          ulByte);
+                *pucPtr++ = GrOffScreen8BPPIndexTranslate(pvDisplayData,
+                                                          pucPalette,
+                                                          *pucData++);
             }
 
             //
@@ -373,107 +574,91 @@ GrOffScreen8BPPPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
 
 //*****************************************************************************
 //
-//! Draws a horizontal line.
+//! Fills a span of pixels within a row of the off-screen buffer.
 //!
-//! \param pvDisplayData is a pointer to the driver-specific data for this
-//! display driver.
-//! \param lX1 is the X coordinate of the start of the line.
-//! \param lX2 is the X coordinate of the end of the line.
-//! \param lY is the Y coordinate of the line.
-//! \param ulValue is the color of the line.
+//! \param pucData is a pointer to the byte of the image buffer that contains
+//! the first pixel of the span.
+//! \param lCount is the number of pixels in the span.
+//! \param ulValue is the color of the span, copied into all 4 pixels of the
+//! unsigned long.
 //!
-//! This function draws a horizontal line on the display.  The coordinates of
-//! the line are assumed to be within the extents of the display.
+//! This function draws the pixels up to the first word boundary with byte and
+//! half-word stores, the middle of the span with aligned word stores, and the
+//! pixels after the last word boundary with half-word and byte stores.
 //!
 //! \return None.
 //
 //*****************************************************************************
 static void
-GrOffScreen8BPPLineDrawH(void *pvDisplayData, long lX1, long lX2, long lY,
-                         unsigned long ulValue)
+GrOffScreen8BPPSpanFill(unsigned char *pucData, long lCount,
+                        unsigned long ulValue)
 {
-    unsigned char *pucData;
-
-    //
-    // Check the arguments.
-    //
-    ASSERT(pvDisplayData);
-
-    //
-    // Create a character pointer for the display-specific data (which points
-    // to the image buffer).
-    //
-    pucData = (unsigned char *)pvDisplayData;
-
-    //
-    // Get the offset to the byte of the image buffer that contains the
-    // starting pixel.
-    //
-    pucData += (*(unsigned short *)(pucData + 1) * lY) + lX1 + 6 + (256 * 3);
-
-    //
-    // Copy the pixel value into all 4 pixels of the unsigned long.  This will
-    // be used later to write multiple pixels into memory (as opposed to one at
-    // a time).
-    //
-    ulValue = (ulValue << 24) | (ulValue << 16) | (ulValue << 8) | ulValue;
+    unsigned long *pulData;
 
     //
     // See if the buffer pointer is not half-word aligned.
     //
-    if(((unsigned long)pucData) & 1)
+    if(((unsigned long)pucData & 1) && (lCount > 0))
     {
         //
         // Draw one pixel to half-word align the buffer pointer.
         //
         *pucData++ = ulValue & 0xff;
-        lX1++;
+        lCount--;
     }
 
     //
     // See if the buffer pointer is not word aligned and there are at least two
     // pixels left to draw.
     //
-    if(((unsigned long)pucData & 2) && ((lX2 - lX1) > 0))
+    if(((unsigned long)pucData & 2) && (lCount >= 2))
     {
         //
         // Draw two pixels to word align the buffer pointer.
         //
         *(unsigned short *)pucData = ulValue & 0xffff;
         pucData += 2;
-        lX1 += 2;
+        lCount -= 2;
     }
 
     //
-    // Loop while there are at least four pixels left to draw.
+    // Draw sixteen pixels at a time while there are enough left to draw, then
+    // four pixels at a time.
     //
-    while((lX1 + 3) <= lX2)
+    pulData = (unsigned long *)pucData;
+    while(lCount >= 16)
     {
-        //
-        // Draw four pixels.
-        //
-        *(unsigned long *)pucData = ulValue;
-        pucData += 4;
-        lX1 += 4;
+        pulData[0] = ulValue;
+        pulData[1] = ulValue;
+        pulData[2] = ulValue;
+        pulData[3] = ulValue;
+        pulData += 4;
+        lCount -= 16;
     }
+    while(lCount >= 4)
+    {
+        *pulData++ = ulValue;
+        lCount -= 4;
+    }
+    pucData = (unsigned char *)pulData;
 
     //
     // See if there are at least two pixels left to draw.
     //
-    if((lX1 + 1) <= lX2)
+    if(lCount >= 2)
     {
         //
         // Draw two pixels, leaving the buffer pointer half-word aligned.
         //
         *(unsigned short *)pucData = ulValue & 0xffff;
         pucData += 2;
-        lX1 += 2;
+        lCount -= 2;
     }
 
     //
     // See if there is one pixel left to draw.
     //
-    if(lX1 == lX2)
+    if(lCount == 1)
     {
         //
         // Draw the final pixel.
@@ -482,6 +667,59 @@ GrOffScreen8BPPLineDrawH(void *pvDisplayData, long lX1, long lX2, long lY,
     }
 }
 
+//*****************************************************************************
+//
+//! Draws a horizontal line.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX1 is the X coordinate of the start of the line.
+//! \param lX2 is the X coordinate of the end of the line.
+//! \param lY is the Y coordinate of the line.
+//! \param ulValue is the color of the line.
+//!
+//! This function draws a horizontal line on the display.  The coordinates of
+//! the line are assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen8BPPLineDrawH(void *pvDisplayData, long lX1, long lX2, long lY,
+                         unsigned long ulValue)
+{
+    unsigned char *pucData;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+
+    //
+    // Create a character pointer for the display-specific data (which points
+    // to the image buffer).
+    //
+    pucData = (unsigned char *)pvDisplayData;
+
+    //
+    // Get the offset to the byte of the image buffer that contains the
+    // starting pixel.
+    //
+    pucData += (*(unsigned short *)(pucData + 1) * lY) + lX1 + 6 + (256 * 3);
+
+    //
+    // Copy the pixel value into all 4 pixels of the unsigned long.  This will
+    // be used later to write multiple pixels into memory (as opposed to one at
+    // a time).
+    //
+    ulValue = (ulValue << 24) | (ulValue << 16) | (ulValue << 8) | ulValue;
+
+    //
+    // Draw the pixels of the line.
+    //
+    GrOffScreen8BPPSpanFill(pucData, lX2 - lX1 + 1, ulValue);
+}
+
 //*****************************************************************************
 //
 //! Draws a vertical line.
@@ -559,8 +797,8 @@ static void
 GrOffScreen8BPPRectFill(void *pvDisplayData, const tRectangle *pRect,
                         unsigned long ulValue)
 {
-    unsigned char *pucData, *pucPtr;
-    long lBytesPerRow, lX, lY;
+    unsigned char *pucData;
+    long lBytesPerRow, lWidth, lY;
 
     //
     // Check the arguments.
@@ -593,95 +831,18 @@ GrOffScreen8BPPRectFill(void *pvDisplayData, const tRectangle *pRect,
     ulValue = (ulValue << 24) | (ulValue << 16) | (ulValue << 8) | ulValue;
 
     //
-    // Get the starting X coordinate.
+    // Get the width of the rectangle.
     //
-    lX = pRect->sXMin;
+    lWidth = pRect->sXMax - pRect->sXMin + 1;
 
     //
-    // See if the buffer pointer is not half-word aligned.
-    //
-    if(((unsigned long)pucData) & 1)
-    {
-        //
-        // Draw one pixel column to half-word align the buffer pointer.
-        //
-        for(lY = pRect->sYMin, pucPtr = pucData; lY <= pRect->sYMax;
-            lY++, pucPtr += lBytesPerRow)
-        {
-            *pucPtr = ulValue & 0xff;
-        }
-        pucData++;
-        lX++;
-    }
-
-    //
-    // See if the buffer pointer is not word aligned and there are at least two
-    // pixel columns left to draw.
+    // Fill the rectangle one row at a time, so that the image buffer is
+    // written sequentially.
     //
-    if(((unsigned long)pucData & 2) && ((pRect->sXMax - lX) > 0))
+    for(lY = pRect->sYMin; lY <= pRect->sYMax; lY++)
     {
-        //
-        // Draw two pixel columns to word align the buffer pointer.
-        //
-        for(lY = pRect->sYMin, pucPtr = pucData; lY <= pRect->sYMax;
-            lY++, pucPtr += lBytesPerRow)
-        {
-            *(unsigned short *)pucPtr = ulValue & 0xffff;
-        }
-        pucData += 2;
-        lX += 2;
-    }
-
-    //
-    // Loop while there are at least four pixel columns left to draw.
-    //
-    while((lX + 3) <= pRect->sXMax)
-    {
-        //
-        // Draw four pixel columns.
-        //
-        for(lY = pRect->sYMin, pucPtr = pucData; lY <= pRect->sYMax;
-            lY++, pucPtr += lBytesPerRow)
-        {
-            *(unsigned long *)pucPtr = ulValue;
-        }
-        pucData += 4;
-        lX += 4;
-    }
-
-    //
-    // See if ther are at least two pixel columns left to draw.
-    //
-    if((lX + 1) <= pRect->sXMax)
-    {
-        //
-        // Draw two pixel columns, leaving the buffer pointer half-word
-        // aligned.
-        //
-        ulValue &= 0xffff;
-        for(lY = pRect->sYMin, pucPtr = pucData; lY <= pRect->sYMax;
-            lY++, pucPtr += lBytesPerRow)
-        {
-            *(unsigned short *)pucPtr = ulValue;
-        }
-        pucData += 2;
-        lX += 2;
-    }
-
-    //
-    // See if there is one pixel column left to draw.
-    //
-    if(lX == pRect->sXMax)
-    {
-        //
-        // Draw the final pixel column.
-        //
-        ulValue &= 0xff;
-        for(lY = pRect->sYMin; lY <= pRect->sYMax;
-            lY++, pucData += lBytesPerRow)
-        {
-            *pucData = ulValue;
-        }
+        GrOffScreen8BPPSpanFill(pucData, lWidth, ulValue);
+        pucData += lBytesPerRow;
     }
 }
 
@@ -804,6 +965,12 @@ GrOffScreen8BPPPaletteSet(tDisplay *pDisplay, unsigned long *pulPalette,
     //
     pucData += ulOffset * 3;
 
+    //
+    // Discard any cached palette translations, since they may no longer be
+    // valid.
+    //
+    g_pvImageDisplay = 0;
+
     //
     // Loop while there are more palette entries to add.
     //
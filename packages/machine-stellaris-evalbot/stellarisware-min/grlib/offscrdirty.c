@@ -0,0 +1,566 @@
+//*****************************************************************************
+//
+// offscrdirty.c - Dirty-region tracking for off-screen display buffers.
+//
+// Copyright (c) 2008-2013 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 10636 of the Stellaris Graphics Library.
+//
+//*****************************************************************************
+
+#include "driverlib/debug.h"
+#include "grlib/grlib.h"
+
+//*****************************************************************************
+//
+// Make sure min and max are defined.
+//
+//*****************************************************************************
+#ifndef min
+#define min(a, b)               (((a) < (b)) ? (a) : (b))
+#endif
+
+#ifndef max
+#define max(a, b)               (((a) < (b)) ? (b) : (a))
+#endif
+
+//*****************************************************************************
+//
+//! \addtogroup primitives_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Grows the dirty region so that it includes the given rectangle.
+//
+// \param psDirty is a pointer to the dirty-region tracking state.
+// \param lX1 is the minimum X coordinate of the modified rectangle.
+// \param lY1 is the minimum Y coordinate of the modified rectangle.
+// \param lX2 is the maximum X coordinate of the modified rectangle.
+// \param lY2 is the maximum Y coordinate of the modified rectangle.
+//
+// This function extends the bounding box of the modified pixels.  If the
+// dirty region is currently empty, it becomes the given rectangle.
+//
+// \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreenDirtyExtend(tOffScreenDirty *psDirty, long lX1, long lY1, long lX2,
+                       long lY2)
+{
+    //
+    // See if the dirty region is currently empty.
+    //
+    if(psDirty->sDirty.sXMin > psDirty->sDirty.sXMax)
+    {
+        //
+        // The dirty region becomes the given rectangle.
+        //
+        psDirty->sDirty.sXMin = lX1;
+        psDirty->sDirty.sYMin = lY1;
+        psDirty->sDirty.sXMax = lX2;
+        psDirty->sDirty.sYMax = lY2;
+        return;
+    }
+
+    //
+    // Grow each edge of the dirty region as required to enclose the given
+    // rectangle.
+    //
+    if(lX1 < psDirty->sDirty.sXMin)
+    {
+        psDirty->sDirty.sXMin = lX1;
+    }
+    if(lY1 < psDirty->sDirty.sYMin)
+    {
+        psDirty->sDirty.sYMin = lY1;
+    }
+    if(lX2 > psDirty->sDirty.sXMax)
+    {
+        psDirty->sDirty.sXMax = lX2;
+    }
+    if(lY2 > psDirty->sDirty.sYMax)
+    {
+        psDirty->sDirty.sYMax = lY2;
+    }
+}
+
+//*****************************************************************************
+//
+//! Draws a pixel on the screen.
+//!
+//! \param pvDisplayData is a pointer to the dirty-region tracking state.
+//! \param lX is the X coordinate of the pixel.
+//! \param lY is the Y coordinate of the pixel.
+//! \param ulValue is the color of the pixel.
+//!
+//! This function draws the given pixel on the underlying display and adds it
+//! to the dirty region.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreenDirtyPixelDraw(void *pvDisplayData, long lX, long lY,
+                          unsigned long ulValue)
+{
+    tOffScreenDirty *psDirty;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+
+    //
+    // Draw the pixel on the underlying display.
+    //
+    psDirty = (tOffScreenDirty *)pvDisplayData;
+    DpyPixelDraw(psDirty->pDisplay, lX, lY, ulValue);
+
+    //
+    // Add the pixel to the dirty region.
+    //
+    GrOffScreenDirtyExtend(psDirty, lX, lY, lX, lY);
+}
+
+//*****************************************************************************
+//
+//! Draws a horizontal sequence of pixels on the screen.
+//!
+//! \param pvDisplayData is a pointer to the dirty-region tracking state.
+//! \param lX is the X coordinate of the first pixel.
+//! \param lY is the Y coordinate of the first pixel.
+//! \param lX0 is sub-pixel offset within the pixel data, which is valid for 1
+//! or 4 bit per pixel formats.
+//! \param lCount is the number of pixels to draw.
+//! \param lBPP is the number of bits per pixel; must be 1, 4, or 8.
+//! \param pucData is a pointer to the pixel data.
+//! \param pucPalette is a pointer to the palette used to draw the pixels.
+//!
+//! This function draws the given pixels on the underlying display and adds
+//! them to the dirty region.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreenDirtyPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
+                                  long lX0, long lCount, long lBPP,
+                                  const unsigned char *pucData,
+                                  const unsigned char *pucPalette)
+{
+    tOffScreenDirty *psDirty;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+
+    //
+    // Draw the pixels on the underlying display.
+    //
+    psDirty = (tOffScreenDirty *)pvDisplayData;
+    DpyPixelDrawMultiple(psDirty->pDisplay, lX, lY, lX0, lCount, lBPP,
+                         pucData, pucPalette);
+
+    //
+    // Add the pixels to the dirty region.
+    //
+    if(lCount > 0)
+    {
+        GrOffScreenDirtyExtend(psDirty, lX, lY, lX + lCount - 1, lY);
+    }
+}
+
+//*****************************************************************************
+//
+//! Draws a horizontal line.
+//!
+//! \param pvDisplayData is a pointer to the dirty-region tracking state.
+//! \param lX1 is the X coordinate of the start of the line.
+//! \param lX2 is the X coordinate of the end of the line.
+//! \param lY is the Y coordinate of the line.
+//! \param ulValue is the color of the line.
+//!
+//! This function draws a horizontal line on the underlying display and adds
+//! it to the dirty region.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreenDirtyLineDrawH(void *pvDisplayData, long lX1, long lX2, long lY,
+                          unsigned long ulValue)
+{
+    tOffScreenDirty *psDirty;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+
+    //
+    // Draw the line on the underlying display.
+    //
+    psDirty = (tOffScreenDirty *)pvDisplayData;
+    DpyLineDrawH(psDirty->pDisplay, lX1, lX2, lY, ulValue);
+
+    //
+    // Add the line to the dirty region.
+    //
+    GrOffScreenDirtyExtend(psDirty, lX1, lY, lX2, lY);
+}
+
+//*****************************************************************************
+//
+//! Draws a vertical line.
+//!
+//! \param pvDisplayData is a pointer to the dirty-region tracking state.
+//! \param lX is the X coordinate of the line.
+//! \param lY1 is the Y coordinate of the start of the line.
+//! \param lY2 is the Y coordinate of the end of the line.
+//! \param ulValue is the color of the line.
+//!
+//! This function draws a vertical line on the underlying display and adds it
+//! to the dirty region.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreenDirtyLineDrawV(void *pvDisplayData, long lX, long lY1, long lY2,
+                          unsigned long ulValue)
+{
+    tOffScreenDirty *psDirty;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+
+    //
+    // Draw the line on the underlying display.
+    //
+    psDirty = (tOffScreenDirty *)pvDisplayData;
+    DpyLineDrawV(psDirty->pDisplay, lX, lY1, lY2, ulValue);
+
+    //
+    // Add the line to the dirty region.
+    //
+    GrOffScreenDirtyExtend(psDirty, lX, lY1, lX, lY2);
+}
+
+//*****************************************************************************
+//
+//! Fills a rectangle.
+//!
+//! \param pvDisplayData is a pointer to the dirty-region tracking state.
+//! \param pRect is a pointer to the structure describing the rectangle.
+//! \param ulValue is the color of the rectangle.
+//!
+//! This function fills a rectangle on the underlying display and adds it to
+//! the dirty region.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreenDirtyRectFill(void *pvDisplayData, const tRectangle *pRect,
+                         unsigned long ulValue)
+{
+    tOffScreenDirty *psDirty;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+    ASSERT(pRect);
+
+    //
+    // Fill the rectangle on the underlying display.
+    //
+    psDirty = (tOffScreenDirty *)pvDisplayData;
+    DpyRectFill(psDirty->pDisplay, pRect, ulValue);
+
+    //
+    // Add the rectangle to the dirty region.
+    //
+    GrOffScreenDirtyExtend(psDirty, pRect->sXMin, pRect->sYMin, pRect->sXMax,
+                           pRect->sYMax);
+}
+
+//*****************************************************************************
+//
+//! Translates a 24-bit RGB color to a display driver-specific color.
+//!
+//! \param pvDisplayData is a pointer to the dirty-region tracking state.
+//! \param ulValue is the 24-bit RGB color.  The least-significant byte is the
+//! blue channel, the next byte is the green channel, and the third byte is the
+//! red channel.
+//!
+//! This function translates a 24-bit RGB color using the underlying display.
+//!
+//! \return Returns the display-driver specific color.
+//
+//*****************************************************************************
+static unsigned long
+GrOffScreenDirtyColorTranslate(void *pvDisplayData, unsigned long ulValue)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+
+    //
+    // Translate the color using the underlying display.
+    //
+    return(DpyColorTranslate(((tOffScreenDirty *)pvDisplayData)->pDisplay,
+                             ulValue));
+}
+
+//*****************************************************************************
+//
+//! Flushes any cached drawing operations.
+//!
+//! \param pvDisplayData is a pointer to the dirty-region tracking state.
+//!
+//! This functions flushes the underlying display and then, if any pixels have
+//! been modified since the last flush, passes the bounding box of the modified
+//! pixels to the flush function supplied to GrOffScreenDirtyInit().  The dirty
+//! region is empty once this function returns.  If nothing has been drawn
+//! since the last flush, the flush function is not called at all.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreenDirtyFlush(void *pvDisplayData)
+{
+    tOffScreenDirty *psDirty;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+
+    //
+    // Flush the underlying display.
+    //
+    psDirty = (tOffScreenDirty *)pvDisplayData;
+    DpyFlush(psDirty->pDisplay);
+
+    //
+    // Return without doing anything if no pixels have been modified.
+    //
+    if(GrOffScreenDirtyIsEmpty(psDirty))
+    {
+        return;
+    }
+
+    //
+    // Copy the modified region to the physical display.
+    //
+    if(psDirty->pfnFlush)
+    {
+        psDirty->pfnFlush(psDirty->pvFlushData, &psDirty->sDirty);
+    }
+
+    //
+    // The dirty region has now been flushed.
+    //
+    GrOffScreenDirtyClear(psDirty);
+}
+
+//*****************************************************************************
+//
+//! Initializes a dirty-region tracking display.
+//!
+//! \param pDisplay is a pointer to the display structure to be configured.
+//! \param psDirty is a pointer to the dirty-region tracking state, which must
+//! remain valid for as long as \e pDisplay is in use.
+//! \param pOffScreen is a pointer to the display to which the drawing
+//! operations are passed; this is typically a display initialized with
+//! GrOffScreen1BPPInit(), GrOffScreen4BPPInit() or GrOffScreen8BPPInit().
+//! \param pfnFlush is a pointer to the function that copies a region of the
+//! off-screen buffer to the physical display, or zero if the application will
+//! query the dirty region itself.
+//! \param pvFlushData is the pointer that is passed to \e pfnFlush.
+//!
+//! This function initializes a display structure that passes all drawing
+//! operations on to \e pOffScreen while keeping a bounding box of every pixel
+//! written.  When the display is flushed via GrFlush(), \e pfnFlush is called
+//! with the bounding box of the modified pixels, allowing the physical display
+//! to be updated with only the region that has changed rather than the whole
+//! frame buffer.
+//!
+//! Drawing performed directly on \e pOffScreen (or directly into its image
+//! buffer) is not tracked; GrOffScreenDirtyAdd() can be used to mark such a
+//! region as modified.
+//!
+//! The dirty region is initially empty.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrOffScreenDirtyInit(tDisplay *pDisplay, tOffScreenDirty *psDirty,
+                     const tDisplay *pOffScreen,
+                     void (*pfnFlush)(void *pvFlushData,
+                                      const tRectangle *pRect),
+                     void *pvFlushData)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(pDisplay);
+    ASSERT(psDirty);
+    ASSERT(pOffScreen);
+
+    //
+    // Initialize the dirty-region tracking state.
+    //
+    psDirty->pDisplay = pOffScreen;
+    psDirty->pfnFlush = pfnFlush;
+    psDirty->pvFlushData = pvFlushData;
+    GrOffScreenDirtyClear(psDirty);
+
+    //
+    // Initialize the display structure.
+    //
+    pDisplay->lSize = sizeof(tDisplay);
+    pDisplay->pvDisplayData = psDirty;
+    pDisplay->usWidth = pOffScreen->usWidth;
+    pDisplay->usHeight = pOffScreen->usHeight;
+    pDisplay->pfnPixelDraw = GrOffScreenDirtyPixelDraw;
+    pDisplay->pfnPixelDrawMultiple = GrOffScreenDirtyPixelDrawMultiple;
+    pDisplay->pfnLineDrawH = GrOffScreenDirtyLineDrawH;
+    pDisplay->pfnLineDrawV = GrOffScreenDirtyLineDrawV;
+    pDisplay->pfnRectFill = GrOffScreenDirtyRectFill;
+    pDisplay->pfnColorTranslate = GrOffScreenDirtyColorTranslate;
+    pDisplay->pfnFlush = GrOffScreenDirtyFlush;
+}
+
+//*****************************************************************************
+//
+//! Marks a region of a dirty-region tracking display as modified.
+//!
+//! \param psDirty is a pointer to the dirty-region tracking state.
+//! \param pRect is a pointer to the rectangle to add to the dirty region.
+//!
+//! This function adds a rectangle to the dirty region, forcing it to be copied
+//! to the physical display on the next flush.  This is required when the
+//! off-screen buffer is modified without going through the tracking display,
+//! and can also be used to force a full refresh of the physical display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrOffScreenDirtyAdd(tOffScreenDirty *psDirty, const tRectangle *pRect)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(psDirty);
+    ASSERT(pRect);
+
+    //
+    // Add the rectangle to the dirty region.
+    //
+    GrOffScreenDirtyExtend(psDirty, pRect->sXMin, pRect->sYMin, pRect->sXMax,
+                           pRect->sYMax);
+}
+
+//*****************************************************************************
+//
+//! Copies a region of an off-screen buffer onto a display.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param pucImage is a pointer to the off-screen image buffer.
+//! \param lX is the X coordinate at which the upper left corner of the
+//! off-screen buffer is placed.
+//! \param lY is the Y coordinate at which the upper left corner of the
+//! off-screen buffer is placed.
+//! \param pRect is a pointer to the region of the off-screen buffer to copy,
+//! in off-screen buffer coordinates (typically the rectangle passed to the
+//! flush function of a dirty-region tracking display).
+//!
+//! This function draws the part of the off-screen buffer that lies within
+//! \e pRect, as if GrImageDraw() had been called with the clipping region
+//! reduced to that area.  Rows above and below the region are skipped and only
+//! the pixels within the region are passed to the display driver, so the cost
+//! of the copy is proportional to the size of the region rather than the size
+//! of the buffer.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrOffScreenDirtyBlit(const tContext *pContext, const unsigned char *pucImage,
+                     long lX, long lY, const tRectangle *pRect)
+{
+    tRectangle sRegion;
+    tContext sContext;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pContext);
+    ASSERT(pucImage);
+    ASSERT(pRect);
+
+    //
+    // Translate the region into display coordinates and reduce it to the part
+    // that lies within the clipping region.  GrRectIntersectGet() is not used
+    // since it rejects regions that are a single row or column, which are
+    // common dirty regions.
+    //
+    sRegion.sXMin = max(pRect->sXMin + lX, pContext->sClipRegion.sXMin);
+    sRegion.sYMin = max(pRect->sYMin + lY, pContext->sClipRegion.sYMin);
+    sRegion.sXMax = min(pRect->sXMax + lX, pContext->sClipRegion.sXMax);
+    sRegion.sYMax = min(pRect->sYMax + lY, pContext->sClipRegion.sYMax);
+
+    //
+    // Return without doing anything if none of the region is visible.
+    //
+    if((sRegion.sXMin > sRegion.sXMax) || (sRegion.sYMin > sRegion.sYMax))
+    {
+        return;
+    }
+
+    //
+    // Reduce the clipping region of a copy of the drawing context to the
+    // visible part of the region.
+    //
+    sContext = *pContext;
+    sContext.sClipRegion = sRegion;
+
+    //
+    // Draw the off-screen buffer through the reduced clipping region.
+    //
+    GrImageDraw(&sContext, pucImage, lX, lY);
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -51,6 +51,17 @@
 //*****************************************************************************
 #define QUEUE_SIZE              16
 
+//*****************************************************************************
+//
+// The maximum number of separate widget trees that can be awaiting a repaint
+// via WidgetInvalidate().  Invalidating a widget whose ancestor is already
+// invalid does not consume an entry.
+//
+//*****************************************************************************
+#ifndef INVALID_LIST_SIZE
+#define INVALID_LIST_SIZE       8
+#endif
+
 #ifdef DEBUG_MSGQ
 //*****************************************************************************
 //
@@ -176,6 +187,28 @@ static volatile unsigned long g_ulMQWrite = 0;
 //*****************************************************************************
 static unsigned char g_ucMQMutex = 0;
 
+//*****************************************************************************
+//
+// The widgets that have been invalidated and are waiting to be repainted.  No
+// widget in this list is a descendant of another widget in the list.
+//
+//*****************************************************************************
+static tWidget *g_ppInvalid[INVALID_LIST_SIZE];
+
+//*****************************************************************************
+//
+// The number of widgets in the invalid widget list.
+//
+//*****************************************************************************
+static volatile unsigned long g_ulInvalidCount = 0;
+
+//*****************************************************************************
+//
+// The mutex used to protect access to the invalid widget list.
+//
+//*****************************************************************************
+static unsigned char g_ucInvalidMutex = 0;
+
 //*****************************************************************************
 //
 //! Initializes a mutex to the unowned state.
@@ -433,6 +466,82 @@ WidgetIsInTree(tWidget *pWidget, tWidget *pFind)
     return(0);
 }
 
+//*****************************************************************************
+//
+// Determines if a widget is an ancestor of (or the same as) another widget.
+//
+// \param pAncestor is a pointer to the possible ancestor widget.
+// \param pWidget is a pointer to the widget whose ancestry is checked.
+//
+// This function follows the parent links of \e pWidget up to the root of the
+// tree to determine whether \e pAncestor encloses it.  Unlike
+// WidgetIsInTree(), the cost depends only on the depth of \e pWidget.
+//
+// \return Returns 1 if \e pAncestor is \e pWidget or one of its ancestors and
+// 0 otherwise.
+//
+//*****************************************************************************
+static long
+WidgetIsAncestor(tWidget *pAncestor, tWidget *pWidget)
+{
+    //
+    // Walk up the tree from the widget, looking for the ancestor.
+    //
+    for(; pWidget; pWidget = pWidget->pParent)
+    {
+        if(pWidget == pAncestor)
+        {
+            return(1);
+        }
+    }
+
+    //
+    // The ancestor was not found.
+    //
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Removes a widget tree from the invalid widget list.
+//
+// \param pWidget is a pointer to the widget tree to remove.
+//
+// This function removes \e pWidget and all of its descendants from the
+// invalid widget list.  The caller must hold the invalid widget list mutex.
+//
+// \return None.
+//
+//*****************************************************************************
+static void
+WidgetInvalidRemove(tWidget *pWidget)
+{
+    unsigned long ulIdx;
+
+    //
+    // Loop through the invalid widget list.
+    //
+    for(ulIdx = 0; ulIdx < g_ulInvalidCount; )
+    {
+        //
+        // See if this entry lies within the widget tree.
+        //
+        if(WidgetIsAncestor(pWidget, g_ppInvalid[ulIdx]))
+        {
+            //
+            // Replace this entry with the last entry in the list.  The order
+            // of the list is not significant.
+            //
+            g_ulInvalidCount--;
+            g_ppInvalid[ulIdx] = g_ppInvalid[g_ulInvalidCount];
+        }
+        else
+        {
+            ulIdx++;
+        }
+    }
+}
+
 //*****************************************************************************
 //
 //! Handles widget messages.
@@ -622,6 +731,16 @@ WidgetRemove(tWidget *pWidget)
         g_pPointerWidget = 0;
     }
 
+    //
+    // Make sure that the removed widgets are not repainted if they have been
+    // invalidated.
+    //
+    if(!WidgetMutexGet(&g_ucInvalidMutex))
+    {
+        WidgetInvalidRemove(pWidget);
+        WidgetMutexPut(&g_ucInvalidMutex);
+    }
+
     //
     // Clear the next pointer of the widget.
     //
@@ -1119,6 +1238,140 @@ WidgetMessageQueueAdd(tWidget *pWidget, unsigned long ulMessage,
     return(1);
 }
 
+//*****************************************************************************
+//
+//! Marks a widget tree as needing to be repainted.
+//!
+//! \param pWidget is a pointer to the widget tree to be repainted.
+//!
+//! This function records that the given widget, and all of the widgets
+//! beneath it, must be redrawn.  The actual drawing occurs the next time
+//! WidgetMessageQueueProcess() is called, once the pending messages have been
+//! processed.
+//!
+//! Unlike WidgetPaint(), which queues a paint message each time it is called,
+//! invalidations are coalesced: a widget that is invalidated several times, or
+//! whose ancestor has also been invalidated, is painted only once.  Widgets
+//! that have not been invalidated are not painted at all, so an application
+//! that invalidates just the widgets whose state has changed avoids redrawing
+//! (and, with a dirty-region tracking display, flushing) the rest of the
+//! screen.
+//!
+//! It is safe for code which interrupts WidgetMessageQueueProcess() to call
+//! this function.
+//!
+//! \return Returns 1 if the widget was marked for repainting, and 0 if it
+//! could not be since another context is currently modifying the list of
+//! invalid widgets and the paint message could not be queued either.
+//
+//*****************************************************************************
+long
+WidgetInvalidate(tWidget *pWidget)
+{
+    unsigned long ulIdx;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pWidget);
+
+    //
+    // Get the mutex that protects the invalid widget list.  If it is already
+    // held, fall back to queueing a paint message.
+    //
+    if(WidgetMutexGet(&g_ucInvalidMutex))
+    {
+        return(WidgetPaint(pWidget));
+    }
+
+    //
+    // Nothing needs to be done if this widget or one of its ancestors is
+    // already waiting to be repainted.
+    //
+    for(ulIdx = 0; ulIdx < g_ulInvalidCount; ulIdx++)
+    {
+        if(WidgetIsAncestor(g_ppInvalid[ulIdx], pWidget))
+        {
+            WidgetMutexPut(&g_ucInvalidMutex);
+            return(1);
+        }
+    }
+
+    //
+    // Any descendants of this widget in the list are repainted along with it,
+    // so remove them.
+    //
+    WidgetInvalidRemove(pWidget);
+
+    //
+    // See if there is space in the invalid widget list.
+    //
+    if(g_ulInvalidCount == INVALID_LIST_SIZE)
+    {
+        //
+        // The list is full, so fall back to queueing a paint message.
+        //
+        WidgetMutexPut(&g_ucInvalidMutex);
+        return(WidgetPaint(pWidget));
+    }
+
+    //
+    // Add this widget to the invalid widget list.
+    //
+    g_ppInvalid[g_ulInvalidCount] = pWidget;
+    g_ulInvalidCount++;
+
+    //
+    // Release the invalid widget list mutex.
+    //
+    WidgetMutexPut(&g_ucInvalidMutex);
+
+    //
+    // Success.
+    //
+    return(1);
+}
+
+//*****************************************************************************
+//
+// Repaints the widgets in the invalid widget list.
+//
+// This function removes each widget from the invalid widget list and sends a
+// paint message to it and its descendants.  Widgets that are invalidated while
+// painting are also repainted before this function returns.
+//
+// \return None.
+//
+//*****************************************************************************
+static void
+WidgetInvalidPaint(void)
+{
+    tWidget *pWidget;
+
+    //
+    // Loop while there are more widgets in the invalid widget list.
+    //
+    while(g_ulInvalidCount)
+    {
+        //
+        // Remove the last widget from the list.  If another context currently
+        // holds the mutex, leave the list for the next call.
+        //
+        if(WidgetMutexGet(&g_ucInvalidMutex))
+        {
+            return;
+        }
+        g_ulInvalidCount--;
+        pWidget = g_ppInvalid[g_ulInvalidCount];
+        WidgetMutexPut(&g_ucInvalidMutex);
+
+        //
+        // Paint this widget tree.
+        //
+        WidgetMessageSendPreOrder(pWidget, WIDGET_MSG_PAINT, 0, 0, 0);
+    }
+}
+
 //*****************************************************************************
 //
 //! Processes the messages in the widget message queue.
@@ -1130,6 +1383,9 @@ WidgetMessageQueueAdd(tWidget *pWidget, unsigned long ulMessage,
 //! WidgetMessageQueueAdd() to send more messages.  In both cases, the newly
 //! added message will also be processed before this function returns.
 //!
+//! Once the message queue is empty, the widgets marked by WidgetInvalidate()
+//! are repainted.
+//!
 //! \return None.
 //
 //*****************************************************************************
@@ -1140,10 +1396,24 @@ WidgetMessageQueueProcess(void)
     unsigned long ulFlags, ulMessage, ulParam1, ulParam2;
 
     //
-    // Loop while there are more messages in the message queue.
+    // Loop while there are more messages in the message queue or widgets
+    // waiting to be repainted.
     //
-    while(g_ulMQRead != g_ulMQWrite)
+    while((g_ulMQRead != g_ulMQWrite) || g_ulInvalidCount)
     {
+        //
+        // Repaint the invalid widgets once all pending messages (which may
+        // invalidate further widgets) have been processed.
+        //
+        if(g_ulMQRead == g_ulMQWrite)
+        {
+            WidgetInvalidPaint();
+            if(g_ulMQRead == g_ulMQWrite)
+            {
+                break;
+            }
+        }
+
         //
         // Copy the contents of this message into local variables.
         //
@@ -234,6 +234,7 @@ extern long WidgetMessageQueueAdd(tWidget *pWidget, unsigned long ulMessage,
                                   unsigned long bPostOrder,
                                   unsigned long bStopOnSuccess);
 extern void WidgetMessageQueueProcess(void);
+extern long WidgetInvalidate(tWidget *pWidget);
 extern long WidgetPointerMessage(unsigned long ulMessage, long lX, long lY);
 extern void WidgetMutexInit(unsigned char *pcMutex);
 extern unsigned long WidgetMutexGet(unsigned char *pcMutex);
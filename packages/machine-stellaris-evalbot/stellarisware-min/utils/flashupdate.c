@@ -0,0 +1,937 @@
+//*****************************************************************************
+//
+// flashupdate.c - In-application update of the flash image, programmed in the
+//                 background while the image is being received.
+//
+// Copyright (c) 2008-2013 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 10636 of the Stellaris Firmware Development Package.
+//
+//*****************************************************************************
+
+#include <string.h>
+#include "inc/hw_types.h"
+#include "driverlib/debug.h"
+#include "driverlib/flash.h"
+#include "utils/crc.h"
+#include "utils/tftp.h"
+#include "utils/flashupdate.h"
+
+//*****************************************************************************
+//
+//! \addtogroup flashupdate_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The image is received into a staging region of flash while the active image
+// keeps running.  The data that is received (typically by the TFTP server in
+// the context of the Ethernet interrupt) is copied into a small ring of page
+// buffers, and each page is erased and programmed by FlashUpdateService(),
+// which is called from a low priority task.  Flash operations stall the
+// processor while they are in progress, so keeping them out of the interrupt
+// context means that the reception of the image (and everything else that
+// happens in interrupt context) is not held up by them.
+//
+// The image is followed in the stream by its CRC-32, stored in little-endian
+// byte order.  The CRC-32 of the data is computed as it is received, so it is
+// known as soon as the transfer completes; it is checked against the CRC-32
+// at the end of the stream, and against the CRC-32 of the data read back from
+// the staging region.  Only if both match is a record written to the last page
+// of the staging region, which causes FlashUpdateSwap() to copy the image into
+// the active region at the next reset.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The value of the first word of the record at the end of the staging region
+// that marks the staging region as holding a verified image.
+//
+//*****************************************************************************
+#define FLASH_UPDATE_MAGIC      0x55504454
+
+//*****************************************************************************
+//
+// The requests made of FlashUpdateService() by FlashUpdateEnd().
+//
+//*****************************************************************************
+#define FLASH_UPDATE_REQ_NONE   0
+#define FLASH_UPDATE_REQ_END    1
+#define FLASH_UPDATE_REQ_ABORT  2
+
+//*****************************************************************************
+//
+// The address of the active image, the address of the staging region, and the
+// size of each, as given to FlashUpdateInit().
+//
+//*****************************************************************************
+static unsigned long g_ulFlashUpdateActive;
+static unsigned long g_ulFlashUpdateStaging;
+static unsigned long g_ulFlashUpdateSize;
+
+//*****************************************************************************
+//
+// The function that is called when a page buffer is ready to be programmed,
+// which typically wakes the task that calls FlashUpdateService().
+//
+//*****************************************************************************
+static void (*g_pfnFlashUpdatePageReady)(void);
+
+//*****************************************************************************
+//
+// The page buffers.  Page n of the image is held in buffer n modulo
+// FLASH_UPDATE_BUFFERS.
+//
+//*****************************************************************************
+static unsigned long
+    g_pulFlashUpdateBuffer[FLASH_UPDATE_BUFFERS][FLASH_UPDATE_PAGE_SIZE / 4];
+
+//*****************************************************************************
+//
+// The number of pages that have been filled, which is only modified by the
+// writer, and the number of pages that have been programmed, which is only
+// modified by FlashUpdateService().  The difference between the two is the
+// number of page buffers waiting to be programmed.
+//
+//*****************************************************************************
+static volatile unsigned long g_ulFlashUpdatePagesFilled;
+static volatile unsigned long g_ulFlashUpdatePagesProgrammed;
+
+//*****************************************************************************
+//
+// The number of bytes in the page buffer that is being filled, the number of
+// bytes of the image that have been received, and the running CRC-32 of them.
+//
+//*****************************************************************************
+static unsigned long g_ulFlashUpdateFillCount;
+static unsigned long g_ulFlashUpdateLength;
+static unsigned long g_ulFlashUpdateCrc;
+
+//*****************************************************************************
+//
+// The last bytes of the stream that have been received.  These are held back
+// from the image since they may be the CRC-32 that follows it.
+//
+//*****************************************************************************
+static unsigned char g_pucFlashUpdateTail[4];
+static unsigned long g_ulFlashUpdateTailCount;
+
+//*****************************************************************************
+//
+// The length and CRC-32 of the image, and the CRC-32 that followed it in the
+// stream, which are passed to FlashUpdateService() by FlashUpdateEnd().
+//
+//*****************************************************************************
+static volatile unsigned long g_ulFlashUpdateFinalLength;
+static volatile unsigned long g_ulFlashUpdateFinalCrc;
+static volatile unsigned long g_ulFlashUpdateTrailer;
+static volatile unsigned long g_ulFlashUpdateRequest;
+
+//*****************************************************************************
+//
+// A flag that is true once the record at the end of the staging region has
+// been erased for this update.
+//
+//*****************************************************************************
+static tBoolean g_bFlashUpdateRecordErased;
+
+//*****************************************************************************
+//
+// The state of the update.  Other than in FlashUpdateStart(), this is only
+// modified by FlashUpdateService().
+//
+//*****************************************************************************
+static volatile tFlashUpdateStatus g_eFlashUpdateStatus;
+
+//*****************************************************************************
+//
+// The TFTP connection that is receiving the image, if any.
+//
+//*****************************************************************************
+static tTFTPConnection *g_psFlashUpdateTFTP;
+
+//*****************************************************************************
+//
+// Adds bytes to the image, copying them into the page buffers.  The caller
+// must have checked that there is room for them.
+//
+//*****************************************************************************
+static void
+FlashUpdateCommit(const unsigned char *pucData, unsigned long ulCount)
+{
+    unsigned char *pucBuffer;
+    unsigned long ulCopy;
+
+    //
+    // Return without doing anything if there are no bytes to add.
+    //
+    if(ulCount == 0)
+    {
+        return;
+    }
+
+    //
+    // Update the length and CRC-32 of the image.
+    //
+    g_ulFlashUpdateCrc = Crc32(g_ulFlashUpdateCrc, pucData, ulCount);
+    g_ulFlashUpdateLength += ulCount;
+
+    //
+    // Loop while there are more bytes to copy.
+    //
+    while(ulCount)
+    {
+        //
+        // Copy as many bytes as will fit into the page buffer that is being
+        // filled.
+        //
+        pucBuffer = (unsigned char *)
+            g_pulFlashUpdateBuffer[g_ulFlashUpdatePagesFilled %
+                                   FLASH_UPDATE_BUFFERS];
+        ulCopy = FLASH_UPDATE_PAGE_SIZE - g_ulFlashUpdateFillCount;
+        if(ulCopy > ulCount)
+        {
+            ulCopy = ulCount;
+        }
+        memcpy(pucBuffer + g_ulFlashUpdateFillCount, pucData, ulCopy);
+        g_ulFlashUpdateFillCount += ulCopy;
+        pucData += ulCopy;
+        ulCount -= ulCopy;
+
+        //
+        // If the page buffer is full, pass it to FlashUpdateService() to be
+        // programmed.
+        //
+        if(g_ulFlashUpdateFillCount == FLASH_UPDATE_PAGE_SIZE)
+        {
+            g_ulFlashUpdateFillCount = 0;
+            g_ulFlashUpdatePagesFilled++;
+            if(g_pfnFlashUpdatePageReady)
+            {
+                g_pfnFlashUpdatePageReady();
+            }
+        }
+    }
+}
+
+//*****************************************************************************
+//
+//! Initializes the flash update module.
+//!
+//! \param ulActiveStart is the address of the active image.
+//! \param ulStagingStart is the address of the staging region.
+//! \param ulSize is the size of the active image and of the staging region.
+//! \param pfnPageReady is a function that is called when there is work for
+//! FlashUpdateService() to do, or zero if none is required.
+//!
+//! This function initializes the flash update module.  The staging region
+//! receives the new image, and must not overlap the active image.  Each of the
+//! addresses and the size must be a multiple of FLASH_UPDATE_PAGE_SIZE, which
+//! must be the size of an erase page of the flash.  The last page of the
+//! staging region holds the record of a verified image, so the largest image
+//! that can be received is \e ulSize less FLASH_UPDATE_PAGE_SIZE bytes.
+//!
+//! The \e pfnPageReady function is called from the context of
+//! FlashUpdateWrite() and FlashUpdateEnd(), and is typically used to wake
+//! the task that calls FlashUpdateService().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+FlashUpdateInit(unsigned long ulActiveStart, unsigned long ulStagingStart,
+                unsigned long ulSize, void (*pfnPageReady)(void))
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT((ulActiveStart & (FLASH_UPDATE_PAGE_SIZE - 1)) == 0);
+    ASSERT((ulStagingStart & (FLASH_UPDATE_PAGE_SIZE - 1)) == 0);
+    ASSERT((ulSize & (FLASH_UPDATE_PAGE_SIZE - 1)) == 0);
+    ASSERT(ulSize > FLASH_UPDATE_PAGE_SIZE);
+    ASSERT(((ulActiveStart + ulSize) <= ulStagingStart) ||
+           ((ulStagingStart + ulSize) <= ulActiveStart));
+
+    //
+    // Save the regions and the callback function.
+    //
+    g_ulFlashUpdateActive = ulActiveStart;
+    g_ulFlashUpdateStaging = ulStagingStart;
+    g_ulFlashUpdateSize = ulSize;
+    g_pfnFlashUpdatePageReady = pfnPageReady;
+
+    //
+    // No update has been started.
+    //
+    g_eFlashUpdateStatus = FLASH_UPDATE_IDLE;
+    g_psFlashUpdateTFTP = 0;
+}
+
+//*****************************************************************************
+//
+//! Starts receiving a new image.
+//!
+//! This function prepares the module to receive a new image with
+//! FlashUpdateWrite().  Any image that is in the staging region is discarded.
+//!
+//! \return Returns \b false if an update is already in progress, and \b true
+//! otherwise.
+//
+//*****************************************************************************
+tBoolean
+FlashUpdateStart(void)
+{
+    //
+    // Fail if an update is already in progress.
+    //
+    if((g_eFlashUpdateStatus == FLASH_UPDATE_RECEIVING) ||
+       (g_eFlashUpdateStatus == FLASH_UPDATE_VERIFYING))
+    {
+        return(false);
+    }
+
+    //
+    // Reset the state of the update.
+    //
+    g_ulFlashUpdatePagesFilled = 0;
+    g_ulFlashUpdatePagesProgrammed = 0;
+    g_ulFlashUpdateFillCount = 0;
+    g_ulFlashUpdateLength = 0;
+    g_ulFlashUpdateCrc = 0xffffffff;
+    g_ulFlashUpdateTailCount = 0;
+    g_ulFlashUpdateRequest = FLASH_UPDATE_REQ_NONE;
+    g_bFlashUpdateRecordErased = false;
+    g_eFlashUpdateStatus = FLASH_UPDATE_RECEIVING;
+
+    //
+    // Success.
+    //
+    return(true);
+}
+
+//*****************************************************************************
+//
+//! Gets the number of bytes that can be passed to FlashUpdateWrite().
+//!
+//! This function returns the number of bytes of free space in the page
+//! buffers.  This does not account for the size of the staging region.
+//!
+//! \return Returns the number of bytes that FlashUpdateWrite() can accept
+//! without waiting for FlashUpdateService() to program a page.
+//
+//*****************************************************************************
+unsigned long
+FlashUpdateSpaceGet(void)
+{
+    unsigned long ulPending;
+
+    //
+    // There is no space if an image is not being received.
+    //
+    if((g_eFlashUpdateStatus != FLASH_UPDATE_RECEIVING) ||
+       (g_ulFlashUpdateRequest != FLASH_UPDATE_REQ_NONE))
+    {
+        return(0);
+    }
+
+    //
+    // Determine the number of page buffers that are waiting to be programmed.
+    // The page buffer that is being filled is never counted here, since it is
+    // only filled once the number of pages waiting is less than the number of
+    // buffers.
+    //
+    ulPending = g_ulFlashUpdatePagesFilled - g_ulFlashUpdatePagesProgrammed;
+
+    //
+    // Return the space in the remaining page buffers.
+    //
+    return(((FLASH_UPDATE_BUFFERS - ulPending) * FLASH_UPDATE_PAGE_SIZE) -
+           g_ulFlashUpdateFillCount);
+}
+
+//*****************************************************************************
+//
+//! Passes received data to the flash update module.
+//!
+//! \param pucData is a pointer to the data.
+//! \param ulLength is the number of bytes of data.
+//!
+//! This function copies the next portion of the stream into the page buffers,
+//! to be programmed into the staging region by FlashUpdateService().  The
+//! stream consists of the image followed by its CRC-32 in little-endian byte
+//! order.  This function may be called from an interrupt handler, but must not
+//! be called from more than one context at a time.
+//!
+//! \return Returns the number of bytes that were accepted.  This is less than
+//! \e ulLength if the page buffers are full, if the data would not fit in the
+//! staging region, or if an image is not being received.
+//
+//*****************************************************************************
+unsigned long
+FlashUpdateWrite(const unsigned char *pucData, unsigned long ulLength)
+{
+    unsigned long ulSpace, ulCommit, ulCount, ulIdx;
+
+    //
+    // Accept nothing if an image is not being received.
+    //
+    ulSpace = FlashUpdateSpaceGet();
+    if(ulSpace == 0)
+    {
+        return(0);
+    }
+
+    //
+    // Limit the space to that remaining in the staging region.
+    //
+    ulCount = (g_ulFlashUpdateSize - FLASH_UPDATE_PAGE_SIZE -
+               g_ulFlashUpdateLength);
+    if(ulSpace > ulCount)
+    {
+        ulSpace = ulCount;
+    }
+
+    //
+    // The last four bytes of the stream are held back, so four more bytes
+    // than there is space for can be accepted.
+    //
+    ulCount = ulSpace + sizeof(g_pucFlashUpdateTail) - g_ulFlashUpdateTailCount;
+    if(ulLength > ulCount)
+    {
+        ulLength = ulCount;
+    }
+
+    //
+    // Determine the number of bytes that are no longer among the last four of
+    // the stream, and so are part of the image.
+    //
+    ulCommit = g_ulFlashUpdateTailCount + ulLength;
+    ulCommit = ((ulCommit > sizeof(g_pucFlashUpdateTail)) ?
+                (ulCommit - sizeof(g_pucFlashUpdateTail)) : 0);
+
+    //
+    // Add those bytes to the image, first from the bytes that have been held
+    // back and then from the new data.
+    //
+    ulCount = ((ulCommit < g_ulFlashUpdateTailCount) ? ulCommit :
+               g_ulFlashUpdateTailCount);
+    FlashUpdateCommit(g_pucFlashUpdateTail, ulCount);
+    FlashUpdateCommit(pucData, ulCommit - ulCount);
+
+    //
+    // Hold back the remaining bytes.
+    //
+    for(ulIdx = ulCount; ulIdx < g_ulFlashUpdateTailCount; ulIdx++)
+    {
+        g_pucFlashUpdateTail[ulIdx - ulCount] = g_pucFlashUpdateTail[ulIdx];
+    }
+    g_ulFlashUpdateTailCount -= ulCount;
+    for(ulIdx = ulCommit - ulCount; ulIdx < ulLength; ulIdx++)
+    {
+        g_pucFlashUpdateTail[g_ulFlashUpdateTailCount++] = pucData[ulIdx];
+    }
+
+    //
+    // Return the number of bytes accepted.
+    //
+    return(ulLength);
+}
+
+//*****************************************************************************
+//
+//! Finishes receiving an image.
+//!
+//! \param bAbort is \b true if the transfer of the image failed.
+//!
+//! This function indicates that the whole stream has been passed to
+//! FlashUpdateWrite(), or, if \e bAbort is \b true, that the update should be
+//! abandoned.  The remaining data is programmed, and the image verified, by
+//! FlashUpdateService().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+FlashUpdateEnd(tBoolean bAbort)
+{
+    unsigned char *pucBuffer;
+
+    //
+    // Do nothing if an image is not being received.
+    //
+    if((g_eFlashUpdateStatus != FLASH_UPDATE_RECEIVING) ||
+       (g_ulFlashUpdateRequest != FLASH_UPDATE_REQ_NONE))
+    {
+        return;
+    }
+
+    //
+    // The stream is not valid unless it includes the CRC-32.
+    //
+    if(g_ulFlashUpdateTailCount != sizeof(g_pucFlashUpdateTail))
+    {
+        bAbort = true;
+    }
+
+    if(!bAbort)
+    {
+        //
+        // Pad the last page of the image with erased bytes, and pass it to
+        // FlashUpdateService() to be programmed.
+        //
+        if(g_ulFlashUpdateFillCount)
+        {
+            pucBuffer = (unsigned char *)
+                g_pulFlashUpdateBuffer[g_ulFlashUpdatePagesFilled %
+                                       FLASH_UPDATE_BUFFERS];
+            memset(pucBuffer + g_ulFlashUpdateFillCount, 0xff,
+                   FLASH_UPDATE_PAGE_SIZE - g_ulFlashUpdateFillCount);
+            g_ulFlashUpdateFillCount = 0;
+            g_ulFlashUpdatePagesFilled++;
+        }
+
+        //
+        // Save the length and CRC-32 of the image, and the CRC-32 that
+        // followed it.
+        //
+        g_ulFlashUpdateFinalLength = g_ulFlashUpdateLength;
+        g_ulFlashUpdateFinalCrc = g_ulFlashUpdateCrc ^ 0xffffffff;
+        g_ulFlashUpdateTrailer = (
+            (unsigned long)g_pucFlashUpdateTail[0] |
+            ((unsigned long)g_pucFlashUpdateTail[1] << 8) |
+            ((unsigned long)g_pucFlashUpdateTail[2] << 16) |
+            ((unsigned long)g_pucFlashUpdateTail[3] << 24));
+    }
+
+    //
+    // Pass the request to FlashUpdateService().
+    //
+    g_ulFlashUpdateRequest = (bAbort ? FLASH_UPDATE_REQ_ABORT :
+                              FLASH_UPDATE_REQ_END);
+    if(g_pfnFlashUpdatePageReady)
+    {
+        g_pfnFlashUpdatePageReady();
+    }
+}
+
+//*****************************************************************************
+//
+//! Programs received data into the staging region.
+//!
+//! This function performs the next step of the update: erasing the record at
+//! the end of the staging region, programming a page that has been received,
+//! or verifying the image once all of it has been programmed.  It should be
+//! called from a low priority task (or the main loop of the application) each
+//! time the \e pfnPageReady function passed to FlashUpdateInit() is called,
+//! until it returns \b false.
+//!
+//! The processor stalls while the flash is erased or programmed, so this
+//! function should not be called from an interrupt handler.
+//!
+//! \return Returns \b true if a step was performed, and \b false if there is
+//! nothing to do.
+//
+//*****************************************************************************
+tBoolean
+FlashUpdateService(void)
+{
+    unsigned long ulAddress, ulCrc;
+    unsigned long pulRecord[4];
+
+    //
+    // There is nothing to do if an image is not being received.
+    //
+    if(g_eFlashUpdateStatus != FLASH_UPDATE_RECEIVING)
+    {
+        return(false);
+    }
+
+    //
+    // Abandon the update if the transfer failed.
+    //
+    if(g_ulFlashUpdateRequest == FLASH_UPDATE_REQ_ABORT)
+    {
+        g_eFlashUpdateStatus = FLASH_UPDATE_FAILED;
+        return(true);
+    }
+
+    //
+    // Erase the record at the end of the staging region before programming
+    // any of the image, so that a partially programmed image is never taken
+    // to be a verified one.
+    //
+    ulAddress = g_ulFlashUpdateStaging + g_ulFlashUpdateSize -
+                FLASH_UPDATE_PAGE_SIZE;
+    if(!g_bFlashUpdateRecordErased)
+    {
+        if(FlashErase(ulAddress))
+        {
+            g_eFlashUpdateStatus = FLASH_UPDATE_FAILED;
+            return(true);
+        }
+        g_bFlashUpdateRecordErased = true;
+        return(true);
+    }
+
+    //
+    // Program the next page that has been received, if any.
+    //
+    if(g_ulFlashUpdatePagesProgrammed != g_ulFlashUpdatePagesFilled)
+    {
+        ulAddress = (g_ulFlashUpdateStaging +
+                     (g_ulFlashUpdatePagesProgrammed *
+                      FLASH_UPDATE_PAGE_SIZE));
+        if(FlashErase(ulAddress) ||
+           FlashProgram(g_pulFlashUpdateBuffer[g_ulFlashUpdatePagesProgrammed %
+                                               FLASH_UPDATE_BUFFERS],
+                        ulAddress, FLASH_UPDATE_PAGE_SIZE))
+        {
+            g_eFlashUpdateStatus = FLASH_UPDATE_FAILED;
+            return(true);
+        }
+
+        //
+        // Release the page buffer to the writer.
+        //
+        g_ulFlashUpdatePagesProgrammed++;
+        return(true);
+    }
+
+    //
+    // There is nothing more to do until the whole image has been received.
+    //
+    if(g_ulFlashUpdateRequest != FLASH_UPDATE_REQ_END)
+    {
+        return(false);
+    }
+
+    //
+    // Verify that the CRC-32 of the data received matches the CRC-32 that
+    // followed it, and that the image in the staging region has the same
+    // CRC-32.
+    //
+    g_eFlashUpdateStatus = FLASH_UPDATE_VERIFYING;
+    if((g_ulFlashUpdateFinalLength == 0) ||
+       (g_ulFlashUpdateFinalCrc != g_ulFlashUpdateTrailer))
+    {
+        g_eFlashUpdateStatus = FLASH_UPDATE_FAILED;
+        return(true);
+    }
+    ulCrc = Crc32(0xffffffff, (unsigned char *)g_ulFlashUpdateStaging,
+                  g_ulFlashUpdateFinalLength) ^ 0xffffffff;
+    if(ulCrc != g_ulFlashUpdateFinalCrc)
+    {
+        g_eFlashUpdateStatus = FLASH_UPDATE_FAILED;
+        return(true);
+    }
+
+    //
+    // Write the record that marks the staging region as holding a verified
+    // image.
+    //
+    pulRecord[0] = FLASH_UPDATE_MAGIC;
+    pulRecord[1] = g_ulFlashUpdateFinalLength;
+    pulRecord[2] = ulCrc;
+    pulRecord[3] = ~(pulRecord[0] ^ pulRecord[1] ^ pulRecord[2]);
+    if(FlashProgram(pulRecord, ulAddress, sizeof(pulRecord)))
+    {
+        g_eFlashUpdateStatus = FLASH_UPDATE_FAILED;
+        return(true);
+    }
+
+    //
+    // The update is complete.
+    //
+    g_eFlashUpdateStatus = FLASH_UPDATE_COMPLETE;
+    return(true);
+}
+
+//*****************************************************************************
+//
+//! Gets the state of the update.
+//!
+//! \return Returns the state of the update.
+//
+//*****************************************************************************
+tFlashUpdateStatus
+FlashUpdateStatusGet(void)
+{
+    return(g_eFlashUpdateStatus);
+}
+
+//*****************************************************************************
+//
+//! Replaces the active image with a verified image from the staging region.
+//!
+//! This function checks whether the staging region holds a verified image,
+//! and if so, copies it into the active region, and erases the record that
+//! marks it as verified.  It should be called early after reset, before the
+//! active image is run, by code that does not reside in the active region
+//! (such as a boot loader), since the active region is erased.
+//!
+//! Pages of the active region that already match the staging region are not
+//! erased, so if a reset interrupts the copy it is completed the next time
+//! that this function is called.
+//!
+//! \return Returns \b true if the active image was replaced, and \b false
+//! otherwise.
+//
+//*****************************************************************************
+tBoolean
+FlashUpdateSwap(void)
+{
+    unsigned long *pulRecord, *pulActive, *pulStaging;
+    unsigned long ulLength, ulCrc, ulOffset, ulIdx;
+
+    //
+    // Check that the record at the end of the staging region is valid.
+    //
+    pulRecord = (unsigned long *)(g_ulFlashUpdateStaging + g_ulFlashUpdateSize -
+                                  FLASH_UPDATE_PAGE_SIZE);
+    if((pulRecord[0] != FLASH_UPDATE_MAGIC) ||
+       (pulRecord[3] != ~(pulRecord[0] ^ pulRecord[1] ^ pulRecord[2])) ||
+       (pulRecord[1] == 0) ||
+       (pulRecord[1] > (g_ulFlashUpdateSize - FLASH_UPDATE_PAGE_SIZE)))
+    {
+        return(false);
+    }
+    ulLength = pulRecord[1];
+    ulCrc = pulRecord[2];
+
+    //
+    // Check the image in the staging region.
+    //
+    if((Crc32(0xffffffff, (unsigned char *)g_ulFlashUpdateStaging,
+              ulLength) ^ 0xffffffff) != ulCrc)
+    {
+        return(false);
+    }
+
+    //
+    // Copy each page of the image that does not already match.
+    //
+    for(ulOffset = 0; ulOffset < ulLength; ulOffset += FLASH_UPDATE_PAGE_SIZE)
+    {
+        pulActive = (unsigned long *)(g_ulFlashUpdateActive + ulOffset);
+        pulStaging = (unsigned long *)(g_ulFlashUpdateStaging + ulOffset);
+        for(ulIdx = 0; ulIdx < (FLASH_UPDATE_PAGE_SIZE / 4); ulIdx++)
+        {
+            if(pulActive[ulIdx] != pulStaging[ulIdx])
+            {
+                break;
+            }
+        }
+        if(ulIdx == (FLASH_UPDATE_PAGE_SIZE / 4))
+        {
+            continue;
+        }
+        if(FlashErase((unsigned long)pulActive) ||
+           FlashProgram(pulStaging, (unsigned long)pulActive,
+                        FLASH_UPDATE_PAGE_SIZE))
+        {
+            return(false);
+        }
+    }
+
+    //
+    // Check the image in the active region.
+    //
+    if((Crc32(0xffffffff, (unsigned char *)g_ulFlashUpdateActive,
+              ulLength) ^ 0xffffffff) != ulCrc)
+    {
+        return(false);
+    }
+
+    //
+    // Erase the record so that the image is not copied again.
+    //
+    FlashErase((unsigned long)pulRecord);
+
+    //
+    // The active image has been replaced.
+    //
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Handles a block of data received by the TFTP server.
+//
+//*****************************************************************************
+static tTFTPError
+FlashUpdateTFTPPut(tTFTPConnection *psTFTP)
+{
+    //
+    // Fail the transfer if the update has failed.
+    //
+    if(g_eFlashUpdateStatus != FLASH_UPDATE_RECEIVING)
+    {
+        psTFTP->pcErrorString = "Update failed";
+        return(TFTP_ERR_NOT_DEFINED);
+    }
+
+    //
+    // Ask the TFTP server to withhold the acknowledgement of this block if
+    // there is not room for it in the page buffers.
+    //
+    if((psTFTP->ulDataRemaining == 0) &&
+       (FlashUpdateSpaceGet() < psTFTP->ulBlockSize))
+    {
+        return(TFTP_BUSY);
+    }
+
+    //
+    // Pass the data to the flash update module.
+    //
+    if(FlashUpdateWrite(psTFTP->pucData, psTFTP->ulDataLength) !=
+       psTFTP->ulDataLength)
+    {
+        psTFTP->pcErrorString = "Image too large";
+        return(TFTP_DISK_FULL);
+    }
+
+    //
+    // Success.
+    //
+    return(TFTP_OK);
+}
+
+//*****************************************************************************
+//
+// Handles the end of a TFTP transfer.
+//
+//*****************************************************************************
+static void
+FlashUpdateTFTPClose(tTFTPConnection *psTFTP)
+{
+    //
+    // Finish the update, abandoning it if the transfer did not complete.
+    //
+    FlashUpdateEnd(psTFTP->bComplete ? false : true);
+    g_psFlashUpdateTFTP = 0;
+}
+
+//*****************************************************************************
+//
+//! Starts receiving an image with the TFTP server.
+//!
+//! \param psTFTP is the connection of a PUT request.
+//!
+//! This function may be called by the tTFTPRequest callback passed to
+//! TFTPInit() to receive an image with a PUT request.  It starts the update,
+//! limits the block size and window size of the connection to those that fit
+//! in the page buffers, and sets the callbacks of the connection.  While the
+//! page buffers are full, the acknowledgements of received blocks are
+//! withheld, so the application must call FlashUpdateTFTPPoll() periodically.
+//!
+//! \return Returns \b TFTP_OK if the update was started, or an error to be
+//! returned to the client otherwise.
+//
+//*****************************************************************************
+tTFTPError
+FlashUpdateTFTPStart(tTFTPConnection *psTFTP)
+{
+    unsigned long ulWindow;
+
+    //
+    // Start the update.
+    //
+    if(!FlashUpdateStart())
+    {
+        psTFTP->pcErrorString = "Update in progress";
+        return(TFTP_ERR_NOT_DEFINED);
+    }
+
+    //
+    // A block must fit in a page buffer, and a window of blocks must fit in
+    // the page buffers other than the one that is being programmed.
+    //
+    if(psTFTP->ulBlockSize > FLASH_UPDATE_PAGE_SIZE)
+    {
+        psTFTP->ulBlockSize = FLASH_UPDATE_PAGE_SIZE;
+    }
+    ulWindow = (((FLASH_UPDATE_BUFFERS - 1) * FLASH_UPDATE_PAGE_SIZE) /
+                psTFTP->ulBlockSize);
+    if(ulWindow == 0)
+    {
+        ulWindow = 1;
+    }
+    if(psTFTP->ulWindowSize > ulWindow)
+    {
+        psTFTP->ulWindowSize = ulWindow;
+    }
+
+    //
+    // Set the callbacks for the connection.
+    //
+    psTFTP->pfnPutData = FlashUpdateTFTPPut;
+    psTFTP->pfnClose = FlashUpdateTFTPClose;
+    g_psFlashUpdateTFTP = psTFTP;
+
+    //
+    // Success.
+    //
+    return(TFTP_OK);
+}
+
+//*****************************************************************************
+//
+//! Resumes a TFTP transfer once there is room in the page buffers.
+//!
+//! This function sends the acknowledgement that was withheld by the TFTP
+//! server when the page buffers were full, once there is room for a window of
+//! blocks.  It must be called periodically from the same context as the lwIP
+//! stack, for example from the lwIPHostTimerHandler() function.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+FlashUpdateTFTPPoll(void)
+{
+    tTFTPConnection *psTFTP;
+
+    //
+    // Do nothing unless an acknowledgement is being withheld.
+    //
+    psTFTP = g_psFlashUpdateTFTP;
+    if(!psTFTP || !psTFTP->bAckDeferred)
+    {
+        return;
+    }
+
+    //
+    // Send the acknowledgement if there is room for a window of blocks, or if
+    // the update has failed so that the next block will fail the transfer.
+    //
+    if((g_eFlashUpdateStatus != FLASH_UPDATE_RECEIVING) ||
+       (FlashUpdateSpaceGet() >=
+        (psTFTP->ulWindowSize * psTFTP->ulBlockSize)))
+    {
+        TFTPDataResume(psTFTP);
+    }
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -0,0 +1,119 @@
+//*****************************************************************************
+//
+// flashupdate.h - Prototypes for the in-application flash update module.
+//
+// Copyright (c) 2008-2013 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 10636 of the Stellaris Firmware Development Package.
+//
+//*****************************************************************************
+
+#ifndef __FLASHUPDATE_H__
+#define __FLASHUPDATE_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The size of a flash erase page, and the number of page buffers in which
+// received data waits to be programmed into flash.
+//
+//*****************************************************************************
+#ifndef FLASH_UPDATE_PAGE_SIZE
+#define FLASH_UPDATE_PAGE_SIZE  1024
+#endif
+#ifndef FLASH_UPDATE_BUFFERS
+#define FLASH_UPDATE_BUFFERS    2
+#endif
+#if FLASH_UPDATE_BUFFERS < 2
+#error "FLASH_UPDATE_BUFFERS must be at least two"
+#endif
+
+//*****************************************************************************
+//
+// The states of an update, as returned by FlashUpdateStatusGet().
+//
+//*****************************************************************************
+typedef enum
+{
+    //
+    // No update has been started.
+    //
+    FLASH_UPDATE_IDLE,
+
+    //
+    // Image data is being received and programmed into the staging region.
+    //
+    FLASH_UPDATE_RECEIVING,
+
+    //
+    // All of the image data has been received, and is being programmed and
+    // verified.
+    //
+    FLASH_UPDATE_VERIFYING,
+
+    //
+    // The image has been verified and will replace the running image at the
+    // next reset.
+    //
+    FLASH_UPDATE_COMPLETE,
+
+    //
+    // The update failed; the running image is unaffected.
+    //
+    FLASH_UPDATE_FAILED
+}
+tFlashUpdateStatus;
+
+//*****************************************************************************
+//
+// Prototypes for the APIs.
+//
+//*****************************************************************************
+extern void FlashUpdateInit(unsigned long ulActiveStart,
+                            unsigned long ulStagingStart, unsigned long ulSize,
+                            void (*pfnPageReady)(void));
+extern tBoolean FlashUpdateStart(void);
+extern unsigned long FlashUpdateWrite(const unsigned char *pucData,
+                                      unsigned long ulLength);
+extern unsigned long FlashUpdateSpaceGet(void);
+extern void FlashUpdateEnd(tBoolean bAbort);
+extern tBoolean FlashUpdateService(void);
+extern tFlashUpdateStatus FlashUpdateStatusGet(void);
+extern tBoolean FlashUpdateSwap(void);
+extern tTFTPError FlashUpdateTFTPStart(tTFTPConnection *psTFTP);
+extern void FlashUpdateTFTPPoll(void);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FLASHUPDATE_H__
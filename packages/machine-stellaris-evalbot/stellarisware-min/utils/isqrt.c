@@ -109,6 +109,93 @@ isqrt(unsigned long ulValue)
     return(ulRoot >> 1);
 }
 
+//*****************************************************************************
+//
+// Counts the leading zero bits of a non-zero 32-bit value.  Cortex-M3 and
+// Cortex-M4 have an instruction for this, which GCC-based compilers emit for
+// the builtin.
+//
+//*****************************************************************************
+#if defined(__GNUC__)
+#define isqrt_clz(ulValue)      __builtin_clz(ulValue)
+#else
+static unsigned long
+isqrt_clz(unsigned long ulValue)
+{
+    unsigned long ulCount;
+
+    for(ulCount = 0; !(ulValue & 0x80000000); ulCount++)
+    {
+        ulValue <<= 1;
+    }
+
+    return(ulCount);
+}
+#endif
+
+//*****************************************************************************
+//
+//! Compute the integer square roots of an array of integers.
+//!
+//! \param pulValue is a pointer to the values whose square roots are desired.
+//! \param pulRoot is a pointer to the array that receives the square roots.
+//! \param ulCount is the number of values.
+//!
+//! This function computes the same values as calling isqrt() for each value
+//! in turn.  Since a pair of leading zero bits in the input leaves the
+//! remainder and root of isqrt() at zero, the bit-by-bit loop starts at the
+//! most significant non-zero pair of bits of each value, which makes small
+//! values correspondingly faster.  The value and root arrays may be the same
+//! array.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+isqrt_n(const unsigned long *pulValue, unsigned long *pulRoot,
+        unsigned long ulCount)
+{
+    unsigned long ulValue, ulRem, ulRoot, ulIdx;
+
+    while(ulCount--)
+    {
+        ulValue = *pulValue++;
+        ulRem = 0;
+        ulRoot = 0;
+
+        if(ulValue)
+        {
+            //
+            // Skip the pairs of leading zero bits.
+            //
+            ulIdx = isqrt_clz(ulValue) / 2;
+            ulValue <<= 2 * ulIdx;
+
+            //
+            // Compute the remaining bits of the root, as isqrt() does.
+            //
+            for(; ulIdx < 16; ulIdx++)
+            {
+                ulRoot <<= 1;
+                ulRem = ((ulRem << 2) + (ulValue >> 30));
+                ulValue <<= 2;
+                ulRoot++;
+                if(ulRoot <= ulRem)
+                {
+                    ulRem -= ulRoot;
+                    ulRoot++;
+                }
+                else
+                {
+                    ulRoot--;
+                }
+            }
+        }
+
+        *pulRoot++ = ulRoot >> 1;
+    }
+}
+
 //*****************************************************************************
 //
 // Close the Doxygen group.
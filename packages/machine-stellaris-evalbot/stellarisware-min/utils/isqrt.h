@@ -38,10 +38,12 @@ extern "C"
 
 //*****************************************************************************
 //
-// The prototype for the integer square root function.
+// The prototypes for the integer square root functions.
 //
 //*****************************************************************************
 extern unsigned long isqrt(unsigned long ulValue);
+extern void isqrt_n(const unsigned long *pulValue, unsigned long *pulRoot,
+                    unsigned long ulCount);
 
 //*****************************************************************************
 //
@@ -117,6 +117,60 @@ sine(unsigned long ulAngle)
     }
 }
 
+//*****************************************************************************
+//
+//! Computes approximations of the sine of an array of input angles.
+//!
+//! \param pulAngle is a pointer to the angles, each expressed as a 0.32
+//! fixed-point value that is the percentage of the way around a circle.
+//! \param plSine is a pointer to the array that receives the sines.
+//! \param ulCount is the number of angles.
+//!
+//! This function computes the same values as calling sine() for each angle in
+//! turn, but without the call overhead and without branches, so that the
+//! processor pipeline does not stall on the quadrant of each angle.  The
+//! quadrant selects the direction of the table lookup and the sign of the
+//! result through masks instead.  The angle and sine arrays may be the same
+//! array.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+sine_n(const unsigned long *pulAngle, long *plSine, unsigned long ulCount)
+{
+    unsigned long ulAngle, ulIdx, ulReverse, ulNegate;
+
+    while(ulCount--)
+    {
+        //
+        // Add 0.5 to the angle and get the index into the sine table, as
+        // sine() does.
+        //
+        ulAngle = *pulAngle++ + 0x00400000;
+        ulIdx = (ulAngle >> 23) & 255;
+
+        //
+        // Make masks of all ones from bit 30 (the angle is in the second or
+        // fourth quadrant) and bit 31 (the angle is in the third or fourth
+        // quadrant).
+        //
+        ulReverse = 0 - ((ulAngle >> 30) & 1);
+        ulNegate = 0 - ((ulAngle >> 31) & 1);
+
+        //
+        // Reverse the index when required: (ulIdx ^ ~0) + 257 is 256 - ulIdx.
+        //
+        ulIdx = (ulIdx ^ ulReverse) + (ulReverse & 257);
+
+        //
+        // Look up the sine, and negate it when required: (x ^ ~0) + 1 is -x.
+        //
+        *plSine++ = (long)((g_pusFixedSineTable[ulIdx] ^ ulNegate) -
+                           ulNegate);
+    }
+}
+
 //*****************************************************************************
 //
 // Close the Doxygen group.
@@ -68,10 +68,12 @@ extern "C"
 
 //*****************************************************************************
 //
-// Prototype for the fixed point sine function.
+// Prototypes for the fixed point sine functions.
 //
 //*****************************************************************************
 extern long sine(unsigned long ulAngle);
+extern void sine_n(const unsigned long *pulAngle, long *plSine,
+                   unsigned long ulCount);
 
 //*****************************************************************************
 //
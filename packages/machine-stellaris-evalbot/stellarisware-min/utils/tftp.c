@@ -47,6 +47,19 @@
 #define TFTP_DATA               3
 #define TFTP_ACK                4
 #define TFTP_ERROR              5
+#define TFTP_OACK               6
+
+//*****************************************************************************
+//
+// The flags stored in the ucFlags field of a connection.  The first two
+// indicate the options given by the client, and the last indicates that the
+// last block received in sequence has been acknowledged again in response to
+// a block received out of sequence.
+//
+//*****************************************************************************
+#define TFTP_FLAG_BLKSIZE       0x01
+#define TFTP_FLAG_WINDOWSIZE    0x02
+#define TFTP_FLAG_REACKED       0x80
 
 //*****************************************************************************
 //
@@ -224,6 +237,13 @@ TFTPDataAck(tTFTPConnection *psTFTP)
     unsigned char *pucData;
     struct pbuf *p;
 
+    //
+    // The client starts a new window of data blocks after each
+    // acknowledgement, and any withheld acknowledgement is sent by this one.
+    //
+    psTFTP->ulWindowCount = 0;
+    psTFTP->bAckDeferred = false;
+
     //
     // Allocate a pbuf for this data packet.
     //
@@ -257,6 +277,64 @@ TFTPDataAck(tTFTPConnection *psTFTP)
     pbuf_free(p);
 }
 
+//*****************************************************************************
+//
+// Send an OACK packet back to the TFTP client, acknowledging the options that
+// it requested with the values that have been accepted.
+//
+//*****************************************************************************
+static void
+TFTPOptionsAck(tTFTPConnection *psTFTP)
+{
+    unsigned long ulLength;
+    char pcOptions[40];
+    struct pbuf *p;
+
+    //
+    // Fill in the packet header.
+    //
+    pcOptions[0] = (TFTP_OACK >> 8) & 0xff;
+    pcOptions[1] = TFTP_OACK & 0xff;
+    ulLength = 2;
+
+    //
+    // Add each of the requested options and its value.  Note that each of
+    // the strings is followed by a zero.
+    //
+    if(psTFTP->ucFlags & TFTP_FLAG_BLKSIZE)
+    {
+        ulLength += usprintf(&pcOptions[ulLength], "blksize") + 1;
+        ulLength += usprintf(&pcOptions[ulLength], "%d",
+                             psTFTP->ulBlockSize) + 1;
+    }
+    if(psTFTP->ucFlags & TFTP_FLAG_WINDOWSIZE)
+    {
+        ulLength += usprintf(&pcOptions[ulLength], "windowsize") + 1;
+        ulLength += usprintf(&pcOptions[ulLength], "%d",
+                             psTFTP->ulWindowSize) + 1;
+    }
+
+    //
+    // Allocate a pbuf for this packet.
+    //
+    p = pbuf_alloc(PBUF_TRANSPORT, ulLength, PBUF_RAM);
+    if(!p)
+    {
+        return;
+    }
+
+    //
+    // Copy the packet into the pbuf and send it.
+    //
+    memcpy(p->payload, pcOptions, ulLength);
+    udp_send(psTFTP->pPCB, p);
+
+    //
+    // Free the pbuf.
+    //
+    pbuf_free(p);
+}
+
 //*****************************************************************************
 //
 // Handles datagrams received from the TFTP data connection.
@@ -337,11 +415,37 @@ TFTPDataRecv(void *arg, struct udp_pcb *upcb, struct pbuf *p,
            (pucData[1] == (TFTP_DATA & 0xff)))
         {
             //
-            // This is a data packet.  Extract the block number from the packet
-            // and set the offset within the block (stored in ulDataRemaining)
-            // to zero.
+            // This is a data packet.  Extract the block number from the packet.
+            //
+            ulBlock = (pucData[2] << 8) + pucData[3];
+
+            //
+            // If this is not the block following the last one received, it is
+            // either a retransmission of a block that has already been received
+            // or an earlier block of the window has been lost.  In either case,
+            // acknowledge the last block received so that the client continues
+            // from the block that follows it (RFC 7440).  Only do this once for
+            // each block received, so that the client does not retransmit the
+            // rest of its window for each of the blocks that follow, and not
+            // while the acknowledgement is being withheld.
+            //
+            if(ulBlock != ((psTFTP->ulBlockNum + 1) & 0xffff))
+            {
+                if(!psTFTP->bAckDeferred &&
+                   !(psTFTP->ucFlags & TFTP_FLAG_REACKED))
+                {
+                    TFTPDataAck(psTFTP);
+                    psTFTP->ucFlags |= TFTP_FLAG_REACKED;
+                }
+                pbuf_free(p);
+                return;
+            }
+
+            //
+            // Set the block number and the offset within the block (stored in
+            // ulDataRemaining) to zero.
             //
-            psTFTP->ulBlockNum = (pucData[2] << 8) + pucData[3];
+            psTFTP->ulBlockNum = ulBlock;
             psTFTP->ulDataRemaining = 0;
             psTFTP->ulDataLength = p->len - 4;
 
@@ -391,11 +495,22 @@ TFTPDataRecv(void *arg, struct udp_pcb *upcb, struct pbuf *p,
                 }
             }
 
+            //
+            // If the application can not accept this block at the moment,
+            // forget that it was received and withhold the acknowledgement
+            // until the application calls TFTPDataResume().
+            //
+            if(eRetcode == TFTP_BUSY)
+            {
+                psTFTP->ulBlockNum = (ulBlock - 1) & 0xffff;
+                psTFTP->bAckDeferred = true;
+            }
+
             //
             // If we get here and there was an error reported, pass the error
             // back to the TFTP client.
             //
-            if(psTFTP && (eRetcode != TFTP_OK))
+            else if(psTFTP && (eRetcode != TFTP_OK))
             {
                 //
                 // Send the error code to the client.
@@ -411,22 +526,34 @@ TFTPDataRecv(void *arg, struct udp_pcb *upcb, struct pbuf *p,
             else
             {
                 //
-                // Acknowledge this block.
+                // A block has been received in sequence, so a block received
+                // out of sequence should be acknowledged again.
                 //
-                TFTPDataAck(psTFTP);
+                psTFTP->ucFlags &= ~TFTP_FLAG_REACKED;
 
                 //
                 // Is the transfer finished?
                 //
-                if(p->tot_len < (TFTP_BLOCK_SIZE + 4))
+                if(p->tot_len < (psTFTP->ulBlockSize + 4))
                 {
                     //
-                    // We got a short packet so the transfer is complete.  Close
-                    // the connection.
+                    // We got a short packet so the transfer is complete.
+                    // Acknowledge it and close the connection.
                     //
+                    TFTPDataAck(psTFTP);
+                    psTFTP->bComplete = true;
                     TFTPClose(psTFTP);
                     psTFTP = NULL;
                 }
+
+                //
+                // Otherwise, acknowledge this block if it is the last of the
+                // window.
+                //
+                else if(++psTFTP->ulWindowCount >= psTFTP->ulWindowSize)
+                {
+                    TFTPDataAck(psTFTP);
+                }
             }
         }
         else
@@ -524,6 +651,78 @@ TFTPModeGet(unsigned char *pucRequest, unsigned long ulLen)
     return(TFTP_MODE_INVALID);
 }
 
+//*****************************************************************************
+//
+// Parses the options (RFC 2347) that follow the file name and mode strings of
+// a request, for the block size (RFC 2348) and window size (RFC 7440) that the
+// client would like to use.  Any other options are ignored.
+//
+//*****************************************************************************
+static void
+TFTPOptionsGet(tTFTPConnection *psTFTP, unsigned char *pucRequest,
+               unsigned long ulLen)
+{
+    unsigned long ulLoop, ulStrings, ulName, ulValue, ulNumber;
+
+    //
+    // Skip the file name and mode strings (and the first two bytes of the
+    // request packet).
+    //
+    for(ulLoop = 2, ulStrings = 0; (ulLoop < ulLen) && (ulStrings < 2);
+        ulLoop++)
+    {
+        if(pucRequest[ulLoop] == (unsigned char)0)
+        {
+            ulStrings++;
+        }
+    }
+
+    //
+    // Loop through the pairs of option name and value strings.
+    //
+    while(ulLoop < ulLen)
+    {
+        //
+        // Find the end of the option name, and the end of the value.
+        //
+        for(ulName = ulLoop; (ulLoop < ulLen) && pucRequest[ulLoop]; ulLoop++)
+        {
+        }
+        for(ulValue = ++ulLoop; (ulLoop < ulLen) && pucRequest[ulLoop];
+            ulLoop++)
+        {
+        }
+
+        //
+        // Stop if the value is not terminated within the packet.
+        //
+        if(ulLoop >= ulLen)
+        {
+            break;
+        }
+        ulLoop++;
+
+        //
+        // Record the block size or window size if this is one of those
+        // options and the value is valid.
+        //
+        ulNumber = ustrtoul((char *)&pucRequest[ulValue], 0, 10);
+        if(!ustrcasecmp((char *)&pucRequest[ulName], "blksize") &&
+           (ulNumber >= 8) && (ulNumber <= 65464))
+        {
+            psTFTP->ulBlockSize = ((ulNumber < TFTP_BLOCK_SIZE_MAX) ?
+                                   ulNumber : TFTP_BLOCK_SIZE_MAX);
+            psTFTP->ucFlags |= TFTP_FLAG_BLKSIZE;
+        }
+        else if(!ustrcasecmp((char *)&pucRequest[ulName], "windowsize") &&
+                (ulNumber >= 1) && (ulNumber <= 65535))
+        {
+            psTFTP->ulWindowSize = ulNumber;
+            psTFTP->ucFlags |= TFTP_FLAG_WINDOWSIZE;
+        }
+    }
+}
+
 //*****************************************************************************
 //
 // Handles datagrams received on the TFTP server port.
@@ -534,6 +733,7 @@ TFTPRecv(void *arg, struct udp_pcb *upcb, struct pbuf *p, struct ip_addr *addr,
          u16_t port)
 {
     unsigned char *pucData;
+    unsigned long ulBlockSize, ulWindowSize;
     tBoolean bGetRequest;
     tTFTPMode eMode;
     tTFTPError eRetcode;
@@ -607,6 +807,19 @@ TFTPRecv(void *arg, struct udp_pcb *upcb, struct pbuf *p, struct ip_addr *addr,
         //
         memset(psTFTP, 0, sizeof(tTFTPConnection));
         psTFTP->pcErrorString = "Unknown error";
+        psTFTP->ulBlockSize = TFTP_BLOCK_SIZE;
+        psTFTP->ulWindowSize = 1;
+
+        //
+        // Options are only supported for PUT requests, so find those that
+        // the client would like to use.
+        //
+        if(!bGetRequest)
+        {
+            TFTPOptionsGet(psTFTP, pucData, p->len);
+        }
+        ulBlockSize = psTFTP->ulBlockSize;
+        ulWindowSize = psTFTP->ulWindowSize;
 
         //
         // Yes - create the new UDP connection and set things up to
@@ -641,11 +854,34 @@ TFTPRecv(void *arg, struct udp_pcb *upcb, struct pbuf *p, struct ip_addr *addr,
             else
             {
                 //
-                // For a PUT request, we acknowledge the transfer which tells
-                // the TFTP client that it can start sending us data.
+                // The application may have reduced the block size and window
+                // size, but must not have increased them.
+                //
+                if((psTFTP->ulBlockSize < 8) ||
+                   (psTFTP->ulBlockSize > ulBlockSize))
+                {
+                    psTFTP->ulBlockSize = ulBlockSize;
+                }
+                if((psTFTP->ulWindowSize < 1) ||
+                   (psTFTP->ulWindowSize > ulWindowSize))
+                {
+                    psTFTP->ulWindowSize = ulWindowSize;
+                }
+
+                //
+                // For a PUT request, we acknowledge the transfer (or the
+                // options that were requested) which tells the TFTP client
+                // that it can start sending us data.
                 //
                 psTFTP->ulBlockNum = 0;
-                TFTPDataAck(psTFTP);
+                if(psTFTP->ucFlags)
+                {
+                    TFTPOptionsAck(psTFTP);
+                }
+                else
+                {
+                    TFTPDataAck(psTFTP);
+                }
             }
         }
         else
@@ -666,6 +902,33 @@ TFTPRecv(void *arg, struct udp_pcb *upcb, struct pbuf *p, struct ip_addr *addr,
     pbuf_free(p);
 }
 
+//*****************************************************************************
+//
+//! Sends an acknowledgement that was withheld from the client.
+//!
+//! \param psTFTP is the connection for which the acknowledgement was withheld.
+//!
+//! This function must be called by the application once it is able to accept
+//! further data after a pfnPutData callback has returned TFTP_BUSY.  It sends
+//! the acknowledgement of the last block that was accepted, which causes the
+//! client to send the blocks that follow it.  If the acknowledgement is not
+//! being withheld, this function does nothing.
+//!
+//! This function must be called from the same context as the lwIP stack, for
+//! example from the lwIPHostTimerHandler() function.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+TFTPDataResume(tTFTPConnection *psTFTP)
+{
+    if(psTFTP->bAckDeferred)
+    {
+        TFTPDataAck(psTFTP);
+    }
+}
+
 //*****************************************************************************
 //
 //! Initializes the TFTP server module.
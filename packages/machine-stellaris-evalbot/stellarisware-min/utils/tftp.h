@@ -35,11 +35,17 @@
 //*****************************************************************************
 //
 //! TFTP error codes.  Note that this enum is mapped so that all positive
-//! values match the TFTP protocol-defined error codes.
+//! values match the TFTP protocol-defined error codes.  TFTP_BUSY may be
+//! returned by a pfnPutData callback for the first portion of a block (when
+//! ulDataRemaining is zero) to indicate that the application can not accept
+//! the block at this time.  The block is discarded and its acknowledgement is
+//! withheld until the application calls TFTPDataResume(), or the client
+//! retransmits it.
 //
 //*****************************************************************************
 typedef enum
 {
+    TFTP_BUSY = -2,
     TFTP_OK = -1,
     TFTP_ERR_NOT_DEFINED = 0,
     TFTP_FILE_NOT_FOUND = 1,
@@ -68,11 +74,20 @@ typedef enum
 //*****************************************************************************
 //
 //! Data transfer under TFTP is performed using fixed-size blocks.  This label
-//! defines the size of a block of TFTP data.
+//! defines the size of a block of TFTP data, unless a different size is
+//! negotiated with the blksize option (RFC 2348) of a PUT request.
 //
 //*****************************************************************************
 #define TFTP_BLOCK_SIZE 512
 
+//*****************************************************************************
+//
+//! The largest block size that may be negotiated with the blksize option.
+//! This is chosen so that a block fits in a single Ethernet frame.
+//
+//*****************************************************************************
+#define TFTP_BLOCK_SIZE_MAX 1428
+
 //*****************************************************************************
 //
 // Callback function prototypes passed to TFTPInit.  These functions receive
@@ -173,6 +188,49 @@ typedef struct _tTFTPConnection
     //! must not modify it.
     //
     unsigned long ulBlockNum;
+
+    //
+    //! The size of the data blocks of a PUT request.  Before the tTFTPRequest
+    //! callback is made, this is set to the size requested by the client with
+    //! the blksize option, or to TFTP_BLOCK_SIZE if the option was not given.
+    //! The application may reduce it during the callback.
+    //
+    unsigned long ulBlockSize;
+
+    //
+    //! The number of data blocks of a PUT request that the client sends
+    //! before waiting for an acknowledgement.  Before the tTFTPRequest
+    //! callback is made, this is set to the size requested by the client with
+    //! the windowsize option (RFC 7440), or to one if the option was not given.
+    //! The application may reduce it during the callback.
+    //
+    unsigned long ulWindowSize;
+
+    //
+    //! This field is set by the TFTP module before the pfnClose callback is
+    //! made if the transfer completed successfully.
+    //
+    tBoolean bComplete;
+
+    //
+    //! Flags indicating the options given by the client and the state of the
+    //! transfer.  Applications must not modify this field.
+    //
+    unsigned char ucFlags;
+
+    //
+    //! This field is set by the TFTP module when a pfnPutData callback has
+    //! returned TFTP_BUSY and the acknowledgement of the received data has
+    //! been withheld.  Applications may read this field but must not modify
+    //! it.
+    //
+    tBoolean bAckDeferred;
+
+    //
+    //! The number of data blocks received since the last acknowledgement was
+    //! sent.  Applications must not modify this field.
+    //
+    unsigned long ulWindowCount;
 } tTFTPConnection;
 
 //*****************************************************************************
@@ -181,6 +239,7 @@ typedef struct _tTFTPConnection
 //
 //*****************************************************************************
 void TFTPInit(tTFTPRequest pfnRequest);
+void TFTPDataResume(tTFTPConnection *psTFTP);
 
 //*****************************************************************************
 //
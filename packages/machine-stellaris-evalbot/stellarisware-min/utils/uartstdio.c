@@ -33,6 +33,7 @@
 #include "driverlib/rom_map.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/uart.h"
+#include "driverlib/udma.h"
 #include "utils/uartstdio.h"
 
 //*****************************************************************************
@@ -114,6 +115,47 @@ static volatile unsigned long g_ulUARTRxReadIndex = 0;
                                               UART_RX_BUFFER_SIZE))
 #define ADVANCE_RX_BUFFER_INDEX(Index) \
                                 (Index) = ((Index) + 1) % UART_RX_BUFFER_SIZE
+
+#ifdef UART_TX_DMA
+//*****************************************************************************
+//
+// The number of bytes from the output ring buffer that are currently being
+// moved into the UART transmit FIFO by the uDMA controller, or zero if no
+// transfer is in progress.  The read index of the output ring buffer is only
+// advanced past these bytes once the transfer has completed, so they can not
+// be overwritten while the transfer is in progress.
+//
+//*****************************************************************************
+static volatile unsigned long g_ulUARTTxDMACount = 0;
+
+//*****************************************************************************
+//
+// The maximum number of bytes that can be moved by a single uDMA transfer.
+//
+//*****************************************************************************
+#define UART_TX_DMA_MAX_TRANSFER                                              \
+                                1024
+#endif
+#endif
+
+#ifndef UART_BUFFERED
+//*****************************************************************************
+//
+// This global controls whether or not UARTwrite() waits for space in the UART
+// transmit FIFO.  If non-blocking output is enabled, characters that do not
+// fit in the transmit FIFO are not written.
+//
+//*****************************************************************************
+static tBoolean g_bTxNonBlocking;
+
+//*****************************************************************************
+//
+// This global indicates that the CR which precedes a LF has been written to
+// the UART transmit FIFO but the LF itself has not, due to the transmit FIFO
+// being full in non-blocking mode.
+//
+//*****************************************************************************
+static tBoolean g_bTxCRWritten;
 #endif
 
 //*****************************************************************************
@@ -160,6 +202,19 @@ static const unsigned long g_ulUARTInt[3] =
 static unsigned long g_ulPortNum;
 #endif
 
+#if defined(UART_BUFFERED) && defined(UART_TX_DMA)
+//*****************************************************************************
+//
+// The list of uDMA channels used to transmit on the console UART.  UART2 is
+// only available as a secondary channel assignment.
+//
+//*****************************************************************************
+static const unsigned long g_ulUARTTxDMAChannel[3] =
+{
+    UDMA_CHANNEL_UART0TX, UDMA_CHANNEL_UART1TX, UDMA_SEC_CHANNEL_UART2TX_1
+};
+#endif
+
 //*****************************************************************************
 //
 // The list of UART peripherals.
@@ -271,7 +326,7 @@ GetBufferCount(volatile unsigned long *pulRead,
 // them into the UART transmit FIFO.
 //
 //*****************************************************************************
-#ifdef UART_BUFFERED
+#if defined(UART_BUFFERED) && !defined(UART_TX_DMA)
 static void
 UARTPrimeTransmit(unsigned long ulBase)
 {
@@ -305,6 +360,75 @@ UARTPrimeTransmit(unsigned long ulBase)
 }
 #endif
 
+//*****************************************************************************
+//
+// Retire the uDMA transfer from the transmit buffer if it has completed, and
+// start a transfer of the next contiguous span of the transmit buffer if no
+// transfer is in progress.
+//
+//*****************************************************************************
+#if defined(UART_BUFFERED) && defined(UART_TX_DMA)
+static void
+UARTPrimeTransmit(unsigned long ulBase)
+{
+    unsigned long ulChannel, ulRead, ulWrite, ulCount;
+
+    //
+    // Do we have any data to transmit (or in the process of being
+    // transmitted)?
+    //
+    if(!TX_BUFFER_EMPTY)
+    {
+        //
+        // Disable the UART interrupt.  The uDMA controller signals the end of
+        // a transfer on the UART interrupt, so if we don't do this there is a
+        // race condition which can cause a transfer to be retired twice.
+        //
+        MAP_IntDisable(g_ulUARTInt[g_ulPortNum]);
+
+        //
+        // If the transfer in progress has completed, advance the read index
+        // past the bytes that it moved into the transmit FIFO.
+        //
+        ulChannel = g_ulUARTTxDMAChannel[g_ulPortNum];
+        if(g_ulUARTTxDMACount && !MAP_uDMAChannelIsEnabled(ulChannel))
+        {
+            g_ulUARTTxReadIndex = ((g_ulUARTTxReadIndex + g_ulUARTTxDMACount) %
+                                   UART_TX_BUFFER_SIZE);
+            g_ulUARTTxDMACount = 0;
+        }
+
+        //
+        // If no transfer is in progress and there is more data to transmit,
+        // start a transfer of the data up to the end of the buffer or the
+        // write index, whichever comes first.
+        //
+        ulRead = g_ulUARTTxReadIndex;
+        ulWrite = g_ulUARTTxWriteIndex;
+        if(!g_ulUARTTxDMACount && (ulRead != ulWrite))
+        {
+            ulCount = ((ulWrite > ulRead) ? ulWrite : UART_TX_BUFFER_SIZE) -
+                      ulRead;
+            if(ulCount > UART_TX_DMA_MAX_TRANSFER)
+            {
+                ulCount = UART_TX_DMA_MAX_TRANSFER;
+            }
+            MAP_uDMAChannelTransferSet(ulChannel | UDMA_PRI_SELECT,
+                                       UDMA_MODE_BASIC,
+                                       &g_pcUARTTxBuffer[ulRead],
+                                       (void *)(ulBase + UART_O_DR), ulCount);
+            g_ulUARTTxDMACount = ulCount;
+            MAP_uDMAChannelEnable(ulChannel);
+        }
+
+        //
+        // Reenable the UART interrupt.
+        //
+        MAP_IntEnable(g_ulUARTInt[g_ulPortNum]);
+    }
+}
+#endif
+
 //*****************************************************************************
 //
 //! Configures the UART console.
@@ -324,6 +448,10 @@ UARTPrimeTransmit(unsigned long ulBase)
 //! caller has previously configured the relevant UART pins for operation as a
 //! UART rather than as GPIOs.
 //!
+//! When the module is built with \b UART_TX_DMA, this function also assumes
+//! that the caller has previously enabled the uDMA controller and set the
+//! base address of its channel control table.
+//!
 //! \return None.
 //
 //*****************************************************************************
@@ -369,24 +497,51 @@ UARTStdioConfig(unsigned long ulPortNum, unsigned long ulBaud,
                             (UART_CONFIG_PAR_NONE | UART_CONFIG_STOP_ONE |
                              UART_CONFIG_WLEN_8));
 
-#ifdef UART_BUFFERED
+#if defined(UART_BUFFERED) && defined(UART_TX_DMA)
+    //
+    // Set the UART to request transmit data from the uDMA controller whenever
+    // the TX FIFO is half empty, and to interrupt when any character is
+    // received.
+    //
+    MAP_UARTFIFOLevelSet(g_ulBase, UART_FIFO_TX4_8, UART_FIFO_RX1_8);
+
+    //
+    // Set up the uDMA channel to copy bytes from the transmit buffer into the
+    // UART data register, four at a time.  UART2 must be selected as the
+    // secondary peripheral of its channel.
+    //
+    if(ulPortNum == 2)
+    {
+        MAP_uDMAChannelSelectSecondary(UDMA_DEF_USBEP1TX_SEC_UART2TX);
+    }
+    MAP_uDMAChannelAttributeDisable(g_ulUARTTxDMAChannel[ulPortNum],
+                                    UDMA_ATTR_ALL);
+    MAP_uDMAChannelControlSet(g_ulUARTTxDMAChannel[ulPortNum] |
+                              UDMA_PRI_SELECT,
+                              (UDMA_SIZE_8 | UDMA_SRC_INC_8 |
+                               UDMA_DST_INC_NONE | UDMA_ARB_4));
+    MAP_UARTDMAEnable(g_ulBase, UART_DMA_TX);
+#elif defined(UART_BUFFERED)
     //
     // Set the UART to interrupt whenever the TX FIFO is almost empty or
     // when any character is received.
     //
     MAP_UARTFIFOLevelSet(g_ulBase, UART_FIFO_TX1_8, UART_FIFO_RX1_8);
+#endif
 
-    //
-    // Flush both the buffers.
-    //
-    UARTFlushRx();
-    UARTFlushTx(true);
+#ifdef UART_BUFFERED
 
     //
     // Remember which interrupt we are dealing with.
     //
     g_ulPortNum = ulPortNum;
 
+    //
+    // Flush both the buffers.
+    //
+    UARTFlushRx();
+    UARTFlushTx(true);
+
     //
     // We are configured for buffered output so enable the master interrupt
     // for this UART and the receive interrupts.  We don't actually enable the
@@ -486,10 +641,12 @@ UARTStdioInitExpClk(unsigned long ulPortNum, unsigned long ulBaud)
 //! transmitted and the function will return.
 //!
 //! In non-buffered mode, this function is blocking and will not return until
-//! all the characters have been written to the output FIFO.  In buffered mode,
-//! the characters are written to the UART transmit buffer and the call returns
-//! immediately.  If insufficient space remains in the transmit buffer,
-//! additional characters are discarded.
+//! all the characters have been written to the output FIFO, unless
+//! non-blocking output has been enabled with UARTTxNonBlockingSet().  In that
+//! case, or in buffered mode, the characters are written to the UART transmit
+//! FIFO or buffer and the call returns immediately.  If insufficient space
+//! remains in the transmit FIFO or buffer, additional characters are
+//! discarded.
 //!
 //! \return Returns the count of characters written.
 //
@@ -513,11 +670,13 @@ UARTwrite(const char *pcBuf, unsigned long ulLen)
     {
         //
         // If the character to the UART is \n, then add a \r before it so that
-        // \n is translated to \n\r in the output.
+        // \n is translated to \n\r in the output.  Only do so if there is
+        // space for both characters, so that the count of characters written
+        // never leaves a \r without its \n.
         //
         if(pcBuf[uIdx] == '\n')
         {
-            if(!TX_BUFFER_FULL)
+            if(TX_BUFFER_FREE > 2)
             {
                 g_pcUARTTxBuffer[g_ulUARTTxWriteIndex] = '\r';
                 ADVANCE_TX_BUFFER_INDEX(g_ulUARTTxWriteIndex);
@@ -555,7 +714,9 @@ UARTwrite(const char *pcBuf, unsigned long ulLen)
     if(!TX_BUFFER_EMPTY)
     {
         UARTPrimeTransmit(g_ulBase);
+#ifndef UART_TX_DMA
         MAP_UARTIntEnable(g_ulBase, UART_INT_TX);
+#endif
     }
 
     //
@@ -571,6 +732,53 @@ UARTwrite(const char *pcBuf, unsigned long ulLen)
     ASSERT(g_ulBase != 0);
     ASSERT(pcBuf != 0);
 
+    //
+    // See if non-blocking output is enabled.
+    //
+    if(g_bTxNonBlocking)
+    {
+        //
+        // Send the characters until the transmit FIFO is full.
+        //
+        for(uIdx = 0; uIdx < ulLen; uIdx++)
+        {
+            //
+            // If the character to the UART is \n, then add a \r before it
+            // (unless that was done by a previous call that could not write
+            // the \n) so that \n is translated to \n\r in the output.
+            //
+            if((pcBuf[uIdx] == '\n') && !g_bTxCRWritten)
+            {
+                if(!MAP_UARTCharPutNonBlocking(g_ulBase, '\r'))
+                {
+                    //
+                    // The FIFO is full - discard remaining characters and
+                    // return.
+                    //
+                    break;
+                }
+                g_bTxCRWritten = true;
+            }
+
+            //
+            // Send the character to the UART output.
+            //
+            if(!MAP_UARTCharPutNonBlocking(g_ulBase, pcBuf[uIdx]))
+            {
+                //
+                // The FIFO is full - discard remaining characters and return.
+                //
+                break;
+            }
+            g_bTxCRWritten = false;
+        }
+
+        //
+        // Return the number of characters written.
+        //
+        return(uIdx);
+    }
+
     //
     // Send the characters
     //
@@ -580,10 +788,11 @@ UARTwrite(const char *pcBuf, unsigned long ulLen)
         // If the character to the UART is \n, then add a \r before it so that
         // \n is translated to \n\r in the output.
         //
-        if(pcBuf[uIdx] == '\n')
+        if((pcBuf[uIdx] == '\n') && !g_bTxCRWritten)
         {
             MAP_UARTCharPut(g_ulBase, '\r');
         }
+        g_bTxCRWritten = false;
 
         //
         // Send the character to the UART output.
@@ -598,6 +807,32 @@ UARTwrite(const char *pcBuf, unsigned long ulLen)
 #endif
 }
 
+//*****************************************************************************
+//
+//! Enables or disables non-blocking output.
+//!
+//! \param bEnable must be set to \b true to enable non-blocking output or
+//! \b false to disable it.
+//!
+//! This function, available only when the module is built to operate in
+//! non-buffered mode, may be used to control whether or not UARTwrite() and
+//! UARTprintf() wait for space in the UART transmit FIFO.  By default, output
+//! is blocking.  When non-blocking output is enabled, characters that do not
+//! fit in the transmit FIFO are discarded and the number of characters that
+//! were written is returned, so that tasks which must not be delayed can
+//! still produce console output.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#if !defined(UART_BUFFERED) || defined(DOXYGEN)
+void
+UARTTxNonBlockingSet(tBoolean bEnable)
+{
+    g_bTxNonBlocking = bEnable;
+}
+#endif
+
 //*****************************************************************************
 //
 //! A simple UART based get string function, with some line processing.
@@ -882,14 +1117,110 @@ UARTgetc(void)
 
 //*****************************************************************************
 //
-//! A simple UART based printf function supporting \%c, \%d, \%p, \%s, \%u,
+// The buffer into which UARTvprintf() formats its output before passing it to
+// UARTwrite().
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The formatted characters that have not yet been passed to UARTwrite().
+    //
+    char pcBuf[UART_PRINTF_BUFFER_SIZE];
+
+    //
+    // The number of characters in pcBuf.
+    //
+    unsigned long ulPos;
+
+    //
+    // The number of characters that UARTwrite() has written.
+    //
+    int iCount;
+
+    //
+    // Set once UARTwrite() has failed to write all of the characters that it
+    // was given, after which any further output is discarded.
+    //
+    tBoolean bFull;
+}
+tUARTPrintfBuffer;
+
+//*****************************************************************************
+//
+// Passes the characters in a UARTvprintf() output buffer to UARTwrite() and
+// empties the buffer.
+//
+//*****************************************************************************
+static void
+UARTPrintfFlush(tUARTPrintfBuffer *psBuffer)
+{
+    int iCount;
+
+    //
+    // See if there are characters to write, and if all previous characters
+    // have been written.
+    //
+    if(psBuffer->ulPos && !psBuffer->bFull)
+    {
+        //
+        // Write the characters, and stop writing any further output if they
+        // were not all written.
+        //
+        iCount = UARTwrite(psBuffer->pcBuf, psBuffer->ulPos);
+        psBuffer->iCount += iCount;
+        if(iCount != (int)psBuffer->ulPos)
+        {
+            psBuffer->bFull = true;
+        }
+    }
+
+    //
+    // Empty the buffer.
+    //
+    psBuffer->ulPos = 0;
+}
+
+//*****************************************************************************
+//
+// Adds characters to a UARTvprintf() output buffer, writing out the buffer
+// whenever it fills.
+//
+//*****************************************************************************
+static void
+UARTPrintfPut(tUARTPrintfBuffer *psBuffer, const char *pcStr,
+              unsigned long ulLen)
+{
+    //
+    // Loop through the characters.
+    //
+    while(ulLen--)
+    {
+        //
+        // Write out the buffer if it is full.
+        //
+        if(psBuffer->ulPos == sizeof(psBuffer->pcBuf))
+        {
+            UARTPrintfFlush(psBuffer);
+        }
+
+        //
+        // Add this character to the buffer.
+        //
+        psBuffer->pcBuf[psBuffer->ulPos++] = *pcStr++;
+    }
+}
+
+//*****************************************************************************
+//
+//! A simple UART based vprintf function supporting \%c, \%d, \%p, \%s, \%u,
 //! \%x, and \%X.
 //!
 //! \param pcString is the format string.
-//! \param ... are the optional arguments, which depend on the contents of the
-//! format string.
+//! \param vaArgP is a variable argument list pointer whose content will depend
+//! upon the format string passed in \e pcString.
 //!
-//! This function is very similar to the C library <tt>fprintf()</tt> function.
+//! This function is very similar to the C library <tt>vprintf()</tt> function.
 //! All of its output will be sent to the UART.  Only the following formatting
 //! characters are supported:
 //!
@@ -915,15 +1246,23 @@ UARTgetc(void)
 //! the format string.  For example, if an integer was passed where a string
 //! was expected, an error of some kind will most likely occur.
 //!
-//! \return None.
+//! The output is formatted into a buffer of \b UART_PRINTF_BUFFER_SIZE bytes
+//! on the stack, which is passed to UARTPrintfPut(&sBuffer, ) each time that it fills and
+//! once formatting is complete.  Output that fits in this buffer is therefore
+//! placed into the transmit buffer (and, when the module is built with
+//! \b UART_TX_DMA, handed to the uDMA controller) in a single operation.  If
+//! UARTPrintfPut(&sBuffer, ) is unable to write all of the characters that it is given, the
+//! remainder of the output is discarded.
+//!
+//! \return Returns the count of characters written.
 //
 //*****************************************************************************
-void
-UARTprintf(const char *pcString, ...)
+int
+UARTvprintf(const char *pcString, va_list vaArgP)
 {
     unsigned long ulIdx, ulValue, ulPos, ulCount, ulBase, ulNeg;
     char *pcStr, pcBuf[16], cFill;
-    va_list vaArgP;
+    tUARTPrintfBuffer sBuffer;
 
     //
     // Check the arguments.
@@ -931,9 +1270,11 @@ UARTprintf(const char *pcString, ...)
     ASSERT(pcString != 0);
 
     //
-    // Start the varargs processing.
+    // Start with an empty output buffer.
     //
-    va_start(vaArgP, pcString);
+    sBuffer.ulPos = 0;
+    sBuffer.iCount = 0;
+    sBuffer.bFull = false;
 
     //
     // Loop while there are more characters in the string.
@@ -951,7 +1292,7 @@ UARTprintf(const char *pcString, ...)
         //
         // Write this portion of the string.
         //
-        UARTwrite(pcString, ulIdx);
+        UARTPrintfPut(&sBuffer, pcString, ulIdx);
 
         //
         // Skip the portion of the string that was written.
@@ -1035,7 +1376,7 @@ again:
                     //
                     // Print out the character.
                     //
-                    UARTwrite((char *)&ulValue, 1);
+                    UARTPrintfPut(&sBuffer, (char *)&ulValue, 1);
 
                     //
                     // This command has been handled.
@@ -1115,7 +1456,7 @@ again:
                     //
                     // Write the string.
                     //
-                    UARTwrite(pcStr, ulIdx);
+                    UARTPrintfPut(&sBuffer, pcStr, ulIdx);
 
                     //
                     // Write any required padding spaces
@@ -1125,7 +1466,7 @@ again:
                         ulCount -= ulIdx;
                         while(ulCount--)
                         {
-                            UARTwrite(" ", 1);
+                            UARTPrintfPut(&sBuffer, " ", 1);
                         }
                     }
                     //
@@ -1271,7 +1612,7 @@ convert:
                     //
                     // Write the string.
                     //
-                    UARTwrite(pcBuf, ulPos);
+                    UARTPrintfPut(&sBuffer, pcBuf, ulPos);
 
                     //
                     // This command has been handled.
@@ -1287,7 +1628,7 @@ convert:
                     //
                     // Simply write a single %.
                     //
-                    UARTwrite(pcString - 1, 1);
+                    UARTPrintfPut(&sBuffer, pcString - 1, 1);
 
                     //
                     // This command has been handled.
@@ -1303,7 +1644,7 @@ convert:
                     //
                     // Indicate an error.
                     //
-                    UARTwrite("ERROR", 5);
+                    UARTPrintfPut(&sBuffer, "ERROR", 5);
 
                     //
                     // This command has been handled.
@@ -1314,10 +1655,58 @@ convert:
         }
     }
 
+    //
+    // Write any output that remains in the buffer.
+    //
+    UARTPrintfFlush(&sBuffer);
+
+    //
+    // Return the number of characters written.
+    //
+    return(sBuffer.iCount);
+}
+
+//*****************************************************************************
+//
+//! A simple UART based printf function supporting \%c, \%d, \%p, \%s, \%u,
+//! \%x, and \%X.
+//!
+//! \param pcString is the format string.
+//! \param ... are the optional arguments, which depend on the contents of the
+//! format string.
+//!
+//! This function is very similar to the C library <tt>fprintf()</tt> function.
+//! All of its output will be sent to the UART.  The supported formatting
+//! characters are described in the documentation of UARTvprintf().
+//!
+//! \return Returns the count of characters written.
+//
+//*****************************************************************************
+int
+UARTprintf(const char *pcString, ...)
+{
+    va_list vaArgP;
+    int iCount;
+
+    //
+    // Start the varargs processing.
+    //
+    va_start(vaArgP, pcString);
+
+    //
+    // Format and write the string.
+    //
+    iCount = UARTvprintf(pcString, vaArgP);
+
     //
     // End the varargs processing.
     //
     va_end(vaArgP);
+
+    //
+    // Return the number of characters written.
+    //
+    return(iCount);
 }
 
 //*****************************************************************************
@@ -1492,6 +1881,14 @@ UARTFlushTx(tBoolean bDiscard)
         //
         ulInt = MAP_IntMasterDisable();
 
+#ifdef UART_TX_DMA
+        //
+        // Abandon the uDMA transfer that is in progress, if any.
+        //
+        MAP_uDMAChannelDisable(g_ulUARTTxDMAChannel[g_ulPortNum]);
+        g_ulUARTTxDMACount = 0;
+#endif
+
         //
         // Flush the transmit buffer.
         //
@@ -1554,7 +1951,10 @@ UARTEchoSet(tBoolean bEnable)
 //! This function handles interrupts from the UART.  It will copy data from the
 //! transmit buffer to the UART transmit FIFO if space is available, and it
 //! will copy data from the UART receive FIFO to the receive buffer if data is
-//! available.
+//! available.  When the module is built with \b UART_TX_DMA, the uDMA
+//! controller copies data into the UART transmit FIFO and signals the end of
+//! each transfer on the UART interrupt; this function then starts the transfer
+//! of any further data in the transmit buffer.
 //!
 //! \return None.
 //
@@ -1574,6 +1974,14 @@ UARTStdioIntHandler(void)
     ulInts = MAP_UARTIntStatus(g_ulBase, true);
     MAP_UARTIntClear(g_ulBase, ulInts);
 
+#ifdef UART_TX_DMA
+    //
+    // The end of a uDMA transfer is not reflected in the UART interrupt
+    // status, so check for a completed transfer on every interrupt and start
+    // the next one.
+    //
+    UARTPrimeTransmit(g_ulBase);
+#else
     //
     // Are we being interrupted because the TX FIFO has space available?
     //
@@ -1592,6 +2000,7 @@ UARTStdioIntHandler(void)
             MAP_UARTIntDisable(g_ulBase, UART_INT_TX);
         }
     }
+#endif
 
     //
     // Are we being interrupted due to a received character?
@@ -1719,7 +2128,9 @@ UARTStdioIntHandler(void)
         // gets transmitted.
         //
         UARTPrimeTransmit(g_ulBase);
+#ifndef UART_TX_DMA
         MAP_UARTIntEnable(g_ulBase, UART_INT_TX);
+#endif
     }
 }
 #endif
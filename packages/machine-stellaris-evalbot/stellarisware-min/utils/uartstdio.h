@@ -25,6 +25,8 @@
 #ifndef __UARTSTDIO_H__
 #define __UARTSTDIO_H__
 
+#include <stdarg.h>
+
 //*****************************************************************************
 //
 // If building with a C++ compiler, make all of the definitions in this header
@@ -51,6 +53,25 @@ extern "C"
 #endif
 #endif
 
+//*****************************************************************************
+//
+// The size of the buffer on the stack into which UARTprintf() formats its
+// output.
+//
+//*****************************************************************************
+#ifndef UART_PRINTF_BUFFER_SIZE
+#define UART_PRINTF_BUFFER_SIZE 64
+#endif
+
+//*****************************************************************************
+//
+// Transmission using the uDMA controller is only supported in buffered mode.
+//
+//*****************************************************************************
+#if defined(UART_TX_DMA) && !defined(UART_BUFFERED)
+#error "UART_TX_DMA requires UART_BUFFERED"
+#endif
+
 //*****************************************************************************
 //
 // Prototypes for the APIs.
@@ -62,8 +83,12 @@ extern void UARTStdioInit(unsigned long ulPort);
 extern void UARTStdioInitExpClk(unsigned long ulPort, unsigned long ulBaud);
 extern int UARTgets(char *pcBuf, unsigned long ulLen);
 extern unsigned char UARTgetc(void);
-extern void UARTprintf(const char *pcString, ...);
+extern int UARTprintf(const char *pcString, ...);
+extern int UARTvprintf(const char *pcString, va_list vaArgP);
 extern int UARTwrite(const char *pcBuf, unsigned long ulLen);
+#ifndef UART_BUFFERED
+extern void UARTTxNonBlockingSet(tBoolean bEnable);
+#endif
 #ifdef UART_BUFFERED
 extern int UARTPeek(unsigned char ucChar);
 extern void UARTFlushTx(tBoolean bDiscard);
@@ -0,0 +1,341 @@
+//*****************************************************************************
+//
+// vecmath.c - Fixed point vector math functions, using the SIMD and DSP
+//             instructions of the Cortex-M4 where they are available.
+//
+// Copyright (c) 2006-2013 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 10636 of the Stellaris Firmware Development Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <string.h>
+#include "utils/vecmath.h"
+
+//*****************************************************************************
+//
+//! \addtogroup vecmath_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// When compiled for a processor with the DSP extension (Cortex-M4), the
+// functions process two samples at a time, packed into a 32-bit word as the
+// SIMD instructions expect: the first sample in the lower halfword, the second
+// in the upper halfword.  Otherwise (for example, on the Cortex-M3 of the
+// Stellaris parts), they process one sample at a time in portable C.  Both
+// produce bit-identical results.
+//
+// Defining VECMATH_SIMD_EMULATION selects the SIMD code with C models of the
+// instructions, so that the packing of the samples can be tested on a host.
+//
+//*****************************************************************************
+#if defined(__GNUC__) && defined(__ARM_FEATURE_DSP)
+#define VECMATH_SIMD
+
+//
+// Adds both signed 16x16-bit products of the halfwords of two words to a
+// 64-bit accumulator.
+//
+static inline int64_t
+vec_smlald(int64_t i64Acc, uint32_t ui32A, uint32_t ui32B)
+{
+    __asm("smlald %Q0, %R0, %1, %2"
+          : "+r" (i64Acc)
+          : "r" (ui32A), "r" (ui32B));
+    return(i64Acc);
+}
+
+//
+// Adds the halfwords of two words with signed saturation.
+//
+static inline uint32_t
+vec_qadd16(uint32_t ui32A, uint32_t ui32B)
+{
+    uint32_t ui32Result;
+
+    __asm("qadd16 %0, %1, %2"
+          : "=r" (ui32Result)
+          : "r" (ui32A), "r" (ui32B));
+    return(ui32Result);
+}
+
+//
+// Multiplies the lower and the upper halfword of a word by the lower halfword
+// of another word.
+//
+static inline int32_t
+vec_smulbb(uint32_t ui32A, uint32_t ui32B)
+{
+    int32_t i32Result;
+
+    __asm("smulbb %0, %1, %2"
+          : "=r" (i32Result)
+          : "r" (ui32A), "r" (ui32B));
+    return(i32Result);
+}
+
+static inline int32_t
+vec_smultb(uint32_t ui32A, uint32_t ui32B)
+{
+    int32_t i32Result;
+
+    __asm("smultb %0, %1, %2"
+          : "=r" (i32Result)
+          : "r" (ui32A), "r" (ui32B));
+    return(i32Result);
+}
+
+//
+// Saturates a signed value to 16 bits.
+//
+static inline int32_t
+vec_ssat16(int32_t i32Value)
+{
+    int32_t i32Result;
+
+    __asm("ssat %0, #16, %1"
+          : "=r" (i32Result)
+          : "r" (i32Value));
+    return(i32Result);
+}
+#elif defined(VECMATH_SIMD_EMULATION)
+#define VECMATH_SIMD
+
+static int32_t
+vec_ssat16(int32_t i32Value)
+{
+    return((i32Value > 32767) ? 32767 :
+           ((i32Value < -32768) ? -32768 : i32Value));
+}
+
+static int64_t
+vec_smlald(int64_t i64Acc, uint32_t ui32A, uint32_t ui32B)
+{
+    return(i64Acc + (int32_t)(int16_t)ui32A * (int16_t)ui32B +
+           (int32_t)(int16_t)(ui32A >> 16) * (int16_t)(ui32B >> 16));
+}
+
+static uint32_t
+vec_qadd16(uint32_t ui32A, uint32_t ui32B)
+{
+    return(((uint32_t)vec_ssat16((int16_t)ui32A + (int16_t)ui32B) & 0xffff) |
+           ((uint32_t)vec_ssat16((int16_t)(ui32A >> 16) +
+                                 (int16_t)(ui32B >> 16)) << 16));
+}
+
+static int32_t
+vec_smulbb(uint32_t ui32A, uint32_t ui32B)
+{
+    return((int32_t)(int16_t)ui32A * (int16_t)ui32B);
+}
+
+static int32_t
+vec_smultb(uint32_t ui32A, uint32_t ui32B)
+{
+    return((int32_t)(int16_t)(ui32A >> 16) * (int16_t)ui32B);
+}
+#else
+static int32_t
+vec_ssat16(int32_t i32Value)
+{
+    return((i32Value > 32767) ? 32767 :
+           ((i32Value < -32768) ? -32768 : i32Value));
+}
+#endif
+
+#ifdef VECMATH_SIMD
+//
+// Loads and stores two samples, which need not be aligned to a word.  The
+// Cortex-M4 supports unaligned word accesses, and compilers turn these copies
+// into single loads and stores.
+//
+static uint32_t
+vec_load2(const int16_t *pi16Src)
+{
+    uint32_t ui32Value;
+
+    memcpy(&ui32Value, pi16Src, sizeof(ui32Value));
+    return(ui32Value);
+}
+
+static void
+vec_store2(int16_t *pi16Dst, uint32_t ui32Value)
+{
+    memcpy(pi16Dst, &ui32Value, sizeof(ui32Value));
+}
+#endif
+
+//*****************************************************************************
+//
+//! Computes the dot product of two vectors.
+//!
+//! \param pi16A is a pointer to the first vector.
+//! \param pi16B is a pointer to the second vector.
+//! \param ui32Count is the number of samples in each vector.
+//!
+//! This function computes the sum of the products of the corresponding
+//! samples of two vectors.  The sum is accumulated with 64 bits, so it is
+//! exact for vectors of any practical length.
+//!
+//! \return Returns the dot product, in 34.30 fixed point format.
+//
+//*****************************************************************************
+int64_t
+vec_dot_q15(const int16_t *pi16A, const int16_t *pi16B, uint32_t ui32Count)
+{
+    int64_t i64Acc = 0;
+
+#ifdef VECMATH_SIMD
+    for(; ui32Count >= 2; ui32Count -= 2, pi16A += 2, pi16B += 2)
+    {
+        i64Acc = vec_smlald(i64Acc, vec_load2(pi16A), vec_load2(pi16B));
+    }
+#endif
+
+    while(ui32Count--)
+    {
+        i64Acc += (int32_t)*pi16A++ * *pi16B++;
+    }
+
+    return(i64Acc);
+}
+
+//*****************************************************************************
+//
+//! Filters a block of samples with a finite impulse response filter.
+//!
+//! \param pi16Coeff is a pointer to the filter coefficients, in reverse time
+//! order (that is, the coefficient of the oldest sample first).
+//! \param ui32Taps is the number of filter coefficients.
+//! \param pi16In is a pointer to the input samples, which start with the last
+//! \e ui32Taps - 1 samples of the previous block.
+//! \param pi16Out is a pointer to the array that receives the output samples.
+//! \param ui32Count is the number of output samples.
+//!
+//! This function computes each output sample as the dot product of the
+//! coefficients with the \e ui32Taps input samples that end at the
+//! corresponding new input sample, so \e pi16In must hold \e ui32Count +
+//! \e ui32Taps - 1 samples.  The products are accumulated with 64 bits, and
+//! the sum is rounded to 1.15 format and saturated.  To filter a stream, the
+//! caller copies the last \e ui32Taps - 1 input samples to the start of the
+//! input array before the next block.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+vec_fir_q15(const int16_t *pi16Coeff, uint32_t ui32Taps,
+            const int16_t *pi16In, int16_t *pi16Out, uint32_t ui32Count)
+{
+    int64_t i64Acc;
+
+    while(ui32Count--)
+    {
+        i64Acc = (vec_dot_q15(pi16Coeff, pi16In++, ui32Taps) + 0x4000) >> 15;
+        *pi16Out++ = (int16_t)((i64Acc > 32767) ? 32767 :
+                               ((i64Acc < -32768) ? -32768 : i64Acc));
+    }
+}
+
+//*****************************************************************************
+//
+//! Scales a vector.
+//!
+//! \param pi16In is a pointer to the input vector.
+//! \param i16Scale is the scale factor, in 1.15 fixed point format.
+//! \param ui32Shift is the number of bits, between 0 and 15, by which the
+//! scaled samples are shifted left.
+//! \param pi16Out is a pointer to the array that receives the scaled vector.
+//! \param ui32Count is the number of samples.
+//!
+//! This function multiplies each sample by \e i16Scale * 2^\e ui32Shift,
+//! truncating the result towards negative infinity and saturating it.  The
+//! input and output arrays may be the same array.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+vec_scale_q15(const int16_t *pi16In, int16_t i16Scale, uint32_t ui32Shift,
+              int16_t *pi16Out, uint32_t ui32Count)
+{
+    uint32_t ui32Right = 15 - ui32Shift;
+
+#ifdef VECMATH_SIMD
+    uint32_t ui32Value, ui32Scale = (uint16_t)i16Scale;
+
+    for(; ui32Count >= 2; ui32Count -= 2, pi16In += 2, pi16Out += 2)
+    {
+        ui32Value = vec_load2(pi16In);
+        vec_store2(pi16Out,
+                   ((uint32_t)vec_ssat16(vec_smulbb(ui32Value, ui32Scale) >>
+                                         ui32Right) & 0xffff) |
+                   ((uint32_t)vec_ssat16(vec_smultb(ui32Value, ui32Scale) >>
+                                         ui32Right) << 16));
+    }
+#endif
+
+    while(ui32Count--)
+    {
+        *pi16Out++ = (int16_t)vec_ssat16(((int32_t)*pi16In++ * i16Scale) >>
+                                         ui32Right);
+    }
+}
+
+//*****************************************************************************
+//
+//! Adds two vectors.
+//!
+//! \param pi16A is a pointer to the first vector.
+//! \param pi16B is a pointer to the second vector.
+//! \param pi16Out is a pointer to the array that receives the sum.
+//! \param ui32Count is the number of samples in each vector.
+//!
+//! This function adds the corresponding samples of two vectors, saturating
+//! the sums.  The output array may be the same as either input array.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+vec_add_q15(const int16_t *pi16A, const int16_t *pi16B, int16_t *pi16Out,
+            uint32_t ui32Count)
+{
+#ifdef VECMATH_SIMD
+    for(; ui32Count >= 2;
+        ui32Count -= 2, pi16A += 2, pi16B += 2, pi16Out += 2)
+    {
+        vec_store2(pi16Out, vec_qadd16(vec_load2(pi16A), vec_load2(pi16B)));
+    }
+#endif
+
+    while(ui32Count--)
+    {
+        *pi16Out++ = (int16_t)vec_ssat16((int32_t)*pi16A++ + *pi16B++);
+    }
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
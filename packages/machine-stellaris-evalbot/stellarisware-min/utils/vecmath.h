@@ -0,0 +1,68 @@
+//*****************************************************************************
+//
+// vecmath.h - Prototypes for the fixed point vector math functions.
+//
+// Copyright (c) 2006-2013 Texas Instruments Incorporated.  All rights reserved.
+// Software License Agreement
+//
+// Texas Instruments (TI) is supplying this software for use solely and
+// exclusively on TI's microcontroller products. The software is owned by
+// TI and/or its suppliers, and is protected under applicable copyright
+// laws. You may not combine this software with "viral" open-source
+// software in order to form a larger program.
+//
+// THIS SOFTWARE IS PROVIDED "AS IS" AND WITH ALL FAULTS.
+// NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT
+// NOT LIMITED TO, IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE. TI SHALL NOT, UNDER ANY
+// CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL, OR CONSEQUENTIAL
+// DAMAGES, FOR ANY REASON WHATSOEVER.
+//
+// This is part of revision 10636 of the Stellaris Firmware Development Package.
+//
+//*****************************************************************************
+
+#ifndef __VECMATH_H__
+#define __VECMATH_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Prototypes for the APIs.  The samples are in 1.15 (Q15) fixed point format.
+// The functions use fixed-width types, so that they do not depend on the width
+// of long.
+//
+//*****************************************************************************
+extern int64_t vec_dot_q15(const int16_t *pi16A, const int16_t *pi16B,
+                           uint32_t ui32Count);
+extern void vec_fir_q15(const int16_t *pi16Coeff, uint32_t ui32Taps,
+                        const int16_t *pi16In, int16_t *pi16Out,
+                        uint32_t ui32Count);
+extern void vec_scale_q15(const int16_t *pi16In, int16_t i16Scale,
+                          uint32_t ui32Shift, int16_t *pi16Out,
+                          uint32_t ui32Count);
+extern void vec_add_q15(const int16_t *pi16A, const int16_t *pi16B,
+                        int16_t *pi16Out, uint32_t ui32Count);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __VECMATH_H__
@@ -0,0 +1,608 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+/*
+ * Host test for the UART console module of StellarisWare (utils/uartstdio.c).
+ *
+ * The driver library functions used by the module are replaced by a model of the UART, its uDMA channel and the
+ * interrupt controller.  Each model step shifts one character out of the transmit FIFO onto a simulated wire, services
+ * uDMA requests and delivers any pending UART interrupt (unless it is masked).  Model steps are taken both between
+ * calls to the module and, at random, from within the driver library calls that the module makes, so that interrupts
+ * arrive at arbitrary points of the module's code.
+ *
+ * The module is built in one mode at a time (see uartstdio-test.sh): unbuffered, buffered (UART_BUFFERED) or buffered
+ * with uDMA transmission (UART_BUFFERED and UART_TX_DMA).  For each mode the test checks that formatted output arrives
+ * on the wire intact, that non-blocking output never waits for the wire and reports the number of characters queued,
+ * and reports the number of interrupts, uDMA transfers and busy-wait steps that the output required.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_uart.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+#include "utils/uartstdio.h"
+
+#define FIFO_SIZE 16
+#define WIRE_SIZE (1024 * 1024)
+#define NUM_LINES 4000
+
+static void
+SimFail(const char *pcMessage)
+{
+    fprintf(stderr, "FAIL: %s\n", pcMessage);
+    exit(1);
+}
+
+#ifdef UART_BUFFERED
+extern void UARTStdioIntHandler(void);
+#else
+/* In unbuffered mode the module does not use the UART interrupt, and does not provide a handler for it. */
+static void
+UARTStdioIntHandler(void)
+{
+    SimFail("unexpected interrupt");
+}
+#endif
+
+/* The state of the simulated UART, uDMA channel and interrupt controller. */
+static struct
+{
+    unsigned char pucFifo[FIFO_SIZE];
+    unsigned long ulFifoHead;
+    unsigned long ulFifoCount;
+    unsigned long ulTxLevel;
+    unsigned long ulIntMask;
+    unsigned long ulIntRaw;
+    tBoolean bDMAEnabled;
+
+    const unsigned char *pucDMASrc;
+    unsigned long ulDMACount;
+    tBoolean bDMAChannelEnabled;
+    tBoolean bDMADone;
+
+    tBoolean bNVICEnabled;
+    tBoolean bMasterDisabled;
+    tBoolean bInHandler;
+
+    tBoolean bStalled;
+    char pcWire[WIRE_SIZE];
+    unsigned long ulWireLen;
+
+    unsigned long ulInterrupts;
+    unsigned long ulTransfers;
+    unsigned long ulWaitSteps;
+    unsigned long ulRandom;
+} g_sSim;
+
+static unsigned long
+SimRandom(void)
+{
+    g_sSim.ulRandom = g_sSim.ulRandom * 1103515245 + 12345;
+    return (g_sSim.ulRandom >> 16) & 0x7fff;
+}
+
+/* Deliver the UART interrupt if it is pending and not masked. */
+static void
+SimInterrupt(void)
+{
+    if (g_sSim.bInHandler || g_sSim.bMasterDisabled || !g_sSim.bNVICEnabled)
+    {
+        return;
+    }
+    if ((g_sSim.ulIntRaw & g_sSim.ulIntMask) || g_sSim.bDMADone)
+    {
+        g_sSim.bDMADone = false;
+        g_sSim.bInHandler = true;
+        g_sSim.ulInterrupts++;
+        UARTStdioIntHandler();
+        g_sSim.bInHandler = false;
+    }
+}
+
+static void
+SimFifoPut(unsigned char ucChar)
+{
+    g_sSim.pucFifo[(g_sSim.ulFifoHead + g_sSim.ulFifoCount) % FIFO_SIZE] = ucChar;
+    g_sSim.ulFifoCount++;
+}
+
+/* Shift a character onto the wire, service the uDMA channel and deliver any pending interrupt. */
+static void
+SimStep(void)
+{
+    unsigned long ulIdx;
+
+    if (!g_sSim.bStalled && g_sSim.ulFifoCount)
+    {
+        if (g_sSim.ulWireLen == WIRE_SIZE)
+        {
+            SimFail("wire overflow");
+        }
+        g_sSim.pcWire[g_sSim.ulWireLen++] = g_sSim.pucFifo[g_sSim.ulFifoHead];
+        g_sSim.ulFifoHead = (g_sSim.ulFifoHead + 1) % FIFO_SIZE;
+        g_sSim.ulFifoCount--;
+
+        /* The transmit interrupt is raised as the FIFO level drops through the trigger level. */
+        if (g_sSim.ulFifoCount == g_sSim.ulTxLevel)
+        {
+            g_sSim.ulIntRaw |= UART_INT_TX;
+        }
+    }
+
+    /* The UART requests a burst of four characters whenever its FIFO is no more than half full. */
+    if (g_sSim.bDMAEnabled && g_sSim.bDMAChannelEnabled && (g_sSim.ulFifoCount <= FIFO_SIZE / 2))
+    {
+        for (ulIdx = 0; (ulIdx < 4) && g_sSim.ulDMACount; ulIdx++)
+        {
+            SimFifoPut(*g_sSim.pucDMASrc++);
+            g_sSim.ulDMACount--;
+        }
+        if (!g_sSim.ulDMACount)
+        {
+            g_sSim.bDMAChannelEnabled = false;
+            g_sSim.bDMADone = true;
+        }
+    }
+
+    SimInterrupt();
+}
+
+/* Called on every driver library call, to let the simulation progress at arbitrary points of the module's code. */
+static void
+SimPoll(void)
+{
+    if (!g_sSim.bInHandler && ((SimRandom() % 4) == 0))
+    {
+        SimStep();
+    }
+}
+
+/* Run the simulation until everything queued has been shifted onto the wire. */
+static void
+SimDrain(void)
+{
+    unsigned long ulIdle;
+
+    for (ulIdle = 0; ulIdle < 64; )
+    {
+        unsigned long ulWireLen = g_sSim.ulWireLen;
+
+        SimStep();
+        ulIdle = (g_sSim.ulWireLen == ulWireLen) ? ulIdle + 1 : 0;
+    }
+}
+
+tBoolean
+SysCtlPeripheralPresent(unsigned long ulPeripheral)
+{
+    return ulPeripheral == SYSCTL_PERIPH_UART0;
+}
+
+void
+SysCtlPeripheralEnable(unsigned long ulPeripheral)
+{
+}
+
+unsigned long
+SysCtlClockGet(void)
+{
+    return 50000000;
+}
+
+void
+UARTConfigSetExpClk(unsigned long ulBase, unsigned long ulUARTClk, unsigned long ulBaud, unsigned long ulConfig)
+{
+}
+
+void
+UARTFIFOLevelSet(unsigned long ulBase, unsigned long ulTxLevel, unsigned long ulRxLevel)
+{
+    static const unsigned long pulLevels[] = { 2, 4, 8, 12, 14 };
+
+    g_sSim.ulTxLevel = pulLevels[ulTxLevel];
+}
+
+void
+UARTEnable(unsigned long ulBase)
+{
+}
+
+void
+UARTIntEnable(unsigned long ulBase, unsigned long ulIntFlags)
+{
+    SimPoll();
+    g_sSim.ulIntMask |= ulIntFlags;
+    SimInterrupt();
+}
+
+void
+UARTIntDisable(unsigned long ulBase, unsigned long ulIntFlags)
+{
+    SimPoll();
+    g_sSim.ulIntMask &= ~ulIntFlags;
+}
+
+unsigned long
+UARTIntStatus(unsigned long ulBase, tBoolean bMasked)
+{
+    return bMasked ? (g_sSim.ulIntRaw & g_sSim.ulIntMask) : g_sSim.ulIntRaw;
+}
+
+void
+UARTIntClear(unsigned long ulBase, unsigned long ulIntFlags)
+{
+    g_sSim.ulIntRaw &= ~ulIntFlags;
+}
+
+tBoolean
+UARTSpaceAvail(unsigned long ulBase)
+{
+    SimPoll();
+    return g_sSim.ulFifoCount < FIFO_SIZE;
+}
+
+tBoolean
+UARTCharPutNonBlocking(unsigned long ulBase, unsigned char ucData)
+{
+    SimPoll();
+    if (g_sSim.ulFifoCount == FIFO_SIZE)
+    {
+        return false;
+    }
+    SimFifoPut(ucData);
+    return true;
+}
+
+void
+UARTCharPut(unsigned long ulBase, unsigned char ucData)
+{
+    while (g_sSim.ulFifoCount == FIFO_SIZE)
+    {
+        if (g_sSim.bStalled)
+        {
+            SimFail("blocking write on a stalled UART");
+        }
+        g_sSim.ulWaitSteps++;
+        SimStep();
+    }
+    SimFifoPut(ucData);
+}
+
+tBoolean
+UARTCharsAvail(unsigned long ulBase)
+{
+    return false;
+}
+
+long
+UARTCharGetNonBlocking(unsigned long ulBase)
+{
+    return -1;
+}
+
+long
+UARTCharGet(unsigned long ulBase)
+{
+    SimFail("unexpected read");
+    return -1;
+}
+
+void
+UARTDMAEnable(unsigned long ulBase, unsigned long ulDMAFlags)
+{
+    g_sSim.bDMAEnabled = (ulDMAFlags & UART_DMA_TX) != 0;
+}
+
+void
+IntEnable(unsigned long ulInterrupt)
+{
+    if (ulInterrupt != INT_UART0)
+    {
+        SimFail("unexpected interrupt enabled");
+    }
+    g_sSim.bNVICEnabled = true;
+    SimInterrupt();
+}
+
+void
+IntDisable(unsigned long ulInterrupt)
+{
+    SimPoll();
+    g_sSim.bNVICEnabled = false;
+}
+
+tBoolean
+IntMasterEnable(void)
+{
+    tBoolean bWasDisabled = g_sSim.bMasterDisabled;
+
+    g_sSim.bMasterDisabled = false;
+    SimInterrupt();
+    return bWasDisabled;
+}
+
+tBoolean
+IntMasterDisable(void)
+{
+    tBoolean bWasDisabled = g_sSim.bMasterDisabled;
+
+    SimPoll();
+    g_sSim.bMasterDisabled = true;
+    return bWasDisabled;
+}
+
+void
+uDMAChannelSelectSecondary(unsigned long ulSecPeriphs)
+{
+}
+
+void
+uDMAChannelAttributeDisable(unsigned long ulChannelNum, unsigned long ulAttr)
+{
+}
+
+void
+uDMAChannelControlSet(unsigned long ulChannelStructIndex, unsigned long ulControl)
+{
+    if (ulChannelStructIndex != UDMA_CHANNEL_UART0TX ||
+        ulControl != (UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_4))
+    {
+        SimFail("unexpected uDMA channel control");
+    }
+}
+
+void
+uDMAChannelTransferSet(unsigned long ulChannelStructIndex, unsigned long ulMode, void *pvSrcAddr, void *pvDstAddr,
+                       unsigned long ulTransferSize)
+{
+    if (ulChannelStructIndex != UDMA_CHANNEL_UART0TX || ulMode != UDMA_MODE_BASIC ||
+        pvDstAddr != (void *)(UART0_BASE + UART_O_DR) || ulTransferSize < 1 || ulTransferSize > 1024)
+    {
+        SimFail("unexpected uDMA transfer");
+    }
+    if (g_sSim.bDMAChannelEnabled)
+    {
+        SimFail("uDMA transfer set while the channel is enabled");
+    }
+    g_sSim.pucDMASrc = pvSrcAddr;
+    g_sSim.ulDMACount = ulTransferSize;
+}
+
+void
+uDMAChannelEnable(unsigned long ulChannelNum)
+{
+    g_sSim.bDMAChannelEnabled = true;
+    g_sSim.ulTransfers++;
+}
+
+void
+uDMAChannelDisable(unsigned long ulChannelNum)
+{
+    g_sSim.bDMAChannelEnabled = false;
+}
+
+tBoolean
+uDMAChannelIsEnabled(unsigned long ulChannelNum)
+{
+    SimPoll();
+    return g_sSim.bDMAChannelEnabled;
+}
+
+/* Append the output expected on the wire for a string, in which each LF is preceded by a CR. */
+static void
+ExpectString(char *pcExpected, unsigned long *pulLen, const char *pcString, unsigned long ulCount)
+{
+    unsigned long ulIdx;
+
+    for (ulIdx = 0; ulIdx < ulCount; ulIdx++)
+    {
+        if (pcString[ulIdx] == '\n')
+        {
+            pcExpected[(*pulLen)++] = '\r';
+        }
+        pcExpected[(*pulLen)++] = pcString[ulIdx];
+    }
+}
+
+static void
+RandomText(char *pcText, unsigned long ulLen)
+{
+    unsigned long ulIdx;
+
+    for (ulIdx = 0; ulIdx < ulLen; ulIdx++)
+    {
+        pcText[ulIdx] = (SimRandom() % 8) ? 'a' + (SimRandom() % 26) : '\n';
+    }
+    pcText[ulLen] = '\0';
+}
+
+/* Print a random line through UARTprintf() and the equivalent line through snprintf(). */
+static int
+PrintLine(char *pcReference, size_t ulSize)
+{
+    long lA = (long)(SimRandom() * SimRandom()) - 100000000;
+    long lB = (long)(SimRandom() % 2000) - 1000;
+    unsigned long ulC = SimRandom() * SimRandom() * 4;
+    char pcText[200];
+
+    switch (SimRandom() % 6)
+    {
+    case 0:
+        snprintf(pcReference, ulSize, "task %lu: state %ld, pos %5ld\n", ulC, lA, lB);
+        return UARTprintf("task %u: state %d, pos %5i\n", ulC, lA, lB);
+    case 1:
+        snprintf(pcReference, ulSize, "%08lx %lx %lx %lx\n", ulC, ulC >> 12, (unsigned long)lB & 0xffff, ulC);
+        return UARTprintf("%08x %x %X %p\n", ulC, ulC >> 12, (unsigned long)lB & 0xffff, ulC);
+    case 2:
+        RandomText(pcText, SimRandom() % 12);
+        snprintf(pcReference, ulSize, "[%-10s] [%s]\n", pcText, pcText);
+        return UARTprintf("[%10s] [%s]\n", pcText, pcText);
+    case 3:
+        snprintf(pcReference, ulSize, "%c%c%c 100%%\n", 'a' + (int)(ulC % 26), '0' + (int)(ulC % 10), '\n');
+        return UARTprintf("%c%c%c 100%%\n", 'a' + (ulC % 26), '0' + (ulC % 10), (unsigned long)'\n');
+    case 4:
+        RandomText(pcText, SimRandom() % 199);
+        snprintf(pcReference, ulSize, "%s", pcText);
+        return UARTprintf("%s", pcText);
+    default:
+        snprintf(pcReference, ulSize, "%05ld %03lu %3ld\n", lB, ulC % 1000, lB % 10);
+        return UARTprintf("%05d %03u %3d\n", lB, ulC % 1000, lB % 10);
+    }
+}
+
+static void
+CheckWire(const char *pcExpected, unsigned long ulLen)
+{
+    if ((g_sSim.ulWireLen != ulLen) || memcmp(g_sSim.pcWire, pcExpected, ulLen))
+    {
+        SimFail("wire output does not match the expected output");
+    }
+}
+
+/* Print random lines, leaving enough time between them for the output to never be discarded. */
+static void
+TestOutput(const char *pcMode, char *pcExpected)
+{
+    char pcReference[512];
+    unsigned long ulLen = 0, ulLine;
+    int iCount;
+
+    g_sSim.ulWireLen = 0;
+    g_sSim.ulInterrupts = 0;
+    g_sSim.ulTransfers = 0;
+    g_sSim.ulWaitSteps = 0;
+
+    for (ulLine = 0; ulLine < NUM_LINES; ulLine++)
+    {
+#ifdef UART_BUFFERED
+        while (UARTTxBytesFree() < (int)sizeof(pcReference))
+        {
+            SimStep();
+        }
+#endif
+        iCount = PrintLine(pcReference, sizeof(pcReference));
+        if (iCount != (int)strlen(pcReference))
+        {
+            SimFail("UARTprintf() did not report the whole line as written");
+        }
+        ExpectString(pcExpected, &ulLen, pcReference, strlen(pcReference));
+
+        /* Let the line be partially transmitted before the next one is printed. */
+        for (iCount = SimRandom() % 64; iCount; iCount--)
+        {
+            SimStep();
+        }
+    }
+    SimDrain();
+    CheckWire(pcExpected, ulLen);
+
+    printf("%s: %lu lines, %lu bytes, %lu interrupts, %lu uDMA transfers, %lu busy-wait steps\n", pcMode, ulLine,
+           ulLen, g_sSim.ulInterrupts, g_sSim.ulTransfers, g_sSim.ulWaitSteps);
+}
+
+/* Print random lines while the wire is stalled, and check that output is queued rather than waited for. */
+static void
+TestNonBlocking(const char *pcMode, char *pcExpected)
+{
+    char pcReference[512];
+    unsigned long ulLen = 0, ulLine, ulQueued = 0;
+    int iCount;
+
+    g_sSim.ulWireLen = 0;
+
+    for (ulLine = 0; ulLine < NUM_LINES / 10; ulLine++)
+    {
+        g_sSim.bStalled = true;
+        iCount = PrintLine(pcReference, sizeof(pcReference));
+        if ((iCount < 0) || (iCount > (int)strlen(pcReference)))
+        {
+            SimFail("UARTprintf() reported an invalid number of characters written");
+        }
+        ulQueued += iCount;
+
+#ifndef UART_BUFFERED
+        /* Retry the remainder of the line (one write at a time, as the FIFO drains). */
+        while (iCount != (int)strlen(pcReference))
+        {
+            SimStep();
+            g_sSim.bStalled = false;
+            SimStep();
+            g_sSim.bStalled = true;
+            iCount += UARTwrite(pcReference + iCount, strlen(pcReference) - iCount);
+        }
+#endif
+
+        /* Only the characters reported as written are transmitted. */
+        ExpectString(pcExpected, &ulLen, pcReference, iCount);
+
+        if ((SimRandom() % 8) == 0)
+        {
+            g_sSim.bStalled = false;
+            SimDrain();
+        }
+    }
+    g_sSim.bStalled = false;
+    SimDrain();
+    CheckWire(pcExpected, ulLen);
+
+    printf("%s (non-blocking): %lu lines, %lu bytes queued while stalled\n", pcMode, ulLine, ulQueued);
+}
+
+int
+main(void)
+{
+    static char pcExpected[WIRE_SIZE];
+    const char *pcMode;
+
+#if defined(UART_TX_DMA)
+    pcMode = "buffered with uDMA";
+#elif defined(UART_BUFFERED)
+    pcMode = "buffered";
+#else
+    pcMode = "unbuffered";
+#endif
+
+    g_sSim.ulRandom = 1;
+    UARTStdioConfig(0, 115200, SysCtlClockGet());
+
+    TestOutput(pcMode, pcExpected);
+
+#ifndef UART_BUFFERED
+    UARTTxNonBlockingSet(true);
+#endif
+    TestNonBlocking(pcMode, pcExpected);
+
+    return 0;
+}
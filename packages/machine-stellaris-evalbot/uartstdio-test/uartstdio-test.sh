@@ -0,0 +1,56 @@
+#!/bin/sh
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+
+# Build and run the host test of the UART console module against a simulated UART, once for each of the unbuffered,
+# buffered and buffered with uDMA transmission modes of the module.
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+STELLARISWARE="${HERE}/../stellarisware-min"
+OUT="${OUT:-${HERE}/../../../out/uartstdio-test}"
+CC="${CC:-gcc}"
+CFLAGS="${CFLAGS:--O2 -Wall}"
+
+mkdir -p "${OUT}"
+
+for MODE in unbuffered buffered dma; do
+    case "${MODE}" in
+        unbuffered) DEFINES="" ;;
+        buffered) DEFINES="-DUART_BUFFERED" ;;
+        dma) DEFINES="-DUART_BUFFERED -DUART_TX_DMA" ;;
+    esac
+
+    "${CC}" ${CFLAGS} ${DEFINES} -I"${STELLARISWARE}" -c "${STELLARISWARE}/utils/uartstdio.c" \
+        -o "${OUT}/uartstdio-${MODE}.o"
+    "${CC}" ${CFLAGS} ${DEFINES} -I"${STELLARISWARE}" -c "${HERE}/uartstdio-test.c" -o "${OUT}/uartstdio-test-${MODE}.o"
+    "${CC}" -o "${OUT}/uartstdio-test-${MODE}" "${OUT}/uartstdio-test-${MODE}.o" "${OUT}/uartstdio-${MODE}.o"
+
+    "${OUT}/uartstdio-test-${MODE}"
+done
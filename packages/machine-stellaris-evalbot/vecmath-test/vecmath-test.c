@@ -0,0 +1,429 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+/*
+ * Host test of the batch sine and integer square root functions of StellarisWare (utils/sine.c and utils/isqrt.c) and
+ * of the fixed point vector math module (utils/vecmath.c).
+ *
+ * sine_n() and isqrt_n() are checked for bit-exactness against sine() and isqrt(), over a dense sweep of all angles and
+ * over all values around the squares and powers of two, plus random values.  The vector functions are checked against
+ * the straightforward definitions below, including at the saturation limits, with all vector lengths up to a few
+ * dozen samples and with arrays that are not aligned to a word.  vecmath-test.sh runs the test against the portable C
+ * code of the vector math module and against its SIMD code on C models of the Cortex-M4 instructions.
+ *
+ * The test then measures the throughput of each batch function, and for sine_n() and isqrt_n() also of a loop over the
+ * scalar function.  Host throughput only indicates the overheads that the batch functions avoid; the gain of the SIMD
+ * instructions is only visible on a Cortex-M4, and their C models on the host are slower than the portable code.
+ *
+ * StellarisWare assumes that long is 32 bits wide, so the sine and integer square root modules are built with long
+ * defined as int (see vecmath-test.sh).  The same definition is applied below, after the system headers have been
+ * included.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define long int
+
+#include "utils/sine.h"
+#include "utils/isqrt.h"
+#include "utils/vecmath.h"
+
+#define BLOCK 4096
+#define MAX_LENGTH 67
+#define MAX_TAPS 33
+#define BENCH_SAMPLES (16UL * 1024 * 1024)
+
+static uint32_t g_ui32Random = 1;
+static const char *g_pcMode;
+static volatile int64_t g_i64Sink;
+
+static void
+Fail(const char *pcMessage, uint32_t ui32Detail)
+{
+    fprintf(stderr, "FAIL (%s): %s (%08x)\n", g_pcMode, pcMessage, ui32Detail);
+    exit(1);
+}
+
+static uint32_t
+Random(void)
+{
+    /* xorshift32 */
+    g_ui32Random ^= g_ui32Random << 13;
+    g_ui32Random ^= g_ui32Random >> 17;
+    g_ui32Random ^= g_ui32Random << 5;
+    return g_ui32Random;
+}
+
+/* A random sample, with a bias towards the saturation limits. */
+static int16_t
+RandomSample(void)
+{
+    switch (Random() % 8)
+    {
+    case 0:
+        return -32768;
+    case 1:
+        return 32767;
+    default:
+        return (int16_t)Random();
+    }
+}
+
+static int16_t
+Saturate(int64_t i64Value)
+{
+    return (int16_t)((i64Value > 32767) ? 32767 : ((i64Value < -32768) ? -32768 : i64Value));
+}
+
+static int64_t
+RefDot(const int16_t *pi16A, const int16_t *pi16B, uint32_t ui32Count)
+{
+    int64_t i64Sum = 0;
+    uint32_t ui32Idx;
+
+    for (ui32Idx = 0; ui32Idx < ui32Count; ui32Idx++)
+    {
+        i64Sum += (int64_t)pi16A[ui32Idx] * pi16B[ui32Idx];
+    }
+    return i64Sum;
+}
+
+static int16_t
+RefFir(const int16_t *pi16Coeff, uint32_t ui32Taps, const int16_t *pi16In)
+{
+    int64_t i64Sum = RefDot(pi16Coeff, pi16In, ui32Taps);
+
+    /* Round half up, i.e., add one half and floor. */
+    return Saturate((i64Sum + 0x4000 - (((i64Sum + 0x4000) % 32768 + 32768) % 32768)) / 32768);
+}
+
+static int16_t
+RefScale(int16_t i16In, int16_t i16Scale, uint32_t ui32Shift)
+{
+    int64_t i64Product = (int64_t)i16In * i16Scale * (1 << ui32Shift);
+
+    /* Floor division by 2^15. */
+    return Saturate((i64Product - ((i64Product % 32768 + 32768) % 32768)) / 32768);
+}
+
+static void
+TestSine(void)
+{
+    static unsigned long pulAngle[BLOCK];
+    static long plSine[BLOCK];
+    uint64_t ui64Angle;
+    uint32_t ui32Idx, ui32Fill = 0;
+
+    /* Sweep all angles in steps that visit every table entry and rounding boundary, then random angles. */
+    for (ui64Angle = 0; ui64Angle < (1ULL << 32) + 2 * BLOCK * 4099ULL; ui64Angle += 4099)
+    {
+        pulAngle[ui32Fill++] = (ui64Angle < (1ULL << 32)) ? (unsigned long)ui64Angle : (unsigned long)Random();
+        if (ui32Fill == BLOCK)
+        {
+            sine_n(pulAngle, plSine, BLOCK);
+            for (ui32Idx = 0; ui32Idx < BLOCK; ui32Idx++)
+            {
+                if (plSine[ui32Idx] != sine(pulAngle[ui32Idx]))
+                {
+                    Fail("sine_n differs from sine", pulAngle[ui32Idx]);
+                }
+            }
+            ui32Fill = 0;
+        }
+    }
+
+    /* In place, with a count that is not a multiple of anything. */
+    for (ui32Idx = 0; ui32Idx < 1001; ui32Idx++)
+    {
+        pulAngle[ui32Idx] = Random();
+        plSine[ui32Idx] = sine(pulAngle[ui32Idx]);
+    }
+    sine_n(pulAngle, (long *)pulAngle, 1001);
+    if (memcmp(pulAngle, plSine, 1001 * sizeof(long)))
+    {
+        Fail("sine_n in place differs from sine", 0);
+    }
+}
+
+static void
+TestIsqrt(void)
+{
+    static unsigned long pulValue[BLOCK], pulRoot[BLOCK];
+    uint64_t ui64Base;
+    uint32_t ui32Idx, ui32Fill = 0, ui32Round;
+
+    /* Values around each square and power of two (which covers all leading zero counts), then random values. */
+    for (ui32Round = 0; ui32Round < 65536 + 32 + 4 * BLOCK; ui32Round++)
+    {
+        if (ui32Round < 65536)
+        {
+            ui64Base = (uint64_t)ui32Round * ui32Round;
+        }
+        else if (ui32Round < 65536 + 32)
+        {
+            ui64Base = 1ULL << (ui32Round - 65536);
+        }
+        else
+        {
+            ui64Base = Random();
+        }
+        for (ui32Idx = 0; ui32Idx < 3; ui32Idx++)
+        {
+            pulValue[ui32Fill++] = (unsigned long)(uint32_t)(ui64Base + ui32Idx - 1);
+            if (ui32Fill == BLOCK)
+            {
+                isqrt_n(pulValue, pulRoot, BLOCK);
+                for (ui32Fill = 0; ui32Fill < BLOCK; ui32Fill++)
+                {
+                    if (pulRoot[ui32Fill] != isqrt(pulValue[ui32Fill]))
+                    {
+                        Fail("isqrt_n differs from isqrt", pulValue[ui32Fill]);
+                    }
+                }
+                ui32Fill = 0;
+            }
+        }
+    }
+
+    /* In place. */
+    for (ui32Idx = 0; ui32Idx < 1001; ui32Idx++)
+    {
+        pulValue[ui32Idx] = Random() >> (ui32Idx % 32);
+        pulRoot[ui32Idx] = isqrt(pulValue[ui32Idx]);
+    }
+    isqrt_n(pulValue, pulValue, 1001);
+    if (memcmp(pulValue, pulRoot, 1001 * sizeof(long)))
+    {
+        Fail("isqrt_n in place differs from isqrt", 0);
+    }
+}
+
+static void
+TestVectors(void)
+{
+    /* One spare sample in front of each array, so that the vectors can start at an odd halfword. */
+    static int16_t pi16A[MAX_LENGTH + MAX_TAPS + 1], pi16B[MAX_LENGTH + MAX_TAPS + 1];
+    static int16_t pi16Out[MAX_LENGTH + 1], pi16Ref[MAX_LENGTH];
+    uint32_t ui32Length, ui32Taps, ui32Idx, ui32Round, ui32Shift;
+    int16_t *pi16VecA, *pi16VecB, *pi16VecOut, i16Scale;
+
+    for (ui32Round = 0; ui32Round < 2000; ui32Round++)
+    {
+        for (ui32Idx = 0; ui32Idx < MAX_LENGTH + MAX_TAPS + 1; ui32Idx++)
+        {
+            pi16A[ui32Idx] = RandomSample();
+            pi16B[ui32Idx] = RandomSample();
+        }
+        pi16VecA = pi16A + (ui32Round & 1);
+        pi16VecB = pi16B + ((ui32Round >> 1) & 1);
+        pi16VecOut = pi16Out + ((ui32Round >> 2) & 1);
+
+        for (ui32Length = 0; ui32Length <= MAX_LENGTH; ui32Length++)
+        {
+            if (vec_dot_q15(pi16VecA, pi16VecB, ui32Length) != RefDot(pi16VecA, pi16VecB, ui32Length))
+            {
+                Fail("vec_dot_q15 differs from the definition", ui32Length);
+            }
+
+            for (ui32Idx = 0; ui32Idx < ui32Length; ui32Idx++)
+            {
+                pi16Ref[ui32Idx] = Saturate((int32_t)pi16VecA[ui32Idx] + pi16VecB[ui32Idx]);
+            }
+            vec_add_q15(pi16VecA, pi16VecB, pi16VecOut, ui32Length);
+            if (memcmp(pi16VecOut, pi16Ref, ui32Length * sizeof(int16_t)))
+            {
+                Fail("vec_add_q15 differs from the definition", ui32Length);
+            }
+
+            ui32Shift = Random() % 16;
+            i16Scale = RandomSample();
+            for (ui32Idx = 0; ui32Idx < ui32Length; ui32Idx++)
+            {
+                pi16Ref[ui32Idx] = RefScale(pi16VecA[ui32Idx], i16Scale, ui32Shift);
+            }
+            vec_scale_q15(pi16VecA, i16Scale, ui32Shift, pi16VecOut, ui32Length);
+            if (memcmp(pi16VecOut, pi16Ref, ui32Length * sizeof(int16_t)))
+            {
+                Fail("vec_scale_q15 differs from the definition", (ui32Shift << 16) | (uint16_t)i16Scale);
+            }
+        }
+
+        ui32Taps = 1 + Random() % MAX_TAPS;
+        ui32Length = Random() % (MAX_LENGTH + 1);
+        for (ui32Idx = 0; ui32Idx < ui32Length; ui32Idx++)
+        {
+            pi16Ref[ui32Idx] = RefFir(pi16VecB, ui32Taps, pi16VecA + ui32Idx);
+        }
+        vec_fir_q15(pi16VecB, ui32Taps, pi16VecA, pi16VecOut, ui32Length);
+        if (memcmp(pi16VecOut, pi16Ref, ui32Length * sizeof(int16_t)))
+        {
+            Fail("vec_fir_q15 differs from the definition", (ui32Taps << 16) | ui32Length);
+        }
+    }
+
+    /* In place. */
+    memcpy(pi16Out, pi16A, MAX_LENGTH * sizeof(int16_t));
+    vec_add_q15(pi16Out, pi16B, pi16Out, MAX_LENGTH);
+    vec_scale_q15(pi16Out, 12345, 3, pi16Out, MAX_LENGTH);
+    for (ui32Idx = 0; ui32Idx < MAX_LENGTH; ui32Idx++)
+    {
+        if (pi16Out[ui32Idx] != RefScale(Saturate((int32_t)pi16A[ui32Idx] + pi16B[ui32Idx]), 12345, 3))
+        {
+            Fail("in place vector operations differ from the definitions", ui32Idx);
+        }
+    }
+}
+
+static double
+Seconds(const struct timespec *psStart)
+{
+    struct timespec sEnd;
+
+    clock_gettime(CLOCK_MONOTONIC, &sEnd);
+    return (double)(sEnd.tv_sec - psStart->tv_sec) + (double)(sEnd.tv_nsec - psStart->tv_nsec) * 1e-9;
+}
+
+static void
+Report(const char *pcName, double dScalar, double dBatch)
+{
+    printf("vecmath-test (%s): %-13s %8.1f Msamples/s", g_pcMode, pcName, BENCH_SAMPLES / dBatch * 1e-6);
+    if (dScalar > 0)
+    {
+        printf(" (%8.1f Msamples/s for the scalar function, %.2fx)", BENCH_SAMPLES / dScalar * 1e-6, dScalar / dBatch);
+    }
+    printf("\n");
+}
+
+static void
+Bench(void)
+{
+    static unsigned long pulIn[BLOCK], pulOut[BLOCK];
+    static int16_t pi16A[BLOCK + 16], pi16B[BLOCK], pi16Out[BLOCK];
+    struct timespec sStart;
+    double dScalar;
+    uint32_t ui32Block, ui32Idx;
+    int64_t i64Sum = 0;
+
+    for (ui32Idx = 0; ui32Idx < BLOCK; ui32Idx++)
+    {
+        pulIn[ui32Idx] = Random();
+        pi16A[ui32Idx] = (int16_t)Random();
+        pi16B[ui32Idx] = (int16_t)Random();
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &sStart);
+    for (ui32Block = 0; ui32Block < BENCH_SAMPLES / BLOCK; ui32Block++)
+    {
+        for (ui32Idx = 0; ui32Idx < BLOCK; ui32Idx++)
+        {
+            pulOut[ui32Idx] = sine(pulIn[ui32Idx]);
+        }
+        i64Sum += pulOut[ui32Block % BLOCK];
+    }
+    dScalar = Seconds(&sStart);
+    clock_gettime(CLOCK_MONOTONIC, &sStart);
+    for (ui32Block = 0; ui32Block < BENCH_SAMPLES / BLOCK; ui32Block++)
+    {
+        sine_n(pulIn, (long *)pulOut, BLOCK);
+        i64Sum += pulOut[ui32Block % BLOCK];
+    }
+    Report("sine_n", dScalar, Seconds(&sStart));
+
+    clock_gettime(CLOCK_MONOTONIC, &sStart);
+    for (ui32Block = 0; ui32Block < BENCH_SAMPLES / BLOCK; ui32Block++)
+    {
+        for (ui32Idx = 0; ui32Idx < BLOCK; ui32Idx++)
+        {
+            pulOut[ui32Idx] = isqrt(pulIn[ui32Idx] >> (ui32Idx % 32));
+        }
+        i64Sum += pulOut[ui32Block % BLOCK];
+    }
+    dScalar = Seconds(&sStart);
+    for (ui32Idx = 0; ui32Idx < BLOCK; ui32Idx++)
+    {
+        pulIn[ui32Idx] >>= ui32Idx % 32;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &sStart);
+    for (ui32Block = 0; ui32Block < BENCH_SAMPLES / BLOCK; ui32Block++)
+    {
+        isqrt_n(pulIn, pulOut, BLOCK);
+        i64Sum += pulOut[ui32Block % BLOCK];
+    }
+    Report("isqrt_n", dScalar, Seconds(&sStart));
+
+    clock_gettime(CLOCK_MONOTONIC, &sStart);
+    for (ui32Block = 0; ui32Block < BENCH_SAMPLES / BLOCK; ui32Block++)
+    {
+        i64Sum += vec_dot_q15(pi16A, pi16B, BLOCK);
+    }
+    Report("vec_dot_q15", 0, Seconds(&sStart));
+
+    /* A 16-tap filter, so each output sample counts as 16 samples. */
+    clock_gettime(CLOCK_MONOTONIC, &sStart);
+    for (ui32Block = 0; ui32Block < BENCH_SAMPLES / BLOCK / 16; ui32Block++)
+    {
+        vec_fir_q15(pi16B, 16, pi16A, pi16Out, BLOCK);
+        i64Sum += pi16Out[ui32Block % BLOCK];
+    }
+    Report("vec_fir_q15", 0, Seconds(&sStart));
+
+    clock_gettime(CLOCK_MONOTONIC, &sStart);
+    for (ui32Block = 0; ui32Block < BENCH_SAMPLES / BLOCK; ui32Block++)
+    {
+        vec_scale_q15(pi16A, 23456, 2, pi16Out, BLOCK);
+        i64Sum += pi16Out[ui32Block % BLOCK];
+    }
+    Report("vec_scale_q15", 0, Seconds(&sStart));
+
+    clock_gettime(CLOCK_MONOTONIC, &sStart);
+    for (ui32Block = 0; ui32Block < BENCH_SAMPLES / BLOCK; ui32Block++)
+    {
+        vec_add_q15(pi16A, pi16B, pi16Out, BLOCK);
+        i64Sum += pi16Out[ui32Block % BLOCK];
+    }
+    Report("vec_add_q15", 0, Seconds(&sStart));
+
+    g_i64Sink = i64Sum;
+}
+
+int
+main(int argc, char **argv)
+{
+    g_pcMode = (argc > 1) ? argv[1] : "default";
+
+    TestSine();
+    TestIsqrt();
+    TestVectors();
+    printf("vecmath-test (%s): sine_n, isqrt_n and vector operations are bit-exact\n", g_pcMode);
+
+    Bench();
+    return 0;
+}
@@ -0,0 +1,64 @@
+#!/bin/sh
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+# Build and run the host test of the batch sine and integer square root functions and of the fixed point vector math
+# module, once with the portable C code of the vector math module and once with its SIMD code on C models of the
+# Cortex-M4 instructions.  StellarisWare assumes that long is 32 bits wide, so the sine and integer square root modules
+# are built with long defined as int (by a forced include after a system header, as they include none themselves).
+# The vector math module uses fixed-width types and is built as is.
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+STELLARISWARE="${HERE}/../stellarisware-min"
+OUT="${OUT:-${HERE}/../../../out/vecmath-test}"
+CC="${CC:-gcc}"
+CFLAGS="${CFLAGS:--O2 -Wall}"
+
+mkdir -p "${OUT}"
+printf '#include <string.h>\n#define long int\n' > "${OUT}/long32.h"
+
+for SOURCE in sine.c isqrt.c; do
+    "${CC}" ${CFLAGS} -include "${OUT}/long32.h" -I"${STELLARISWARE}" -c "${STELLARISWARE}/utils/${SOURCE}" \
+        -o "${OUT}/$(basename "${SOURCE}" .c).o"
+done
+"${CC}" ${CFLAGS} -I"${STELLARISWARE}" -c "${HERE}/vecmath-test.c" -o "${OUT}/vecmath-test.o"
+
+for MODE in portable simd; do
+    case "${MODE}" in
+        portable) DEFINES="" ;;
+        simd) DEFINES="-DVECMATH_SIMD_EMULATION" ;;
+    esac
+
+    "${CC}" ${CFLAGS} ${DEFINES} -I"${STELLARISWARE}" -c "${STELLARISWARE}/utils/vecmath.c" \
+        -o "${OUT}/vecmath-${MODE}.o"
+    "${CC}" -o "${OUT}/vecmath-test-${MODE}" "${OUT}/vecmath-test.o" "${OUT}/sine.o" "${OUT}/isqrt.o" \
+        "${OUT}/vecmath-${MODE}.o"
+
+    "${OUT}/vecmath-test-${MODE}" "${MODE}"
+done
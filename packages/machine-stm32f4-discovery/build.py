@@ -25,7 +25,8 @@
 # @TAG(NICTA_AGPL)
 #
 
-from prj import execute, SystemBuildError
+from prj import execute, compile_cached, run_parallel, SystemBuildError
+import functools
 import os
 
 
@@ -42,17 +43,22 @@ def system_build(system):
     # Compile all C files.
     c_obj_files = [os.path.join(system.output, os.path.basename(c.replace('.c', '.o'))) for c in system.c_files]
 
-    for c, o in zip(system.c_files, c_obj_files):
+    def compile_c(c, o):
         os.makedirs(os.path.dirname(o), exist_ok=True)
-        execute(['arm-none-eabi-gcc', '-ffreestanding', '-c', c, '-o', o, '-Wall', '-Werror'] +
-                c_flags + inc_path_args)
+        compile_cached(['arm-none-eabi-gcc', '-ffreestanding', '-c', c, '-o', o, '-Wall', '-Werror'] +
+                       c_flags + inc_path_args, c, o, system.object_cache)
+
+    run_parallel(functools.partial(compile_c, c, o) for c, o in zip(system.c_files, c_obj_files))
 
     # Assemble all asm files.
     asm_obj_files = [os.path.join(system.output, os.path.basename(s.replace('.s', '.o'))) for s in system.asm_files]
-    for s, o in zip(system.asm_files, asm_obj_files):
+
+    def assemble(s, o):
         os.makedirs(os.path.dirname(o), exist_ok=True)
         execute(['arm-none-eabi-as', '-o', o, s] + a_flags + inc_path_args)
 
+    run_parallel(functools.partial(assemble, s, o) for s, o in zip(system.asm_files, asm_obj_files))
+
     # Perform final link
     obj_files = asm_obj_files + c_obj_files
     execute(['arm-none-eabi-ld', '-T', system.linker_script, '-o', system.output_file] + obj_files)
@@ -25,13 +25,21 @@
 # @TAG(NICTA_AGPL)
 #
 
-from prj import execute, SystemBuildError
+from prj import execute, compile_cached, run_parallel, wcet_report, SystemBuildError
+import functools
+import os
 
 
 schema = {
     'type': 'dict',
     'name': 'module',
-    'dict_type': ([{'type': 'string', 'name': 'output_type', 'default': 'executable'}], [])
+    'dict_type': ([{'type': 'string', 'name': 'output_type', 'default': 'executable'},
+                   {'type': 'bool', 'name': 'wcet_report', 'default': 'false'},
+                   {'type': 'int', 'name': 'wcet_retries', 'default': '2'},
+                   {'type': 'list', 'name': 'wcet_limits', 'default': [],
+                    'list_type': {'type': 'dict', 'name': 'limit',
+                                  'dict_type': ([{'type': 'string', 'name': 'entry_point'},
+                                                 {'type': 'int', 'name': 'instructions'}], [])}}], [])
 }
 
 
@@ -45,6 +53,41 @@ def system_build(system, configuration):
     if len(system.c_files) == 0:
         raise SystemBuildError("Zero C files in system definition")
 
-    shared_args = ['-shared', '-fPIC', '-std=c90'] if configuration['output_type'] == 'shared-library' else []
+    if configuration['output_type'] == 'shared-library':
+        c_flags = ['-fPIC', '-std=c90']
+        link_flags = ['-shared', '-fPIC']
+    else:
+        c_flags = []
+        link_flags = []
+    if configuration['wcet_report']:
+        # The report attributes loop bound annotations to instructions through the debug line information.
+        c_flags += ['-g']
 
-    execute(['gcc', '-o', system.output_file, '-Wall', '-Werror'] + shared_args + inc_path_args + system.c_files)
+    # Compile all C files.
+    c_obj_files = [os.path.join(system.output, os.path.basename(c.replace('.c', '.o'))) for c in system.c_files]
+
+    def compile_c(c, o):
+        compile_cached(['gcc', '-c', c, '-o', o, '-Wall', '-Werror'] + c_flags + inc_path_args,
+                       c, o, system.object_cache)
+
+    run_parallel(functools.partial(compile_c, c, o) for c, o in zip(system.c_files, c_obj_files))
+
+    # Perform final link
+    execute(['gcc', '-o', system.output_file] + link_flags + c_obj_files)
+
+    if configuration['wcet_report']:
+        print_wcet_report(system, configuration['wcet_limits'], configuration['wcet_retries'])
+
+
+def print_wcet_report(system, limits, retries):
+    disassembly_file = system.output_file + '.dis'
+    with open(disassembly_file, 'w') as f:
+        execute(['objdump', '-d', '-l', '--no-show-raw-insn', system.output_file], stdout=f)
+    limits = [(limit['entry_point'], limit['instructions']) for limit in limits]
+    report, exceeded = wcet_report(disassembly_file, 'x86_64', limits, retries)
+    with open(system.output_file + '.wcet', 'w') as f:
+        f.write(report)
+    print("Worst-case instruction counts of {}:".format(system.name))
+    print(report, end='')
+    if exceeded:
+        raise SystemBuildError("Entry points exceed their WCET limits: {}".format(', '.join(exceeded)))
@@ -0,0 +1,306 @@
+
+
+#include <stddef.h>
+#include "rtos-blocking-mutex-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+{{#mutexes.length}}
+#define MUTEX_ID_NONE ((MutexIdOption) UINT8_MAX)
+{{/mutexes.length}}
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+typedef {{prefix_type}}MutexId MutexIdOption;
+typedef {{prefix_type}}TaskId TaskIdOption;
+
+
+struct mutex {
+    TaskIdOption holder;
+};
+{{#mutex.stats}}
+struct mutex_stat {
+    uint32_t mutex_lock_counter;
+    uint32_t mutex_lock_contended_counter;
+    {{prefix_type}}TicksRelative mutex_lock_max_wait_time;
+};
+{{/mutex.stats}}
+
+
+
+
+
+{{#mutexes.length}}
+static bool mutex_try_lock({{prefix_type}}MutexId m);
+static bool mutex_acquire({{prefix_type}}MutexId m) {{prefix_const}}REENTRANT;
+static void mutex_release({{prefix_type}}MutexId m);
+{{/mutexes.length}}
+static void mutex_core_block_on({{prefix_type}}TaskId task) {{prefix_const}}REENTRANT;
+static void mutex_core_unblock({{prefix_type}}TaskId task);
+static {{prefix_type}}TaskId get_current_task(void);
+
+{{#mutexes.length}}
+static struct mutex mutexes[{{mutexes.length}}] = {
+{{#mutexes}}
+    {TASK_ID_NONE},
+{{/mutexes}}
+};
+static MutexIdOption mutex_waiters[{{tasks.length}}] = {
+{{#tasks}}
+    MUTEX_ID_NONE,
+{{/tasks}}
+};
+{{#mutex.stats}}
+bool {{prefix_func}}mutex_stats_enabled;
+static struct mutex_stat mutex_stats[{{mutexes.length}}];
+{{/mutex.stats}}
+{{/mutexes.length}}
+void (*block_on_ptr)({{prefix_type}}TaskId);
+void (*unblock_ptr)({{prefix_type}}TaskId);
+{{prefix_type}}TaskId (*get_current_task_ptr)(void);
+
+{{#mutexes.length}}
+#define assert_mutex_valid(mutex) api_assert(mutex < {{mutexes.length}}, ERROR_ID_INVALID_ID)
+{{/mutexes.length}}
+#define preempt_disable()
+#define preempt_enable()
+#define precondition_preemption_disabled()
+#define postcondition_preemption_disabled()
+#define api_assert(expression, error_id) do { } while(0)
+
+{{#mutexes.length}}
+static bool
+mutex_try_lock(const {{prefix_type}}MutexId m)
+{
+    const bool r = mutexes[m].holder == TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    if (r)
+    {
+        mutexes[m].holder = get_current_task();
+    }
+
+    postcondition_preemption_disabled();
+
+    return r;
+}
+
+/*
+ * Lock the mutex, blocking the current task while another task holds it.
+ * Returns whether the mutex was contended.
+ */
+static bool
+mutex_acquire(const {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT
+{
+    bool contended = false;
+
+    precondition_preemption_disabled();
+
+    while (!mutex_try_lock(m))
+    {
+        contended = true;
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on(mutexes[m].holder);
+    }
+
+    postcondition_preemption_disabled();
+
+    return contended;
+}
+
+static void
+mutex_release(const {{prefix_type}}MutexId m)
+{
+    {{prefix_type}}TaskId t;
+
+    precondition_preemption_disabled();
+
+
+    /* loop bound: {{tasks.length}} */
+    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+    {
+        if (mutex_waiters[t] == m)
+        {
+            mutex_waiters[t] = MUTEX_ID_NONE;
+            mutex_core_unblock(t);
+        }
+    }
+
+    mutexes[m].holder = TASK_ID_NONE;
+
+    postcondition_preemption_disabled();
+}
+{{#mutex.stats}}
+
+static void
+mutex_stats_update(const {{prefix_type}}MutexId m, const bool contended, const {{prefix_type}}TicksAbsolute
+        wait_start_ticks)
+{
+    if ({{prefix_func}}mutex_stats_enabled) {
+        mutex_stats[m].mutex_lock_counter += 1;
+        if (contended) {
+            {{prefix_type}}TicksRelative wait_time = {{prefix_func}}timer_current_ticks - wait_start_ticks;
+
+            mutex_stats[m].mutex_lock_contended_counter += 1;
+            if (wait_time > mutex_stats[m].mutex_lock_max_wait_time)
+            {
+                mutex_stats[m].mutex_lock_max_wait_time = wait_time;
+            }
+        }
+    }
+}
+{{/mutex.stats}}
+{{/mutexes.length}}
+static void
+mutex_core_block_on({{prefix_type}}TaskId task) {{prefix_const}}REENTRANT
+{
+    if (block_on_ptr != NULL)
+    {
+        block_on_ptr(task);
+    }
+}
+
+static void
+mutex_core_unblock({{prefix_type}}TaskId task)
+{
+    if (unblock_ptr != NULL)
+    {
+        unblock_ptr(task);
+    }
+}
+
+static {{prefix_type}}TaskId
+get_current_task(void)
+{
+    if (get_current_task_ptr != NULL)
+    {
+        return get_current_task_ptr();
+    }
+    return {{prefix_const}}TASK_ID_ZERO;
+}
+
+{{#mutexes.length}}
+void
+{{prefix_func}}mutex_lock(const {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT
+{
+{{#mutex.stats}}
+    bool contended;
+    const {{prefix_type}}TicksAbsolute wait_start_ticks = {{prefix_func}}timer_current_ticks;
+
+{{/mutex.stats}}
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder != get_current_task(), ERROR_ID_DEADLOCK);
+
+    preempt_disable();
+
+{{#mutex.stats}}
+    contended = mutex_acquire(m);
+{{/mutex.stats}}
+{{^mutex.stats}}
+    (void) mutex_acquire(m);
+{{/mutex.stats}}
+
+    preempt_enable();
+
+{{#mutex.stats}}
+    mutex_stats_update(m, contended, wait_start_ticks);
+{{/mutex.stats}}
+}
+
+
+void
+{{prefix_func}}mutex_unlock(const {{prefix_type}}MutexId m)
+{
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    mutex_release(m);
+
+    preempt_enable();
+}
+
+bool
+{{prefix_func}}mutex_try_lock(const {{prefix_type}}MutexId m)
+{
+    bool r;
+
+    assert_mutex_valid(m);
+
+    preempt_disable();
+
+    r = mutex_try_lock(m);
+
+    preempt_enable();
+
+    return r;
+}
+
+/* A macro implementation would be preferable to eliminate function call overhead when compilers don't support implicit
+ * inlining, but at present this would involve exposing too many implementation internals in the public API header. */
+bool
+{{prefix_func}}mutex_holder_is_current(const {{prefix_type}}MutexId m)
+{
+    assert_mutex_valid(m);
+    return mutexes[m].holder == get_current_task();
+}
+
+{{#mutex.stats}}
+void {{prefix_func}}mutex_stats_clear(void)
+{
+    /* memset would be preferable, but string.h is not available on all platforms */
+    uint8_t mutex_index;
+    /* loop bound: {{mutexes.length}} */
+    for (mutex_index = 0; mutex_index < {{mutexes.length}}; mutex_index += 1)
+    {
+        mutex_stats[mutex_index].mutex_lock_counter = 0;
+        mutex_stats[mutex_index].mutex_lock_contended_counter = 0;
+        mutex_stats[mutex_index].mutex_lock_max_wait_time = 0;
+    }
+}
+{{/mutex.stats}}
+{{/mutexes.length}}
+
+struct mutex * pub_mutexes = mutexes;
+
+void
+pub_set_block_on_ptr(void (*y)({{prefix_type}}TaskId))
+{
+    block_on_ptr = y;
+}
+
+void
+pub_set_unblock_ptr(void (*y)({{prefix_type}}TaskId))
+{
+    unblock_ptr = y;
+}
+
+void
+pub_set_get_current_task_ptr({{prefix_type}}TaskId (*y)(void))
+{
+    get_current_task_ptr = y;
+}
+
+void pub_mutex_init(void)
+{
+    {{prefix_type}}MutexId mutex_id;
+    {{prefix_type}}TaskId task_id;
+    /* For testing purposes we also reset all mutexes */
+    for (mutex_id = {{prefix_const}}MUTEX_ID_ZERO; mutex_id <= {{prefix_const}}MUTEX_ID_MAX; mutex_id++)
+    {
+        mutexes[mutex_id].holder = TASK_ID_NONE;
+    }
+    for (task_id = {{prefix_const}}TASK_ID_ZERO; task_id <= {{prefix_const}}TASK_ID_MAX; task_id++)
+    {
+        mutex_waiters[task_id] = MUTEX_ID_NONE;
+    }
+    block_on_ptr = NULL;
+    unblock_ptr = NULL;
+    get_current_task_ptr = NULL;
+}
@@ -0,0 +1,49 @@
+#ifndef RTOS_BLOCKING_MUTEX_TEST_H
+#define RTOS_BLOCKING_MUTEX_TEST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+
+typedef uint8_t {{prefix_type}}MutexId;
+typedef uint8_t {{prefix_type}}TaskId;
+
+
+
+#define {{prefix_const}}REENTRANT {{reentrant}}
+{{#mutexes.length}}
+#define {{prefix_const}}MUTEX_ID_ZERO (({{prefix_type}}MutexId) UINT8_C(0))
+#define {{prefix_const}}MUTEX_ID_MAX (({{prefix_type}}MutexId) UINT8_C({{mutexes.length}} - 1))
+{{#mutexes}}
+#define {{prefix_const}}MUTEX_ID_{{name|u}} (({{prefix_type}}MutexId) UINT8_C({{idx}}))
+{{/mutexes}}
+{{/mutexes.length}}
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+
+
+
+
+{{#mutex.stats}}
+extern bool {{prefix_func}}mutex_stats_enabled;
+{{/mutex.stats}}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+{{#mutexes.length}}
+void {{prefix_func}}mutex_lock({{prefix_type}}MutexId) {{prefix_const}}REENTRANT;
+bool {{prefix_func}}mutex_try_lock({{prefix_type}}MutexId);
+void {{prefix_func}}mutex_unlock({{prefix_type}}MutexId);
+bool {{prefix_func}}mutex_holder_is_current({{prefix_type}}MutexId);
+{{#mutex.stats}}
+void {{prefix_func}}mutex_stats_clear(void);
+{{/mutex.stats}}
+{{/mutexes.length}}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_BLOCKING_MUTEX_TEST_H */
\ No newline at end of file
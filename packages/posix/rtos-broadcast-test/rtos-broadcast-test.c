@@ -0,0 +1,390 @@
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rtos-broadcast-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+#define ERROR_ID_NONE (({{prefix_type}}ErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW (({{prefix_type}}ErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID (({{prefix_type}}ErrorId) UINT8_C(2))
+#define ERROR_ID_NOT_HOLDING_MUTEX (({{prefix_type}}ErrorId) UINT8_C(3))
+#define ERROR_ID_DEADLOCK (({{prefix_type}}ErrorId) UINT8_C(4))
+#define ERROR_ID_TASK_FUNCTION_RETURNS (({{prefix_type}}ErrorId) UINT8_C(5))
+#define ERROR_ID_INTERNAL_CURRENT_TASK_INVALID (({{prefix_type}}ErrorId) UINT8_C(6))
+#define ERROR_ID_INTERNAL_INVALID_ID (({{prefix_type}}ErrorId) UINT8_C(7))
+#define ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP (({{prefix_type}}ErrorId) UINT8_C(8))
+#define ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT (({{prefix_type}}ErrorId) UINT8_C(9))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_ZERO_TIMEOUT (({{prefix_type}}ErrorId) UINT8_C(10))
+#define ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER (({{prefix_type}}ErrorId) UINT8_C(11))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW (({{prefix_type}}ErrorId) UINT8_C(12))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION (({{prefix_type}}ErrorId) UINT8_C(13))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_CONFIGURATION (({{prefix_type}}ErrorId) UINT8_C(14))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_HEAD (({{prefix_type}}ErrorId) UINT8_C(15))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE (({{prefix_type}}ErrorId) UINT8_C(16))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_ID_IN_WAITERS (({{prefix_type}}ErrorId) UINT8_C(17))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TASKS_BLOCKED_DESPITE_AVAILABLE_MESSAGES (({{prefix_type}}ErrorId) UINT8_C(18))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_WAITING_TASK_IS_NOT_BLOCKED (({{prefix_type}}ErrorId) UINT8_C(19))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGES_POINTER (({{prefix_type}}ErrorId) UINT8_C(20))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGE_SIZE (({{prefix_type}}ErrorId) UINT8_C(21))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH (({{prefix_type}}ErrorId) UINT8_C(22))
+#define ERROR_ID_INTERNAL_PRECONDITION_VIOLATED (({{prefix_type}}ErrorId) UINT8_C(23))
+#define ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED (({{prefix_type}}ErrorId) UINT8_C(24))
+#define ERROR_ID_SEMAPHORE_MAX_INVALID (({{prefix_type}}ErrorId) UINT8_C(25))
+#define ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT (({{prefix_type}}ErrorId) UINT8_C(26))
+#define ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT (({{prefix_type}}ErrorId) UINT8_C(27))
+#define ERROR_ID_SEMAPHORE_MAX_EXCEEDED (({{prefix_type}}ErrorId) UINT8_C(28))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED (({{prefix_type}}ErrorId) UINT8_C(29))
+#define ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX (({{prefix_type}}ErrorId) UINT8_C(30))
+#define ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED (({{prefix_type}}ErrorId) UINT8_C(31))
+#define ERROR_ID_SCHED_EDF_TASK_NOT_PERIODIC (({{prefix_type}}ErrorId) UINT8_C(32))
+#define ERROR_ID_TIMER_TASK_NOT_PERIODIC (({{prefix_type}}ErrorId) UINT8_C(33))
+#define ERROR_ID_POOL_INVALID_BLOCK (({{prefix_type}}ErrorId) UINT8_C(34))
+#define ERROR_ID_BROADCAST_NOT_SUBSCRIBED (({{prefix_type}}ErrorId) UINT8_C(35))
+#define ERROR_ID_BROADCAST_INVALID_POINTER (({{prefix_type}}ErrorId) UINT8_C(36))
+#define ERROR_ID_WORK_QUEUE_INVALID_FUNCTION (({{prefix_type}}ErrorId) UINT8_C(37))
+#define ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS (({{prefix_type}}ErrorId) UINT8_C(38))
+#define ERROR_ID_TIMEBASE_TIME_TOO_FAR (({{prefix_type}}ErrorId) UINT8_C(39))
+
+
+typedef uint8_t BroadcastSubscriptionIndex;
+
+
+/* representation of a broadcast channel instance */
+struct broadcast
+{
+    /* pointer to the array holding the record data
+     * the array contains record_size * length bytes */
+    uint8_t *records;
+    /* size of each record in bytes */
+    uint16_t record_size;
+    /* number of records the channel retains for its subscribers */
+    uint8_t length;
+    /* index of the slot the next record is published into
+     * 0 <= head < length */
+    uint8_t head;
+    /* sequence number of the next record to be published */
+    uint32_t published;
+    /* range of the subscriptions of the channel in the broadcast_subscriptions array */
+    BroadcastSubscriptionIndex first_subscription;
+    BroadcastSubscriptionIndex subscription_count;
+    /* signal set sent to all subscribers when a record is published */
+    {{prefix_type}}SignalSet sig_set;
+};
+
+/* the per-subscriber state of a broadcast channel */
+struct broadcast_subscription
+{
+    {{prefix_type}}TaskId task;
+    /* sequence number of the next record the subscriber retrieves */
+    uint32_t cursor;
+    /* number of records that were overwritten before the subscriber retrieved them */
+    uint32_t lost;
+};
+
+
+extern void {{fatal_error}}({{prefix_type}}ErrorId error_id);
+
+
+
+
+{{#broadcasts.length}}
+static struct broadcast_subscription *broadcast_subscription_get({{prefix_type}}BroadcastId broadcast);
+static void broadcast_copy(uint8_t *dst, const uint8_t *src, uint16_t length);
+{{/broadcasts.length}}
+static void signal_send_set({{prefix_type}}TaskId task_id, {{prefix_type}}SignalSet signals);
+static {{prefix_type}}SignalSet signal_wait_set({{prefix_type}}SignalSet requested_signals) {{prefix_const}}REENTRANT;
+static {{prefix_type}}TaskId get_current_task(void);
+
+
+{{#broadcasts.length}}
+{{#broadcasts}}
+static uint8_t broadcast_{{name}}_records[{{length}}][{{#record_size}}{{record_size}}{{/record_size}}{{#record_type}}sizeof({{record_type}}){{/record_type}}];
+{{/broadcasts}}
+static struct broadcast broadcasts[{{broadcasts.length}}] =
+{
+{{#broadcasts}}
+    {
+        (uint8_t*)broadcast_{{name}}_records,
+{{#record_size}}
+        {{record_size}},
+{{/record_size}}
+{{#record_type}}
+        sizeof({{record_type}}),
+{{/record_type}}
+        {{length}},
+        0,
+        0,
+        {{first_subscription}},
+        {{subscribers.length}},
+        {{prefix_const}}SIGNAL_SET_{{sig_set|u}}
+    },
+{{/broadcasts}}
+};
+static struct broadcast_subscription broadcast_subscriptions[{{broadcast_subscriptions.length}}] =
+{
+{{#broadcast_subscriptions}}
+    { {{prefix_const}}TASK_ID_{{name|u}}, 0, 0 },
+{{/broadcast_subscriptions}}
+};
+
+{{/broadcasts.length}}
+static {{prefix_type}}TaskId current_task;
+static void (*wait_ptr)(void);
+{{prefix_type}}SignalSet pub_signals[{{tasks.length}}];
+uint8_t pub_waits;
+{{prefix_type}}ErrorId pub_fatal_error_id;
+
+{{#api_asserts}}
+#define api_error(error_id) {{fatal_error}}(error_id)
+{{/api_asserts}}
+{{^api_asserts}}
+#define api_error(error_id) do { } while(0)
+{{/api_asserts}}
+{{#api_asserts}}
+#define api_assert(expression, error_id) do { if (!(expression)) { api_error(error_id); } } while(0)
+{{/api_asserts}}
+{{^api_asserts}}
+#define api_assert(expression, error_id) do { } while(0)
+{{/api_asserts}}
+
+{{#internal_asserts}}
+#define internal_error(error_id) {{fatal_error}}(error_id)
+{{/internal_asserts}}
+{{^internal_asserts}}
+#define internal_error(error_id) do { } while(0)
+{{/internal_asserts}}
+{{#internal_asserts}}
+#define internal_assert(expression, error_id) do { if (!(expression)) { internal_error(error_id); } } while(0)
+{{/internal_asserts}}
+{{^internal_asserts}}
+#define internal_assert(expression, error_id) do { } while(0)
+{{/internal_asserts}}
+{{#broadcasts.length}}
+#define broadcast_api_assert_valid(broadcast) api_assert(broadcast < {{broadcasts.length}}, ERROR_ID_INVALID_ID)
+
+{{/broadcasts.length}}
+
+
+
+{{#broadcasts.length}}
+static struct broadcast_subscription *
+broadcast_subscription_get(const {{prefix_type}}BroadcastId broadcast)
+{
+    const struct broadcast *const b = &broadcasts[broadcast];
+    BroadcastSubscriptionIndex s;
+
+    /* loop bound: {{broadcast_subscriptions.length}} */
+    for (s = b->first_subscription; s < b->first_subscription + b->subscription_count; s += 1)
+    {
+        if (broadcast_subscriptions[s].task == get_current_task())
+        {
+            return &broadcast_subscriptions[s];
+        }
+    }
+
+    api_error(ERROR_ID_BROADCAST_NOT_SUBSCRIBED);
+    return &broadcast_subscriptions[b->first_subscription];
+}
+
+/* called broadcast_copy instead of memcpy to not conflict with gcc's built-in memcpy declaration on unit test
+ * targets */
+static void
+broadcast_copy(uint8_t *dst, const uint8_t *src, const uint16_t length)
+{
+    uint8_t *const dst_end = dst + length;
+
+    /* loop bound: 65535 */
+    while (dst < dst_end)
+    {
+        *dst++ = *src++;
+    }
+}
+
+{{/broadcasts.length}}
+static void
+signal_send_set(const {{prefix_type}}TaskId task_id, const {{prefix_type}}SignalSet signals)
+{
+    pub_signals[task_id] |= signals;
+}
+
+/*
+ * While the current task waits, other tasks run in the wait function that the test sets.
+ */
+static {{prefix_type}}SignalSet
+signal_wait_set(const {{prefix_type}}SignalSet requested_signals) {{prefix_const}}REENTRANT
+{
+    const {{prefix_type}}TaskId task = current_task;
+
+    pub_waits++;
+    pub_signals[task] &= ~requested_signals;
+    if (wait_ptr != NULL)
+    {
+        wait_ptr();
+    }
+    current_task = task;
+
+    return requested_signals;
+}
+
+static {{prefix_type}}TaskId
+get_current_task(void)
+{
+    return current_task;
+}
+
+void
+test_fatal_error(const {{prefix_type}}ErrorId error_id)
+{
+    pub_fatal_error_id = error_id;
+}
+
+
+{{#broadcasts.length}}
+void
+{{prefix_func}}broadcast_publish(const {{prefix_type}}BroadcastId broadcast, const void *const record)
+{
+    struct broadcast *b;
+    BroadcastSubscriptionIndex s;
+
+    broadcast_api_assert_valid(broadcast);
+    api_assert(record, ERROR_ID_BROADCAST_INVALID_POINTER);
+
+    b = &broadcasts[broadcast];
+
+    /* The record is copied once, regardless of the number of subscribers.
+     * The producer never waits for subscribers: slow subscribers lose the oldest records instead. */
+    broadcast_copy(&b->records[(uint16_t) b->head * b->record_size], (const uint8_t*)record, b->record_size);
+    b->head = (b->head + 1) % b->length;
+    b->published += 1;
+
+    /* Sending the signal only makes the subscribers runnable; they run in the order the scheduler selects them after
+     * the publishing task yields. */
+    /* loop bound: {{broadcast_subscriptions.length}} */
+    for (s = b->first_subscription; s < b->first_subscription + b->subscription_count; s += 1)
+    {
+        signal_send_set(broadcast_subscriptions[s].task, b->sig_set);
+    }
+}
+
+bool
+{{prefix_func}}broadcast_try_get(const {{prefix_type}}BroadcastId broadcast, void *const record)
+{
+    const struct broadcast *b;
+    struct broadcast_subscription *subscription;
+    uint32_t pending;
+
+    broadcast_api_assert_valid(broadcast);
+    api_assert(record, ERROR_ID_BROADCAST_INVALID_POINTER);
+
+    b = &broadcasts[broadcast];
+    subscription = broadcast_subscription_get(broadcast);
+    pending = b->published - subscription->cursor;
+
+    if (pending == 0)
+    {
+        return false;
+    }
+
+    if (pending > b->length)
+    {
+        /* The records the subscriber has not retrieved yet have been overwritten, so skip to the oldest record the
+         * channel still retains */
+        subscription->lost += pending - b->length;
+        subscription->cursor = b->published - b->length;
+        pending = b->length;
+    }
+
+    broadcast_copy((uint8_t*)record,
+                   &b->records[(uint16_t) ((b->head + b->length - pending) % b->length) * b->record_size],
+                   b->record_size);
+    subscription->cursor += 1;
+
+    return true;
+}
+
+void
+{{prefix_func}}broadcast_get(const {{prefix_type}}BroadcastId broadcast, void *const record) {{prefix_const}}REENTRANT
+{
+    broadcast_api_assert_valid(broadcast);
+    api_assert(record, ERROR_ID_BROADCAST_INVALID_POINTER);
+
+    while (!{{prefix_func}}broadcast_try_get(broadcast, record))
+    {
+        (void) signal_wait_set(broadcasts[broadcast].sig_set);
+    }
+}
+
+uint32_t
+{{prefix_func}}broadcast_lost(const {{prefix_type}}BroadcastId broadcast)
+{
+    struct broadcast_subscription *subscription;
+    const struct broadcast *b;
+    uint32_t lost;
+
+    broadcast_api_assert_valid(broadcast);
+
+    b = &broadcasts[broadcast];
+    subscription = broadcast_subscription_get(broadcast);
+    lost = subscription->lost;
+
+    /* Records that have been overwritten but not skipped by broadcast_try_get() yet are lost as well */
+    if (b->published - subscription->cursor > b->length)
+    {
+        lost += b->published - subscription->cursor - b->length;
+        subscription->cursor = b->published - b->length;
+    }
+    subscription->lost = 0;
+
+    return lost;
+}
+
+{{/broadcasts.length}}
+void
+pub_broadcast_init(void)
+{
+    {{prefix_type}}BroadcastId broadcast;
+    BroadcastSubscriptionIndex s;
+    {{prefix_type}}TaskId task_id;
+
+    /* For testing purposes, all channels and subscriptions are reset */
+    for (broadcast = 0; broadcast < {{broadcasts.length}}; broadcast++)
+    {
+        broadcasts[broadcast].head = 0;
+        broadcasts[broadcast].published = 0;
+    }
+    for (s = 0; s < {{broadcast_subscriptions.length}}; s++)
+    {
+        broadcast_subscriptions[s].cursor = 0;
+        broadcast_subscriptions[s].lost = 0;
+    }
+    for (task_id = {{prefix_const}}TASK_ID_ZERO; task_id <= {{prefix_const}}TASK_ID_MAX; task_id++)
+    {
+        pub_signals[task_id] = 0;
+    }
+    current_task = {{prefix_const}}TASK_ID_ZERO;
+    wait_ptr = NULL;
+    pub_waits = 0;
+    pub_fatal_error_id = ERROR_ID_NONE;
+}
+
+void
+pub_set_current_task(const {{prefix_type}}TaskId task_id)
+{
+    current_task = task_id;
+}
+
+void
+pub_set_wait_ptr(void (*y)(void))
+{
+    wait_ptr = y;
+}
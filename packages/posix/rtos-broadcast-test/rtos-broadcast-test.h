@@ -0,0 +1,57 @@
+#ifndef RTOS_BROADCAST_TEST_H
+#define RTOS_BROADCAST_TEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdint.h>
+
+typedef uint8_t {{prefix_type}}ErrorId;
+typedef uint8_t {{prefix_type}}BroadcastId;
+typedef uint8_t {{prefix_type}}TaskId;
+typedef uint8_t {{prefix_type}}SignalSet;
+
+
+
+
+#define {{prefix_const}}REENTRANT {{reentrant}}
+
+{{#broadcasts}}
+#define {{prefix_const}}BROADCAST_ID_{{name|u}} (({{prefix_type}}BroadcastId) UINT8_C({{idx}}))
+{{/broadcasts}}
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+{{#tasks}}
+#define {{prefix_const}}TASK_ID_{{name|u}} (({{prefix_type}}TaskId) UINT8_C({{idx}}))
+{{/tasks}}
+{{#broadcasts}}
+#define {{prefix_const}}SIGNAL_SET_{{sig_set|u}} (({{prefix_type}}SignalSet) UINT8_C(1))
+{{/broadcasts}}
+
+
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+{{#broadcasts.length}}
+void {{prefix_func}}broadcast_publish({{prefix_type}}BroadcastId broadcast, const void *record);
+bool {{prefix_func}}broadcast_try_get({{prefix_type}}BroadcastId broadcast, void *record);
+void {{prefix_func}}broadcast_get({{prefix_type}}BroadcastId broadcast, void *record) {{prefix_const}}REENTRANT;
+uint32_t {{prefix_func}}broadcast_lost({{prefix_type}}BroadcastId broadcast);
+
+{{/broadcasts.length}}
+void pub_broadcast_init(void);
+void pub_set_current_task({{prefix_type}}TaskId task_id);
+void pub_set_wait_ptr(void (*y)(void));
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_BROADCAST_TEST_H */
\ No newline at end of file
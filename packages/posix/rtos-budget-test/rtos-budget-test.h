@@ -0,0 +1,40 @@
+#ifndef RTOS_BUDGET_TEST_H
+#define RTOS_BUDGET_TEST_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+typedef uint8_t {{prefix_type}}TaskId;
+typedef uint16_t {{prefix_type}}TicksRelative;
+typedef uint32_t {{prefix_type}}TicksAbsolute;
+
+
+
+#define {{prefix_const}}REENTRANT {{reentrant}}
+
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+
+
+
+
+
+extern {{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+void pub_budget_init(void);
+void pub_sched_set_runnable({{prefix_type}}TaskId task_id);
+void pub_sched_set_blocked({{prefix_type}}TaskId task_id);
+bool pub_sched_runnable({{prefix_type}}TaskId task_id);
+{{prefix_type}}TaskId pub_budget_select(void);
+int32_t pub_budget_remaining({{prefix_type}}TaskId task_id);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_BUDGET_TEST_H */
\ No newline at end of file
@@ -0,0 +1,564 @@
+
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rtos-condition-variable-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+{{#mutexes.length}}
+#define MUTEX_ID_NONE ((MutexIdOption) UINT8_MAX)
+{{/mutexes.length}}
+{{#condition_variables.length}}
+#define COND_ID_NONE ((CondIdOption) UINT8_MAX)
+{{/condition_variables.length}}
+#define TASK_ID_NONE ((TaskIdOption) UINT8_MAX)
+typedef {{prefix_type}}MutexId MutexIdOption;
+typedef {{prefix_type}}CondId CondIdOption;
+typedef {{prefix_type}}TaskId TaskIdOption;
+
+
+struct mutex {
+    TaskIdOption holder;
+};
+{{#mutex.stats}}
+struct mutex_stat {
+    uint32_t mutex_lock_counter;
+    uint32_t mutex_lock_contended_counter;
+    {{prefix_type}}TicksRelative mutex_lock_max_wait_time;
+};
+{{/mutex.stats}}
+
+
+
+
+
+
+
+{{#mutexes.length}}
+static bool mutex_try_lock({{prefix_type}}MutexId m);
+static bool mutex_acquire({{prefix_type}}MutexId m) {{prefix_const}}REENTRANT;
+static void mutex_release({{prefix_type}}MutexId m);
+{{/mutexes.length}}
+{{#condition_variables.length}}
+static void cond_wake({{prefix_type}}CondId cond, bool all);
+{{/condition_variables.length}}
+static void test_block(TaskIdOption blocker) {{prefix_const}}REENTRANT;
+static void mutex_core_block_on({{prefix_type}}TaskId blocker) {{prefix_const}}REENTRANT;
+static void cond_core_block(void) {{prefix_const}}REENTRANT;
+static void cond_core_block_timeout({{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT;
+static void test_unblock({{prefix_type}}TaskId task);
+static void test_preempt_enable(void);
+static {{prefix_type}}TaskId get_current_task(void);
+
+{{#mutexes.length}}
+static struct mutex mutexes[{{mutexes.length}}] = {
+{{#mutexes}}
+    {TASK_ID_NONE},
+{{/mutexes}}
+};
+static MutexIdOption mutex_waiters[{{tasks.length}}] = {
+{{#tasks}}
+    MUTEX_ID_NONE,
+{{/tasks}}
+};
+{{#mutex.stats}}
+bool {{prefix_func}}mutex_stats_enabled;
+static struct mutex_stat mutex_stats[{{mutexes.length}}];
+{{/mutex.stats}}
+{{/mutexes.length}}
+{{#condition_variables.length}}
+/* The condition variable each task waits on, if any.
+ * A task waiting on a condition variable holds no mutex and is blocked without a blocker, so no task inherits its
+ * priority until it is woken up and waits for the mutex again. */
+static CondIdOption cond_waiters[{{tasks.length}}] = {
+{{#tasks}}
+    COND_ID_NONE,
+{{/tasks}}
+};
+{{/condition_variables.length}}
+static {{prefix_type}}TaskId current_task;
+static bool preemption_disabled;
+static bool preemption_pending;
+static void (*block_ptr)({{prefix_type}}TaskId);
+static void (*block_timeout_ptr)({{prefix_type}}TicksRelative);
+static void (*preempt_ptr)(void);
+{{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+bool pub_unblocked[{{tasks.length}}];
+uint8_t pub_deadlocks;
+uint8_t pub_preemption_errors;
+
+{{#mutexes.length}}
+#define assert_mutex_valid(mutex) api_assert(mutex < {{mutexes.length}}, ERROR_ID_INVALID_ID)
+{{/mutexes.length}}
+{{#condition_variables.length}}
+#define assert_cond_valid(cond) api_assert(cond < {{condition_variables.length}}, ERROR_ID_INVALID_ID)
+{{/condition_variables.length}}
+#define preempt_disable() (preemption_disabled = true)
+#define preempt_enable() test_preempt_enable()
+#define precondition_preemption_disabled() \
+    do { if (!preemption_disabled) { pub_preemption_errors++; } } while (0)
+#define postcondition_preemption_disabled() precondition_preemption_disabled()
+#define api_assert(expression, error_id) do { } while(0)
+#define mutex_core_unblock(task) test_unblock(task)
+#define cond_core_unblock(task) test_unblock(task)
+#define cond_core_higher_priority(t1, t2) ((t1) < (t2))
+
+{{#mutexes.length}}
+static bool
+mutex_try_lock(const {{prefix_type}}MutexId m)
+{
+    const bool r = mutexes[m].holder == TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    if (r)
+    {
+        mutexes[m].holder = get_current_task();
+    }
+
+    postcondition_preemption_disabled();
+
+    return r;
+}
+
+/*
+ * Lock the mutex, blocking the current task while another task holds it.
+ * Returns whether the mutex was contended.
+ */
+static bool
+mutex_acquire(const {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT
+{
+    bool contended = false;
+
+    precondition_preemption_disabled();
+
+    while (!mutex_try_lock(m))
+    {
+        contended = true;
+        mutex_waiters[get_current_task()] = m;
+        mutex_core_block_on(mutexes[m].holder);
+    }
+
+    postcondition_preemption_disabled();
+
+    return contended;
+}
+
+static void
+mutex_release(const {{prefix_type}}MutexId m)
+{
+    {{prefix_type}}TaskId t;
+
+    precondition_preemption_disabled();
+
+
+    /* loop bound: {{tasks.length}} */
+    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+    {
+        if (mutex_waiters[t] == m)
+        {
+            mutex_waiters[t] = MUTEX_ID_NONE;
+            mutex_core_unblock(t);
+        }
+    }
+
+    mutexes[m].holder = TASK_ID_NONE;
+
+    postcondition_preemption_disabled();
+}
+{{#mutex.stats}}
+
+static void
+mutex_stats_update(const {{prefix_type}}MutexId m, const bool contended, const {{prefix_type}}TicksAbsolute
+        wait_start_ticks)
+{
+    if ({{prefix_func}}mutex_stats_enabled) {
+        mutex_stats[m].mutex_lock_counter += 1;
+        if (contended) {
+            {{prefix_type}}TicksRelative wait_time = {{prefix_func}}timer_current_ticks - wait_start_ticks;
+
+            mutex_stats[m].mutex_lock_contended_counter += 1;
+            if (wait_time > mutex_stats[m].mutex_lock_max_wait_time)
+            {
+                mutex_stats[m].mutex_lock_max_wait_time = wait_time;
+            }
+        }
+    }
+}
+{{/mutex.stats}}
+{{/mutexes.length}}
+{{#condition_variables.length}}
+static void
+cond_wake(const {{prefix_type}}CondId cond, const bool all)
+{
+    {{prefix_type}}TaskId t;
+    TaskIdOption waiter = TASK_ID_NONE;
+
+    precondition_preemption_disabled();
+
+    /* loop bound: {{tasks.length}} */
+    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+    {
+        if (cond_waiters[t] == cond)
+        {
+            if (all)
+            {
+                cond_waiters[t] = COND_ID_NONE;
+                cond_core_unblock(t);
+            }
+            else if (waiter == TASK_ID_NONE || cond_core_higher_priority(t, waiter))
+            {
+                waiter = t;
+            }
+        }
+    }
+
+    if (waiter != TASK_ID_NONE)
+    {
+        cond_waiters[waiter] = COND_ID_NONE;
+        cond_core_unblock(waiter);
+    }
+
+    postcondition_preemption_disabled();
+}
+{{/condition_variables.length}}
+/*
+ * While the current task is blocked, other tasks run in the block function that the test sets.
+ * The block function receives the task that holds the mutex the current task waits for, if any.
+ * Each block function runs once, so that the test lays out exactly which tasks run at which point.
+ * When no other task runs, nothing can unblock the current task.
+ * Instead of blocking forever, the task records the deadlock and stops waiting, so that a failing test does not hang.
+ */
+static void
+test_block(const TaskIdOption blocker) {{prefix_const}}REENTRANT
+{
+    const {{prefix_type}}TaskId task = current_task;
+    void (*const block)({{prefix_type}}TaskId) = block_ptr;
+
+    precondition_preemption_disabled();
+
+    pub_unblocked[task] = false;
+    block_ptr = NULL;
+    if (block != NULL)
+    {
+        /* Other tasks start with preemption enabled */
+        preemption_disabled = false;
+        block(blocker);
+        preemption_disabled = true;
+    }
+    current_task = task;
+
+    if (!pub_unblocked[task])
+    {
+        pub_deadlocks++;
+        cond_waiters[task] = COND_ID_NONE;
+        if (mutex_waiters[task] != MUTEX_ID_NONE)
+        {
+            mutexes[mutex_waiters[task]].holder = TASK_ID_NONE;
+            mutex_waiters[task] = MUTEX_ID_NONE;
+        }
+    }
+}
+
+static void
+mutex_core_block_on(const {{prefix_type}}TaskId blocker) {{prefix_const}}REENTRANT
+{
+    test_block(blocker);
+}
+
+static void
+cond_core_block(void) {{prefix_const}}REENTRANT
+{
+    test_block(TASK_ID_NONE);
+}
+
+/*
+ * Without a block function, no other task runs and the timeout expires.
+ */
+static void
+cond_core_block_timeout(const {{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT
+{
+    const {{prefix_type}}TaskId task = current_task;
+    void (*const block_timeout)({{prefix_type}}TicksRelative) = block_timeout_ptr;
+
+    precondition_preemption_disabled();
+
+    pub_unblocked[task] = false;
+    block_timeout_ptr = NULL;
+    if (block_timeout != NULL)
+    {
+        preemption_disabled = false;
+        block_timeout(timeout);
+        preemption_disabled = true;
+    }
+    else
+    {
+        {{prefix_func}}timer_current_ticks += timeout;
+    }
+    current_task = task;
+}
+
+static void
+test_unblock(const {{prefix_type}}TaskId task)
+{
+    precondition_preemption_disabled();
+
+    pub_unblocked[task] = true;
+    preemption_pending = true;
+}
+
+/*
+ * An unblocked task preempts the current task as soon as preemption is enabled again, if the test sets a preempt
+ * function.
+ */
+static void
+test_preempt_enable(void)
+{
+    const {{prefix_type}}TaskId task = current_task;
+    void (*const preempt)(void) = preempt_ptr;
+
+    preemption_disabled = false;
+    if (preemption_pending)
+    {
+        preemption_pending = false;
+        if (preempt != NULL)
+        {
+            preempt_ptr = NULL;
+            preempt();
+            current_task = task;
+        }
+    }
+}
+
+static {{prefix_type}}TaskId
+get_current_task(void)
+{
+    return current_task;
+}
+
+{{#mutexes.length}}
+void
+{{prefix_func}}mutex_lock(const {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT
+{
+{{#mutex.stats}}
+    bool contended;
+    const {{prefix_type}}TicksAbsolute wait_start_ticks = {{prefix_func}}timer_current_ticks;
+
+{{/mutex.stats}}
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder != get_current_task(), ERROR_ID_DEADLOCK);
+
+    preempt_disable();
+
+{{#mutex.stats}}
+    contended = mutex_acquire(m);
+{{/mutex.stats}}
+{{^mutex.stats}}
+    (void) mutex_acquire(m);
+{{/mutex.stats}}
+
+    preempt_enable();
+
+{{#mutex.stats}}
+    mutex_stats_update(m, contended, wait_start_ticks);
+{{/mutex.stats}}
+}
+
+
+void
+{{prefix_func}}mutex_unlock(const {{prefix_type}}MutexId m)
+{
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    mutex_release(m);
+
+    preempt_enable();
+}
+
+bool
+{{prefix_func}}mutex_try_lock(const {{prefix_type}}MutexId m)
+{
+    bool r;
+
+    assert_mutex_valid(m);
+
+    preempt_disable();
+
+    r = mutex_try_lock(m);
+
+    preempt_enable();
+
+    return r;
+}
+
+/* A macro implementation would be preferable to eliminate function call overhead when compilers don't support implicit
+ * inlining, but at present this would involve exposing too many implementation internals in the public API header. */
+bool
+{{prefix_func}}mutex_holder_is_current(const {{prefix_type}}MutexId m)
+{
+    assert_mutex_valid(m);
+    return mutexes[m].holder == get_current_task();
+}
+
+{{#mutex.stats}}
+void {{prefix_func}}mutex_stats_clear(void)
+{
+    /* memset would be preferable, but string.h is not available on all platforms */
+    uint8_t mutex_index;
+    /* loop bound: {{mutexes.length}} */
+    for (mutex_index = 0; mutex_index < {{mutexes.length}}; mutex_index += 1)
+    {
+        mutex_stats[mutex_index].mutex_lock_counter = 0;
+        mutex_stats[mutex_index].mutex_lock_contended_counter = 0;
+        mutex_stats[mutex_index].mutex_lock_max_wait_time = 0;
+    }
+}
+{{/mutex.stats}}
+{{/mutexes.length}}
+{{#condition_variables.length}}
+void
+{{prefix_func}}cond_wait(const {{prefix_type}}CondId cond, const {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT
+{
+    assert_cond_valid(cond);
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    /* With preemption disabled, no other task can signal the condition variable between releasing the mutex and
+     * blocking, so the wakeup cannot be lost. */
+    cond_waiters[get_current_task()] = cond;
+    mutex_release(m);
+
+    /* The task may also receive the blocking signal for reasons other than being woken up, e.g., a stale signal of an
+     * earlier timeout, so block until it is actually removed from the waiters. */
+    do
+    {
+        cond_core_block();
+    } while (cond_waiters[get_current_task()] == cond);
+
+    (void) mutex_acquire(m);
+
+    preempt_enable();
+}
+
+bool
+{{prefix_func}}cond_wait_timeout(const {{prefix_type}}CondId cond, const {{prefix_type}}MutexId m,
+                                 const {{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT
+{
+    bool signaled;
+    const {{prefix_type}}TicksAbsolute absolute_timeout = {{prefix_func}}timer_current_ticks + timeout;
+
+    assert_cond_valid(cond);
+    assert_mutex_valid(m);
+    api_assert(mutexes[m].holder == get_current_task(), ERROR_ID_NOT_HOLDING_MUTEX);
+
+    preempt_disable();
+
+    cond_waiters[get_current_task()] = cond;
+    mutex_release(m);
+
+    while (cond_waiters[get_current_task()] == cond && absolute_timeout > {{prefix_func}}timer_current_ticks)
+    {
+        cond_core_block_timeout(absolute_timeout - {{prefix_func}}timer_current_ticks);
+    }
+    signaled = cond_waiters[get_current_task()] != cond;
+    cond_waiters[get_current_task()] = COND_ID_NONE;
+
+    (void) mutex_acquire(m);
+
+    preempt_enable();
+
+    return signaled;
+}
+
+void
+{{prefix_func}}cond_signal(const {{prefix_type}}CondId cond)
+{
+    assert_cond_valid(cond);
+
+    preempt_disable();
+
+    cond_wake(cond, false);
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}cond_broadcast(const {{prefix_type}}CondId cond)
+{
+    assert_cond_valid(cond);
+
+    preempt_disable();
+
+    cond_wake(cond, true);
+
+    preempt_enable();
+}
+{{/condition_variables.length}}
+
+struct mutex * pub_mutexes = mutexes;
+
+void
+pub_cond_init(void)
+{
+    {{prefix_type}}MutexId mutex_id;
+    {{prefix_type}}TaskId task_id;
+
+    /* For testing purposes, all mutexes and waiters are reset, too */
+    for (mutex_id = {{prefix_const}}MUTEX_ID_ZERO; mutex_id <= {{prefix_const}}MUTEX_ID_MAX; mutex_id++)
+    {
+        mutexes[mutex_id].holder = TASK_ID_NONE;
+    }
+    for (task_id = {{prefix_const}}TASK_ID_ZERO; task_id <= {{prefix_const}}TASK_ID_MAX; task_id++)
+    {
+        mutex_waiters[task_id] = MUTEX_ID_NONE;
+        cond_waiters[task_id] = COND_ID_NONE;
+        pub_unblocked[task_id] = false;
+    }
+    current_task = {{prefix_const}}TASK_ID_ZERO;
+    preemption_disabled = false;
+    preemption_pending = false;
+    block_ptr = NULL;
+    block_timeout_ptr = NULL;
+    preempt_ptr = NULL;
+    {{prefix_func}}timer_current_ticks = 0;
+    pub_deadlocks = 0;
+    pub_preemption_errors = 0;
+}
+
+void
+pub_set_current_task(const {{prefix_type}}TaskId task_id)
+{
+    current_task = task_id;
+}
+
+void
+pub_set_block_ptr(void (*y)({{prefix_type}}TaskId))
+{
+    block_ptr = y;
+}
+
+void
+pub_set_block_timeout_ptr(void (*y)({{prefix_type}}TicksRelative))
+{
+    block_timeout_ptr = y;
+}
+
+void
+pub_set_preempt_ptr(void (*y)(void))
+{
+    preempt_ptr = y;
+}
@@ -0,0 +1,76 @@
+#ifndef RTOS_CONDITION_VARIABLE_TEST_H
+#define RTOS_CONDITION_VARIABLE_TEST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint8_t {{prefix_type}}MutexId;
+typedef uint8_t {{prefix_type}}CondId;
+typedef uint8_t {{prefix_type}}TaskId;
+typedef uint16_t {{prefix_type}}TicksRelative;
+typedef uint32_t {{prefix_type}}TicksAbsolute;
+
+
+
+
+#define {{prefix_const}}REENTRANT {{reentrant}}
+{{#mutexes.length}}
+#define {{prefix_const}}MUTEX_ID_ZERO (({{prefix_type}}MutexId) UINT8_C(0))
+#define {{prefix_const}}MUTEX_ID_MAX (({{prefix_type}}MutexId) UINT8_C({{mutexes.length}} - 1))
+{{#mutexes}}
+#define {{prefix_const}}MUTEX_ID_{{name|u}} (({{prefix_type}}MutexId) UINT8_C({{idx}}))
+{{/mutexes}}
+{{/mutexes.length}}
+{{#condition_variables.length}}
+#define {{prefix_const}}COND_ID_ZERO (({{prefix_type}}CondId) UINT8_C(0))
+#define {{prefix_const}}COND_ID_MAX (({{prefix_type}}CondId) UINT8_C({{condition_variables.length}} - 1))
+{{#condition_variables}}
+#define {{prefix_const}}COND_ID_{{name|u}} (({{prefix_type}}CondId) UINT8_C({{idx}}))
+{{/condition_variables}}
+{{/condition_variables.length}}
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+
+
+
+
+
+{{#mutex.stats}}
+extern bool {{prefix_func}}mutex_stats_enabled;
+{{/mutex.stats}}
+
+extern {{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+{{#mutexes.length}}
+void {{prefix_func}}mutex_lock({{prefix_type}}MutexId) {{prefix_const}}REENTRANT;
+bool {{prefix_func}}mutex_try_lock({{prefix_type}}MutexId);
+void {{prefix_func}}mutex_unlock({{prefix_type}}MutexId);
+bool {{prefix_func}}mutex_holder_is_current({{prefix_type}}MutexId);
+{{#mutex.stats}}
+void {{prefix_func}}mutex_stats_clear(void);
+{{/mutex.stats}}
+{{/mutexes.length}}
+{{#condition_variables.length}}
+void {{prefix_func}}cond_wait({{prefix_type}}CondId cond, {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT;
+bool {{prefix_func}}cond_wait_timeout({{prefix_type}}CondId cond, {{prefix_type}}MutexId m,
+                                    {{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT;
+void {{prefix_func}}cond_signal({{prefix_type}}CondId cond);
+void {{prefix_func}}cond_broadcast({{prefix_type}}CondId cond);
+{{/condition_variables.length}}
+void pub_cond_init(void);
+void pub_set_current_task({{prefix_type}}TaskId task_id);
+void pub_set_block_ptr(void (*y)({{prefix_type}}TaskId));
+void pub_set_block_timeout_ptr(void (*y)({{prefix_type}}TicksRelative));
+void pub_set_preempt_ptr(void (*y)(void));
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_CONDITION_VARIABLE_TEST_H */
\ No newline at end of file
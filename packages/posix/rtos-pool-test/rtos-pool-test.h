@@ -0,0 +1,59 @@
+#ifndef RTOS_POOL_TEST_H
+#define RTOS_POOL_TEST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint8_t {{prefix_type}}ErrorId;
+typedef uint8_t {{prefix_type}}PoolId;
+typedef uint8_t {{prefix_type}}TaskId;
+typedef uint16_t {{prefix_type}}TicksRelative;
+typedef uint32_t {{prefix_type}}TicksAbsolute;
+
+
+
+
+#define {{prefix_const}}REENTRANT {{reentrant}}
+
+{{#pools}}
+#define {{prefix_const}}POOL_ID_{{name|u}} (({{prefix_type}}PoolId) UINT8_C({{idx}}))
+{{/pools}}
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+
+
+
+
+
+
+
+extern {{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+{{#pools.length}}
+void *{{prefix_func}}pool_alloc({{prefix_type}}PoolId pool);
+void *{{prefix_func}}pool_alloc_wait({{prefix_type}}PoolId pool) {{prefix_const}}REENTRANT;
+void *{{prefix_func}}pool_alloc_timeout({{prefix_type}}PoolId pool, {{prefix_type}}TicksRelative timeout)
+        {{prefix_const}}REENTRANT;
+void {{prefix_func}}pool_free({{prefix_type}}PoolId pool, void *block);
+void {{prefix_func}}pool_free_from_interrupt({{prefix_type}}PoolId pool, void *block);
+uint16_t {{prefix_func}}pool_high_water_mark({{prefix_type}}PoolId pool);
+{{/pools.length}}
+void pub_pool_init(void);
+void pub_set_current_task({{prefix_type}}TaskId task_id);
+void pub_set_interrupt_ptr(void (*y)(void), uint32_t compare_and_swap_count);
+void pub_set_block_ptr(void (*y)(void));
+void pub_set_block_timeout_ptr(void (*y)({{prefix_type}}TicksRelative));
+uint32_t pub_pool_head({{prefix_type}}PoolId pool);
+{{prefix_type}}ErrorId pub_pool_free_fatal_error({{prefix_type}}PoolId pool, void *block);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_POOL_TEST_H */
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef RTOS_SCHED_PRIO_INHERIT_TEST_H
+#define RTOS_SCHED_PRIO_INHERIT_TEST_H
+
+
+
+
+
+
+
+
+
+#define {{prefix_const}}REENTRANT {{reentrant}}
+
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_SCHED_PRIO_INHERIT_TEST_H */
\ No newline at end of file
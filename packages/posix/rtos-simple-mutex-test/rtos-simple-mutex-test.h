@@ -0,0 +1,41 @@
+#ifndef RTOS_SIMPLE_MUTEX_TEST_H
+#define RTOS_SIMPLE_MUTEX_TEST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+{{#mutexes.length}}
+typedef uint8_t {{prefix_type}}MutexId;
+{{/mutexes.length}}
+
+
+
+
+#define {{prefix_const}}REENTRANT {{reentrant}}
+{{#mutexes}}
+#define {{prefix_const}}MUTEX_ID_{{name|u}} (({{prefix_type}}MutexId) UINT8_C({{idx}}))
+{{/mutexes}}
+
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+{{#mutexes.length}}
+void {{prefix_func}}mutex_lock({{prefix_type}}MutexId) {{prefix_const}}REENTRANT;
+bool {{prefix_func}}mutex_try_lock({{prefix_type}}MutexId);
+void {{prefix_func}}mutex_unlock({{prefix_type}}MutexId);
+{{/mutexes.length}}
+void {{prefix_func}}yield(void) {{prefix_const}}REENTRANT;
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_SIMPLE_MUTEX_TEST_H */
\ No newline at end of file
@@ -0,0 +1,227 @@
+
+
+
+#include <stdio.h>
+#include <stddef.h>
+#include "rtos-simple-semaphore-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+
+#define SEM_ID_NONE ((SemIdOption) UINT8_MAX)
+#define SEM_VALUE_ZERO (({{prefix_type}}SemValue) UINT{{semaphore_value_size}}_C(0))
+{{#semaphore_enable_max}}
+#define SEM_VALUE_MAX (({{prefix_type}}SemValue) UINT{{semaphore_value_size}}_MAX)
+{{/semaphore_enable_max}}
+
+typedef {{prefix_type}}SemId SemIdOption;
+
+
+struct semaphore {
+    {{prefix_type}}SemValue value;
+{{#semaphore_enable_max}}
+    {{prefix_type}}SemValue max;
+{{/semaphore_enable_max}}
+};
+
+
+
+
+
+
+
+static bool internal_sem_try_wait(const {{prefix_type}}SemId s);
+
+
+
+static struct semaphore semaphores[{{semaphores.length}}];
+static SemIdOption sem_waiters[{{tasks.length}}];
+static void (*block_ptr)(void);
+static void (*unblock_ptr)({{prefix_type}}TaskId);
+static {{prefix_type}}TaskId (*get_current_task_ptr)(void);
+
+#define preempt_disable()
+#define preempt_enable()
+#define preempt_clear()
+#define precondition_preemption_disabled()
+#define postcondition_preemption_disabled()
+#define assert_sem_valid(sem) api_assert(sem < {{semaphores.length}}, ERROR_ID_INVALID_ID)
+#define sem_core_block() block()
+#define sem_core_unblock(task_id) unblock(task_id)
+#define api_assert(expression, error_id) do { } while(0)
+
+
+static void
+sem_init(void)
+{
+    {{prefix_type}}TaskId t;
+
+    for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+    {
+        sem_waiters[t] = SEM_ID_NONE;
+    }
+}
+
+static bool
+internal_sem_try_wait(const {{prefix_type}}SemId s)
+{
+    precondition_preemption_disabled();
+
+    if (semaphores[s].value == SEM_VALUE_ZERO)
+    {
+        return false;
+    }
+    else
+    {
+        semaphores[s].value--;
+        return true;
+    }
+
+    postcondition_preemption_disabled();
+}
+static void
+block(void) {{prefix_const}}REENTRANT
+{
+    if (block_ptr != NULL)
+    {
+        block_ptr();
+    }
+}
+
+static void
+unblock({{prefix_type}}TaskId task_id)
+{
+    if (unblock_ptr != NULL)
+    {
+        unblock_ptr(task_id);
+    }
+}
+
+static {{prefix_type}}TaskId
+get_current_task(void)
+{
+    if (get_current_task_ptr != NULL)
+    {
+        return get_current_task_ptr();
+    }
+
+    return {{prefix_const}}TASK_ID_ZERO;
+}
+
+
+void
+{{prefix_func}}sem_wait(const {{prefix_type}}SemId s) {{prefix_const}}REENTRANT
+{
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+    while (!internal_sem_try_wait(s))
+    {
+        sem_waiters[get_current_task()] = s;
+        sem_core_block();
+    }
+
+    preempt_enable();
+}
+
+
+void
+{{prefix_func}}sem_post(const {{prefix_type}}SemId s)
+{
+    {{prefix_type}}TaskId t;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+
+{{#semaphore_enable_max}}
+    api_assert(semaphores[s].max != SEM_VALUE_ZERO, ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT);
+
+    if (semaphores[s].value >= semaphores[s].max) {
+        {{fatal_error}}(ERROR_ID_SEMAPHORE_MAX_EXCEEDED);
+    }
+{{/semaphore_enable_max}}
+
+    if (semaphores[s].value == SEM_VALUE_ZERO)
+    {
+        /* loop bound: {{tasks.length}} */
+        for (t = {{prefix_const}}TASK_ID_ZERO; t <= {{prefix_const}}TASK_ID_MAX; t++)
+        {
+            if (sem_waiters[t] == s)
+            {
+                sem_waiters[t] = SEM_ID_NONE;
+                sem_core_unblock(t);
+            }
+        }
+    }
+
+    semaphores[s].value++;
+
+    preempt_enable();
+}
+
+bool
+{{prefix_func}}sem_try_wait(const {{prefix_type}}SemId s)
+{
+    bool r;
+
+    assert_sem_valid(s);
+
+    preempt_disable();
+    r = internal_sem_try_wait(s);
+    preempt_enable();
+
+    return r;
+}
+
+{{#semaphore_enable_max}}
+void
+{{prefix_func}}sem_max_init(const {{prefix_type}}SemId s, const {{prefix_type}}SemValue max)
+{
+    assert_sem_valid(s);
+
+    api_assert(max != SEM_VALUE_ZERO, ERROR_ID_SEMAPHORE_MAX_INVALID);
+    api_assert(semaphores[s].max == SEM_VALUE_ZERO, ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT);
+
+    semaphores[s].max = max;
+}
+{{/semaphore_enable_max}}
+
+struct semaphore * pub_semaphores = semaphores;
+{{prefix_type}}TaskId * pub_waiters = sem_waiters;
+
+void pub_set_block_ptr(void (*fn)(void))
+{
+    block_ptr = fn;
+}
+
+void pub_set_unblock_ptr(void (*fn)({{prefix_type}}TaskId))
+{
+    unblock_ptr = fn;
+}
+
+void pub_set_get_current_task_ptr({{prefix_type}}TaskId (*y)(void))
+{
+    get_current_task_ptr = y;
+}
+
+void pub_sem_init(void)
+{
+    {{prefix_type}}SemId sem_id;
+    sem_init();
+    /* For testing purposes we also reset the value of all semaphores to zero */
+    for (sem_id = {{prefix_const}}SEM_ID_ZERO; sem_id <= {{prefix_const}}SEM_ID_MAX; sem_id++)
+    {
+        semaphores[sem_id].value = SEM_VALUE_ZERO;
+    }
+    block_ptr = NULL;
+    unblock_ptr = NULL;
+    get_current_task_ptr = NULL;
+}
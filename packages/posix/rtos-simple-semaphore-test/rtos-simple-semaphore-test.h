@@ -0,0 +1,51 @@
+#ifndef RTOS_SIMPLE_SEMAPHORE_TEST_H
+#define RTOS_SIMPLE_SEMAPHORE_TEST_H
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+
+typedef uint8_t {{prefix_type}}SemId;
+typedef uint{{semaphore_value_size}}_t {{prefix_type}}SemValue;
+typedef uint8_t {{prefix_type}}TaskId;
+
+
+
+
+#define {{prefix_const}}REENTRANT {{reentrant}}
+
+#define {{prefix_const}}SEM_ID_ZERO (({{prefix_type}}SemId) UINT8_C(0))
+#define {{prefix_const}}SEM_ID_MAX (({{prefix_type}}SemId) UINT8_C({{semaphores.length}} - 1))
+{{#semaphores}}
+#define {{prefix_const}}SEM_ID_{{name|u}} (({{prefix_type}}SemId) UINT8_C({{idx}}))
+{{/semaphores}}
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+
+
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+void {{prefix_func}}sem_post({{prefix_type}}SemId);
+bool {{prefix_func}}sem_try_wait({{prefix_type}}SemId);
+void {{prefix_func}}sem_wait({{prefix_type}}SemId) {{prefix_const}}REENTRANT;
+{{#semaphore_enable_max}}
+void {{prefix_func}}sem_max_init({{prefix_type}}SemId s, {{prefix_type}}SemValue max);
+{{/semaphore_enable_max}}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_SIMPLE_SEMAPHORE_TEST_H */
\ No newline at end of file
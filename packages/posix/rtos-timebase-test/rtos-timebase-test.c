@@ -0,0 +1,569 @@
+
+#include <stdint.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rtos-timebase-test.h"
+/* Functions on the hot paths of the RTOS, such as scheduling and context switching, are placed in the .ramfunc
+ * section.
+ * Linker scripts may place this section in faster memory than other code, e.g., in SRAM instead of flash with wait
+ * states, or collect it with the rest of the code. */
+#ifdef __ELF__
+#define RAMFUNC __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#endif
+#define ERROR_ID_NONE (({{prefix_type}}ErrorId) UINT8_C(0))
+#define ERROR_ID_TICK_OVERFLOW (({{prefix_type}}ErrorId) UINT8_C(1))
+#define ERROR_ID_INVALID_ID (({{prefix_type}}ErrorId) UINT8_C(2))
+#define ERROR_ID_NOT_HOLDING_MUTEX (({{prefix_type}}ErrorId) UINT8_C(3))
+#define ERROR_ID_DEADLOCK (({{prefix_type}}ErrorId) UINT8_C(4))
+#define ERROR_ID_TASK_FUNCTION_RETURNS (({{prefix_type}}ErrorId) UINT8_C(5))
+#define ERROR_ID_INTERNAL_CURRENT_TASK_INVALID (({{prefix_type}}ErrorId) UINT8_C(6))
+#define ERROR_ID_INTERNAL_INVALID_ID (({{prefix_type}}ErrorId) UINT8_C(7))
+#define ERROR_ID_MESSAGE_QUEUE_BUFFER_OVERLAP (({{prefix_type}}ErrorId) UINT8_C(8))
+#define ERROR_ID_MESSAGE_QUEUE_ZERO_TIMEOUT (({{prefix_type}}ErrorId) UINT8_C(9))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_ZERO_TIMEOUT (({{prefix_type}}ErrorId) UINT8_C(10))
+#define ERROR_ID_MESSAGE_QUEUE_INVALID_POINTER (({{prefix_type}}ErrorId) UINT8_C(11))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_TICK_OVERFLOW (({{prefix_type}}ErrorId) UINT8_C(12))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_INCORRECT_INITIALIZATION (({{prefix_type}}ErrorId) UINT8_C(13))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_CONFIGURATION (({{prefix_type}}ErrorId) UINT8_C(14))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_HEAD (({{prefix_type}}ErrorId) UINT8_C(15))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_AVAILABLE (({{prefix_type}}ErrorId) UINT8_C(16))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_ID_IN_WAITERS (({{prefix_type}}ErrorId) UINT8_C(17))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TASKS_BLOCKED_DESPITE_AVAILABLE_MESSAGES (({{prefix_type}}ErrorId) UINT8_C(18))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_WAITING_TASK_IS_NOT_BLOCKED (({{prefix_type}}ErrorId) UINT8_C(19))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGES_POINTER (({{prefix_type}}ErrorId) UINT8_C(20))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_MESSAGE_SIZE (({{prefix_type}}ErrorId) UINT8_C(21))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_INVALID_QUEUE_LENGTH (({{prefix_type}}ErrorId) UINT8_C(22))
+#define ERROR_ID_INTERNAL_PRECONDITION_VIOLATED (({{prefix_type}}ErrorId) UINT8_C(23))
+#define ERROR_ID_INTERNAL_POSTCONDITION_VIOLATED (({{prefix_type}}ErrorId) UINT8_C(24))
+#define ERROR_ID_SEMAPHORE_MAX_INVALID (({{prefix_type}}ErrorId) UINT8_C(25))
+#define ERROR_ID_SEMAPHORE_MAX_USE_BEFORE_INIT (({{prefix_type}}ErrorId) UINT8_C(26))
+#define ERROR_ID_SEMAPHORE_MAX_ALREADY_INIT (({{prefix_type}}ErrorId) UINT8_C(27))
+#define ERROR_ID_SEMAPHORE_MAX_EXCEEDED (({{prefix_type}}ErrorId) UINT8_C(28))
+#define ERROR_ID_MESSAGE_QUEUE_INTERNAL_VIOLATED_INVARIANT_TIMER_IS_ENABLED (({{prefix_type}}ErrorId) UINT8_C(29))
+#define ERROR_ID_SCHED_PRIO_CEILING_TASK_LOCKING_LOWER_PRIORITY_MUTEX (({{prefix_type}}ErrorId) UINT8_C(30))
+#define ERROR_ID_SCHED_PRIO_CEILING_MUTEX_ALREADY_LOCKED (({{prefix_type}}ErrorId) UINT8_C(31))
+#define ERROR_ID_SCHED_EDF_TASK_NOT_PERIODIC (({{prefix_type}}ErrorId) UINT8_C(32))
+#define ERROR_ID_TIMER_TASK_NOT_PERIODIC (({{prefix_type}}ErrorId) UINT8_C(33))
+#define ERROR_ID_POOL_INVALID_BLOCK (({{prefix_type}}ErrorId) UINT8_C(34))
+#define ERROR_ID_BROADCAST_NOT_SUBSCRIBED (({{prefix_type}}ErrorId) UINT8_C(35))
+#define ERROR_ID_BROADCAST_INVALID_POINTER (({{prefix_type}}ErrorId) UINT8_C(36))
+#define ERROR_ID_WORK_QUEUE_INVALID_FUNCTION (({{prefix_type}}ErrorId) UINT8_C(37))
+#define ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS (({{prefix_type}}ErrorId) UINT8_C(38))
+#define ERROR_ID_TIMEBASE_TIME_TOO_FAR (({{prefix_type}}ErrorId) UINT8_C(39))
+{{#timebase}}
+#define TIMEBASE_NANOSECONDS_PER_SECOND UINT32_C(1000000000)
+#define TIMEBASE_TICK_PERIOD UINT32_C({{tick_period}})
+#define TIMEBASE_TICKS_PER_SECOND UINT32_C({{ticks_per_second}})
+#define TIMEBASE_RATE UINT64_C({{rate}})
+#define TIMEBASE_RATE_PER_PPB INT64_C({{rate_per_ppb}})
+#define TIMEBASE_CYCLES_PER_NANOSECOND UINT64_C({{cycles_per_nanosecond}})
+#define TIMEBASE_CYCLES_PER_NANOSECOND_PER_PPB INT64_C({{cycles_per_nanosecond_per_ppb}})
+#define TIMEBASE_ADJUSTMENT_MAX INT32_C(1000000)
+#define TIMEBASE_SECONDS_MAX ((UINT{{ticksrelative_size}}_MAX - 2U) / TIMEBASE_TICKS_PER_SECOND - 1U)
+{{/timebase}}
+#define {{prefix_const}}SIGNAL_ID__TASK_TIMER UINT8_C(1)
+
+
+
+{{#timebase}}
+/*
+ * The network time at the most recent tick, and the value of the cycle counter when the tick interrupt handler sampled
+ * it.
+ * The rate converts cycles to nanoseconds, with 32 fractional bits, and the fraction holds the fraction of a
+ * nanosecond that the network time had reached at the tick.
+ * The step is the total of all steps that the clock includes.
+ * The sequence number increments at each tick, so that readers detect that a tick interrupted them.
+ */
+struct timebase_clock {
+    uint32_t sequence;
+    {{prefix_type}}TicksAbsolute ticks;
+    uint32_t cycles;
+    uint32_t seconds;
+    uint32_t nanoseconds;
+    uint32_t fraction;
+    uint64_t rate;
+    uint32_t step_seconds;
+    uint32_t step_nanoseconds;
+};
+
+/*
+ * The total of all steps of the network time that tasks requested, modulo 2^32 seconds.
+ * The next tick applies the difference to the total that the clock includes.
+ */
+struct timebase_step {
+    uint32_t seconds;
+    uint32_t nanoseconds;
+};
+{{/timebase}}
+
+
+extern void {{fatal_error}}({{prefix_type}}ErrorId error_id);
+
+
+
+
+{{#timebase}}
+static void timebase_init(void);
+{{/timebase}}
+static uint32_t cycle_counter_get(void);
+static void timer_oneshot({{prefix_type}}TimerId timer_id, {{prefix_type}}TicksRelative timeout);
+static {{prefix_type}}TaskId get_current_task(void);
+
+
+{{#timebase}}
+static volatile struct timebase_clock timebase_clock;
+/*
+ * Tasks publish a new total step by writing the slot that the step sequence number does not select and then
+ * incrementing it, so that the tick interrupt handler never reads a partially written total
+ */
+static volatile struct timebase_step timebase_steps[2];
+static volatile uint32_t timebase_step_sequence;
+static volatile int32_t timebase_adjustment;
+/* Only the tick interrupt handler accesses the following */
+static int32_t timebase_applied_adjustment;
+static uint64_t timebase_cycles_per_nanosecond;
+static uint32_t timebase_reload;
+{{/timebase}}
+static {{prefix_type}}TaskId current_task;
+static void (*interrupt_ptr)(void);
+static const {{prefix_type}}TimerId task_timers[{{tasks.length}}] = {
+{{#tasks}}
+    {{idx}},
+{{/tasks}}
+};
+{{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+uint32_t pub_cycles;
+uint32_t pub_ticks;
+{{prefix_type}}TimerId pub_oneshot_timer;
+{{prefix_type}}TicksRelative pub_oneshot_timeout;
+uint8_t pub_waits;
+{{prefix_type}}ErrorId pub_fatal_error_id;
+
+{{#api_asserts}}
+#define api_error(error_id) {{fatal_error}}(error_id)
+{{/api_asserts}}
+{{^api_asserts}}
+#define api_error(error_id) do { } while(0)
+{{/api_asserts}}
+{{#api_asserts}}
+#define api_assert(expression, error_id) do { if (!(expression)) { api_error(error_id); } } while(0)
+{{/api_asserts}}
+{{^api_asserts}}
+#define api_assert(expression, error_id) do { } while(0)
+{{/api_asserts}}
+
+{{#internal_asserts}}
+#define internal_error(error_id) {{fatal_error}}(error_id)
+{{/internal_asserts}}
+{{^internal_asserts}}
+#define internal_error(error_id) do { } while(0)
+{{/internal_asserts}}
+{{#internal_asserts}}
+#define internal_assert(expression, error_id) do { if (!(expression)) { internal_error(error_id); } } while(0)
+{{/internal_asserts}}
+{{^internal_asserts}}
+#define internal_assert(expression, error_id) do { } while(0)
+{{/internal_asserts}}
+
+#define preempt_disable()
+#define preempt_enable()
+#define cycle_counter_init()
+#define assert_timer_valid(timer) api_assert((timer) <= {{prefix_const}}TASK_ID_MAX, ERROR_ID_INVALID_ID)
+#define signal_wait(requested_set) (pub_waits++)
+
+
+{{#timebase}}
+/*
+ * Advance a network time by the network time that elapses during the given number of cycles at the given rate.
+ * The fraction of a nanosecond that the network time reaches carries over between calls in 'fraction'.
+ * The multiplication is split into 32-bit halves of the rate, so that the product of up to 2^32 cycles does not
+ * overflow.
+ */
+static void
+timebase_advance({{prefix_type}}NetworkTime *const time, uint32_t *const fraction, const uint32_t cycles,
+                 const uint64_t rate)
+{
+    const uint64_t low = (uint64_t) cycles * (uint32_t) rate + *fraction;
+    uint64_t nanoseconds = (uint64_t) cycles * (uint32_t) (rate >> 32) + (low >> 32) + time->nanoseconds;
+
+    *fraction = (uint32_t) low;
+    /* loop bound: {{wrap_seconds}} */
+    while (nanoseconds >= TIMEBASE_NANOSECONDS_PER_SECOND)
+    {
+        nanoseconds -= TIMEBASE_NANOSECONDS_PER_SECOND;
+        time->seconds++;
+    }
+    time->nanoseconds = (uint32_t) nanoseconds;
+}
+
+/*
+ * Add a signed number of seconds and nanoseconds to a network time.
+ * The magnitude of the nanoseconds must be less than one second.
+ */
+static void
+timebase_add({{prefix_type}}NetworkTime *const time, const int32_t seconds, const int32_t nanoseconds)
+{
+    int32_t sum = (int32_t) time->nanoseconds + nanoseconds;
+
+    time->seconds += (uint32_t) seconds;
+    if (sum < 0)
+    {
+        sum += (int32_t) TIMEBASE_NANOSECONDS_PER_SECOND;
+        time->seconds--;
+    }
+    else if (sum >= (int32_t) TIMEBASE_NANOSECONDS_PER_SECOND)
+    {
+        sum -= (int32_t) TIMEBASE_NANOSECONDS_PER_SECOND;
+        time->seconds++;
+    }
+    time->nanoseconds = (uint32_t) sum;
+}
+
+/*
+ * Add the part of the requested total step that the clock does not include yet to a network time.
+ */
+static void
+timebase_add_step({{prefix_type}}NetworkTime *const time, const uint32_t step_sequence, const uint32_t step_seconds,
+                  const uint32_t step_nanoseconds)
+{
+    const volatile struct timebase_step *const step = &timebase_steps[step_sequence & 1U];
+
+    timebase_add(time, (int32_t) (step->seconds - step_seconds),
+                 (int32_t) step->nanoseconds - (int32_t) step_nanoseconds);
+}
+
+/*
+ * Take a consistent copy of the clock, including a step that the next tick is yet to apply, and return the number of
+ * cycles between the tick and the given cycle counter value, which may precede the tick.
+ * The copy is retried if a tick or a task that steps the network time interrupts it.
+ */
+static int32_t
+timebase_read(struct timebase_clock *const clock, {{prefix_type}}NetworkTime *const time, const uint32_t cycles)
+{
+    uint32_t sequence, step_sequence;
+
+    /* loop bound: retries */
+    do
+    {
+        sequence = timebase_clock.sequence;
+        step_sequence = timebase_step_sequence;
+        clock->ticks = timebase_clock.ticks;
+        clock->cycles = timebase_clock.cycles;
+        clock->fraction = timebase_clock.fraction;
+        clock->rate = timebase_clock.rate;
+        time->seconds = timebase_clock.seconds;
+        time->nanoseconds = timebase_clock.nanoseconds;
+        timebase_add_step(time, step_sequence, timebase_clock.step_seconds, timebase_clock.step_nanoseconds);
+    }
+    while (sequence != timebase_clock.sequence || step_sequence != timebase_step_sequence);
+
+    return (int32_t) (cycles - clock->cycles);
+}
+
+/*
+ * Convert a cycle counter value within half the range of the cycle counter of the most recent tick to network time.
+ */
+static void
+timebase_at(const uint32_t cycles, {{prefix_type}}NetworkTime *const time)
+{
+    struct timebase_clock clock;
+    const int32_t elapsed = timebase_read(&clock, time, cycles);
+
+    if (elapsed >= 0)
+    {
+        timebase_advance(time, &clock.fraction, (uint32_t) elapsed, clock.rate);
+    }
+    else
+    {
+        {{prefix_type}}NetworkTime before = { 0, 0 };
+
+        clock.fraction = 0;
+        timebase_advance(&before, &clock.fraction, (uint32_t) -elapsed, clock.rate);
+        timebase_add(time, -(int32_t) before.seconds, -(int32_t) before.nanoseconds);
+    }
+}
+
+/*
+ * Convert a network time to the relative number of ticks after which the RTOS processes the first tick at or after the
+ * network time.
+ * Network times in the past convert to the next tick the RTOS processes.
+ */
+static {{prefix_type}}TicksRelative
+timebase_ticks_until(const {{prefix_type}}NetworkTime *const time)
+{
+    struct timebase_clock clock;
+    {{prefix_type}}NetworkTime tick;
+    uint32_t seconds;
+    int32_t nanoseconds;
+    {{prefix_type}}TicksAbsolute ticks;
+
+    (void) timebase_read(&clock, &tick, cycle_counter_get());
+
+    seconds = time->seconds - tick.seconds;
+    nanoseconds = (int32_t) time->nanoseconds - (int32_t) tick.nanoseconds;
+    if (nanoseconds < 0)
+    {
+        nanoseconds += (int32_t) TIMEBASE_NANOSECONDS_PER_SECOND;
+        seconds--;
+    }
+
+    if ((int32_t) seconds < 0)
+    {
+        ticks = 0;
+    }
+    else if (seconds > TIMEBASE_SECONDS_MAX)
+    {
+        api_error(ERROR_ID_TIMEBASE_TIME_TOO_FAR);
+        ticks = TIMEBASE_SECONDS_MAX * TIMEBASE_TICKS_PER_SECOND;
+    }
+    else
+    {
+        ticks = seconds * TIMEBASE_TICKS_PER_SECOND +
+            ((uint32_t) nanoseconds + TIMEBASE_TICK_PERIOD - 1U) / TIMEBASE_TICK_PERIOD;
+    }
+
+    /* The tick interrupt handler may have counted ticks that the RTOS is yet to process */
+    return ({{prefix_type}}TicksRelative) (ticks + (clock.ticks - {{prefix_func}}timer_current_ticks));
+}
+
+static void
+timebase_init(void)
+{
+    cycle_counter_init();
+    timebase_clock.cycles = cycle_counter_get();
+    timebase_clock.rate = TIMEBASE_RATE;
+    timebase_cycles_per_nanosecond = TIMEBASE_CYCLES_PER_NANOSECOND;
+    timebase_reload = {{prefix_const}}TIMEBASE_TICK_CYCLES;
+}
+{{/timebase}}
+/*
+ * The interrupt, if one is set, occurs immediately after the cycle counter is read, so that the reader straddles it.
+ */
+static uint32_t
+cycle_counter_get(void)
+{
+    const uint32_t cycles = pub_cycles;
+    void (*const interrupt)(void) = interrupt_ptr;
+
+    if (interrupt != NULL)
+    {
+        interrupt_ptr = NULL;
+        interrupt();
+    }
+
+    return cycles;
+}
+
+static void
+timer_oneshot(const {{prefix_type}}TimerId timer_id, const {{prefix_type}}TicksRelative timeout)
+{
+    pub_oneshot_timer = timer_id;
+    pub_oneshot_timeout = timeout;
+}
+
+static {{prefix_type}}TaskId
+get_current_task(void)
+{
+    return current_task;
+}
+
+void
+test_fatal_error(const {{prefix_type}}ErrorId error_id)
+{
+    pub_fatal_error_id = error_id;
+}
+
+
+{{#timebase}}
+/*
+ * The tick interrupt handler calls this function at each tick, in place of timer_tick().
+ * The period that ends at the next tick is already loaded into the tick timer, so the returned reload value applies
+ * to the period after it.
+ * It is chosen so that the period ends at the multiple of the tick period that is nearest to one tick period after the
+ * next tick in network time, which keeps ticks aligned to network time while the network time is adjusted or stepped.
+ */
+uint32_t
+{{prefix_func}}timebase_tick(void)
+{
+    const uint32_t cycles = cycle_counter_get();
+    const int32_t adjustment = timebase_adjustment;
+    const uint32_t step_sequence = timebase_step_sequence;
+    {{prefix_type}}NetworkTime time;
+    uint32_t fraction = timebase_clock.fraction;
+    uint64_t rate = timebase_clock.rate;
+    uint32_t phase, period;
+
+    time.seconds = timebase_clock.seconds;
+    time.nanoseconds = timebase_clock.nanoseconds;
+    timebase_advance(&time, &fraction, cycles - timebase_clock.cycles, rate);
+
+    timebase_add_step(&time, step_sequence, timebase_clock.step_seconds, timebase_clock.step_nanoseconds);
+
+    /* The adjustment applies from this tick onwards, relative to the nominal rates */
+    if (adjustment != timebase_applied_adjustment)
+    {
+        rate = TIMEBASE_RATE + (uint64_t) ((adjustment * TIMEBASE_RATE_PER_PPB) >> 16);
+        timebase_cycles_per_nanosecond = TIMEBASE_CYCLES_PER_NANOSECOND -
+            (uint64_t) ((adjustment * TIMEBASE_CYCLES_PER_NANOSECOND_PER_PPB) >> 16);
+        timebase_applied_adjustment = adjustment;
+    }
+
+    timebase_clock.ticks++;
+    timebase_clock.cycles = cycles;
+    timebase_clock.seconds = time.seconds;
+    timebase_clock.nanoseconds = time.nanoseconds;
+    timebase_clock.fraction = fraction;
+    timebase_clock.rate = rate;
+    timebase_clock.step_seconds = timebase_steps[step_sequence & 1U].seconds;
+    timebase_clock.step_nanoseconds = timebase_steps[step_sequence & 1U].nanoseconds;
+    timebase_clock.sequence++;
+
+    /* Predict the network time of the next tick, and end the following period at a multiple of the tick period */
+    timebase_advance(&time, &fraction, timebase_reload, rate);
+    phase = time.nanoseconds % TIMEBASE_TICK_PERIOD;
+    period = (phase < TIMEBASE_TICK_PERIOD / 2U ? 1U : 2U) * TIMEBASE_TICK_PERIOD - phase;
+    timebase_reload = (uint32_t) (((uint64_t) period * timebase_cycles_per_nanosecond) >> 32);
+
+    {{prefix_func}}timer_tick();
+
+    return timebase_reload;
+}
+
+uint32_t
+{{prefix_func}}timebase_cycles(void)
+{
+    return cycle_counter_get();
+}
+
+void
+{{prefix_func}}timebase_now({{prefix_type}}NetworkTime *const time)
+{
+    timebase_at(cycle_counter_get(), time);
+}
+
+void
+{{prefix_func}}timebase_from_cycles(const uint32_t cycles, {{prefix_type}}NetworkTime *const time)
+{
+    timebase_at(cycles, time);
+}
+
+void
+{{prefix_func}}timebase_set(const {{prefix_type}}NetworkTime *const time)
+{
+    {{prefix_type}}NetworkTime now, total;
+    uint32_t step_sequence;
+
+    preempt_disable();
+
+    /*
+     * Only tasks publish steps, so the total does not change while preemption is disabled.
+     * The current network time includes it, whether or not a tick has applied it to the clock, so the new total
+     * differs from it by the difference between the requested and the current network time.
+     */
+    step_sequence = timebase_step_sequence;
+    timebase_at(cycle_counter_get(), &now);
+    total.seconds = timebase_steps[step_sequence & 1U].seconds;
+    total.nanoseconds = timebase_steps[step_sequence & 1U].nanoseconds;
+    timebase_add(&total, (int32_t) (time->seconds - now.seconds),
+                 (int32_t) time->nanoseconds - (int32_t) now.nanoseconds);
+
+    timebase_steps[(step_sequence + 1U) & 1U].seconds = total.seconds;
+    timebase_steps[(step_sequence + 1U) & 1U].nanoseconds = total.nanoseconds;
+    timebase_step_sequence = step_sequence + 1U;
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}timebase_adjust(const int32_t ppb)
+{
+    if (ppb > TIMEBASE_ADJUSTMENT_MAX)
+    {
+        timebase_adjustment = TIMEBASE_ADJUSTMENT_MAX;
+    }
+    else if (ppb < -TIMEBASE_ADJUSTMENT_MAX)
+    {
+        timebase_adjustment = -TIMEBASE_ADJUSTMENT_MAX;
+    }
+    else
+    {
+        timebase_adjustment = ppb;
+    }
+}
+
+void
+{{prefix_func}}timer_oneshot_at(const {{prefix_type}}TimerId timer_id, const {{prefix_type}}NetworkTime *const time)
+{
+    assert_timer_valid(timer_id);
+
+    preempt_disable();
+
+    timer_oneshot(timer_id, timebase_ticks_until(time));
+
+    preempt_enable();
+}
+
+void
+{{prefix_func}}sleep_until(const {{prefix_type}}NetworkTime *const time) {{prefix_const}}REENTRANT
+{
+    preempt_disable();
+
+    timer_oneshot(task_timers[get_current_task()], timebase_ticks_until(time));
+    signal_wait({{prefix_const}}SIGNAL_ID__TASK_TIMER);
+
+    preempt_enable();
+}
+{{/timebase}}
+void
+{{prefix_func}}timer_tick(void)
+{
+    pub_ticks++;
+}
+
+void
+pub_timebase_init(void)
+{
+    /* For testing purposes, the network time, steps and adjustment are reset, too */
+    timebase_clock.sequence = 0;
+    timebase_clock.ticks = 0;
+    timebase_clock.seconds = 0;
+    timebase_clock.nanoseconds = 0;
+    timebase_clock.fraction = 0;
+    timebase_clock.step_seconds = 0;
+    timebase_clock.step_nanoseconds = 0;
+    timebase_steps[0].seconds = 0;
+    timebase_steps[0].nanoseconds = 0;
+    timebase_steps[1].seconds = 0;
+    timebase_steps[1].nanoseconds = 0;
+    timebase_step_sequence = 0;
+    timebase_adjustment = 0;
+    timebase_applied_adjustment = 0;
+
+    current_task = {{prefix_const}}TASK_ID_ZERO;
+    interrupt_ptr = NULL;
+    {{prefix_func}}timer_current_ticks = 0;
+    pub_cycles = 0;
+    pub_ticks = 0;
+    pub_oneshot_timer = 0;
+    pub_oneshot_timeout = 0;
+    pub_waits = 0;
+    pub_fatal_error_id = ERROR_ID_NONE;
+
+    timebase_init();
+}
+
+void
+pub_set_current_task(const {{prefix_type}}TaskId task_id)
+{
+    current_task = task_id;
+}
+
+void
+pub_set_interrupt_ptr(void (*y)(void))
+{
+    interrupt_ptr = y;
+}
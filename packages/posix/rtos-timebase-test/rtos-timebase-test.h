@@ -0,0 +1,62 @@
+#ifndef RTOS_TIMEBASE_TEST_H
+#define RTOS_TIMEBASE_TEST_H
+
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+
+typedef uint8_t {{prefix_type}}ErrorId;
+
+typedef uint8_t {{prefix_type}}TaskId;
+typedef uint8_t {{prefix_type}}TimerId;
+typedef uint{{ticksrelative_size}}_t {{prefix_type}}TicksRelative;
+typedef uint32_t {{prefix_type}}TicksAbsolute;
+
+
+{{#timebase}}
+/* A network time, e.g., a PTP timestamp, in seconds and nanoseconds since the epoch of the network's time scale */
+typedef struct {
+    uint32_t seconds;
+    uint32_t nanoseconds;
+} {{prefix_type}}NetworkTime;
+{{/timebase}}
+
+#define {{prefix_const}}REENTRANT {{reentrant}}
+
+{{#timebase}}
+#define {{prefix_const}}TIMEBASE_TICK_CYCLES UINT32_C({{tick_cycles}})
+{{/timebase}}
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+
+
+
+
+
+
+
+extern {{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+{{#timebase}}
+uint32_t {{prefix_func}}timebase_tick(void);
+uint32_t {{prefix_func}}timebase_cycles(void);
+void {{prefix_func}}timebase_now({{prefix_type}}NetworkTime *time);
+void {{prefix_func}}timebase_from_cycles(uint32_t cycles, {{prefix_type}}NetworkTime *time);
+void {{prefix_func}}timebase_set(const {{prefix_type}}NetworkTime *time);
+void {{prefix_func}}timebase_adjust(int32_t ppb);
+void {{prefix_func}}timer_oneshot_at({{prefix_type}}TimerId timer_id, const {{prefix_type}}NetworkTime *time);
+void {{prefix_func}}sleep_until(const {{prefix_type}}NetworkTime *time) {{prefix_const}}REENTRANT;
+{{/timebase}}
+void {{prefix_func}}timer_tick(void);
+void pub_timebase_init(void);
+void pub_set_current_task({{prefix_type}}TaskId task_id);
+void pub_set_interrupt_ptr(void (*y)(void));
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_TIMEBASE_TEST_H */
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef RTOS_TIMER_TEST_H
+#define RTOS_TIMER_TEST_H
+
+#include <stdint.h>
+#include <stdint.h>
+
+typedef uint{{timerid_size}}_t {{prefix_type}}TimerId;
+typedef uint32_t {{prefix_type}}TicksAbsolute;
+typedef uint{{ticksrelative_size}}_t {{prefix_type}}TicksRelative;
+typedef uint8_t {{prefix_type}}TaskId;
+typedef uint8_t {{prefix_type}}SignalId;
+typedef uint8_t {{prefix_type}}SignalSet;
+typedef uint8_t {{prefix_type}}ErrorId;
+
+{{#periodic_tasks.length}}
+/* The timing statistics of the completed jobs of a periodic task, in ticks.
+ * The averages are the totals divided by the number of jobs. */
+typedef struct {
+    uint32_t jobs;
+    uint32_t deadline_misses;
+    uint32_t jitter_total;
+    uint32_t response_total;
+    {{prefix_type}}TicksRelative jitter_min;
+    {{prefix_type}}TicksRelative jitter_max;
+    {{prefix_type}}TicksRelative response_min;
+    {{prefix_type}}TicksRelative response_max;
+} {{prefix_type}}PeriodicStats;
+{{/periodic_tasks.length}}
+
+#define {{prefix_const}}REENTRANT {{reentrant}}
+{{#timers}}
+#define {{prefix_const}}TIMER_ID_{{name|u}} (({{prefix_type}}TimerId) UINT{{timerid_size}}_C({{idx}}))
+{{/timers}}
+
+{{#periodic_tasks.length}}
+#define {{prefix_const}}PERIODIC_STATS_INIT \
+    { 0, 0, 0, 0, UINT{{ticksrelative_size}}_MAX, 0, UINT{{ticksrelative_size}}_MAX, 0 }
+{{/periodic_tasks.length}}
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+{{#tasks}}
+#define {{prefix_const}}TASK_ID_{{name|u}} (({{prefix_type}}TaskId) UINT8_C({{idx}}))
+{{/tasks}}
+#define {{prefix_const}}SIGNAL_SET_EMPTY (({{prefix_type}}SignalSet) UINT8_C(0))
+{{#signal_labels}}
+#define {{prefix_const}}SIGNAL_ID_{{name|u}} (({{prefix_type}}SignalId) UINT8_C({{idx}}))
+#define {{prefix_const}}SIGNAL_SET_{{name|u}} (({{prefix_type}}SignalSet) UINT8_C(1U << {{idx}}))
+{{/signal_labels}}
+
+
+
+
+extern {{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+{{#periodic_tasks.length}}
+extern {{prefix_type}}PeriodicStats {{prefix_func}}periodic_stats[{{periodic_tasks.length}}];
+{{/periodic_tasks.length}}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void {{prefix_func}}sleep({{prefix_type}}TicksRelative ticks) {{prefix_const}}REENTRANT;
+{{#timers.length}}
+void {{prefix_func}}timer_enable({{prefix_type}}TimerId timer_id);
+void {{prefix_func}}timer_disable({{prefix_type}}TimerId timer_id);
+void {{prefix_func}}timer_oneshot({{prefix_type}}TimerId timer_id, {{prefix_type}}TicksRelative timeout);
+bool {{prefix_func}}timer_check_overflow({{prefix_type}}TimerId timer_id);
+{{prefix_type}}TicksRelative {{prefix_func}}timer_remaining({{prefix_type}}TimerId timer_id);
+void {{prefix_func}}timer_reload_set({{prefix_type}}TimerId timer_id, {{prefix_type}}TicksRelative reload);
+void {{prefix_func}}timer_error_set({{prefix_type}}TimerId timer_id, {{prefix_type}}ErrorId error_id);
+void {{prefix_func}}timer_signal_set({{prefix_type}}TimerId timer_id, {{prefix_type}}TaskId task_id, {{prefix_type}}SignalSet signal_set);
+{{/timers.length}}
+{{#periodic_tasks.length}}
+void {{prefix_func}}periodic_wait_next(void) {{prefix_const}}REENTRANT;
+void {{prefix_func}}periodic_stats_clear(void);
+{{/periodic_tasks.length}}
+void pub_tick(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_TIMER_TEST_H */
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef RTOS_WORK_QUEUE_TEST_H
+#define RTOS_WORK_QUEUE_TEST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef uint8_t {{prefix_type}}WorkQueueId;
+typedef void (*{{prefix_type}}WorkFunction)(void *context);
+typedef uint8_t {{prefix_type}}TaskId;
+typedef uint8_t {{prefix_type}}InterruptEventId;
+typedef uint8_t {{prefix_type}}SignalSet;
+
+
+
+#define {{prefix_const}}REENTRANT {{reentrant}}
+{{#work_queues}}
+#define {{prefix_const}}WORK_QUEUE_ID_{{name|u}} (({{prefix_type}}WorkQueueId) UINT8_C({{idx}}))
+{{/work_queues}}
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT8_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT8_C({{tasks.length}} - 1))
+{{#tasks}}
+#define {{prefix_const}}TASK_ID_{{name|u}} (({{prefix_type}}TaskId) UINT8_C({{idx}}))
+{{/tasks}}
+{{#interrupt_events}}
+#define {{prefix_const}}INTERRUPT_EVENT_ID_{{name|u}} (({{prefix_type}}InterruptEventId) UINT8_C({{idx}}))
+{{/interrupt_events}}
+#define {{prefix_const}}SIGNAL_SET__WORK (({{prefix_type}}SignalSet) UINT8_C(2))
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+{{#work_queues.length}}
+bool {{prefix_func}}work_queue_submit({{prefix_type}}WorkQueueId work_queue, {{prefix_type}}WorkFunction function,
+                                    void *context);
+bool {{prefix_func}}work_queue_submit_from_interrupt({{prefix_type}}WorkQueueId work_queue,
+                                                   {{prefix_type}}WorkFunction function, void *context);
+void {{prefix_func}}work_queue_worker({{prefix_type}}WorkQueueId work_queue) {{prefix_const}}REENTRANT;
+{{/work_queues.length}}
+void {{prefix_func}}interrupt_event_raise({{prefix_type}}InterruptEventId interrupt_event_id);
+{{prefix_type}}SignalSet {{prefix_func}}signal_wait_set({{prefix_type}}SignalSet requested_signals);
+void pub_work_queue_init(void);
+void pub_work_queue_set_position({{prefix_type}}WorkQueueId work_queue, uint32_t position);
+void pub_set_interrupt_ptr(void (*y)(void), uint32_t compare_and_swap_count);
+void pub_set_wait_ptr(bool (*y)(void));
+void pub_work_queue_run({{prefix_type}}WorkQueueId work_queue);
+void *pub_work_queue_dequeue({{prefix_type}}WorkQueueId work_queue);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_WORK_QUEUE_TEST_H */
\ No newline at end of file
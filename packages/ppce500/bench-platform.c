@@ -0,0 +1,93 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+/*
+ * Platform support for the rtos-bench systems.
+ *
+ * The bench clock is the lower 32 bits of the e500 time base.
+ *
+ * Preemptive systems measure interrupt handling with the decrementer, which bench_irq_trigger sets to expire
+ * immediately.
+ * Its handler is installed by the system as the vectable module's preempting decrementer handler.
+ *
+ * The ppce500 debug output goes nowhere, so the benchmark results are collected by a debugger stopping in
+ * bench_report and bench_done; see pylib/bench.py.
+ */
+
+#include <stdint.h>
+
+void
+bench_clock_init(void)
+{
+    /* Set HID0[TBEN] to enable the time base.
+     * A context-synchronising instruction is required before and after mtspr HID0 by the e500 Reference Manual. */
+    asm volatile(
+        "mfspr %%r3,1008\n"
+        "ori %%r3,%%r3,0x4000\n" /* 0x4000 = HID0[TBEN] */
+        "isync\n"
+        "mtspr 1008,%%r3\n"
+        "isync"
+        ::: "r3");
+}
+
+uint32_t
+bench_clock(void)
+{
+    uint32_t tbl;
+
+    asm volatile("mftb %0" : "=r" (tbl));
+
+    return tbl;
+}
+
+void
+bench_irq_trigger(void)
+{
+    /* Set TCR[DIE] to enable the decrementer interrupt, then let the (non auto-reloading) decrementer expire. */
+    asm volatile(
+        "mftcr %%r3\n"
+        "oris %%r3,%%r3,0x400\n" /* 0x4000000 = TCR[DIE] */
+        "mttcr %%r3\n"
+        "li %%r3,1\n"
+        "mtdec %%r3"
+        ::: "r3");
+}
+
+void
+bench_irq_clear(void)
+{
+    /* Write-1-to-clear TSR[DIS] (decrementer interrupt status) */
+    asm volatile(
+        "lis %%r3,0x800\n" /* 0x8000000 = TSR[DIS] */
+        "mttsr %%r3"
+        ::: "r3");
+}
+
+void
+bench_exit(void)
+{
+}
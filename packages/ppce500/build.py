@@ -25,36 +25,107 @@
 # @TAG(NICTA_AGPL)
 #
 
-from prj import execute
+from prj import execute, compile_cached, run_parallel, size_report, wcet_report, SystemBuildError
+import functools
 import os
 
 
+schema = {
+    'type': 'dict',
+    'name': 'module',
+    'dict_type': ([{'type': 'bool', 'name': 'gc_sections', 'default': 'false'},
+                   {'type': 'bool', 'name': 'lto', 'default': 'false'},
+                   {'type': 'bool', 'name': 'size_report', 'default': 'false'},
+                   {'type': 'bool', 'name': 'wcet_report', 'default': 'false'},
+                   {'type': 'int', 'name': 'wcet_retries', 'default': '2'},
+                   {'type': 'list', 'name': 'wcet_limits', 'default': [],
+                    'list_type': {'type': 'dict', 'name': 'limit',
+                                  'dict_type': ([{'type': 'string', 'name': 'entry_point'},
+                                                 {'type': 'int', 'name': 'instructions'}], [])}}], [])
+}
+
+
 def run(system, configuration=None):
-    return system_build(system)
+    return system_build(system, configuration)
 
 
-def system_build(system):
+def system_build(system, configuration):
     inc_path_args = ['-I%s' % i for i in system.include_paths]
     common_flags = ['-g3']
     a_flags = common_flags
-    c_flags = common_flags
+    c_flags = list(common_flags)
+    link_flags = ['-Map={}'.format(map_file(system))]
+
+    if configuration['gc_sections']:
+        # Place each function and object in its own section, so that the linker can discard the unreferenced ones.
+        c_flags += ['-ffunction-sections', '-fdata-sections']
+        link_flags += ['--gc-sections']
+    if configuration['lto']:
+        # Optimise the RTOS and the application as a single unit at link time.
+        # Link-time optimisation requires an optimisation level, which is otherwise not set for this target.
+        c_flags += ['-Os', '-flto']
+
+    # gcc options for the PowerPC e500
+    cpu_flags = ['-mcpu=8548', '-mfloat-gprs=double', '-meabi', '-mno-sdata', '-G', '0']
 
     # Compile all C files.
     c_obj_files = [os.path.join(system.output, os.path.basename(c.replace('.c', '.o'))) for c in system.c_files]
 
-    for c, o in zip(system.c_files, c_obj_files):
+    def compile_c(c, o):
         os.makedirs(os.path.dirname(o), exist_ok=True)
-        # gcc options for the PowerPC e500
-        execute(['powerpc-linux-gnu-gcc', '-mcpu=8548', '-mfloat-gprs=double', '-meabi', '-mno-sdata', '-G', '0',
-                '-ffreestanding', '-c', c, '-o', o, '-Wall', '-Werror'] +
-                c_flags + inc_path_args)
+        compile_cached(['powerpc-linux-gnu-gcc'] + cpu_flags +
+                       ['-ffreestanding', '-c', c, '-o', o, '-Wall', '-Werror'] + c_flags + inc_path_args,
+                       c, o, system.object_cache)
+
+    run_parallel(functools.partial(compile_c, c, o) for c, o in zip(system.c_files, c_obj_files))
 
     # Assemble all asm files.
     asm_obj_files = [os.path.join(system.output, os.path.basename(s.replace('.s', '.o'))) for s in system.asm_files]
-    for s, o in zip(system.asm_files, asm_obj_files):
+
+    def assemble(s, o):
         os.makedirs(os.path.dirname(o), exist_ok=True)
         execute(['powerpc-linux-gnu-as', '-me500', '-o', o, s] + a_flags + inc_path_args)
 
+    run_parallel(functools.partial(assemble, s, o) for s, o in zip(system.asm_files, asm_obj_files))
+
     # Perform final link
     obj_files = asm_obj_files + c_obj_files
-    execute(['powerpc-linux-gnu-ld', '-G', '0', '-T', system.linker_script, '-o', system.output_file] + obj_files)
+    if configuration['lto']:
+        # Link through the compiler driver so that it can run the link-time optimiser.
+        execute(['powerpc-linux-gnu-gcc'] + cpu_flags +
+                ['-ffreestanding', '-nostdlib', '-T', system.linker_script, '-o', system.output_file] + c_flags +
+                ['-Wl,-G,0'] + ['-Wl,' + flag for flag in link_flags] + obj_files)
+    else:
+        execute(['powerpc-linux-gnu-ld', '-G', '0', '-T', system.linker_script, '-o', system.output_file] +
+                link_flags + obj_files)
+
+    if configuration['size_report']:
+        print_size_report(system)
+    if configuration['wcet_report']:
+        print_wcet_report(system, configuration['wcet_limits'], configuration['wcet_retries'])
+
+
+def map_file(system):
+    return system.output_file + '.map'
+
+
+def print_size_report(system):
+    report = size_report(map_file(system))
+    with open(system.output_file + '.size', 'w') as f:
+        f.write(report)
+    print("Size of {} by file (bytes):".format(system.name))
+    print(report, end='')
+
+
+def print_wcet_report(system, limits, retries):
+    disassembly_file = system.output_file + '.dis'
+    with open(disassembly_file, 'w') as f:
+        execute(['powerpc-linux-gnu-objdump', '-d', '-l', '--no-show-raw-insn', system.output_file], stdout=f)
+    limits = [(limit['entry_point'], limit['instructions']) for limit in limits]
+    report, exceeded = wcet_report(disassembly_file, 'ppce500', limits, retries)
+    with open(system.output_file + '.wcet', 'w') as f:
+        f.write(report)
+    print("Worst-case instruction counts of {}:".format(system.name))
+    print(report, end='')
+    if exceeded:
+        raise SystemBuildError("Entry points exceed their WCET limits: {}".format(', '.join(exceeded)))
@@ -0,0 +1,256 @@
+#ifndef RTOS_PHACT_H
+#define RTOS_PHACT_H
+
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <stdint.h>
+
+{{#interrupt_events.length}}
+#include <stdint.h>
+{{/interrupt_events.length}}
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdint.h>
+#include <stdint.h>
+
+
+
+
+
+typedef uint{{signalset_size}}_t {{prefix_type}}SignalSet;
+typedef {{prefix_type}}SignalSet {{prefix_type}}SignalId;
+
+typedef uint{{timerid_size}}_t {{prefix_type}}TimerId;
+typedef uint32_t {{prefix_type}}TicksAbsolute;
+typedef uint{{ticksrelative_size}}_t {{prefix_type}}TicksRelative;
+
+{{#interrupt_events.length}}
+typedef uint{{interrupteventid_size}}_t {{prefix_type}}InterruptEventId;
+{{/interrupt_events.length}}
+
+typedef uint8_t {{prefix_type}}MutexId;
+typedef uint8_t {{prefix_type}}CondId;
+typedef uint8_t {{prefix_type}}SemId;
+typedef uint{{semaphore_value_size}}_t {{prefix_type}}SemValue;
+typedef uint8_t {{prefix_type}}PoolId;
+typedef uint8_t {{prefix_type}}ErrorId;
+typedef uint{{taskid_size}}_t {{prefix_type}}TaskId;
+
+
+
+
+
+
+
+{{#periodic_tasks.length}}
+/* The timing statistics of the completed jobs of a periodic task, in ticks.
+ * The averages are the totals divided by the number of jobs. */
+typedef struct {
+    uint32_t jobs;
+    uint32_t deadline_misses;
+    uint32_t jitter_total;
+    uint32_t response_total;
+    {{prefix_type}}TicksRelative jitter_min;
+    {{prefix_type}}TicksRelative jitter_max;
+    {{prefix_type}}TicksRelative response_min;
+    {{prefix_type}}TicksRelative response_max;
+} {{prefix_type}}PeriodicStats;
+{{/periodic_tasks.length}}
+
+
+
+
+
+
+
+
+
+
+#define {{prefix_const}}REENTRANT {{reentrant}}
+
+
+
+#define {{prefix_const}}SIGNAL_SET_EMPTY (({{prefix_type}}SignalSet) UINT{{signalset_size}}_C(0))
+#define {{prefix_const}}SIGNAL_SET_ALL (({{prefix_type}}SignalSet) UINT{{signalset_size}}_MAX)
+{{#signal_sets}}
+#define {{prefix_const}}SIGNAL_SET_{{name|u}} (({{prefix_type}}SignalSet) UINT{{signalset_size}}_C({{value}}))
+{{#singleton}}#define {{prefix_const}}SIGNAL_ID_{{name|u}} (({{prefix_type}}SignalId) {{prefix_const}}SIGNAL_SET_{{name|u}}){{/singleton}}
+{{/signal_sets}}
+
+{{#timers}}
+#define {{prefix_const}}TIMER_ID_{{name|u}} (({{prefix_type}}TimerId) UINT{{timerid_size}}_C({{idx}}))
+{{/timers}}
+
+{{#periodic_tasks.length}}
+#define {{prefix_const}}PERIODIC_STATS_INIT \
+    { 0, 0, 0, 0, UINT{{ticksrelative_size}}_MAX, 0, UINT{{ticksrelative_size}}_MAX, 0 }
+{{/periodic_tasks.length}}
+
+{{#interrupt_events}}
+#define {{prefix_const}}INTERRUPT_EVENT_ID_{{name|u}} (({{prefix_type}}InterruptEventId) UINT{{interrupteventid_size}}_C({{idx}}))
+{{/interrupt_events}}
+
+{{#mutexes.length}}
+#define {{prefix_const}}MUTEX_ID_ZERO (({{prefix_type}}MutexId) UINT8_C(0))
+#define {{prefix_const}}MUTEX_ID_MAX (({{prefix_type}}MutexId) UINT8_C({{mutexes.length}} - 1))
+{{#mutexes}}
+#define {{prefix_const}}MUTEX_ID_{{name|u}} (({{prefix_type}}MutexId) UINT8_C({{idx}}))
+{{/mutexes}}
+{{/mutexes.length}}
+{{#condition_variables.length}}
+#define {{prefix_const}}COND_ID_ZERO (({{prefix_type}}CondId) UINT8_C(0))
+#define {{prefix_const}}COND_ID_MAX (({{prefix_type}}CondId) UINT8_C({{condition_variables.length}} - 1))
+{{#condition_variables}}
+#define {{prefix_const}}COND_ID_{{name|u}} (({{prefix_type}}CondId) UINT8_C({{idx}}))
+{{/condition_variables}}
+{{/condition_variables.length}}
+#define {{prefix_const}}SEM_ID_ZERO (({{prefix_type}}SemId) UINT8_C(0))
+#define {{prefix_const}}SEM_ID_MAX (({{prefix_type}}SemId) UINT8_C({{semaphores.length}} - 1))
+{{#semaphores}}
+#define {{prefix_const}}SEM_ID_{{name|u}} (({{prefix_type}}SemId) UINT8_C({{idx}}))
+{{/semaphores}}
+{{#pools}}
+#define {{prefix_const}}POOL_ID_{{name|u}} (({{prefix_type}}PoolId) UINT8_C({{idx}}))
+{{/pools}}
+
+#define {{prefix_const}}TASK_ID_ZERO (({{prefix_type}}TaskId) UINT{{taskid_size}}_C(0))
+#define {{prefix_const}}TASK_ID_MAX (({{prefix_type}}TaskId)UINT{{taskid_size}}_C({{tasks.length}} - 1))
+{{#tasks}}
+#define {{prefix_const}}TASK_ID_{{name|u}} (({{prefix_type}}TaskId) UINT{{taskid_size}}_C({{idx}}))
+{{/tasks}}
+
+
+
+
+
+#define {{prefix_func}}signal_wait(requested_signal) \
+    (void) {{prefix_func}}signal_wait_set(requested_signal)
+
+#define {{prefix_func}}signal_poll(requested_signal) \
+    ({{prefix_func}}signal_poll_set(requested_signal) != {{prefix_const}}SIGNAL_SET_EMPTY)
+
+#define {{prefix_func}}signal_peek(requested_signal) \
+    ({{prefix_func}}signal_peek_set(requested_signal) != {{prefix_const}}SIGNAL_SET_EMPTY)
+
+#define {{prefix_func}}signal_send(task_id, signal) \
+    {{prefix_func}}signal_send_set(task_id, signal)
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+extern {{prefix_type}}TicksAbsolute {{prefix_func}}timer_current_ticks;
+{{#periodic_tasks.length}}
+extern {{prefix_type}}PeriodicStats {{prefix_func}}periodic_stats[{{periodic_tasks.length}}];
+{{/periodic_tasks.length}}
+
+
+
+{{#mutex.stats}}
+extern bool {{prefix_func}}mutex_stats_enabled;
+{{/mutex.stats}}
+
+
+
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+
+{{prefix_type}}SignalSet {{prefix_func}}signal_wait_set({{prefix_type}}SignalSet requested_signals) {{prefix_const}}REENTRANT;
+{{prefix_type}}SignalSet {{prefix_func}}signal_poll_set({{prefix_type}}SignalSet requested_signals);
+{{prefix_type}}SignalSet {{prefix_func}}signal_peek_set({{prefix_type}}SignalSet requested_signals);
+void {{prefix_func}}signal_send_set({{prefix_type}}TaskId task_id, {{prefix_type}}SignalSet signals);
+void {{prefix_func}}timer_tick(void);
+void {{prefix_func}}sleep({{prefix_type}}TicksRelative ticks) {{prefix_const}}REENTRANT;
+{{#timers.length}}
+void {{prefix_func}}timer_enable({{prefix_type}}TimerId timer_id);
+void {{prefix_func}}timer_disable({{prefix_type}}TimerId timer_id);
+void {{prefix_func}}timer_oneshot({{prefix_type}}TimerId timer_id, {{prefix_type}}TicksRelative timeout);
+bool {{prefix_func}}timer_check_overflow({{prefix_type}}TimerId timer_id);
+{{prefix_type}}TicksRelative {{prefix_func}}timer_remaining({{prefix_type}}TimerId timer_id);
+void {{prefix_func}}timer_reload_set({{prefix_type}}TimerId timer_id, {{prefix_type}}TicksRelative reload);
+void {{prefix_func}}timer_error_set({{prefix_type}}TimerId timer_id, {{prefix_type}}ErrorId error_id);
+void {{prefix_func}}timer_signal_set({{prefix_type}}TimerId timer_id, {{prefix_type}}TaskId task_id, {{prefix_type}}SignalSet signal_set);
+{{/timers.length}}
+{{#periodic_tasks.length}}
+void {{prefix_func}}periodic_wait_next(void) {{prefix_const}}REENTRANT;
+void {{prefix_func}}periodic_stats_clear(void);
+{{/periodic_tasks.length}}
+{{#interrupt_events.length}}
+void {{prefix_func}}interrupt_event_raise({{prefix_type}}InterruptEventId event);
+{{/interrupt_events.length}}
+
+
+{{#mutexes.length}}
+void {{prefix_func}}mutex_lock({{prefix_type}}MutexId) {{prefix_const}}REENTRANT;
+bool {{prefix_func}}mutex_lock_timeout({{prefix_type}}MutexId, {{prefix_type}}TicksRelative) {{prefix_const}}REENTRANT;
+bool {{prefix_func}}mutex_try_lock({{prefix_type}}MutexId);
+void {{prefix_func}}mutex_unlock({{prefix_type}}MutexId);
+bool {{prefix_func}}mutex_holder_is_current({{prefix_type}}MutexId);
+{{#mutex.stats}}
+void {{prefix_func}}mutex_stats_clear(void);
+{{/mutex.stats}}
+{{/mutexes.length}}
+{{#condition_variables.length}}
+void {{prefix_func}}cond_wait({{prefix_type}}CondId cond, {{prefix_type}}MutexId m) {{prefix_const}}REENTRANT;
+bool {{prefix_func}}cond_wait_timeout({{prefix_type}}CondId cond, {{prefix_type}}MutexId m,
+                                    {{prefix_type}}TicksRelative timeout) {{prefix_const}}REENTRANT;
+void {{prefix_func}}cond_signal({{prefix_type}}CondId cond);
+void {{prefix_func}}cond_broadcast({{prefix_type}}CondId cond);
+{{/condition_variables.length}}
+void {{prefix_func}}sem_post({{prefix_type}}SemId);
+bool {{prefix_func}}sem_try_wait({{prefix_type}}SemId);
+void {{prefix_func}}sem_wait({{prefix_type}}SemId) {{prefix_const}}REENTRANT;
+bool {{prefix_func}}sem_wait_timeout({{prefix_type}}SemId, {{prefix_type}}TicksRelative timeout)
+        {{prefix_const}}REENTRANT;
+{{#semaphore_enable_max}}
+void {{prefix_func}}sem_max_init({{prefix_type}}SemId s, {{prefix_type}}SemValue max);
+{{/semaphore_enable_max}}
+{{#pools.length}}
+void *{{prefix_func}}pool_alloc({{prefix_type}}PoolId pool);
+void *{{prefix_func}}pool_alloc_wait({{prefix_type}}PoolId pool) {{prefix_const}}REENTRANT;
+void *{{prefix_func}}pool_alloc_timeout({{prefix_type}}PoolId pool, {{prefix_type}}TicksRelative timeout)
+        {{prefix_const}}REENTRANT;
+void {{prefix_func}}pool_free({{prefix_type}}PoolId pool, void *block);
+void {{prefix_func}}pool_free_from_interrupt({{prefix_type}}PoolId pool, void *block);
+uint16_t {{prefix_func}}pool_high_water_mark({{prefix_type}}PoolId pool);
+{{/pools.length}}
+
+{{prefix_type}}TaskId {{prefix_func}}task_current(void);
+void {{prefix_func}}start(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTOS_PHACT_H */
\ No newline at end of file
@@ -0,0 +1,614 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+/*
+ * Kernel benchmarks shared by every RTOS variant.
+ *
+ * The system provides two tasks: 'main', which drives the benchmarks and
+ * takes the measurements, and 'helper', which is the other end of every
+ * context switch.
+ * On preemptive variants 'helper' must have the higher priority.
+ *
+ * Each result is printed on a single line:
+ *
+ *   bench: <name> <param> <iterations> <elapsed>
+ *
+ * with the numeric fields in hexadecimal and 'elapsed' in units of the platform's bench clock.
+ * The line 'bench: done' marks the end of the run.
+ * 'x.py bench' parses this output.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "rtos-{{variant}}.h"
+#include "debug.h"
+
+#define BENCH_ITERATIONS 1000
+
+/* Provided by the platform's bench-platform module. */
+extern void bench_clock_init(void);
+extern uint32_t bench_clock(void);
+extern void bench_exit(void);
+{{#preemptive}}
+extern void bench_irq_trigger(void);
+extern void bench_irq_clear(void);
+{{/preemptive}}
+
+{{#yield}}
+/* The phase tells the helper task what the main task is currently measuring.
+ * Only cooperative variants need this; on preemptive variants the helper runs only when it is signalled. */
+enum bench_phase {
+    BENCH_PHASE_YIELD,
+    BENCH_PHASE_MUTEX,
+    BENCH_PHASE_IRQ,
+    BENCH_PHASE_SERVER
+};
+
+static volatile enum bench_phase bench_phase;
+{{/yield}}
+{{#signals}}
+
+/* Requests handled by the helper task when it receives the 'bench' signal. */
+enum bench_command {
+    BENCH_COMMAND_PING,
+    BENCH_COMMAND_MUTEX,
+    BENCH_COMMAND_SEM,
+    BENCH_COMMAND_MSGQ
+};
+
+static volatile enum bench_command bench_command;
+{{/signals}}
+{{#message_queues}}
+static volatile RtosMessageQueueId bench_queue;
+static uint8_t bench_message_out[128];
+static uint8_t bench_message_in[128];
+{{/message_queues}}
+{{#signals}}
+static volatile uint32_t bench_wake;
+{{/signals}}
+{{#preemptive}}
+static volatile enum {
+    BENCH_IRQ_EVENT,
+    BENCH_IRQ_TICK
+} bench_irq_action;
+static volatile uint32_t bench_irq_count;
+{{/preemptive}}
+{{#irq_unblock}}
+static volatile uint32_t bench_wake;
+{{/irq_unblock}}
+
+{{#errors}}
+void
+fatal(const RtosErrorId error_id)
+{
+    debug_print("FATAL ERROR: ");
+    debug_printhex32(error_id);
+    debug_println("");
+    for (;;)
+    {
+    }
+}
+{{/errors}}
+
+static void
+bench_report(const char *const name, const uint32_t param, const uint32_t iterations, const uint32_t elapsed)
+{
+    debug_print("bench: ");
+    debug_print(name);
+    debug_print(" ");
+    debug_printhex32(param);
+    debug_print(" ");
+    debug_printhex32(iterations);
+    debug_print(" ");
+    debug_printhex32(elapsed);
+    debug_println("");
+}
+
+static void
+bench_done(void)
+{
+    debug_println("bench: done");
+    bench_exit();
+    for (;;)
+    {
+    }
+}
+{{#preemptive}}
+
+/* Handler for the platform's bench interrupt; the system installs it as a preempting handler. */
+bool
+bench_irq_handler(void)
+{
+    bench_irq_clear();
+    if (bench_irq_action == BENCH_IRQ_TICK)
+    {
+        rtos_timer_tick();
+    }
+    else
+    {
+        rtos_interrupt_event_raise(RTOS_INTERRUPT_EVENT_ID_BENCH);
+    }
+    bench_irq_count++;
+
+    return true;
+}
+
+/* Trigger the bench interrupt and return once its handler, and any task it woke, has run. */
+static void
+bench_irq_raise(void)
+{
+    const uint32_t count = bench_irq_count;
+
+    bench_irq_trigger();
+    while (bench_irq_count == count)
+    {
+    }
+}
+{{/preemptive}}
+{{#signals}}
+
+/* Hand a command to the helper task and return once it has been carried out.
+ * Returns the bench clock value taken immediately before the helper was signalled. */
+static uint32_t
+bench_request(const enum bench_command command)
+{
+    uint32_t start;
+
+    bench_command = command;
+    start = bench_clock();
+    rtos_signal_send(RTOS_TASK_ID_HELPER, RTOS_SIGNAL_ID_BENCH);
+{{^preemptive}}
+    (void) rtos_signal_wait(RTOS_SIGNAL_ID_BENCH);
+{{/preemptive}}
+
+    return start;
+}
+{{/signals}}
+
+static void
+bench_context_switch(void)
+{
+    uint32_t i;
+    uint32_t start;
+{{#preemptive}}
+    uint32_t request;
+    uint32_t latency = 0;
+{{/preemptive}}
+
+{{#yield_to}}
+    start = bench_clock();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        rtos_yield_to(RTOS_TASK_ID_HELPER);
+    }
+    bench_report("cswitch-yield-to", 0, 2 * BENCH_ITERATIONS, bench_clock() - start);
+{{/yield_to}}
+{{#yield}}
+    bench_phase = BENCH_PHASE_YIELD;
+    start = bench_clock();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        rtos_yield();
+    }
+    bench_report("cswitch-coop", 0, 2 * BENCH_ITERATIONS, bench_clock() - start);
+{{/yield}}
+{{#preemptive}}
+    start = bench_clock();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        request = bench_request(BENCH_COMMAND_PING);
+        latency += bench_wake - request;
+    }
+    bench_report("cswitch-preempt", 0, 2 * BENCH_ITERATIONS, bench_clock() - start);
+    bench_report("signal-wake", 0, BENCH_ITERATIONS, latency);
+{{/preemptive}}
+}
+{{#mutex}}
+
+static void
+bench_mutex(void)
+{
+    uint32_t i;
+    uint32_t start;
+    uint32_t elapsed = 0;
+
+    start = bench_clock();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        rtos_mutex_lock(RTOS_MUTEX_ID_BENCH);
+        rtos_mutex_unlock(RTOS_MUTEX_ID_BENCH);
+    }
+    bench_report("mutex-uncontended", 0, BENCH_ITERATIONS, bench_clock() - start);
+
+{{#preemptive}}
+    /* The helper preempts, finds the mutex held and blocks; unlocking hands the mutex over to it. */
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        start = bench_clock();
+        rtos_mutex_lock(RTOS_MUTEX_ID_BENCH);
+        (void) bench_request(BENCH_COMMAND_MUTEX);
+        rtos_mutex_unlock(RTOS_MUTEX_ID_BENCH);
+        elapsed += bench_clock() - start;
+    }
+{{/preemptive}}
+{{^preemptive}}
+    /* The helper attempts to take the mutex while it is held, then takes it once it has been released. */
+    bench_phase = BENCH_PHASE_MUTEX;
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        start = bench_clock();
+        rtos_mutex_lock(RTOS_MUTEX_ID_BENCH);
+        rtos_yield();
+        rtos_mutex_unlock(RTOS_MUTEX_ID_BENCH);
+        rtos_yield();
+        elapsed += bench_clock() - start;
+    }
+{{/preemptive}}
+    bench_report("mutex-contended", 0, BENCH_ITERATIONS, elapsed);
+}
+{{/mutex}}
+{{#signals}}
+{{^preemptive}}
+
+static void
+bench_signal(void)
+{
+    uint32_t i;
+    uint32_t start;
+    uint32_t request;
+    uint32_t latency = 0;
+
+    start = bench_clock();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        request = bench_request(BENCH_COMMAND_PING);
+        latency += bench_wake - request;
+    }
+    bench_report("signal-roundtrip", 0, BENCH_ITERATIONS, bench_clock() - start);
+    bench_report("signal-wake", 0, BENCH_ITERATIONS, latency);
+}
+{{/preemptive}}
+{{/signals}}
+{{#semaphores}}
+
+static void
+bench_sem(void)
+{
+    uint32_t i;
+    uint32_t start;
+
+    (void) bench_request(BENCH_COMMAND_SEM);
+    start = bench_clock();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        rtos_sem_post(RTOS_SEM_ID_PING);
+        rtos_sem_wait(RTOS_SEM_ID_PONG);
+    }
+    bench_report("sem-pingpong", 0, BENCH_ITERATIONS, bench_clock() - start);
+}
+{{/semaphores}}
+{{#message_queues}}
+
+static void
+bench_msgq_size(const RtosMessageQueueId queue, const uint32_t size)
+{
+    uint32_t i;
+    uint32_t start;
+
+    bench_queue = queue;
+    start = bench_clock();
+    rtos_signal_send(RTOS_TASK_ID_HELPER, RTOS_SIGNAL_ID_BENCH);
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        rtos_message_queue_put(queue, bench_message_out);
+    }
+    (void) rtos_signal_wait(RTOS_SIGNAL_ID_BENCH);
+    bench_report("msgq-throughput", size, BENCH_ITERATIONS, bench_clock() - start);
+}
+
+static void
+bench_msgq(void)
+{
+    bench_command = BENCH_COMMAND_MSGQ;
+    bench_msgq_size(RTOS_MESSAGE_QUEUE_ID_BENCH4, 4);
+    bench_msgq_size(RTOS_MESSAGE_QUEUE_ID_BENCH32, 32);
+    bench_msgq_size(RTOS_MESSAGE_QUEUE_ID_BENCH128, 128);
+}
+{{/message_queues}}
+{{#timers}}
+
+{{#preemptive}}
+/* Ticks are raised by the bench interrupt's handler. */
+{{/preemptive}}
+{{^preemptive}}
+/* Ticks are raised from task context and processed when the main task yields. */
+{{/preemptive}}
+/* None of the enabled timers comes close to expiring, so the measurement is the cost of processing a tick as a
+ * function of the number of timers that the kernel has to update. */
+static void
+bench_timer(void)
+{
+    static const uint32_t timer_counts[] = { 0, 1, 2, 4, 8 };
+    uint32_t c;
+    uint32_t i;
+    uint32_t start;
+
+{{#preemptive}}
+    bench_irq_action = BENCH_IRQ_TICK;
+{{/preemptive}}
+    for (c = 0; c < sizeof(timer_counts) / sizeof(timer_counts[0]); c++)
+    {
+        for (i = 0; i < timer_counts[c]; i++)
+        {
+            rtos_timer_reload_set((RtosTimerId) i, 60000);
+            rtos_timer_enable((RtosTimerId) i);
+        }
+
+        start = bench_clock();
+        for (i = 0; i < BENCH_ITERATIONS; i++)
+        {
+{{#preemptive}}
+            bench_irq_raise();
+{{/preemptive}}
+{{^preemptive}}
+            rtos_timer_tick();
+            rtos_yield();
+{{/preemptive}}
+        }
+        bench_report("timer-tick", timer_counts[c], BENCH_ITERATIONS, bench_clock() - start);
+
+        for (i = 0; i < timer_counts[c]; i++)
+        {
+            rtos_timer_disable((RtosTimerId) i);
+        }
+    }
+}
+{{/timers}}
+{{#irq_signal}}
+
+{{#preemptive}}
+/* The interrupt event is raised by the bench interrupt's handler; the latency runs from triggering the interrupt to
+ * the helper task waking. */
+{{/preemptive}}
+{{^preemptive}}
+/* The interrupt event is raised from task context and processed when the main task waits; the latency covers the
+ * kernel's event processing and the switch to the helper task, but not the hardware's exception entry. */
+{{/preemptive}}
+static void
+bench_irq(void)
+{
+    uint32_t i;
+    uint32_t start;
+    uint32_t latency = 0;
+
+    bench_command = BENCH_COMMAND_PING;
+{{#preemptive}}
+    bench_irq_action = BENCH_IRQ_EVENT;
+{{/preemptive}}
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        start = bench_clock();
+{{#preemptive}}
+        bench_irq_raise();
+{{/preemptive}}
+{{^preemptive}}
+        rtos_interrupt_event_raise(RTOS_INTERRUPT_EVENT_ID_BENCH);
+        (void) rtos_signal_wait(RTOS_SIGNAL_ID_BENCH);
+{{/preemptive}}
+        latency += bench_wake - start;
+    }
+    bench_report("irq-wake", 0, BENCH_ITERATIONS, latency);
+}
+{{/irq_signal}}
+{{#irq_unblock}}
+
+static void
+bench_irq(void)
+{
+    uint32_t i;
+    uint32_t start;
+    uint32_t latency = 0;
+
+    bench_phase = BENCH_PHASE_IRQ;
+    /* Let the helper move on to the new phase and block. */
+    rtos_yield();
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        start = bench_clock();
+        rtos_interrupt_event_raise(RTOS_INTERRUPT_EVENT_ID_HELPER);
+        rtos_yield();
+        latency += bench_wake - start;
+    }
+    bench_report("irq-wake", 0, BENCH_ITERATIONS, latency);
+}
+{{/irq_unblock}}
+
+void
+bench_main(void)
+{
+    bench_clock_init();
+    /* Tasks do not all start out runnable; make both of them runnable in whichever way the variant provides. */
+{{#task_start}}
+    rtos_task_start(RTOS_TASK_ID_HELPER);
+{{/task_start}}
+{{#unblock}}
+    rtos_unblock(RTOS_TASK_ID_MAIN);
+    rtos_unblock(RTOS_TASK_ID_HELPER);
+{{/unblock}}
+{{#signal_unblock}}
+    rtos_signal_send_set(RTOS_TASK_ID_MAIN, 0);
+    rtos_signal_send_set(RTOS_TASK_ID_HELPER, 0);
+{{/signal_unblock}}
+
+    bench_context_switch();
+{{#mutex}}
+    bench_mutex();
+{{/mutex}}
+{{#irq_unblock}}
+    bench_irq();
+{{/irq_unblock}}
+{{#signals}}
+{{^preemptive}}
+    /* Let the helper leave the mutex phase and wait for commands. */
+    bench_phase = BENCH_PHASE_SERVER;
+    rtos_yield();
+    bench_signal();
+{{/preemptive}}
+{{/signals}}
+{{#semaphores}}
+    bench_sem();
+{{/semaphores}}
+{{#message_queues}}
+    bench_msgq();
+{{/message_queues}}
+{{#timers}}
+    bench_timer();
+{{/timers}}
+{{#irq_signal}}
+    bench_irq();
+{{/irq_signal}}
+
+    bench_done();
+}
+
+{{#semaphores}}
+static void
+bench_helper_sem(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        rtos_sem_wait(RTOS_SEM_ID_PING);
+        rtos_sem_post(RTOS_SEM_ID_PONG);
+    }
+}
+
+{{/semaphores}}
+{{#message_queues}}
+static void
+bench_helper_msgq(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        rtos_message_queue_get(bench_queue, bench_message_in);
+    }
+}
+
+{{/message_queues}}
+void
+bench_helper(void)
+{
+{{#yield_to}}
+{{^yield}}
+    for (;;)
+    {
+        rtos_yield_to(RTOS_TASK_ID_MAIN);
+    }
+{{/yield}}
+{{/yield_to}}
+{{#yield}}
+    while (bench_phase == BENCH_PHASE_YIELD)
+    {
+        rtos_yield();
+    }
+{{/yield}}
+{{^preemptive}}
+{{#mutex}}
+    while (bench_phase == BENCH_PHASE_MUTEX)
+    {
+        rtos_mutex_lock(RTOS_MUTEX_ID_BENCH);
+        rtos_mutex_unlock(RTOS_MUTEX_ID_BENCH);
+        rtos_yield();
+    }
+{{/mutex}}
+{{/preemptive}}
+{{#irq_unblock}}
+    for (;;)
+    {
+        rtos_block();
+        bench_wake = bench_clock();
+    }
+{{/irq_unblock}}
+{{#signals}}
+    for (;;)
+    {
+        (void) rtos_signal_wait(RTOS_SIGNAL_ID_BENCH);
+        bench_wake = bench_clock();
+
+        switch (bench_command)
+        {
+        case BENCH_COMMAND_PING:
+            break;
+{{#mutex}}
+        case BENCH_COMMAND_MUTEX:
+            rtos_mutex_lock(RTOS_MUTEX_ID_BENCH);
+            rtos_mutex_unlock(RTOS_MUTEX_ID_BENCH);
+            break;
+{{/mutex}}
+{{#semaphores}}
+        case BENCH_COMMAND_SEM:
+            bench_helper_sem();
+            break;
+{{/semaphores}}
+{{#message_queues}}
+        case BENCH_COMMAND_MSGQ:
+            bench_helper_msgq();
+            break;
+{{/message_queues}}
+        default:
+            break;
+        }
+{{^preemptive}}
+
+        rtos_signal_send(RTOS_TASK_ID_MAIN, RTOS_SIGNAL_ID_BENCH);
+{{/preemptive}}
+    }
+{{/signals}}
+{{^yield_to}}
+{{^irq_unblock}}
+{{^signals}}
+    for (;;)
+    {
+        rtos_yield();
+    }
+{{/signals}}
+{{/irq_unblock}}
+{{/yield_to}}
+}
+
+int
+main(void)
+{
+    rtos_start();
+    for (;;)
+    {
+    }
+}
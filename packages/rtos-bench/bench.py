@@ -0,0 +1,57 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+from prj import Module
+
+
+class BenchModule(Module):
+    # The feature flags select which benchmarks are built.
+    # A system sets those that match the APIs provided by its RTOS variant.
+    xml_schema = """
+<schema>
+    <entry name="variant" type="c_ident" />
+    <entry name="errors" type="bool" default="false" />
+    <entry name="preemptive" type="bool" default="false" />
+    <entry name="yield_to" type="bool" default="false" />
+    <entry name="yield" type="bool" default="false" />
+    <entry name="task_start" type="bool" default="false" />
+    <entry name="unblock" type="bool" default="false" />
+    <entry name="signal_unblock" type="bool" default="false" />
+    <entry name="mutex" type="bool" default="false" />
+    <entry name="signals" type="bool" default="false" />
+    <entry name="semaphores" type="bool" default="false" />
+    <entry name="message_queues" type="bool" default="false" />
+    <entry name="timers" type="bool" default="false" />
+    <entry name="irq_unblock" type="bool" default="false" />
+    <entry name="irq_signal" type="bool" default="false" />
+</schema>"""
+
+    files = [
+        {'input': 'bench.c', 'render': True, 'type': 'c'},
+    ]
+
+module = BenchModule()
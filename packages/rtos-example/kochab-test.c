@@ -54,10 +54,19 @@ fatal(const RtosErrorId error_id)
     }
 }
 
+void
+budget_overrun(const RtosTaskId task)
+{
+    debug_print("BUDGET OVERRUN: ");
+    debug_printhex32(task);
+    debug_println("");
+}
+
 void
 fn_a(void)
 {
     uint8_t count;
+    void *block;
 
     debug_println("task a: taking lock");
     rtos_mutex_lock(RTOS_MUTEX_ID_M0);
@@ -68,6 +77,17 @@ fn_a(void)
     debug_println("task a: releasing lock");
     rtos_mutex_unlock(RTOS_MUTEX_ID_M0);
 
+    debug_println("task a: allocating buffer");
+    block = rtos_pool_alloc(RTOS_POOL_ID_BUFFERS);
+    if (block == NULL)
+    {
+        debug_println("unexpected pool empty.");
+    }
+    else
+    {
+        rtos_pool_free(RTOS_POOL_ID_BUFFERS, block);
+    }
+
     for (count = 0; count < 10; count++)
     {
         debug_println("task a");
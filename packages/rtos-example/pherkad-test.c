@@ -0,0 +1,110 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtos-pherkad.h"
+#include "machine-timer.h"
+#include "debug.h"
+
+bool
+tick_irq(void)
+{
+    machine_timer_clear();
+
+    rtos_timer_tick();
+
+    return true;
+}
+
+void
+fatal(const RtosErrorId error_id)
+{
+    debug_print("FATAL ERROR: ");
+    debug_printhex32(error_id);
+    debug_println("");
+    for (;;)
+    {
+    }
+}
+
+void
+fn_a(void)
+{
+    uint8_t count;
+
+    debug_println("task a: taking lock");
+    rtos_mutex_lock(RTOS_MUTEX_ID_M0);
+    debug_println("task a: releasing lock");
+    rtos_mutex_unlock(RTOS_MUTEX_ID_M0);
+
+    /* Task a is periodic with a deadline of 10 ticks, so it preempts task b whenever it is released */
+    for (count = 0; ; count++)
+    {
+        debug_print("task a: release ");
+        debug_printhex32(count);
+        debug_println("");
+        if (count % 5 == 0)
+        {
+            debug_println("unblocking b");
+            rtos_signal_send_set(RTOS_TASK_ID_B, RTOS_SIGNAL_SET_TEST);
+        }
+        rtos_release_wait();
+    }
+}
+
+void
+fn_b(void)
+{
+    debug_println("task b: attempting lock");
+    rtos_mutex_lock(RTOS_MUTEX_ID_M0);
+    debug_println("task b: got lock");
+    rtos_mutex_unlock(RTOS_MUTEX_ID_M0);
+
+    for (;;)
+    {
+        debug_println("task b blocking");
+        (void) rtos_signal_wait_set(RTOS_SIGNAL_SET_TEST);
+        /* Each event that task b handles has to be handled within 50 ticks */
+        rtos_deadline_set(50);
+        debug_println("task b unblocked");
+    }
+}
+
+int
+main(void)
+{
+    machine_timer_init();
+
+    debug_println("Starting RTOS");
+    rtos_start();
+    /* Should never reach here, but if we do, an infinite loop is
+       easier to debug than returning somewhere random. */
+    for (;;) ;
+}
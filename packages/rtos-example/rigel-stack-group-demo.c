@@ -0,0 +1,154 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtos-rigel.h"
+#include "debug.h"
+
+#define DEMO_ERROR_ID_TEST_FAIL 0xff
+/* The RTOS's error ID for a run-to-completion task that yields or blocks */
+#define DEMO_ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS 0x26
+
+/* The size in bytes of the stack that tasks C and D share, i.e., the larger of their stack sizes in the .prx file */
+#define DEMO_HANDLERS_STACK_BYTES (256 * sizeof(uint32_t))
+#define DEMO_MAX_ACTIVATIONS 4
+
+#define DEMO_FAIL_IF(cond, fail_str) \
+    if (cond) { \
+        debug_println(fail_str); \
+        fatal(DEMO_ERROR_ID_TEST_FAIL); \
+    }
+#define DEMO_FAIL_UNLESS(cond, fail_str) DEMO_FAIL_IF(!(cond), fail_str)
+
+/* The run-to-completion tasks in the order of their activations, and the location of their stack frames */
+static RtosTaskId demo_activations[DEMO_MAX_ACTIVATIONS];
+static uintptr_t demo_frames[DEMO_MAX_ACTIVATIONS];
+static uint8_t demo_activation_count;
+static bool demo_d_blocks;
+
+void
+fatal(const RtosErrorId error_id)
+{
+    debug_print("FATAL ERROR: ");
+    debug_printhex32(error_id);
+    debug_println("");
+    if (error_id == DEMO_ERROR_ID_RUN_TO_COMPLETION_TASK_YIELDS && demo_d_blocks)
+    {
+        debug_println("demo: the RTOS rejected the blocking call of d as expected");
+    }
+    for (;;)
+    {
+    }
+}
+
+static void
+demo_activated(const RtosTaskId task, const volatile uint8_t *const frame)
+{
+    DEMO_FAIL_UNLESS(rtos_task_current() == task, "demo: wrong current task!");
+    DEMO_FAIL_UNLESS(demo_activation_count < DEMO_MAX_ACTIVATIONS, "demo: too many activations!");
+    demo_activations[demo_activation_count] = task;
+    demo_frames[demo_activation_count] = (uintptr_t) frame;
+    demo_activation_count++;
+}
+
+void
+fn_a(void)
+{
+    uintptr_t distance;
+
+    /* Rigel does not preempt task A, so the run-to-completion tasks only run once A yields */
+    debug_println("a: starting d, then c");
+    rtos_task_start(RTOS_TASK_ID_D);
+    rtos_task_start(RTOS_TASK_ID_C);
+    DEMO_FAIL_UNLESS(demo_activation_count == 0, "a: run-to-completion tasks ran before a yielded!");
+    rtos_yield();
+
+    /* The scheduler selects C and D in its round-robin order after A rather than in the order they were started.
+     * Each runs to completion before the other starts, so that both frames are on the same shared stack. */
+    DEMO_FAIL_UNLESS(demo_activation_count == 2, "a: c and d did not run exactly once each!");
+    DEMO_FAIL_UNLESS(demo_activations[0] == RTOS_TASK_ID_C && demo_activations[1] == RTOS_TASK_ID_D,
+            "a: c and d ran out of order!");
+    distance = demo_frames[0] > demo_frames[1] ? demo_frames[0] - demo_frames[1] : demo_frames[1] - demo_frames[0];
+    DEMO_FAIL_UNLESS(distance < DEMO_HANDLERS_STACK_BYTES, "a: c and d did not run on the same stack!");
+    debug_println("a: c and d ran to completion in order on their shared stack");
+
+    /* Start signals that a run-to-completion task receives before it runs activate it only once */
+    debug_println("a: starting c twice");
+    rtos_task_start(RTOS_TASK_ID_C);
+    rtos_task_start(RTOS_TASK_ID_C);
+    rtos_yield();
+    DEMO_FAIL_UNLESS(demo_activation_count == 3 && demo_activations[2] == RTOS_TASK_ID_C,
+            "a: c did not run exactly once!");
+    debug_println("a: c ran once");
+
+    /* A run-to-completion task must not block, because it would leave its frames on the shared stack */
+    debug_println("a: starting d, which blocks");
+    demo_d_blocks = true;
+    rtos_task_start(RTOS_TASK_ID_D);
+    rtos_yield();
+
+    debug_println("a: shouldn't be here!");
+    fatal(DEMO_ERROR_ID_TEST_FAIL);
+}
+
+void
+fn_c(void)
+{
+    volatile uint8_t frame;
+
+    debug_println("c: activated");
+    demo_activated(RTOS_TASK_ID_C, &frame);
+}
+
+void
+fn_d(void)
+{
+    volatile uint8_t frame;
+
+    debug_println("d: activated");
+    demo_activated(RTOS_TASK_ID_D, &frame);
+
+    if (demo_d_blocks)
+    {
+        debug_println("d: sleeping, which the RTOS should reject");
+        rtos_sleep(1);
+        debug_println("d: shouldn't be here!");
+        fatal(DEMO_ERROR_ID_TEST_FAIL);
+    }
+}
+
+int
+main(void)
+{
+    debug_println("Starting RTOS");
+    rtos_start();
+    /* Should never reach here, but if we do, an infinite loop is
+       easier to debug than returning somewhere random. */
+    for (;;) ;
+}
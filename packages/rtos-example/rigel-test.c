@@ -161,6 +161,20 @@ fn_b(void)
     }
 }
 
+/* The run-to-completion tasks c and d are only configured in systems with a stack group.
+ * See rigel-stack-group-demo.c for a system that exercises them. */
+void
+fn_c(void)
+{
+    debug_println("task c: activated");
+}
+
+void
+fn_d(void)
+{
+    debug_println("task d: activated");
+}
+
 int
 main(void)
 {
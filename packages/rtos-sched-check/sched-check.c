@@ -0,0 +1,616 @@
+/*
+ * eChronos Real-Time Operating System
+ * Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, version 3, provided that these additional
+ * terms apply under section 7:
+ *
+ *   No right, title or interest in or to any trade mark, service mark, logo
+ *   or trade name of of National ICT Australia Limited, ABN 62 102 206 173
+ *   ("NICTA") or its licensors is granted. Modified versions of the Program
+ *   must be plainly marked as such, and must not be distributed using
+ *   "eChronos" as a trade mark or product name, or misrepresented as being
+ *   the original Program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @TAG(NICTA_AGPL)
+ */
+
+
+/*
+ * Scheduler equivalence checker.
+ *
+ * The system links this file with a scheduler test module (e.g. posix.rtos-sched-rr-test) into a native executable.
+ * It drives the generated scheduler through its pub_sched_* functions and mirrors every operation on a
+ * straightforward reference model of the scheduling policy, comparing the task selected by both after each step.
+ *
+ * The check runs in two phases:
+ *
+ *  - An exhaustive phase enumerates every combination of task states of 'exhaustive_tasks' tasks, half of them taken
+ *    from the start and half from the end of the task array so that the combinations straddle bitmap words and wrap
+ *    around in round-robin order.
+ *    All other tasks are blocked.
+ *    A task's state is runnable, blocked, or (with priority inheritance) blocked on each of the other tasks and (with
+ *    EDF) combined with one of a small set of deadlines, so that deadlines tie.
+ *    States with cycles of tasks blocked on each other are skipped, as the mutex layer never creates them.
+ *    Each combination is checked from every position the history of selections can leave the scheduler in with
+ *    respect to the enumerated tasks: after each of them for round-robin, and with each combination of offsets of
+ *    the priority levels containing them for prio_inherit_rr.
+ *    The scheduler is moved to a position by selecting a single runnable task before the combination is applied.
+ *  - A randomized phase then applies 'samples' random operations to all tasks.
+ *
+ * The remaining time slice state is not enumerated but carried over from one state to the next, and each state is
+ * checked with several consecutive selections.
+ *
+ * The executable prints the number of states checked per second for each phase and exits with status 1 on the first
+ * mismatch, after printing the state it occurred in.
+ * 'x.py test sched-check' builds and runs all such systems.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define TASKS {{tasks}}U
+#define EXHAUSTIVE_TASKS {{exhaustive_tasks}}U
+#define SAMPLES {{samples}}UL
+#define TASK_NONE ((TaskId) UINT8_MAX)
+{{#blocked_on}}
+/* Runnable, blocked, or blocked on one of the other exhaustive tasks */
+#define STATE_CHOICES (EXHAUSTIVE_TASKS + 1U)
+{{/blocked_on}}
+{{^blocked_on}}
+/* Runnable or blocked */
+#define STATE_CHOICES 2U
+{{/blocked_on}}
+{{#edf}}
+#define DEADLINE_CHOICES 3U
+#define DEADLINE_WINDOW (4U * TASKS)
+{{/edf}}
+{{^edf}}
+#define DEADLINE_CHOICES 1U
+{{/edf}}
+{{#prio_inherit_rr}}
+#define LEVEL_SIZE {{level_size}}U
+#define LEVELS {{levels}}U
+#define TIME_SLICE {{time_slice}}U
+{{/prio_inherit_rr}}
+
+typedef uint8_t TaskId;
+
+/* Provided by the scheduler test module */
+extern void pub_sched_set_runnable(TaskId task_id);
+extern void pub_sched_set_blocked(TaskId task_id);
+{{#blocked_on}}
+extern void pub_sched_set_blocked_on(TaskId task_id, TaskId blocked_on);
+{{/blocked_on}}
+{{#edf}}
+extern void pub_sched_set_deadline(TaskId task_id, uint32_t deadline);
+{{/edf}}
+extern TaskId pub_sched_get_next(void);
+{{#prio_inherit_rr}}
+extern bool pub_sched_time_slice_tick(void);
+{{/prio_inherit_rr}}
+
+/* The reference model. Each task is blocked on itself when runnable and on TASK_NONE when blocked. */
+static TaskId ref_blocked_on[TASKS];
+{{#rr}}
+static TaskId ref_cur;
+{{/rr}}
+{{#edf}}
+static uint32_t ref_deadlines[TASKS];
+{{/edf}}
+{{#prio_inherit_rr}}
+/* Like the scheduler's, the time slice state starts out zeroed rather than with no task selected */
+static TaskId ref_level_offsets[LEVELS];
+static TaskId ref_slice_task;
+static TaskId ref_slice_level;
+static uint32_t ref_slice_remaining;
+{{/prio_inherit_rr}}
+
+static uint32_t random_state = {{seed}}U;
+static unsigned long states;
+
+static uint32_t
+random_next(void)
+{
+    /* xorshift32 */
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+{{#blocked_on}}
+/* Follow the chain of tasks the given task is blocked on; returns the runnable task at its end or TASK_NONE. */
+static TaskId
+ref_resolve(TaskId task_id)
+{
+    while (task_id != TASK_NONE && ref_blocked_on[task_id] != task_id)
+    {
+        task_id = ref_blocked_on[task_id];
+    }
+    return task_id;
+}
+
+{{/blocked_on}}
+{{#edf}}
+static bool
+ref_before(const TaskId task_a, const TaskId task_b)
+{
+    const int32_t difference = (int32_t) (ref_deadlines[task_a] - ref_deadlines[task_b]);
+
+    return difference < 0 || (difference == 0 && task_a < task_b);
+}
+
+{{/edf}}
+{{#prio_inherit_rr}}
+static TaskId
+ref_level_size(const TaskId level)
+{
+    return (level + 1U) * LEVEL_SIZE <= TASKS ? LEVEL_SIZE : TASKS - level * LEVEL_SIZE;
+}
+
+{{/prio_inherit_rr}}
+static TaskId
+ref_get_next(void)
+{
+{{#rr}}
+    /* The first runnable task after the current one, wrapping around and ending with the current one */
+    TaskId count;
+
+    for (count = 0; count < TASKS; count++)
+    {
+        ref_cur = ref_cur == TASKS - 1U ? 0 : ref_cur + 1U;
+        if (ref_blocked_on[ref_cur] == ref_cur)
+        {
+            return ref_cur;
+        }
+    }
+    ref_cur = TASKS - 1U;
+    return TASK_NONE;
+{{/rr}}
+{{#prio}}
+    /* The runnable task with the lowest index, i.e., the highest priority */
+    TaskId task_id;
+
+    for (task_id = 0; task_id < TASKS; task_id++)
+    {
+        if (ref_blocked_on[task_id] == task_id)
+        {
+            return task_id;
+        }
+    }
+    return TASK_NONE;
+{{/prio}}
+{{#prio_inherit}}
+    /* The end of the blocked-on chain of the highest priority task whose chain ends in a runnable task */
+    TaskId task_id;
+
+    for (task_id = 0; task_id < TASKS; task_id++)
+    {
+        if (ref_resolve(task_id) != TASK_NONE)
+        {
+            return ref_resolve(task_id);
+        }
+    }
+    return TASK_NONE;
+{{/prio_inherit}}
+{{#prio_inherit_rr}}
+    /*
+     * As for prio_inherit, but within a priority level the search starts at the task last selected from that level.
+     * A newly selected task starts a new time slice.
+     */
+    TaskId level, offset, count, task_id;
+
+    for (level = 0; level < LEVELS; level++)
+    {
+        offset = ref_level_offsets[level];
+        for (count = 0; count < ref_level_size(level); count++)
+        {
+            task_id = ref_resolve(level * LEVEL_SIZE + offset);
+            if (task_id != TASK_NONE)
+            {
+                ref_level_offsets[level] = offset;
+                if (task_id != ref_slice_task)
+                {
+                    ref_slice_task = task_id;
+                    ref_slice_level = level;
+                    ref_slice_remaining = TIME_SLICE;
+                }
+                return task_id;
+            }
+            offset = offset + 1U == ref_level_size(level) ? 0 : offset + 1U;
+        }
+    }
+    return TASK_NONE;
+{{/prio_inherit_rr}}
+{{#edf}}
+    /* The end of the blocked-on chain of the earliest deadline task whose chain ends in a runnable task */
+    TaskId task_id, earliest = TASK_NONE;
+
+    for (task_id = 0; task_id < TASKS; task_id++)
+    {
+        if (ref_resolve(task_id) != TASK_NONE && (earliest == TASK_NONE || ref_before(task_id, earliest)))
+        {
+            earliest = task_id;
+        }
+    }
+    return earliest == TASK_NONE ? TASK_NONE : ref_resolve(earliest);
+{{/edf}}
+}
+{{#prio_inherit_rr}}
+
+static bool
+ref_time_slice_tick(void)
+{
+    if (ref_slice_remaining > 1)
+    {
+        ref_slice_remaining--;
+        return false;
+    }
+    else
+    {
+        const TaskId level = ref_slice_level;
+
+        ref_level_offsets[level] = ref_level_offsets[level] + 1U == ref_level_size(level) ?
+            0 : ref_level_offsets[level] + 1U;
+        ref_slice_task = TASK_NONE;
+        return true;
+    }
+}
+{{/prio_inherit_rr}}
+
+static void
+set_runnable(const TaskId task_id)
+{
+    pub_sched_set_runnable(task_id);
+    ref_blocked_on[task_id] = task_id;
+}
+
+static void
+set_blocked(const TaskId task_id)
+{
+    pub_sched_set_blocked(task_id);
+    ref_blocked_on[task_id] = TASK_NONE;
+}
+{{#blocked_on}}
+
+static void
+set_blocked_on(const TaskId task_id, const TaskId blocker)
+{
+    pub_sched_set_blocked_on(task_id, blocker);
+    ref_blocked_on[task_id] = blocker;
+}
+
+/* Whether blocking the given task on the given blocker would create a cycle */
+static bool
+creates_cycle(const TaskId task_id, TaskId blocker)
+{
+    while (blocker != TASK_NONE && blocker != task_id && ref_blocked_on[blocker] != blocker)
+    {
+        blocker = ref_blocked_on[blocker];
+    }
+    return blocker == task_id;
+}
+{{/blocked_on}}
+{{#edf}}
+
+static void
+set_deadline(const TaskId task_id, const uint32_t deadline)
+{
+    pub_sched_set_deadline(task_id, deadline);
+    ref_deadlines[task_id] = deadline;
+}
+{{/edf}}
+
+static void
+fail(const char *const phase, const TaskId expected, const TaskId actual)
+{
+    TaskId task_id;
+
+    printf("sched-check: {{scheduler}} %s: mismatch after %lu states: expected task %u, got %u\n",
+           phase, states, expected, actual);
+    printf("sched-check: blocked on:");
+    for (task_id = 0; task_id < TASKS; task_id++)
+    {
+        printf(" %u", ref_blocked_on[task_id]);
+    }
+    printf("\n");
+{{#edf}}
+    printf("sched-check: deadlines:");
+    for (task_id = 0; task_id < TASKS; task_id++)
+    {
+        printf(" %lu", (unsigned long) ref_deadlines[task_id]);
+    }
+    printf("\n");
+{{/edf}}
+    exit(1);
+}
+
+static void
+check_next(const char *const phase)
+{
+    const TaskId expected = ref_get_next();
+    const TaskId actual = pub_sched_get_next();
+
+    if (actual != expected)
+    {
+        fail(phase, expected, actual);
+    }
+}
+
+/* Check the selections in the current state; they also advance the history-dependent state */
+static void
+check_state(const char *const phase)
+{
+    check_next(phase);
+{{#rr}}
+    check_next(phase);
+{{/rr}}
+{{#prio_inherit_rr}}
+    check_next(phase);
+    if (pub_sched_time_slice_tick() != ref_time_slice_tick())
+    {
+        printf("sched-check: {{scheduler}} %s: time slice expiry mismatch after %lu states\n", phase, states);
+        exit(1);
+    }
+    check_next(phase);
+{{/prio_inherit_rr}}
+    states++;
+}
+
+static void
+report(const char *const phase, const clock_t start)
+{
+    const double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    printf("sched-check: {{scheduler}} %s: %lu states in %.3f s (%.0f states/s)\n",
+           phase, states, seconds, seconds > 0 ? states / seconds : 0.0);
+}
+
+/* Map the index of an exhaustively enumerated task to its task ID: the first half from the start of the task array,
+ * the rest from its end. */
+static TaskId
+exhaustive_task(const TaskId idx)
+{
+    return idx < EXHAUSTIVE_TASKS / 2U ? idx : TASKS - EXHAUSTIVE_TASKS + idx;
+}
+
+/* Apply one task's enumerated choice; returns false if its state would create a blocked-on cycle */
+static bool
+apply_choice(const TaskId idx, const unsigned int choice)
+{
+    const TaskId task_id = exhaustive_task(idx);
+    const unsigned int state = choice / DEADLINE_CHOICES;
+{{#blocked_on}}
+    TaskId blocker;
+{{/blocked_on}}
+
+{{#edf}}
+    set_deadline(task_id, choice % DEADLINE_CHOICES);
+{{/edf}}
+    if (state == 0)
+    {
+        set_runnable(task_id);
+    }
+    else if (state == 1)
+    {
+        set_blocked(task_id);
+    }
+{{#blocked_on}}
+    else
+    {
+        /* Skip the task itself */
+        blocker = state - 2U < idx ? state - 2U : state - 1U;
+        blocker = exhaustive_task(blocker);
+        if (creates_cycle(task_id, blocker))
+        {
+            return false;
+        }
+        set_blocked_on(task_id, blocker);
+    }
+{{/blocked_on}}
+    return true;
+}
+
+{{#rr}}
+
+/* The round-robin position after each enumerated task */
+static unsigned int
+exhaustive_positions(void)
+{
+    return EXHAUSTIVE_TASKS;
+}
+{{/rr}}
+{{#prio_inherit_rr}}
+
+/* The levels containing enumerated tasks, in ascending order, and their number */
+static TaskId exhaustive_levels[EXHAUSTIVE_TASKS];
+static TaskId exhaustive_level_count;
+
+/* Each combination of offsets of the levels containing enumerated tasks */
+static unsigned int
+exhaustive_positions(void)
+{
+    unsigned int positions = 1;
+    TaskId idx, level;
+
+    exhaustive_level_count = 0;
+    for (idx = 0; idx < EXHAUSTIVE_TASKS; idx++)
+    {
+        level = exhaustive_task(idx) / LEVEL_SIZE;
+        if (exhaustive_level_count == 0 || exhaustive_levels[exhaustive_level_count - 1U] != level)
+        {
+            exhaustive_levels[exhaustive_level_count++] = level;
+            positions *= ref_level_size(level);
+        }
+    }
+    return positions;
+}
+{{/prio_inherit_rr}}
+{{^history}}
+
+/* Selections do not depend on their history */
+static unsigned int
+exhaustive_positions(void)
+{
+    return 1;
+}
+{{/history}}
+{{#history}}
+
+/* Select the given task as the only runnable one, which leaves the scheduler at that task's position */
+static void
+select_only(const TaskId task_id)
+{
+    set_runnable(task_id);
+    check_next("exhaustive position");
+    set_blocked(task_id);
+}
+{{/history}}
+
+/* Move the scheduler to the given position; all tasks must be blocked */
+static void
+set_position(unsigned int position)
+{
+{{#rr}}
+    select_only(exhaustive_task(position));
+{{/rr}}
+{{#prio_inherit_rr}}
+    TaskId idx, level;
+
+    for (idx = 0; idx < exhaustive_level_count; idx++)
+    {
+        level = exhaustive_levels[idx];
+        select_only(level * LEVEL_SIZE + position % ref_level_size(level));
+        position /= ref_level_size(level);
+    }
+{{/prio_inherit_rr}}
+{{^history}}
+    (void) position;
+{{/history}}
+}
+
+static void
+check_exhaustive(void)
+{
+    unsigned int choices[EXHAUSTIVE_TASKS] = { 0 };
+    unsigned int position = 0;
+    const unsigned int positions = exhaustive_positions();
+    TaskId idx;
+    bool valid;
+    const clock_t start = clock();
+
+    states = 0;
+    for (;;)
+    {
+        /*
+         * Blocking all enumerated tasks first means that a cycle can only be closed by the task whose choice closes
+         * it, and that an applied state never contains one.
+         */
+        for (idx = 0; idx < EXHAUSTIVE_TASKS; idx++)
+        {
+            set_blocked(exhaustive_task(idx));
+        }
+        set_position(position);
+        valid = true;
+        for (idx = 0; idx < EXHAUSTIVE_TASKS && valid; idx++)
+        {
+            valid = apply_choice(idx, choices[idx]);
+        }
+        if (valid)
+        {
+            check_state("exhaustive");
+        }
+
+        for (idx = 0; idx < EXHAUSTIVE_TASKS; idx++)
+        {
+            if (++choices[idx] < STATE_CHOICES * DEADLINE_CHOICES)
+            {
+                break;
+            }
+            choices[idx] = 0;
+        }
+        if (idx == EXHAUSTIVE_TASKS && ++position == positions)
+        {
+            break;
+        }
+    }
+    report("exhaustive", start);
+}
+
+static void
+check_random(void)
+{
+    unsigned long sample;
+    TaskId task_id;
+{{#blocked_on}}
+    TaskId blocker;
+{{/blocked_on}}
+{{#edf}}
+    /* Start close to the wrap-around of the tick counter and advance past it */
+    uint32_t now = (uint32_t) 0 - (uint32_t) SAMPLES;
+{{/edf}}
+    const clock_t start = clock();
+
+    states = 0;
+    for (sample = 0; sample < SAMPLES; sample++)
+    {
+        task_id = random_next() % TASKS;
+        switch (random_next() % 4U)
+        {
+        case 0:
+            set_runnable(task_id);
+            break;
+        case 1:
+            set_blocked(task_id);
+            break;
+        case 2:
+{{#blocked_on}}
+            blocker = random_next() % TASKS;
+            if (blocker != task_id && !creates_cycle(task_id, blocker))
+            {
+                set_blocked_on(task_id, blocker);
+            }
+{{/blocked_on}}
+            break;
+        default:
+{{#edf}}
+            now += random_next() % 4U;
+            set_deadline(task_id, now + random_next() % DEADLINE_WINDOW);
+{{/edf}}
+            break;
+        }
+        check_state("random");
+    }
+    report("random", start);
+}
+
+int
+main(void)
+{
+    TaskId task_id;
+
+    for (task_id = 0; task_id < TASKS; task_id++)
+    {
+        set_blocked(task_id);
+    }
+
+    check_exhaustive();
+    check_random();
+    printf("sched-check: {{scheduler}}: passed\n");
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+
+from prj import Module, SystemParseError, xml_error_str
+
+
+class SchedCheckModule(Module):
+    # 'tasks' must match the number of tasks of the scheduler test module in the same system.
+    # Priority levels are assumed to hold 'level_size' adjacent tasks each, the last level possibly fewer.
+    xml_schema = """
+<schema>
+    <entry name="scheduler" type="c_ident" />
+    <entry name="tasks" type="int" />
+    <entry name="level_size" type="int" default="1" />
+    <entry name="time_slice" type="int" default="0" />
+    <entry name="exhaustive_tasks" type="int" default="10" />
+    <entry name="samples" type="int" default="1000000" />
+    <entry name="seed" type="int" default="1" />
+</schema>"""
+
+    files = [
+        {'input': 'sched-check.c', 'render': True, 'type': 'c'},
+    ]
+
+    schedulers = ['rr', 'prio', 'prio_inherit', 'prio_inherit_rr', 'edf']
+
+    def configure(self, xml_config):
+        config = super().configure(xml_config)
+
+        def error(msg):
+            raise SystemParseError(xml_error_str(xml_config, msg))
+
+        if config['scheduler'] not in self.schedulers:
+            error("scheduler must be one of {}, not {}".format(', '.join(self.schedulers), config['scheduler']))
+        # Task IDs are 8 bits wide in the scheduler test modules and 0xff is TASK_ID_NONE
+        if not 1 <= config['tasks'] < 0xff:
+            error("tasks must be between 1 and 254")
+        if not 1 <= config['exhaustive_tasks'] <= min(config['tasks'], 16):
+            error("exhaustive_tasks must be between 1 and the smaller of tasks and 16")
+        if config['scheduler'] == 'prio_inherit_rr' and config['time_slice'] == 0:
+            error("the prio_inherit_rr scheduler requires a time_slice")
+
+        for scheduler in self.schedulers:
+            config[scheduler] = config['scheduler'] == scheduler
+        config['blocked_on'] = config['scheduler'] in ('prio_inherit', 'prio_inherit_rr', 'edf')
+        config['history'] = config['scheduler'] in ('rr', 'prio_inherit_rr')
+        config['levels'] = (config['tasks'] + config['level_size'] - 1) // config['level_size']
+
+        return config
+
+module = SchedCheckModule()
@@ -0,0 +1,102 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+import os.path
+from prj import Module, SystemParseError, xml_error_str
+from operator import itemgetter
+from util.rtos import (configure_budgets, configure_id_sizes, configure_pools, configure_timebase,
+                       configure_timers, configure_work_queues)
+from util.util import LengthList
+
+
+class KochabModule(Module):
+    xml_schema_path = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'schema.xml')
+    files = [
+        {'input': 'rtos-kochab.h', 'render': True},
+        {'input': 'rtos-kochab.c', 'render': True, 'type': 'c'},
+    ]
+
+    def configure(self, xml_config):
+        config = super().configure(xml_config)
+
+        # Create builtin signals
+        config['signal_labels'].append({'name': '_task_timer', 'idx': len(config['signal_labels'])})
+        if config['work_queues']:
+            config['signal_labels'].append({'name': '_work', 'idx': len(config['signal_labels'])})
+
+        # Create signal_set definitions from signal definitions:
+        config['signal_sets'] = [{'name': sig['name'], 'value': 1 << sig['idx'], 'singleton': True}
+                                 for sig in config['signal_labels']]
+
+        config['prefix_func'] = config['prefix'] + '_' if config['prefix'] is not None else ''
+        config['prefix_type'] = config['prefix'].capitalize() if config['prefix'] is not None else ''
+        config['prefix_const'] = config['prefix'].upper() + '_' if config['prefix'] is not None else ''
+
+        tasks = config['tasks']
+        tasks.sort(key=itemgetter('priority'), reverse=True)
+        config['priority_levels'] = LengthList()
+        for idx, t in enumerate(tasks):
+            t['idx'] = idx
+            # Tasks of equal priority are adjacent after sorting and form a priority level
+            if idx == 0 or t['priority'] != tasks[idx - 1]['priority']:
+                config['priority_levels'].append({'first': idx})
+            # Create a timer for each task
+            timer = {'name': '_task_' + t['name'],
+                     'error': 0,
+                     'reload': 0,
+                     'task': t,
+                     'idx': len(config['timers']),
+                     'enabled': False,
+                     'sig_set': '_task_timer'}
+            t['timer'] = timer
+            config['timers'].append(timer)
+
+        if not 0 <= config['time_slice'] <= 0xffff:
+            raise SystemParseError(xml_error_str(xml_config, "The time slice must be a relative tick count"))
+
+        configure_budgets(xml_config, config)
+
+        configure_pools(xml_config, config)
+
+        if config['condition_variables'] and not config['mutexes']:
+            raise SystemParseError(xml_error_str(xml_config, "Condition variables require at least one mutex"))
+
+        configure_work_queues(xml_config, config)
+
+        config['atomics'] = len(config['pools']) > 0 or len(config['work_queues']) > 0
+
+        configure_timebase(xml_config, config)
+
+        # The cycle counter is only compiled into systems that use it, so that its functions are never unused
+        config['cycle_counter'] = config['budgets'] or bool(config['timebase'])
+
+        configure_id_sizes(xml_config, config, len(config['signal_labels']))
+        configure_timers(xml_config, config)
+        return config
+
+
+module = KochabModule()
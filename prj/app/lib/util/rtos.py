@@ -0,0 +1,178 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+"""Configuration helpers that the RTOS variant modules share."""
+
+from .util import LengthList, pack_bits, uint_size
+from .xml import SystemParseError, xml_error_str
+
+SIGNAL_SET_BITS_MAX = 32
+NANOSECONDS_PER_SECOND = 1000000000
+
+
+def configure_id_sizes(xml_config, config, signal_count=None):
+    """Choose the narrowest types for task IDs and, if the variant has signals, signal sets.
+
+    Sizes that the system configuration specifies take precedence.
+    Task IDs distinguish all tasks from TASK_ID_NONE, and signal sets have a bit for each of the `signal_count`
+    signals.
+
+    """
+    if config['taskid_size'] is None:
+        config['taskid_size'] = uint_size(len(config['tasks']))
+    if signal_count is not None and config['signalset_size'] is None:
+        if signal_count > SIGNAL_SET_BITS_MAX:
+            raise SystemParseError(xml_error_str(xml_config, "A signal set has at most {} signals, but the system "
+                                                 "requires {}".format(SIGNAL_SET_BITS_MAX, signal_count)))
+        config['signalset_size'] = uint_size((1 << signal_count) - 1)
+
+
+def configure_timers(xml_config, config):
+    """Validate the periodic tasks, choose the narrowest types for timer IDs and relative tick counts, and pack the
+    initial timer enabled flags.
+
+    The deadline of a periodic task defaults to its period.
+    Relative tick counts are at least 16 bits wide because they are also used for timeouts chosen at run time.
+
+    """
+    periodic_task_names = set()
+    for periodic_task in config['periodic_tasks']:
+        name = periodic_task['task']['name']
+        if name in periodic_task_names:
+            raise SystemParseError(xml_error_str(xml_config, "Task {} must not be periodic more than "
+                                                 "once".format(name)))
+        periodic_task_names.add(name)
+        if periodic_task['deadline'] == 0:
+            periodic_task['deadline'] = periodic_task['period']
+        if not 0 < periodic_task['period'] < 1 << 32 or not 0 < periodic_task['deadline'] <= periodic_task['period']:
+            raise SystemParseError(xml_error_str(xml_config, "The period of periodic task {} must be a positive "
+                                                 "relative tick count, and its deadline must not exceed the "
+                                                 "period".format(name)))
+
+    config['timerid_size'] = uint_size(len(config['timers']))
+    ticks = [timer['reload'] for timer in config['timers']]
+    ticks += [t[key] for t in config['periodic_tasks'] for key in ('period', 'deadline')]
+    config['ticksrelative_size'] = max(16, uint_size(max(ticks + [0])))
+    config['timer_enabled_words'] = LengthList(hex(word) for word in
+                                               pack_bits([timer['enabled'] for timer in config['timers']]))
+
+
+def configure_pools(xml_config, config):
+    """Validate the memory pools and compute the stride between their blocks."""
+    for pool in config['pools']:
+        # Block indices are 16-bit, with the largest value marking the end of the free list
+        if not 0 < pool['block_count'] < 0xffff or pool['block_size'] <= 0:
+            raise SystemParseError(xml_error_str(xml_config, "The pool {} must have between 1 and 65534 blocks "
+                                                 "of a positive size".format(pool['name'])))
+        if pool['alignment'] <= 0 or pool['alignment'] & (pool['alignment'] - 1):
+            raise SystemParseError(xml_error_str(xml_config, "The alignment of pool {} must be a power of "
+                                                 "two".format(pool['name'])))
+        # Free blocks hold the 16-bit index of the next free block, so blocks are at least two bytes in size and
+        # aligned to two bytes, and padded to a multiple of their alignment
+        alignment = pool['alignment'] = max(pool['alignment'], 2)
+        pool['stride'] = (max(pool['block_size'], 2) + alignment - 1) // alignment * alignment
+
+
+def configure_budgets(xml_config, config):
+    """Validate the execution budgets of the tasks, and enable budget accounting if any task has a budget.
+
+    Budgets are cycle counts and replenishment periods are relative tick counts.
+
+    """
+    for task in config['tasks']:
+        if task['budget'] and (not 0 < task['budget'] <= 0x3fffffff or not 0 < task['budget_period'] <= 0xffff):
+            raise SystemParseError(xml_error_str(xml_config, "The budget of task {} must be a positive cycle "
+                                                 "count with a replenishment period in ticks".format(task['name'])))
+
+    # Budget accounting is only compiled into systems that use it
+    config['budgets'] = any(task['budget'] for task in config['tasks'])
+
+
+def configure_work_queues(xml_config, config):
+    """Validate the work queues, and create an interrupt event for each of their workers.
+
+    Interrupt handlers wake up each worker of a work queue through an interrupt event of its own that sets the '_work'
+    signal.
+
+    """
+    config['work_queue_workers'] = LengthList()
+    workers = set()
+    for work_queue in config['work_queues']:
+        length = work_queue['length']
+        if length < 2 or length & (length - 1):
+            raise SystemParseError(xml_error_str(xml_config, "The length of work queue {} must be a power of two "
+                                                 "of at least 2".format(work_queue['name'])))
+        work_queue['first_worker'] = len(config['work_queue_workers'])
+        for task in work_queue['workers']:
+            if task['name'] in workers:
+                raise SystemParseError(xml_error_str(xml_config, "Task {} must not be a worker of more than one "
+                                                     "work queue".format(task['name'])))
+            workers.add(task['name'])
+            interrupt_event = {'name': '_work_{}_{}'.format(work_queue['name'], task['name']),
+                               'task': task,
+                               'sig_set': '_work',
+                               'idx': len(config['interrupt_events'])}
+            config['interrupt_events'].append(interrupt_event)
+            config['work_queue_workers'].append({'task': task, 'interrupt_event': interrupt_event['name']})
+
+
+def configure_timebase(xml_config, config):
+    """Validate the timebase, if the system configures one, and compute its fixed-point conversions between cycles
+    and nanoseconds.
+
+    """
+    # An absent optional dictionary configures as an empty one
+    timebase = config['timebase']
+    if timebase:
+        frequency, period = timebase['clock_frequency'], timebase['tick_period']
+        # Ticks are aligned to multiples of the tick period in network time, so a second must be a whole number of
+        # tick periods, and a tick period must be a whole number of cycles.
+        # The reload value of the tick timer may reach twice the tick period in cycles.
+        if not 1000000 <= frequency < 1 << 32:
+            raise SystemParseError(xml_error_str(xml_config, "The timebase clock frequency must be between 1 MHz "
+                                                 "and 4 GHz"))
+        if not 0 < period <= NANOSECONDS_PER_SECOND or NANOSECONDS_PER_SECOND % period:
+            raise SystemParseError(xml_error_str(xml_config, "The timebase tick period must divide one second "
+                                                 "into a whole number of ticks"))
+        tick_cycles, remainder = divmod(frequency * period, NANOSECONDS_PER_SECOND)
+        if remainder or not 0 < tick_cycles < 1 << 30:
+            raise SystemParseError(xml_error_str(xml_config, "The timebase tick period must be a whole number of "
+                                                 "less than 2^30 cycles"))
+        timebase['tick_cycles'] = tick_cycles
+        timebase['ticks_per_second'] = NANOSECONDS_PER_SECOND // period
+        # Fixed-point conversions between cycles and nanoseconds with 32 fractional bits, and their changes per part
+        # per billion of frequency adjustment with 16 more fractional bits
+        rate = timebase['rate'] = _round_div(NANOSECONDS_PER_SECOND << 32, frequency)
+        timebase['rate_per_ppb'] = _round_div(rate << 16, NANOSECONDS_PER_SECOND)
+        cycles_per_ns = timebase['cycles_per_nanosecond'] = _round_div(frequency << 32, NANOSECONDS_PER_SECOND)
+        timebase['cycles_per_nanosecond_per_ppb'] = _round_div(cycles_per_ns << 16, NANOSECONDS_PER_SECOND)
+        # The number of whole seconds in 2^32 cycles at the fastest adjusted rate bounds the conversion loops
+        timebase['wrap_seconds'] = ((1 << 32) * ((rate >> 32) + 1)) // NANOSECONDS_PER_SECOND + 1
+
+
+def _round_div(dividend, divisor):
+    return (dividend + divisor // 2) // divisor
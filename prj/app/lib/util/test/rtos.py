@@ -0,0 +1,160 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+from util.rtos import (configure_budgets, configure_id_sizes, configure_pools, configure_timebase,
+                       configure_timers, configure_work_queues)
+from util.xml import SystemParseError, xml_parse_string
+from nose.tools import assert_raises
+
+
+def _config(tasks=0, timers=(), periodic_tasks=()):
+    return {'taskid_size': None, 'signalset_size': None, 'tasks': [{}] * tasks, 'timers': list(timers),
+            'periodic_tasks': list(periodic_tasks)}
+
+
+def test_configure_id_sizes():
+    config = _config(tasks=255)
+    configure_id_sizes(None, config)
+    assert config['taskid_size'] == 8 and config['signalset_size'] is None
+
+    config = _config(tasks=256)
+    configure_id_sizes(None, config, 9)
+    assert (config['taskid_size'], config['signalset_size']) == (16, 16)
+
+    config = _config(tasks=1)
+    config['signalset_size'] = 32
+    configure_id_sizes(None, config, 1)
+    assert (config['taskid_size'], config['signalset_size']) == (8, 32)
+
+
+def test_configure_id_sizes_too_many_signals():
+    config = _config(tasks=1)
+    configure_id_sizes(None, config, 32)
+    assert config['signalset_size'] == 32
+
+    with assert_raises(SystemParseError) as e:
+        configure_id_sizes(xml_parse_string('<module />'), _config(tasks=1), 33)
+    assert 'at most 32 signals' in str(e.exception)
+
+
+def _periodic_task(name, period, deadline=0):
+    return {'task': {'name': name}, 'period': period, 'deadline': deadline}
+
+
+def test_configure_timers():
+    timers = [{'reload': 0, 'enabled': idx == 32} for idx in range(33)]
+    config = _config(timers=timers)
+    configure_timers(None, config)
+    assert (config['timerid_size'], config['ticksrelative_size']) == (8, 16)
+    assert config['timer_enabled_words'] == ['0x0', '0x1']
+    assert config['timer_enabled_words'].length == 2
+
+    config = _config(timers=timers, periodic_tasks=[_periodic_task('a', 0x10000, 10)])
+    configure_timers(None, config)
+    assert config['ticksrelative_size'] == 32
+
+
+def test_configure_timers_periodic_tasks():
+    config = _config(periodic_tasks=[_periodic_task('a', 10), _periodic_task('b', 10, 5)])
+    configure_timers(None, config)
+    assert [t['deadline'] for t in config['periodic_tasks']] == [10, 5]
+
+    for periodic_tasks in ([_periodic_task('a', 0)], [_periodic_task('a', 10, 11)], [_periodic_task('a', 1 << 32)],
+                           [_periodic_task('a', 10), _periodic_task('a', 20)]):
+        with assert_raises(SystemParseError):
+            configure_timers(xml_parse_string('<module />'), _config(periodic_tasks=periodic_tasks))
+
+
+def _pool(block_size, block_count=1, alignment=4):
+    return {'name': 'p', 'block_size': block_size, 'block_count': block_count, 'alignment': alignment}
+
+
+def test_configure_pools():
+    config = {'pools': [_pool(6), _pool(1, alignment=1), _pool(9, 0xfffe, 8)]}
+    configure_pools(None, config)
+    assert [(p['alignment'], p['stride']) for p in config['pools']] == [(4, 8), (2, 2), (8, 16)]
+
+    for pool in (_pool(0), _pool(4, 0), _pool(4, 0xffff), _pool(4, alignment=3), _pool(4, alignment=0)):
+        with assert_raises(SystemParseError):
+            configure_pools(xml_parse_string('<module />'), {'pools': [pool]})
+
+
+def _budget_task(budget, budget_period=10):
+    return {'name': 't', 'budget': budget, 'budget_period': budget_period}
+
+
+def test_configure_budgets():
+    config = {'tasks': [_budget_task(0, 0), _budget_task(0, 0)]}
+    configure_budgets(None, config)
+    assert not config['budgets']
+
+    config = {'tasks': [_budget_task(0, 0), _budget_task(0x3fffffff, 0xffff)]}
+    configure_budgets(None, config)
+    assert config['budgets']
+
+    for task in (_budget_task(-1), _budget_task(0x40000000), _budget_task(1, 0), _budget_task(1, 0x10000)):
+        with assert_raises(SystemParseError):
+            configure_budgets(xml_parse_string('<module />'), {'tasks': [task]})
+
+
+def test_configure_timebase():
+    # A 50 MHz clock with 1 ms ticks
+    config = {'timebase': {'clock_frequency': 50000000, 'tick_period': 1000000}}
+    configure_timebase(None, config)
+    timebase = config['timebase']
+    assert (timebase['tick_cycles'], timebase['ticks_per_second']) == (50000, 1000)
+    assert timebase['rate'] == 20 << 32 and timebase['cycles_per_nanosecond'] == round((1 << 32) / 20)
+
+    config = {'timebase': {}}
+    configure_timebase(None, config)
+    assert config['timebase'] == {}
+
+    for frequency, period in ((999999, 1000000), (1 << 32, 1000000), (50000000, 3000000), (50000000, 1),
+                              (2000000000, 1000000000)):
+        with assert_raises(SystemParseError):
+            configure_timebase(xml_parse_string('<module />'),
+                               {'timebase': {'clock_frequency': frequency, 'tick_period': period}})
+
+
+def _work_queue(name, length, workers):
+    return {'name': name, 'length': length, 'workers': [{'name': worker} for worker in workers]}
+
+
+def test_configure_work_queues():
+    config = {'work_queues': [_work_queue('a', 4, ['t1', 't2']), _work_queue('b', 2, ['t3'])],
+              'interrupt_events': [{'name': 'e', 'idx': 0}]}
+    configure_work_queues(None, config)
+    assert [q['first_worker'] for q in config['work_queues']] == [0, 2]
+    events = [(e['name'], e['idx']) for e in config['interrupt_events']]
+    assert events == [('e', 0), ('_work_a_t1', 1), ('_work_a_t2', 2), ('_work_b_t3', 3)]
+    assert [w['interrupt_event'] for w in config['work_queue_workers']] == ['_work_a_t1', '_work_a_t2', '_work_b_t3']
+
+    for work_queues in ([_work_queue('a', 3, [])], [_work_queue('a', 1, [])],
+                        [_work_queue('a', 2, ['t1']), _work_queue('b', 2, ['t1'])]):
+        with assert_raises(SystemParseError):
+            configure_work_queues(xml_parse_string('<module />'),
+                                  {'work_queues': work_queues, 'interrupt_events': []})
@@ -25,7 +25,7 @@
 # @TAG(NICTA_AGPL)
 #
 
-from util.util import do_nothing, Singleton, s16l, check_unique, remove_multi, add_index, \
+from util.util import do_nothing, Singleton, s16l, uint_size, pack_bits, check_unique, remove_multi, add_index, \
     LengthMixin, LengthList, config_traverse, config_set, list_search
 from nose.tools import assert_raises, raises
 
@@ -72,6 +72,27 @@ def test_s16l_ffff():
         yield 'n={}'.format(n), check_s16l, 0xffff, n, expected
 
 
+def check_uint_size(max_value, expected):
+    assert uint_size(max_value) == expected
+
+
+def test_uint_size():
+    for max_value, expected in ((0, 8), (255, 8), (256, 16), (0xffff, 16), (0x10000, 32), (0xffffffff, 32)):
+        yield 'max_value={}'.format(max_value), check_uint_size, max_value, expected
+
+
+@raises(ValueError)
+def test_uint_size_too_large():
+    uint_size(1 << 32)
+
+
+def test_pack_bits():
+    assert pack_bits([]) == []
+    assert pack_bits([True, False, True]) == [5]
+    assert pack_bits([False] * 32 + [True]) == [0, 1]
+    assert pack_bits([True] * 9, word_size=8) == [0xff, 1]
+
+
 def test_check_unique_no_dups():
     check_unique(range(40))
 
@@ -0,0 +1,177 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+from util.wcet import evaluate_bound, parse_loop_bounds, report
+from nose.tools import assert_raises
+
+
+SOURCE = """int
+rtos_count(int x)
+{
+    int i = 0;
+
+    /* loop bound: {} */
+    while (i < x)
+    {
+        i++;
+    }
+    return i;
+}
+"""
+
+
+def source_reader(bound):
+    return lambda path: SOURCE.replace('{}', bound).splitlines() if path == '/src/a.c' else None
+
+
+ARMV7M_DISASSEMBLY = """
+00000100 <rtos_count>:
+rtos_count():
+/src/a.c:4
+ 100:\tmovs\tr3, #0
+/src/a.c:7
+ 102:\tcmp\tr3, r0
+ 104:\tbge.n\t10c <rtos_count+0xc>
+/src/a.c:9
+ 106:\tadds\tr3, #1
+/src/a.c:7
+ 108:\tb.n\t102 <rtos_count+0x2>
+ 10a:\tnop
+/src/a.c:11
+ 10c:\tmov\tr0, r3
+ 10e:\tbx\tlr
+
+00000110 <rtos_wait>:
+rtos_wait():
+ 110:\tpush\t{r4, lr}
+ 112:\tbl\t100 <rtos_count>
+ 116:\tbl\t120 <rtos_internal_yield>
+ 11a:\tpop\t{r4, pc}
+
+00000120 <rtos_internal_yield>:
+ 120:\tsvc\t0
+ 122:\tbx\tlr
+
+00000124 <rtos_internal_helper>:
+ 124:\tbx\tlr
+"""
+
+PPCE500_DISASSEMBLY = """
+00000100 <rtos_count>:
+rtos_count():
+/src/a.c:4
+ 100:\tli      r9,0
+/src/a.c:7
+ 104:\tcmpw    cr7,r9,r3
+ 108:\tbge-    cr7,118 <rtos_count+0x18>
+/src/a.c:9
+ 10c:\taddi    r9,r9,1
+/src/a.c:7
+ 110:\tb       104 <rtos_count+0x4>
+ 114:\tnop
+/src/a.c:11
+ 118:\tmr      r3,r9
+ 11c:\tblr
+
+00000120 <rtos_dispatch>:
+ 120:\tmtctr   r3
+ 124:\tbctrl
+ 128:\tblr
+"""
+
+
+def test_evaluate_bound():
+    assert evaluate_bound('(10 - 1U) / 4 + 1') == 3
+    assert evaluate_bound('7 % 4 * 2') == 6
+    assert evaluate_bound('retries + 1', 3) == 4
+    with assert_raises(ValueError):
+        evaluate_bound('__import__("os")')
+    with assert_raises(ValueError):
+        evaluate_bound('retries')
+
+
+def test_parse_loop_bounds():
+    lines = ['/* loop bound: 3 */', 'do', '{', '    a();', '} while (', '    b() &&', '    c());',
+             '/* loop bound: 2 * 4 */', 'for (i = 0;', '     i < n; i++)', '{',
+             '    /* loop bound: 5 */', '    while (x) y();', '}']
+    assert parse_loop_bounds('a.c', lines) == [(2, 7, 3, False), (9, 14, 8, False), (13, 13, 5, False)]
+    assert parse_loop_bounds('a.c', ['/* loop bound: retries */', 'for (;;);'], 3) == [(2, 2, 3, True)]
+    with assert_raises(ValueError):
+        parse_loop_bounds('a.c', ['/* loop bound: n */', 'for (;;);'])
+
+
+def test_armv7m():
+    text, exceeded = report(ARMV7M_DISASSEMBLY, 'armv7m', source_reader('4'))
+    lines = text.splitlines()
+    assert lines[1].split() == ['23', 'rtos_count']
+    # The context switch is not counted, and the call to it makes rtos_wait blocking
+    assert lines[2].split() == ['27', 'rtos_wait', '(blocking)']
+    assert 'rtos_internal_helper' not in text
+    assert lines[4:6] == ['  iterations  loop', '           4  /src/a.c:7 in rtos_count']
+    assert exceeded == []
+
+
+def test_limits():
+    _, exceeded = report(ARMV7M_DISASSEMBLY, 'armv7m', source_reader('4'), limits=[('rtos_*', 25)])
+    assert exceeded == ['rtos_wait']
+    _, exceeded = report(ARMV7M_DISASSEMBLY, 'armv7m', source_reader('4'),
+                         limits=[('rtos_*', 100), ('rtos_count', 10)])
+    assert exceeded == ['rtos_count']
+
+
+def test_retries():
+    # The assumed number of retries bounds the loop, and marks the entry points that depend on it.
+    text, exceeded = report(ARMV7M_DISASSEMBLY, 'armv7m', source_reader('retries'), limits=[('rtos_count', 20)],
+                            retries=3)
+    lines = text.splitlines()
+    assert lines[1].split() == ['19', 'rtos_count', '(assumes', '3', 'retries)']
+    assert lines[2].split() == ['23', 'rtos_wait', '(blocking,', 'assumes', '3', 'retries)']
+    assert '           3  /src/a.c:7 in rtos_count' in lines
+    assert lines[-1].endswith('is interrupted at most 2 times per execution.')
+    assert exceeded == []
+    text, exceeded = report(ARMV7M_DISASSEMBLY, 'armv7m', source_reader('retries'), limits=[('rtos_count', 20)],
+                            retries=4)
+    assert text.splitlines()[1].split()[:2] == ['23', 'rtos_count']
+    assert exceeded == ['rtos_count']
+    assert 'assumes' not in report(ARMV7M_DISASSEMBLY, 'armv7m', source_reader('4'))[0]
+    with assert_raises(ValueError):
+        report(ARMV7M_DISASSEMBLY, 'armv7m', source_reader('retries'), retries=0)
+
+
+def test_unknown_bound():
+    text, exceeded = report(ARMV7M_DISASSEMBLY, 'armv7m', lambda path: None, limits=[('rtos_count', 100)])
+    assert text.splitlines()[1].split() == ['unknown', 'rtos_count', '(EXCEEDS', 'LIMIT', '100)']
+    assert 'rtos_count: loop at /src/a.c:7 in rtos_count has no bound' in text
+    assert exceeded == ['rtos_count']
+
+
+def test_ppce500():
+    text, _ = report(PPCE500_DISASSEMBLY, 'ppce500', source_reader('2'))
+    lines = text.splitlines()
+    assert lines[1].split() == ['15', 'rtos_count']
+    assert lines[2].split() == ['unknown', 'rtos_dispatch']
+    assert 'rtos_dispatch: indirect call at 0x124 in rtos_dispatch' in text
@@ -87,6 +87,23 @@ def s16l(value, n):
     return (value << n) & 0xffff
 
 
+def uint_size(max_value):
+    """Return the width in bits of the narrowest of uint8_t, uint16_t, and uint32_t that can represent 'max_value'."""
+    for size in (8, 16, 32):
+        if 0 <= max_value < 1 << size:
+            return size
+    raise ValueError("No unsigned integer type can represent the value {}".format(max_value))
+
+
+def pack_bits(flags, word_size=32):
+    """Pack a sequence of booleans into a list of integers of 'word_size' bits, with the first flag in bit 0."""
+    words = [0] * ((len(flags) + word_size - 1) // word_size)
+    for idx, flag in enumerate(flags):
+        if flag:
+            words[idx // word_size] |= 1 << (idx % word_size)
+    return words
+
+
 def check_unique(lst):
     """Raise exception if the items in the list are not unique."""
     uniq = list(set(lst))
@@ -0,0 +1,645 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+
+"""Static worst-case execution bounds of the functions in a linked image.
+
+The analysis works on the output of 'objdump -d -l --no-show-raw-insn' for the image.
+It splits each function into basic blocks, finds its loops, and computes the largest number of instructions executed
+on any path from the function's entry to a return, including the instructions executed by the functions it calls.
+
+Loops must be bounded by an annotation in the C source, a comment on the line preceding the loop statement:
+
+    /* loop bound: {{tasks.length}} */
+    for (...)
+    {
+        ...
+    }
+
+The bound is the largest number of iterations of the loop body.
+It may be an integer expression using + - * / % and parentheses, with / and % rounding as in C for non-negative
+operands, and the name 'retries'.
+Because components render such annotations from the system configuration, the resulting bounds are parameterized by
+the configured numbers of tasks, timers, mutexes, and so on.
+
+A loop that only repeats when an interrupt intervenes, e.g., a retry of an exclusive access or a compare-and-swap, has
+no bound of its own: back-to-back interrupts can make it repeat any number of times.
+Such loops are annotated with the bound 'retries', which is an assumption of the analysis rather than a property of
+the code, and the report marks the bounds that depend on it.
+A loop in the binary is matched to the innermost annotated loop statement that contains the source lines of all of its
+branches back to its header.
+Line information remains valid when the compiler inlines the function containing the loop.
+
+Calls to the architecture's context switch functions end an activation of the calling task.
+They are not counted, and a function that makes them is reported as blocking.
+A loop that makes such calls without an annotation, e.g., a loop that waits for a resource, is assumed to execute
+one iteration before and one after the context switch.
+Calls to functions that never return, e.g., the fatal error handler, end a path and are not counted.
+
+Indirect calls and branches, recursion, unannotated loops, and calls to functions outside the image make a bound
+unknown.
+The report lists the reason for each unknown bound.
+
+"""
+import fnmatch
+import re
+from collections import namedtuple
+
+
+Instruction = namedtuple('Instruction', 'address mnemonic operands location')
+
+# The kinds of control transfer that architecture classifiers return for an instruction.
+OTHER = 'other'  # Continues with the next instruction.
+CALL = 'call'  # Direct call.
+INDIRECT_CALL = 'indirect call'
+JUMP = 'jump'  # Unconditional direct branch.
+COND_JUMP = 'conditional jump'
+INDIRECT_JUMP = 'indirect jump'
+RETURN = 'return'
+COND_RETURN = 'conditional return'
+STOP = 'stop'  # Does not continue, e.g., a trap.
+
+_TARGET_RE = re.compile(r'\b([0-9a-f]+) <([^>]+)>')
+
+
+def _target(operands):
+    match = _TARGET_RE.search(operands)
+    return (int(match.group(1), 16), match.group(2)) if match else (None, None)
+
+
+_ARM_CONDITIONS = '(eq|ne|cs|hs|cc|lo|mi|pl|vs|vc|hi|ls|ge|lt|gt|le|al)?'
+_ARM_BRANCH_RE = re.compile(r'^(b|bl|blx|bx|cbz|cbnz|pop|ldm|ldmia|ldmfd|ldr|mov|tbb|tbh)' + _ARM_CONDITIONS + '$')
+
+
+def _classify_armv7m(mnemonic, operands):
+    match = _ARM_BRANCH_RE.match(mnemonic.split('.')[0])
+    if match is None:
+        return OTHER, None
+    base, condition = match.group(1), match.group(2) not in (None, 'al')
+    address, _ = _target(operands)
+    registers = operands.split('@')[0]
+    if base == 'b':
+        return (COND_JUMP if condition else JUMP), address
+    if base in ('cbz', 'cbnz'):
+        return COND_JUMP, address
+    if base == 'bl':
+        return CALL, address
+    if base == 'blx':
+        return (CALL, address) if address is not None else (INDIRECT_CALL, None)
+    if base == 'bx':
+        if registers.strip() == 'lr':
+            return (COND_RETURN if condition else RETURN), None
+        return INDIRECT_JUMP, None
+    if base in ('tbb', 'tbh'):
+        return INDIRECT_JUMP, None
+    if base in ('pop', 'ldm', 'ldmia', 'ldmfd'):
+        if re.search(r'\bpc\b', registers):
+            return (COND_RETURN if condition else RETURN), None
+        return OTHER, None
+    # ldr and mov only transfer control when they write the pc.
+    if re.match(r'\s*pc\b', registers):
+        if base == 'ldr' and re.search(r'\[sp\]', registers):
+            return (COND_RETURN if condition else RETURN), None
+        return INDIRECT_JUMP, None
+    return OTHER, None
+
+
+def _classify_ppce500(mnemonic, operands):
+    mnemonic = mnemonic.rstrip('+-')
+    if mnemonic in ('blr', 'rfi', 'rfci', 'rfmci', 'rfdi'):
+        return RETURN, None
+    if not mnemonic.startswith('b'):
+        return OTHER, None
+    if mnemonic.endswith('lrl') or mnemonic.endswith('ctrl'):
+        return INDIRECT_CALL, None
+    if mnemonic.endswith('lr'):
+        return COND_RETURN, None
+    if mnemonic.endswith('ctr'):
+        return INDIRECT_JUMP, None
+    address, _ = _target(operands)
+    if address is None:
+        # Other instructions starting with 'b', e.g., the SPE 'brinc'.
+        return OTHER, None
+    if mnemonic in ('b', 'ba'):
+        return JUMP, address
+    if mnemonic.endswith('l') or mnemonic.endswith('la'):
+        return CALL, address
+    return COND_JUMP, address
+
+
+_X86_PREFIXES = ('bnd', 'notrack', 'rep', 'repz', 'repe', 'repnz', 'repne', 'lock', 'data16', 'cs', 'ds')
+
+
+def _classify_x86_64(mnemonic, operands):
+    while mnemonic in _X86_PREFIXES and operands:
+        mnemonic, _, operands = operands.partition(' ')
+        operands = operands.strip()
+    if mnemonic in ('ret', 'retq', 'iret', 'iretq'):
+        return RETURN, None
+    if mnemonic in ('hlt', 'ud2'):
+        return STOP, None
+    if mnemonic in ('call', 'callq', 'jmp', 'jmpq'):
+        address, _ = _target(operands)
+        if operands.startswith('*') or address is None:
+            return (INDIRECT_CALL if mnemonic.startswith('call') else INDIRECT_JUMP), None
+        return (CALL if mnemonic.startswith('call') else JUMP), address
+    if mnemonic.startswith('j') or mnemonic.startswith('loop'):
+        return COND_JUMP, _target(operands)[0]
+    return OTHER, None
+
+
+# For each architecture: the instruction classifier, the context switch functions, and the exception handlers that
+# are entry points of the kernel in addition to its API functions.
+ARCHITECTURES = {
+    'armv7m': (_classify_armv7m,
+               ('rtos_internal_yield', 'rtos_internal_context_switch', 'rtos_internal_context_switch_first'),
+               ('rtos_internal_svc_handler', 'rtos_internal_pendsv_handler')),
+    'ppce500': (_classify_ppce500,
+                ('rtos_internal_yield_syscall', 'rtos_internal_context_switch',
+                 'rtos_internal_context_switch_first'),
+                ('syscall_vector', 'exception_preempt_trampoline_*')),
+    'x86_64': (_classify_x86_64,
+               ('swapcontext', 'swapcontext@plt', 'setcontext', 'setcontext@plt'),
+               ()),
+}
+
+# Functions outside the image that never return.
+_NO_RETURN = ('abort', 'exit', '_exit', '__assert_fail', '__stack_chk_fail', 'longjmp')
+
+
+class Function:
+    def __init__(self, name, start):
+        self.name = name
+        self.start = start
+        self.end = None
+        self.instructions = []
+
+
+_HEADER_RE = re.compile(r'^([0-9a-f]+) <(.+)>:$')
+_INSTRUCTION_RE = re.compile(r'^\s*([0-9a-f]+):\s+(\S+)\s*(.*)$')
+_LOCATION_RE = re.compile(r'^(\S.*):(\d+)( \(discriminator \d+\))?$')
+
+
+def parse_disassembly(text):
+    """Parse the output of 'objdump -d -l --no-show-raw-insn' and return the functions it contains by name."""
+    functions = {}
+    function = None
+    location = None
+    for line in text.splitlines():
+        match = _HEADER_RE.match(line)
+        if match:
+            function = Function(match.group(2), int(match.group(1), 16))
+            functions[function.name] = function
+            location = None
+            continue
+        match = _LOCATION_RE.match(line)
+        if match:
+            location = (match.group(1), int(match.group(2)))
+            continue
+        match = _INSTRUCTION_RE.match(line)
+        if match and function is not None and '\t' in line:
+            # Instructions are the only lines with a tab, after the address.
+            function.instructions.append(Instruction(int(match.group(1), 16), match.group(2),
+                                                     match.group(3).strip(), location))
+
+    by_start = sorted(functions.values(), key=lambda f: f.start)
+    for function, following in zip(by_start, by_start[1:] + [None]):
+        if following is not None and following.start > function.start:
+            function.end = following.start
+        elif function.instructions:
+            function.end = function.instructions[-1].address + 1
+        else:
+            function.end = function.start
+    return functions
+
+
+_ANNOTATION_RE = re.compile(r'/\*\s*loop bound:\s*(.+?)\s*\*/')
+_EXPRESSION_RE = re.compile(r'^[0-9\s()+\-*/%]+$')
+
+
+def evaluate_bound(expression, retries=None):
+    """Evaluate the integer expression of a loop bound annotation.
+
+    'retries' is the value of the name 'retries' in the expression, which is invalid if it is None.
+
+    """
+    expression = re.sub(r'\b(\d+)[uUlL]+\b', r'\1', expression)
+    if retries is not None:
+        expression = re.sub(r'\bretries\b', str(retries), expression)
+    if not _EXPRESSION_RE.match(expression):
+        raise ValueError("Invalid loop bound expression '{}'".format(expression))
+    return int(eval(expression.replace('/', '//'), {'__builtins__': {}}))
+
+
+def parse_loop_bounds(path, lines, retries=None):
+    """Return the loop bound annotations in the given source lines as a list of (first, last, bound, assumed) tuples.
+
+    'first' and 'last' are the line numbers of the annotated loop statement, including its body.
+    'assumed' is true if the bound depends on the assumed number of 'retries'.
+
+    """
+    bounds = []
+    for idx, line in enumerate(lines):
+        match = _ANNOTATION_RE.search(line)
+        if not match:
+            continue
+        try:
+            bound = evaluate_bound(match.group(1), retries)
+        except (ValueError, SyntaxError, ZeroDivisionError):
+            raise ValueError("{}:{}: invalid loop bound '{}'".format(path, idx + 1, match.group(1)))
+        # The loop statement ends at the brace that closes its body or at the semicolon that ends it.
+        # A do-while loop ends at the semicolon after its condition, which follows the brace that closes its body.
+        is_do = re.match(r'\s*do\b', lines[idx + 1]) if idx + 1 < len(lines) else False
+        parens = braces = 0
+        last = idx + 1
+        for last in range(idx + 1, len(lines)):
+            ended = False
+            for char in lines[last].split('//')[0]:
+                if char == '(':
+                    parens += 1
+                elif char == ')':
+                    parens -= 1
+                elif char == '{':
+                    braces += 1
+                elif char == '}':
+                    braces -= 1
+                    ended = braces == 0 and parens == 0 and not is_do
+                elif char == ';':
+                    ended = braces == 0 and parens == 0
+                if ended:
+                    break
+            if ended:
+                break
+        assumed = re.search(r'\bretries\b', match.group(1)) is not None
+        bounds.append((idx + 2, last + 1, bound, assumed))
+    return bounds
+
+
+# 'assumed' is true if the cost depends on the assumed number of retries of loops that repeat when interrupted.
+Result = namedtuple('Result', 'cost reasons blocking returns assumed')
+
+
+class Analysis:
+    """The worst-case instruction counts of the functions in a disassembled image.
+
+    'functions' is the result of parse_disassembly().
+    'read_source' returns the lines of a source file named in the debug line information, or None if it is not
+    available.
+    'retries' is the assumed largest number of iterations of a loop that repeats when an interrupt intervenes.
+
+    """
+    def __init__(self, functions, arch, read_source, retries=2):
+        self.functions = functions
+        self.classify, self.switch_functions, self.handlers = ARCHITECTURES[arch]
+        self.by_start = {f.start: f for f in functions.values()}
+        self.read_source = read_source
+        self.retries = retries
+        self.loops = []
+        self._results = {}
+        self._bounds = {}
+        self._in_progress = set()
+
+    def loop_bound(self, path, lines):
+        """The (bound, assumed) pair of the innermost annotated loop in 'path' that contains all of 'lines', or
+        (None, False)."""
+        if path not in self._bounds:
+            source = self.read_source(path)
+            self._bounds[path] = parse_loop_bounds(path, source, self.retries) if source is not None else []
+        candidates = [b for b in self._bounds[path] if all(b[0] <= line <= b[1] for line in lines)]
+        if not candidates:
+            return None, False
+        return min(candidates, key=lambda b: b[1] - b[0])[2:]
+
+    def function(self, name):
+        """Return the Result of analysing the named function."""
+        if name in self._results:
+            return self._results[name]
+        if name in self._in_progress:
+            return Result(None, {'recursion through {}'.format(name)}, False, True, False)
+        function = self.functions.get(name)
+        # The stub of a dynamically linked function only branches to a function in another image.
+        if function is None or name.endswith('@plt'):
+            return Result(None, {'calls {}, which is not in the image'.format(name.split('@')[0])}, False,
+                          name.split('@')[0] not in _NO_RETURN, False)
+        self._in_progress.add(name)
+        result = _FunctionAnalysis(self, function).result()
+        self._in_progress.discard(name)
+        self._results[name] = result
+        return result
+
+    def call(self, address, operands):
+        """Return the Result of a call to the given address."""
+        callee = self.by_start.get(address)
+        name = callee.name if callee is not None else _target(operands)[1]
+        if name is None:
+            return Result(None, {'branch to an unknown address'}, False, True, False)
+        if name in self.switch_functions:
+            return Result(0, set(), True, True, False)
+        return self.function(name)
+
+
+class _FunctionAnalysis:
+    def __init__(self, analysis, function):
+        self.analysis = analysis
+        self.function = function
+        self.instructions = function.instructions
+        self.kinds = [analysis.classify(i.mnemonic, i.operands) for i in self.instructions]
+
+    def inside(self, address):
+        return address is not None and self.function.start <= address < self.function.end
+
+    def where(self, idx):
+        location = self.instructions[idx].location
+        if location is not None:
+            return '{}:{}'.format(*location)
+        return '{:#x}'.format(self.instructions[idx].address)
+
+    def result(self):
+        if not self.instructions:
+            return Result(None, {'{} has no instructions'.format(self.function.name)}, False, True, False)
+        if not self._build_blocks():
+            return Result(None, self.reasons, False, True, False)
+        reachable = self._reachable()
+        if not any(self.exits[b] for b in reachable):
+            return Result(None, set(), False, False, False)
+        loops = self._loops(reachable)
+        if loops is None:
+            return Result(None, {'irreducible control flow in {}'.format(self.function.name)}, False, True, False)
+        for block in reachable:
+            self.reasons.update(self.block_reasons[block])
+        return self._collapse(reachable, loops)
+
+    def _build_blocks(self):
+        """Split the function into basic blocks with their costs and successors; returns False if that fails."""
+        instructions, kinds = self.instructions, self.kinds
+        index = {i.address: idx for idx, i in enumerate(instructions)}
+        self.reasons = set()
+
+        # A call or branch to another function is a call; a branch to another function is also a tail call.
+        calls = {}
+        leaders = {0}
+        for idx, (kind, target) in enumerate(kinds):
+            if kind == CALL or kind in (JUMP, COND_JUMP) and not self.inside(target):
+                calls[idx] = self.analysis.call(target, instructions[idx].operands)
+            if kind in (JUMP, COND_JUMP) and self.inside(target):
+                if target not in index:
+                    self.reasons.add('branch into an instruction at {:#x}'.format(target))
+                    return False
+                leaders.add(index[target])
+            if kind != OTHER and (kind != CALL or not calls[idx].returns):
+                leaders.add(idx + 1)
+        self.leaders = sorted(leader for leader in leaders if leader < len(instructions))
+
+        self.ends, self.cost, self.succs, self.exits, self.blocking, self.block_reasons = {}, {}, {}, {}, {}, {}
+        self.assumed = {}
+        for first, end in zip(self.leaders, self.leaders[1:] + [len(instructions)]):
+            cost, succs, exits, blocking, reasons, assumed = end - first, [], False, False, set(), False
+            for idx in range(first, end):
+                kind, target = kinds[idx]
+                if kind == INDIRECT_CALL:
+                    reasons.add('indirect call at {} in {}'.format(self.where(idx), self.function.name))
+                if kind == INDIRECT_JUMP:
+                    reasons.add('indirect branch at {} in {}'.format(self.where(idx), self.function.name))
+                if idx not in calls:
+                    continue
+                blocking = blocking or calls[idx].blocking
+                assumed = assumed or calls[idx].assumed
+                if not calls[idx].returns:
+                    # The path ends here.
+                    end = idx + 1
+                    break
+                reasons.update(calls[idx].reasons)
+                if calls[idx].cost is not None:
+                    cost += calls[idx].cost
+            else:
+                kind, target = kinds[end - 1]
+                if kind in (JUMP, COND_JUMP) and self.inside(target):
+                    succs.append(index[target])
+                exits = kind in (RETURN, COND_RETURN, INDIRECT_JUMP) or kind in (JUMP, COND_JUMP) and end - 1 in calls
+                if kind not in (JUMP, RETURN, INDIRECT_JUMP, STOP) and end < len(instructions):
+                    succs.append(end)
+            self.ends[first] = end
+            self.cost[first] = None if reasons else cost
+            self.succs[first] = succs
+            self.exits[first] = exits
+            self.blocking[first] = blocking
+            self.block_reasons[first] = reasons
+            self.assumed[first] = assumed
+        return True
+
+    def _reachable(self):
+        reachable, stack = set(), [0]
+        while stack:
+            block = stack.pop()
+            if block not in reachable:
+                reachable.add(block)
+                stack.extend(self.succs[block])
+        return reachable
+
+    def _loops(self, reachable):
+        """Return the natural loops of the reachable blocks as {header: body}, or None if the flow is irreducible."""
+        preds = {b: set() for b in reachable}
+        for b in reachable:
+            for t in self.succs[b]:
+                preds[t].add(b)
+
+        # Dominators, by iteration to a fixed point.
+        dom = {b: set(reachable) for b in reachable}
+        dom[0] = {0}
+        changed = True
+        while changed:
+            changed = False
+            for b in sorted(reachable - {0}):
+                new = set.intersection(*(dom[p] for p in preds[b])) | {b}
+                if new != dom[b]:
+                    dom[b] = new
+                    changed = True
+
+        # In a reducible flow graph every retreating edge of a depth-first search goes to a dominator.
+        loops = {}
+        active, done = {0}, set()
+        stack = [(0, iter(self.succs[0]))]
+        while stack:
+            block, successors = stack[-1]
+            for t in successors:
+                if t in active:
+                    if t not in dom[block]:
+                        return None
+                    body = loops.setdefault(t, {t})
+                    work = [block]
+                    while work:
+                        b = work.pop()
+                        if b not in body:
+                            body.add(b)
+                            work.extend(preds[b])
+                elif t not in done:
+                    active.add(t)
+                    stack.append((t, iter(self.succs[t])))
+                    break
+            else:
+                active.discard(block)
+                done.add(block)
+                stack.pop()
+        return loops
+
+    def _collapse(self, reachable, loops):
+        """Collapse the loops, innermost first, into nodes whose cost bounds all of their iterations, and return the
+        Result for the longest path from the entry to an exit."""
+        rep = {b: b for b in reachable}
+        members = {b: {b} for b in reachable}
+        cost = {b: self.cost[b] for b in reachable}
+        blocking = {b: self.blocking[b] for b in reachable}
+        exits = {b: self.exits[b] for b in reachable}
+        assumed = any(self.assumed[b] for b in reachable)
+
+        def succs(node):
+            return {rep[t] for b in members[node] for t in self.succs[b]} - {node}
+
+        for header, body in sorted(loops.items(), key=lambda item: len(item[1])):
+            nodes = {rep[b] for b in body}
+            head = rep[header]
+            width = _longest(head, lambda n: (succs(n) & nodes) - {head}, cost)
+
+            # Compilers attribute the branches back to the header to the loop statement itself, while the header
+            # may be any part of the loop body after loop rotation.
+            latches = [self.ends[b] - 1 for b in body if header in self.succs[b]]
+            locations = [self.instructions[idx].location for idx in latches]
+            where = self.where(max(latches))
+            bound, bound_assumed = None, False
+            if None not in locations and len({path for path, _ in locations}) == 1:
+                bound, bound_assumed = self.analysis.loop_bound(locations[0][0], [line for _, line in locations])
+            assumed = assumed or bound_assumed
+            is_blocking = any(blocking[n] for n in nodes)
+            if bound is None and is_blocking:
+                # One iteration before the context switch, and one after it.
+                bound = 1
+            # A loop that is never left, e.g., after a fatal error, ends the paths through it.
+            leaves = any(exits[n] or succs(n) - nodes for n in nodes)
+            if bound is None and leaves:
+                self.reasons.add('loop at {} in {} has no bound'.format(where, self.function.name))
+            if leaves:
+                self.analysis.loops.append((self.function.name, where, bound))
+
+            node = ('loop', header)
+            members[node] = set().union(*(members[n] for n in nodes))
+            for b in members[node]:
+                rep[b] = node
+            # The loop header may execute once more than the body.
+            cost[node] = None if bound is None or width is None else (bound + 1) * width
+            blocking[node] = is_blocking
+            exits[node] = any(exits[n] for n in nodes)
+
+        total = _longest(rep[0], succs, cost, lambda n: exits[n])
+        return Result(total, self.reasons if total is None else set(), any(blocking.values()), True, assumed)
+
+
+def _longest(start, successors, cost, is_end=None):
+    """Return the largest total cost of a path from 'start', ending at any node or, if given, at a node for which
+    'is_end' is true.
+
+    Returns None if a cost on such a path is unknown.
+
+    """
+    memo = {}
+
+    # Returns -1 for nodes from which no path reaches an end.
+    def longest(node):
+        if node in memo:
+            return memo[node]
+        memo[node] = None
+        best = 0 if is_end is None or is_end(node) else -1
+        unknown = False
+        for succ in successors(node):
+            value = longest(succ)
+            if value is None:
+                unknown = True
+            else:
+                best = max(best, value)
+        if unknown:
+            memo[node] = None
+        elif best < 0:
+            memo[node] = -1
+        elif cost[node] is None:
+            memo[node] = None
+        else:
+            memo[node] = best + cost[node]
+        return memo[node]
+
+    value = longest(start)
+    return None if value is None or value < 0 else value
+
+
+def report(disassembly, arch, read_source, prefix='rtos', limits=(), retries=2):
+    """Analyse the given disassembly and return the text of a report and the entry points that exceed their limits.
+
+    The entry points are the kernel API functions, whose names start with the given prefix, and the architecture's
+    exception handlers.
+    'limits' is a sequence of (pattern, instructions) pairs.
+    An entry point exceeds its limit if its bound, or unknown bound, is larger than the limit of any matching pattern.
+    'retries' is the assumed largest number of iterations of a loop that repeats when an interrupt intervenes, and
+    the report marks the bounds that depend on it.
+
+    """
+    if retries < 1:
+        raise ValueError("The assumed number of retries must be at least 1, not {}".format(retries))
+    analysis = Analysis(parse_disassembly(disassembly), arch, read_source, retries)
+
+    def is_entry_point(name):
+        return (fnmatch.fnmatchcase(name, prefix + '_*') and not fnmatch.fnmatchcase(name, prefix + '_internal_*') or
+                any(fnmatch.fnmatchcase(name, pattern) for pattern in analysis.handlers))
+
+    rows, notes, exceeded, assumed = [], [], [], False
+    for function in sorted(analysis.functions.values(), key=lambda f: f.start):
+        if not is_entry_point(function.name):
+            continue
+        result = analysis.function(function.name)
+        if not result.returns:
+            rows.append(('-', function.name, 'does not return'))
+            continue
+        flags = ['blocking'] if result.blocking else []
+        if result.assumed and result.cost is not None:
+            flags.append('assumes {} retries'.format(retries))
+            assumed = True
+        limits_matching = [limit for pattern, limit in limits if fnmatch.fnmatchcase(function.name, pattern)]
+        if limits_matching and (result.cost is None or result.cost > min(limits_matching)):
+            flags.append('EXCEEDS LIMIT {}'.format(min(limits_matching)))
+            exceeded.append(function.name)
+        rows.append(('unknown' if result.cost is None else result.cost, function.name, ', '.join(flags)))
+        notes += ['{}: {}'.format(function.name, reason) for reason in sorted(result.reasons)]
+
+    lines = ['{:>12}  {}'.format('instructions', 'entry point')]
+    lines += ['{:>12}  {}{}'.format(cost, name, ' ({})'.format(flags) if flags else '') for cost, name, flags in rows]
+    if analysis.loops:
+        lines += ['', '{:>12}  {}'.format('iterations', 'loop')]
+        lines += ['{:>12}  {} in {}'.format('unbounded' if bound is None else bound, where, function)
+                  for function, where, bound in sorted(set(analysis.loops), key=lambda l: (l[1], l[0]))]
+    if assumed:
+        lines += ['', 'Bounds that assume {} retries hold only if each loop that repeats when an interrupt '
+                  'intervenes is interrupted at most {} times per execution.'.format(retries, retries - 1)]
+    if notes:
+        lines += ['', 'Unknown bounds:'] + ['  ' + note for note in notes]
+    return '\n'.join(lines) + '\n', exceeded
@@ -63,7 +63,9 @@ _logging.basicConfig = error_fn
 
 from xml.parsers.expat import ExpatError
 import argparse
+import concurrent.futures
 import functools
+import hashlib
 import imp
 import inspect
 import os
@@ -74,10 +76,12 @@ import shutil
 import signal
 import subprocess
 import sys
+import threading
 import traceback
 from util.xml import UserError, NOTHING, xml_parse_file, single_text_child, maybe_single_named_child,\
     xml_parse_file_with_includes, xml_parse_string, get_attribute, single_named_child, xml2schema,\
     xml2dict, SystemParseError, xml_error_str, maybe_get_element_list, check_schema_is_valid, SchemaInvalidError
+import util.wcet
 
 # Configure the pystache module
 pystache.defaults.MISSING_TAGS = 'strict'
@@ -143,19 +147,69 @@ def pystache_render(file_in, file_out, config):
     # Note: This can only be used on integer values
     renderer.register_formatter('hex', lambda x: str(hex(int(x))))
 
-    with open(file_in, 'r') as inp:
-        template_data = inp.read()
-
     try:
-        parsed_template = pystache.parser.parse(template_data, name=file_in)
+        parsed_template = _parse_template(file_in)
         data = renderer.render(parsed_template, config)
     except pystache.common.PystacheError as e:
         raise SystemBuildError("Error rendering template '{}'. {}.".format(e.location, str(e)))
 
     os.makedirs(os.path.dirname(file_out), exist_ok=True)
 
-    with open(file_out, 'w') as outp:
-        outp.write(data)
+    write_if_changed(file_out, data)
+
+
+# Parsed templates, keyed on their file path, and validated against the file's modification time and size.
+# Templates shared by several systems built in one process are thus only parsed once.
+_parsed_templates = {}
+
+
+def _parse_template(file_in):
+    stat = os.stat(file_in)
+    key = (stat.st_mtime_ns, stat.st_size)
+    entry = _parsed_templates.get(file_in)
+    if entry is None or entry[0] != key:
+        with open(file_in, 'r') as inp:
+            template_data = inp.read()
+        entry = (key, pystache.parser.parse(template_data, name=file_in))
+        _parsed_templates[file_in] = entry
+    return entry[1]
+
+
+def write_if_changed(path, data):
+    """Write the string `data` to the file `path`, unless the file already contains exactly `data`.
+
+    Leaving an unchanged file untouched preserves its modification time, so that later build steps can tell that it
+    has not changed.
+    Returns True if the file was written.
+
+    """
+    try:
+        with open(path, 'r') as f:
+            if f.read() == data:
+                return False
+    except (FileNotFoundError, UnicodeDecodeError):
+        pass
+
+    with open(path, 'w') as f:
+        f.write(data)
+    return True
+
+
+def copy_if_changed(src, dst):
+    """Copy the file `src` to `dst`, unless `dst` already has the same content.
+
+    Returns True if the file was copied.
+
+    """
+    if os.path.exists(dst) and _file_digest(src) == _file_digest(dst):
+        return False
+    shutil.copyfile(src, dst)
+    return True
+
+
+def _file_digest(path):
+    with open(path, 'rb') as f:
+        return hashlib.sha256(f.read()).digest()
 
 
 # We don't want byte-code written to disk for any of the plug-ins that we load,
@@ -227,13 +281,193 @@ def execute(args, **kwargs):
     cmd_line = ' '.join(args)
     logger.info('Executing: %s' % cmd_line)
     try:
-        code = subprocess.call(args, **kwargs)
+        with _job_slots:
+            code = subprocess.call(args, **kwargs)
     except FileNotFoundError as exc:
         raise SystemBuildError("Command {} raise exception: {}".format(cmd_line, exc))
     if code != 0:
         raise SystemBuildError("Command {} returned non-zero error code: {}".format(cmd_line, code))
 
 
+# The number of commands that execute() may run at the same time, across all threads.
+# It is configured through set_jobs(), e.g., by the '--jobs' command line option.
+_jobs = 1
+_job_slots = threading.BoundedSemaphore(_jobs)
+
+
+def set_jobs(jobs):
+    """Set the number of commands that may execute concurrently, and the number of threads used by run_parallel()."""
+    global _jobs, _job_slots
+    _jobs = max(1, jobs)
+    _job_slots = threading.BoundedSemaphore(_jobs)
+
+
+def run_parallel(functions):
+    """Call each of the argument-less `functions`, running as many of them concurrently as set_jobs() allows.
+
+    All functions are run to completion, even if some of them fail.
+    If any of them raises an exception, the exception of the first failing function in `functions` is then re-raised.
+    Returns the list of their return values.
+
+    """
+    functions = list(functions)
+    if _jobs == 1 or len(functions) <= 1:
+        return [f() for f in functions]
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=_jobs) as executor:
+        futures = [executor.submit(f) for f in functions]
+    return [future.result() for future in futures]
+
+
+def _compiler_identity(compiler):
+    """Return a string that changes whenever the executable that the command name `compiler` runs changes."""
+    path = shutil.which(compiler)
+    if path is None:
+        return compiler
+    path = os.path.realpath(path)
+    stat = os.stat(path)
+    return '{}\0{}\0{}'.format(path, stat.st_size, stat.st_mtime_ns)
+
+
+def compile_cached(args, source, output, cache_dir):
+    """Execute the compiler command `args`, which compiles the C file `source` to the object file `output`.
+
+    If `cache_dir` is not None, the object file is taken from, or added to, the object cache in that directory.
+    Cached objects are keyed on the preprocessed source, the command line, the working directory, and the compiler
+    executable, identified by its resolved path, size, and modification time, so that upgrading the compiler
+    invalidates the objects it produced.
+    The preprocessed source includes the paths of the source and header files, and the working directory ends up in
+    the debug information of the object, so a cached object is only ever reused where compiling would produce the
+    same object.
+
+    `args` must be a gcc-compatible command line with the options '-c' and '-o <output>'.
+
+    """
+    if cache_dir is None:
+        execute(args)
+        return
+
+    preprocess_args = []
+    skip = False
+    for arg in args:
+        if skip:
+            skip = False
+        elif arg == '-o':
+            skip = True
+        elif arg in ('-MD', '-MMD'):
+            pass
+        else:
+            preprocess_args.append('-E' if arg == '-c' else arg)
+
+    try:
+        with _job_slots:
+            preprocessed = subprocess.check_output(preprocess_args, stderr=subprocess.DEVNULL)
+    except (subprocess.CalledProcessError, FileNotFoundError):
+        # Let the compiler itself report the problem.
+        execute(args)
+        return
+
+    key = hashlib.sha256(preprocessed)
+    key.update('\0'.join('<output>' if arg == output else arg for arg in args).encode())
+    key.update(os.getcwd().encode())
+    key.update(_compiler_identity(args[0]).encode())
+    digest = key.hexdigest()
+    cached = os.path.join(cache_dir, digest[:2], digest + '.o')
+
+    if os.path.exists(cached):
+        logger.info('Cached: %s -> %s', source, output)
+        shutil.copyfile(cached, output)
+        return
+
+    execute(args)
+
+    # Write to a temporary file first, so that concurrent builds never see a partially written object.
+    os.makedirs(os.path.dirname(cached), exist_ok=True)
+    temp = '{}.{}.{}'.format(cached, os.getpid(), threading.get_ident())
+    shutil.copyfile(output, temp)
+    os.replace(temp, cached)
+
+
+def size_report(map_file):
+    """Return a report of the image size contributed by each input file, parsed from the GNU ld map file `map_file`.
+
+    Sizes are reported in the same categories as the 'size' tool: 'text' is code and read-only data, 'data' is
+    initialised data, and 'bss' is zero-initialised data.
+    Input sections discarded by the linker, e.g., through '--gc-sections', are not counted.
+
+    """
+    categories = (('text', ('.vectors', '.undefined', '.text', '.rodata')),
+                  ('data', ('.data',)),
+                  ('bss', ('.bss',)))
+    sizes = {}
+
+    with open(map_file) as f:
+        lines = f.read().splitlines()
+
+    try:
+        start = lines.index('Linker script and memory map')
+    except ValueError:
+        raise SystemBuildError("'{}' is not a GNU ld map file.".format(map_file))
+
+    output_section = None
+    for line, next_line in zip(lines[start:], lines[start + 1:] + ['']):
+        if line and not line[0].isspace():
+            output_section = line.split()[0]
+            continue
+        # Input sections are indented by one space.
+        # Long input section names are followed by a line break before the address, size, and input file.
+        if not line.startswith(' ') or line.startswith('  '):
+            continue
+        fields = line.split()
+        if len(fields) == 1 and next_line.startswith('  '):
+            fields += next_line.split()
+        if len(fields) < 4 or fields[0] == '*fill*' or not fields[1].startswith('0x') or \
+                not fields[2].startswith('0x'):
+            continue
+
+        for category, prefixes in categories:
+            if output_section is not None and output_section.startswith(prefixes):
+                obj = os.path.basename(' '.join(fields[3:]))
+                obj_sizes = sizes.setdefault(obj, dict.fromkeys((name for name, _ in categories), 0))
+                obj_sizes[category] += int(fields[2], 16)
+                break
+
+    names = [name for name, _ in categories]
+    rows = sorted(sizes.items(), key=lambda item: (-sum(item[1].values()), item[0]))
+    totals = {name: sum(obj_sizes[name] for _, obj_sizes in rows) for name in names}
+    report = ['{:>8} {:>8} {:>8}  {}'.format(*(names + ['file']))]
+    report += ['{:8} {:8} {:8}  {}'.format(*([obj_sizes[name] for name in names] + [obj])) for obj, obj_sizes in rows]
+    report.append('{:8} {:8} {:8}  {}'.format(*([totals[name] for name in names] + ['(total)'])))
+    return '\n'.join(report) + '\n'
+
+
+def wcet_report(disassembly_file, arch, limits=(), retries=2):
+    """Return a report of the worst-case instruction counts of the kernel entry points of an image, and the names of
+    the entry points that exceed their limits.
+
+    `disassembly_file` contains the output of 'objdump -d -l --no-show-raw-insn' for the image, which must contain
+    debug line information.
+    `arch` selects the instruction set, one of the keys of util.wcet.ARCHITECTURES.
+    `limits` is a sequence of (entry point name pattern, instructions) pairs.
+    `retries` is the assumed largest number of iterations of loops that repeat when an interrupt intervenes.
+    See util.wcet for the analysis and the loop bound annotations in the C source that it relies on.
+
+    """
+    def read_source(path):
+        try:
+            with open(path) as f:
+                return f.read().splitlines()
+        except OSError:
+            return None
+
+    with open(disassembly_file) as f:
+        disassembly = f.read()
+    try:
+        return util.wcet.report(disassembly, arch, read_source, limits=limits, retries=retries)
+    except ValueError as exc:
+        raise SystemBuildError(str(exc))
+
+
 class Header:
     """Header is a very simple container class that keeps track of an XML element
     that is associated with a header file name.
@@ -395,7 +629,7 @@ xml_schema_path) set as a class member.".format(self.__class__.__name__,
                 if f.get('render', False):
                     pystache_render(input_path, output_path, config)
                 else:
-                    shutil.copyfile(input_path, output_path)
+                    copy_if_changed(input_path, output_path)
             except FileNotFoundError as e:
                 raise SystemBuildError("File not found error during template preparation '{}'.".format(e.filename))
 
@@ -540,7 +774,7 @@ class SourceModule(NamedModule):
         if self.code_gen is None:
             if copy_all_files:
                 path = os.path.join(system.output, os.path.basename(self.filename))
-                shutil.copyfile(self.filename, path)
+                copy_if_changed(self.filename, path)
                 logger.info("Preparing: copy %s -> %s", self.filename, path)
                 system.add_file(path)
             else:
@@ -559,7 +793,7 @@ class SourceModule(NamedModule):
             path = os.path.join(system.output, os.path.basename(header.path))
             try:
                 if header.code_gen is None:
-                    shutil.copyfile(header.path, path)
+                    copy_if_changed(header.path, path)
                 elif header.code_gen == 'template':
                     logger.info("Preparing: template %s -> %s (%s)", header.path, path, config)
                     pystache_render(header.path, path, config)
@@ -642,6 +876,11 @@ class System:
         global_includes = ["/home/schnommos/Dev/echronos/packages/machine-stellaris-evalbot/stellarisware-min", "/home/schnommos/Dev/echronos/packages/machine-stellaris-evalbot/stellarisware-min/boards/ek-evalbot" ]
         return [self.output] + global_includes
 
+    @property
+    def object_cache(self):
+        """The directory of the object cache that builders should pass to compile_cached(), or None."""
+        return self.project.object_cache
+
     @property
     def c_files(self):
         return self._c_files
@@ -914,6 +1153,10 @@ class Project:
         else:
             self.output = os.path.join(self.project_dir, path)
 
+        # Compiled objects are shared between all systems of the project through a cache in the output directory.
+        # Setting object_cache to None disables the cache.
+        self.object_cache = os.path.join(self.output, '.objcache')
+
     def entity_name_to_path(self, entity_name):
         """Looks up an entity definition in the search paths by its specified `entity_name`.
 
@@ -1044,16 +1287,52 @@ def generate(args):
 
 
 def build(args):
-    """Build the system specified on the command line from its source modules into a binary.
+    """Build the systems specified on the command line from their source modules into binaries.
 
     `args` is expected to provide the following attributes:
     - `project`: an instance of Project
-    - `system`: the name of a system entity to instantiate and build
+    - `system`: a list of names of system entities to instantiate and build
+    - `jobs`: the number of compiler processes to run concurrently
+    - `no_object_cache`: whether to disable the object cache
+
+    Up to `jobs` compiler processes run concurrently, both across the files of a system and across systems.
+    All systems are built, even if building one of them fails.
 
     This function returns 0 on success and 1 if an error occurs.
 
     """
-    return call_system_function(args, System.build)
+    set_jobs(args.jobs)
+    if args.no_object_cache:
+        args.project.object_cache = None
+
+    if args.output and len(args.system) > 1:
+        logger.error("The output directory can only be specified when building a single system.")
+        return 1
+
+    systems = []
+    for system_name in args.system:
+        system = _load_system(args, system_name)
+        if system is None:
+            return 1
+        # Importing and instantiating modules is not thread-safe, so do this before building in parallel.
+        try:
+            system._instances
+        except UserError as e:
+            logger.error(str(e))
+            return 1
+        systems.append(system)
+
+    def build_system(system):
+        logger.info("Invoking 'build' on system '{}'".format(system.name))
+        try:
+            system.build()
+        except UserError as e:
+            logger.error("{}: {}".format(system.name, e))
+            return 1
+        return 0
+
+    results = run_parallel(functools.partial(build_system, system) for system in systems)
+    return max([0] + results)
 
 
 def load(args):
@@ -1071,12 +1350,31 @@ def load(args):
 
 def call_system_function(args, function, extra_args=None, sys_is_path=False):
     """Instantiate a system and call the given member function of the System class on it."""
-    project = args.project
-    system_name = args.system
-
     if extra_args is None:
         extra_args = {}
 
+    system = _load_system(args, args.system, sys_is_path)
+    if system is None:
+        return 1
+
+    logger.info("Invoking '{}' on system '{}'".format(function.__name__, system.name))
+    try:
+        function(system, **extra_args)
+    except UserError as e:
+        logger.error(str(e))
+        return 1
+
+    return 0
+
+
+def _load_system(args, system_name, sys_is_path=False):
+    """Load the system `system_name`, or the system definition file `system_name` if `sys_is_path` is True.
+
+    Returns the System instance, or None after logging an error if the system cannot be loaded.
+
+    """
+    project = args.project
+
     try:
         if sys_is_path:
             system_path = system_name
@@ -1087,27 +1385,20 @@ def call_system_function(args, function, extra_args=None, sys_is_path=False):
         else:
             if not valid_entity_name(system_name):
                 logger.error("System name '{}' is invalid.".format(system_name))
-                return 1
+                return None
             logger.info("Loading system: {}".format(system_name))
             system = project.find(system_name)
     except EntityLoadError as e:
         logger.error("Unable to load system [{}]: {}".format(system_name, e))
-        return 1
+        return None
     except EntityNotFoundError:
         logger.error("Unable to find system [{}].".format(system_name))
-        return 1
+        return None
 
     if args.output:
         system.output = args.output
 
-    logger.info("Invoking '{}' on system '{}'".format(function.__name__, system.name))
-    try:
-        function(system, **extra_args)
-    except UserError as e:
-        logger.error(str(e))
-        return 1
-
-    return 0
+    return system
 
 
 SUBCOMMAND_TABLE = {
@@ -1137,8 +1428,12 @@ def get_command_line_arguments():
     build_parser = subparsers.add_parser('gen', help='Generate source code for a system')
     build_parser.add_argument('system', help='system to generate source for')
 
-    build_parser = subparsers.add_parser('build', help='Build a system and create a system image')
-    build_parser.add_argument('system', help='system to build')
+    build_parser = subparsers.add_parser('build', help='Build systems and create system images')
+    build_parser.add_argument('system', nargs='+', help='systems to build')
+    build_parser.add_argument('--jobs', '-j', type=int, default=1,
+                              help='number of compiler processes to run concurrently')
+    build_parser.add_argument('--no-object-cache', action='store_true',
+                              help='always compile, instead of reusing objects compiled by earlier builds')
 
     load_parser = subparsers.add_parser('load', help='Load a system image onto a device and execute it')
     load_parser.add_argument('system', help='system to load')
@@ -30,13 +30,30 @@ import subprocess
 import sys
 import tempfile
 from xml.parsers.expat import ExpatError
-from prj import get_command_line_arguments, Project, valid_entity_name, System
+from prj import get_command_line_arguments, Project, valid_entity_name, System, write_if_changed, compile_cached,\
+    run_parallel, set_jobs, size_report, wcet_report, SystemBuildError
 from util.xml import SystemParseError, xml_parse_file_with_includes, xml_parse_string, xml_parse_file, xml2dict,\
     single_text_child, dict_has_keys, check_schema_is_valid, SchemaInvalidError, list_all_equal,\
     asdict, check_ident, get_attribute, ensure_unique_tag_names, element_children, ensure_all_children_named
 from nose.tools import assert_raises, raises
 
 base_dir = os.path.dirname(__file__)
+packages_dir = os.path.join(base_dir, os.path.pardir, os.path.pardir, 'packages')
+
+
+def _generate_system(modules):
+    """Generate a system with the given module definitions from the packages of this repository.
+
+    Systems that use an RTOS module depend on the RTOS packages that 'x.py build packages' generates.
+
+    """
+    with tempfile.TemporaryDirectory() as temp_dir:
+        prx = os.path.join(temp_dir, 'system.prx')
+        write_if_changed(prx, '<system><modules>{}</modules></system>'.format(modules))
+        project = Project(None, search_paths=[packages_dir])
+        system = project._parse_import('system', prx)
+        system.output = os.path.join(temp_dir, 'out')
+        system.generate(copy_all_files=False)
 
 
 def test_dict_has_keys():
@@ -695,6 +712,135 @@ def test_xml_include_paths():
         assert p._prx_include_paths == ['1', '2', 'a', 'b']
 
 
+def test_build_arguments():
+    sys.argv[1:] = ['build', '-j', '4', 'a.b', 'c.d']
+    args = get_command_line_arguments()
+    assert args.system == ['a.b', 'c.d']
+    assert args.jobs == 4
+    assert not args.no_object_cache
+
+
+def test_write_if_changed():
+    with tempfile.TemporaryDirectory() as temp_dir:
+        path = os.path.join(temp_dir, 'foo.c')
+        assert write_if_changed(path, 'foo')
+        assert not write_if_changed(path, 'foo')
+        assert write_if_changed(path, 'bar')
+        with open(path) as f:
+            assert f.read() == 'bar'
+
+
+def test_run_parallel():
+    set_jobs(4)
+    try:
+        assert run_parallel([lambda: 1, lambda: 2, lambda: 3]) == [1, 2, 3]
+
+        def fail():
+            raise ValueError()
+        with assert_raises(ValueError):
+            run_parallel([lambda: 1, fail])
+    finally:
+        set_jobs(1)
+
+
+def test_compile_cached():
+    with tempfile.TemporaryDirectory() as temp_dir:
+        source = os.path.join(temp_dir, 'foo.c')
+        output = os.path.join(temp_dir, 'foo.o')
+        cache_dir = os.path.join(temp_dir, 'cache')
+        args = ['gcc', '-c', source, '-o', output]
+
+        write_if_changed(source, 'int foo;\n')
+        compile_cached(args, source, output, cache_dir)
+        assert os.path.exists(output)
+        cached = [os.path.join(d, f) for d, _, files in os.walk(cache_dir) for f in files]
+        assert len(cached) == 1
+
+        # A cache hit takes the object from the cache instead of compiling it.
+        with open(cached[0], 'w') as f:
+            f.write('cached')
+        compile_cached(args, source, output, cache_dir)
+        with open(output) as f:
+            assert f.read() == 'cached'
+
+        # A change to the source is a cache miss.
+        write_if_changed(source, 'int bar;\n')
+        compile_cached(args, source, output, cache_dir)
+        assert len([f for _, _, files in os.walk(cache_dir) for f in files]) == 2
+
+        # So is a change to the compiler, even if its command line stays the same.
+        compiler = os.path.join(temp_dir, 'cc')
+        write_if_changed(compiler, '#!/bin/sh\nexec gcc "$@"\n')
+        os.chmod(compiler, 0o755)
+        args[0] = compiler
+        compile_cached(args, source, output, cache_dir)
+        assert len([f for _, _, files in os.walk(cache_dir) for f in files]) == 3
+        compile_cached(args, source, output, cache_dir)
+        assert len([f for _, _, files in os.walk(cache_dir) for f in files]) == 3
+        stat = os.stat(compiler)
+        os.utime(compiler, ns=(stat.st_atime_ns, stat.st_mtime_ns + 1000000000))
+        compile_cached(args, source, output, cache_dir)
+        assert len([f for _, _, files in os.walk(cache_dir) for f in files]) == 4
+
+
+def test_size_report():
+    with tempfile.TemporaryDirectory() as temp_dir:
+        source = os.path.join(temp_dir, 'foo.c')
+        obj = os.path.join(temp_dir, 'foo.o')
+        map_file = os.path.join(temp_dir, 'system.map')
+        write_if_changed(source, 'int foo = 1;\nint bar[4];\nint unused[8];\n'
+                                 'int used(void) { return foo + bar[0]; }\nint unused_function(void) { return 0; }\n'
+                                 'void _start(void) { used(); }\n')
+        subprocess.check_call(['gcc', '-O0', '-fno-asynchronous-unwind-tables', '-ffunction-sections',
+                               '-fdata-sections', '-fno-common', '-c', source, '-o', obj])
+        subprocess.check_call(['ld', '-e', '_start', '--gc-sections', '-Map={}'.format(map_file), '-o',
+                               os.path.join(temp_dir, 'system'), obj])
+
+        report = size_report(map_file).splitlines()
+        assert report[0].split() == ['text', 'data', 'bss', 'file']
+        text, data, bss, name = report[1].split()
+        assert name == 'foo.o'
+        assert (int(data), int(bss)) == (4, 16)
+        assert report[-1].split()[1:] == ['4', '16', '(total)']
+
+
+def test_wcet_report():
+    with tempfile.TemporaryDirectory() as temp_dir:
+        source = os.path.join(temp_dir, 'foo.c')
+        system = os.path.join(temp_dir, 'system')
+        disassembly_file = os.path.join(temp_dir, 'system.dis')
+        write_if_changed(source, 'int table[8];\n'
+                                 'int rtos_sum(int n)\n{\n    int i, sum = 0;\n'
+                                 '    /* loop bound: 8 */\n    for (i = 0; i < n; i++)\n'
+                                 '    {\n        sum += table[i];\n'
+                                 '    }\n    return sum;\n}\n'
+                                 'int rtos_scan(int n)\n{\n    while (table[n] != 0)\n    {\n        n++;\n'
+                                 '    }\n    return n;\n}\n'
+                                 'void _start(void) { rtos_sum(8); rtos_scan(0); }\n')
+        subprocess.check_call(['gcc', '-O0', '-g', '-fno-pic', '-c', source, '-o', system + '.o'])
+        subprocess.check_call(['ld', '-e', '_start', '-o', system, system + '.o'])
+        with open(disassembly_file, 'w') as f:
+            subprocess.check_call(['objdump', '-d', '-l', '--no-show-raw-insn', system], stdout=f)
+
+        report, exceeded = wcet_report(disassembly_file, 'x86_64', [('rtos_*', 1000), ('rtos_sum', 10)])
+        lines = report.splitlines()
+        assert lines[0].split() == ['instructions', 'entry', 'point']
+        cost, name = lines[1].split()[:2]
+        assert name == 'rtos_sum' and 8 * 5 < int(cost) < 1000
+        assert lines[2].split()[:2] == ['unknown', 'rtos_scan']
+        assert '           8  {}:6 in rtos_sum'.format(source) in lines
+        assert any(line.startswith('  rtos_scan: loop at {}:'.format(source)) and line.endswith('has no bound')
+                   for line in lines)
+        assert exceeded == ['rtos_sum', 'rtos_scan']
+
+        # An invalid loop bound annotation is an error of the system build.
+        with open(source) as f:
+            text = f.read()
+        write_if_changed(source, text.replace('loop bound: 8', 'loop bound: n'))
+        with assert_raises(SystemBuildError):
+            wcet_report(disassembly_file, 'x86_64')
+
+
 def test_check_ident():
     check_ident('foo_bar_123')
     with assert_raises(ValueError):
@@ -703,3 +849,65 @@ def test_check_ident():
         check_ident('Foobar')
     with assert_raises(ValueError):
         check_ident('foo_%_')
+
+
+def test_generate_kochab_without_timebase():
+    # The optional timebase dictionary configures as an empty dictionary when it is absent
+    _generate_system("""<module name="armv7m.rtos-kochab">
+  <prefix>rtos</prefix>
+  <mutex><stats>false</stats></mutex>
+  <tasks><task><name>a</name><function>a</function><priority>1</priority><stack_size>256</stack_size></task></tasks>
+</module>""")
+
+
+def _check_vectable_error(options, message):
+    with assert_raises(SystemParseError) as context:
+        _generate_system('<module name="armv7m.vectable">{}</module>'.format(options))
+    assert message in str(context.exception), str(context.exception)
+
+
+def test_vectable_priorities():
+    _generate_system("""<module name="armv7m.vectable">
+  <preemption>true</preemption>
+  <kernel_priority_threshold>0x40</kernel_priority_threshold>
+  <systick>exception_preempt_trampoline_systick</systick>
+  <systick_priority>0xc0</systick_priority>
+  <external_irqs><external_irq><number>5</number><handler>fast_irq</handler><priority>0x20</priority></external_irq>
+  </external_irqs>
+</module>""")
+
+    # Without preemption support, kernel-aware interrupts may have any priority
+    _generate_system("""<module name="armv7m.vectable">
+  <systick>tick_irq</systick>
+  <systick_priority>0xf0</systick_priority>
+</module>""")
+
+
+def test_vectable_threshold_not_representable():
+    _check_vectable_error('<priority_bits>3</priority_bits>'
+                          '<kernel_priority_threshold>0x10</kernel_priority_threshold>',
+                          'kernel_priority_threshold 16 is not a priority value')
+    _check_vectable_error('<kernel_priority_threshold>0xf0</kernel_priority_threshold>',
+                          'kernel_priority_threshold 240 is not a priority value')
+    # A threshold equal to the SVCall priority would let kernel-aware interrupts share the priority of SVCall
+    _check_vectable_error('<kernel_priority_threshold>0xe0</kernel_priority_threshold>',
+                          'kernel_priority_threshold 224 is not a priority value')
+
+
+def test_vectable_zero_latency_trampoline():
+    _check_vectable_error("""<kernel_priority_threshold>0x40</kernel_priority_threshold>
+  <external_irqs><external_irq><number>3</number><handler>exception_preempt_trampoline_uart</handler>
+  <priority>0x30</priority></external_irq></external_irqs>""", 'IRQ 3 is a zero-latency interrupt')
+    # Exceptions without a configured priority have the highest priority
+    _check_vectable_error("""<kernel_priority_threshold>0x40</kernel_priority_threshold>
+  <systick>exception_preempt_trampoline_systick</systick>""", 'systick is a zero-latency interrupt')
+
+
+def test_vectable_kernel_aware_above_svcall():
+    _check_vectable_error("""<preemption>true</preemption>
+  <systick>exception_preempt_trampoline_systick</systick>
+  <systick_priority>0xe0</systick_priority>""",
+                          'systick is a kernel-aware interrupt, so its priority 224 must be below')
+    _check_vectable_error("""<preemption>true</preemption>
+  <external_irqs><external_irq><number>7</number><handler>irq7</handler><priority>0xff</priority></external_irq>
+  </external_irqs>""", 'IRQ 7 is a kernel-aware interrupt, so its priority 240 must be below')
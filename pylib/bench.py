@@ -0,0 +1,321 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+"""Build and run the rtos-bench kernel benchmark systems, record their results, and compare them against a baseline.
+
+Every directory named 'bench' under a 'packages' directory holds one .prx system per RTOS variant supported by its
+platform.
+Each system prints its results as lines of the form 'bench: <name> <param> <iterations> <elapsed>' (see
+packages/rtos-bench/bench.c).
+Elapsed times are in units of the platform's bench clock, so results are only comparable between runs on the same
+platform and host.
+
+"""
+import os
+import re
+import sys
+import json
+import shutil
+import socket
+import fnmatch
+import tempfile
+import subprocess
+
+from .utils import BASE_DIR, base_to_top_paths, top_path, get_executable_extension
+from .cmdline import subcmd, Arg
+
+
+_RESULT_RE = re.compile(r'bench: (\S+) 0x([0-9a-fA-F]+) 0x([0-9a-fA-F]+) 0x([0-9a-fA-F]+)')
+_DONE_LINE = 'bench: done'
+
+_GDB_COMMANDS = """target remote :{port}
+set height 0
+set confirm off
+break bench_report
+commands
+silent
+printf "bench: %s 0x%x 0x%x 0x%x\\n", name, param, iterations, elapsed
+continue
+end
+break bench_done
+commands
+silent
+printf "bench: done\\n"
+kill
+quit
+end
+continue
+"""
+
+
+def _run_native(executable, timeout):
+    return _run(executable, [executable], timeout)
+
+
+def _run_qemu_armv7m(executable, timeout):
+    return _run(executable, ['qemu-system-arm', '-M', 'simple-armv7m', '-nographic', '-semihosting',
+                             '-kernel', executable], timeout)
+
+
+def _run_qemu_ppce500(executable, timeout):
+    # The ppce500 debug output is discarded, so the results are printed by gdb from breakpoints on bench_report and
+    # bench_done.
+    port = _free_port()
+    qemu = subprocess.Popen(['qemu-system-ppc', '-S', '-nographic', '-gdb', 'tcp::{}'.format(port), '-M', 'ppce500',
+                             '-kernel', executable], stdin=subprocess.DEVNULL, stdout=subprocess.DEVNULL)
+    try:
+        with tempfile.NamedTemporaryFile('w', suffix='.gdb', delete=False) as gdb_commands:
+            gdb_commands.write(_GDB_COMMANDS.format(port=port))
+        try:
+            return _run(executable, ['powerpc-linux-gnu-gdb', '--batch', '-nx', executable, '-x', gdb_commands.name],
+                        timeout)
+        finally:
+            os.remove(gdb_commands.name)
+    finally:
+        qemu.terminate()
+        qemu.wait()
+
+
+_PLATFORMS = {
+    'posix': {'tools': ['gcc'], 'run': _run_native, 'unit': 'ns'},
+    'machine-qemu-simple': {'tools': ['arm-none-eabi-gcc', 'qemu-system-arm'], 'run': _run_qemu_armv7m,
+                            'unit': 'cycles'},
+    'machine-qemu-ppce500': {'tools': ['powerpc-linux-gnu-gcc', 'qemu-system-ppc', 'powerpc-linux-gnu-gdb'],
+                             'run': _run_qemu_ppce500, 'unit': 'timebase ticks'},
+}
+
+
+def _free_port():
+    with socket.socket() as s:
+        s.bind(('localhost', 0))
+        return s.getsockname()[1]
+
+
+def _run(executable, command, timeout):
+    """Run a bench system and return its output, up to and including the line marking the end of the benchmarks."""
+    process = subprocess.Popen(command, stdin=subprocess.DEVNULL, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    try:
+        output, _ = process.communicate(timeout=timeout)
+    except subprocess.TimeoutExpired:
+        process.kill()
+        output, _ = process.communicate()
+    return output.decode(errors='replace')
+
+
+def _parse(output):
+    """Convert the output of a bench system into a dictionary {name: {param: result}}.
+
+    Returns None if the output does not contain the line marking the end of the benchmarks.
+
+    """
+    results = {}
+    done = False
+    for line in output.splitlines():
+        line = line.strip()
+        if line == _DONE_LINE:
+            done = True
+            break
+        match = _RESULT_RE.match(line)
+        if match:
+            name = match.group(1)
+            param, iterations, elapsed = (int(g, 16) for g in match.groups()[1:])
+            results.setdefault(name, {})[str(param)] = {
+                'iterations': iterations,
+                'elapsed': elapsed,
+                'per_iteration': elapsed / iterations if iterations else 0,
+            }
+    return results if done else None
+
+
+def _merge_best(results, run_results):
+    """Merge the results of one run into results, keeping the lowest time per iteration of each benchmark."""
+    for name, params in run_results.items():
+        for param, result in params.items():
+            best = results.setdefault(name, {}).get(param)
+            if best is None or result['per_iteration'] < best['per_iteration']:
+                results[name][param] = result
+
+
+def _find_systems(topdir, patterns):
+    systems = []
+    for packages_dir in base_to_top_paths(topdir, 'packages'):
+        for parent, dirs, files in os.walk(packages_dir):
+            dirs.sort()
+            if os.path.basename(parent) != 'bench':
+                continue
+            for file in sorted(files):
+                if file.endswith('.prx'):
+                    rel_path = os.path.relpath(os.path.join(parent, os.path.splitext(file)[0]), packages_dir)
+                    system = rel_path.replace(os.sep, '.')
+                    if not patterns or any(fnmatch.fnmatch(system, p) for p in patterns):
+                        systems.append(system)
+    return systems
+
+
+def _platform(system):
+    return _PLATFORMS.get(system.split('.')[0])
+
+
+def _build(topdir, system, log_path):
+    search_paths = base_to_top_paths(topdir, 'packages')
+    with open(log_path, 'w') as log:
+        return subprocess.call([sys.executable, os.path.join(BASE_DIR, 'prj', 'app', 'prj.py')] +
+                               ['--search-path={}'.format(sp) for sp in search_paths] +
+                               ['build', system], stdout=log, stderr=subprocess.STDOUT) == 0
+
+
+def _run_systems(args):
+    """Build and run the selected bench systems and return the results {system: {'unit': unit, 'results': ...}}."""
+    output_dir = top_path(args.topdir, 'out', 'bench')
+    os.makedirs(output_dir, exist_ok=True)
+
+    results = {}
+    for system in _find_systems(args.topdir, args.systems):
+        platform = _platform(system)
+        if platform is None:
+            print("{}: skipped, no support for running this platform's systems".format(system))
+            continue
+        missing = [tool for tool in platform['tools'] if shutil.which(tool) is None]
+        if missing:
+            print("{}: skipped, not found: {}".format(system, ', '.join(missing)))
+            continue
+
+        log_path = os.path.join(output_dir, system + '.log')
+        if not _build(args.topdir, system, log_path):
+            print("{}: build failed, see {}".format(system, log_path))
+            continue
+
+        executable = top_path(args.topdir, 'out', system.replace('.', os.sep), 'system' + get_executable_extension())
+        system_results = {}
+        for _ in range(args.repeat):
+            output = platform['run'](executable, args.timeout)
+            with open(log_path, 'a') as log:
+                log.write(output)
+            run_results = _parse(output)
+            if run_results is None:
+                system_results = None
+                break
+            _merge_best(system_results, run_results)
+        if system_results is None:
+            print("{}: did not complete, see {}".format(system, log_path))
+            continue
+
+        print("{}: {} benchmarks".format(system, sum(len(r) for r in system_results.values())))
+        results[system] = {'unit': platform['unit'], 'results': system_results}
+    return results
+
+
+def _compare(baseline, current, threshold):
+    """Print the change in time per iteration of each benchmark in current relative to baseline.
+
+    Returns the number of benchmarks that became slower by more than threshold percent.
+
+    """
+    regressions = 0
+    row = '{:<40} {:<20} {:>6} {:>14} {:>14} {:>9}'
+    print(row.format('system', 'benchmark', 'param', 'baseline', 'current', 'change'))
+    for system in sorted(current):
+        base_system = baseline.get(system, {}).get('results', {})
+        for name in sorted(current[system]['results']):
+            for param in sorted(current[system]['results'][name], key=int):
+                now = current[system]['results'][name][param]['per_iteration']
+                base = base_system.get(name, {}).get(param)
+                if base is None:
+                    print(row.format(system, name, param, '-', '{:.1f}'.format(now), 'new'))
+                    continue
+                then = base['per_iteration']
+                change = (now - then) * 100.0 / then if then else 0.0
+                flag = ''
+                if change > threshold:
+                    regressions += 1
+                    flag = ' !'
+                print(row.format(system, name, param, '{:.1f}'.format(then), '{:.1f}'.format(now),
+                                 '{:+.1f}%'.format(change)) + flag)
+    return regressions
+
+
+def _load(path):
+    with open(path) as f:
+        return json.load(f)
+
+
+def _save(path, results):
+    os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+    with open(path, 'w') as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+        f.write('\n')
+
+
+def _default_baseline(topdir):
+    return top_path(topdir, 'out', 'bench', 'baseline.json')
+
+
+_threshold_arg = Arg('--threshold', type=float, default=10.0,
+                     help='Percentage by which the time per iteration of a benchmark may grow before it is reported '
+                     'as a regression (default: 10)')
+_baseline_arg = Arg('--baseline', default=None,
+                    help='Baseline results file (default: out/bench/baseline.json)')
+
+
+@subcmd(cmd='bench', help='Build and run the kernel benchmark systems and compare the results against a baseline',
+        args=(Arg('systems', metavar='SYSTEM', nargs='*', default=[],
+                  help='Systems to run, as shell-style patterns such as "posix.bench.*" (default: all)'),
+              _baseline_arg, _threshold_arg,
+              Arg('--timeout', type=float, default=60.0, help='Seconds to allow each system to run (default: 60)'),
+              Arg('--repeat', type=int, default=3,
+                  help='Number of times to run each system, keeping the best result of each benchmark (default: 3)'),
+              Arg('--update-baseline', action='store_true', default=False,
+                  help='Merge the results into the baseline instead of comparing against it')))
+def run(args):
+    results = _run_systems(args)
+    results_path = top_path(args.topdir, 'out', 'bench', 'results.json')
+    _save(results_path, results)
+    print("Results written to {}".format(results_path))
+
+    baseline_path = args.baseline or _default_baseline(args.topdir)
+    if args.update_baseline:
+        baseline = _load(baseline_path) if os.path.exists(baseline_path) else {}
+        baseline.update(results)
+        _save(baseline_path, baseline)
+        print("Baseline written to {}".format(baseline_path))
+    elif os.path.exists(baseline_path):
+        if _compare(_load(baseline_path), results, args.threshold):
+            return 1
+    else:
+        print("No baseline at {}; use --update-baseline to create it".format(baseline_path))
+
+    return 0
+
+
+@subcmd(cmd='bench', help='Compare two benchmark results files',
+        args=(Arg('results', metavar='RESULTS', help='Results file, e.g., out/bench/results.json'),
+              _baseline_arg, _threshold_arg))
+def compare(args):
+    baseline_path = args.baseline or _default_baseline(args.topdir)
+    if _compare(_load(baseline_path), _load(args.results), args.threshold):
+        return 1
+    return 0
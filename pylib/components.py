@@ -26,6 +26,7 @@
 #
 
 import os
+import pickle
 import shutil
 from collections import namedtuple
 import pystache
@@ -107,7 +108,22 @@ To merge two schemas, corresponding entries both need need to either have child
             a.append(b_child)
 
 
+_merged_schemas = {}
+
+
 def _merge_schema_files(xml_files):
+    """Merge the existing ones of the component schema files `xml_files` and return the merged schema as a string.
+
+    Variants that share the same set of components share the merged schema, which is only computed once per process.
+
+    """
+    key = tuple((xml_file, _stat_key(xml_file)) for xml_file in xml_files if os.path.exists(xml_file))
+    if key not in _merged_schemas:
+        _merged_schemas[key] = _merge_schema_files_uncached(xml_files)
+    return _merged_schemas[key]
+
+
+def _merge_schema_files_uncached(xml_files):
     merged_schema = xml.etree.ElementTree.fromstring('<schema>\n</schema>')
 
     sections = [open(xml_file).read().strip() for xml_file in xml_files if os.path.exists(xml_file)]
@@ -167,32 +183,88 @@ def _sort_typedefs(typedef_lines):
     return '\n'.join(['typedef {} {};'.format(old, new) for (new, old) in r])
 
 
+_DELIMITERS = ('[[', ']]')
+
+
 def _render_data(in_data, name, config):
-    """Render input data (`in_data`) using a given `config`. The result is returned."""
+    """Render input data (`in_data`) using a given `config`. The result is returned.
+
+    `in_data` is either a template string or a template that has already been parsed with _parse_data().
+
+    """
     pystache.defaults.MISSING_TAGS = 'strict'
-    pystache.defaults.DELIMITERS = ('[[', ']]')
+    pystache.defaults.DELIMITERS = _DELIMITERS
     pystache.defaults.TAG_ESCAPE = lambda u: u
-    return pystache.render(in_data, config, name=name)
+    if isinstance(in_data, str):
+        in_data = _parse_data(in_data, name)
+    return pystache.renderer.Renderer().render(in_data, config)
 
 
-def _parse_sectioned_file(fn, config, required_sections):
-    """Given a sectioned C-like file, returns a dictionary of { section: content }
+def _parse_data(in_data, name):
+    """Parse the template string `in_data` into a pystache template that can be passed to _render_data()."""
+    return pystache.parser.parse(in_data, delimiters=_DELIMITERS, name=name)
 
-    For example an input of:
-    /*| foo |*/
-    foo data....
 
-    /*| bar |*/
-    bar data....
+def _stat_key(fn):
+    stat = os.stat(fn)
+    return stat.st_mtime_ns, stat.st_size
 
-    Would produce:
 
-    { 'foo' : "foo data....", 'bar' : "bar data...." }
+class _ParseCache:
+    """A cache of the parsed sections of sectioned files.
+
+    Each file is split into its sections and each section is parsed into a pystache template only once.
+    Entries are keyed on the path of a file and are only used while the modification time and size of the file are
+    unchanged.
+
+    The cache is shared by all RTOS variants generated in a process.
+    If the cache has a `path`, it is loaded from and saved to that file, so that it is also shared across processes.
+
     """
-    if not os.path.exists(fn):
-        # Skip non-existent files
-        return None
+    _VERSION = 1
 
+    def __init__(self, path=None):
+        self.path = path
+        self._entries = {}
+        self._modified = False
+        if path is not None:
+            try:
+                with open(path, 'rb') as f:
+                    version, entries = pickle.load(f)
+                if version == self._VERSION:
+                    self._entries = entries
+            except (OSError, EOFError, ValueError, TypeError, pickle.UnpicklingError, AttributeError, ImportError):
+                # A missing or unreadable cache is simply rebuilt.
+                pass
+
+    def sections(self, fn):
+        """Return a dictionary of { section: parsed template } for the sectioned file `fn`."""
+        key = _stat_key(fn)
+        entry = self._entries.get(fn)
+        if entry is None or entry[0] != key:
+            sections = {name: _parse_data(data, "{}: Section {}".format(fn, name))
+                        for name, data in _split_sections(fn).items()}
+            entry = (key, sections)
+            self._entries[fn] = entry
+            self._modified = True
+        return entry[1]
+
+    def save(self):
+        if self.path is None or not self._modified:
+            return
+        os.makedirs(os.path.dirname(self.path), exist_ok=True)
+        temp_path = '{}.{}'.format(self.path, os.getpid())
+        with open(temp_path, 'wb') as f:
+            pickle.dump((self._VERSION, self._entries), f, pickle.HIGHEST_PROTOCOL)
+        os.replace(temp_path, self.path)
+        self._modified = False
+
+
+_parse_cache = _ParseCache()
+
+
+def _split_sections(fn):
+    """Given a sectioned C-like file, returns a dictionary of { section: unrendered content }"""
     with open(fn) as f:
         sections = {}
         current_lines = None
@@ -206,8 +278,30 @@ def _parse_sectioned_file(fn, config, required_sections):
             elif current_lines is not None:
                 current_lines.append(line)
 
-    for key, value in sections.items():
-        sections[key] = _render_data('\n'.join(value).rstrip(), "{}: Section {}".format(fn, key), config)
+    return {key: '\n'.join(value).rstrip() for key, value in sections.items()}
+
+
+def _parse_sectioned_file(fn, config, required_sections):
+    """Given a sectioned C-like file, returns a dictionary of { section: content }
+
+    For example an input of:
+    /*| foo |*/
+    foo data....
+
+    /*| bar |*/
+    bar data....
+
+    Would produce:
+
+    { 'foo' : "foo data....", 'bar' : "bar data...." }
+    """
+    if not os.path.exists(fn):
+        # Skip non-existent files
+        return None
+
+    sections = {}
+    for key, template in _parse_cache.sections(fn).items():
+        sections[key] = _render_data(template, "{}: Section {}".format(fn, key), config)
 
     for s in required_sections:
         if s not in sections:
@@ -268,28 +362,29 @@ def _generate(rtos_name, components, pkg_name, search_paths):
     # Generate .c file
     all_c_sections = _get_sections(bound_components, "implementation.c", _REQUIRED_C_SECTIONS)
     source_output = os.path.join(module_dir, module_name + '.c')
-    with open(source_output, 'w') as f:
-        for ss in _REQUIRED_C_SECTIONS:
-            data = "\n".join(c_sections[ss] for c_sections in all_c_sections)
-            if ss == 'types':
-                data = _sort_typedefs(data)
-            f.write(data)
-            f.write('\n')
+    source = []
+    for ss in _REQUIRED_C_SECTIONS:
+        data = "\n".join(c_sections[ss] for c_sections in all_c_sections)
+        if ss == 'types':
+            data = _sort_typedefs(data)
+        source.append(data + '\n')
+    _write_if_changed(source_output, ''.join(source))
 
     # Generate .h file
     all_h_sections = _get_sections(bound_components, "header.h", _REQUIRED_H_SECTIONS)
     header_output = os.path.join(module_dir, module_name + '.h')
-    with open(header_output, 'w') as f:
-        mod_name = module_name.upper().replace('-', '_')
-        f.write("#ifndef {}_H\n".format(mod_name))
-        f.write("#define {}_H\n".format(mod_name))
-        for ss in _REQUIRED_H_SECTIONS:
-            if ss == 'public_function_declarations':
-                f.write("#ifdef __cplusplus\nextern \"C\" {\n#endif\n")
-            f.write("\n".join(h_sections[ss] for h_sections in all_h_sections) + "\n")
-            if ss == 'public_function_declarations':
-                f.write("#ifdef __cplusplus\n}\n#endif\n")
-        f.write("\n#endif /* {}_H */".format(mod_name))
+    header = []
+    mod_name = module_name.upper().replace('-', '_')
+    header.append("#ifndef {}_H\n".format(mod_name))
+    header.append("#define {}_H\n".format(mod_name))
+    for ss in _REQUIRED_H_SECTIONS:
+        if ss == 'public_function_declarations':
+            header.append("#ifdef __cplusplus\nextern \"C\" {\n#endif\n")
+        header.append("\n".join(h_sections[ss] for h_sections in all_h_sections) + "\n")
+        if ss == 'public_function_declarations':
+            header.append("#ifdef __cplusplus\n}\n#endif\n")
+    header.append("\n#endif /* {}_H */".format(mod_name))
+    _write_if_changed(header_output, ''.join(header))
 
     # Generate docs
     if os.path.exists(os.path.join(BASE_DIR, 'components', rtos_name, 'docs.md')):
@@ -324,16 +419,29 @@ component'.format(src, dst))
 
     # Generate .xml file
     config_output = os.path.join(module_dir, 'schema.xml')
-    with open(config_output, 'w') as f:
-        f.write('<?xml version="1.0" encoding="UTF-8" ?>\n')
-        xml_files = [os.path.join(bc.path, "schema.xml") for bc in bound_components]
-        schema = _merge_schema_files(xml_files)
-        f.write(schema)
+    xml_files = [os.path.join(bc.path, "schema.xml") for bc in bound_components]
+    schema = _merge_schema_files(xml_files)
+    _write_if_changed(config_output, '<?xml version="1.0" encoding="UTF-8" ?>\n' + schema)
 
     # Generate .py file
     python_output = os.path.join(module_dir, 'entity.py')
     python_file = os.path.join(BASE_DIR, 'components', '{}.py'.format(rtos_name))
-    shutil.copyfile(python_file, python_output)
+    with open(python_file) as f:
+        _write_if_changed(python_output, f.read())
+
+
+def _write_if_changed(path, data):
+    """Write `data` to the file `path`, unless it already has that content.
+
+    Unchanged generated files keep their modification times, so that builds of systems using them remain incremental.
+
+    """
+    if os.path.exists(path):
+        with open(path) as f:
+            if f.read() == data:
+                return
+    with open(path, 'w') as f:
+        f.write(data)
 
 
 def _get_search_paths(topdir):
@@ -353,12 +461,18 @@ def _get_search_paths(topdir):
         cmd='build',
         help='Generate packages from components')
 def build(args):
-    # Generate RTOSes
+    # Generate all RTOS variants in this process, so that they share the parsed component files.
+    # The parse cache is also kept on disk for later runs.
+    global _parse_cache
+    _parse_cache = _ParseCache(os.path.join(BASE_DIR, 'out', 'components', 'parse-cache.pickle'))
+
     search_paths = _get_search_paths(args.topdir)
     for pkg_name, rtos_names in args.configurations.items():
         for rtos_name in rtos_names:
             _generate(rtos_name, args.skeletons[rtos_name], pkg_name, search_paths)
 
+    _parse_cache.save()
+
 
 _DependencyNode = namedtuple("_DependencyNode", ('provides', 'requires'))
 
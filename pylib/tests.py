@@ -37,6 +37,7 @@ import io
 import re
 import nose
 import inspect
+import fnmatch
 
 from .xunittest import discover_tests, TestSuite, SimpleTestNameResult, testcase_matches, testsuite_list
 from .release import _LicenseOpener
@@ -58,6 +59,7 @@ def prj(args):
     modules = ['prj', 'util']
     directories = [find_path(os.path.join('prj', 'app'), args.topdir),
                    find_path(os.path.join('prj', 'app', 'pystache'), args.topdir),
+                   find_path(os.path.join('prj', 'app', 'ply'), args.topdir),
                    find_path(os.path.join('prj', 'app', 'lib'), args.topdir)]
 
     return _run_module_tests_with_args(modules, directories, args)
@@ -354,6 +356,35 @@ def systems(args):
     nose.core.run(argv=[''] + args.unknown_args + tests)
 
 
+@subcmd(name='sched-check', cmd="test", help='Build and run the scheduler equivalence checkers, i.e., the systems in \
+the sched-check directories that compare each generated scheduler against a reference model (see \
+packages/rtos-sched-check/sched-check.c).',
+        args=(Arg('systems', metavar='SYSTEM', nargs='*', default=[],
+                  help='Only check the systems matching one of these patterns, e.g., posix.sched-check.edf'),))
+def sched_check(args):
+    search_paths = list(base_to_top_paths(args.topdir, 'packages'))
+    failures = 0
+    for packages_dir in search_paths:
+        for parent, dirs, files in os.walk(packages_dir):
+            dirs.sort()
+            if os.path.basename(parent) != 'sched-check':
+                continue
+            for file in sorted(files):
+                if not file.endswith('.prx'):
+                    continue
+                rel_path = os.path.relpath(os.path.join(parent, os.path.splitext(file)[0]), packages_dir)
+                system = rel_path.replace(os.sep, '.')
+                if args.systems and not any(fnmatch.fnmatch(system, p) for p in args.systems):
+                    continue
+                subprocess.check_call([sys.executable, os.path.join(BASE_DIR, 'prj', 'app', 'prj.py')] +
+                                      ['--search-path={}'.format(sp) for sp in search_paths] +
+                                      ['build', system], stdout=subprocess.DEVNULL)
+                executable = os.path.join(args.topdir, 'out', rel_path, 'system' + get_executable_extension())
+                if subprocess.call([executable]) != 0:
+                    failures += 1
+    return min(failures, 127)
+
+
 class GdbTestCase(unittest.TestCase):
     """A Pythonic interface to running an RTOS system executable against a GDB command file and checking whether the
     output produced matches a given reference output.
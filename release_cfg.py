@@ -29,7 +29,7 @@ from pylib.release import Release
 
 
 class Standard(Release):
-    packages = ['armv7m', 'generic', 'rtos-example', 'machine-qemu-simple', 'machine-stm32f4-discovery',
+    packages = ['armv7m', 'generic', 'rtos-example', 'rtos-bench', 'machine-qemu-simple', 'machine-stm32f4-discovery',
                 'machine-armv7m-common']
     platforms = ['x86_64-apple-darwin', 'x86_64-unknown-linux-gnu']
     version = '0.0.2'
@@ -710,7 +710,7 @@ class StandardLinux(Standard):
 
 
 class PowerPCe500Linux(Standard):
-    packages = ['ppce500', 'generic', 'rtos-example', 'machine-qemu-ppce500']
+    packages = ['ppce500', 'generic', 'rtos-example', 'rtos-bench', 'machine-qemu-ppce500']
     platforms = ['x86_64-unknown-linux-gnu']
     release_name = 'ppce500_linux'
     enabled = True
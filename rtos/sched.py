@@ -56,56 +56,68 @@ def incmod(i, n):
     return (i + 1) % n
 
 
+def bitmap_words(num_tasks):
+    """Return the number of 32-bit words of a bitmap with one bit for each of 'num_tasks' tasks."""
+    return (num_tasks + 31) // 32
+
+
+def bitmap_get(words, idx):
+    """Return whether the bit of task 'idx' is set in the bitmap 'words'."""
+    return words[idx // 32] & (1 << (idx % 32)) != 0
+
+
+def bitmap_set(words, idx, value):
+    """Set or clear the bit of task 'idx' in the bitmap 'words'."""
+    if value:
+        words[idx // 32] |= 1 << (idx % 32)
+    else:
+        words[idx // 32] &= ~(1 << (idx % 32)) & 0xffffffff
+
+
 def get_rr_sched_struct(num_tasks):
     """Return an implementation mock for a round-robin scheduler with 'num_tasks' tasks."""
-    class RrSchedTaskStruct(ctypes.Structure):
-        _fields_ = [("runnable", ctypes.c_bool)]
-
     class RrSchedStruct(ctypes.Structure):
         _fields_ = [("cur", ctypes.c_uint8),
-                    ("tasks", RrSchedTaskStruct * num_tasks)]
+                    ("runnable", ctypes.c_uint32 * bitmap_words(num_tasks))]
 
         def __str__(self):
-            run_state = ''.join(['X' if x.runnable else ' ' for x in self.tasks])
+            run_state = ''.join(['X' if bitmap_get(self.runnable, idx) else ' ' for idx in range(num_tasks)])
             return "<RrSchedImpl cur={} runnable=[{}]".format(self.cur, run_state)
 
         def __eq__(self, model):
             if model.cur != self.cur:
                 return False
             for idx, r in model.indexed:
-                if self.tasks[idx].runnable != r:
+                if bitmap_get(self.runnable, idx) != r:
                     return False
             return True
 
         def set(self, model):
             self.cur = model.cur
             for idx, r in model.indexed:
-                self.tasks[idx].runnable = r
+                bitmap_set(self.runnable, idx, r)
             assert self == model
     return RrSchedStruct
 
 
 def get_prio_sched_struct(num_tasks):
     """Return an implementation mock for a priority scheduler with 'num_tasks' tasks."""
-    class PrioSchedTaskStruct(ctypes.Structure):
-        _fields_ = [("runnable", ctypes.c_bool)]
-
     class PrioSchedStruct(ctypes.Structure):
-        _fields_ = [("tasks", PrioSchedTaskStruct * num_tasks)]
+        _fields_ = [("runnable", ctypes.c_uint32 * bitmap_words(num_tasks))]
 
         def __str__(self):
-            run_state = ''.join(['X' if x.runnable else ' ' for x in self.tasks])
+            run_state = ''.join(['X' if bitmap_get(self.runnable, idx) else ' ' for idx in range(num_tasks)])
             return "<PrioSchedImpl runnable=[{}]".format(run_state)
 
         def __eq__(self, model):
             for idx, r in model.indexed:
-                if self.tasks[idx].runnable != r:
+                if bitmap_get(self.runnable, idx) != r:
                     return False
             return True
 
         def set(self, model):
             for idx, r in model.indexed:
-                self.tasks[idx].runnable = r
+                bitmap_set(self.runnable, idx, r)
             assert self == model
     return PrioSchedStruct
 
@@ -140,6 +152,90 @@ def get_prio_inherit_sched_struct(num_tasks):
     return PrioInheritSchedStruct
 
 
+def get_prio_inherit_rr_sched_struct(num_tasks, num_levels):
+    """Return an implementation mock for a priority inheritance scheduler with time slicing within priority levels.
+
+    It has 'num_tasks' tasks in 'num_levels' priority levels.
+
+    """
+    class PrioInheritTaskStruct(ctypes.Structure):
+        _fields_ = [("blocked_on", ctypes.c_uint8)]
+
+    class PrioInheritRrSchedStruct(ctypes.Structure):
+        _fields_ = [("tasks", PrioInheritTaskStruct * num_tasks),
+                    ("level_offsets", ctypes.c_uint8 * num_levels),
+                    ("slice_task", ctypes.c_uint8),
+                    ("slice_level", ctypes.c_uint8),
+                    ("slice_remaining", ctypes.c_uint16)]
+
+        def __str__(self):
+            blocked_on = ''.join(['{:d}'.format(x.blocked_on) if x.blocked_on != 0xff else '.'
+                                  for x in self.tasks])
+            return "<PrioInheritRrSchedImpl blocked_on=[{}] level_offsets={} slice=({}, {}, {})>".format(
+                blocked_on, list(self.level_offsets), self.slice_task, self.slice_level, self.slice_remaining)
+
+        def __eq__(self, model):
+            for idx, r in enumerate(model.blocked_on):
+                if r is None:
+                    r = 0xff
+                if self.tasks[idx].blocked_on != r:
+                    return False
+            slice_task = 0xff if model.slice_task is None else model.slice_task
+            return (list(self.level_offsets) == model.level_offsets and self.slice_task == slice_task and
+                    self.slice_level == model.slice_level and self.slice_remaining == model.slice_remaining)
+
+        def set(self, model):
+            for idx, blocked_on in enumerate(model.blocked_on):
+                self.tasks[idx].blocked_on = 0xff if blocked_on is None else blocked_on
+            for level, offset in enumerate(model.level_offsets):
+                self.level_offsets[level] = offset
+            self.slice_task = 0xff if model.slice_task is None else model.slice_task
+            self.slice_level = model.slice_level
+            self.slice_remaining = model.slice_remaining
+            assert self == model
+    return PrioInheritRrSchedStruct
+
+
+def get_edf_sched_struct(num_tasks):
+    """Return an implementation mock for an earliest-deadline-first scheduler with 'num_tasks' tasks."""
+    class EdfTaskStruct(ctypes.Structure):
+        _fields_ = [("blocked_on", ctypes.c_uint8),
+                    ("heap_pos", ctypes.c_uint8),
+                    ("deadline", ctypes.c_uint32)]
+
+    class EdfSchedStruct(ctypes.Structure):
+        _fields_ = [("tasks", EdfTaskStruct * num_tasks),
+                    ("heap", ctypes.c_uint8 * num_tasks),
+                    ("heap_size", ctypes.c_uint8)]
+
+        def __str__(self):
+            blocked_on = ''.join(['{:d}'.format(x.blocked_on) if x.blocked_on != 0xff else '.'
+                                  for x in self.tasks])
+            deadlines = ','.join(str(x.deadline) for x in self.tasks)
+            return "<EdfSchedImpl blocked_on=[{}] deadlines=[{}]>".format(blocked_on, deadlines)
+
+        def __eq__(self, model):
+            for idx, (r, deadline) in enumerate(zip(model.blocked_on, model.deadlines)):
+                if r is None:
+                    r = 0xff
+                if self.tasks[idx].blocked_on != r or self.tasks[idx].deadline != deadline:
+                    return False
+            return True
+
+        def set(self, model):
+            # A list that is sorted by deadline is a valid heap
+            heap = [task_id for task_id in model.deadline_order if model.blocked_on[task_id] is not None]
+            for idx, (blocked_on, deadline) in enumerate(zip(model.blocked_on, model.deadlines)):
+                self.tasks[idx].blocked_on = 0xff if blocked_on is None else blocked_on
+                self.tasks[idx].heap_pos = heap.index(idx) if idx in heap else 0xff
+                self.tasks[idx].deadline = deadline
+            for pos, task_id in enumerate(heap):
+                self.heap[pos] = task_id
+            self.heap_size = len(heap)
+            assert self == model
+    return EdfSchedStruct
+
+
 class BaseSchedModel:
     def __init__(self, runnable):
         self.runnable = runnable
@@ -228,20 +324,21 @@ class PrioInheritSchedModel(BaseSchedModel):
     def __str__(self):
         return '<PrioInheritSched blocked_on=[{}]>'.format(self.blocked_on_str)
 
-    def get_next(self):
-        def resolve_block_chain(task_id):
-            seen = set()
-            while True:
-                blocked_on = self.blocked_on[task_id]
-                assert blocked_on not in seen
-                if blocked_on in (task_id, None):
-                    return blocked_on
-                else:
-                    seen.add(task_id)
-                    task_id = blocked_on
+    def resolve_block_chain(self, task_id):
+        """Return the runnable task at the end of the chain of tasks that task_id is blocked on, or None."""
+        seen = set()
+        while True:
+            blocked_on = self.blocked_on[task_id]
+            assert blocked_on not in seen
+            if blocked_on in (task_id, None):
+                return blocked_on
+            else:
+                seen.add(task_id)
+                task_id = blocked_on
 
+    def get_next(self):
         return head(task_id for
-                    task_id in map(resolve_block_chain, range(len(self.blocked_on)))
+                    task_id in map(self.resolve_block_chain, range(len(self.blocked_on)))
                     if task_id is not None)
 
     @classmethod
@@ -270,6 +367,109 @@ class PrioInheritSchedModel(BaseSchedModel):
         return filter(lambda s: s.any_runnable, g) if assume_runnable else g
 
 
+class PrioInheritRrSchedModel(PrioInheritSchedModel):
+    """A model of the priority inheritance scheduler with round-robin time slicing within priority levels.
+
+    The tasks are sorted by priority, and level_bounds holds the index of the first task of each level, followed by
+    the number of tasks.
+    Within each level, the scheduler visits the tasks starting at the level offset and resolves their blocked_on
+    chains like the priority inheritance model.
+
+    """
+
+    def __init__(self, blocked_on, level_bounds, level_offsets, time_slice):
+        super().__init__(blocked_on)
+        self.level_bounds = level_bounds
+        self.level_offsets = level_offsets
+        self.time_slice = time_slice
+        self.slice_task = None
+        self.slice_level = 0
+        self.slice_remaining = 0
+
+    def __str__(self):
+        return '<PrioInheritRrSched blocked_on=[{}] level_offsets={}>'.format(self.blocked_on_str,
+                                                                              self.level_offsets)
+
+    def level_size(self, level):
+        return self.level_bounds[level + 1] - self.level_bounds[level]
+
+    def get_next(self):
+        for level, offset in enumerate(self.level_offsets):
+            size = self.level_size(level)
+            for count in range(size):
+                task_id = self.resolve_block_chain(self.level_bounds[level] + (offset + count) % size)
+                if task_id is not None:
+                    self.level_offsets[level] = (offset + count) % size
+                    if task_id != self.slice_task:
+                        self.slice_task = task_id
+                        self.slice_level = level
+                        self.slice_remaining = self.time_slice
+                    return task_id
+        return None
+
+    def time_slice_tick(self):
+        """Advance the time slice by one tick, and return whether it expired."""
+        if self.slice_remaining > 1:
+            self.slice_remaining -= 1
+            return False
+        level = self.slice_level
+        self.level_offsets[level] = (self.level_offsets[level] + 1) % self.level_size(level)
+        self.slice_task = None
+        return True
+
+    @classmethod
+    def states(cls, level_bounds, time_slice, assume_runnable=False):
+        """Return all possible scheduler states for the given priority levels at the start of a time slice.
+
+        If assume_runnable is True then only include states where at least one task is runnable.
+
+        """
+        sizes = [end - first for first, end in zip(level_bounds, level_bounds[1:])]
+        for s in PrioInheritSchedModel.states(level_bounds[-1], assume_runnable):
+            for offsets in product(*(range(size) for size in sizes)):
+                yield cls(s.blocked_on, level_bounds, list(offsets), time_slice)
+
+
+class EdfSchedModel(PrioInheritSchedModel):
+    """A model of the earliest-deadline-first with inheritance scheduler.
+
+    It resolves the blocked_on chains like the priority inheritance model, but visits the tasks in the order of their
+    absolute deadlines rather than in the order of their priorities.
+    Like the implementation, it compares deadlines modulo 2**32 and breaks ties by the task index.
+
+    """
+
+    def __init__(self, blocked_on, deadlines):
+        super().__init__(blocked_on)
+        self.deadlines = deadlines
+
+    @property
+    def deadline_order(self):
+        def key(task_id):
+            # The differences to the deadline of task 0, interpreted as signed 32-bit values
+            offset = (self.deadlines[task_id] - self.deadlines[0] + 2 ** 31) % 2 ** 32
+            return (offset, task_id)
+        return sorted(range(len(self.blocked_on)), key=key)
+
+    def __str__(self):
+        deadlines = ','.join(map(str, self.deadlines))
+        return '<EdfSched blocked_on=[{}] deadlines=[{}]>'.format(self.blocked_on_str, deadlines)
+
+    def get_next(self):
+        return head(task_id for
+                    task_id in map(self.resolve_block_chain, self.deadline_order)
+                    if task_id is not None)
+
+    @classmethod
+    def states(cls, n, deadlines, assume_runnable=False):
+        """Return all possible scheduler states for n tasks, combined with each of the given lists of deadlines.
+
+        If assume_runnable is True then only include states where at least one task is runnable.
+
+        """
+        return (cls(s.blocked_on, d) for s in PrioInheritSchedModel.states(n, assume_runnable) for d in deadlines)
+
+
 if __name__ == '__main__':
     import sys
     import argparse
@@ -25,7 +25,8 @@
 # @TAG(NICTA_AGPL)
 #
 
-__all__ = ['sched', 'simple_mutex', 'blocking_mutex', 'simple_semaphore']
+__all__ = ['sched', 'simple_mutex', 'blocking_mutex', 'simple_semaphore', 'timer', 'pool', 'condition_variable',
+           'timebase', 'work_queue', 'broadcast', 'budget']
 
 import ctypes
 import os
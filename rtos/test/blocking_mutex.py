@@ -121,3 +121,86 @@ class testBlockingMutex:
 
         assert blocked_on == 1
         assert self.impl_mutex[1].holder == 2
+
+    def test_unlock_unblocks_waiters(self):
+        # Tasks 1 and 2 wait for mutex 1, which task 0 holds.
+        # Unlocking the mutex unblocks both of them, and the first one to run locks it.
+        self.impl.pub_mutex_init()
+
+        current_task = 0
+        blocked_on = []
+        unblocked = []
+        holders = []
+        unblocked_by_other_mutex = []
+
+        def get_current_task():
+            return current_task
+
+        def unblock(task_id):
+            unblocked.append(task_id)
+
+        def block_on_task_1(task_id):
+            nonlocal current_task
+            blocked_on.append(task_id)
+            # Unlocking a different mutex does not unblock task 1
+            current_task = 0
+            self.impl.rtos_mutex_lock(2)
+            self.impl.rtos_mutex_unlock(2)
+            unblocked_by_other_mutex.extend(unblocked)
+            self.set_block_on_func(block_on_task_2)
+            current_task = 2
+            self.impl.rtos_mutex_lock(1)
+            holders.append(self.impl_mutex[1].holder)
+            # Task 1 no longer waits, so unlocking the mutex again does not unblock it a second time
+            self.impl.rtos_mutex_unlock(1)
+            current_task = 1
+
+        def block_on_task_2(task_id):
+            nonlocal current_task
+            blocked_on.append(task_id)
+            current_task = 0
+            self.impl.rtos_mutex_unlock(1)
+            holders.append(self.impl_mutex[1].holder)
+            current_task = 2
+
+        self.set_get_current_task_func(get_current_task)
+        self.set_unblock_func(unblock)
+        self.set_block_on_func(block_on_task_1)
+
+        self.impl.rtos_mutex_lock(1)
+        current_task = 1
+        self.impl.rtos_mutex_lock(1)
+
+        assert blocked_on == [0, 0]
+        assert unblocked_by_other_mutex == []
+        assert unblocked == [1, 2]
+        assert holders == [0xff, 2]
+        assert self.impl_mutex[1].holder == 1
+
+    def test_block_again(self):
+        # A task that is unblocked while the mutex is still held blocks on it again
+        self.impl.pub_mutex_init()
+
+        current_task = 0
+        blocked_on = []
+
+        def get_current_task():
+            return current_task
+
+        def block_on(task_id):
+            nonlocal current_task
+            blocked_on.append(task_id)
+            if len(blocked_on) == 2:
+                current_task = 0
+                self.impl.rtos_mutex_unlock(1)
+                current_task = 1
+
+        self.set_get_current_task_func(get_current_task)
+        self.set_block_on_func(block_on)
+
+        self.impl.rtos_mutex_lock(1)
+        current_task = 1
+        self.impl.rtos_mutex_lock(1)
+
+        assert blocked_on == [0, 0]
+        assert self.impl_mutex[1].holder == 1
@@ -0,0 +1,145 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+
+import ctypes
+import os
+import sys
+
+from pylib.utils import get_executable_extension
+
+ERROR_ID_NONE = 0
+ERROR_ID_BROADCAST_NOT_SUBSCRIBED = 35
+
+# Channel b0 retains 4 records of 4 bytes for t0 and t1, and channel b1 retains 1 record of 2 bytes for t2
+B0, B1 = 0, 1
+B0_LENGTH = 4
+T0, T1, T2 = range(3)
+
+WaitFuncPtr = ctypes.CFUNCTYPE(None)
+
+
+class testBroadcast:
+    @classmethod
+    def setUpClass(cls):
+        r = os.system(sys.executable + " ./prj/app/prj.py build posix.unittest.broadcast")
+        system = "out/posix/unittest/broadcast/system" + get_executable_extension()
+        assert r == 0
+        cls.impl = ctypes.CDLL(system)
+        cls.impl.rtos_broadcast_try_get.restype = ctypes.c_bool
+        cls.impl.rtos_broadcast_lost.restype = ctypes.c_uint32
+        cls.signals = (ctypes.c_uint8 * 3).in_dll(cls.impl, 'pub_signals')
+        cls.waits = ctypes.c_uint8.in_dll(cls.impl, 'pub_waits')
+        cls.fatal_error_id = ctypes.c_uint8.in_dll(cls.impl, 'pub_fatal_error_id')
+
+    def init(self):
+        self.impl.pub_broadcast_init()
+        # Keep references to the callbacks while the implementation may call them
+        self.callbacks = []
+
+    def publish(self, value, broadcast=B0):
+        self.impl.pub_set_current_task(T2)
+        self.impl.rtos_broadcast_publish(broadcast, ctypes.byref(ctypes.c_uint32(value)))
+
+    def try_get(self, task, broadcast=B0):
+        """Return the next record of the subscriber, or None if there is none."""
+        record = ctypes.c_uint32(0xffffffff)
+        self.impl.pub_set_current_task(task)
+        if self.impl.rtos_broadcast_try_get(broadcast, ctypes.byref(record)):
+            return record.value
+        return None
+
+    def lost(self, task, broadcast=B0):
+        self.impl.pub_set_current_task(task)
+        return self.impl.rtos_broadcast_lost(broadcast)
+
+    def test_slow_subscriber(self):
+        # t1 keeps up with the channel, while t0 falls behind by more than the channel retains
+        self.init()
+        received = []
+        for value in range(10):
+            self.publish(value)
+            received.append(self.try_get(T1))
+        assert received == list(range(10))
+        assert self.try_get(T1) is None
+        assert self.lost(T1) == 0
+
+        # t0 lost the oldest six records, and retrieves the four that the channel still retains
+        assert self.lost(T0) == 10 - B0_LENGTH
+        assert self.lost(T0) == 0
+        assert [self.try_get(T0) for _ in range(B0_LENGTH + 1)] == [6, 7, 8, 9, None]
+
+        # Retrieving a record skips the lost records, which the next call of broadcast_lost counts
+        for value in range(10, 20):
+            self.publish(value)
+        assert self.try_get(T0) == 16
+        assert self.lost(T0) == 6
+        assert self.lost(T0) == 0
+        assert [self.try_get(T0) for _ in range(B0_LENGTH)] == [17, 18, 19, None]
+
+        # Meanwhile, t1 still retrieves the records in order, and lost only those it did not retrieve either
+        assert [self.try_get(T1) for _ in range(B0_LENGTH + 1)] == [16, 17, 18, 19, None]
+        assert self.lost(T1) == 6
+        assert self.fatal_error_id.value == ERROR_ID_NONE
+
+    def test_exactly_full(self):
+        # A subscriber that is exactly one channel length behind has not lost any records
+        self.init()
+        for value in range(B0_LENGTH):
+            self.publish(value)
+        assert self.lost(T0) == 0
+        assert [self.try_get(T0) for _ in range(B0_LENGTH + 1)] == [0, 1, 2, 3, None]
+
+        # A channel that retains a single record
+        for value in (1, 2, 3):
+            self.publish(value, B1)
+        record = ctypes.c_uint16(0)
+        self.impl.pub_set_current_task(T2)
+        assert self.impl.rtos_broadcast_try_get(B1, ctypes.byref(record)) and record.value == 3
+        assert self.lost(T2, B1) == 2
+        assert self.fatal_error_id.value == ERROR_ID_NONE
+
+    def test_signals(self):
+        self.init()
+        self.publish(1)
+        assert list(self.signals) == [1, 1, 0]
+
+        # A subscriber waits for the signal until a record is published
+        self.publish(0)
+        assert [self.try_get(T0) for _ in range(3)] == [1, 0, None]
+        self.callbacks.append(WaitFuncPtr(lambda: self.publish(5)))
+        self.impl.pub_set_wait_ptr(self.callbacks[-1])
+        record = ctypes.c_uint32(0)
+        self.impl.pub_set_current_task(T0)
+        self.impl.rtos_broadcast_get(B0, ctypes.byref(record))
+        assert record.value == 5 and self.waits.value == 1
+
+    def test_not_subscribed(self):
+        self.init()
+        self.publish(1)
+        self.try_get(T2)
+        assert self.fatal_error_id.value == ERROR_ID_BROADCAST_NOT_SUBSCRIBED
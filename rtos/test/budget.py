@@ -0,0 +1,151 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+
+import ctypes
+import os
+import sys
+
+from pylib.utils import get_executable_extension
+
+# In priority order: t0 has a budget of 1000 cycles per 10 ticks, t1 500 cycles per 20 ticks, and t2 no budget
+T0, T1, T2 = range(3)
+T0_BUDGET, T0_PERIOD = 1000, 10
+T1_BUDGET, T1_PERIOD = 500, 20
+
+
+class testBudget:
+    @classmethod
+    def setUpClass(cls):
+        r = os.system(sys.executable + " ./prj/app/prj.py build posix.unittest.budget")
+        system = "out/posix/unittest/budget/system" + get_executable_extension()
+        assert r == 0
+        cls.impl = ctypes.CDLL(system)
+        cls.impl.pub_sched_runnable.restype = ctypes.c_bool
+        cls.impl.pub_budget_select.restype = ctypes.c_uint8
+        cls.impl.pub_budget_remaining.restype = ctypes.c_int32
+        cls.ticks = ctypes.c_uint32.in_dll(cls.impl, 'rtos_timer_current_ticks')
+        cls.cycles = ctypes.c_uint32.in_dll(cls.impl, 'pub_cycles')
+        cls.idle_ticks = ctypes.c_uint32.in_dll(cls.impl, 'pub_idle_ticks')
+        cls.overruns = (ctypes.c_uint8 * 3).in_dll(cls.impl, 'pub_overruns')
+
+    def init(self, *runnable):
+        self.impl.pub_budget_init()
+        for task in runnable:
+            self.impl.pub_sched_set_runnable(task)
+
+    def run(self, cycles, ticks=0):
+        """Let the current task execute for a number of cycles and ticks, then make a scheduling decision."""
+        self.cycles.value += cycles
+        self.ticks.value += ticks
+        return self.impl.pub_budget_select()
+
+    def block(self, task, cycles, ticks=0):
+        """Let the current task execute for a number of cycles and ticks before it blocks."""
+        self.cycles.value += cycles
+        self.ticks.value += ticks
+        self.impl.pub_sched_set_blocked(task)
+        return self.impl.pub_budget_select()
+
+    def test_throttle(self):
+        self.init(T0, T2)
+        assert self.run(0) == T0
+        assert self.run(T0_BUDGET - 1, 3) == T0
+        assert self.impl.pub_budget_remaining(T0) == 1
+        assert self.overruns[T0] == 0
+
+        # The exhausted task is throttled rather than selected, and the next runnable task runs in its place
+        assert self.run(1) == T2
+        assert not self.impl.pub_sched_runnable(T0)
+        assert self.overruns[T0] == 1
+
+        # It remains throttled while lower-priority tasks run, until its replenishment one period after its activation
+        for _ in range(T0_PERIOD - 4):
+            assert self.run(100, 1) == T2
+        assert self.impl.pub_budget_remaining(T0) == 0
+        assert self.run(100, 1) == T0
+        assert self.ticks.value == T0_PERIOD
+        assert self.impl.pub_sched_runnable(T0)
+        assert self.impl.pub_budget_remaining(T0) == T0_BUDGET
+
+    def test_overrun(self):
+        # A task that overruns its budget before the next scheduling point is charged with the whole overrun
+        self.init(T0, T2)
+        assert self.run(0) == T0
+        assert self.run(T0_BUDGET + 200) == T2
+        assert self.impl.pub_budget_remaining(T0) == -200
+
+        # The replenishment of the consumed cycles is capped at the capacity of the budget
+        assert self.run(0, T0_PERIOD) == T0
+        assert self.impl.pub_budget_remaining(T0) == T0_BUDGET
+
+    def test_replenish_consumed(self):
+        # Each active period is replenished one period after its activation by the amount consumed in it
+        self.init(T0, T2)
+        assert self.run(0) == T0
+        assert self.block(T0, 400, 2) == T2
+        self.impl.pub_sched_set_runnable(T0)
+        assert self.run(0, 2) == T0
+        assert self.run(600, 1) == T2
+        assert not self.impl.pub_sched_runnable(T0)
+
+        # The first replenishment is due at tick 10 and the second at tick 14
+        assert self.run(0, T0_PERIOD - 5 - 1) == T2
+        assert self.run(0, 1) == T0
+        assert self.impl.pub_budget_remaining(T0) == 400
+        assert self.run(399) == T0
+        assert self.run(1) == T2
+        assert self.run(0, 3) == T2
+        assert self.run(0, 1) == T0
+        assert self.ticks.value == 4 + T0_PERIOD
+        assert self.impl.pub_budget_remaining(T0) == 600
+
+    def test_idle(self):
+        # When every runnable task is throttled, the system idles until a replenishment is due
+        self.init(T0, T1)
+        assert self.run(0) == T0
+        assert self.run(T0_BUDGET, 1) == T1
+        assert self.run(T1_BUDGET, 2) == T0
+        assert self.ticks.value == T0_PERIOD
+        assert self.idle_ticks.value == T0_PERIOD - 3
+        assert not self.impl.pub_sched_runnable(T1)
+
+    def test_merge_replenishments(self):
+        # The fifth active period before the first replenishment is due is merged into the fourth replenishment
+        self.init(T0, T2)
+        assert self.run(0) == T0
+        for _ in range(5):
+            assert self.block(T0, 100) == T2
+            self.impl.pub_sched_set_runnable(T0)
+            assert self.run(0, 1) == T0
+        assert self.impl.pub_budget_remaining(T0) == T0_BUDGET - 500
+
+        remaining = []
+        for _ in range(T0_PERIOD):
+            self.run(0, 1)
+            remaining.append(self.impl.pub_budget_remaining(T0))
+        assert remaining == [500] * 4 + [600, 700, 800, 800, 1000, 1000]
@@ -0,0 +1,247 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+
+import ctypes
+import os
+import sys
+
+from pylib.utils import get_executable_extension
+
+NUM_MUTEXES = 4
+NUM_TASKS = 4
+TASK_ID_NONE = 0xff
+T0, T1, T2, T3 = range(NUM_TASKS)
+M0, M1 = 0, 1
+C0, C1 = 0, 1
+
+BlockFuncPtr = ctypes.CFUNCTYPE(None, ctypes.c_uint8)
+BlockTimeoutFuncPtr = ctypes.CFUNCTYPE(None, ctypes.c_uint16)
+PreemptFuncPtr = ctypes.CFUNCTYPE(None)
+
+
+class MutexStruct(ctypes.Structure):
+    _fields_ = [("holder", ctypes.c_uint8)]
+
+
+class testConditionVariable:
+    @classmethod
+    def setUpClass(cls):
+        r = os.system(sys.executable + " ./prj/app/prj.py build posix.unittest.condition-variable")
+        system = "out/posix/unittest/condition-variable/system" + get_executable_extension()
+        assert r == 0
+        cls.impl = ctypes.CDLL(system)
+        cls.impl.rtos_cond_wait_timeout.restype = ctypes.c_bool
+        cls.impl.rtos_cond_wait_timeout.argtypes = [ctypes.c_uint8, ctypes.c_uint8, ctypes.c_uint16]
+        cls.impl_mutex = (ctypes.POINTER(MutexStruct * 2)).in_dll(cls.impl, 'pub_mutexes')[0]
+        cls.current_ticks = ctypes.c_uint32.in_dll(cls.impl, 'rtos_timer_current_ticks')
+        cls.unblocked = (ctypes.c_bool * NUM_TASKS).in_dll(cls.impl, 'pub_unblocked')
+        cls.deadlocks = ctypes.c_uint8.in_dll(cls.impl, 'pub_deadlocks')
+        cls.preemption_errors = ctypes.c_uint8.in_dll(cls.impl, 'pub_preemption_errors')
+
+    def init(self):
+        self.impl.pub_cond_init()
+        # Keep references to the callbacks while the implementation may call them
+        self.callbacks = []
+
+    def as_task(self, task, fn, *args):
+        """Call an API function as the given task."""
+        self.impl.pub_set_current_task(task)
+        return fn(*args)
+
+    def on_block(self, fn):
+        """Run `fn` as the other tasks the next time the current task blocks."""
+        self.callbacks.append(BlockFuncPtr(fn))
+        self.impl.pub_set_block_ptr(self.callbacks[-1])
+
+    def on_block_timeout(self, fn):
+        self.callbacks.append(BlockTimeoutFuncPtr(fn))
+        self.impl.pub_set_block_timeout_ptr(self.callbacks[-1])
+
+    def on_preempt(self, fn):
+        """Run `fn` as an unblocked task the next time it preempts the current task."""
+        self.callbacks.append(PreemptFuncPtr(fn))
+        self.impl.pub_set_preempt_ptr(self.callbacks[-1])
+
+    def holder(self, m):
+        return self.impl_mutex[m].holder
+
+    def check_no_errors(self):
+        assert self.deadlocks.value == 0
+        assert self.preemption_errors.value == 0
+
+    def test_wait_signal(self):
+        self.init()
+        holders = []
+
+        def signal(blocker):
+            # The waiting task has released the mutex
+            holders.append(self.holder(M0))
+            self.as_task(T0, self.impl.rtos_mutex_lock, M0)
+            self.impl.rtos_cond_signal(C0)
+            self.impl.rtos_mutex_unlock(M0)
+
+        self.on_block(signal)
+        self.as_task(T1, self.impl.rtos_mutex_lock, M0)
+        self.impl.rtos_cond_wait(C0, M0)
+        assert holders == [TASK_ID_NONE]
+        assert self.unblocked[T1]
+        assert self.holder(M0) == T1
+        self.check_no_errors()
+
+    def test_wait_mutex_held(self):
+        # The signaling task still holds the mutex when the waiting task wakes up, so the waiting task blocks on it
+        self.init()
+        blockers = []
+
+        def unlock(blocker):
+            blockers.append(blocker)
+            self.as_task(T2, self.impl.rtos_mutex_unlock, M0)
+
+        def signal(blocker):
+            self.as_task(T2, self.impl.rtos_mutex_lock, M0)
+            self.impl.rtos_cond_signal(C0)
+            self.on_block(unlock)
+
+        self.on_block(signal)
+        self.as_task(T1, self.impl.rtos_mutex_lock, M0)
+        self.impl.rtos_cond_wait(C0, M0)
+        assert blockers == [T2]
+        assert self.holder(M0) == T1
+        self.check_no_errors()
+
+    def test_wait_timeout(self):
+        self.init()
+        self.current_ticks.value = 10
+        self.as_task(T1, self.impl.rtos_mutex_lock, M0)
+        assert not self.impl.rtos_cond_wait_timeout(C0, M0, 5)
+        assert self.current_ticks.value == 15
+        assert self.holder(M0) == T1
+
+        # The task no longer waits after the timeout, so a signal does not wake it
+        self.as_task(T0, self.impl.rtos_cond_signal, C0)
+        assert not self.unblocked[T1]
+
+        # Another task locks the mutex before the timeout expires, so the task times out holding the mutex again
+        def lock(timeout):
+            self.as_task(T2, self.impl.rtos_mutex_lock, M0)
+            self.current_ticks.value += timeout
+            self.on_block(lambda blocker: self.as_task(T2, self.impl.rtos_mutex_unlock, M0))
+
+        self.on_block_timeout(lock)
+        assert not self.as_task(T1, self.impl.rtos_cond_wait_timeout, C0, M0, 5)
+        assert self.current_ticks.value == 20
+        assert self.holder(M0) == T1
+
+        # A signal before the timeout expires
+        self.on_block_timeout(lambda timeout: self.as_task(T0, self.impl.rtos_cond_signal, C0))
+        assert self.as_task(T1, self.impl.rtos_cond_wait_timeout, C0, M0, 5)
+        assert self.current_ticks.value == 20
+        assert self.holder(M0) == T1
+        self.check_no_errors()
+
+    def wait_all(self, signal, conds):
+        """
+        Let T3, T1 and T2 wait on the given condition variables in this order, and then run `signal` as T0.
+        Return the order in which T2 and T1 return from waiting.
+
+        """
+        returned = []
+
+        def wait(task, cond, next_block):
+            def block(blocker):
+                self.on_block(next_block)
+                self.as_task(task, self.impl.rtos_mutex_lock, M0)
+                self.impl.rtos_cond_wait(cond, M0)
+                returned.append(task)
+                self.as_task(task, self.impl.rtos_mutex_unlock, M0)
+            return block
+
+        self.on_block(wait(T1, conds[T1], wait(T2, conds[T2], lambda blocker: self.as_task(T0, signal))))
+        self.as_task(T3, self.impl.rtos_mutex_lock, M0)
+        self.impl.rtos_cond_wait(conds[T3], M0)
+        assert self.holder(M0) == T3
+        return returned
+
+    def test_signal_priority(self):
+        # Each signal wakes up the highest-priority waiter, i.e., the one with the lowest task ID
+        self.init()
+        woken = []
+
+        def signal():
+            for _ in range(3):
+                self.impl.rtos_cond_signal(C0)
+                woken.append(list(self.unblocked))
+
+        assert self.wait_all(signal, {T1: C0, T2: C0, T3: C0}) == [T2, T1]
+        assert woken == [[False, True, False, False], [False, True, True, False], [False, True, True, True]]
+        self.check_no_errors()
+
+    def test_broadcast(self):
+        self.init()
+        woken = []
+
+        def broadcast():
+            self.impl.rtos_cond_broadcast(C0)
+            woken.append(list(self.unblocked))
+            self.impl.rtos_cond_broadcast(C1)
+            woken.append(list(self.unblocked))
+
+        assert self.wait_all(broadcast, {T1: C0, T2: C1, T3: C0}) == [T2, T1]
+        assert woken == [[False, True, False, True], [False, True, True, True]]
+        self.check_no_errors()
+
+    def test_no_lost_wakeup(self):
+        # Releasing the mutex unblocks T2, which waits for it.
+        # T0 signals the condition variable as soon as it can run, either when T2 preempts T1 between releasing the
+        # mutex and blocking or when T1 blocks.
+        # Either way, the signal must wake up T1.
+        self.init()
+        signaled = []
+
+        def signal(where):
+            def run():
+                self.impl.pub_set_block_ptr(None)
+                self.impl.pub_set_preempt_ptr(None)
+                signaled.append(where)
+                self.as_task(T0, self.impl.rtos_mutex_lock, M0)
+                self.impl.rtos_cond_signal(C0)
+                self.impl.rtos_mutex_unlock(M0)
+            return run
+
+        def wait(blocker):
+            self.on_preempt(signal('preempt'))
+            self.on_block(lambda blocker: signal('block')())
+            self.as_task(T1, self.impl.rtos_cond_wait, C0, M0)
+            self.as_task(T1, self.impl.rtos_mutex_unlock, M0)
+
+        self.as_task(T1, self.impl.rtos_mutex_lock, M0)
+        self.on_block(wait)
+        self.as_task(T2, self.impl.rtos_mutex_lock, M0)
+        assert signaled == ['block']
+        assert self.holder(M0) == T2
+        self.check_no_errors()
@@ -0,0 +1,292 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+import ctypes
+import os
+import sys
+
+from pylib.utils import get_executable_extension
+
+ERROR_ID_NONE = 0
+ERROR_ID_INVALID_ID = 2
+ERROR_ID_POOL_INVALID_BLOCK = 34
+
+# Pool p0 has 4 blocks of 6 bytes, aligned to 4 bytes, and pool p1 has 2 blocks of 1 byte, padded to 2 bytes
+P0, P1 = 0, 1
+P0_BLOCKS, P0_STRIDE = 4, 8
+
+InterruptFuncPtr = ctypes.CFUNCTYPE(None)
+BlockFuncPtr = ctypes.CFUNCTYPE(None)
+BlockTimeoutFuncPtr = ctypes.CFUNCTYPE(None, ctypes.c_uint16)
+
+
+class testPool:
+    @classmethod
+    def setUpClass(cls):
+        r = os.system(sys.executable + " ./prj/app/prj.py build posix.unittest.pool")
+        system = "out/posix/unittest/pool/system" + get_executable_extension()
+        assert r == 0
+        cls.impl = ctypes.CDLL(system)
+        cls.impl.rtos_pool_alloc.restype = ctypes.c_void_p
+        cls.impl.rtos_pool_alloc.argtypes = [ctypes.c_uint8]
+        cls.impl.rtos_pool_alloc_wait.restype = ctypes.c_void_p
+        cls.impl.rtos_pool_alloc_wait.argtypes = [ctypes.c_uint8]
+        cls.impl.rtos_pool_alloc_timeout.restype = ctypes.c_void_p
+        cls.impl.rtos_pool_alloc_timeout.argtypes = [ctypes.c_uint8, ctypes.c_uint16]
+        for name in ('rtos_pool_free', 'rtos_pool_free_from_interrupt', 'pub_pool_free_fatal_error'):
+            getattr(cls.impl, name).argtypes = [ctypes.c_uint8, ctypes.c_void_p]
+        cls.impl.pub_pool_head.restype = ctypes.c_uint32
+        cls.current_ticks = ctypes.c_uint32.in_dll(cls.impl, 'rtos_timer_current_ticks')
+        cls.unblocked = (ctypes.c_bool * 3).in_dll(cls.impl, 'pub_unblocked')
+        cls.fatal_error_id = ctypes.c_uint8.in_dll(cls.impl, 'pub_fatal_error_id')
+
+    def init(self):
+        self.impl.pub_pool_init()
+        # Keep references to the callbacks while the implementation may call them
+        self.callbacks = []
+        self.storage = self.impl.rtos_pool_alloc(P0)
+        self.impl.rtos_pool_free(P0, self.storage)
+
+    def set_interrupt(self, fn, compare_and_swap_count=1):
+        """Run `fn` as an interrupt handler immediately before the given compare-and-swap operation."""
+        calls = []
+
+        def interrupt():
+            calls.append(True)
+            fn()
+        self.callbacks.append(InterruptFuncPtr(interrupt))
+        self.impl.pub_set_interrupt_ptr(self.callbacks[-1], compare_and_swap_count)
+        return calls
+
+    def set_block(self, fn):
+        self.callbacks.append(BlockFuncPtr(fn))
+        self.impl.pub_set_block_ptr(self.callbacks[-1])
+
+    def set_block_timeout(self, fn):
+        self.callbacks.append(BlockTimeoutFuncPtr(fn))
+        self.impl.pub_set_block_timeout_ptr(self.callbacks[-1])
+
+    def block(self, index):
+        return self.storage + index * P0_STRIDE
+
+    def alloc_all(self, pool=P0):
+        blocks = []
+        for _ in range(P0_BLOCKS + 1):
+            block = self.impl.rtos_pool_alloc(pool)
+            if block is None:
+                break
+            blocks.append(block)
+        return blocks
+
+    def test_exhaustion(self):
+        self.init()
+        blocks = self.alloc_all()
+        # Blocks are allocated in order from a new pool, and are aligned
+        assert blocks == [self.block(index) for index in range(P0_BLOCKS)]
+        assert all(block % 4 == 0 for block in blocks)
+        assert self.impl.rtos_pool_alloc(P0) is None
+        assert self.impl.rtos_pool_high_water_mark(P0) == P0_BLOCKS
+
+        # The most recently freed block is allocated first
+        self.impl.rtos_pool_free(P0, blocks[2])
+        self.impl.rtos_pool_free(P0, blocks[0])
+        assert self.impl.rtos_pool_alloc(P0) == blocks[0]
+        assert self.impl.rtos_pool_alloc(P0) == blocks[2]
+        assert self.impl.rtos_pool_alloc(P0) is None
+
+        # Pools are independent, and blocks of one byte are padded to the size of a block index
+        small = self.alloc_all(P1)
+        assert len(small) == 2 and small[1] - small[0] == 2
+        assert self.fatal_error_id.value == ERROR_ID_NONE
+
+    def test_invalid_block(self):
+        self.init()
+        blocks = self.alloc_all()
+        for block in (self.storage - P0_STRIDE, self.block(1) + 2, self.block(P0_BLOCKS)):
+            assert self.impl.pub_pool_free_fatal_error(P0, block) == ERROR_ID_POOL_INVALID_BLOCK
+        assert self.impl.pub_pool_free_fatal_error(2, blocks[0]) == ERROR_ID_INVALID_ID
+
+        # A block freed twice in a row is still the first free block
+        assert self.impl.pub_pool_free_fatal_error(P0, blocks[1]) == ERROR_ID_NONE
+        assert self.impl.pub_pool_free_fatal_error(P0, blocks[1]) == ERROR_ID_POOL_INVALID_BLOCK
+
+        # No block is allocated when the last allocated block is freed again
+        for block in blocks[0:1] + blocks[2:]:
+            self.impl.rtos_pool_free(P0, block)
+        assert self.impl.pub_pool_free_fatal_error(P0, blocks[0]) == ERROR_ID_POOL_INVALID_BLOCK
+
+        # The rejected frees leave the pool intact
+        assert sorted(self.alloc_all()) == blocks
+
+    def test_alloc_aba(self):
+        # While an allocation is about to take the first free block, an interrupt handler allocates the first two free
+        # blocks and frees the first again.
+        # The first free block is then the same as before, but its successor is not, so the allocation must retry.
+        self.init()
+        held = []
+
+        def interrupt():
+            first = self.impl.rtos_pool_alloc(P0)
+            held.append(self.impl.rtos_pool_alloc(P0))
+            self.impl.rtos_pool_free_from_interrupt(P0, first)
+
+        calls = self.set_interrupt(interrupt)
+        block = self.impl.rtos_pool_alloc(P0)
+        assert calls == [True]
+        assert block == self.block(0) and held == [self.block(1)]
+        assert self.alloc_all() == [self.block(2), self.block(3)]
+        assert self.fatal_error_id.value == ERROR_ID_NONE
+
+    def test_free_interrupted(self):
+        self.init()
+        blocks = self.alloc_all()
+        self.impl.rtos_pool_free(P0, blocks[0])
+
+        # While blocks[1] is freed, an interrupt handler allocates blocks[0] and frees it again
+        def interrupt():
+            self.impl.rtos_pool_free_from_interrupt(P0, self.impl.rtos_pool_alloc(P0))
+
+        calls = self.set_interrupt(interrupt)
+        self.impl.rtos_pool_free(P0, blocks[1])
+        assert calls == [True]
+        assert self.alloc_all() == [blocks[1], blocks[0]]
+        assert self.fatal_error_id.value == ERROR_ID_NONE
+
+    def test_tag_wrap(self):
+        # Each allocation and free increments the tag in the upper half of the head of the free list
+        self.init()
+        assert self.impl.pub_pool_head(P0) == 0x20000
+        for _ in range(0x8000 - 3):
+            self.impl.rtos_pool_free(P0, self.impl.rtos_pool_alloc(P0))
+        assert self.impl.pub_pool_head(P0) == 0xfffc0000
+        block = self.impl.rtos_pool_alloc(P0)
+        assert self.impl.pub_pool_head(P0) == 0xfffd0001
+        self.impl.rtos_pool_free(P0, block)
+        assert self.impl.pub_pool_head(P0) == 0xfffe0000
+
+        # The tag wraps around without affecting the index, and an outdated head is still detected after the wrap
+        held = []
+
+        def interrupt():
+            first = self.impl.rtos_pool_alloc(P0)
+            held.append(self.impl.rtos_pool_alloc(P0))
+            self.impl.rtos_pool_free_from_interrupt(P0, first)
+
+        self.set_interrupt(interrupt)
+        assert self.impl.rtos_pool_alloc(P0) == self.block(0)
+        assert (self.impl.pub_pool_head(P0) >> 16, self.impl.pub_pool_head(P0) & 0xffff) == (2, 2)
+        assert held == [self.block(1)]
+        assert self.alloc_all() == [self.block(2), self.block(3)]
+        assert self.fatal_error_id.value == ERROR_ID_NONE
+
+    def test_high_water_mark(self):
+        self.init()
+        blocks = [self.impl.rtos_pool_alloc(P0) for _ in range(3)]
+        for block in blocks[:2]:
+            self.impl.rtos_pool_free(P0, block)
+        blocks[:2] = [self.impl.rtos_pool_alloc(P0)]
+        assert self.impl.rtos_pool_high_water_mark(P0) == 3
+        for block in blocks:
+            self.impl.rtos_pool_free(P0, block)
+        assert self.impl.rtos_pool_high_water_mark(P0) == 3
+        assert self.impl.rtos_pool_high_water_mark(P1) == 0
+
+        # Interrupt handlers allocate blocks while an allocation updates the number of used blocks (the second
+        # compare-and-swap operation of an allocation) and the high-water mark (the third)
+        for compare_and_swap_count in (2, 3):
+            self.impl.pub_pool_init()
+            self.set_interrupt(lambda: self.impl.rtos_pool_alloc(P0), compare_and_swap_count)
+            self.impl.rtos_pool_alloc(P0)
+            assert self.impl.rtos_pool_high_water_mark(P0) == 2
+            self.alloc_all()
+            assert self.impl.rtos_pool_high_water_mark(P0) == P0_BLOCKS
+        assert self.fatal_error_id.value == ERROR_ID_NONE
+
+    def test_free_from_interrupt(self):
+        self.init()
+        blocks = self.alloc_all()
+
+        # Task t1 waits for a block, and a block freed by an interrupt handler does not make it runnable
+        unblocked = []
+
+        def interrupt_handler():
+            self.impl.rtos_pool_free_from_interrupt(P0, blocks[3])
+            unblocked.append(self.unblocked[1])
+
+        self.impl.pub_set_current_task(1)
+        self.set_block(interrupt_handler)
+        assert self.impl.rtos_pool_alloc_wait(P0) == blocks[3]
+        assert unblocked == [False]
+
+        # Having received a block, t1 no longer waits for the pool
+        self.impl.pub_set_current_task(2)
+        self.impl.rtos_pool_free(P0, blocks[2])
+        assert not self.unblocked[1]
+        assert self.impl.rtos_pool_alloc(P0) == blocks[2]
+
+        # A block freed by a task makes all tasks runnable that wait for a block of the pool
+        unblocked = []
+
+        def task_t2():
+            self.impl.pub_set_current_task(2)
+            self.impl.rtos_pool_free(P1, self.impl.rtos_pool_alloc(P1))
+            unblocked.append(self.unblocked[1])
+            self.impl.rtos_pool_free(P0, blocks[0])
+            unblocked.append(self.unblocked[1])
+
+        self.impl.pub_set_current_task(1)
+        self.set_block(task_t2)
+        assert self.impl.rtos_pool_alloc_wait(P0) == blocks[0]
+        assert unblocked == [False, True]
+        assert self.fatal_error_id.value == ERROR_ID_NONE
+
+    def test_alloc_timeout(self):
+        self.init()
+        blocks = self.alloc_all()
+        timeouts = []
+
+        def block_timeout(timeout):
+            timeouts.append(timeout)
+            self.current_ticks.value += 4
+
+        self.current_ticks.value = 100
+        self.set_block_timeout(block_timeout)
+        assert self.impl.rtos_pool_alloc_timeout(P0, 10) is None
+        assert timeouts == [10, 6, 2]
+        assert self.current_ticks.value == 112
+
+        # A task that has timed out no longer waits for the pool
+        self.impl.rtos_pool_free(P0, blocks[0])
+        assert not self.unblocked[0]
+
+        def block_timeout_and_free(timeout):
+            self.impl.rtos_pool_free_from_interrupt(P0, blocks[1])
+
+        self.set_block_timeout(block_timeout_and_free)
+        assert self.impl.rtos_pool_alloc_timeout(P0, 10) == blocks[0]
+        assert self.impl.rtos_pool_alloc_timeout(P0, 10) == blocks[1]
+        assert self.fatal_error_id.value == ERROR_ID_NONE
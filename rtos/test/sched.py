@@ -27,6 +27,7 @@
 
 import ctypes
 import os
+import random
 import sys
 
 from rtos import sched
@@ -98,3 +99,152 @@ class testPrioInheritSched:
         states = sched.PrioInheritSchedModel.states(self.test_size, assume_runnable=True)
         for i, s in enumerate(states):
             yield "check_state.{}".format(i), check_state, s
+
+
+class testPrioInheritRrSched:
+    test_size = 5
+    level_bounds = [0, 1, 4, 5]
+    time_slice = 2
+
+    @classmethod
+    def setUpClass(cls):
+        r = os.system(sys.executable + " ./prj/app/prj.py build posix.unittest.sched-prio-inherit-rr")
+        system = "out/posix/unittest/sched-prio-inherit-rr/system" + get_executable_extension()
+        assert r == 0
+        cls.impl = ctypes.CDLL(system)
+        cls.impl.pub_sched_get_next.restype = ctypes.c_uint8
+        cls.impl.pub_sched_time_slice_tick.restype = ctypes.c_bool
+        pub_sched_tasks = ctypes.POINTER(sched.get_prio_inherit_rr_sched_struct(cls.test_size,
+                                                                                len(cls.level_bounds) - 1))
+        cls.impl_sched = pub_sched_tasks.in_dll(cls.impl, 'pub_sched_tasks')[0]
+
+    def check_next(self, model):
+        impl_next = self.impl.pub_sched_get_next()
+        if impl_next == 255:
+            impl_next = None
+        model_next = model.get_next()
+        assert impl_next == model_next, "Result: {} Expected: {} State: {}".format(impl_next, model_next, model)
+
+    def test_simple(self):
+        def check_state(model):
+            self.impl_sched.set(model)
+            self.check_next(model)
+            assert self.impl_sched == model
+
+        states = sched.PrioInheritRrSchedModel.states(self.level_bounds, self.time_slice, assume_runnable=True)
+        for i, s in enumerate(states):
+            yield "check_state.{}".format(i), check_state, s
+
+    def test_time_slicing(self):
+        """Apply random scheduler operations and ticks to the implementation and the model and compare them."""
+        rand = random.Random(39)
+        model = sched.PrioInheritRrSchedModel([None] * self.test_size, self.level_bounds,
+                                              [0] * (len(self.level_bounds) - 1), self.time_slice)
+        self.impl_sched.set(model)
+
+        for _ in range(2000):
+            task_id = rand.randrange(self.test_size)
+            operation = rand.randrange(4)
+            if operation == 0:
+                model.blocked_on[task_id] = task_id
+                self.impl.pub_sched_set_runnable(task_id)
+            elif operation == 1:
+                model.blocked_on[task_id] = None
+                self.impl.pub_sched_set_blocked(task_id)
+            elif operation == 2:
+                assert self.impl.pub_sched_time_slice_tick() == model.time_slice_tick()
+            self.check_next(model)
+            assert self.impl_sched == model
+
+    def test_rotation(self):
+        """Runnable tasks of equal priority take turns at the expiry of each time slice."""
+        model = sched.PrioInheritRrSchedModel([None, 1, 2, 3, 4], self.level_bounds, [0, 0, 0], self.time_slice)
+        self.impl_sched.set(model)
+        selected = []
+        expired = []
+        for _ in range(12):
+            selected.append(self.impl.pub_sched_get_next())
+            expired.append(self.impl.pub_sched_time_slice_tick())
+        assert selected == [1, 1, 2, 2, 3, 3, 1, 1, 2, 2, 3, 3]
+        assert expired == [False, True] * 6
+
+
+class testEdfSched:
+    test_size = 5
+    deadlines = [[0, 0, 0, 0, 0], [40, 30, 20, 10, 0], [2 ** 32 - 1, 1, 0, 2 ** 32 - 2, 3]]
+
+    @classmethod
+    def setUpClass(cls):
+        r = os.system(sys.executable + " ./prj/app/prj.py build posix.unittest.sched-edf")
+        system = "out/posix/unittest/sched-edf/system" + get_executable_extension()
+        assert r == 0
+        cls.impl = ctypes.CDLL(system)
+        pub_sched_tasks = ctypes.POINTER(sched.get_edf_sched_struct(cls.test_size))
+        cls.impl_sched = pub_sched_tasks.in_dll(cls.impl, 'pub_sched_tasks')[0]
+
+    def check_next(self, model):
+        impl_next = self.impl.pub_sched_get_next()
+        if impl_next == 255:
+            impl_next = None
+        model_next = model.get_next()
+        assert impl_next == model_next, "Result: {} Expected: {} State: {}".format(impl_next, model_next, model)
+
+    def test_simple(self):
+        def check_state(model):
+            self.impl_sched.set(model)
+            self.check_next(model)
+            assert self.impl_sched == model
+
+        states = sched.EdfSchedModel.states(self.test_size, self.deadlines, assume_runnable=True)
+        for i, s in enumerate(states):
+            yield "check_state.{}".format(i), check_state, s
+
+    def test_heap_operations(self):
+        """Apply random scheduler operations to the implementation and the model and compare their decisions.
+
+        This exercises the maintenance of the deadline heap, which test_simple sets up directly.
+
+        """
+        rand = random.Random(37)
+        model = sched.EdfSchedModel([None] * self.test_size, [0] * self.test_size)
+        self.impl_sched.set(model)
+
+        for step in range(2000):
+            task_id = rand.randrange(self.test_size)
+            operation = rand.randrange(4)
+            if operation == 0:
+                model.blocked_on[task_id] = task_id
+                self.impl.pub_sched_set_runnable(task_id)
+            elif operation == 1:
+                model.blocked_on[task_id] = None
+                self.impl.pub_sched_set_blocked(task_id)
+            elif operation == 2:
+                # Only block on tasks whose block chain does not lead back to the task
+                blocker = rand.randrange(self.test_size)
+                chain = blocker
+                while chain not in (task_id, None) and model.blocked_on[chain] != chain:
+                    chain = model.blocked_on[chain]
+                if chain == task_id:
+                    continue
+                model.blocked_on[task_id] = blocker
+                self.impl.pub_sched_set_blocked_on(task_id, blocker)
+            else:
+                # Deadlines advance across the wrap-around of the tick counter, but stay close to each other
+                deadline = (2 ** 32 - 1000 + step + rand.randrange(100)) % 2 ** 32
+                model.deadlines[task_id] = deadline
+                self.impl.pub_sched_set_deadline(task_id, ctypes.c_uint32(deadline))
+            assert self.impl_sched == model
+            self.check_heap(model)
+            self.check_next(model)
+
+    def check_heap(self, model):
+        impl = self.impl_sched
+        heap = impl.heap[:impl.heap_size]
+        assert sorted(heap) == [t for t, b in enumerate(model.blocked_on) if b is not None]
+        order = model.deadline_order
+        for task_id in set(range(self.test_size)) - set(heap):
+            assert impl.tasks[task_id].heap_pos == 0xff
+        for pos, task_id in enumerate(heap):
+            assert impl.tasks[task_id].heap_pos == pos
+            if pos > 0:
+                assert order.index(heap[(pos - 1) // 2]) < order.index(task_id)
@@ -0,0 +1,222 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+
+import ctypes
+import os
+import sys
+
+from pylib.utils import get_executable_extension
+
+ERROR_ID_NONE = 0
+ERROR_ID_TIMEBASE_TIME_TOO_FAR = 39
+
+NANOSECONDS_PER_SECOND = 1000000000
+# The system has a 3 MHz clock and 1 ms ticks, so that conversions between cycles and nanoseconds are inexact
+TICK_CYCLES = 3000
+RATE = ((NANOSECONDS_PER_SECOND << 32) + 1500000) // 3000000
+RATE_PER_PPB = ((RATE << 16) + NANOSECONDS_PER_SECOND // 2) // NANOSECONDS_PER_SECOND
+SECONDS_MAX = 64
+
+InterruptFuncPtr = ctypes.CFUNCTYPE(None)
+
+
+class NetworkTime(ctypes.Structure):
+    _fields_ = [("seconds", ctypes.c_uint32), ("nanoseconds", ctypes.c_uint32)]
+
+
+def network_time(nanoseconds):
+    return divmod(nanoseconds, NANOSECONDS_PER_SECOND)
+
+
+def elapsed(cycles, rate=RATE):
+    """The number of nanoseconds that elapse during the given number of cycles at the given rate."""
+    return (cycles * rate) >> 32
+
+
+class testTimebase:
+    @classmethod
+    def setUpClass(cls):
+        r = os.system(sys.executable + " ./prj/app/prj.py build posix.unittest.timebase")
+        system = "out/posix/unittest/timebase/system" + get_executable_extension()
+        assert r == 0
+        cls.impl = ctypes.CDLL(system)
+        cls.impl.rtos_timebase_tick.restype = ctypes.c_uint32
+        cls.impl.rtos_timebase_from_cycles.argtypes = [ctypes.c_uint32, ctypes.POINTER(NetworkTime)]
+        cls.impl.rtos_timebase_adjust.argtypes = [ctypes.c_int32]
+        cls.cycles = ctypes.c_uint32.in_dll(cls.impl, 'pub_cycles')
+        cls.ticks = ctypes.c_uint32.in_dll(cls.impl, 'pub_ticks')
+        cls.current_ticks = ctypes.c_uint32.in_dll(cls.impl, 'rtos_timer_current_ticks')
+        cls.oneshot_timer = ctypes.c_uint8.in_dll(cls.impl, 'pub_oneshot_timer')
+        cls.oneshot_timeout = ctypes.c_uint16.in_dll(cls.impl, 'pub_oneshot_timeout')
+        cls.waits = ctypes.c_uint8.in_dll(cls.impl, 'pub_waits')
+        cls.fatal_error_id = ctypes.c_uint8.in_dll(cls.impl, 'pub_fatal_error_id')
+
+    def init(self):
+        self.impl.pub_timebase_init()
+        # Keep references to the callbacks while the implementation may call them
+        self.callbacks = []
+
+    def tick(self, cycles=TICK_CYCLES):
+        self.cycles.value += cycles
+        return self.impl.rtos_timebase_tick()
+
+    def now(self):
+        time = NetworkTime()
+        self.impl.rtos_timebase_now(ctypes.byref(time))
+        return (time.seconds, time.nanoseconds)
+
+    def from_cycles(self, cycles):
+        time = NetworkTime()
+        self.impl.rtos_timebase_from_cycles(cycles, ctypes.byref(time))
+        return (time.seconds, time.nanoseconds)
+
+    def set(self, time):
+        self.impl.rtos_timebase_set(ctypes.byref(NetworkTime(*time)))
+
+    def set_interrupt(self, fn):
+        """Run `fn` as an interrupt handler immediately after the cycle counter is next read."""
+        self.callbacks.append(InterruptFuncPtr(fn))
+        self.impl.pub_set_interrupt_ptr(self.callbacks[-1])
+
+    def test_advance(self):
+        # The fractions of nanoseconds carry over between ticks, so the network time at each tick is exactly the time
+        # that elapses in all cycles so far, including the carries into seconds
+        self.init()
+        for cycles in (1, 2, TICK_CYCLES - 3, 1000 * TICK_CYCLES, 1234567, 1000 * TICK_CYCLES - 1, TICK_CYCLES):
+            self.tick(cycles)
+            assert self.now() == network_time(elapsed(self.cycles.value))
+        assert self.ticks.value == 7
+        assert self.now()[0] == 2
+
+        # Times after the tick, and up to one nanosecond of rounding for times before it
+        later = self.cycles.value + 1500 * TICK_CYCLES
+        assert self.from_cycles(later) == network_time(elapsed(later))
+        earlier = self.cycles.value - 1234567
+        seconds, nanoseconds = self.from_cycles(earlier)
+        assert abs(seconds * NANOSECONDS_PER_SECOND + nanoseconds - elapsed(earlier)) <= 1
+        assert self.fatal_error_id.value == ERROR_ID_NONE
+
+    def test_set(self):
+        self.init()
+        self.tick(2000 * TICK_CYCLES)
+
+        # A step is visible before the next tick applies it, and after it
+        for time in ((5, 100), (3, 999999000), (1, 50), (0, 0), (1 << 31, 999999999)):
+            self.set(time)
+            assert self.now() == time
+            self.tick(0)
+            assert self.now() == time
+            self.tick()
+            step_elapsed = elapsed(self.cycles.value) - elapsed(self.cycles.value - TICK_CYCLES)
+            assert self.now() == network_time(time[0] * NANOSECONDS_PER_SECOND + time[1] + step_elapsed)
+        assert self.fatal_error_id.value == ERROR_ID_NONE
+
+    def test_step_straddle(self):
+        self.init()
+        self.tick(1000 * TICK_CYCLES)
+        self.set((10, 0))
+        sample = self.cycles.value + TICK_CYCLES // 2
+        expected = self.from_cycles(sample)
+
+        # A tick that applies the step interrupts a reader after it samples the cycle counter
+        def tick():
+            self.cycles.value = sample + TICK_CYCLES // 2
+            self.impl.rtos_timebase_tick()
+
+        self.cycles.value = sample
+        self.set_interrupt(tick)
+        seconds, nanoseconds = self.now()
+        assert self.ticks.value == 2
+        assert seconds == expected[0] and abs(nanoseconds - expected[1]) <= 1
+
+        # A higher-priority task steps the network time after a reader samples the cycle counter
+        self.cycles.value = sample
+        self.set_interrupt(lambda: self.set((20, 0)))
+        assert self.now() == (20, 0)
+        # The step is relative to the time at the sample, which precedes the tick by half a tick
+        seconds, nanoseconds = self.from_cycles(sample + TICK_CYCLES)
+        assert seconds == 20 and abs(nanoseconds - (elapsed(sample + TICK_CYCLES) - elapsed(sample))) <= 1
+        assert self.fatal_error_id.value == ERROR_ID_NONE
+
+    def check_adjustment(self, ppb, applied_ppb):
+        self.init()
+        self.impl.rtos_timebase_adjust(ppb)
+        # The adjustment applies from the next tick onwards
+        self.tick(0)
+        for _ in range(10000):
+            self.tick()
+        rate = RATE + ((applied_ppb * RATE_PER_PPB) >> 16)
+        nanoseconds = elapsed(self.cycles.value, rate)
+        assert self.now() == network_time(nanoseconds)
+        # Ten seconds of cycles are within two nanoseconds of the adjusted network time
+        assert abs(nanoseconds - 10 * (NANOSECONDS_PER_SECOND + applied_ppb)) <= 2
+
+    def test_adjust(self):
+        self.check_adjustment(0, 0)
+        self.check_adjustment(1000, 1000)
+        self.check_adjustment(-500, -500)
+        self.check_adjustment(5000000, 1000000)
+        self.check_adjustment(-5000000, -1000000)
+
+    def check_ticks_until(self, nanoseconds, timeout, error_id=ERROR_ID_NONE):
+        time = NetworkTime(*network_time(self.tick_time + nanoseconds))
+        self.fatal_error_id.value = ERROR_ID_NONE
+        self.impl.rtos_timer_oneshot_at(0, ctypes.byref(time))
+        assert self.oneshot_timer.value == 0
+        assert self.oneshot_timeout.value == timeout
+        assert self.fatal_error_id.value == error_id
+
+    def test_ticks_until(self):
+        self.init()
+        self.tick(1500 * TICK_CYCLES)
+        self.current_ticks.value = 1
+        seconds, nanoseconds = self.now()
+        self.tick_time = seconds * NANOSECONDS_PER_SECOND + nanoseconds
+        assert nanoseconds > 400000000
+
+        # Future times round up to the next tick, and past times convert to the next tick
+        self.check_ticks_until(2000000, 2)
+        self.check_ticks_until(2500000, 3)
+        self.check_ticks_until(1, 1)
+        self.check_ticks_until(0, 0)
+        self.check_ticks_until(-1000000, 0)
+        self.check_ticks_until(-1500000000, 0)
+        # Across a second, with fewer nanoseconds than the tick
+        self.check_ticks_until(600000000, 600)
+        self.check_ticks_until(SECONDS_MAX * NANOSECONDS_PER_SECOND, SECONDS_MAX * 1000)
+        self.check_ticks_until((SECONDS_MAX + 1) * NANOSECONDS_PER_SECOND, SECONDS_MAX * 1000,
+                               ERROR_ID_TIMEBASE_TIME_TOO_FAR)
+
+        # The RTOS is yet to process a tick
+        self.current_ticks.value = 0
+        self.check_ticks_until(2000000, 3)
+        self.check_ticks_until(-1000000, 1)
+
+        self.impl.pub_set_current_task(1)
+        self.impl.rtos_sleep_until(ctypes.byref(NetworkTime(*network_time(self.tick_time + 5000000))))
+        assert (self.oneshot_timer.value, self.oneshot_timeout.value, self.waits.value) == (1, 6, 1)
@@ -0,0 +1,95 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+import ctypes
+import os
+import sys
+
+from pylib.utils import get_executable_extension
+
+
+class PeriodicStats(ctypes.Structure):
+    _fields_ = [("jobs", ctypes.c_uint32),
+                ("deadline_misses", ctypes.c_uint32),
+                ("jitter_total", ctypes.c_uint32),
+                ("response_total", ctypes.c_uint32),
+                ("jitter_min", ctypes.c_uint16),
+                ("jitter_max", ctypes.c_uint16),
+                ("response_min", ctypes.c_uint16),
+                ("response_max", ctypes.c_uint16)]
+
+    def summary(self):
+        return (self.jobs, self.deadline_misses, self.jitter_min, self.jitter_max, self.jitter_total,
+                self.response_min, self.response_max, self.response_total)
+
+
+class testPeriodicTasks:
+    @classmethod
+    def setUpClass(cls):
+        r = os.system(sys.executable + " ./prj/app/prj.py build posix.unittest.timer")
+        system = "out/posix/unittest/timer/system" + get_executable_extension()
+        assert r == 0
+        cls.impl = ctypes.CDLL(system)
+        cls.current_ticks = ctypes.c_uint32.in_dll(cls.impl, 'rtos_timer_current_ticks')
+        cls.stats = (PeriodicStats * 2).in_dll(cls.impl, 'rtos_periodic_stats')
+        cls.fatal_error_id = ctypes.c_uint8.in_dll(cls.impl, 'pub_fatal_error_id')
+
+    def run_job(self, task, ticks):
+        """As the given task, execute a job for the given number of ticks and then wait for the next release.
+
+        Returns the tick at which the next job starts.
+
+        """
+        self.impl.pub_set_current_task(task)
+        for _ in range(ticks):
+            self.impl.pub_tick()
+        self.impl.rtos_periodic_wait_next()
+        assert self.fatal_error_id.value == 0
+        return self.current_ticks.value
+
+    def test_release_jitter_and_deadline_misses(self):
+        self.impl.pub_timer_init()
+        assert self.current_ticks.value == 0
+
+        # Task t0 has a phase of 5, a period of 10, and a deadline of 10 ticks.
+        # Its jobs are released on time, unless the previous job overran, which delays but does not skip the release.
+        assert self.run_job(0, 0) == 5
+        assert self.run_job(0, 3) == 15
+        assert self.run_job(0, 12) == 27
+        assert self.run_job(0, 1) == 35
+        assert self.stats[0].summary() == (3, 1, 0, 2, 2, 3, 12, 18)
+
+        # Task t1 has a phase of 100, a period of 20, and a deadline of 8 ticks.
+        assert self.run_job(1, 0) == 100
+        assert self.run_job(1, 9) == 120
+        assert self.run_job(1, 8) == 140
+        assert self.stats[1].summary() == (2, 1, 0, 0, 0, 8, 9, 17)
+
+        # The statistics of t0 are unaffected by the releases of its jobs while t1 executed
+        assert self.stats[0].jobs == 3
+        self.impl.rtos_periodic_stats_clear()
+        assert self.stats[0].summary() == self.stats[1].summary() == (0, 0, 0xffff, 0, 0, 0xffff, 0, 0)
@@ -0,0 +1,200 @@
+#
+# eChronos Real-Time Operating System
+# Copyright (C) 2015  National ICT Australia Limited (NICTA), ABN 62 102 206 173.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Affero General Public License as published by
+# the Free Software Foundation, version 3, provided that these additional
+# terms apply under section 7:
+#
+#   No right, title or interest in or to any trade mark, service mark, logo or
+#   trade name of of National ICT Australia Limited, ABN 62 102 206 173
+#   ("NICTA") or its licensors is granted. Modified versions of the Program
+#   must be plainly marked as such, and must not be distributed using
+#   "eChronos" as a trade mark or product name, or misrepresented as being the
+#   original Program.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Affero General Public License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# @TAG(NICTA_AGPL)
+#
+
+
+import ctypes
+import os
+import sys
+
+from pylib.utils import get_executable_extension
+
+Q0, Q1 = 0, 1
+Q0_LENGTH = 4
+T0, T1, T2, T3 = range(4)
+SIGNAL_SET__WORK = 2
+# The interrupt events of the workers t1 and t2 of q0, and t3 of q1
+EVENT_Q0_T1, EVENT_Q0_T2, EVENT_Q1_T3 = range(3)
+
+WorkFuncPtr = ctypes.CFUNCTYPE(None, ctypes.c_void_p)
+InterruptFuncPtr = ctypes.CFUNCTYPE(None)
+WaitFuncPtr = ctypes.CFUNCTYPE(ctypes.c_bool)
+
+
+class testWorkQueue:
+    @classmethod
+    def setUpClass(cls):
+        r = os.system(sys.executable + " ./prj/app/prj.py build posix.unittest.work-queue")
+        system = "out/posix/unittest/work-queue/system" + get_executable_extension()
+        assert r == 0
+        cls.impl = ctypes.CDLL(system)
+        for name in ('rtos_work_queue_submit', 'rtos_work_queue_submit_from_interrupt'):
+            getattr(cls.impl, name).restype = ctypes.c_bool
+            getattr(cls.impl, name).argtypes = [ctypes.c_uint8, WorkFuncPtr, ctypes.c_void_p]
+        cls.impl.pub_work_queue_dequeue.restype = ctypes.c_void_p
+        cls.impl.pub_work_queue_set_position.argtypes = [ctypes.c_uint8, ctypes.c_uint32]
+        cls.signals = (ctypes.c_uint8 * 4).in_dll(cls.impl, 'pub_signals')
+        cls.interrupt_events = (ctypes.c_bool * 3).in_dll(cls.impl, 'pub_interrupt_events')
+        cls.waits = ctypes.c_uint32.in_dll(cls.impl, 'pub_waits')
+
+    def init(self):
+        self.impl.pub_work_queue_init()
+        # Keep references to the callbacks while the implementation may call them
+        self.callbacks = []
+        self.done = []
+        self.work = WorkFuncPtr(self.done.append)
+
+    def submit(self, context, work_queue=Q0):
+        return self.impl.rtos_work_queue_submit(work_queue, self.work, context)
+
+    def submit_from_interrupt(self, context, work_queue=Q0):
+        return self.impl.rtos_work_queue_submit_from_interrupt(work_queue, self.work, context)
+
+    def set_interrupt(self, fn, compare_and_swap_count=1):
+        """Run `fn` as an interrupt handler immediately before the given compare-and-swap operation."""
+        calls = []
+
+        def interrupt():
+            calls.append(True)
+            fn()
+        self.callbacks.append(InterruptFuncPtr(interrupt))
+        self.impl.pub_set_interrupt_ptr(self.callbacks[-1], compare_and_swap_count)
+        return calls
+
+    def run_worker(self, work_queue=Q0, wait=None):
+        """Run the worker of a work queue.
+        Each time the worker waits, it calls `wait`, and it stops when `wait` returns false or is not given.
+
+        """
+        if wait is not None:
+            self.callbacks.append(WaitFuncPtr(wait))
+            self.impl.pub_set_wait_ptr(self.callbacks[-1])
+        self.impl.pub_work_queue_run(work_queue)
+
+    def test_full(self):
+        self.init()
+        assert all(self.submit(context) for context in range(1, Q0_LENGTH + 1))
+        assert not self.submit(Q0_LENGTH + 1)
+        assert not self.submit_from_interrupt(Q0_LENGTH + 1)
+        # Work queues are independent
+        assert self.submit(10, Q1)
+
+        self.run_worker()
+        assert self.done == [1, 2, 3, 4]
+        assert self.waits.value == 1
+        assert self.submit(5)
+
+    def test_empty(self):
+        self.init()
+        self.run_worker()
+        assert self.done == [] and self.waits.value == 1
+        assert self.impl.pub_work_queue_dequeue(Q0) is None
+
+        # Another worker has taken the only item
+        assert self.submit(1)
+        assert self.impl.pub_work_queue_dequeue(Q0) == 1
+        self.run_worker()
+        assert self.done == [] and self.waits.value == 2
+
+    def check_fifo(self, rounds):
+        # Items are submitted in rounds of three, so that the ring wraps around at different slots
+        submitted = iter(range(1, 3 * rounds + 1))
+
+        def wait():
+            return self.waits.value < rounds and all(self.submit(next(submitted)) for _ in range(3))
+
+        self.run_worker(wait=wait)
+        assert self.done == list(range(1, 3 * (rounds - 1) + 1))
+
+    def test_fifo_wrap(self):
+        # Many more items than fit into the work queue go through it in order
+        self.init()
+        self.check_fifo(20)
+
+        # The 32-bit positions of the ring wrap around
+        self.init()
+        self.impl.pub_work_queue_set_position(Q0, 0xfffffffe)
+        self.check_fifo(5)
+        assert self.impl.pub_work_queue_dequeue(Q0) is None
+
+        # The work queue is full when the positions of its items wrap around
+        self.impl.pub_work_queue_set_position(Q0, 0xfffffffe)
+        assert all(self.submit(context) for context in range(1, Q0_LENGTH + 1))
+        assert not self.submit(Q0_LENGTH + 1)
+        assert [self.impl.pub_work_queue_dequeue(Q0) for _ in range(Q0_LENGTH + 1)] == [1, 2, 3, 4, None]
+
+    def test_wakeup(self):
+        # Submitting from a task signals all workers of the work queue.
+        # Submitting from an interrupt handler raises their interrupt events instead.
+        self.init()
+        assert self.submit(1)
+        assert list(self.signals) == [0, SIGNAL_SET__WORK, SIGNAL_SET__WORK, 0]
+        assert not any(self.interrupt_events)
+        assert self.submit_from_interrupt(2, Q1)
+        assert list(self.interrupt_events) == [False, False, True]
+        assert self.signals[T3] == 0
+        self.impl.pub_work_queue_init()
+        assert all(self.submit(context) for context in range(Q0_LENGTH))
+        assert not self.submit_from_interrupt(5)
+        assert not any(self.interrupt_events)
+
+        # A woken-up worker runs the items submitted while it waited
+        self.init()
+
+        def wait():
+            return self.waits.value == 1 and self.submit_from_interrupt(3)
+
+        self.run_worker(wait=wait)
+        assert self.done == [3]
+        assert self.waits.value == 2
+
+    def test_concurrent_submit(self):
+        # An interrupt handler submits an item after a task read the position to submit at, so the task retries at the
+        # next position
+        self.init()
+        calls = self.set_interrupt(lambda: self.submit_from_interrupt(1))
+        assert self.submit(2)
+        assert calls == [True]
+        self.run_worker()
+        assert self.done == [1, 2]
+
+        # When the interrupt handler fills the work queue, the task finds it full
+        self.init()
+        assert self.submit(1)
+        self.set_interrupt(lambda: [self.submit_from_interrupt(context) for context in (2, 3, 4)])
+        assert not self.submit(5)
+        self.run_worker()
+        assert self.done == [1, 2, 3, 4]
+
+    def test_concurrent_dequeue(self):
+        # Another worker takes the first item after this worker read its position, so this worker takes the next one
+        self.init()
+        assert all(self.submit(context) for context in (1, 2, 3))
+        taken = []
+        self.set_interrupt(lambda: taken.append(self.impl.pub_work_queue_dequeue(Q0)))
+        self.run_worker()
+        assert taken == [1]
+        assert self.done == [2, 3]
@@ -108,7 +108,7 @@ import argparse
 import logging
 
 from pylib.components import Component
-from pylib import release, components, prj, tests, tasks, cmdline, docs
+from pylib import release, components, prj, tests, tasks, cmdline, docs, bench
 from pylib.cmdline import add_cmds_in_globals_to_parser
 
 # Set up a specific logger with our desired output level
@@ -126,11 +126,14 @@ topdir = os.path.normpath(os.path.dirname(__file__))
 
 
 CORE_CONFIGURATIONS = {"posix": ["sched-rr-test", "sched-prio-inherit-test", "simple-mutex-test",
-                                 "blocking-mutex-test", "simple-semaphore-test", "sched-prio-test",
+                                 "blocking-mutex-test", "simple-semaphore-test", "sched-prio-test", "sched-edf-test",
+                                 "sched-prio-inherit-rr-test", "timer-test", "pool-test",
+                                 "condition-variable-test", "timebase-test", "work-queue-test", "broadcast-test",
+                                 "budget-test",
                                  "acamar", "gatria", "kraz"],
-                       "armv7m": ["acamar", "gatria", "kraz", "acrux", "rigel", "kochab", "phact"],
-                       "ppce500": ["acamar", "gatria", "kraz", "acrux", "kochab", "phact"],
-                       "stub": ["acamar", "gatria", "kraz", "acrux", "rigel", "kochab", "phact"]}
+                       "armv7m": ["acamar", "gatria", "kraz", "acrux", "rigel", "kochab", "phact", "pherkad"],
+                       "ppce500": ["acamar", "gatria", "kraz", "acrux", "kochab", "phact", "pherkad"],
+                       "stub": ["acamar", "gatria", "kraz", "acrux", "rigel", "kochab", "phact", "pherkad"]}
 
 CORE_SKELETONS = {
     'sched-rr-test': [Component('reentrant'),
@@ -142,9 +145,45 @@ CORE_SKELETONS = {
                         Component('sched-prio-test'),
                         ],
     'sched-prio-inherit-test': [Component('reentrant'),
-                                Component('sched-prio-inherit', {'assume_runnable': False}),
+                                Component('sched-prio-inherit', {'assume_runnable': False, 'time_slicing': False}),
                                 Component('sched-prio-inherit-test'),
                                 ],
+    'sched-prio-inherit-rr-test': [Component('reentrant'),
+                                   Component('sched-prio-inherit', {'assume_runnable': False, 'time_slicing': True}),
+                                   Component('sched-prio-inherit-rr-test'),
+                                   ],
+    'sched-edf-test': [Component('reentrant'),
+                       Component('sched-edf', {'assume_runnable': False}),
+                       Component('sched-edf-test'),
+                       ],
+    'timer-test': [Component('reentrant'),
+                   Component('timer', {'preemptive': True, 'time_slicing': False}),
+                   Component('timer-test'),
+                   ],
+    'pool-test': [Component('reentrant'),
+                  Component('error'),
+                  Component('pool'),
+                  Component('pool-test'),
+                  ],
+    'timebase-test': [Component('reentrant'),
+                      Component('error'),
+                      Component('timebase'),
+                      Component('timebase-test'),
+                      ],
+    'work-queue-test': [Component('reentrant'),
+                        Component('work-queue'),
+                        Component('work-queue-test'),
+                        ],
+    'broadcast-test': [Component('reentrant'),
+                       Component('error'),
+                       Component('broadcast'),
+                       Component('broadcast-test'),
+                       ],
+    'budget-test': [Component('reentrant'),
+                    Component('sched-prio', {'assume_runnable': False}),
+                    Component('budget'),
+                    Component('budget-test'),
+                    ],
     'simple-mutex-test': [Component('reentrant'),
                           Component('simple-mutex'),
                           Component('simple-mutex-test'),
@@ -153,6 +192,11 @@ CORE_SKELETONS = {
                             Component('blocking-mutex', {'lock_timeout': False, 'prio_ceiling': False}),
                             Component('blocking-mutex-test'),
                             ],
+    'condition-variable-test': [Component('reentrant'),
+                                Component('blocking-mutex', {'lock_timeout': False, 'prio_ceiling': False}),
+                                Component('condition-variable'),
+                                Component('condition-variable-test'),
+                                ],
     'simple-semaphore-test': [Component('reentrant'),
                               Component('preempt-null'),
                               Component('simple-semaphore', {'timeouts': False}),
@@ -160,13 +204,13 @@ CORE_SKELETONS = {
                               ],
     'acamar': [Component('reentrant'),
                Component('acamar'),
-               Component('stack', pkg_component=True),
+               Component('stack', {'stack_groups': False}, pkg_component=True),
                Component('context-switch', pkg_component=True),
                Component('error'),
                Component('task'),
                ],
     'gatria': [Component('reentrant'),
-               Component('stack', pkg_component=True),
+               Component('stack', {'stack_groups': False}, pkg_component=True),
                Component('context-switch', pkg_component=True),
                Component('preempt-null'),
                Component('sched-rr', {'assume_runnable': True}),
@@ -176,7 +220,7 @@ CORE_SKELETONS = {
                Component('gatria'),
                ],
     'kraz': [Component('reentrant'),
-             Component('stack', pkg_component=True),
+             Component('stack', {'stack_groups': False}, pkg_component=True),
              Component('context-switch', pkg_component=True),
              Component('preempt-null'),
              Component('sched-rr', {'assume_runnable': True}),
@@ -187,12 +231,12 @@ CORE_SKELETONS = {
              Component('kraz'),
              ],
     'acrux': [Component('reentrant'),
-              Component('stack', pkg_component=True),
+              Component('stack', {'stack_groups': False}, pkg_component=True),
               Component('context-switch', pkg_component=True),
               Component('preempt-null'),
               Component('sched-rr', {'assume_runnable': False}),
               Component('interrupt-event', pkg_component=True),
-              Component('interrupt-event', {'timer_process': False}),
+              Component('interrupt-event', {'timer_process': False, 'budgets': False}),
               Component('simple-mutex'),
               Component('error'),
               Component('task'),
@@ -200,19 +244,20 @@ CORE_SKELETONS = {
               ],
     'rigel': [Component('docs'),
               Component('reentrant'),
-              Component('stack', pkg_component=True),
+              Component('stack', {'stack_groups': True}, pkg_component=True),
               Component('context-switch', pkg_component=True),
               Component('preempt-null'),
               Component('sched-rr', {'assume_runnable': False}),
               Component('signal', {'prio_inherit': False, 'yield_api': True, 'task_signals': True}),
               Component('timer', pkg_component=True),
-              Component('timer', {'preemptive': False}),
+              Component('timer', {'preemptive': False, 'time_slicing': False}),
               Component('interrupt-event', pkg_component=True),
-              Component('interrupt-event', {'timer_process': True}),
+              Component('interrupt-event', {'timer_process': True, 'budgets': False}),
               Component('interrupt-event-signal', {'task_set': True}),
               Component('blocking-mutex', {'lock_timeout': False, 'preemptive': False, 'prio_ceiling': False}),
               Component('profiling'),
               Component('message-queue'),
+              Component('broadcast'),
               Component('error'),
               # Please note that the task_start_api pystache tag is used solely to block out a rigel-specific section
               # of the Task Configuration chapter.
@@ -221,38 +266,68 @@ CORE_SKELETONS = {
               ],
     'kochab': [Component('docs'),
                Component('reentrant'),
-               Component('stack', pkg_component=True),
+               Component('stack', {'stack_groups': False}, pkg_component=True),
                Component('context-switch-preempt', pkg_component=True),
-               Component('sched-prio-inherit', {'assume_runnable': False}),
+               Component('sched-prio-inherit', {'assume_runnable': False, 'time_slicing': True}),
                Component('signal', {'prio_inherit': True, 'yield_api': False, 'task_signals': False}),
                Component('timer', pkg_component=True),
-               Component('timer', {'preemptive': True}),
+               Component('timer', {'preemptive': True, 'time_slicing': True}),
+               Component('cycle-counter', pkg_component=True),
+               Component('budget'),
+               Component('timebase'),
                Component('interrupt-event', pkg_component=True),
-               Component('interrupt-event', {'timer_process': True}),
+               Component('interrupt-event', {'timer_process': True, 'budgets': True}),
                Component('interrupt-event-signal', {'task_set': False}),
                Component('blocking-mutex', {'lock_timeout': True, 'preemptive': True, 'prio_ceiling': False}),
+               Component('condition-variable'),
                Component('simple-semaphore', {'timeouts': True, 'preemptive': True}),
+               Component('atomic', pkg_component=True),
+               Component('pool'),
+               Component('work-queue'),
                Component('error'),
                Component('task', {'task_start_api': False}),
                Component('kochab'),
                ],
     'phact': [Component('docs'),
               Component('reentrant'),
-              Component('stack', pkg_component=True),
+              Component('stack', {'stack_groups': False}, pkg_component=True),
               Component('context-switch-preempt', pkg_component=True),
               Component('sched-prio-ceiling', {'assume_runnable': False}),
               Component('signal', {'prio_inherit': False, 'yield_api': False, 'task_signals': False}),
               Component('timer', pkg_component=True),
-              Component('timer', {'preemptive': True}),
+              Component('timer', {'preemptive': True, 'time_slicing': False}),
               Component('interrupt-event', pkg_component=True),
-              Component('interrupt-event', {'timer_process': True}),
+              Component('interrupt-event', {'timer_process': True, 'budgets': False}),
               Component('interrupt-event-signal', {'task_set': False}),
               Component('blocking-mutex', {'lock_timeout': True, 'preemptive': True, 'prio_ceiling': True}),
+              Component('condition-variable'),
               Component('simple-semaphore', {'timeouts': True, 'preemptive': True}),
+              Component('atomic', pkg_component=True),
+              Component('pool'),
               Component('error'),
               Component('task', {'task_start_api': False}),
               Component('phact'),
               ],
+    'pherkad': [Component('docs'),
+                Component('reentrant'),
+                Component('stack', {'stack_groups': False}, pkg_component=True),
+                Component('context-switch-preempt', pkg_component=True),
+                Component('sched-edf', {'assume_runnable': False}),
+                Component('signal', {'prio_inherit': True, 'yield_api': False, 'task_signals': False}),
+                Component('timer', pkg_component=True),
+                Component('timer', {'preemptive': True, 'time_slicing': False}),
+                Component('interrupt-event', pkg_component=True),
+                Component('interrupt-event', {'timer_process': True, 'budgets': False}),
+                Component('interrupt-event-signal', {'task_set': False}),
+                Component('blocking-mutex', {'lock_timeout': True, 'preemptive': True, 'prio_ceiling': False}),
+                Component('condition-variable'),
+                Component('simple-semaphore', {'timeouts': True, 'preemptive': True}),
+                Component('atomic', pkg_component=True),
+                Component('pool'),
+                Component('error'),
+                Component('task', {'task_start_api': False}),
+                Component('pherkad'),
+                ],
 }
 
 # client repositories may extend or override the following variables to control which configurations are available
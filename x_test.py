@@ -27,7 +27,8 @@
 
 from pylib.xunittest import teamcityskip
 from pylib.utils import Git
-from pylib.components import _sort_typedefs, _sort_by_dependencies, _DependencyNode, _UnresolvableDependencyError
+from pylib.components import _sort_typedefs, _sort_by_dependencies, _DependencyNode, _UnresolvableDependencyError,\
+    _ParseCache, _render_data
 from pylib.tasks import _Review, _Task, _InvalidTaskStateError
 from nose.tools import assert_raises
 import itertools
@@ -117,6 +118,27 @@ def test_resolve_cyclic_dependencies():
     assert sorted(output) == sorted(nodes)
 
 
+def test_parse_cache():
+    with tempfile.TemporaryDirectory() as temp_dir:
+        sectioned_file = os.path.join(temp_dir, 'implementation.c')
+        cache_file = os.path.join(temp_dir, 'cache', 'parse-cache.pickle')
+        with open(sectioned_file, 'w') as f:
+            f.write('/*| foo |*/\nfoo [[x]]\n/*| bar |*/\nbar\n')
+
+        cache = _ParseCache(cache_file)
+        sections = cache.sections(sectioned_file)
+        assert cache.sections(sectioned_file) is sections
+        assert _render_data(sections['foo'], 'foo', {'x': 1}) == 'foo 1'
+        cache.save()
+
+        # A new cache loads the parsed sections from disk and invalidates them when the file changes.
+        cache = _ParseCache(cache_file)
+        assert _render_data(cache.sections(sectioned_file)['bar'], 'bar', {}) == 'bar'
+        with open(sectioned_file, 'w') as f:
+            f.write('/*| foo |*/\nchanged\n')
+        assert sorted(cache.sections(sectioned_file)) == ['foo']
+
+
 # Workaround for the following tests for the pre-integration check that don't use the Git module
 class DummyGit:
     def __init__(self, task_name):